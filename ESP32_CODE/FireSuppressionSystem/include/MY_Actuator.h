@@ -0,0 +1,126 @@
+#ifndef MY_ACTUATOR_H
+#define MY_ACTUATOR_H
+
+#include <Arduino.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+
+// ==================== 通用执行器输出 ====================
+// 风扇、水泵、蜂鸣器共用的GPIO输出层：
+// - 引脚与有效电平在编译期确定，写入直接操作GPIO置位/清零寄存器
+// - 安全策略以模板参数注入，不需要的检查在编译期消除
+// - 不含互斥锁，调用方在各模块自己的互斥锁内使用，避免重复加锁
+// 分区输出的引脚来自运行时的分区表，使用同一写入路径 actuatorWritePin()
+
+// ==================== 寄存器写入 ====================
+
+/**
+ * @brief 直接写GPIO置位/清零寄存器
+ * 单次寄存器写入，不加锁，可在临界区和受控重启前的强制关闭路径中调用
+ */
+static inline void actuatorWritePin(uint8_t pin, bool high) {
+    uint32_t mask = 1UL << (pin & 31);
+    if (pin < 32) {
+        REG_WRITE(high ? GPIO_OUT_W1TS_REG : GPIO_OUT_W1TC_REG, mask);
+    } else {
+        REG_WRITE(high ? GPIO_OUT1_W1TS_REG : GPIO_OUT1_W1TC_REG, mask);
+    }
+}
+
+// ==================== 安全策略 ====================
+// 每个策略提供两项检查，不限制的一项为常量false，对应代码在编译期消除：
+//   limitsOnTime  / expired(onMs)   导通超过上限后 service() 强制关闭 (自动超时)
+//   limitsRestart / allowOn(offMs)  关闭后未满冷却时间时 set(true) 被拒绝
+// 依赖运行时配置或模块整体状态的限制 (水泵占空比冷却、蜂鸣器报警自动关闭) 仍由各模块实现，
+// 这里的策略只作为与之独立的输出级兜底
+
+// 无限制
+struct NoSafetyPolicy {
+    static const bool limitsOnTime = false;
+    static const bool limitsRestart = false;
+    static bool expired(uint32_t) { return false; }
+    static bool allowOn(uint32_t) { return true; }
+};
+
+// 最长导通时间 (毫秒)，超过后 service() 强制关闭输出
+template <uint32_t MaxOnMs>
+struct MaxOnTimePolicy : NoSafetyPolicy {
+    static const bool limitsOnTime = true;
+    static bool expired(uint32_t onMs) { return onMs >= MaxOnMs; }
+};
+
+// 最短关闭时间 (毫秒)，关闭后 MinOffMs 内不允许重新导通，防止继电器和电机频繁启停
+template <uint32_t MinOffMs>
+struct CooldownPolicy : NoSafetyPolicy {
+    static const bool limitsRestart = true;
+    static bool allowOn(uint32_t offMs) { return offMs >= MinOffMs; }
+};
+
+// ==================== 执行器模板 ====================
+
+/**
+ * @brief 编译期特化的执行器输出
+ * @tparam Pin GPIO编号
+ * @tparam ActiveLevel 有效电平 (HIGH=高电平触发, LOW=低电平触发)
+ * @tparam Policy 安全策略
+ */
+template <uint8_t Pin, uint8_t ActiveLevel, class Policy = NoSafetyPolicy>
+class Actuator {
+public:
+    static_assert(Pin < 49, "invalid GPIO number");
+
+    // 配置为输出并置为无效电平 (上电后不计冷却时间)
+    void begin() {
+        pinMode(Pin, OUTPUT);
+        writeLevel(false);
+        active = false;
+        cooling = false;
+    }
+
+    /**
+     * @brief 设置输出
+     * @return false=冷却中拒绝导通，输出保持关闭 (调用方稍后重试)
+     */
+    bool set(bool on) {
+        if (Policy::limitsRestart && on && !active && cooling) {
+            if (!Policy::allowOn(millis() - offSince)) return false;
+            cooling = false;
+        }
+        writeLevel(on);
+        if (Policy::limitsOnTime && on && !active) {
+            onSince = millis();
+        }
+        if (Policy::limitsRestart && !on && active) {
+            offSince = millis();
+            cooling = true;
+        }
+        active = on;
+        return true;
+    }
+
+    bool isActive() const { return active; }
+
+    /**
+     * @brief 执行安全策略检查
+     * @return true=已因超限被强制关闭
+     */
+    bool service() {
+        if (!Policy::limitsOnTime || !active) return false;
+        if (!Policy::expired(millis() - onSince)) return false;
+        set(false);
+        return true;
+    }
+
+private:
+    // Pin 与 ActiveLevel 为常量，内联后分支和掩码都在编译期确定
+    static inline void writeLevel(bool on) {
+        actuatorWritePin(Pin, on == (ActiveLevel == HIGH));
+    }
+
+    bool active = false;
+    bool cooling = false;
+    uint32_t onSince = 0;
+    uint32_t offSince = 0;
+};
+
+#endif
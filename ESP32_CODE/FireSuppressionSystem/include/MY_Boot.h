@@ -0,0 +1,81 @@
+#ifndef MY_BOOT_H
+#define MY_BOOT_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+/*
+ * 分阶段启动：
+ *   1. 安全阶段：配置、传感器、执行器、K230串口，随后立即创建监控与各控制任务
+ *   2. 布防：传感器任务完成首次采样与融合评估，且各控制任务都已进入主循环
+ *   3. 网络阶段：WiFi在后台连接 (不阻塞 setup)，MQTT由连接状态机推进
+ *   各阶段时刻以 esp_timer 计 (应用启动起，不含ROM与二级引导程序)，
+ *   每次启动后首次连上Broker时在 MQTT_TOPIC_BOOT 上发布一次，遥测带 boot_armed_ms
+ */
+
+// ==================== 启动配置 ====================
+// 布防目标 (超出时串口告警，报告中 armed_ok 为false)
+#define BOOT_ARMED_TARGET_MS        1000
+// 控制任务等待首次采样的上限，超时后照常运行 (传感器任务异常由任务监控处理)
+#define BOOT_FIRST_SAMPLE_WAIT_MS   5000
+
+// 就绪位 (各任务进入主循环前设置)
+#define BOOT_READY_SENSOR           (1 << 0)    // 首次采样与融合评估完成
+#define BOOT_READY_PUMP             (1 << 1)
+#define BOOT_READY_FAN              (1 << 2)
+#define BOOT_READY_BUZZER           (1 << 3)
+#define BOOT_READY_K230             (1 << 4)
+#define BOOT_READY_SUPERVISOR       (1 << 5)
+#define BOOT_READY_ARMED_MASK       (BOOT_READY_SENSOR | BOOT_READY_PUMP | BOOT_READY_FAN | \
+                                     BOOT_READY_BUZZER | BOOT_READY_K230 | BOOT_READY_SUPERVISOR)
+
+// ==================== 枚举定义 ====================
+
+typedef enum {
+    BOOT_STAGE_SETUP = 0,           // 进入 setup()
+    BOOT_STAGE_CONTROL_INIT,        // 传感器/执行器/K230初始化完成
+    BOOT_STAGE_TASKS,               // 监控与控制任务已创建
+    BOOT_STAGE_FIRST_SAMPLE,        // 首次采样与融合评估完成
+    BOOT_STAGE_ARMED,               // 全部控制任务就绪
+    BOOT_STAGE_WIFI,                // WiFi连接
+    BOOT_STAGE_MQTT,                // 首次连上Broker
+    BOOT_STAGE_COUNT
+} BootStage;
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint32_t stageMs[BOOT_STAGE_COUNT];     // 应用启动起的毫秒数，0=尚未到达
+    uint32_t readyBits;                     // 已就绪的任务 (BOOT_READY_*)
+    bool armed;
+    bool reported;                          // 启动报告已发布
+} BootStatus;
+
+// ==================== 全局变量声明 ====================
+extern EventGroupHandle_t bootEvents;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数：setup() 第一步调用
+void setupBoot();
+
+// 记录到达某阶段 (只记第一次)
+void bootMark(BootStage stage);
+
+// 任务就绪：全部控制任务就绪时记为布防
+void bootTaskReady(uint32_t readyBit);
+
+// 控制任务启动时调用：等待首次采样完成 (代替固定的启动延时)
+void bootWaitFirstSample();
+
+// 启动报告 (JSON)，发布成功后调用 bootMarkReported
+size_t buildBootReport(char* buffer, size_t size);
+void bootMarkReported();
+
+// 状态获取函数
+BootStatus getBootStatus();
+const char* getBootStageString(BootStage stage);
+void printBootReport();
+
+#endif
@@ -7,15 +7,28 @@
 #include <freertos/semphr.h>
 
 // ==================== 硬件配置 ====================
-// 蜂鸣器控制引脚 (高电平触发)
+// 蜂鸣器控制引脚 (低电平触发)
 #define BUZZER_PIN 8
 
+// 报警节奏由外设生成：1=RMT循环发送, 0=esp_timer单次定时器步进 (RMT不可用时也会自动回退)
+#define BUZZER_USE_RMT          1
+#define BUZZER_RMT_CHANNEL      RMT_CHANNEL_0
+// RMT时钟分频 (APB 80MHz / 255 ≈ 3.2us/tick，单个电平段最长约104ms)
+#define BUZZER_RMT_CLK_DIV      255
+// 每个RMT电平段的最大长度 (毫秒)，更长的响/停会拆成多段
+#define BUZZER_RMT_CHUNK_MS     100
+
 // ==================== 蜂鸣器工作参数 ====================
-// 蜂鸣器响动间隔 (毫秒) - 用于产生警报效果
+// 烟雾报警节奏 (毫秒) - 间歇鸣叫
 #define BUZZER_BEEP_ON_MS       500     // 响500ms
 #define BUZZER_BEEP_OFF_MS      300     // 停300ms
-// 火灾警报持续时间 (毫秒) - 超过此时间自动关闭
-#define BUZZER_AUTO_OFF_MS      60000   // 60秒
+// 疏散报警节奏 (毫秒) - ISO 8201 三连音：响0.5s停0.5s ×3，再停1.5s
+#define BUZZER_T3_ON_MS         500
+#define BUZZER_T3_OFF_MS        500
+#define BUZZER_T3_PAUSE_MS      1500
+// 火灾警报自动关闭时间可在线配置，出厂默认值见 MY_ConfigCore.h
+// 蜂鸣器任务随传感器采样唤醒，两次运行的最大允许间隔 (毫秒)
+#define BUZZER_TASK_DEADLINE_MS 6000
 
 // ==================== 枚举定义 ====================
 
@@ -25,6 +38,14 @@ typedef enum {
     BUZZER_ON = 1       // 蜂鸣器开启（警报中）
 } BuzzerState;
 
+// 报警图案
+typedef enum {
+    BUZZER_PATTERN_NONE = 0,        // 静音
+    BUZZER_PATTERN_SMOKE = 1,       // 烟雾/高温报警：间歇鸣叫
+    BUZZER_PATTERN_EVACUATION = 2,  // 火焰确认：三连音疏散信号
+    BUZZER_PATTERN_CONTINUOUS = 3   // 长鸣 (手动测试)
+} BuzzerPattern;
+
 // 控制模式
 typedef enum {
     BUZZER_MODE_AUTO = 0,    // 自动模式 (根据火灾检测控制)
@@ -37,10 +58,11 @@ typedef enum {
 typedef struct {
     BuzzerState state;          // 当前蜂鸣器状态
     BuzzerMode mode;            // 当前控制模式
+    BuzzerPattern pattern;      // 当前播放的报警图案
     unsigned long lastChange;   // 上次状态改变时间(ms)
     unsigned long alarmStart;   // 警报开始时间
     bool fireDetected;          // 是否检测到火灾
-    bool timeoutActive;         // 是否超时
+    bool timeoutActive;         // 是否超时 (超时后本次火灾不再自动报警，火灾解除后复位)
 } BuzzerControl;
 
 // ==================== 全局变量声明 ====================
@@ -54,25 +76,31 @@ extern SemaphoreHandle_t buzzerMutex;
 void setupBuzzer();
 
 // 蜂鸣器控制函数
-void buzzerOn();
+void buzzerOn();                            // 以疏散图案报警
 void buzzerOff();
 void buzzerToggle();
+void buzzerPlay(BuzzerPattern pattern);     // 切换报警图案 (NONE=关闭)
+void buzzerForceOff();                      // 强制停止播放 (不加锁，仅供受控重启前使用)
+
+// 通知蜂鸣器任务重新评估 (传感器数据更新时调用)
+void buzzerNotify();
 
 // 状态获取函数
 BuzzerState getBuzzerState();
 BuzzerMode getBuzzerMode();
+BuzzerPattern getBuzzerPattern();
 
 // 模式设置函数
 void setBuzzerMode(BuzzerMode mode);
 bool isBuzzerAutoMode();
 
 // 自动控制函数
-void updateBuzzerAutoControl(bool fireDetected);
 void updateBuzzerAutoControlBySensor(float temperature, float smokeLevel, bool smokeAlarm);
 
 // 状态字符串转换 (用于MQTT发布)
 const char* getBuzzerStateString();
 const char* getBuzzerModeString();
+const char* getBuzzerPatternString();
 
 // RTOS任务函数
 void buzzerTask(void *pvParameters);
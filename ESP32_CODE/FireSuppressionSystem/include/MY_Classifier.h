@@ -0,0 +1,72 @@
+#ifndef MY_CLASSIFIER_H
+#define MY_CLASSIFIER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "MY_ClassifierKernels.h"
+#include "MY_Zone.h"
+
+/*
+ * 场景分类 (干扰源识别)：
+ *   DSP任务每算完一次烟雾窗口，对各分区的 烟雾/温度窗口特征 + 湿度 运行一次int8模型，
+ *   判断 正常 / 干扰源 (水汽、烹饪油烟、粉尘) / 火灾，推理见 MY_ClassifierKernels
+ *   模型权重与推理工作区放在PSRAM中 (无PSRAM时权重直接从Flash读取，工作区使用内部RAM)
+ *   分类结果只用于暂缓自动喷水，不影响融合等级、报警和排风：
+ *     本次火灾首次喷水前，若最严重分区被判为干扰源 (概率 >= CLS_VETO_NUISANCE_PROB)，
+ *     且K230视觉未确认火情，则暂缓喷水；同一次火灾最多暂缓 CLS_MAX_HOLD_MS，之后照常喷水
+ *   模型由 HOST_CODE/Classifier 训练并生成 MY_ClassifierModel.h
+ */
+
+// ==================== 分类器配置 ====================
+// 0=只分类并上报 (不影响喷水), 1=按分类结果暂缓自动喷水
+#define CLS_GATE_ENABLE             1
+// 干扰源概率达到此值时暂缓喷水
+#define CLS_VETO_NUISANCE_PROB      0.80f
+// 同一次火灾最多暂缓的时间 (毫秒)
+#define CLS_MAX_HOLD_MS             30000
+// 分类结果的有效期 (毫秒)：DSP任务停滞后结果过期，不再暂缓
+#define CLS_FRESH_MS                5000
+// 单次分类 (全部分区) 的耗时预算 (微秒)，超出时计数
+#define CLS_BUDGET_US               2000
+
+// ==================== 数据结构 ====================
+
+// 单个分区的最新分类结果
+typedef struct {
+    ClsResult result;
+    bool valid;                     // 烟雾窗口已采满并完成过分类
+    unsigned long updatedMs;
+} ClsZoneResult;
+
+// 运行统计
+typedef struct {
+    bool ready;                     // 模型检查通过
+    bool modelInPsram;
+    uint32_t modelVersion;
+    uint32_t runs;                  // 分类次数 (每次全部分区)
+    uint32_t lastUs;                // 最近一次全部分区的推理耗时
+    uint32_t maxUs;
+    uint32_t overBudget;            // 超出 CLS_BUDGET_US 的次数
+} ClassifierStatus;
+
+// ==================== 全局变量声明 ====================
+extern SemaphoreHandle_t classifierMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数 (需在创建DSP任务之前，PSRAM分配失败时降级)
+void setupClassifier();
+
+// 对全部分区的最新窗口分类 (在DSP任务中调用)
+void classifierRun();
+
+// 该分区最新结果是否要求暂缓喷水 (结果有效、未过期且干扰源概率达到阈值；CLS_GATE_ENABLE 为0时总是false)
+bool classifierVetoesSpray(uint8_t zone);
+
+// 状态获取函数
+ClsZoneResult getClassifierResult(uint8_t zone);
+ClassifierStatus getClassifierStatus();
+void printClassifierReport();
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef MY_CLASSIFIER_KERNELS_H
+#define MY_CLASSIFIER_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "MY_DspKernels.h"
+
+// ==================== 场景分类推理 ====================
+// 对一个分区最近的多传感器窗口 (烟雾/温度窗口特征 + 湿度) 判断 正常 / 干扰源 / 火灾
+// 模型为全连接网络 (MLP)，权重与激活均为int8，量化方式与 TFLite Micro 相同：
+//   实数 = scale × (q - zeroPoint)，权重对称量化 (zeroPoint=0)，偏置为int32 (scale = 输入scale × 权重scale)
+//   每层累加结果用 Q31 乘数与移位重新量化 (multiplier, shift：shift>0 为左移)，ReLU 并入截断区间
+// 两种实现：
+//   clsInferRef  标量参考实现 (double，权重反量化，激活不量化)，只用于校验和基准对照
+//   clsInfer     int8实现；有 esp-nn 时全连接层使用其 ESP32-S3 (PIE) 优化版本，
+//                否则用本模块的可移植实现，两者使用同一套定点重新量化算法
+// 本模块不依赖 Arduino/FreeRTOS，主机端训练与基准工具直接编译同一份源码
+
+// 网络规模上限
+#define CLS_MAX_LAYERS              4
+#define CLS_MAX_WIDTH               32
+
+// 输入特征 (clsBuildInput 的输出顺序)
+#define CLS_INPUT_COUNT             11
+
+// esp-nn 可用时全连接层使用其实现，否则用可移植实现
+#if defined(ESP_PLATFORM) && defined(__has_include)
+#if __has_include(<esp_nn.h>)
+#define CLS_USE_ESP_NN              1
+#endif
+#endif
+#ifndef CLS_USE_ESP_NN
+#define CLS_USE_ESP_NN              0
+#endif
+
+// ==================== 枚举定义 ====================
+
+// 分类结果 (与模型输出顺序一致)
+typedef enum {
+    CLS_CLASS_NORMAL = 0,       // 正常环境
+    CLS_CLASS_NUISANCE = 1,     // 干扰源：水汽、烹饪油烟、粉尘
+    CLS_CLASS_FIRE = 2,         // 火灾
+    CLS_CLASS_COUNT = 3
+} ClsClass;
+
+// ==================== 数据结构 ====================
+
+// 一个全连接层：out[o] = act(Σ w[o][i] × in[i] + bias[o])，权重按输出行连续存放
+typedef struct {
+    uint16_t inputs;
+    uint16_t outputs;
+    const int8_t* weights;          // [outputs][inputs]
+    const int32_t* bias;            // [outputs]
+    float inputScale;               // 输入激活的量化参数
+    int32_t inputZeroPoint;
+    float weightScale;
+    float outputScale;              // 输出激活的量化参数
+    int32_t outputZeroPoint;
+    int32_t multiplier;             // 重新量化乘数 (Q31)，对应 inputScale × weightScale / outputScale
+    int32_t shift;
+    int32_t activationMin;          // 截断区间 (ReLU层下限为 outputZeroPoint)
+    int32_t activationMax;
+} ClsLayer;
+
+// 模型：输入标准化参数 + 各层
+// 第一层的输入量化参数用于量化标准化后的输入，最后一层输出为各类别 logit
+typedef struct {
+    uint32_t version;
+    uint8_t layerCount;
+    ClsLayer layers[CLS_MAX_LAYERS];
+    float inputMean[CLS_INPUT_COUNT];       // 标准化：(x - mean) × invStd
+    float inputInvStd[CLS_INPUT_COUNT];
+} ClsModel;
+
+// 一次推理结果
+typedef struct {
+    ClsClass label;                         // 概率最高的类别
+    float prob[CLS_CLASS_COUNT];
+} ClsResult;
+
+// ==================== 函数声明 ====================
+
+// 由窗口特征构造输入向量 (物理单位，方差与频带能量取 log1p)，
+// temp 为NULL (温度窗口未采满) 时温度项按室温平稳处理
+void clsBuildInput(const DspFeatures* smoke, const DspFeatures* temp, float humidity,
+                   float out[CLS_INPUT_COUNT]);
+
+// 检查模型结构 (层间维度衔接、规模上限)，不合法时返回false
+bool clsModelValid(const ClsModel* model);
+
+// 权重与偏置总字节数 (用于拷贝到PSRAM)
+size_t clsModelDataBytes(const ClsModel* model);
+
+// 把权重与偏置拷贝到 storage (至少 clsModelDataBytes 字节) 并让 dst 指向拷贝
+void clsModelCopy(const ClsModel* src, void* storage, ClsModel* dst);
+
+// 推理工作区字节数 (两块激活缓冲)
+size_t clsArenaBytes();
+
+// 标量参考实现
+void clsInferRef(const ClsModel* model, const float input[CLS_INPUT_COUNT], ClsResult* out);
+
+// int8实现 (arena 至少 clsArenaBytes 字节，同一工作区不可被多个任务同时使用)
+void clsInfer(const ClsModel* model, int8_t* arena, const float input[CLS_INPUT_COUNT], ClsResult* out);
+
+// 全连接层实现名称："esp-nn" / "portable"
+const char* clsBackendString();
+const char* clsClassString(ClsClass label);
+
+#endif
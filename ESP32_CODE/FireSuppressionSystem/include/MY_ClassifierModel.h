@@ -0,0 +1,96 @@
+#ifndef MY_CLASSIFIER_MODEL_H
+#define MY_CLASSIFIER_MODEL_H
+
+#include "MY_ClassifierKernels.h"
+
+// ==================== 场景分类模型 ====================
+// 由 HOST_CODE/Classifier 的 cls_train 生成，不要手工修改
+// 网络 11-32-16-3，权重与偏置 1116 字节；合成场景训练 14000 个样本 (种子 1)，验证集准确率 浮点 96.9% / int8 96.5%
+
+#define CLS_MODEL_VERSION           1
+
+static const int8_t clsModelWeights0[32 * 11] = {
+    -16, -7, -5, 4, 12, -8, -15, 2, -15, 8, 3,
+    -15, -5, 4, -2, -20, -47, 3, 12, -16, -5, 1,
+    -7, -25, 37, -18, 13, -10, 15, 14, -13, 12, 7,
+    3, 2, -1, 16, 10, -40, -10, 27, 17, -6, -2,
+    -37, 29, 19, -10, 29, -13, 5, 18, -10, -12, -5,
+    10, 9, -74, 1, -5, 5, 5, -5, 15, -30, 0,
+    -8, 9, 15, -9, -2, 27, 3, 3, -4, -4, -25,
+    5, -23, 18, 11, -25, -39, 17, -1, -11, 27, 2,
+    -19, -14, 4, -9, 1, 47, -29, 16, -16, -8, 2,
+    16, -17, -14, 1, 29, -49, 27, -3, 12, -19, 5,
+    11, -2, -5, -7, 19, 32, -46, -1, 14, 5, 0,
+    41, -5, 23, -1, -22, -12, -2, 4, -12, -6, 0,
+    18, 3, 37, 6, -20, -43, -5, -18, -3, 4, 1,
+    -1, -23, 39, 12, -23, 40, -41, -3, 2, 16, 14,
+    -20, 6, -26, 27, -4, 22, -19, -27, -17, 19, -4,
+    10, -25, 17, -1, 26, -25, 17, 2, 3, 11, 9,
+    30, -3, -3, -1, -5, 45, -14, 18, -2, 19, 8,
+    -1, 29, -1, 3, 8, -3, 28, -4, -15, 12, 42,
+    -23, -10, -65, 5, 31, -14, 19, -9, -33, -2, 5,
+    9, -16, -127, 4, 3, -23, -3, 2, 5, -9, 1,
+    3, -5, -2, -24, 8, -29, 46, 4, -4, 0, -5,
+    -21, 8, 20, -3, 1, -32, 2, -22, -11, -8, -6,
+    1, -14, 0, -19, 5, -16, -15, 18, 6, 3, 1,
+    -4, -48, 38, -29, -16, -54, -22, -10, 34, -8, 4,
+    -6, 9, 4, -19, 9, 19, -47, -38, -7, -1, -4,
+    6, -6, -18, 4, 20, 25, -28, -3, -27, -15, 9,
+    -29, 38, 0, 13, 8, 30, 24, 2, -13, 0, 3,
+    -31, 8, -2, -17, -3, -23, 35, 8, -16, -5, 2,
+    17, -10, 5, 15, -6, -10, 35, 24, 9, 11, 17,
+    17, -17, -12, 2, 11, 28, 4, 13, -5, 13, -12,
+    13, 5, 5, -42, 30, 8, 16, 7, 18, 31, -3,
+    24, -40, 30, -6, -9, 30, -14, -7, 16, -14, -7
+};
+
+static const int32_t clsModelBias0[32] = {
+    -172, -524, -57, -279, 139, 3, 58, -611, 566, 14, 1047, -42, -315, 667, -72, -148, 309, -286, -420, -446, 40, -427, -164, -205, 10, 473, 272, -47, -96, -123, -145, 438
+};
+
+static const int8_t clsModelWeights1[16 * 32] = {
+    19, 27, 17, -10, 32, -11, 2, 13, 18, -60, -32, -127, 18, -2, 8, -56, -39, -12, 25, 52, -18, 14, 4, 14, 23, -10, -22, 7, -12, 12, -18, -53,
+    0, 1, -4, 35, 9, -27, 55, -4, -10, 7, -16, -27, 3, -15, 14, 12, -15, 9, 19, 24, 8, 7, -6, -17, 27, -8, -12, -26, 3, 16, 8, 10,
+    13, 21, 30, 28, -3, 18, -24, 44, -34, 12, -40, 25, 25, -10, -4, 22, -21, 7, -27, 25, 10, 9, 13, 42, 8, -6, 23, 11, 4, -13, 24, 2,
+    3, 9, 4, 15, 18, -39, 8, -21, 24, -12, 5, -18, 3, 20, 0, -22, 8, -12, 7, 9, -28, -32, 12, -7, 36, 29, -11, -14, -8, -19, 5, -18,
+    -12, 3, -11, -46, -20, -18, 22, -37, 19, -49, 44, 26, -16, 59, 13, -14, 19, -53, -17, -28, -43, -12, -4, 2, -4, -16, -35, -10, 14, 20, -17, 37,
+    -30, -9, 3, -29, 33, 19, 14, -18, -14, -3, -33, -11, 9, -23, 2, -5, 18, 17, 35, -11, 23, 21, -107, -50, -17, -13, 49, 49, -8, 9, -6, -48,
+    -2, -6, 1, -16, 6, -1, -1, 6, 10, -6, 52, 8, -22, 29, -1, 10, 31, -7, -9, -27, -1, -26, -15, -2, 14, 27, -39, -25, -26, 24, 0, 24,
+    11, 18, 30, 34, 15, 18, 25, -36, 7, -11, -11, -2, 8, -15, -32, -12, -19, -21, -19, -11, -11, -59, 10, -7, -29, -22, 10, -3, 20, 9, -13, -27,
+    -10, -4, 16, 23, -28, 20, -38, 27, -27, 55, -28, 48, 27, 3, -24, 20, -21, 18, -21, 33, 48, -26, 25, 16, -5, -7, 12, -17, 24, -5, 14, 43,
+    13, 12, 15, 5, 19, -50, -1, -5, 7, -31, 12, -12, -27, -1, 8, 10, 8, -48, 38, 20, -12, 11, 15, -1, 16, 9, -30, -10, 13, -17, 7, -18,
+    19, -39, 4, -13, -2, 6, 22, -26, 30, -33, 32, -2, -30, 29, 11, -2, 11, -14, -10, -6, -12, -13, 8, -16, 20, 19, -47, -12, -15, 19, 4, 21,
+    -15, -11, 5, -10, -30, 0, -2, -21, -2, -1, 17, 28, -5, -3, -4, 18, 43, -4, -2, -6, -1, -45, 7, -20, -7, -14, -14, 16, 7, 28, 4, 12,
+    -5, -3, 29, 28, 11, -32, 21, -4, 2, -20, 11, -19, -9, -10, 23, 6, 1, -19, 21, 25, -20, 9, 11, 5, 12, 7, -15, 14, -21, -2, -28, -28,
+    4, 28, 3, -11, -22, 1, 14, 45, -16, 12, -32, -4, -1, -1, -1, 2, -12, 47, 19, 66, 18, 16, -2, -4, 13, -3, -16, 1, -6, 31, -6, -7,
+    4, -9, -18, -31, -1, 28, 0, -30, 5, 6, 39, 22, -13, 31, 18, 12, 21, 17, -1, -31, -18, -26, 8, 12, 7, 11, -27, -29, 14, 26, -15, 40,
+    -8, -11, 1, 13, -2, -26, 15, -27, 31, -21, 56, -13, -9, 4, 2, 0, 38, -18, 20, 16, -15, 9, -4, -8, 22, 29, -60, -26, -15, 9, -28, 0
+};
+
+static const int32_t clsModelBias1[16] = {
+    -321, -199, -271, 76, 675, 426, 579, -222, -191, -191, 645, -15, -299, -389, 562, 333
+};
+
+static const int8_t clsModelWeights2[3 * 16] = {
+    73, 27, -2, 30, -87, -123, -44, 101, -53, 26, -94, -18, 17, 49, -68, 6,
+    -21, -71, 59, -41, -10, 97, 16, -73, 79, -35, -127, -23, -38, 21, -16, -124,
+    -53, -22, -76, 33, 86, -70, 76, -100, -26, 6, 119, 47, -7, -84, 13, 53
+};
+
+static const int32_t clsModelBias2[3] = {
+    -249, 94, 200
+};
+
+static const ClsModel clsDefaultModel = {
+    CLS_MODEL_VERSION,
+    3,
+    {
+        { 11, 32, clsModelWeights0, clsModelBias0, 0.0318618417f, -14, 0.0295214709f, 0.040815562f, -128, 1583663584, -5, -128, 127 },
+        { 32, 16, clsModelWeights1, clsModelBias1, 0.040815562f, -128, 0.0205333177f, 0.0954181552f, -128, 1207156929, -6, -128, 127 },
+        { 16, 3, clsModelWeights2, clsModelBias2, 0.0954181552f, -128, 0.0132743819f, 0.725506961f, -2, 1919568282, -9, -128, 127 },
+    },
+    { 27.5705261f, 1.37079823f, 0.150207534f, 0.169340268f, 0.898440957f, 0.525834382f, 0.448569328f, 26.6275406f, 2.8451829f, 0.623453796f, 50.6730118f },
+    { 0.047074113f, 0.594711304f, 0.392361403f, 7.27094555f, 0.764124691f, 1.05143273f, 0.895923734f, 0.0749677494f, 0.173134744f, 0.976340771f, 0.0553184412f },
+};
+
+#endif
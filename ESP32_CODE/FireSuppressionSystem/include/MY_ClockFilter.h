@@ -0,0 +1,79 @@
+#ifndef MY_CLOCK_FILTER_H
+#define MY_CLOCK_FILTER_H
+
+#include <stdint.h>
+
+// ==================== 时钟偏差估计 ====================
+// 由一次 请求/应答 的四个时间戳估计本地时钟相对参考时钟的偏差：
+//   t1 本地发送  t2 参考接收  t3 参考发送  t4 本地接收
+//   偏差 = ((t2 - t1) + (t3 - t4)) / 2      往返时延 = (t4 - t1) - (t3 - t2)
+// 首次同步：攒够 CLOCK_FILTER_SYNC_SAMPLES 个样本后取往返时延最小者
+// 样本筛选：往返时延不超过最近 CLOCK_FILTER_WINDOW 个样本最小值 (加容差) 的才采用，
+//   排队时延大的样本不对称误差也大，直接丢弃
+// 偏差按 α 平滑；漂移取本样本与历史中最旧的、仍满足当前时延门限的采用样本之间的斜率，按 β 平滑
+// 本模块不依赖 Arduino/FreeRTOS，主机端测试工具直接编译同一份源码
+
+// 候选样本数
+#define CLOCK_FILTER_WINDOW         8
+#define CLOCK_FILTER_SYNC_SAMPLES   4
+// 采用门限：往返时延 <= 最小值 × 1.5 + CLOCK_FILTER_DELAY_MARGIN_US
+#define CLOCK_FILTER_DELAY_MARGIN_US 100
+// 计算漂移用的采用样本历史长度，以及最短基线 (基线太短时噪声被放大)
+#define CLOCK_FILTER_HISTORY        8
+#define CLOCK_FILTER_MIN_BASELINE_US 4000000
+// 偏差增益 α 与漂移增益 β
+#define CLOCK_FILTER_ALPHA          0.5f
+#define CLOCK_FILTER_BETA           0.3f
+// 残差超过此值时直接跳变到新样本 (参考时钟被调整或首次同步)
+#define CLOCK_FILTER_STEP_US        500000
+// 漂移估计上限 (晶振 + 温漂远小于此值)
+#define CLOCK_FILTER_MAX_DRIFT_PPM  500.0f
+// 漂移估计误差：首个估计之前按晶振典型上限计，之后取斜率与估计值之差的平滑值，不低于下限
+// 用于不确定度随距上次校准时间的增长
+#define CLOCK_FILTER_DRIFT_INIT_PPM 50.0f
+#define CLOCK_FILTER_DRIFT_ERR_PPM  2.0f
+
+// ==================== 数据结构 ====================
+
+// 一次交换得到的样本
+typedef struct {
+    int64_t localUs;            // 样本对应的本地时间 (t1 与 t4 的中点)
+    int64_t offsetUs;           // 参考时间 - 本地时间
+    int64_t delayUs;            // 往返时延 (不含参考端处理时间)
+} ClockSample;
+
+typedef struct {
+    ClockSample window[CLOCK_FILTER_WINDOW];
+    uint8_t count;
+    uint8_t head;
+    ClockSample history[CLOCK_FILTER_HISTORY];     // 已采用的样本
+    uint8_t historyCount;
+    uint8_t historyHead;
+    bool synced;
+    int64_t baseLocalUs;        // 估计值的基准本地时间
+    int64_t baseOffsetUs;       // 基准时刻的偏差
+    int64_t usedDelayUs;        // 最近一次采用的样本的往返时延
+    float driftPpm;             // 偏差变化率 (微秒/秒)，即本地时钟比参考慢多少ppm
+    float driftErrPpm;          // 漂移估计误差
+    bool driftValid;            // 已有漂移估计
+    float jitterUs;             // 残差绝对值的平滑值
+    uint32_t samples;           // 收到的有效样本数
+    uint32_t updates;           // 采用的样本数
+    uint32_t steps;             // 跳变次数
+} ClockFilter;
+
+// ==================== 函数声明 ====================
+
+void clockFilterReset(ClockFilter* filter);
+
+// 加入一次交换的四个时间戳，估计值更新时返回true
+bool clockFilterAddSample(ClockFilter* filter, int64_t t1, int64_t t2, int64_t t3, int64_t t4);
+
+// 本地时间 → 参考时间 (未同步时返回0)
+int64_t clockFilterToReference(const ClockFilter* filter, int64_t localUs);
+
+// 当前估计的不确定度 (未同步时返回 INT64_MAX)
+// = 所用样本往返时延的一半 + 残差抖动 + 漂移估计误差 × 距基准的时间
+int64_t clockFilterUncertaintyUs(const ClockFilter* filter, int64_t localUs);
+
+#endif
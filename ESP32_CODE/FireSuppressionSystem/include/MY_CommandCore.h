@@ -0,0 +1,82 @@
+#ifndef MY_COMMAND_CORE_H
+#define MY_COMMAND_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== 控制命令解码 ====================
+// MQTT与本地服务器的下行命令共用同一套Topic与负载：
+//   控制：{"action":"on"|"off"}，水泵可带脉冲参数，蜂鸣器可带图案；自动模式下由调用方忽略
+//   模式：{"action":"auto"|"manual"}
+//   配置：负载原样交给配置模块 (见 MY_ConfigCore.h)
+// 负载不是JSON对象、缺少 action 或取值不识别时 action 为 COMMAND_ACTION_NONE，调用方不做任何动作；
+// 本模块只做解码，执行由调用方负责；不依赖 Arduino/FreeRTOS，主机端工具直接编译同一份源码
+
+// ==================== 控制Topic ====================
+#define COMMAND_TOPIC_FAN_CONTROL       "fire_alarm/fan/control"
+#define COMMAND_TOPIC_FAN_MODE          "fire_alarm/fan/mode"
+#define COMMAND_TOPIC_PUMP_CONTROL      "fire_alarm/pump/control"
+#define COMMAND_TOPIC_PUMP_MODE         "fire_alarm/pump/mode"
+#define COMMAND_TOPIC_BUZZER_CONTROL    "fire_alarm/buzzer/control"
+#define COMMAND_TOPIC_BUZZER_MODE       "fire_alarm/buzzer/mode"
+#define COMMAND_TOPIC_CONFIG            "fire_alarm/config"
+
+// ==================== 命令参数 ====================
+// 手动模式下 "on" 命令的默认喷水时间 (毫秒)
+#define PUMP_MANUAL_SPRAY_MS     10000
+
+// ==================== 枚举定义 ====================
+
+// 命令Topic (顺序即订阅顺序)
+typedef enum {
+    COMMAND_FAN_CONTROL = 0,
+    COMMAND_FAN_MODE,
+    COMMAND_PUMP_CONTROL,
+    COMMAND_PUMP_MODE,
+    COMMAND_BUZZER_CONTROL,
+    COMMAND_BUZZER_MODE,
+    COMMAND_CONFIG,
+    COMMAND_TOPIC_COUNT
+} CommandTopic;
+
+typedef enum {
+    COMMAND_ACTION_NONE = 0,
+    COMMAND_ACTION_ON,
+    COMMAND_ACTION_OFF,
+    COMMAND_ACTION_AUTO,
+    COMMAND_ACTION_MANUAL
+} CommandAction;
+
+// 蜂鸣器图案 (未指定或不识别时为疏散)
+typedef enum {
+    COMMAND_PATTERN_EVACUATION = 0,
+    COMMAND_PATTERN_SMOKE,
+    COMMAND_PATTERN_CONTINUOUS
+} CommandPattern;
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    CommandTopic topic;
+    CommandAction action;
+    // 水泵 "on" 的脉冲参数: {"action":"on","on_ms":2000,"off_ms":1000,"cycles":3}
+    // on_ms 优先于 duration_ms，均缺失时为 PUMP_MANUAL_SPRAY_MS；限幅由水泵模块负责
+    uint32_t onMs;
+    uint32_t offMs;
+    uint16_t cycles;
+    // 蜂鸣器 "on" 的图案: {"action":"on","pattern":"smoke" | "evacuation" | "continuous"}
+    CommandPattern pattern;
+} ControlCommand;
+
+// ==================== 函数声明 ====================
+
+// Topic名称 (订阅用)，越界返回NULL
+const char* commandTopicName(CommandTopic topic);
+
+// 控制类Topic (自动模式下忽略)
+bool commandIsControl(CommandTopic topic);
+
+// 解码一条命令；Topic不识别时返回false
+bool commandDecode(const char* topic, const char* payload, size_t length, ControlCommand* command);
+
+#endif
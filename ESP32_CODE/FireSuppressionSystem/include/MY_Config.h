@@ -0,0 +1,45 @@
+#ifndef MY_CONFIG_H
+#define MY_CONFIG_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "MY_ConfigCore.h"
+
+// ==================== 运行时配置 ====================
+// 阈值与时间参数可通过MQTT在线修改并保存到NVS，重启后仍然有效
+// 字段表、出厂默认值与更新规则见 MY_ConfigCore.h，本模块负责快照发布与NVS存储
+
+// NVS命名空间：每个字段单独一个键 (键名见 MY_ConfigCore.cpp 的字段表)
+// 新固件增加字段时，NVS中没有该键则取默认值，已保存的字段跨版本保留
+#define CONFIG_NVS_NAMESPACE        "fire_cfg"
+#define CONFIG_NVS_REVISION_KEY     "revision"
+// 快照槽位数 (当前 + 上一个 + 正在写入)
+#define CONFIG_SLOT_COUNT           3
+
+// ==================== 全局变量声明 ====================
+extern SemaphoreHandle_t configMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数 (从NVS逐字段加载，缺失字段使用默认值，整体校验失败则全部使用默认值)
+void setupConfig();
+
+// 获取当前配置快照 (无锁，可在任意任务的控制循环中调用)
+// 返回的指针在一个控制周期内有效，不要长期保存
+const SystemConfig* getConfig();
+
+// 应用JSON格式的配置更新 (部分字段即可)，校验通过后保存并发布新快照
+// error 非NULL时写入失败原因
+bool applyConfigJson(const char* json, char* error, size_t errorSize);
+
+// 恢复出厂默认值
+bool resetConfigToDefaults();
+
+// 生成当前配置的JSON (用于上报)
+String createConfigJson();
+
+// 配置更新被拒绝的次数
+uint32_t getConfigRejectCount();
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef MY_CONFIG_CORE_H
+#define MY_CONFIG_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "MY_OutboxCore.h"
+
+// ==================== 运行时配置核心 ====================
+// MY_Config 的配置语义部分：字段表、出厂默认值、范围校验、更新/恢复默认的规则与 config/state 负载
+//   - 更新为部分字段的JSON对象，缺失或为 null 的字段保持原值，校验通过后修订号+1
+//   - {"action":"reset"} 恢复出厂默认值，修订号同样+1
+//   - 两次成功更新的间隔不小于 CONFIG_MIN_UPDATE_INTERVAL_MS，期间的请求被拒绝
+//   - 负载不是JSON对象、字段类型不符、校验失败或被限频时计入拒绝次数
+// 快照发布、加锁与NVS存储由调用方负责，时间 (millis) 由调用方传入；
+// 本模块不依赖 Arduino/FreeRTOS，主机端工具直接编译同一份源码
+
+// ==================== 出厂默认值 ====================
+// 火灾判定阈值
+#define TEMP_ALARM_THRESHOLD        50.0f   // 超过此温度判定为火灾
+#define TEMP_SAFE_THRESHOLD         40.0f   // 低于此温度可解除火灾状态
+#define SMOKE_ALARM_THRESHOLD       30.0f   // 超过此浓度判定为火灾
+#define SMOKE_SAFE_THRESHOLD        15.0f   // 低于此浓度可解除火灾状态
+// 单次喷水最大持续时间 (毫秒) - 防止水泵过热或水箱耗尽
+#define PUMP_MAX_DURATION_MS        5000    // 5秒
+// 自动模式下检测到火灾后的喷水时间 (毫秒)
+#define PUMP_AUTO_SPRAY_MS          5000    // 5秒
+// 占空比统计窗口 (毫秒) 与额定占空比 (%)
+#define PUMP_DUTY_WINDOW_MS         60000   // 60秒
+#define PUMP_DUTY_PERCENT           50
+// 火灾警报持续时间 (毫秒) - 超过此时间自动关闭
+#define BUZZER_AUTO_OFF_MS          60000   // 60秒
+// 火焰状态超时时间 (毫秒) - 超过此时间未收到fire则认为火焰消失
+// 参数下发生效后取 min(此值, 上报间隔 × K230_FIRE_TIMEOUT_REPORTS)，快速上报时火焰解除也更快
+#define K230_FIRE_TIMEOUT_MS        5000    // 5秒
+// 火焰检测后的水泵喷水时间 (毫秒)
+#define K230_PUMP_SPRAY_MS          15000   // 15秒
+// 超过此时间未收到心跳判定链路丢失
+#define K230_HEARTBEAT_TIMEOUT_MS   15000
+// 帧率下限 (0表示不检查)
+#define K230_MIN_FPS                5.0f
+// 空闲/警戒两档上报间隔
+#define K230_IDLE_REPORT_MS         2000    // 与旧版K230固定的 SEND_INTERVAL_MS 一致
+#define K230_ALERT_REPORT_MS        100
+// 置信度阈值，0表示使用K230模型部署配置中的值
+#define K230_CONF_THRESHOLD         0.0f
+// 检测区域以画面千分比表示，默认整幅画面
+#define K230_ROI_FULL               1000
+
+// ==================== 校验参数 ====================
+// 两次配置更新的最小间隔 (毫秒)
+// 需大于任一控制任务读取配置后使用它的最长时间，保证旧快照在复用前已无人读取
+#define CONFIG_MIN_UPDATE_INTERVAL_MS 2000
+// 心跳超时下限：两个心跳间隔 (K230_HEARTBEAT_INTERVAL_MS，MY_Config.cpp 中静态检查)
+#define CONFIG_K230_HB_TIMEOUT_MIN_MS 10000
+// config/state 负载缓冲区大小
+#define CONFIG_STATE_SIZE           1024
+
+// ==================== 数据结构 ====================
+
+// 系统配置快照 (发布后只读)
+typedef struct {
+    uint32_t revision;              // 配置修订号 (每次成功更新+1)
+
+    // 火灾判定阈值
+    float tempAlarmThreshold;       // 高温报警阈值 (°C)
+    float tempSafeThreshold;        // 温度安全阈值 (°C)
+    float smokeAlarmThreshold;      // 烟雾报警阈值 (%)
+    float smokeSafeThreshold;       // 烟雾安全阈值 (%)
+
+    // 水泵参数
+    uint32_t pumpAutoSprayMs;       // 自动模式单次喷水时间
+    uint32_t pumpMaxDurationMs;     // 单次喷水最大持续时间
+    uint32_t pumpDutyWindowMs;      // 占空比统计窗口
+    uint32_t pumpDutyPercent;       // 额定占空比 (%)
+
+    // 蜂鸣器参数
+    uint32_t buzzerAutoOffMs;       // 警报自动关闭时间
+
+    // K230参数
+    uint32_t k230FireTimeoutMs;     // 火焰信号超时时间
+    uint32_t k230PumpSprayMs;       // K230确认火焰后的喷水时间
+    uint32_t k230HeartbeatTimeoutMs;// 心跳超时时间 (超时判定视觉链路丢失)
+    float k230MinFps;               // 视觉帧率下限 (0=不检查)
+    uint32_t k230IdleReportMs;      // 空闲档火焰上报间隔
+    uint32_t k230AlertReportMs;     // 警戒档火焰上报间隔
+    float k230ConfThreshold;        // K230检测置信度阈值 (0=模型默认)
+    uint32_t k230RoiX;              // 检测区域 (画面千分比)
+    uint32_t k230RoiY;
+    uint32_t k230RoiW;
+    uint32_t k230RoiH;
+
+    // 离线缓存参数
+    uint32_t outboxDrainRatePerSec; // 重连后补发速率 (条/秒)
+} SystemConfig;
+
+// 配置字段表：JSON键 (上报/更新)、NVS键 (不超过15字符)、类型与结构体偏移
+// 新增配置字段只需在 SystemConfig、configCoreLoadDefaults、configCoreValidate 和字段表中各加一处
+typedef enum {
+    CONFIG_FIELD_FLOAT,
+    CONFIG_FIELD_UINT
+} ConfigFieldType;
+
+typedef struct {
+    const char* json;
+    const char* nvs;
+    ConfigFieldType type;
+    size_t offset;
+} ConfigField;
+
+// 更新规则的状态 (限频与拒绝计数)
+typedef struct {
+    bool updated;                   // 是否成功更新过 (未更新过时不限频)
+    uint32_t lastUpdateMs;          // 最近一次成功更新的时间
+    uint32_t rejects;               // 被拒绝的更新次数
+} ConfigCore;
+
+// 一次更新请求的结果
+typedef enum {
+    CONFIG_UPDATE_REJECTED = 0,     // 原配置不变，已计入拒绝次数
+    CONFIG_UPDATE_APPLIED = 1,      // next 为更新后的配置
+    CONFIG_UPDATE_RESET = 2         // next 为出厂默认值
+} ConfigUpdateResult;
+
+// ==================== 全局变量声明 ====================
+extern const ConfigField configFields[];
+extern const size_t configFieldCount;
+
+// ==================== 函数声明 ====================
+
+void configCoreInit(ConfigCore* core);
+void configCoreLoadDefaults(SystemConfig* cfg);
+// 校验通过返回NULL，否则返回失败原因
+const char* configCoreValidate(const SystemConfig* cfg);
+
+// 字段在配置快照中的位置
+float* configFieldFloat(SystemConfig* cfg, const ConfigField* field);
+uint32_t* configFieldUint(SystemConfig* cfg, const ConfigField* field);
+float configFieldGetFloat(const SystemConfig* cfg, const ConfigField* field);
+uint32_t configFieldGetUint(const SystemConfig* cfg, const ConfigField* field);
+
+// 处理一条配置负载；接受时写出 next (修订号已+1) 并记录更新时间，拒绝时 error 为原因
+ConfigUpdateResult configCoreUpdate(ConfigCore* core, const SystemConfig* current, const char* json, size_t length,
+                                    uint32_t nowMs, SystemConfig* next, const char** error);
+// 恢复出厂默认值 (同样受限频)，返回false表示被拒绝
+bool configCoreReset(ConfigCore* core, const SystemConfig* current, uint32_t nowMs, SystemConfig* next);
+
+// config/state 负载 (修订号、全部字段、拒绝次数、参考时钟纪元微秒)，长度语义同 snprintf
+size_t configCoreBuildState(const SystemConfig* cfg, uint32_t rejects, int64_t epochUs, char* buffer, size_t size);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef MY_DSP_H
+#define MY_DSP_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "MY_DspKernels.h"
+#include "MY_Zone.h"
+
+/*
+ * 传感器流特征提取：
+ *   DSP任务以 DSP_SMOKE_RATE_HZ 高速采样各分区MQ-2模拟量，每 DSP_SMOKE_HOP 个样本
+ *   对最近 DSP_SMOKE_WINDOW 个样本计算窗口特征；温度由传感器任务每个采样周期送入，
+ *   窗口为 DSP_TEMP_WINDOW 个样本
+ *   特征：方差、斜率 (单位/秒)、过零率、各频带能量，计算见 MY_DspKernels
+ *   烟雾单位为浓度%，温度单位为°C
+ */
+
+// ==================== DSP配置 ====================
+// 0=浮点流水线, 1=定点流水线 (样本按原始整数存放：ADC计数、0.01°C)
+#define DSP_PIPELINE_FIXED          1
+
+// MQ-2 高速采样
+#define DSP_SMOKE_RATE_HZ           50
+#define DSP_SMOKE_WINDOW            128     // 2.56秒
+#define DSP_SMOKE_HOP               64      // 每1.28秒计算一次
+#define DSP_SMOKE_SCALE             (100.0f / 4095.0f)  // ADC计数 → 浓度%
+// 频带：缓慢波动 / 湍流闪烁 / 高频噪声
+#define DSP_SMOKE_BANDS             { {0.4f, 2.0f}, {2.0f, 8.0f}, {8.0f, 25.0f} }
+#define DSP_SMOKE_BAND_COUNT        3
+
+// 温度 (传感器任务每 SENSOR_READ_INTERVAL_MS 一个样本)
+#define DSP_TEMP_WINDOW             32      // 约64秒
+#define DSP_TEMP_HOP                1
+#define DSP_TEMP_SCALE              0.01f   // 定点样本单位 0.01°C
+#define DSP_TEMP_BANDS              { {0.015f, 0.06f}, {0.06f, 0.25f} }
+#define DSP_TEMP_BAND_COUNT         2
+
+// 两次采样的最大允许间隔 (毫秒)
+#define DSP_TASK_DEADLINE_MS        500
+
+// 空闲暂停：全部分区为安全等级、置信度低于 FUSION_CLEAR_SCORE 且没有DO报警时停止50Hz采样，
+// 每 DSP_IDLE_POLL_MS 检查一次 (需小于 DSP_TASK_DEADLINE_MS)，
+// 使开启 POWER_MGMT_ENABLE 时芯片可以进入Light-sleep；恢复采样后需约2.56秒采满窗口，
+// 期间烟雾特征无效，场景分类不会暂缓喷水
+#define DSP_IDLE_PAUSE_ENABLE       1
+#define DSP_IDLE_POLL_MS            400
+
+#if DSP_PIPELINE_FIXED
+typedef int16_t DspSample;
+#else
+typedef float DspSample;
+#endif
+
+// ==================== 数据结构 ====================
+
+// 单个分区的最新特征
+typedef struct {
+    DspFeatures smoke;
+    DspFeatures temp;
+    bool smokeValid;                // 已采满一个窗口
+    bool tempValid;
+    unsigned long smokeUpdatedMs;
+    unsigned long tempUpdatedMs;
+} DspZoneFeatures;
+
+// 运行统计
+typedef struct {
+    uint32_t smokeWindows;          // 已计算的烟雾窗口数 (全部分区)
+    uint32_t tempWindows;
+    uint32_t smokeUs;               // 最近一次全部分区烟雾特征的计算耗时
+    uint32_t smokeMaxUs;
+    uint32_t tempUs;
+    uint32_t tempMaxUs;
+    uint32_t lateSamples;           // 采样时刻落后一个周期以上的次数
+    bool idle;                      // 当前处于空闲暂停
+    uint32_t idlePauses;            // 进入空闲暂停的次数
+} DspStatus;
+
+// ==================== 全局变量声明 ====================
+extern TaskHandle_t dspTaskHandle;
+extern SemaphoreHandle_t dspMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数 (需在 setupSensor 之后)
+void setupDsp();
+
+// RTOS任务函数
+void dspTask(void *pvParameters);
+
+// 传感器任务每次采样后调用 (温度为NaN时跳过)
+void dspPushTemperature(uint8_t zone, float temperature);
+
+// 状态获取函数
+DspZoneFeatures getDspFeatures(uint8_t zone);
+DspStatus getDspStatus();
+const char* getDspPipelineString();
+void printDspReport();
+
+#endif
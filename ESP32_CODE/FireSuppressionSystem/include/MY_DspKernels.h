@@ -0,0 +1,92 @@
+#ifndef MY_DSP_KERNELS_H
+#define MY_DSP_KERNELS_H
+
+#include <stdint.h>
+
+// ==================== 窗口特征 ====================
+// 对一段等间隔采样 (窗口) 计算：
+//   均值、方差、最小二乘斜率 (单位/秒)、过零率 (相邻样本跨越均值的比例)、各频带能量
+// 频带能量：去均值、加Hann窗后做N点FFT，频带内各bin功率按窗函数功率增益归一化，
+//   单位与方差相同，频带覆盖 (0, fs/2] 时各频带之和约等于方差
+// 三种实现，结果含义相同：
+//   dspFeaturesRef  标量参考实现 (double，直接DFT)，只用于校验和基准对照
+//   dspFeaturesF32  浮点：两遍扫描，4路独立累加；FFT在有 esp-dsp 时使用其 ESP32-S3 (aes3) 优化版本，
+//                   否则用本模块的基2 FFT
+//   dspFeaturesQ15  定点：输入为原始整数 (ADC计数等)，均值/方差/斜率/过零率用整数精确计算，
+//                   FFT为块浮点Q15 (输入归一化到14位，每级右移1位)；S3的PIE向量指令只支持整数，
+//                   esp-dsp 只有定点FFT能用上，因此定点是设备上的默认流水线
+// 本模块不依赖 Arduino/FreeRTOS，主机端基准直接编译同一份源码
+
+// 窗口长度上限 (FFT长度，2的幂)
+#define DSP_MAX_WINDOW              256
+#define DSP_MIN_WINDOW              8
+#define DSP_MAX_BANDS               4
+
+// esp-dsp 可用时FFT使用其实现，否则用可移植实现
+#if defined(ESP_PLATFORM) && defined(__has_include)
+#if __has_include(<esp_dsp.h>)
+#define DSP_USE_ESP_DSP             1
+#endif
+#endif
+#ifndef DSP_USE_ESP_DSP
+#define DSP_USE_ESP_DSP             0
+#endif
+
+// ==================== 数据结构 ====================
+
+// 频带 [loHz, hiHz)
+typedef struct {
+    float loHz;
+    float hiHz;
+} DspBand;
+
+// 计算计划：窗口参数与预计算表，含FFT工作区 (同一计划不可被多个任务同时使用)
+typedef struct {
+    uint16_t n;                             // 窗口长度
+    uint8_t log2n;
+    float sampleRateHz;
+    float scale;                            // 定点输入每个LSB对应的物理量
+    uint8_t bandCount;
+    uint16_t bandLo[DSP_MAX_BANDS];         // 频带对应的bin范围 [lo, hi)
+    uint16_t bandHi[DSP_MAX_BANDS];
+    float windowPower;                      // Hann窗功率增益 Σw²/N
+    float indexVariance;                    // Σ(i-ī)²
+    float windowF32[DSP_MAX_WINDOW];
+    int16_t windowQ15[DSP_MAX_WINDOW];
+    float twiddleF32[DSP_MAX_WINDOW];       // W^k = (cos, -sin)，k < N/2，交替存放
+    int16_t twiddleQ15[DSP_MAX_WINDOW];
+    uint16_t bitReverse[DSP_MAX_WINDOW];
+    // FFT工作区 (复数交替存放，16字节对齐以满足向量指令)
+    alignas(16) float workF32[DSP_MAX_WINDOW * 2];
+    alignas(16) int16_t workQ15[DSP_MAX_WINDOW * 2];
+} DspPlan;
+
+// 一个窗口的特征 (物理单位)
+typedef struct {
+    float mean;
+    float variance;
+    float slope;                            // 单位/秒
+    float zcr;                              // [0,1]
+    float bandEnergy[DSP_MAX_BANDS];        // 单位²
+} DspFeatures;
+
+// ==================== 函数声明 ====================
+
+// 初始化计划：n 为 [DSP_MIN_WINDOW, DSP_MAX_WINDOW] 内的2的幂，频带按bin取整，
+// scale 只用于定点输入。参数不合法时返回false
+bool dspPlanInit(DspPlan* plan, uint16_t n, float sampleRateHz, float scale,
+                 const DspBand* bands, uint8_t bandCount);
+
+// 标量参考实现 (输入为物理单位)
+void dspFeaturesRef(const DspPlan* plan, const float* x, DspFeatures* out);
+
+// 浮点实现 (输入为物理单位)
+void dspFeaturesF32(DspPlan* plan, const float* x, DspFeatures* out);
+
+// 定点实现 (输入为原始整数，输出 = 原始值 × scale 的物理单位)
+void dspFeaturesQ15(DspPlan* plan, const int16_t* x, DspFeatures* out);
+
+// FFT实现名称："esp-dsp" / "portable"
+const char* dspBackendString();
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef MY_ED25519_H
+#define MY_ED25519_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== Ed25519 签名 ====================
+// RFC 8032 纯 Ed25519 (不带上下文、不预先哈希)，用于固件补丁签名 (MY_OtaPatch)
+// 设备只做校验；签名与由种子导出公钥供主机端工具 (ota_diff / ota_keygen) 使用，私钥不进入固件
+// 域运算为16个16位limb (TweetNaCl 的做法)，代码小、无查表，标量乘按位条件交换，耗时与私钥无关
+// 校验耗时约为两次256位标量乘，设备只在收到补丁头部时执行一次
+// 本模块不依赖 Arduino/FreeRTOS，主机端工具直接编译同一份源码
+
+#define ED25519_SEED_SIZE           32          // 私钥种子
+#define ED25519_PUBLIC_KEY_SIZE     32
+#define ED25519_SIGNATURE_SIZE      64
+
+// ==================== 函数声明 ====================
+
+// 校验签名：公钥不是曲线上的点、S 不小于群阶或签名不符时返回false
+bool ed25519Verify(const uint8_t signature[ED25519_SIGNATURE_SIZE], const uint8_t* message, size_t len,
+                   const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE]);
+
+// 由种子导出公钥 (主机端使用)
+void ed25519PublicKey(const uint8_t seed[ED25519_SEED_SIZE], uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE]);
+
+// 签名 (主机端使用)
+void ed25519Sign(const uint8_t seed[ED25519_SEED_SIZE], const uint8_t* message, size_t len,
+                 uint8_t signature[ED25519_SIGNATURE_SIZE]);
+
+#endif
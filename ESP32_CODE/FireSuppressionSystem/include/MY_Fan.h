@@ -9,6 +9,37 @@
 // ==================== 硬件配置 ====================
 // 风扇控制引脚 (连接到继电器IN口，低电平触发)
 #define FAN_RELAY_PIN 13
+// 继电器断开后的最短关闭时间 (毫秒)，期间的开启请求由风扇任务下个周期重试
+#define FAN_RELAY_MIN_OFF_MS        3000
+
+// ==================== PWM调速配置 ====================
+// 0=继电器开关控制 (默认), 1=PWM调速 (需将继电器换成MOSFET驱动模块，接在同一引脚)
+#define FAN_PWM_ENABLE              0
+#define FAN_PWM_CHANNEL             2
+#define FAN_PWM_FREQ_HZ             25000   // 25kHz，超出人耳范围
+#define FAN_PWM_RESOLUTION          10      // 10位占空比 (0~1023)
+#define FAN_PWM_MIN_PERCENT         30      // 风扇能可靠转动的最低转速
+// 软启动：每秒最多升速的百分比 (降速不受限)
+#define FAN_SOFT_START_PERCENT_PER_S 25
+// PWM模式下的控制周期 (毫秒)
+#define FAN_CONTROL_PERIOD_MS       250
+// 风扇任务两次循环的最大允许间隔 (毫秒)
+#define FAN_TASK_DEADLINE_MS        3000
+
+// ==================== 烟雾闭环控制参数 ====================
+// PI控制：误差 = 滤波后烟雾浓度 - 烟雾安全阈值 (单位%)
+#define FAN_PI_KP                   4.0f    // 每1%误差 → 4%转速
+#define FAN_PI_KI                   0.2f    // 每1%·s积分 → 0.2%转速
+// 烟雾上升趋势前馈：每 1%/s 上升速率 → 10%转速
+#define FAN_TREND_GAIN              10.0f
+// 烟雾浓度一阶滤波时间常数 (毫秒)
+#define FAN_SMOKE_FILTER_TAU_MS     4000
+
+// ==================== 排烟延时参数 ====================
+// 火灾解除后继续排烟的转速 (PWM模式)，延时时长沿用 K230_FAN_DURATION_MS
+#define FAN_PURGE_PERCENT           60
+// 报警持续超过此时长才执行延时排烟，短暂误报直接停机以节省能耗
+#define FAN_PURGE_MIN_EVENT_MS      10000
 
 // ==================== 枚举定义 ====================
 
@@ -44,6 +75,9 @@ typedef struct {
     float lastHumidity;       // 上次检测的湿度
     float lastSmokeLevel;     // 上次检测的烟雾浓度
     bool lastSmokeAlarm;      // 上次的烟雾报警状态
+    uint8_t targetSpeed;      // 目标转速 (%)
+    uint8_t speed;            // 实际输出转速 (%)，继电器模式下为0或100
+    bool purging;             // 是否处于火灾解除后的延时排烟
 } FanControl;
 
 // ==================== 全局变量声明 ====================
@@ -60,11 +94,15 @@ void setupFan();
 void fanOn();
 void fanOff();
 void fanToggle();
+void fanStartPurge();   // 火灾解除后延时排烟 K230_FAN_DURATION_MS 再停机
+void fanForceOff();     // 强制停止输出 (不加锁，仅供受控重启前使用)
 
 // 状态获取函数
 FanState getFanState();
 FanMode getFanMode();
 AlarmReason getAlarmReason();
+uint8_t getFanSpeed();
+bool isFanPurging();
 
 // 模式设置函数
 void setFanMode(FanMode mode);
@@ -0,0 +1,50 @@
+#ifndef MY_FUSION_H
+#define MY_FUSION_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "MY_Zone.h"
+#include "MY_Sensor.h"
+#include "MY_FusionKernels.h"
+
+/*
+ * 多源证据融合的设备端封装：
+ *   证据计算、noisy-OR 与迟滞见 MY_FusionKernels.h，本模块负责互斥锁、
+ *   从运行时配置取阈值、传入 millis()，以及等级变化时的日志与事件上报
+ */
+
+#if ZONE_COUNT > FUSION_MAX_ZONES
+#error "ZONE_COUNT exceeds FUSION_MAX_ZONES"
+#endif
+
+// ==================== 全局变量声明 ====================
+extern SemaphoreHandle_t fusionMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数
+void setupFusion();
+
+// 更新证据 (一次处理全部分区，温度为NaN时跳过该分区温度源，由过期衰减处理传感器失效)
+void fusionUpdateSensors(const ZoneSensorData* data);
+void fusionUpdateK230(float confidence);
+
+// 按当前时间计算全部分区的置信度并更新等级 (迟滞、峰值)，等级变化时上报事件
+// 只由传感器任务在每次采样后调用，其他任务读取缓存的结果
+void fusionEvaluate();
+
+// 最近一次评估的整层结果 (只读)：等级和置信度取最严重的分区
+FireAssessment fusionAssessment();
+// 最近一次评估中单个分区的结果 (只读)
+FireAssessment fusionZoneAssessment(uint8_t zone);
+void fusionGetLevels(FireLevel levels[ZONE_COUNT]);
+
+// 状态获取函数 (整层)
+float getFireScore();
+FireLevel getFireLevel();
+uint8_t getFireZone();
+const char* getFireLevelString();
+const char* getFireLevelName(FireLevel level);
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef MY_FUSION_KERNELS_H
+#define MY_FUSION_KERNELS_H
+
+#include <stdint.h>
+
+/*
+ * 多源证据融合：
+ *   每个证据源给出 [0,1] 的证据强度，超过新鲜期后按指数衰减 (数据过期不再贡献)；
+ *   火灾置信度 = 1 - Π(1 - 权重i × 证据i)  (noisy-OR，单一来源最多贡献其权重)
+ *   执行器按置信度分级动作：
+ *     >= FUSION_ALARM_SCORE    → 报警 (蜂鸣器、排风)
+ *     >= FUSION_SUPPRESS_SCORE → 灭火 (水泵喷水、疏散警报)
+ *     <  FUSION_CLEAR_SCORE    → 恢复安全
+ *   权重使单帧K230误检或单个传感器的短时异常不足以触发喷水；以下情况可由单一来源灭火：
+ *     - K230确认：持续检测 (命中计数达到 FUSION_K230_CONFIRM_HITS) 且平滑置信度足够时证据饱和
+ *     - 烟雾持续：浓度持续高于报警阈值 FUSION_SMOKE_CONFIRM_MS 后置信度至少为灭火阈值
+ *     - 传感器故障：温度/烟雾/DO 中有源过期或从未收到数据时，其余传感器按对数域权重重新归一化
+ *       (例如DHT11损坏时，烟雾+DO 可以达到灭火阈值)
+ *   每个分区独立评估，整层执行器按最严重的分区动作
+ * 证据计算、noisy-OR 与迟滞都在本模块中，时间由调用方传入；
+ * 本模块不依赖 Arduino/FreeRTOS，主机端回放工具直接编译同一份源码
+ */
+
+// ==================== 证据源权重 ====================
+#define FUSION_WEIGHT_SMOKE         0.60f   // MQ-2 模拟浓度及上升斜率
+#define FUSION_WEIGHT_TEMP          0.60f   // DHT11 温度及升温速率
+#define FUSION_WEIGHT_MQ2_DO        0.30f   // MQ-2 数字报警 (与浓度同一传感器，权重较低)
+#define FUSION_WEIGHT_K230          0.90f   // K230 视觉检测
+
+// ==================== 置信度阈值 ====================
+#define FUSION_ALARM_SCORE          0.50f
+#define FUSION_SUPPRESS_SCORE       0.75f
+#define FUSION_CLEAR_SCORE          0.20f
+// 单一证据源达到此强度时视为"该源报警" (用于风扇报警原因)
+#define FUSION_SOURCE_ACTIVE        0.50f
+
+// ==================== 证据计算参数 ====================
+// 浓度/温度在 安全阈值→报警阈值 之间线性映射为 0→1，斜率项最多额外贡献 FUSION_SLOPE_BONUS
+#define FUSION_SLOPE_BONUS          0.50f
+#define FUSION_SMOKE_SLOPE_FULL     2.0f    // 烟雾上升达到此斜率 (%/秒) 时斜率项饱和
+#define FUSION_TEMP_ROR_FULL        8.0f    // 升温达到此速率 (°C/分钟) 时斜率项饱和 (参考差温探测器)
+#define FUSION_SLOPE_ALPHA          0.30f   // 烟雾斜率指数平滑系数
+// 升温速率按至少此时长的窗口计算，并扣除一个DHT11分辨率：读数在相邻两个整数间跳动
+// 不计为升温 (逐次采样计算时，1°C跳变在2秒内相当于30°C/分钟)
+#define FUSION_TEMP_ROR_WINDOW_MS   30000
+#define FUSION_TEMP_RESOLUTION      1.0f
+// K230检测率：命中计数按时间常数指数衰减，达到 FUSION_K230_FULL_HITS 时检测率项饱和
+#define FUSION_K230_RATE_TAU_MS     6000
+#define FUSION_K230_FULL_HITS       2.0f
+// 每次命中的权重 = 距上次命中的时间 / 此值 (最多为1)：K230切换到快速上报后，
+// 检测率项仍按持续检测的时间累积，不会因上报变密而更快饱和
+#define FUSION_K230_HIT_SPACING_MS  2000
+#define FUSION_K230_CONF_ALPHA      0.50f   // 置信度指数平滑系数
+#define FUSION_K230_DEFAULT_CONF    0.80f   // 旧协议 (仅"fire") 没有置信度时使用
+// K230确认：命中计数与平滑置信度都达到此值时证据饱和 (约6秒持续检测；间隔10秒以上的孤立误检达不到)
+#define FUSION_K230_CONFIRM_HITS    2.0f
+#define FUSION_K230_CONFIRM_CONF    0.60f
+// 烟雾持续：浓度高于报警阈值持续此时长后置信度至少为灭火阈值；
+// 回落到 安全与报警阈值的中点 以下才重新计时
+#define FUSION_SMOKE_CONFIRM_MS     300000
+
+// ==================== 过期衰减 ====================
+// 超过新鲜期后证据按 exp(-(age-fresh)/tau) 衰减
+#define FUSION_SENSOR_FRESH_MS      5000    // 传感器 (2个采样周期余量)
+#define FUSION_SENSOR_TAU_MS        10000
+#define FUSION_K230_FRESH_MS        2500    // K230 (空闲档上报间隔最长2秒)
+#define FUSION_K230_TAU_MS          3000
+
+// 分区数上限 (实际分区数由 fusionKernelInit 指定)
+#define FUSION_MAX_ZONES            8
+
+// ==================== 枚举定义 ====================
+
+// 证据源
+typedef enum {
+    FUSION_SRC_SMOKE = 0,
+    FUSION_SRC_TEMP = 1,
+    FUSION_SRC_MQ2_DO = 2,
+    FUSION_SRC_K230 = 3,
+    FUSION_SRC_COUNT = 4
+} FusionSource;
+
+// 火灾等级 (带迟滞)
+typedef enum {
+    FIRE_LEVEL_NONE = 0,        // 安全
+    FIRE_LEVEL_ALARM = 1,       // 报警：蜂鸣器、排风
+    FIRE_LEVEL_SUPPRESS = 2     // 灭火：喷水、疏散警报
+} FireLevel;
+
+// ==================== 数据结构 ====================
+
+// 浓度/温度的 安全→报警 阈值 (设备上取自运行时配置)
+typedef struct {
+    float smokeSafe;
+    float smokeAlarm;
+    float tempSafe;
+    float tempAlarm;
+} FusionThresholds;
+
+// 融合状态：各字段按分区分数组存放，评估时一次遍历全部分区
+typedef struct {
+    uint8_t zoneCount;
+    uint8_t k230Zone;                                           // K230 摄像头所在分区
+    // 证据 [证据源][分区]
+    float evidence[FUSION_SRC_COUNT][FUSION_MAX_ZONES];         // 最近一次更新时的证据强度 [0,1]
+    uint32_t updatedMs[FUSION_SRC_COUNT][FUSION_MAX_ZONES];     // 最近一次更新时间
+    bool valid[FUSION_SRC_COUNT][FUSION_MAX_ZONES];             // 是否收到过数据
+    float effective[FUSION_SRC_COUNT][FUSION_MAX_ZONES];        // 最近一次评估时计入过期衰减后的证据
+    // 斜率估计
+    float lastSmokeLevel[FUSION_MAX_ZONES];
+    float lastTemperature[FUSION_MAX_ZONES];    // 升温速率窗口起点的温度
+    uint32_t lastSmokeMs[FUSION_MAX_ZONES];
+    uint32_t lastTempMs[FUSION_MAX_ZONES];      // 升温速率窗口起点
+    float smokeSlope[FUSION_MAX_ZONES];     // %/秒 (平滑后)
+    float tempRor[FUSION_MAX_ZONES];        // °C/分钟 (最近一个窗口)
+    // 烟雾持续高于报警阈值的起点
+    bool smokeHigh[FUSION_MAX_ZONES];
+    uint32_t smokeHighSinceMs[FUSION_MAX_ZONES];
+    // 输出
+    FireLevel level[FUSION_MAX_ZONES];
+    float score[FUSION_MAX_ZONES];
+    float peakScore[FUSION_MAX_ZONES];      // 当前事件的最高置信度
+    // K230检测率与置信度 (只属于 k230Zone)
+    float k230Hits;                         // 指数衰减的命中计数
+    float k230Confidence;                   // 平滑后的检测置信度
+    uint32_t k230LastMs;
+    // 整层汇总
+    uint8_t worstZone;                      // 等级最高 (同等级取置信度最高) 的分区
+} FusionState;
+
+// 一次评估结果 (整层或单个分区)
+typedef struct {
+    float score;                            // 火灾置信度 [0,1]
+    FireLevel level;                        // 迟滞后的等级
+    float evidence[FUSION_SRC_COUNT];       // 计入过期衰减后的各源证据
+    uint8_t zone;                           // 所属分区 (整层结果为最严重的分区)
+} FireAssessment;
+
+// ==================== 函数声明 ====================
+
+// 全部分区置为未收到数据、安全等级；zoneCount 不超过 FUSION_MAX_ZONES
+void fusionKernelInit(FusionState* state, uint8_t zoneCount, uint8_t k230Zone);
+
+// 更新全部分区的传感器证据，各数组长度为 zoneCount；温度为NaN时跳过该分区温度源
+void fusionKernelUpdateSensors(FusionState* state, const FusionThresholds* thresholds,
+                               const float* temperature, const float* smokeLevel, const bool* smokeAlarm,
+                               uint32_t nowMs);
+
+// 计入一帧K230火焰检测 (置信度 [0,1])
+void fusionKernelUpdateK230(FusionState* state, float confidence, uint32_t nowMs);
+
+// 按 nowMs 计算全部分区的置信度，推进迟滞与峰值；返回最严重的分区
+uint8_t fusionKernelEvaluate(FusionState* state, uint32_t nowMs);
+
+// 最近一次评估中单个分区的结果
+FireAssessment fusionKernelResult(const FusionState* state, uint8_t zone);
+
+// 带迟滞的等级更新
+FireLevel fusionNextLevel(FireLevel level, float score);
+
+#endif
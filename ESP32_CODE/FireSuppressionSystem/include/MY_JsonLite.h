@@ -0,0 +1,85 @@
+#ifndef MY_JSON_LITE_H
+#define MY_JSON_LITE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== 轻量JSON读写 ====================
+// 遥测、配置状态的序列化与命令/配置负载的解析，设备与主机端工具共用同一份实现：
+//   - 写入：按调用顺序输出到调用方缓冲区，长度语义同 snprintf (返回完整输出所需长度，放不下时截断)；
+//           非有限数值 (NaN/Inf) 输出为 null，定点数值去掉末尾的0
+//   - 读取：只解析顶层对象的成员，嵌套的对象/数组做语法检查后整体跳过；
+//           字符串值指向原始负载，不做反转义 (命令中的动作/图案名不含转义字符)
+// 本模块不依赖 Arduino/FreeRTOS，主机端工具直接编译同一份源码
+
+// 嵌套层数上限
+#define JSON_LITE_MAX_DEPTH         8
+// 顶层成员数上限 (超出的成员做语法检查后忽略)
+#define JSON_LITE_MAX_MEMBERS       32
+
+// ==================== 数据结构 ====================
+
+// 写入状态
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;                          // 完整输出所需长度 (不含结尾0)
+    uint8_t depth;
+    bool needComma[JSON_LITE_MAX_DEPTH];
+} JsonLiteWriter;
+
+// 值的类型
+typedef enum {
+    JSON_LITE_NULL = 0,
+    JSON_LITE_BOOL,
+    JSON_LITE_NUMBER,
+    JSON_LITE_STRING,
+    JSON_LITE_OBJECT,
+    JSON_LITE_ARRAY
+} JsonLiteType;
+
+// 顶层对象的一个成员 (指向原始负载)
+typedef struct {
+    const char* key;
+    size_t keyLength;
+    const char* value;                      // 字符串不含引号
+    size_t valueLength;
+    JsonLiteType type;
+} JsonLiteMember;
+
+// 解析后的顶层对象
+typedef struct {
+    JsonLiteMember members[JSON_LITE_MAX_MEMBERS];
+    uint8_t count;
+} JsonLiteObject;
+
+// ==================== 函数声明 ====================
+
+// 写入：key 为NULL时写数组元素或根对象
+void jsonLiteBegin(JsonLiteWriter* w, char* buffer, size_t size);
+void jsonLiteBeginObject(JsonLiteWriter* w, const char* key);
+void jsonLiteEndObject(JsonLiteWriter* w);
+void jsonLiteBeginArray(JsonLiteWriter* w, const char* key);
+void jsonLiteEndArray(JsonLiteWriter* w);
+void jsonLiteString(JsonLiteWriter* w, const char* key, const char* value);    // value 为NULL时写 null
+void jsonLiteBool(JsonLiteWriter* w, const char* key, bool value);
+void jsonLiteInt(JsonLiteWriter* w, const char* key, int64_t value);
+void jsonLiteUint(JsonLiteWriter* w, const char* key, uint64_t value);
+// 按 decimals 位小数四舍五入 (同 round(x × 10^decimals) / 10^decimals)
+void jsonLiteFixed(JsonLiteWriter* w, const char* key, double value, uint8_t decimals);
+// 单精度配置值 (6位有效数字)
+void jsonLiteFloat(JsonLiteWriter* w, const char* key, float value);
+// 写入结尾0，返回完整输出所需长度；返回值 >= size 表示缓冲区不足
+size_t jsonLiteEnd(JsonLiteWriter* w);
+
+// 读取：负载必须是一个完整的JSON对象，否则返回false
+bool jsonLiteParse(const char* json, size_t length, JsonLiteObject* object);
+// 查找成员，不存在返回NULL
+const JsonLiteMember* jsonLiteFind(const JsonLiteObject* object, const char* key);
+// 字符串成员与 text 相等
+bool jsonLiteEquals(const JsonLiteMember* member, const char* text);
+// 数值成员转换；类型不符或超出范围时返回false
+bool jsonLiteToDouble(const JsonLiteMember* member, double* value);
+bool jsonLiteToUint32(const JsonLiteMember* member, uint32_t* value);
+
+#endif
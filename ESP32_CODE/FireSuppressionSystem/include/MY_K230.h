@@ -10,24 +10,99 @@
 // ==================== 硬件配置 ====================
 // K230串口配置 (使用Serial1)
 #define K230_SERIAL         Serial1
-#define K230_BAUD_RATE      115200
+#define K230_BAUD_RATE      115200  // 上电/回落时的基础速率
 #define K230_RX_PIN         18      // ESP32-S3 RX 接 K230 TX
 #define K230_TX_PIN         17      // ESP32-S3 TX 接 K230 RX
+// UART驱动接收环形缓冲 (中断把硬件FIFO搬入此处)，921600波特下约可容纳90ms数据
+#define K230_RX_BUFFER_SIZE 8192
+// K230任务单次从驱动缓冲批量读取的字节数
+#define K230_RX_CHUNK_SIZE  256
 
 // ==================== 协议定义 ====================
-// K230发送的火焰检测命令
+// K230发送的火焰检测命令，后面可跟空格和检测置信度，如 "fire 0.87"
 #define K230_FIRE_CMD       "fire"
-#define K230_BUFFER_SIZE    32
+// K230周期心跳: "hb <累计帧数> <FPS> <平均推理ms> <模型ID>"，如 "hb 15230 14.8 41.2 fire_det"
+// 没有火焰时K230也会定期发送，ESP32据此区分"无火"与"视觉链路故障"
+#define K230_HEARTBEAT_CMD  "hb"
+#define K230_BUFFER_SIZE    64
+#define K230_MODEL_ID_SIZE  24
+
+// 二进制帧 (检测快照分块)，与文本行共用串口，以 0xA5 0x5A 开头 (文本行只含ASCII，不会出现这两个字节)
+// | A5 5A | 类型(1) | 快照ID(2) | 块序号(2) | 块数(2) | 总长(4) | 偏移(4) | 长度(2) | 数据 | CRC32(4) |
+// 多字节字段为小端，CRC32与zlib相同，覆盖"类型"至"数据"
+#define K230_FRAME_MAGIC0           0xA5
+#define K230_FRAME_MAGIC1           0x5A
+#define K230_FRAME_HEADER_SIZE      17      // "类型"至"长度"
+#define K230_FRAME_TYPE_JPEG        0x01
+#define K230_FRAME_MAX_PAYLOAD      1024
+// 帧开始后超过此时间仍未收完则丢弃半帧，回到文本行解析
+#define K230_FRAME_TIMEOUT_MS       200
+
+// 波特率协商 (ESP32 -> K230 文本行)：
+//   ESP32 "baud <N>" -> K230以旧速率回复 "baud_ok <N>" 后切换
+//   ESP32 切换后发送 "baud_confirm" -> K230回复 "baud_active <N>"
+//   任一步超时双方都回落到 K230_BAUD_RATE
+#define K230_BAUD_CMD               "baud"
+#define K230_BAUD_OK_CMD            "baud_ok"
+#define K230_BAUD_CONFIRM_CMD       "baud_confirm"
+#define K230_BAUD_ACTIVE_CMD        "baud_active"
+// 高速率期间ESP32定期发送 "baud_keep"，K230超过3个周期收不到任何行即自行回落
+#define K230_BAUD_KEEPALIVE_CMD     "baud_keep"
+
+// 检测参数下发 (ESP32 -> K230)：
+//   "cfg <上报间隔ms> <置信度阈值> <ROI x> <ROI y> <ROI w> <ROI h>"，如 "cfg 100 0.45 0 0 1000 1000"
+//   ROI 以画面千分比表示，与分辨率无关；置信度阈值为0表示使用模型部署配置中的值
+//   K230应用后原样回复 "cfg_ok ..."，ESP32据此确认参数已生效
+#define K230_CFG_CMD                "cfg"
+#define K230_CFG_OK_CMD             "cfg_ok"
 
 // ==================== 火焰检测参数 ====================
-// 火焰检测后的风扇持续运行时间 (毫秒)
+// 火焰解除后风扇继续排烟的时间 (毫秒)，传感器判定恢复安全后同样适用
 #define K230_FAN_DURATION_MS        60000   // 60秒
-// 火焰检测后的水泵喷水时间 (毫秒)
-#define K230_PUMP_SPRAY_MS          15000   // 15秒
+// 火焰检测后的水泵喷水时间、火焰状态超时时间可在线配置，出厂默认值见 MY_ConfigCore.h
 // 连续检测到火焰的确认次数 (防抖)
 #define K230_FIRE_CONFIRM_COUNT     1       // 立即响应，不做防抖
-// 火焰状态超时时间 (毫秒) - 超过此时间未收到fire则认为火焰消失
-#define K230_FIRE_TIMEOUT_MS        5000    // 5秒
+// 参数下发生效后火焰超时取 min(配置值, 上报间隔 × K230_FIRE_TIMEOUT_REPORTS)，快速上报时火焰解除也更快
+#define K230_FIRE_TIMEOUT_REPORTS   3       // 连续错过几次上报判定火焰消失
+#define K230_FIRE_TIMEOUT_MIN_MS    500     // 下限 (K230帧率约15FPS，避免单帧漏检即解除)
+// 无串口数据时K230任务检查超时的周期 (毫秒)，有数据时立即唤醒
+#define K230_IDLE_WAIT_MS           100
+// K230任务两次循环的最大允许间隔 (毫秒)，超出计为超时
+#define K230_TASK_DEADLINE_MS       1000
+
+// ==================== 视觉链路监测参数 ====================
+// K230心跳发送间隔 (毫秒)，与 fire_detection.py 中 HEARTBEAT_INTERVAL_MS 一致
+#define K230_HEARTBEAT_INTERVAL_MS  5000
+// 心跳超时与帧率下限可在线配置，出厂默认值见 MY_ConfigCore.h
+// 连续多少个心跳低于帧率下限才判定低帧率 (避免偶发抖动)
+#define K230_LOW_FPS_COUNT          3
+// 推理耗时平均值的平滑系数 (新样本权重)
+#define K230_INFER_EWMA_ALPHA       0.2f
+
+// ==================== 高速链路参数 ====================
+// 协商的目标波特率，0表示保持 K230_BAUD_RATE 不协商
+#define K230_HIGH_BAUD_RATE         921600
+// 发出 "baud" 后等待 "baud_ok" 的时间 (毫秒)，超时视为K230不支持
+#define K230_BAUD_REPLY_MS          1000
+// 收到 "baud_ok" 后等待K230完成切换再发送确认 (毫秒)，K230发出应答后约20ms切换
+#define K230_BAUD_SETTLE_MS         50
+// 切换后等待 "baud_active" 的时间 (毫秒)，需大于K230一侧的确认等待 (1000ms)
+#define K230_BAUD_VERIFY_MS         1500
+// 高速率期间发送 "baud_keep" 的间隔 (毫秒)
+#define K230_BAUD_KEEPALIVE_MS      5000
+// 协商失败后的重试间隔 (毫秒)
+#define K230_BAUD_RETRY_MS          60000
+// 接收速率统计窗口 (毫秒)
+#define K230_RATE_WINDOW_MS         1000
+
+// ==================== 自适应上报参数 ====================
+// 空闲/警戒两档上报间隔与置信度阈值可在线配置，出厂默认值见 MY_ConfigCore.h
+// 第K230_ZONE区任一传感器证据 (烟雾/温度/MQ-2 DO) 达到此值、火灾等级达到报警或视觉检测到火焰时进入警戒
+#define K230_ALERT_EVIDENCE         0.20f
+// 触发条件消失后保持警戒的时间 (毫秒)，避免在阈值附近反复切换
+#define K230_ALERT_HOLD_MS          30000
+// 参数下发后等待 "cfg_ok" 的时间 (毫秒)，超时重发
+#define K230_CFG_RETRY_MS           1000
 
 // ==================== 枚举定义 ====================
 
@@ -35,9 +110,33 @@
 typedef enum {
     K230_FIRE_NONE = 0,         // 未检测到火焰
     K230_FIRE_DETECTED = 1,     // 检测到火焰
-    K230_FIRE_CONFIRMED = 2     // 火焰已确认（触发灭火）
+    K230_FIRE_CONFIRMED = 2     // 火焰已确认（作为视觉证据参与融合评估）
 } K230FireState;
 
+// 视觉链路状态
+typedef enum {
+    K230_LINK_WAITING = 0,      // 上电后尚未收到心跳 (未超时)
+    K230_LINK_OK = 1,           // 心跳正常且帧计数在增长
+    K230_LINK_LOST = 2,         // 心跳超时：K230掉电/死机或串口线断开
+    K230_LINK_STALLED = 3,      // 心跳正常但帧计数不再增长：摄像头或模型卡死
+    K230_LINK_LOW_FPS = 4       // 帧率持续低于下限
+} K230LinkState;
+
+// 检测上报档位
+typedef enum {
+    K230_REPORT_IDLE = 0,       // 空闲：稀疏上报，降低串口与两端CPU负载
+    K230_REPORT_ALERT = 1       // 警戒：传感器读数升高，快速上报以降低检测与解除延迟
+} K230ReportMode;
+
+// 串口速率协商状态
+typedef enum {
+    K230_BAUD_BASE = 0,         // 基础速率，等待链路正常后协商
+    K230_BAUD_REQUESTED = 1,    // 已发送 "baud <N>"，等待 "baud_ok"
+    K230_BAUD_VERIFYING = 2,    // 已切换到高速率，等待 "baud_active"
+    K230_BAUD_HIGH = 3,         // 高速率工作中
+    K230_BAUD_FAILED = 4        // 协商失败，基础速率工作，等待重试
+} K230BaudState;
+
 // ==================== 数据结构 ====================
 
 // K230状态结构体
@@ -50,8 +149,57 @@ typedef struct {
     bool suppressionActive;         // 灭火系统是否激活
 } K230Control;
 
+// K230视觉链路健康状态 (由心跳帧更新)
+typedef struct {
+    K230LinkState linkState;        // 当前链路状态
+    unsigned long lastHeartbeatTime;// 上次收到心跳的时间 (0=从未收到)
+    uint32_t heartbeats;            // 累计心跳数
+    uint32_t frames;                // K230上报的累计处理帧数
+    float fps;                      // K230上报的帧率
+    float inferMs;                  // 最近一个心跳周期的平均推理耗时
+    float inferAvgMs;               // 推理耗时平滑值
+    float inferMaxMs;               // 推理耗时最大值 (开机以来)
+    char modelId[K230_MODEL_ID_SIZE];
+    uint8_t lowFpsCount;            // 连续低帧率心跳数
+    uint32_t faults;                // 进入故障状态的次数
+    uint32_t restarts;              // 帧计数回退次数 (K230重启)
+    uint32_t badFrames;             // 无法解析的行数
+} K230Health;
+
+// K230串口链路统计 (速率协商与二进制帧)
+typedef struct {
+    K230BaudState baudState;        // 速率协商状态
+    uint32_t baudRate;              // 当前波特率
+    uint32_t upgrades;              // 协商成功次数
+    uint32_t fallbacks;             // 协商失败或高速率下链路丢失而回落的次数
+    uint64_t rxBytes;               // 累计接收字节数
+    uint32_t rxBytesPerSec;         // 最近统计窗口的接收速率
+    uint32_t frames;                // 校验通过的二进制帧数
+    uint32_t crcErrors;             // CRC错误帧数
+    uint32_t frameErrors;           // 长度非法或帧内超时的帧数
+} K230LinkStats;
+
+// K230检测参数 (下发与确认)
+typedef struct {
+    uint32_t intervalMs;            // 火焰上报间隔
+    float confThreshold;            // 置信度阈值 (0=模型默认)
+    uint16_t roi[4];                // 检测区域 x, y, w, h (千分比)
+} K230DetectParams;
+
+// K230检测参数下发状态
+typedef struct {
+    K230ReportMode mode;            // 当前上报档位
+    K230DetectParams applied;       // K230已确认的参数
+    bool synced;                    // applied 与期望参数一致
+    uint32_t commands;              // 已发送的 cfg 命令数
+    uint32_t modeChanges;           // 档位切换次数
+    unsigned long lastTriggerTime;  // 最近一次满足警戒条件的时间
+} K230ControlStatus;
+
 // ==================== 全局变量声明 ====================
 extern K230Control k230Control;
+extern K230Health k230Health;
+extern K230LinkStats k230LinkStats;
 extern TaskHandle_t k230TaskHandle;
 extern SemaphoreHandle_t k230Mutex;
 
@@ -66,12 +214,28 @@ bool isK230FireDetected();
 unsigned long getK230LastFireTime();
 
 // 火焰处理函数
-void handleK230FireDetected();
+void handleK230FireDetected(float confidence);
 void resetK230FireState();
 
 // 状态字符串转换 (用于MQTT发布)
 const char* getK230FireStateString();
 
+// 视觉链路健康状态
+K230Health getK230Health();
+bool isK230VisionFault();
+const char* getK230LinkStateString(K230LinkState state);
+void printK230Report();
+
+// 串口链路 (速率协商与二进制帧)
+K230LinkStats getK230LinkStats();
+const char* getK230BaudStateString(K230BaudState state);
+void k230SendLine(const char* line);
+
+// 检测参数下发与自适应上报
+K230ControlStatus getK230ControlStatus();
+const char* getK230ReportModeString(K230ReportMode mode);
+unsigned long getK230FireTimeoutMs();
+
 // RTOS任务函数
 void k230Task(void *pvParameters);
 
@@ -0,0 +1,50 @@
+#ifndef MY_LOCAL_SERVER_H
+#define MY_LOCAL_SERVER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "MY_LocalServerCore.h"
+
+// ==================== 本地服务器配置 ====================
+// 局域网内的手机可直接连接设备获取实时数据，不经过公网Broker
+// 0=关闭, 1=开启 (无鉴权，仅建议在可信局域网内开启)
+#define LOCAL_SERVER_ENABLE         0
+#define LOCAL_SERVER_PORT           80
+// SSE长连接的最大客户端数
+#define LOCAL_SERVER_MAX_CLIENTS    4
+// 请求缓冲区大小 (请求头 + 命令JSON)
+#define LOCAL_SERVER_REQUEST_SIZE   1024
+// 读取请求的超时时间 (毫秒)
+#define LOCAL_SERVER_READ_TIMEOUT_MS 500
+// 服务器任务轮询周期 (毫秒)
+#define LOCAL_SERVER_POLL_MS        200
+
+/*
+ * 接口说明：
+ *   GET  /events              SSE推送，每次数据与 fire_alarm/sensor_data 相同
+ *   GET  /state               当前状态快照 (JSON)
+ *   POST /fan/control 等      请求体与对应MQTT控制Topic的消息相同，如 {"action":"on"}
+ * Socket部分见 MY_LocalServerCore (HOST_CODE/LocalServer 在主机回环上测试)
+ */
+
+// ==================== 全局变量声明 ====================
+extern TaskHandle_t localServerTaskHandle;
+extern SemaphoreHandle_t localServerMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数
+void setupLocalServer();
+
+// 将一帧已序列化的JSON推送给所有SSE客户端（不复制payload）
+void localServerBroadcast(const char* json, size_t length);
+
+// 状态获取函数
+LocalServerStats getLocalServerStats();
+
+// RTOS任务函数
+void localServerTask(void *pvParameters);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef MY_LOCAL_SERVER_CORE_H
+#define MY_LOCAL_SERVER_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== 本地服务器Socket核心 ====================
+// MY_LocalServer 的网络部分：单任务select模型，HTTP短连接 (命令/快照) + SSE长连接 (推送)
+//   - SSE客户端数固定上限，满时返回503
+//   - 推送用sendmsg分散写：SSE前缀/payload/结尾三段直接交给协议栈，
+//     同一个payload缓冲区被所有客户端共享，不做逐客户端拷贝
+//   - 非阻塞发送，发送不完整的客户端 (过慢) 标记后由轮询方关闭，不拖慢推送方
+// 加锁、状态序列化与命令分发由调用方通过 LocalCoreHandlers 提供
+// 本模块只使用BSD Socket (设备上为lwIP)，不依赖 Arduino/FreeRTOS，主机端回环测试直接编译同一份源码
+
+// 客户端槽位上限 (实际上限由 localCoreOpen 的 maxClients 指定)
+#define LOCAL_CORE_MAX_CLIENTS      8
+
+// ==================== 数据结构 ====================
+
+// 服务器统计
+typedef struct {
+    uint8_t clients;            // 当前SSE客户端数
+    uint32_t framesSent;        // 累计推送帧数 (按客户端计)
+    uint32_t clientsDropped;    // 因发送失败/过慢被断开的客户端数
+    uint32_t rejected;          // 因连接数已满被拒绝的次数
+    uint32_t commands;          // 已处理的控制命令数
+} LocalServerStats;
+
+// 调用方提供的处理函数 (lock/unlock 保护客户端槽位与统计，推送与轮询在不同任务中调用)
+typedef struct {
+    void* ctx;
+    void (*lock)(void* ctx);
+    void (*unlock)(void* ctx);
+    // GET /state：把当前状态JSON写入buffer，返回长度，0=失败
+    size_t (*state)(void* ctx, char* buffer, size_t size);
+    // POST：path 如 "/fan/control"，body 为请求体；返回false表示无此命令
+    bool (*command)(void* ctx, const char* path, const char* body);
+    // 连接/断开/命令日志，可为NULL
+    void (*log)(void* ctx, const char* message);
+} LocalCoreHandlers;
+
+// SSE客户端槽位
+typedef struct {
+    int fd;             // -1 表示空闲
+    bool closing;       // 发送失败，待轮询方关闭
+} LocalCoreClient;
+
+typedef struct {
+    int listenFd;
+    uint8_t maxClients;
+    uint32_t readTimeoutMs;                 // 读取一个请求的超时时间
+    LocalCoreClient clients[LOCAL_CORE_MAX_CLIENTS];
+    LocalServerStats stats;
+    LocalCoreHandlers handlers;
+    char* request;                          // 请求缓冲区 (仅轮询方使用)
+    size_t requestSize;
+    char* response;                         // GET /state 的响应缓冲区 (仅轮询方使用)
+    size_t responseSize;
+} LocalServerCore;
+
+// ==================== 函数声明 ====================
+
+// 监听 port (0=由系统分配，用 localCorePort 查询)；失败返回false
+bool localCoreOpen(LocalServerCore* core, uint16_t port, uint8_t maxClients, uint32_t readTimeoutMs,
+                   char* request, size_t requestSize, char* response, size_t responseSize,
+                   const LocalCoreHandlers* handlers);
+uint16_t localCorePort(const LocalServerCore* core);
+
+// 轮询一次：关闭待关闭的客户端，最长等待 timeoutMs，处理断开和一个新连接
+void localCorePoll(LocalServerCore* core, uint32_t timeoutMs);
+
+// 将一帧已序列化的JSON推送给所有SSE客户端（不复制payload）
+void localCoreBroadcast(LocalServerCore* core, const char* json, size_t length);
+
+LocalServerStats localCoreStats(LocalServerCore* core);
+
+// 关闭监听和所有客户端
+void localCoreClose(LocalServerCore* core);
+
+#endif
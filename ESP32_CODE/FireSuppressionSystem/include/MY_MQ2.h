@@ -7,9 +7,7 @@
 #define MQ2_AO_PIN 15  // 模拟输出引脚
 #define MQ2_DO_PIN 16  // 数字输出引脚（报警输出）
 
-// 烟雾报警阈值
-#define SMOKE_ALARM_THRESHOLD 30.0f // 超过此浓度判定为火灾
-#define SMOKE_SAFE_THRESHOLD 15.0f  // 低于此浓度可解除火灾状态
+// 烟雾报警/安全阈值可在线配置，出厂默认值见 MY_ConfigCore.h
 
 // MQ-2 数据结构
 struct MQ2Data {
@@ -21,6 +19,9 @@ struct MQ2Data {
 // 函数声明
 void setupMQ2();
 MQ2Data readMQ2();
+// 多分区：按指定引脚配置/读取一路MQ-2
+void setupMQ2Pins(uint8_t aoPin, uint8_t doPin);
+MQ2Data readMQ2Pins(uint8_t aoPin, uint8_t doPin);
 
 // 全局变量声明
 extern MQ2Data currentMQ2Data;
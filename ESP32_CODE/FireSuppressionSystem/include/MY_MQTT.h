@@ -5,6 +5,7 @@
 #include <PubSubClient.h>
 #include <ArduinoJson.h>
 #include "MY_K230.h"
+#include "MY_Outbox.h"
 
 // ==================== WiFi配置 ====================
 extern const char* WIFI_SSID;
@@ -15,6 +16,8 @@ extern const char* MQTT_BROKER;
 extern const int MQTT_PORT;
 extern const char* MQTT_CLIENT_ID;
 extern const char* DEVICE_ID;
+extern const char* MQTT_USERNAME;             // Broker账号 (空=匿名)
+extern const char* MQTT_PASSWORD;
 
 // MQTT Topics
 extern const char* MQTT_TOPIC_SENSOR;         // 传感器数据发布Topic
@@ -24,37 +27,89 @@ extern const char* MQTT_TOPIC_PUMP_CONTROL;   // 水泵控制订阅Topic
 extern const char* MQTT_TOPIC_PUMP_MODE;      // 水泵模式订阅Topic
 extern const char* MQTT_TOPIC_BUZZER_CONTROL; // 蜂鸣器控制订阅Topic
 extern const char* MQTT_TOPIC_BUZZER_MODE;    // 蜂鸣器模式订阅Topic
+extern const char* MQTT_TOPIC_ALARM;          // 报警事件发布Topic
+extern const char* MQTT_TOPIC_STATUS;         // 在线状态Topic (retained, 含遗嘱)
+extern const char* MQTT_TOPIC_CONFIG;         // 运行时配置订阅Topic
+extern const char* MQTT_TOPIC_CONFIG_STATE;   // 当前配置发布Topic (retained)
+extern const char* MQTT_TOPIC_SNAPSHOT;       // 检测快照描述发布Topic (JSON)
+extern const char* MQTT_TOPIC_SNAPSHOT_DATA;  // 检测快照数据块发布Topic (二进制)
+extern const char* MQTT_TOPIC_BOOT;           // 启动报告发布Topic (每次启动一次)
+
+// ==================== 连接参数 ====================
+#define MQTT_TASK_PERIOD_MS         100     // 未连接时MQTT任务的运行周期
+#define MQTT_RX_WAIT_MS             10      // 已连接时等待Socket可读的最长时间
+#define MQTT_RX_MAX_PACKETS         8       // 单轮最多处理的入站报文数
+#define MQTT_PUBLISH_INTERVAL_MS    1000    // 传感器数据发布间隔
+#define MQTT_TX_POOL_SIZE           4       // 发布缓冲池大小
+#define MQTT_TX_BUFFER_SIZE         OUTBOX_PAYLOAD_SIZE     // 单个发布缓冲区大小 (与离线缓存一致)
+#define MQTT_KEEPALIVE_S            10      // 心跳间隔，Broker在1.5倍时间内未收到心跳即发布遗嘱
+#define MQTT_SOCKET_TIMEOUT_S       3       // 等待CONNACK/单次读写的超时时间
+#define MQTT_DNS_TIMEOUT_MS         5000    // 异步解析Broker域名的最长等待时间
+#define MQTT_TCP_CONNECT_TIMEOUT_MS 5000    // 非阻塞TCP连接的最长等待时间
+#define WIFI_CONNECT_TIMEOUT_MS     10000   // 单次WiFi重连等待时间
+#define MQTT_BACKOFF_MIN_MS         1000    // 重连退避最小值
+#define MQTT_BACKOFF_MAX_MS         60000   // 重连退避最大值
+
+// ==================== 枚举定义 ====================
+
+// 连接状态
+typedef enum {
+    LINK_WIFI_DOWN = 0,         // WiFi未连接 (等待退避后重连)
+    LINK_WIFI_CONNECTING = 1,   // WiFi连接中
+    LINK_MQTT_CONNECTING = 2,   // WiFi已连接，等待/尝试连接Broker
+    LINK_CONNECTED = 3          // MQTT已连接
+} MqttLinkState;
+
+// ==================== 数据结构 ====================
+
+// 连接统计
+typedef struct {
+    MqttLinkState state;            // 当前连接状态
+    uint32_t attempts;              // 累计Broker连接尝试次数
+    uint32_t reconnects;            // 断线后重连成功次数
+    unsigned long wifiConnectMs;    // 最近一次WiFi连接耗时
+    unsigned long mqttConnectMs;    // 最近一次Broker连接耗时
+    unsigned long lastOutageMs;     // 最近一次断线时长
+    unsigned long backoffMs;        // 当前退避时间
+} MqttLinkStats;
 
 // ==================== 全局对象 ====================
 extern WiFiClient espClient;
 extern PubSubClient mqttClient;
+extern MqttLinkStats mqttLinkStats;
 
 // ==================== FreeRTOS任务句柄 ====================
 extern TaskHandle_t mqttTaskHandle;
+extern TaskHandle_t telemetryTaskHandle;
 
 // ==================== 函数声明 ====================
 
 void setupWiFi();
 void setupMQTT();
-void reconnectMQTT();
+void updateMqttConnection();
 void subscribeControlTopics();
 
 // MQTT回调
 void mqttCallback(char* topic, byte* payload, unsigned int length);
+bool dispatchCommand(const char* topic, const char* message);
 
-// 命令处理
-void handleFanControlCommand(const char* payload);
-void handleFanModeCommand(const char* payload);
-void handlePumpControlCommand(const char* payload);
-void handlePumpModeCommand(const char* payload);
-void handleBuzzerControlCommand(const char* payload);
-void handleBuzzerModeCommand(const char* payload);
+// 配置命令处理
+void handleConfigCommand(const char* payload);
 
 // 数据发布
 void publishSensorData(float temperature, float humidity, float smokeLevel, bool smokeAlarm);
 String createJsonPayload(float temperature, float humidity, float smokeLevel, bool smokeAlarm);
+size_t createJsonPayload(char* buffer, size_t size, float temperature, float humidity, float smokeLevel, bool smokeAlarm);
+
+// 序列化到固定缓冲区；放不下时不截断，记录错误并返回0 (调用方据此跳过发布)
+size_t serializeJsonChecked(const JsonDocument& doc, char* buffer, size_t size, const char* what);
+
+// 报警事件 (经离线缓存队列发布，断网期间不丢失)
+void queueAlarmEvent(const char* source, const char* event);
+void queueAlarmEvent(const char* source, const char* event, const char* zone);
 
 // RTOS任务
-void mqttTask(void *pvParameters);
+void mqttTask(void *pvParameters);          // 连接管理 + 命令接收 + 发送
+void telemetryTask(void *pvParameters);     // 传感器数据序列化
 
 #endif
@@ -0,0 +1,111 @@
+#ifndef MY_MEMORY_H
+#define MY_MEMORY_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+#include <freertos/event_groups.h>
+
+// ==================== 内存分配模式 ====================
+// 0=任务/互斥锁/队列从堆上创建 (默认), 1=全部使用编译期静态存储
+// 静态模式下这些对象在链接时即占用内部RAM，运行期堆上只剩网络与JSON的临时分配
+// 可由编译参数覆盖 (platformio.ini 的 esp32-s3-devkitc-1-static 环境)
+#ifndef STATIC_ALLOCATION_ENABLE
+#define STATIC_ALLOCATION_ENABLE    0
+#endif
+
+// ==================== 任务栈大小 (字节) ====================
+// 按 printMemoryReport() 打印的栈高水位调整：建议值 = 实际最大用量 + MEMORY_STACK_MARGIN_BYTES
+#define TASK_STACK_SUPERVISOR       4096
+#define TASK_STACK_FAN              4096
+#define TASK_STACK_PUMP             4096
+#define TASK_STACK_K230             4096
+#define TASK_STACK_BUZZER           2048
+#define TASK_STACK_MQTT             8192
+#define TASK_STACK_TELEMETRY        8192
+#define TASK_STACK_LOCAL_SERVER     4096
+#define TASK_STACK_SENSOR           4096
+#define TASK_STACK_OTA              8192    // 补丁头部的签名校验约需4KB
+#define TASK_STACK_DSP              4096
+// 建议栈大小在实测用量之上保留的余量
+#define MEMORY_STACK_MARGIN_BYTES   512
+// 最多记录的任务数
+#define MEMORY_MAX_TRACKED_TASKS    12
+
+// ==================== 创建宏 ====================
+// 每次展开生成独立的lambda，其中的静态存储只属于这一个对象
+
+// 创建模块互斥锁
+#if STATIC_ALLOCATION_ENABLE
+#define CREATE_MODULE_MUTEX() \
+    ([]() { \
+        static StaticSemaphore_t mutexBuffer; \
+        return xSemaphoreCreateMutexStatic(&mutexBuffer); \
+    }())
+#else
+#define CREATE_MODULE_MUTEX() xSemaphoreCreateMutex()
+#endif
+
+// 创建队列 (length 与 itemSize 需为编译期常量)
+#if STATIC_ALLOCATION_ENABLE
+#define CREATE_MODULE_QUEUE(length, itemSize) \
+    ([]() { \
+        static uint8_t queueStorage[(length) * (itemSize)]; \
+        static StaticQueue_t queueBuffer; \
+        return xQueueCreateStatic(length, itemSize, queueStorage, &queueBuffer); \
+    }())
+#else
+#define CREATE_MODULE_QUEUE(length, itemSize) xQueueCreate(length, itemSize)
+#endif
+
+// 创建事件组
+#if STATIC_ALLOCATION_ENABLE
+#define CREATE_MODULE_EVENT_GROUP() \
+    ([]() { \
+        static StaticEventGroup_t eventGroupBuffer; \
+        return xEventGroupCreateStatic(&eventGroupBuffer); \
+    }())
+#else
+#define CREATE_MODULE_EVENT_GROUP() xEventGroupCreate()
+#endif
+
+// 创建固定核心的任务并登记到栈用量报告 (参数需为常量或全局对象)
+#if STATIC_ALLOCATION_ENABLE
+#define CREATE_PINNED_TASK(function, name, stackBytes, priority, handle, core) \
+    (*(handle) = memoryTrackTask([]() { \
+        static StackType_t taskStack[(stackBytes) / sizeof(StackType_t)]; \
+        static StaticTask_t taskBuffer; \
+        return xTaskCreateStaticPinnedToCore(function, name, stackBytes, NULL, priority, \
+                                             taskStack, &taskBuffer, core); \
+    }(), name, stackBytes))
+#else
+#define CREATE_PINNED_TASK(function, name, stackBytes, priority, handle, core) \
+    (xTaskCreatePinnedToCore(function, name, stackBytes, NULL, priority, handle, core), \
+     memoryTrackTask(*(handle), name, stackBytes))
+#endif
+
+// ==================== 数据结构 ====================
+
+// 内部RAM堆状态
+typedef struct {
+    uint32_t freeBytes;         // 空闲总量
+    uint32_t largestBlock;      // 最大连续空闲块
+    uint32_t minFreeBytes;      // 开机以来的最低空闲量
+    uint8_t fragPct;            // 碎片率 = 1 - 最大块/空闲总量 (%)
+    uint8_t maxFragPct;         // 开机以来观测到的最高碎片率
+} HeapStatus;
+
+// ==================== 函数声明 ====================
+
+// 登记任务，用于栈高水位报告 (由 CREATE_PINNED_TASK 调用)
+TaskHandle_t memoryTrackTask(TaskHandle_t handle, const char* name, uint32_t stackBytes);
+
+// 状态获取函数
+HeapStatus getHeapStatus();
+
+// 打印堆碎片与各任务栈用量
+void printMemoryReport();
+
+#endif
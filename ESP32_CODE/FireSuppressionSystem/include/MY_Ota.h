@@ -0,0 +1,114 @@
+#ifndef MY_OTA_H
+#define MY_OTA_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "MY_OtaPatch.h"
+#include "MY_OtaBoot.h"
+
+/*
+ * MQTT固件升级 (A/B分区 + 增量补丁)：
+ *   主机 (HOST_CODE/Ota/ota_server) 在 OTA_TOPIC_OFFER/<device_id> 上发布升级描述，
+ *   设备在 OTA_TOPIC_STATUS 上回复状态，主机再在 OTA_TOPIC_DATA/<device_id> 上按序分块发送补丁
+ *   补丁 (MY_OtaPatch) 头部带发布者的 Ed25519 签名，设备用 MY_OtaKey.h 中的公钥校验，不符时不写入任何数据
+ *   补丁以当前运行的镜像为基准，边接收边解压、应用并写入另一个OTA分区，
+ *   写完校验SHA-256 (写入流 + 回读分区) 后切换启动分区重启，新镜像进入试运行 (MY_OtaBoot)，
+ *   签到窗口内未签到或反复重启则切回原分区
+ *   流量控制：设备最多缓存 OTA_RX_SLOTS 块，状态中的 next/done 为已接收/已写入的块数，
+ *   主机只发送 done + OTA_RX_SLOTS 以内的块，丢块时从 next 重发
+ */
+
+// ==================== 升级配置 ====================
+// 当前固件版本 (发布新版本时修改)
+#define FIRMWARE_VERSION            "1.0.0"
+// 0=关闭 (默认), 1=开启 (分区表需含 ota_0/ota_1，default_16MB.csv 满足)
+// 开启前需用 ota_keygen 生成 MY_OtaKey.h；补丁须带该密钥的签名，并在Broker上限制 fire_alarm/ota/# 的发布权限 (见文档)
+// 关闭时不订阅升级Topic，试运行签到与回滚照常工作；可在 platformio.ini 中以 -DOTA_ENABLE=1 开启
+#ifndef OTA_ENABLE
+#define OTA_ENABLE                  0
+#endif
+#define OTA_TOPIC_OFFER             "fire_alarm/ota/offer/"     // 后接 device_id
+#define OTA_TOPIC_DATA              "fire_alarm/ota/data/"      // 后接 device_id
+#define OTA_TOPIC_STATUS            "fire_alarm/ota/status"
+// 数据块：头部 升级编号(2) 保留(2) 块序号(4)，小端，其后为补丁数据
+#define OTA_DATA_HEADER_SIZE        8
+#define OTA_CHUNK_MAX               2048
+// 接收缓冲槽位数 (主机发送窗口)
+#define OTA_RX_SLOTS                4
+// 补丁最大字节数 (完整镜像同样受此限制)
+#define OTA_PATCH_MAX_BYTES         (4 * 1024 * 1024)
+// 接收中超过此时间没有新数据则放弃本次升级
+#define OTA_STALL_TIMEOUT_MS        60000
+// 试运行：启动后需在此时间内签到，否则回滚
+#define OTA_CHECKIN_WINDOW_MS       300000
+// 签到条件：MQTT已连接、运行超过此时间且任务监控没有超时记录
+#define OTA_CHECKIN_STABLE_MS       30000
+// 写入完成、发布状态后等待多久重启
+#define OTA_REBOOT_DELAY_MS         2000
+// OTA任务空闲时的检查周期
+#define OTA_TASK_PERIOD_MS          1000
+// 试运行记录 (NVS)
+#define OTA_NVS_NAMESPACE           "fire_ota"
+#define OTA_NVS_KEY                 "boot"
+
+// ==================== 枚举定义 ====================
+
+typedef enum {
+    OTA_IDLE = 0,               // 无升级
+    OTA_RECEIVING = 1,          // 接收并写入中
+    OTA_REBOOTING = 2,          // 已校验并切换启动分区，等待重启 (火警期间推迟)
+    OTA_FAILED = 3              // 本次升级失败 (可接受新的升级)
+} OtaState;
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    OtaState state;
+    uint16_t otaId;
+    char version[OTA_VERSION_SIZE];     // 正在升级到的版本
+    uint32_t chunks;                    // 总块数
+    uint32_t nextChunk;                 // 已接收 (入队) 的块数
+    uint32_t doneChunks;                // 已写入的块数
+    uint32_t patchBytes;                // 补丁大小
+    uint32_t targetBytes;               // 目标镜像大小 (头部解析后有效)
+    bool delta;                         // 增量补丁
+    unsigned long startTime;
+    unsigned long elapsedMs;            // 接收到校验完成的耗时
+    const char* error;                  // 最近一次失败原因
+    uint32_t updates;                   // 成功写入次数
+    uint32_t failures;
+    // 当前运行的镜像
+    int8_t runningSlot;                 // 0/1，factory 为 -1
+    uint32_t imageSize;                 // 0=尚未计算
+    char imageSha[SHA256_HEX_SIZE];
+    OtaBootRecord boot;
+} OtaStatus;
+
+// ==================== 全局变量声明 ====================
+extern TaskHandle_t otaTaskHandle;
+extern SemaphoreHandle_t otaMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数：读取试运行记录，需要时立即回滚重启 (需在离线缓存队列之后、各任务创建之前)
+void setupOta();
+
+// OTA任务：计算当前镜像摘要、写入补丁、试运行窗口计时
+void otaTask(void* pvParameters);
+
+// MQTT回调入口：升级Topic时处理并返回true (数据块为二进制，需在复制为字符串之前调用)
+bool otaHandleMessage(const char* topic, const uint8_t* payload, unsigned int length);
+// MQTT任务在已连接时调用：签到、发布状态与应答
+void otaPoll();
+// 连接建立时调用：重新发布完整状态
+void otaOnConnect();
+const char* getOtaOfferTopic();
+const char* getOtaDataTopic();
+
+// 状态获取函数
+OtaStatus getOtaStatus();
+const char* getOtaStateString(OtaState state);
+void printOtaReport();
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef MY_OTA_BOOT_H
+#define MY_OTA_BOOT_H
+
+#include <stdint.h>
+
+// ==================== 试运行与回滚记录 ====================
+// 新镜像写入并切换启动分区后进入试运行 (TRIAL)，需在签到窗口内签到 (MY_Ota: MQTT已连接且运行平稳)
+// 才转为 CONFIRMED；窗口超时或试运行期间反复重启 (启动次数超过 OTA_BOOT_MAX_TRIALS) 则切回原分区
+// 启动时发现运行的不是试运行分区 (引导程序已回滚或新镜像无法启动) 同样记为 ROLLED_BACK
+// 记录保存在NVS (主机模拟器保存在文件)，本模块只做状态判断，不依赖 Arduino/FreeRTOS
+
+#define OTA_BOOT_MAX_TRIALS         3
+#define OTA_VERSION_SIZE            24
+
+// ==================== 枚举定义 ====================
+
+typedef enum {
+    OTA_BOOT_NONE = 0,              // 未经OTA (串口烧录) 或记录不存在
+    OTA_BOOT_TRIAL = 1,             // 新镜像试运行中，等待签到
+    OTA_BOOT_CONFIRMED = 2,         // 新镜像已签到
+    OTA_BOOT_ROLLED_BACK = 3        // 新镜像未签到，已回到原镜像
+} OtaBootState;
+
+typedef enum {
+    OTA_BOOT_ACTION_NONE = 0,       // 正常运行
+    OTA_BOOT_ACTION_TRIAL,          // 试运行：启动签到窗口计时
+    OTA_BOOT_ACTION_ROLLBACK        // 立即切回原分区并重启
+} OtaBootAction;
+
+// ==================== 数据结构 ====================
+
+// 按原样保存，修改字段需同时修改 OTA_BOOT_RECORD_MAGIC
+#define OTA_BOOT_RECORD_MAGIC       0x4F544131      // "OTA1"
+typedef struct {
+    uint32_t magic;
+    uint8_t state;                  // OtaBootState
+    uint8_t trialSlot;              // 试运行的分区编号 (0/1)
+    uint8_t previousSlot;           // 回滚目标
+    uint8_t trialBoots;             // 试运行期间的启动次数
+    uint16_t otaId;                 // 最近一次升级的编号
+    uint8_t reported;               // 最近一次状态变化已上报 (报警事件)
+    uint8_t reserved;
+    char version[OTA_VERSION_SIZE]; // 试运行/已确认的版本
+    char previousVersion[OTA_VERSION_SIZE];
+} OtaBootRecord;
+
+// ==================== 函数声明 ====================
+
+// 读出的记录无效时置为 NONE
+void otaBootSanitize(OtaBootRecord* record);
+
+// 新镜像写入并校验通过、切换启动分区之前调用
+void otaBootArm(OtaBootRecord* record, uint16_t otaId, const char* version, const char* previousVersion,
+                uint8_t trialSlot, uint8_t previousSlot);
+
+// 每次启动调用一次 (记录可能被修改，调用方需保存)
+OtaBootAction otaBootOnStart(OtaBootRecord* record, uint8_t runningSlot);
+
+// 签到：TRIAL -> CONFIRMED，状态变化时返回true
+bool otaBootCheckIn(OtaBootRecord* record);
+
+// 签到窗口超时：TRIAL -> ROLLED_BACK，返回回滚目标分区 (不在试运行时返回-1)
+int otaBootExpire(OtaBootRecord* record);
+
+const char* otaBootStateString(uint8_t state);
+
+#endif
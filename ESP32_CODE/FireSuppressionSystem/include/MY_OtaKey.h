@@ -0,0 +1,16 @@
+#ifndef MY_OTA_KEY_H
+#define MY_OTA_KEY_H
+
+#include <stdint.h>
+#include "MY_Ed25519.h"
+
+// ==================== 固件补丁签名公钥 ====================
+// 由 HOST_CODE/Ota 的 ota_keygen 生成：ota_keygen -H include/MY_OtaKey.h signing.key
+// 私钥 (signing.key) 只保存在发布补丁的主机上，不进入仓库
+// 仓库中为占位内容 (OTA_SIGNING_KEY_SET=0)，此时开启 OTA_ENABLE 会编译失败
+
+#define OTA_SIGNING_KEY_SET         0
+
+static const uint8_t otaSigningPublicKey[ED25519_PUBLIC_KEY_SIZE] = {0};
+
+#endif
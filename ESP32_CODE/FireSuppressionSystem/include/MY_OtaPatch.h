@@ -0,0 +1,155 @@
+#ifndef MY_OTA_PATCH_H
+#define MY_OTA_PATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "MY_Sha256.h"
+#include "MY_Ed25519.h"
+
+// ==================== 固件补丁格式 ====================
+// 由主机端 ota_diff (HOST_CODE/Ota) 生成，设备边接收边解压、边应用、边写入非活动分区，不缓存整个补丁：
+//   头部 OTA_PATCH_HEADER_SIZE 字节 (不压缩，小端)：
+//     "FAOT" | 版本(1) | 标志(1) | 保留(2) | 基准长度(4) | 目标长度(4) | 基准SHA-256(32) | 目标SHA-256(32) |
+//     Ed25519签名(64)
+//   签名覆盖前 OTA_PATCH_SIGNED_SIZE 字节，由发布者的私钥生成，设备用编译进固件的公钥校验；
+//   头部绑定了目标镜像的SHA-256，签名通过且写完后摘要一致才切换启动分区，未签名或签名不符的补丁在写入任何数据前被拒绝
+//   其后为LZ压缩的指令流，每条指令 (bsdiff 形式)：
+//     diffLen, extraLen (varint) | seek (zigzag varint) | diff[diffLen] | extra[extraLen]
+//     输出 old[oldPos + i] + diff[i] (逐字节模256)，oldPos += diffLen；再输出 extra；最后 oldPos += seek
+//   重新链接后的固件大部分是地址平移了若干字节的代码，diff 字节绝大多数为0，压缩后远小于完整镜像
+//   标志不含 OTA_PATCH_FLAG_DELTA 时是完整镜像 (基准长度为0，只有 extra)，用于设备基准与补丁不匹配时
+// LZ格式 (LZSS)：一个标志字节 (低位先用) 描述其后8个单元，位0=字面字节，位1=匹配：
+//   2字节小端 v：距离 = (v >> 4) + 1，长度 = (v & 0x0F) + 3；低4位为15时再跟 varint 追加长度
+//   解压只需一个 OTA_LZ_WINDOW 字节的环形缓冲区
+// 本模块不依赖 Arduino/FreeRTOS，主机端工具直接编译同一份源码
+
+#define OTA_PATCH_MAGIC             "FAOT"
+#define OTA_PATCH_VERSION           2           // 1 为不带签名的旧格式，不再接受
+#define OTA_PATCH_FLAG_DELTA        0x01
+#define OTA_PATCH_SIGNED_SIZE       80
+#define OTA_PATCH_HEADER_SIZE       (OTA_PATCH_SIGNED_SIZE + ED25519_SIGNATURE_SIZE)
+#define OTA_LZ_WINDOW               4096        // 需为2的幂，距离字段为12位
+#define OTA_LZ_MIN_MATCH            3
+#define OTA_LZ_LEN_EXTENDED         15          // 长度字段为此值时后跟 varint
+#define OTA_LZ_MAX_MATCH            65535       // 单个匹配的最大长度 (编码端同样限制)
+// 写目标分区的块大小 (Flash扇区)、读基准的缓存大小、解压输出暂存大小
+#define OTA_PATCH_WRITE_BLOCK       4096
+#define OTA_PATCH_READ_BLOCK        1024
+#define OTA_PATCH_STAGE_SIZE        256
+
+// ==================== 枚举定义 ====================
+
+typedef enum {
+    OTA_PATCH_OK = 0,
+    OTA_PATCH_ERR_HEADER,           // 魔数/版本不对
+    OTA_PATCH_ERR_SIGNATURE,        // 头部签名与设备公钥不符
+    OTA_PATCH_ERR_BASE,             // 增量补丁的基准不是当前运行的镜像
+    OTA_PATCH_ERR_TOO_LARGE,        // 目标镜像超过分区容量
+    OTA_PATCH_ERR_FORMAT,           // 压缩流或指令流损坏
+    OTA_PATCH_ERR_RANGE,            // 指令读取基准镜像越界
+    OTA_PATCH_ERR_IO,               // 读写分区失败
+    OTA_PATCH_ERR_INCOMPLETE,       // 结束时目标镜像未写满
+    OTA_PATCH_ERR_HASH,             // 写入数据的SHA-256与头部不符
+    OTA_PATCH_ERR_VERIFY            // 回读分区的SHA-256与头部不符
+} OtaPatchResult;
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint8_t flags;
+    uint32_t baseSize;
+    uint32_t targetSize;
+    uint8_t baseSha[SHA256_DIGEST_SIZE];
+    uint8_t targetSha[SHA256_DIGEST_SIZE];
+} OtaPatchHeader;
+
+// 分区读写 (固件为 esp_partition/esp_ota，主机为文件模拟的分区)
+// writeTarget 按偏移顺序调用，每次最多 OTA_PATCH_WRITE_BLOCK 字节
+typedef struct {
+    void* context;
+    bool (*readBase)(void* context, uint32_t offset, uint8_t* buf, size_t len);
+    bool (*writeTarget)(void* context, uint32_t offset, const uint8_t* buf, size_t len);
+    bool (*readTarget)(void* context, uint32_t offset, uint8_t* buf, size_t len);
+    uint32_t targetCapacity;        // 目标分区大小
+} OtaPatchIo;
+
+// 流式应用状态 (约10KB，由调用方分配)
+typedef struct {
+    OtaPatchIo io;
+    uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE];     // 发布者公钥
+    uint32_t runningSize;           // 当前运行镜像的长度与摘要 (增量补丁的基准须与之相同)
+    uint8_t runningSha[SHA256_DIGEST_SIZE];
+    OtaPatchResult error;
+
+    // 头部
+    uint8_t headerBuf[OTA_PATCH_HEADER_SIZE];
+    uint8_t headerLen;
+    bool headerReady;
+    OtaPatchHeader header;
+
+    // LZ解压
+    uint8_t window[OTA_LZ_WINDOW];
+    uint32_t decoded;               // 已解压字节数
+    uint8_t lzState;
+    uint8_t lzFlags;
+    uint8_t lzBit;
+    uint16_t lzWord;
+    uint32_t lzVarint;
+    uint8_t lzShift;
+    uint8_t stage[OTA_PATCH_STAGE_SIZE];
+    uint16_t stageLen;
+
+    // 指令解析
+    uint8_t opState;
+    uint32_t opVarint;
+    uint8_t opShift;
+    uint32_t diffRemain;
+    uint32_t extraRemain;
+    int32_t seek;
+    int64_t oldPos;
+
+    // 基准读缓存
+    uint8_t readBuf[OTA_PATCH_READ_BLOCK];
+    uint32_t readStart;
+    uint32_t readLen;
+
+    // 目标写缓冲
+    uint8_t writeBuf[OTA_PATCH_WRITE_BLOCK];
+    uint32_t writeLen;
+    uint32_t written;               // 已写入分区的字节数
+    uint32_t produced;              // 已生成的目标字节数 (含写缓冲)
+    Sha256Context sha;
+
+    // 统计
+    uint32_t inputBytes;            // 收到的补丁字节数
+    uint32_t diffBytes;             // 由基准+差值生成的字节数
+    uint32_t extraBytes;            // 直接携带的字节数
+} OtaPatch;
+
+// ==================== 函数声明 ====================
+
+// 开始应用：publicKey 为发布者公钥，runningSize/runningSha 为当前运行镜像
+void otaPatchBegin(OtaPatch* patch, const OtaPatchIo* io, const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE],
+                   uint32_t runningSize, const uint8_t runningSha[SHA256_DIGEST_SIZE]);
+
+// 按顺序送入补丁数据 (任意长度分块)，出错后保持首个错误
+OtaPatchResult otaPatchFeed(OtaPatch* patch, const uint8_t* data, size_t len);
+
+// 补丁全部送入后调用：写出剩余数据，校验写入流和回读分区的SHA-256
+OtaPatchResult otaPatchFinish(OtaPatch* patch);
+
+// 头部已解析 (可读取 header.targetSize 等)
+bool otaPatchHeaderReady(const OtaPatch* patch);
+
+// 头部编解码 (主机端生成补丁时使用同一份实现)；编码时签名位置为0，需再调用 otaPatchSignHeader
+void otaPatchEncodeHeader(const OtaPatchHeader* header, uint8_t out[OTA_PATCH_HEADER_SIZE]);
+bool otaPatchDecodeHeader(const uint8_t in[OTA_PATCH_HEADER_SIZE], OtaPatchHeader* header);
+
+// 用私钥种子签名头部 (主机端使用)
+void otaPatchSignHeader(uint8_t header[OTA_PATCH_HEADER_SIZE], const uint8_t seed[ED25519_SEED_SIZE]);
+bool otaPatchVerifyHeader(const uint8_t header[OTA_PATCH_HEADER_SIZE],
+                          const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE]);
+
+const char* otaPatchResultString(OtaPatchResult result);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MY_OUTBOX_H
+#define MY_OUTBOX_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "MY_Zone.h"
+#include "MY_OutboxCore.h"
+
+// ==================== 离线缓存队列配置 ====================
+// 断网/Broker不可用期间，待发布的消息先进入本队列，重连后按速率补发
+// 队列存储区优先分配在PSRAM中；入队/合并/补发顺序由 MY_OutboxCore 实现
+
+// 单条消息的最大长度 (与 mqttClient.setBufferSize 保持一致)
+// 遥测顶层字段约2.0KB，zones 数组每个分区约0.41KB (含窗口特征与场景分类)
+#define OUTBOX_PAYLOAD_SIZE         (2176 + ZONE_COUNT * 448)
+// 报警事件队列容量 (高优先级，不合并)
+#define OUTBOX_ALARM_CAPACITY       64
+// 遥测数据队列容量
+#define OUTBOX_TELEMETRY_CAPACITY   256
+// 无PSRAM时的降级容量 (内部RAM有限)
+#define OUTBOX_FALLBACK_CAPACITY    8
+
+// Flash溢出存储 (LittleFS)：遥测队列满时把最旧的样本写入Flash而不是丢弃
+// 0=关闭, 1=开启
+#define OUTBOX_FLASH_SPILL          0
+#define OUTBOX_SPILL_FILE           "/outbox.bin"
+#define OUTBOX_SPILL_MAX_ENTRIES    1024
+
+// ==================== 数据结构 ====================
+
+// 补发回调：返回true表示发布成功
+typedef bool (*OutboxPublishFn)(const char* topic, const char* payload);
+
+// ==================== 全局变量声明 ====================
+extern SemaphoreHandle_t outboxMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数
+void setupOutbox();
+
+// 入队 (captureTime 为数据采集时的 millis())
+bool outboxPush(OutboxClass msgClass, const char* topic, const char* payload, unsigned long captureTime);
+
+// 按速率补发，报警事件优先；返回本次补发条数
+uint32_t outboxDrain(OutboxPublishFn publish);
+
+// 状态获取函数
+bool outboxHasTelemetry();
+uint32_t getOutboxDepth();
+uint32_t getOutboxDropped();
+OutboxStats getOutboxStats();
+
+#endif
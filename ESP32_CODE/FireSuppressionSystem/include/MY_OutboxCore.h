@@ -0,0 +1,116 @@
+#ifndef MY_OUTBOX_CORE_H
+#define MY_OUTBOX_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== 离线缓存队列核心 ====================
+// MY_Outbox 的队列部分：报警/遥测两个环形队列、遥测合并、令牌桶限速和补发序号校验
+//   - 报警事件优先补发，不合并，满时丢弃最旧事件
+//   - 遥测在合并窗口内覆盖队尾样本；满时把最旧样本交给溢出存储 (可选) 或丢弃
+//   - 补发时先拷贝队头再发布 (发布期间不持有锁)，发布成功后按序号确认队头未被改写才出队
+//   - 计数满足 入队 = 已补发 + 丢弃 + 合并 + 队列深度 (含溢出存储)
+// 存储区分配、加锁和Flash溢出由调用方提供，时间 (millis) 由调用方传入；
+// 本模块不依赖 Arduino/FreeRTOS，主机端测试直接编译同一份源码
+
+// Topic最大长度
+#define OUTBOX_TOPIC_SIZE           64
+// 遥测合并窗口 (毫秒) - 窗口内的新样本覆盖队尾样本，而不是追加
+#define OUTBOX_COALESCE_MS          10000
+// 重连后补发速率默认值 (条/秒)，实际速率由调用方在补发时传入
+#define OUTBOX_DRAIN_RATE_PER_SEC   10
+// 单次补发最多积攒的令牌数 (限制突发)
+#define OUTBOX_DRAIN_BURST          20
+
+// ==================== 枚举定义 ====================
+
+// 消息类别
+typedef enum {
+    OUTBOX_CLASS_ALARM = 0,       // 报警事件 (优先补发)
+    OUTBOX_CLASS_TELEMETRY = 1    // 遥测数据 (可合并)
+} OutboxClass;
+
+// 补发条目的来源
+typedef enum {
+    OUTBOX_SOURCE_NONE = 0,
+    OUTBOX_SOURCE_ALARM,
+    OUTBOX_SOURCE_SPILL,
+    OUTBOX_SOURCE_TELEMETRY
+} OutboxSource;
+
+// ==================== 数据结构 ====================
+
+// 条目头 (payload 另存，长度由 outboxCoreInit 指定)
+typedef struct {
+    uint32_t seq;                           // 序号 (补发时用于校验队头未被改写)
+    uint32_t captureTime;                   // 原始采集时间(ms)
+    uint8_t msgClass;                       // OutboxClass
+    char topic[OUTBOX_TOPIC_SIZE];
+} OutboxEntryHeader;
+
+// 队列统计
+typedef struct {
+    uint32_t alarmDepth;          // 报警事件队列深度
+    uint32_t telemetryDepth;      // 遥测队列深度 (RAM)
+    uint32_t spilledDepth;        // Flash中尚未补发的条目数
+    uint32_t dropped;             // 因队列满而丢弃的条目数
+    uint32_t coalesced;           // 被合并覆盖的遥测样本数
+    uint32_t sent;                // 已补发并出队的条目数 (出队前重发的不重复计数)
+} OutboxStats;
+
+// 环形队列 (第 i 个槽位的 payload 位于 payloads + i × payloadSize)
+typedef struct {
+    OutboxEntryHeader* headers;
+    char* payloads;
+    uint32_t capacity;      // 0 表示存储区分配失败，入队一律丢弃
+    uint32_t head;          // 队头下标 (最旧)
+    uint32_t count;
+} OutboxRing;
+
+// 遥测溢出存储 (设备上为LittleFS文件)，按先进先出读取
+typedef struct {
+    void* ctx;
+    // 写入一条最旧的遥测，返回false表示存储已满或写入失败 (该条目被丢弃)
+    bool (*write)(void* ctx, const OutboxEntryHeader* header, const char* payload);
+    // 读取最早写入且尚未补发的条目，返回false表示没有或读取失败
+    bool (*read)(void* ctx, OutboxEntryHeader* header, char* payload);
+    // 最早的条目已补发
+    void (*pop)(void* ctx);
+    uint32_t (*depth)(void* ctx);
+} OutboxSpillHandlers;
+
+typedef struct {
+    OutboxRing alarm;
+    OutboxRing telemetry;
+    size_t payloadSize;
+    const OutboxSpillHandlers* spill;       // NULL 表示不溢出
+    OutboxStats stats;
+    uint32_t nextSeq;
+    uint32_t telemetryWindowStart;          // 合并窗口起点 (队尾样本所在窗口的开始时间)
+    // 令牌桶 (只由补发方访问，不需要加锁)
+    uint32_t drainTokens;
+    uint32_t lastDrainRefill;
+} OutboxCore;
+
+// ==================== 函数声明 ====================
+// 除 outboxCoreRefill 外，调用方需在同一把锁内调用
+
+// 初始化计数与令牌桶；spill 为NULL时遥测满即丢弃
+void outboxCoreInit(OutboxCore* core, size_t payloadSize, const OutboxSpillHandlers* spill, uint32_t nowMs);
+// 绑定队列存储区 (payloads 至少 capacity × payloadSize 字节)
+void outboxRingInit(OutboxRing* ring, OutboxEntryHeader* headers, char* payloads, uint32_t capacity);
+
+// 入队，payload 超长时截断；返回false表示队列没有存储区
+bool outboxCorePush(OutboxCore* core, OutboxClass msgClass, const char* topic, const char* payload, uint32_t captureTime);
+
+// 按经过的时间和速率 (条/秒，0表示不补充) 补充令牌，返回本轮可补发的条数 (只由补发方调用，不需要加锁)
+uint32_t outboxCoreRefill(OutboxCore* core, uint32_t nowMs, uint32_t ratePerSec);
+// 拷贝下一条待补发的条目 (报警 → 溢出存储 → RAM遥测)
+OutboxSource outboxCorePeek(OutboxCore* core, OutboxEntryHeader* header, char* payload);
+// 发布成功后调用：队头未被改写时出队并计入已补发，消耗一个令牌
+void outboxCoreComplete(OutboxCore* core, OutboxSource source, uint32_t seq);
+
+OutboxStats outboxCoreStats(const OutboxCore* core);
+bool outboxCoreHasTelemetry(const OutboxCore* core);
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MY_POWER_H
+#define MY_POWER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// ==================== 电源管理配置 ====================
+// 0=关闭 (CPU固定最高频率), 1=开启 (动态调频 + 空闲时自动Light-sleep)
+// 需要sdkconfig开启 CONFIG_PM_ENABLE，Light-sleep还需要 CONFIG_FREERTOS_USE_TICKLESS_IDLE，
+// 缺少对应选项时自动降级为仅调频或关闭，并在串口提示
+// 可由编译参数覆盖 (platformio.ini 的 esp32-s3-devkitc-1-lowpower 环境)
+#ifndef POWER_MGMT_ENABLE
+#define POWER_MGMT_ENABLE           0
+#endif
+#define POWER_CPU_MAX_MHZ           240
+// UART驱动使用APB时钟时会持有APB锁，实际最低频率为80MHz
+#define POWER_CPU_MIN_MHZ           80
+// 收到K230线路唤醒后保持清醒的时间 (毫秒)，需大于K230发送间隔，期间不再进入Light-sleep
+#define POWER_K230_AWAKE_MS         3000
+
+/*
+ * 运行方式：
+ *   没有事件时各任务都在阻塞等待，FreeRTOS空闲时关闭Tick并进入Light-sleep；
+ *   以下唤醒源可在睡眠中唤醒芯片：
+ *     - MQ-2 DO引脚低电平 (检测到烟雾)，立即唤醒传感器任务采样
+ *     - K230 RX引脚低电平 (串口起始位)，之后保持清醒 POWER_K230_AWAKE_MS 接收数据
+ *     - esp_timer定时器 (水泵脉冲、蜂鸣器步进等)
+ *   火焰/喷水/报警/排风期间对应模块持有电源锁，CPU保持最高频率且不睡眠
+ */
+
+// ==================== 枚举定义 ====================
+
+// 电源管理工作模式
+typedef enum {
+    POWER_MODE_OFF = 0,         // 未开启，CPU固定最高频率
+    POWER_MODE_DFS = 1,         // 仅动态调频
+    POWER_MODE_LIGHT_SLEEP = 2  // 动态调频 + 自动Light-sleep
+} PowerMode;
+
+// 电源锁持有者 (位掩码)，任一位置位时保持全速运行
+typedef enum {
+    POWER_HOLD_K230   = 1 << 0, // K230火焰状态
+    POWER_HOLD_PUMP   = 1 << 1, // 水泵继电器导通
+    POWER_HOLD_FAN    = 1 << 2, // 风扇运行
+    POWER_HOLD_BUZZER = 1 << 3, // 蜂鸣器报警
+    POWER_HOLD_ZONE   = 1 << 4  // 分区风扇/喷淋阀动作
+} PowerHoldSource;
+
+// ==================== 数据结构 ====================
+
+// 唤醒延迟统计 (引脚中断 -> 对应任务开始处理)
+typedef struct {
+    uint32_t count;             // 唤醒次数
+    uint32_t lastUs;            // 最近一次延迟
+    uint32_t maxUs;             // 最大延迟
+} PowerWakeStats;
+
+// 电源管理状态
+typedef struct {
+    PowerMode mode;             // 实际生效的工作模式
+    uint32_t holdMask;          // 当前持有电源锁的模块
+    uint8_t fullPowerPct;       // 开机以来持有电源锁的时间占比 (%)
+    PowerWakeStats smokeWake;   // MQ-2 DO唤醒
+    PowerWakeStats k230Wake;    // K230串口唤醒
+} PowerStatus;
+
+// ==================== 全局变量声明 ====================
+extern SemaphoreHandle_t powerMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数 (需在各模块初始化引脚之后、创建任务之前调用)
+void setupPower();
+
+// 设置/清除电源锁持有者
+void powerSetHold(uint32_t source, bool active);
+
+// 传感器任务被唤醒后调用：记录唤醒延迟，DO恢复高电平后重新开启唤醒中断
+void powerSmokeWakeHandled(uint8_t doPin, bool smokeAlarm);
+
+// K230任务收到数据后调用：记录唤醒延迟并延长清醒窗口
+void powerK230Activity();
+
+// 状态获取函数
+PowerStatus getPowerStatus();
+const char* getPowerModeString();
+
+// 打印电源锁与各模式驻留时间 (需开启 CONFIG_PM_PROFILING)
+void printPowerReport();
+
+#endif
@@ -5,18 +5,35 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
+#include "MY_PumpDuty.h"
 
 // ==================== 硬件配置 ====================
 // 水泵控制引脚 (连接到继电器IN口，高电平触发)
 #define PUMP_RELAY_PIN 14
 
 // ==================== 水泵工作参数 ====================
-// 单次喷水最大持续时间 (毫秒) - 防止水泵过热或水箱耗尽
-#define PUMP_MAX_DURATION_MS     5000   // 5秒
-// 喷水间隔冷却时间 (毫秒)
-#define PUMP_COOLDOWN_MS         10000   // 10秒
-// 自动模式下检测到火灾后的喷水时间 (毫秒)
-#define PUMP_AUTO_SPRAY_MS       5000   // 5秒
+// 单次喷水最大持续时间、自动喷水时间可在线配置，出厂默认值见 MY_ConfigCore.h
+// 继电器连续导通的硬件兜底上限 (毫秒) - 独立于定时器，大于可配置的最大喷水时间
+#define PUMP_HARD_MAX_ON_MS      65000
+// 水泵任务周期与最大允许间隔 (毫秒)
+#define PUMP_TASK_PERIOD_MS      500
+#define PUMP_TASK_DEADLINE_MS    2000
+
+// ==================== 占空比模型参数 ====================
+// 不再在每次喷水后固定冷却，而是统计滑动窗口内的累计喷水时间：
+// 窗口内累计喷水不超过 窗口长度 × 额定占空比，预算用尽才进入冷却
+// 统计窗口与额定占空比可在线配置，出厂默认值见 MY_ConfigCore.h
+// 恢复预算与区间记录条数见 MY_PumpDuty.h
+
+// ==================== 脉冲喷水参数 ====================
+// 继电器由esp_timer单次定时器回调直接切换，不依赖任务轮询周期
+// 单个脉冲最短喷水时间 (毫秒)
+#define PUMP_MIN_PULSE_MS        100
+// 脉冲间隔最短时间 (毫秒) - 小于此值时按单次连续喷水处理，避免绕过最大持续时间保护
+#define PUMP_MIN_PULSE_OFF_MS    200
+// 单条命令最多脉冲次数
+#define PUMP_MAX_PULSE_CYCLES    20
+// 手动模式下 "on" 命令的默认喷水时间见 MY_CommandCore.h (PUMP_MANUAL_SPRAY_MS)
 
 // ==================== 枚举定义 ====================
 
@@ -24,7 +41,7 @@
 typedef enum {
     PUMP_OFF = 0,       // 水泵关闭
     PUMP_ON = 1,        // 水泵开启（喷水中）
-    PUMP_COOLDOWN = 2   // 冷却中（暂时不可用）
+    PUMP_COOLDOWN = 2   // 冷却中（占空比预算耗尽，暂时不可用）
 } PumpState;
 
 // 控制模式
@@ -44,8 +61,22 @@ typedef struct {
     unsigned long totalSprayTime; // 累计喷水时间 (用于统计)
     uint32_t sprayCount;          // 喷水次数统计
     bool fireDetected;            // 是否检测到火灾
+    bool relayOn;                 // 继电器实际输出 (脉冲间隔期间 state 仍为 PUMP_ON)
+    uint16_t pulsesRemaining;     // 剩余脉冲数 (含当前脉冲)
+    uint32_t timerMaxLateUs;      // 定时切换的最大延迟 (微秒，用于评估精度)
+    bool sprayHeld;               // 场景分类判定为干扰源，暂缓自动喷水中
+    uint32_t sprayHoldCount;      // 暂缓次数 (每次火灾最多一次)
 } PumpControl;
 
+// 占空比模型状态 (用于遥测上报)
+typedef struct {
+    uint32_t windowMs;            // 统计窗口长度
+    uint32_t capMs;               // 窗口内允许的最大喷水时间
+    uint32_t usedMs;              // 窗口内已喷水时间
+    uint32_t budgetMs;            // 当前剩余可喷水时间
+    uint32_t recoverMs;           // 恢复可用还需的时间 (0=可用)
+} PumpDutyStatus;
+
 // ==================== 全局变量声明 ====================
 extern PumpControl pumpControl;
 extern TaskHandle_t pumpTaskHandle;
@@ -59,13 +90,22 @@ void setupPump();
 // 水泵控制函数
 void pumpOn();                              // 开启水泵
 void pumpOff();                             // 关闭水泵
+void pumpForceOff();                        // 强制断开继电器 (不加锁，仅供受控重启前使用)
 void pumpSpray(unsigned long durationMs);   // 喷水指定时间后自动关闭
+// 脉冲喷水：喷 onMs、停 offMs，重复 cycles 次后进入冷却
+bool pumpSprayPattern(uint32_t onMs, uint32_t offMs, uint16_t cycles);
 
 // 状态获取函数
 PumpState getPumpState();
 PumpMode getPumpMode();
-bool isPumpAvailable();                     // 检查水泵是否可用（非冷却状态）
-unsigned long getPumpRemainingCooldown();   // 获取剩余冷却时间
+bool isPumpAvailable();                     // 检查水泵是否可用（占空比预算充足）
+unsigned long getPumpRemainingCooldown();   // 获取预算恢复还需的时间
+PumpDutyStatus getPumpDutyStatus();         // 占空比模型状态
+bool isPumpRelayOn();                       // 继电器是否导通
+uint16_t getPumpPulsesRemaining();          // 剩余脉冲数
+uint32_t getPumpTimerMaxLateUs();           // 定时切换最大延迟 (微秒)
+bool isPumpSprayHeld();                     // 是否因干扰源暂缓自动喷水
+uint32_t getPumpSprayHoldCount();           // 暂缓次数
 
 // 模式设置函数
 void setPumpMode(PumpMode mode);
@@ -0,0 +1,64 @@
+#ifndef MY_PUMP_DUTY_H
+#define MY_PUMP_DUTY_H
+
+#include <stdint.h>
+
+/*
+ * 水泵占空比模型：
+ *   记录最近的继电器导通区间，统计滑动窗口内的累计喷水时间；
+ *   窗口内累计喷水不超过 窗口长度 × 额定占空比，预算用尽才进入冷却
+ * 时间由调用方传入 (设备上为 esp_timer_get_time() 的64位微秒计数)，窗口与占空比每次调用时给出，
+ * 在线修改配置后立即生效；
+ * 本模块不依赖 Arduino/FreeRTOS，主机端测试直接编译同一份源码
+ */
+
+// ==================== 占空比模型参数 ====================
+// 冷却后恢复可用所需的最小预算 (毫秒)
+#define PUMP_DUTY_RESUME_MS      1000
+// 导通区间记录条数 (记录满时合并最旧的两条，只会高估占用)
+#define PUMP_DUTY_HISTORY        32
+
+// ==================== 数据结构 ====================
+
+// 窗口与上限 (设备上取自运行时配置)
+typedef struct {
+    int64_t windowUs;               // 统计窗口长度
+    int64_t capUs;                  // 窗口内允许的最大导通时间
+} PumpDutyLimits;
+
+// 继电器导通区间
+typedef struct {
+    int64_t startUs;
+    int64_t endUs;
+} OnInterval;
+
+// 占空比模型 (最近的导通区间，按时间先后排列)
+typedef struct {
+    OnInterval history[PUMP_DUTY_HISTORY];
+    uint8_t head;                   // 最旧记录下标
+    uint8_t count;
+    bool on;                        // 继电器正在导通
+    int64_t onSinceUs;              // 本次导通时刻
+} PumpDutyModel;
+
+// ==================== 函数声明 ====================
+
+// 窗口长度 × 额定占空比 (%)
+PumpDutyLimits pumpDutyMakeLimits(uint32_t windowMs, uint32_t percent);
+void pumpDutyInit(PumpDutyModel* model);
+
+// 继电器导通/断开；断开时记录本次区间并返回导通时长 (微秒)
+void pumpDutyStart(PumpDutyModel* model, int64_t atUs);
+int64_t pumpDutyStop(PumpDutyModel* model, const PumpDutyLimits* limits, int64_t atUs);
+
+// 截至 atUs 的窗口内累计导通时间；正在导通的区间按截至 nowUs 计算
+// (atUs 晚于 nowUs 时用于预测，假设此后不再喷水)
+int64_t pumpDutyUsedUs(const PumpDutyModel* model, const PumpDutyLimits* limits, int64_t atUs, int64_t nowUs);
+// atUs 时刻的剩余预算，不小于0
+int64_t pumpDutyBudgetAtUs(const PumpDutyModel* model, const PumpDutyLimits* limits, int64_t atUs, int64_t nowUs);
+// 从冷却恢复所需的预算 (不超过上限，避免窗口很小时永远无法恢复)
+int64_t pumpDutyResumeUs(const PumpDutyLimits* limits);
+// 停泵状态下预算恢复到 targetUs 还需多久 (毫秒，向上取整)，0表示已满足
+uint32_t pumpDutyWaitMs(const PumpDutyModel* model, const PumpDutyLimits* limits, int64_t nowUs, int64_t targetUs);
+
+#endif
@@ -2,8 +2,18 @@
 #define MY_SENSOR_H
 
 #include <Arduino.h>
+#include "MY_Zone.h"
 
+// 传感器采样周期 (毫秒)
+#define SENSOR_READ_INTERVAL_MS 2000
+// 传感器任务两次采样的最大允许间隔 (毫秒)
+#define SENSOR_TASK_DEADLINE_MS 5000
 
+// 传感器任务通知位：DO中断要求提前采样；K230帧只要求重新评估，不打乱采样周期
+#define SENSOR_NOTIFY_SAMPLE    0x01
+#define SENSOR_NOTIFY_EVALUATE  0x02
+
+// 单个分区的一组读数
 typedef struct {
     float temperature;
     float humidity;
@@ -11,12 +21,25 @@ typedef struct {
     bool smokeAlarm;
 }SensorData;
 
-extern SensorData sensorData;
+// 全部分区的读数 (按字段分数组存放，与融合模块一次遍历全部分区)
+typedef struct {
+    float temperature[ZONE_COUNT];
+    float humidity[ZONE_COUNT];
+    float smokeLevel[ZONE_COUNT];
+    bool smokeAlarm[ZONE_COUNT];
+}ZoneSensorData;
+
+extern ZoneSensorData zoneSensorData;
 extern TaskHandle_t sensorTaskHandle;
 extern SemaphoreHandle_t sensorMutex;
 
 
 void setupSensor();
 void sensorTask(void *pvParameters);
+// 请求传感器任务立即重新评估融合等级 (K230帧到达时调用)
+void sensorRequestEvaluate();
+
+// 获取单个分区最近一次的读数 (加锁复制)
+SensorData getSensorData(uint8_t zone);
 
-#endif
\ No newline at end of file
+#endif
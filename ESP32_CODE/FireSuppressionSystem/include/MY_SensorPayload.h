@@ -0,0 +1,166 @@
+#ifndef MY_SENSOR_PAYLOAD_H
+#define MY_SENSOR_PAYLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "MY_DspKernels.h"
+#include "MY_FusionKernels.h"
+
+// ==================== 遥测负载 ====================
+// fire_alarm/sensor_data 的字段、顺序与取整规则：
+//   读数保留1位小数，置信度与证据保留3位，其余浮点按各字段注释取整；NaN (传感器读取失败) 输出为 null
+//   顶层读数为第0区，保持与APP兼容；zones 数组为各分区的读数、等级、执行器与窗口特征
+// 调用方先把各模块状态收集到 SensorPayload (枚举值已转换为字符串)，再由 sensorPayloadBuild 序列化；
+// 本模块不依赖 Arduino/FreeRTOS，主机端负载生成器直接编译同一份源码
+
+// ==================== 数据结构 ====================
+
+// 单个分区
+typedef struct {
+    const char* name;
+    float temperature;
+    float humidity;
+    float smokeLevel;
+    bool smokeAlarm;
+    float fireScore;
+    const char* fireLevel;
+    bool fan;
+    bool valve;
+
+    // 窗口特征 (采满一个窗口后才有，温度特征只随烟雾特征一起输出)
+    bool smokeValid;
+    DspFeatures smoke;
+    uint8_t smokeBandCount;
+    bool tempValid;
+    DspFeatures temp;
+
+    // 场景分类
+    bool clsValid;
+    const char* clsClass;
+    float pNuisance;
+    float pFire;
+} SensorPayloadZone;
+
+// 一条遥测 (字段顺序即输出顺序)
+typedef struct {
+    const char* deviceId;
+    float temperature;
+    float humidity;
+    float smokeLevel;
+    bool smokeAlarm;
+
+    // 风扇
+    const char* fanState;
+    const char* fanMode;
+    uint8_t fanSpeed;
+    bool fanPurging;
+
+    // 水泵
+    const char* pumpState;
+    const char* pumpMode;
+    bool pumpRelay;
+    uint16_t pumpPulsesLeft;
+    uint32_t pumpTimerLateUs;
+    bool pumpHeld;
+    uint32_t pumpHolds;
+    uint32_t pumpDutyUsedMs;
+    uint32_t pumpDutyCapMs;
+    uint32_t pumpDutyBudgetMs;
+    uint32_t pumpDutyRecoverMs;
+
+    // K230火焰状态、链路健康与上报档位
+    const char* k230Fire;
+    bool k230FireDetected;
+    const char* k230Link;
+    float k230Fps;
+    uint32_t k230Frames;
+    float k230InferMs;
+    float k230InferAvgMs;
+    float k230InferMaxMs;
+    const char* k230Model;
+    int64_t k230HeartbeatAgeMs;     // 从未收到心跳为-1
+    uint32_t k230Faults;
+    uint32_t k230Restarts;
+    const char* k230ReportMode;
+    int64_t k230ReportMs;           // 未确认为-1
+
+    // K230串口链路速率与检测快照
+    uint32_t k230Baud;
+    uint32_t k230RxBps;
+    uint32_t k230CrcErrors;
+    uint32_t snapshots;
+    uint32_t snapshotBytes;
+    uint32_t snapshotAssemblyMs;
+    float snapshotKBps;
+
+    // 火灾置信度融合评估
+    float fireScore;
+    const char* fireLevel;
+    const char* fireZone;
+    float fireEvidence[FUSION_SRC_COUNT];
+
+    // 蜂鸣器
+    const char* buzzerState;
+    const char* buzzerMode;
+    const char* buzzerPattern;
+
+    // 分区周期耗时、DSP与分类器
+    uint32_t zoneSampleUs;
+    uint32_t zoneSampleMaxUs;
+    uint32_t zoneEvalUs;
+    uint32_t zoneEvalMaxUs;
+    const char* dspPipeline;
+    uint32_t dspUs;
+    uint32_t dspMaxUs;
+    uint32_t clsModel;
+    uint32_t clsUs;
+    uint32_t clsMaxUs;
+    const SensorPayloadZone* zones;
+    uint8_t zoneCount;
+
+    // 电源管理与唤醒延迟
+    const char* powerMode;
+    uint32_t powerHolds;
+    uint8_t powerFullPct;
+    uint32_t wakeSmokeUs;
+    uint32_t wakeSmokeMaxUs;
+    uint32_t wakeK230Us;
+    uint32_t wakeK230MaxUs;
+
+    // 任务监控、固件版本与升级状态
+    uint32_t deadlineMisses;
+    const char* resetReason;
+    const char* fwVersion;
+    const char* otaState;
+    const char* otaBoot;
+    uint32_t bootArmedMs;
+
+    // 内部RAM堆
+    uint32_t heapFree;
+    uint32_t heapLargest;
+    uint32_t heapMinFree;
+    uint8_t heapFragPct;
+    uint8_t heapFragMaxPct;
+
+    // 时间：timestamp 为启动后的毫秒数，epoch_us 为参考时钟纪元微秒 (0=未同步)
+    uint64_t timestamp;
+    int64_t epochUs;
+    int64_t clockUncertaintyUs;
+    float clockDriftPpm;
+
+    // 离线缓存与连接统计
+    uint32_t outboxDepth;
+    uint32_t outboxDropped;
+    uint32_t txSkipped;
+    uint32_t mqttReconnects;
+    uint32_t wifiConnectMs;
+    uint32_t mqttConnectMs;
+    uint32_t lastOutageMs;
+} SensorPayload;
+
+// ==================== 函数声明 ====================
+
+// 序列化到 buffer，长度语义同 snprintf (返回值 >= size 表示缓冲区不足，内容已截断)
+size_t sensorPayloadBuild(const SensorPayload* payload, char* buffer, size_t size);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef MY_SHA256_H
+#define MY_SHA256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== SHA-256 ====================
+// 流式计算 (FIPS 180-4)，用于固件镜像与补丁校验
+// 本模块不依赖 Arduino/FreeRTOS，主机端工具直接编译同一份源码，两端的摘要计算完全一致
+
+#define SHA256_DIGEST_SIZE          32
+#define SHA256_BLOCK_SIZE           64
+// 十六进制字符串长度 (含结尾0)
+#define SHA256_HEX_SIZE             (SHA256_DIGEST_SIZE * 2 + 1)
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t totalBytes;
+    uint8_t block[SHA256_BLOCK_SIZE];
+    uint8_t blockLen;
+} Sha256Context;
+
+// ==================== 函数声明 ====================
+
+void sha256Init(Sha256Context* ctx);
+void sha256Update(Sha256Context* ctx, const uint8_t* data, size_t len);
+void sha256Final(Sha256Context* ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+// 摘要 <-> 小写十六进制字符串，解析失败返回false
+void sha256ToHex(const uint8_t digest[SHA256_DIGEST_SIZE], char hex[SHA256_HEX_SIZE]);
+bool sha256FromHex(const char* hex, size_t len, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+#endif
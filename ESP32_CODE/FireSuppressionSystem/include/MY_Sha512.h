@@ -0,0 +1,29 @@
+#ifndef MY_SHA512_H
+#define MY_SHA512_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== SHA-512 ====================
+// 流式计算 (FIPS 180-4)，供 Ed25519 签名校验使用 (MY_Ed25519)
+// 本模块不依赖 Arduino/FreeRTOS，主机端工具直接编译同一份源码
+
+#define SHA512_DIGEST_SIZE          64
+#define SHA512_BLOCK_SIZE           128
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint64_t state[8];
+    uint64_t totalBytes;            // 补丁与签名消息远小于 2^61 字节，位长只用低64位
+    uint8_t block[SHA512_BLOCK_SIZE];
+    uint8_t blockLen;
+} Sha512Context;
+
+// ==================== 函数声明 ====================
+
+void sha512Init(Sha512Context* ctx);
+void sha512Update(Sha512Context* ctx, const uint8_t* data, size_t len);
+void sha512Final(Sha512Context* ctx, uint8_t digest[SHA512_DIGEST_SIZE]);
+
+#endif
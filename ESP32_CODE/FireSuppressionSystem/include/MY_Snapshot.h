@@ -0,0 +1,62 @@
+#ifndef MY_SNAPSHOT_H
+#define MY_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// ==================== 检测快照配置 ====================
+// K230检测到火焰时发送检测帧的JPEG缩略图，按 MY_K230.h 中的二进制帧分块传输，
+// K230任务校验后在PSRAM中重组，完整后由MQTT任务分块发布
+
+// 0=关闭, 1=开启 (无PSRAM时自动关闭)
+#define SNAPSHOT_ENABLE                 1
+// 单张快照最大字节数 (320x240 JPEG 质量50约10~20KB)
+#define SNAPSHOT_MAX_BYTES              (64 * 1024)
+// 快照槽位数：一个重组的同时另一个可在发布
+#define SNAPSHOT_SLOTS                  2
+// 单张快照最多的串口分块数
+#define SNAPSHOT_MAX_CHUNKS             256
+// 首块到达后超过此时间仍未收齐则丢弃 (毫秒)
+#define SNAPSHOT_ASSEMBLY_TIMEOUT_MS    5000
+// 重组完成后等待发布的最长时间 (毫秒)，MQTT长时间断开时丢弃旧快照
+#define SNAPSHOT_PUBLISH_TIMEOUT_MS     60000
+// MQTT单条报文携带的JPEG字节数，MQTT任务每轮最多发布一块，不阻塞报警和遥测
+#define SNAPSHOT_MQTT_CHUNK_SIZE        4096
+// MQTT数据块头: 快照ID(2) 块序号(2) 块数(2) 保留(2)，小端
+#define SNAPSHOT_MQTT_HEADER_SIZE       8
+
+// ==================== 数据结构 ====================
+
+// 快照统计
+typedef struct {
+    bool storageReady;              // PSRAM槽位是否分配成功
+    uint32_t completed;             // 重组完成的快照数
+    uint32_t incomplete;            // 超时或被新快照打断而丢弃的快照数
+    uint32_t dropped;               // 槽位全忙、超长或非JPEG而丢弃的快照数
+    uint32_t published;             // 发布完成的快照数
+    uint32_t publishFailed;         // 发布中断或等待超时的快照数
+    uint32_t lastBytes;             // 最近一张快照的字节数
+    uint32_t lastAssemblyMs;        // 最近一张快照从首字节到收齐的时间
+    uint32_t maxAssemblyMs;         // 重组耗时最大值
+    float lastRateKBps;             // 最近一张快照的串口有效吞吐 (KB/s)
+    uint32_t lastPublishMs;         // 最近一张快照的MQTT发布耗时
+} SnapshotStats;
+
+// ==================== 函数声明 ====================
+
+void setupSnapshot();
+
+// K230任务调用：校验通过的JPEG分块，frameStartUs 为该帧首字节到达时间
+void snapshotHandleChunk(uint16_t snapshotId, uint16_t index, uint16_t count, uint32_t totalBytes,
+                         uint32_t offset, const uint8_t* data, uint16_t length, int64_t frameStartUs);
+// K230任务调用：重组超时检查
+void snapshotPoll();
+
+// MQTT任务调用：发布已重组快照的下一块
+void snapshotPublishStep();
+
+SnapshotStats getSnapshotStats();
+void printSnapshotReport();
+
+#endif
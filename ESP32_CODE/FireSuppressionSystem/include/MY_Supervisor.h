@@ -0,0 +1,86 @@
+#ifndef MY_SUPERVISOR_H
+#define MY_SUPERVISOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// ==================== 监控配置 ====================
+// 各控制任务声明周期和截止时间并每个周期签到，监控任务检查超时
+// 监控任务自身由硬件任务看门狗(TWDT)监视，卡死时由看门狗复位
+#define SUPERVISOR_MAX_TASKS            8
+#define SUPERVISOR_PERIOD_MS            500     // 监控任务扫描周期
+#define SUPERVISOR_WDT_TIMEOUT_S        5       // 任务看门狗超时 (秒)
+// 连续超时达到此次数后受控重启
+#define SUPERVISOR_MAX_CONSECUTIVE_MISSES 3
+// 超过 截止时间×此倍数 仍未签到视为卡死，立即受控重启
+#define SUPERVISOR_HANG_MULTIPLIER      4
+// 重启原因记录 (NVS)
+#define SUPERVISOR_NVS_NAMESPACE        "fire_sup"
+#define SUPERVISOR_NVS_KEY              "reset"
+
+// 签到间隔直方图：按占截止时间的百分比分桶，最后一桶为 >=200%
+#define SUPERVISOR_HIST_BUCKETS         6
+#define SUPERVISOR_HIST_EDGES_PCT       { 25, 50, 75, 100, 200 }
+
+// ==================== 枚举定义 ====================
+
+// 受控重启原因
+typedef enum {
+    SUPERVISOR_RESET_NONE = 0,
+    SUPERVISOR_RESET_DEADLINE = 1,  // 连续多次超过截止时间
+    SUPERVISOR_RESET_HANG = 2       // 长时间未签到
+} SupervisorResetReason;
+
+// ==================== 数据结构 ====================
+
+// 被监控任务
+typedef struct {
+    const char* name;               // 任务名
+    uint32_t periodMs;              // 声明的周期
+    uint32_t deadlineMs;            // 截止时间 (两次签到的最大间隔)
+    int64_t lastCheckInUs;          // 上次签到时刻
+    uint32_t checkIns;              // 签到次数
+    uint32_t misses;                // 累计超时次数
+    uint8_t consecutiveMisses;      // 连续超时次数
+    bool stalled;                   // 本次未签到已被监控任务计为超时
+    uint32_t maxIntervalMs;         // 最大签到间隔
+    uint32_t histogram[SUPERVISOR_HIST_BUCKETS];
+} SupervisedTask;
+
+// 保存到NVS的重启记录
+typedef struct {
+    uint8_t reason;                 // SupervisorResetReason
+    char task[16];                  // 触发重启的任务
+    uint32_t misses;                // 该任务累计超时次数
+    uint32_t sinceCheckInMs;        // 重启时距上次签到的时间
+    uint32_t restarts;              // 累计受控重启次数
+} SupervisorResetRecord;
+
+// ==================== 全局变量声明 ====================
+extern TaskHandle_t supervisorTaskHandle;
+extern SemaphoreHandle_t supervisorMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数 (读取上次重启原因并配置任务看门狗)
+void setupSupervisor();
+
+// 注册被监控任务，在任务进入主循环前调用，返回编号 (失败返回-1)
+int8_t supervisorRegister(const char* name, uint32_t periodMs, uint32_t deadlineMs);
+
+// 每个周期签到一次
+void supervisorCheckIn(int8_t id);
+
+// 状态获取函数
+uint32_t getSupervisorTotalMisses();
+const char* getLastResetReason();      // 如 "hang:Pump_Task"、"task_wdt"、"power_on"
+
+// 打印各任务签到统计
+void printSupervisorReport();
+
+// RTOS任务函数
+void supervisorTask(void *pvParameters);
+
+#endif
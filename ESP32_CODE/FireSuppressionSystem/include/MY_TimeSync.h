@@ -0,0 +1,68 @@
+#ifndef MY_TIME_SYNC_H
+#define MY_TIME_SYNC_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "MY_ClockFilter.h"
+
+/*
+ * MQTT时钟同步 (NTP式 请求/应答)：
+ *   设备在 TIMESYNC_TOPIC_REQUEST 上发布 {device_id, seq, t1}，
+ *   参考进程 (HOST_CODE/TimeRef/time_ref) 在 TIMESYNC_TOPIC_RESPONSE/<device_id> 上回复 {seq, t1, t2, t3}，
+ *   设备收到时记 t4，交给 MY_ClockFilter 估计偏差与漂移
+ *   本地时间为 esp_timer_get_time() (微秒)，参考时间为参考进程的 Unix 纪元微秒
+ *   发布的遥测/报警/配置/上线消息都带 epoch_us (参考纪元微秒，未同步时为0)，
+ *   遥测另带当前不确定度，便于跨设备比较事件先后与端到端延迟
+ */
+
+// ==================== 时钟同步配置 ====================
+#define TIMESYNC_TOPIC_REQUEST      "fire_alarm/time/request"
+#define TIMESYNC_TOPIC_RESPONSE     "fire_alarm/time/response/"     // 后接 device_id
+// 上电/重连后的快速采样：间隔 TIMESYNC_BURST_MS，采满 TIMESYNC_BURST_SAMPLES 个
+#define TIMESYNC_BURST_SAMPLES      CLOCK_FILTER_WINDOW
+#define TIMESYNC_BURST_MS           1000
+// 稳态采样间隔 (漂移已估计，不确定度按 CLOCK_FILTER_DRIFT_ERR_PPM 增长)
+#define TIMESYNC_INTERVAL_MS        16000
+// 应答超时，超时后放弃本次交换
+#define TIMESYNC_TIMEOUT_MS         2000
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    bool synced;
+    int64_t offsetUs;           // 参考时间 - 本地时间 (当前时刻)
+    float driftPpm;
+    int64_t uncertaintyUs;      // 未同步时为 -1
+    int64_t lastDelayUs;        // 最近一次有效交换的往返时延
+    uint32_t requests;
+    uint32_t samples;           // 有效应答数
+    uint32_t timeouts;
+    uint32_t steps;             // 偏差跳变次数
+} TimeSyncStatus;
+
+// ==================== 全局变量声明 ====================
+extern SemaphoreHandle_t timeSyncMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数
+void setupTimeSync();
+
+// MQTT任务在已连接时调用：按节奏发布请求 (直接发布，不进离线缓存队列)
+void timeSyncPoll();
+// 连接建立时调用：重新进入快速采样
+void timeSyncOnConnect();
+// MQTT回调入口：topic 为本设备应答Topic时处理并返回true；localUs 为收到报文时的本地时间
+bool timeSyncHandleMessage(const char* topic, const char* message, int64_t localUs);
+// 本设备应答Topic (订阅用)
+const char* getTimeSyncResponseTopic();
+
+// 本地时间 (esp_timer_get_time) → 参考纪元微秒，未同步时返回0
+int64_t timeSyncEpochUs(int64_t localUs);
+// 当前时刻的参考纪元微秒，未同步时返回0
+int64_t timeSyncNowEpochUs();
+TimeSyncStatus getTimeSyncStatus();
+void printTimeSyncReport();
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef MY_ZONE_H
+#define MY_ZONE_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// ==================== 分区配置 ====================
+// 一个控制器负责一层楼的多个分区 (房间)，每个分区有独立的传感器和执行器
+// 分区硬件在 MY_Zone.cpp 的 zoneTable 中描述，数量需与 ZONE_COUNT 一致
+#define ZONE_COUNT                  1
+// 分区名称最大长度 (含结尾0)
+#define ZONE_NAME_SIZE              16
+// 分区没有对应硬件时的引脚值
+#define ZONE_NO_PIN                 0xFF
+// K230摄像头所在分区 (视觉证据只计入该分区)
+#define K230_ZONE                   0
+// 分区执行器 (排烟风扇/喷淋阀) 的有效电平
+#define ZONE_OUTPUT_ACTIVE_LEVEL    HIGH
+
+/*
+ * 执行器分工：
+ *   水泵、蜂鸣器为整层共用：任一分区达到灭火等级时水泵喷水，蜂鸣器按最高等级报警
+ *   主风扇 (FAN_RELAY_PIN) 为整层排烟，按最高等级控制
+ *   各分区可选配自己的排烟风扇和喷淋阀 (zoneTable 中为 ZONE_NO_PIN 时不使用)：
+ *     - 分区风扇：该分区达到报警等级时开启
+ *     - 喷淋阀：该分区达到灭火等级时打开，水泵停止后才关闭，水只喷向着火分区
+ */
+
+// ==================== 数据结构 ====================
+
+// 分区硬件描述
+typedef struct {
+    const char* name;           // 分区名称 (用于遥测与报警事件)
+    uint8_t dhtPin;             // DHT11 数据引脚
+    uint8_t mq2AoPin;           // MQ-2 模拟输出 (需为ADC1引脚，ADC2与WiFi冲突)
+    uint8_t mq2DoPin;           // MQ-2 数字输出 (同时作为Light-sleep唤醒源)
+    uint8_t fanPin;             // 分区排烟风扇继电器，ZONE_NO_PIN=无
+    uint8_t valvePin;           // 分区喷淋电磁阀，ZONE_NO_PIN=水泵直接供水
+} ZoneDescriptor;
+
+// 分区执行器状态 (按字段分数组存放，每周期一次遍历所有分区)
+typedef struct {
+    bool fanOn[ZONE_COUNT];
+    bool valveOpen[ZONE_COUNT];
+    uint32_t valveOpens[ZONE_COUNT];    // 喷淋阀累计打开次数
+} ZoneOutputs;
+
+// 每周期耗时统计 (微秒)
+typedef struct {
+    uint32_t sampleUs;          // 最近一次采样全部分区的耗时
+    uint32_t sampleMaxUs;
+    uint32_t evalUs;            // 最近一次融合评估全部分区的耗时
+    uint32_t evalMaxUs;
+} ZoneCycleStats;
+
+// ==================== 全局变量声明 ====================
+extern const ZoneDescriptor zoneTable[ZONE_COUNT];
+extern ZoneOutputs zoneOutputs;
+extern SemaphoreHandle_t zoneMutex;
+
+// ==================== 函数声明 ====================
+
+// 初始化函数 (配置分区执行器引脚，需在执行器模块初始化之后调用)
+void setupZones();
+
+// 按各分区火灾等级更新分区风扇和喷淋阀 (水泵任务每周期、喷水前调用)
+void zoneApplyOutputs();
+
+// 强制关闭全部分区输出 (不加锁，仅供受控重启前使用)
+void zoneForceOff();
+
+// 记录一个传感器周期的耗时
+void zoneRecordCycle(uint32_t sampleUs, uint32_t evalUs);
+
+// 状态获取函数
+const char* getZoneName(uint8_t zone);
+bool isZoneFanOn(uint8_t zone);
+bool isZoneValveOpen(uint8_t zone);
+ZoneCycleStats getZoneCycleStats();
+
+// 打印各分区状态与周期耗时
+void printZoneReport();
+
+#endif
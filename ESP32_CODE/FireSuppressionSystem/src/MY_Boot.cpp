@@ -0,0 +1,140 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <esp_timer.h>
+#include "MY_Boot.h"
+#include "MY_Memory.h"
+#include "MY_MQTT.h"
+#include "MY_Ota.h"
+#include "MY_Supervisor.h"
+#include "MY_TimeSync.h"
+
+// ==================== 全局变量定义 ====================
+EventGroupHandle_t bootEvents = NULL;
+
+static SemaphoreHandle_t bootMutex = NULL;
+static BootStatus bootStatus = {};
+
+// ==================== 初始化函数 ====================
+
+void setupBoot() {
+    bootMutex = CREATE_MODULE_MUTEX();
+    bootEvents = CREATE_MODULE_EVENT_GROUP();
+    bootMark(BOOT_STAGE_SETUP);
+}
+
+// ==================== 阶段记录 ====================
+
+void bootMark(BootStage stage) {
+    // 至少记1ms，0表示尚未到达
+    uint32_t ms = (uint32_t)(esp_timer_get_time() / 1000);
+    if (ms == 0) ms = 1;
+    if (xSemaphoreTake(bootMutex, portMAX_DELAY) == pdTRUE) {
+        if (bootStatus.stageMs[stage] == 0) bootStatus.stageMs[stage] = ms;
+        xSemaphoreGive(bootMutex);
+    }
+}
+
+/**
+ * @brief 任务就绪
+ *
+ * 传感器任务在首次采样与融合评估后调用，其余控制任务在进入主循环前调用；
+ * 全部就绪时记为布防并打印耗时
+ */
+void bootTaskReady(uint32_t readyBit) {
+    if (readyBit == BOOT_READY_SENSOR) bootMark(BOOT_STAGE_FIRST_SAMPLE);
+
+    bool armedNow = false;
+    if (xSemaphoreTake(bootMutex, portMAX_DELAY) == pdTRUE) {
+        bootStatus.readyBits |= readyBit;
+        if (!bootStatus.armed && (bootStatus.readyBits & BOOT_READY_ARMED_MASK) == BOOT_READY_ARMED_MASK) {
+            bootStatus.armed = true;
+            armedNow = true;
+        }
+        xSemaphoreGive(bootMutex);
+    }
+    xEventGroupSetBits(bootEvents, readyBit);
+
+    if (armedNow) {
+        bootMark(BOOT_STAGE_ARMED);
+        BootStatus status = getBootStatus();
+        uint32_t armedMs = status.stageMs[BOOT_STAGE_ARMED];
+        Serial.println("[BOOT] Armed in " + String(armedMs) + "ms (tasks at " +
+                       String(status.stageMs[BOOT_STAGE_TASKS]) + "ms, first sample at " +
+                       String(status.stageMs[BOOT_STAGE_FIRST_SAMPLE]) + "ms)");
+        if (armedMs > BOOT_ARMED_TARGET_MS) {
+            Serial.println("[BOOT] WARNING: armed later than target " + String(BOOT_ARMED_TARGET_MS) + "ms");
+        }
+    }
+}
+
+/**
+ * @brief 等待首次采样
+ *
+ * 取代各控制任务原来固定的2-3秒启动延时：数据就绪即开始控制，
+ * 传感器任务异常时最多等待 BOOT_FIRST_SAMPLE_WAIT_MS
+ */
+void bootWaitFirstSample() {
+    xEventGroupWaitBits(bootEvents, BOOT_READY_SENSOR, pdFALSE, pdTRUE, pdMS_TO_TICKS(BOOT_FIRST_SAMPLE_WAIT_MS));
+}
+
+// ==================== 启动报告 ====================
+
+size_t buildBootReport(char* buffer, size_t size) {
+    BootStatus status = getBootStatus();
+    JsonDocument doc;
+    doc["device_id"] = DEVICE_ID;
+    doc["fw_version"] = FIRMWARE_VERSION;
+    doc["reset_reason"] = getLastResetReason();
+    doc["armed_ms"] = status.stageMs[BOOT_STAGE_ARMED];
+    doc["armed_ok"] = status.armed && status.stageMs[BOOT_STAGE_ARMED] <= BOOT_ARMED_TARGET_MS;
+    JsonObject stages = doc["stages"].to<JsonObject>();
+    for (uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+        stages[getBootStageString((BootStage)i)] = status.stageMs[i];
+    }
+    doc["epoch_us"] = timeSyncNowEpochUs();
+    return serializeJsonChecked(doc, buffer, size, "boot");
+}
+
+void bootMarkReported() {
+    if (xSemaphoreTake(bootMutex, portMAX_DELAY) == pdTRUE) {
+        bootStatus.reported = true;
+        xSemaphoreGive(bootMutex);
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+BootStatus getBootStatus() {
+    BootStatus status = {};
+    if (xSemaphoreTake(bootMutex, portMAX_DELAY) == pdTRUE) {
+        status = bootStatus;
+        xSemaphoreGive(bootMutex);
+    }
+    return status;
+}
+
+const char* getBootStageString(BootStage stage) {
+    switch (stage) {
+        case BOOT_STAGE_SETUP:          return "setup";
+        case BOOT_STAGE_CONTROL_INIT:   return "control_init";
+        case BOOT_STAGE_TASKS:          return "tasks";
+        case BOOT_STAGE_FIRST_SAMPLE:   return "first_sample";
+        case BOOT_STAGE_ARMED:          return "armed";
+        case BOOT_STAGE_WIFI:           return "wifi";
+        case BOOT_STAGE_MQTT:           return "mqtt";
+        default:                        return "unknown";
+    }
+}
+
+void printBootReport() {
+    BootStatus status = getBootStatus();
+    String line = "Boot: Armed=";
+    line += status.armed ? String(status.stageMs[BOOT_STAGE_ARMED]) + "ms" : String("no (ready 0x") +
+            String(status.readyBits, HEX) + ")";
+    line += " (target " + String(BOOT_ARMED_TARGET_MS) + "ms)";
+    for (uint8_t i = BOOT_STAGE_WIFI; i < BOOT_STAGE_COUNT; i++) {
+        line += ", " + String(getBootStageString((BootStage)i)) + "=";
+        line += status.stageMs[i] != 0 ? String(status.stageMs[i]) + "ms" : String("pending");
+    }
+    Serial.println(line);
+}
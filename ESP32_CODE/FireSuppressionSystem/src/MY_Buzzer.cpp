@@ -1,15 +1,26 @@
 #include <Arduino.h>
+#include <esp_timer.h>
+#include <driver/rmt.h>
+#include <soc/soc_caps.h>
 #include "MY_Buzzer.h"
 #include "MY_Fan.h"  // 引入火灾检测阈值定义
 #include "MY_DHT11.h"
 #include "MY_MQ2.h"
 #include "MY_Sensor.h"
 #include "MY_K230.h"
+#include "MY_Fusion.h"
+#include "MY_Config.h"
+#include "MY_Actuator.h"
+#include "MY_Power.h"
+#include "MY_Supervisor.h"
+#include "MY_Memory.h"
+#include "MY_Boot.h"
 
 // ==================== 全局变量定义 ====================
 BuzzerControl buzzerControl = {
     .state = BUZZER_OFF,
     .mode = BUZZER_MODE_AUTO,
+    .pattern = BUZZER_PATTERN_NONE,
     .lastChange = 0,
     .alarmStart = 0,
     .fireDetected = false,
@@ -19,65 +30,310 @@ BuzzerControl buzzerControl = {
 TaskHandle_t buzzerTaskHandle = NULL;
 SemaphoreHandle_t buzzerMutex = NULL;
 
-// 内部变量：蜂鸣器当前输出状态（用于产生间歇警报）
-static bool buzzerOutput = false;
-static unsigned long lastBeepToggle = 0;
+// ==================== 报警图案定义 ====================
+
+// 一步 = 响 onMs 后停 offMs，图案循环播放
+typedef struct {
+    uint16_t onMs;
+    uint16_t offMs;
+} BuzzerStep;
+
+static const BuzzerStep PATTERN_SMOKE[] = {
+    {BUZZER_BEEP_ON_MS, BUZZER_BEEP_OFF_MS}
+};
+
+static const BuzzerStep PATTERN_EVACUATION[] = {
+    {BUZZER_T3_ON_MS, BUZZER_T3_OFF_MS},
+    {BUZZER_T3_ON_MS, BUZZER_T3_OFF_MS},
+    {BUZZER_T3_ON_MS, BUZZER_T3_PAUSE_MS}
+};
+
+static const BuzzerStep PATTERN_CONTINUOUS[] = {
+    {2 * BUZZER_RMT_CHUNK_MS, 0}
+};
+
+static const BuzzerStep* getPatternSteps(BuzzerPattern pattern, size_t* count) {
+    switch (pattern) {
+        case BUZZER_PATTERN_SMOKE:
+            *count = sizeof(PATTERN_SMOKE) / sizeof(PATTERN_SMOKE[0]);
+            return PATTERN_SMOKE;
+        case BUZZER_PATTERN_EVACUATION:
+            *count = sizeof(PATTERN_EVACUATION) / sizeof(PATTERN_EVACUATION[0]);
+            return PATTERN_EVACUATION;
+        case BUZZER_PATTERN_CONTINUOUS:
+            *count = sizeof(PATTERN_CONTINUOUS) / sizeof(PATTERN_CONTINUOUS[0]);
+            return PATTERN_CONTINUOUS;
+        default:
+            *count = 0;
+            return NULL;
+    }
+}
+
+// ==================== 图案播放引擎 ====================
+// RMT模式：图案编码为RMT电平段后循环发送，播放期间完全不占用CPU
+// 定时器模式：esp_timer单次定时器逐段切换GPIO，作为RMT不可用时的回退
+
+// 蜂鸣器低电平响
+#define BUZZER_LEVEL_SOUND      0
+#define BUZZER_LEVEL_SILENT     1
+
+#define BUZZER_RMT_TICKS_PER_MS (APB_CLK_FREQ / 1000 / BUZZER_RMT_CLK_DIV)
+// 通道内存最后一个字留给结束标记
+#define BUZZER_RMT_MAX_ITEMS    (SOC_RMT_MEM_WORDS_PER_CHANNEL - 1)
+
+// GPIO直驱输出 (低电平响)，RMT不可用时使用
+static Actuator<BUZZER_PIN, LOW> buzzerGpio;
+
+static bool rmtReady = false;
+static rmt_item32_t rmtItems[BUZZER_RMT_MAX_ITEMS + 1];
+
+static esp_timer_handle_t stepTimer = NULL;
+static portMUX_TYPE stepMux = portMUX_INITIALIZER_UNLOCKED;
+static const BuzzerStep* stepPattern = NULL;
+static size_t stepCount = 0;
+static size_t stepIndex = 0;
+static bool stepSoundPhase = false;
+static bool stepActive = false;
+
+/**
+ * @brief 将图案编码为RMT电平段
+ * @return 电平段对数，0表示超出通道容量
+ */
+static size_t encodeRmtPattern(const BuzzerStep* steps, size_t count) {
+    // 先展开为单个电平段，每段不超过 BUZZER_RMT_CHUNK_MS
+    uint16_t durations[BUZZER_RMT_MAX_ITEMS * 2];
+    uint8_t levels[BUZZER_RMT_MAX_ITEMS * 2];
+    size_t halves = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        for (int phase = 0; phase < 2; phase++) {
+            uint32_t ms = (phase == 0) ? steps[i].onMs : steps[i].offMs;
+            uint8_t level = (phase == 0) ? BUZZER_LEVEL_SOUND : BUZZER_LEVEL_SILENT;
+            while (ms > 0) {
+                uint32_t chunk = ms > BUZZER_RMT_CHUNK_MS ? BUZZER_RMT_CHUNK_MS : ms;
+                if (halves >= BUZZER_RMT_MAX_ITEMS * 2) return 0;
+                durations[halves] = chunk * BUZZER_RMT_TICKS_PER_MS;
+                levels[halves] = level;
+                halves++;
+                ms -= chunk;
+            }
+        }
+    }
+
+    // 每个RMT字包含两段，段数为奇数时把最后一段一分为二 (时长为0的段会被当作结束标记)
+    if (halves % 2 != 0) {
+        if (halves >= BUZZER_RMT_MAX_ITEMS * 2) return 0;
+        uint16_t half = durations[halves - 1] / 2;
+        durations[halves] = durations[halves - 1] - half;
+        durations[halves - 1] = half;
+        levels[halves] = levels[halves - 1];
+        halves++;
+    }
+
+    size_t items = halves / 2;
+    for (size_t i = 0; i < items; i++) {
+        rmtItems[i].duration0 = durations[2 * i];
+        rmtItems[i].level0 = levels[2 * i];
+        rmtItems[i].duration1 = durations[2 * i + 1];
+        rmtItems[i].level1 = levels[2 * i + 1];
+    }
+    rmtItems[items].val = 0;    // 结束标记，循环模式下从头重播
+    return items;
+}
+
+static bool setupRmtOutput() {
+#if BUZZER_USE_RMT
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)BUZZER_PIN, BUZZER_RMT_CHANNEL);
+    config.clk_div = BUZZER_RMT_CLK_DIV;
+    config.mem_block_num = 1;
+    config.tx_config.loop_en = true;
+    config.tx_config.carrier_en = false;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;    // 空闲时保持静音
+
+    if (rmt_config(&config) != ESP_OK) return false;
+    if (rmt_driver_install(BUZZER_RMT_CHANNEL, 0, 0) != ESP_OK) return false;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 定时器模式的步进回调 (运行在esp_timer任务中)
+ * 电平切换放在临界区内，保证停止播放后不会被过期回调重新拉低
+ */
+static void stepTimerCallback(void* arg) {
+    uint32_t nextMs = 0;
+    portENTER_CRITICAL(&stepMux);
+    if (stepActive) {
+        // 跳过时长为0的段
+        for (size_t guard = 0; guard < stepCount * 2 && nextMs == 0; guard++) {
+            stepSoundPhase = !stepSoundPhase;
+            if (stepSoundPhase) {
+                stepIndex = (stepIndex + 1) % stepCount;
+                nextMs = stepPattern[stepIndex].onMs;
+            } else {
+                nextMs = stepPattern[stepIndex].offMs;
+            }
+        }
+        buzzerGpio.set(stepSoundPhase);
+    }
+    portEXIT_CRITICAL(&stepMux);
+
+    if (nextMs > 0) {
+        esp_timer_start_once(stepTimer, (uint64_t)nextMs * 1000);
+    }
+}
+
+static void stopPatternOutput() {
+    if (rmtReady) {
+        rmt_tx_stop(BUZZER_RMT_CHANNEL);
+        return;
+    }
+    if (stepTimer != NULL) {
+        esp_timer_stop(stepTimer);
+    }
+    portENTER_CRITICAL(&stepMux);
+    stepActive = false;
+    buzzerGpio.set(false);
+    portEXIT_CRITICAL(&stepMux);
+}
+
+/**
+ * @brief 开始播放图案（调用方需持有buzzerMutex）
+ */
+static void startPatternOutput(BuzzerPattern pattern) {
+    stopPatternOutput();
+
+    size_t count = 0;
+    const BuzzerStep* steps = getPatternSteps(pattern, &count);
+    if (steps == NULL || count == 0) return;
+
+    if (rmtReady) {
+        size_t items = encodeRmtPattern(steps, count);
+        if (items > 0) {
+            rmt_fill_tx_items(BUZZER_RMT_CHANNEL, rmtItems, items + 1, 0);
+            rmt_set_tx_loop_mode(BUZZER_RMT_CHANNEL, true);
+            rmt_tx_start(BUZZER_RMT_CHANNEL, true);
+            return;
+        }
+        // 图案超出通道容量时退化为长鸣，保证报警一定发声
+        Serial.println("[BUZZER] Pattern too long for RMT, falling back to steady tone");
+        items = encodeRmtPattern(PATTERN_CONTINUOUS, 1);
+        rmt_fill_tx_items(BUZZER_RMT_CHANNEL, rmtItems, items + 1, 0);
+        rmt_set_tx_loop_mode(BUZZER_RMT_CHANNEL, true);
+        rmt_tx_start(BUZZER_RMT_CHANNEL, true);
+        return;
+    }
+
+    if (stepTimer == NULL) {
+        // 无定时器可用时退化为长鸣，保证报警一定发声
+        buzzerGpio.set(true);
+        return;
+    }
+
+    portENTER_CRITICAL(&stepMux);
+    stepPattern = steps;
+    stepCount = count;
+    stepIndex = count - 1;      // 回调第一次推进后从第0步的"响"开始
+    stepSoundPhase = false;
+    stepActive = true;
+    portEXIT_CRITICAL(&stepMux);
+    stepTimerCallback(NULL);
+}
 
 // ==================== 初始化函数 ====================
 
 void setupBuzzer() {
     // 创建互斥锁
-    buzzerMutex = xSemaphoreCreateMutex();
+    buzzerMutex = CREATE_MODULE_MUTEX();
     
-    // 配置GPIO
-    pinMode(BUZZER_PIN, OUTPUT);
-    digitalWrite(BUZZER_PIN, HIGH);  // 初始关闭
+    // 配置GPIO (初始关闭)
+    buzzerGpio.begin();
+
+    rmtReady = setupRmtOutput();
+    if (!rmtReady) {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = stepTimerCallback;
+        timerArgs.arg = NULL;
+        timerArgs.dispatch_method = ESP_TIMER_TASK;
+        timerArgs.name = "buzzer_step";
+        if (esp_timer_create(&timerArgs, &stepTimer) != ESP_OK) {
+            stepTimer = NULL;
+        }
+    }
     
     buzzerControl.state = BUZZER_OFF;
     buzzerControl.mode = BUZZER_MODE_AUTO;
+    buzzerControl.pattern = BUZZER_PATTERN_NONE;
     buzzerControl.lastChange = millis();
     
     Serial.println("[BUZZER] ========== Buzzer Module Init ==========");
     Serial.println("[BUZZER] GPIO: " + String(BUZZER_PIN));
     Serial.println("[BUZZER] Mode: AUTO (default)");
-    Serial.println("[BUZZER] Beep Pattern: " + String(BUZZER_BEEP_ON_MS) + "ms ON / " + String(BUZZER_BEEP_OFF_MS) + "ms OFF");
+    Serial.println("[BUZZER] Pattern output: " + String(rmtReady ? "RMT" : (stepTimer != NULL ? "esp_timer" : "steady")));
+    Serial.println("[BUZZER] Smoke pattern: " + String(BUZZER_BEEP_ON_MS) + "ms ON / " + String(BUZZER_BEEP_OFF_MS) + "ms OFF");
     Serial.println("[BUZZER] ==========================================");
 }
 
 // ==================== 蜂鸣器控制函数 ====================
 
 /**
- * @brief 开启蜂鸣器警报
+ * @brief 播放指定报警图案
+ * @param pattern BUZZER_PATTERN_NONE 表示关闭
+ *
+ * 图案交给外设循环播放后立即返回，图案不变时重复调用没有任何开销。
  */
-void buzzerOn() {
+void buzzerPlay(BuzzerPattern pattern) {
+    bool changed = false;
     if (xSemaphoreTake(buzzerMutex, portMAX_DELAY) == pdTRUE) {
-        if (buzzerControl.state != BUZZER_ON) {
-            buzzerControl.state = BUZZER_ON;
+        if (buzzerControl.pattern != pattern) {
+            BuzzerState previous = buzzerControl.state;
+            startPatternOutput(pattern);
+            buzzerControl.pattern = pattern;
+            buzzerControl.state = (pattern == BUZZER_PATTERN_NONE) ? BUZZER_OFF : BUZZER_ON;
             buzzerControl.lastChange = millis();
-            buzzerControl.alarmStart = millis();
-            buzzerOutput = true;
-            lastBeepToggle = millis();
-            digitalWrite(BUZZER_PIN, LOW);
-            Serial.println("[BUZZER] >>> ALARM ACTIVATED <<<");
+            if (previous == BUZZER_OFF && buzzerControl.state == BUZZER_ON) {
+                buzzerControl.alarmStart = millis();
+            }
+            powerSetHold(POWER_HOLD_BUZZER, buzzerControl.state == BUZZER_ON);
+            changed = true;
         }
         xSemaphoreGive(buzzerMutex);
     }
+
+    if (changed) {
+        if (pattern == BUZZER_PATTERN_NONE) {
+            Serial.println("[BUZZER] Alarm deactivated");
+        } else {
+            Serial.println("[BUZZER] >>> ALARM ACTIVATED (" + String(getBuzzerPatternString()) + ") <<<");
+        }
+        // 状态变化后让任务重新计算自动关闭超时
+        buzzerNotify();
+    }
+}
+
+/**
+ * @brief 开启蜂鸣器警报
+ */
+void buzzerOn() {
+    buzzerPlay(BUZZER_PATTERN_EVACUATION);
 }
 
 /**
  * @brief 关闭蜂鸣器
  */
 void buzzerOff() {
-    if (xSemaphoreTake(buzzerMutex, portMAX_DELAY) == pdTRUE) {
-        if (buzzerControl.state != BUZZER_OFF) {
-            digitalWrite(BUZZER_PIN, HIGH);
-            buzzerControl.state = BUZZER_OFF;
-            buzzerControl.lastChange = millis();
-            buzzerOutput = false;
-            Serial.println("[BUZZER] Alarm deactivated");
-        }
-        xSemaphoreGive(buzzerMutex);
-    }
+    buzzerPlay(BUZZER_PATTERN_NONE);
+}
+
+/**
+ * @brief 强制停止报警输出
+ * 不获取buzzerMutex：监控模块在受控重启前调用，此时持有互斥锁的任务可能已经卡死
+ */
+void buzzerForceOff() {
+    stopPatternOutput();
 }
 
 /**
@@ -91,6 +347,12 @@ void buzzerToggle() {
     }
 }
 
+void buzzerNotify() {
+    if (buzzerTaskHandle != NULL) {
+        xTaskNotifyGive(buzzerTaskHandle);
+    }
+}
+
 // ==================== 状态获取函数 ====================
 
 BuzzerState getBuzzerState() {
@@ -102,6 +364,15 @@ BuzzerState getBuzzerState() {
     return state;
 }
 
+BuzzerPattern getBuzzerPattern() {
+    BuzzerPattern pattern = BUZZER_PATTERN_NONE;
+    if (xSemaphoreTake(buzzerMutex, portMAX_DELAY) == pdTRUE) {
+        pattern = buzzerControl.pattern;
+        xSemaphoreGive(buzzerMutex);
+    }
+    return pattern;
+}
+
 BuzzerMode getBuzzerMode() {
     BuzzerMode mode = BUZZER_MODE_AUTO;
     if (xSemaphoreTake(buzzerMutex, portMAX_DELAY) == pdTRUE) {
@@ -117,7 +388,9 @@ void setBuzzerMode(BuzzerMode mode) {
     if (xSemaphoreTake(buzzerMutex, portMAX_DELAY) == pdTRUE) {
         if (buzzerControl.mode != mode) {
             buzzerControl.mode = mode;
+            buzzerControl.timeoutActive = false;
             Serial.println("[BUZZER] Mode changed to: " + String(mode == BUZZER_MODE_AUTO ? "AUTO" : "MANUAL"));
+            buzzerNotify();
             
             // 切换到手动模式时，关闭蜂鸣器
             if (mode == BUZZER_MODE_MANUAL && buzzerControl.state == BUZZER_ON) {
@@ -144,48 +417,29 @@ const char* getBuzzerModeString() {
     return getBuzzerMode() == BUZZER_MODE_AUTO ? "auto" : "manual";
 }
 
-// ==================== 自动控制函数 ====================
-
-/**
- * @brief 根据火灾检测状态自动控制蜂鸣器（K230触发）
- * @param fireDetected 是否检测到火灾
- */
-void updateBuzzerAutoControl(bool fireDetected) {
-    // 仅在自动模式下执行
-    if (!isBuzzerAutoMode()) {
-        return;
-    }
-    
-    // 更新火灾检测状态
-    if (xSemaphoreTake(buzzerMutex, portMAX_DELAY) == pdTRUE) {
-        buzzerControl.fireDetected = fireDetected;
-        xSemaphoreGive(buzzerMutex);
-    }
-    
-    // 火灾检测：开启警报
-    if (fireDetected) {
-        if (getBuzzerState() != BUZZER_ON) {
-            Serial.println("[BUZZER] !!! FIRE DETECTED (K230) - ALARM ON !!!");
-            buzzerOn();
-        }
-    } else {
-        // 火灾解除：关闭警报
-        if (getBuzzerState() == BUZZER_ON) {
-            Serial.println("[BUZZER] Fire cleared (K230), alarm off");
-            buzzerOff();
-        }
+const char* getBuzzerPatternString() {
+    switch (getBuzzerPattern()) {
+        case BUZZER_PATTERN_SMOKE: return "smoke";
+        case BUZZER_PATTERN_EVACUATION: return "evacuation";
+        case BUZZER_PATTERN_CONTINUOUS: return "continuous";
+        default: return "none";
     }
 }
 
+// ==================== 自动控制函数 ====================
+
 /**
- * @brief 根据传感器数据自动控制蜂鸣器（温度/烟雾触发）
+ * @brief 根据火灾置信度自动控制蜂鸣器
  * 
  * 火灾判定逻辑（与风扇相同）：
- * - 温度 > 50°C → 高温报警
- * - 烟雾浓度 > 30% 或 烟雾报警触发 → 烟雾报警
+ * - 融合评估达到报警等级 → 报警
+ * 
+ * 报警图案：
+ * - 达到灭火等级 → 三连音疏散信号
+ * - 报警等级 → 间歇鸣叫
  * 
  * 安全恢复逻辑：
- * - 温度 < 40°C 且 烟雾浓度 < 15% 且 无烟雾报警 → 关闭警报
+ * - 融合评估恢复安全 (FIRE_LEVEL_NONE) → 关闭警报
  * 
  * @param temperature 当前温度 (摄氏度)
  * @param smokeLevel 当前烟雾浓度 (百分比)
@@ -197,63 +451,37 @@ void updateBuzzerAutoControlBySensor(float temperature, float smokeLevel, bool s
         return;
     }
     
-    // 判断是否处于火灾环境（使用与风扇相同的阈值）
-    bool highTemp = (temperature > TEMP_ALARM_THRESHOLD);
-    bool smokeDetected = (smokeLevel > SMOKE_ALARM_THRESHOLD) || smokeAlarm;
-    bool fireDetected = highTemp || smokeDetected;
+    // 判断是否处于火灾环境（融合置信度）
+    FireAssessment fire = fusionAssessment();
+    bool fireDetected = (fire.level != FIRE_LEVEL_NONE);
 
     // 更新火灾检测状态
+    bool timedOut = false;
     if (xSemaphoreTake(buzzerMutex, portMAX_DELAY) == pdTRUE) {
         buzzerControl.fireDetected = fireDetected;
+        if (!fireDetected) {
+            buzzerControl.timeoutActive = false;
+        }
+        timedOut = buzzerControl.timeoutActive;
         xSemaphoreGive(buzzerMutex);
     }
-
-    // k230火焰确认
-    // K230火焰确认
-    int K230FireConfirmed = 0;
-    if(xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE){
-        K230FireConfirmed = k230Control.fireState;
-        xSemaphoreGive(k230Mutex);
-    }
-    
-    if(K230FireConfirmed == K230_FIRE_CONFIRMED){
-        buzzerControl.fireDetected = true; // K230确认火焰检测时强制触发警报
-    }
     
     // 火灾检测：开启警报
     if (fireDetected) {
-        if (getBuzzerState() != BUZZER_ON) {
-            Serial.println("[BUZZER] !!! FIRE DETECTED (Sensor) - ALARM ON !!!");
-            Serial.println("[BUZZER] Temp: " + String(temperature) + "°C, Smoke: " + String(smokeLevel) + "%");
-
-            // 报警的时候响一会儿然后关闭一会儿，然后重复这个状态
-            unsigned long interval = buzzerOutput ? BUZZER_BEEP_ON_MS : BUZZER_BEEP_OFF_MS;
-            
-            if (millis() - lastBeepToggle >= interval) {
-                buzzerOutput = !buzzerOutput;
-                if(buzzerOutput==BUZZER_BEEP_ON_MS){
-                    buzzerOn();
-                }else if(buzzerOutput==BUZZER_BEEP_OFF_MS){
-                    buzzerOff();
-                }
-
-                lastBeepToggle = millis();
-            }
-
+        BuzzerPattern wanted = (fire.level == FIRE_LEVEL_SUPPRESS) ? BUZZER_PATTERN_EVACUATION : BUZZER_PATTERN_SMOKE;
+        if (!timedOut && getBuzzerPattern() != wanted) {
+            Serial.println("[BUZZER] !!! FIRE DETECTED - ALARM ON !!!");
+            Serial.println("[BUZZER] Temp: " + String(temperature) + "°C, Smoke: " + String(smokeLevel) + "%" +
+                           (smokeAlarm ? " (DO)" : "") + ", Score: " + String(fire.score, 2));
+            buzzerPlay(wanted);
         }
         return;
     }
     
     // 安全恢复：关闭警报
-    bool tempSafe = (temperature < TEMP_SAFE_THRESHOLD);
-    bool smokeSafe = (smokeLevel < SMOKE_SAFE_THRESHOLD) && !smokeAlarm;
-    
-    if (tempSafe && smokeSafe && K230FireConfirmed != K230_FIRE_CONFIRMED) {
-        buzzerControl.fireDetected = false;
-        if (getBuzzerState() == BUZZER_ON) {
-            Serial.println("[BUZZER] Environment safe (Sensor), alarm off");
-            buzzerOff();
-        }
+    if (getBuzzerState() == BUZZER_ON) {
+        Serial.println("[BUZZER] Environment safe, alarm off");
+        buzzerOff();
     }
 }
 
@@ -263,53 +491,57 @@ void updateBuzzerAutoControlBySensor(float temperature, float smokeLevel, bool s
  * @brief 蜂鸣器控制RTOS任务
  * 
  * 职责：
- * 1. 产生间歇性警报声（ON/OFF交替）
+ * 1. 传感器数据更新后评估是否需要报警及报警图案
  * 2. 检查自动关闭超时
- * 3. 与其他模块协同工作
+ * 
+ * 报警节奏由RMT/定时器播放，任务只在传感器更新、状态变化或超时到期时唤醒。
  */
 void buzzerTask(void *pvParameters) {
     Serial.println("[BUZZER] Buzzer task started on Core " + String(xPortGetCoreID()));
     
-    // 等待系统初始化
-    vTaskDelay(pdMS_TO_TICKS(2000));
+    // 等待首次采样（代替固定延时）
+    bootWaitFirstSample();
+
+    int8_t supervisorId = supervisorRegister("Buzzer_Task", SENSOR_READ_INTERVAL_MS, BUZZER_TASK_DEADLINE_MS);
+    bootTaskReady(BOOT_READY_BUZZER);
     
     for (;;) {
+        supervisorCheckIn(supervisorId);
         
-        float temperature;
-        float humidity;
-        float smokeLevel;
-        bool  smokeAlarm;
-        // 更新传感器数据缓存
-        if(xSemaphoreTake(sensorMutex,portMAX_DELAY)==pdTRUE){
-            temperature = sensorData.temperature;
-            humidity = sensorData.humidity;
-            smokeLevel = sensorData.smokeLevel;
-            smokeAlarm = sensorData.smokeAlarm;
-            xSemaphoreGive(sensorMutex);
-        }
+        // 更新传感器数据缓存（取最严重分区的读数）
+        SensorData data = getSensorData(getFireZone());
+        float temperature = data.temperature;
+        float smokeLevel = data.smokeLevel;
+        bool  smokeAlarm = data.smokeAlarm;
 
 
-        // 检查DHT读取是否有效
-        if(!isnan(humidity) && !isnan(temperature)){
-            updateBuzzerAutoControlBySensor(temperature, smokeLevel, smokeAlarm);
-        }
+        // 按火灾置信度评估（温度读取失败由融合评估的过期衰减处理）
+        updateBuzzerAutoControlBySensor(temperature, smokeLevel, smokeAlarm);
 
-        // 处理超时
-        unsigned long now = millis();
+        // 处理超时：计算距离自动关闭还有多久，作为下次等待的超时时间
+        TickType_t waitTicks = portMAX_DELAY;
+        bool expired = false;
         if(isBuzzerAutoMode()){
-            if(xSemaphoreTake(buzzerMutex,pdMS_TO_TICKS(10))==pdTRUE){
-                if(now - buzzerControl.alarmStart >= BUZZER_AUTO_OFF_MS){
-                    buzzerControl.timeoutActive = true; // 标记已经超时
-                    xSemaphoreGive(buzzerMutex);
-
-                    buzzerOff();
-                } else{
-                    xSemaphoreGive(buzzerMutex);
+            if(xSemaphoreTake(buzzerMutex, portMAX_DELAY)==pdTRUE){
+                if(buzzerControl.state == BUZZER_ON){
+                    unsigned long elapsed = millis() - buzzerControl.alarmStart;
+                    uint32_t autoOffMs = getConfig()->buzzerAutoOffMs;
+                    if(elapsed >= autoOffMs){
+                        buzzerControl.timeoutActive = true; // 标记已经超时
+                        expired = true;
+                    } else {
+                        waitTicks = pdMS_TO_TICKS(autoOffMs - elapsed);
+                    }
                 }
+                xSemaphoreGive(buzzerMutex);
             }
         }
+        if(expired){
+            Serial.println("[BUZZER] Auto-off timeout reached");
+            buzzerOff();
+        }
         
-        // 任务周期：50ms（确保警报节奏准确）
-        vTaskDelay(pdMS_TO_TICKS(50));
+        // 等待传感器更新 / 状态变化 / 超时
+        ulTaskNotifyTake(pdTRUE, waitTicks);
     }
 }
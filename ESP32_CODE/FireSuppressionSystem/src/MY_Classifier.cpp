@@ -0,0 +1,146 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "MY_Classifier.h"
+#include "MY_ClassifierModel.h"
+#include "MY_Dsp.h"
+#include "MY_Sensor.h"
+#include "MY_Memory.h"
+
+// ==================== 全局变量定义 ====================
+SemaphoreHandle_t classifierMutex = NULL;
+
+// 模型与工作区只在DSP任务中使用
+static ClsModel psramModel;
+static const ClsModel* activeModel = NULL;
+static int8_t* arena = NULL;
+
+static ClsZoneResult zoneResults[ZONE_COUNT] = {};
+static ClassifierStatus classifierStatus = {};
+
+// ==================== 初始化函数 ====================
+
+/**
+ * @brief 初始化场景分类
+ *
+ * 权重、偏置与推理工作区一次分配在PSRAM中并拷贝模型；无PSRAM时权重直接从Flash读取，
+ * 工作区 (几十字节) 放在内部RAM。模型检查不通过时不分类，也不会暂缓喷水
+ */
+void setupClassifier() {
+    classifierMutex = CREATE_MODULE_MUTEX();
+
+    classifierStatus.modelVersion = clsDefaultModel.version;
+    if (!clsModelValid(&clsDefaultModel)) {
+        Serial.println("[CLS] ERROR: model v" + String(clsDefaultModel.version) + " is invalid, classifier disabled");
+        return;
+    }
+
+    size_t modelBytes = clsModelDataBytes(&clsDefaultModel);
+    uint8_t* storage = NULL;
+    if (psramFound()) {
+        storage = (uint8_t*)ps_malloc(modelBytes + clsArenaBytes());
+    }
+    if (storage != NULL) {
+        clsModelCopy(&clsDefaultModel, storage, &psramModel);
+        activeModel = &psramModel;
+        arena = (int8_t*)(storage + modelBytes);
+        classifierStatus.modelInPsram = true;
+    } else {
+        activeModel = &clsDefaultModel;
+        arena = (int8_t*)malloc(clsArenaBytes());
+    }
+    if (arena == NULL) {
+        Serial.println("[CLS] ERROR: arena allocation failed, classifier disabled");
+        return;
+    }
+
+    classifierStatus.ready = true;
+    Serial.println("[CLS] Model v" + String(clsDefaultModel.version) + ", " + String(activeModel->layerCount) +
+                   " layers, " + String(modelBytes) + " bytes in " +
+                   String(classifierStatus.modelInPsram ? "PSRAM" : "flash") + ", backend " + String(clsBackendString()) +
+                   ", gate " + String(CLS_GATE_ENABLE ? "on" : "off"));
+}
+
+// ==================== 分类 ====================
+
+/**
+ * @brief 对全部分区的最新窗口分类（在DSP任务中调用）
+ *
+ * 烟雾窗口未采满的分区跳过；温度窗口未采满时按室温平稳处理
+ */
+void classifierRun() {
+    if (!classifierStatus.ready) return;
+
+    ClsResult results[ZONE_COUNT];
+    bool valid[ZONE_COUNT];
+    int64_t start = esp_timer_get_time();
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        DspZoneFeatures features = getDspFeatures(z);
+        valid[z] = features.smokeValid;
+        if (!valid[z]) continue;
+
+        float input[CLS_INPUT_COUNT];
+        clsBuildInput(&features.smoke, features.tempValid ? &features.temp : NULL,
+                      getSensorData(z).humidity, input);
+        clsInfer(activeModel, arena, input, &results[z]);
+    }
+    uint32_t elapsedUs = (uint32_t)(esp_timer_get_time() - start);
+
+    unsigned long now = millis();
+    if (xSemaphoreTake(classifierMutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+            if (!valid[z]) continue;
+            zoneResults[z].result = results[z];
+            zoneResults[z].valid = true;
+            zoneResults[z].updatedMs = now;
+        }
+        classifierStatus.runs++;
+        classifierStatus.lastUs = elapsedUs;
+        if (elapsedUs > classifierStatus.maxUs) classifierStatus.maxUs = elapsedUs;
+        if (elapsedUs > CLS_BUDGET_US) classifierStatus.overBudget++;
+        xSemaphoreGive(classifierMutex);
+    }
+}
+
+bool classifierVetoesSpray(uint8_t zone) {
+    if (!CLS_GATE_ENABLE || zone >= ZONE_COUNT) return false;
+    ClsZoneResult zoneResult = getClassifierResult(zone);
+    return zoneResult.valid && millis() - zoneResult.updatedMs <= CLS_FRESH_MS &&
+           zoneResult.result.prob[CLS_CLASS_NUISANCE] >= CLS_VETO_NUISANCE_PROB;
+}
+
+// ==================== 状态获取函数 ====================
+
+ClsZoneResult getClassifierResult(uint8_t zone) {
+    ClsZoneResult result = {};
+    if (zone < ZONE_COUNT && xSemaphoreTake(classifierMutex, portMAX_DELAY) == pdTRUE) {
+        result = zoneResults[zone];
+        xSemaphoreGive(classifierMutex);
+    }
+    return result;
+}
+
+ClassifierStatus getClassifierStatus() {
+    ClassifierStatus status = {};
+    if (xSemaphoreTake(classifierMutex, portMAX_DELAY) == pdTRUE) {
+        status = classifierStatus;
+        xSemaphoreGive(classifierMutex);
+    }
+    return status;
+}
+
+void printClassifierReport() {
+    ClassifierStatus status = getClassifierStatus();
+    Serial.println("Classifier: Model=v" + String(status.modelVersion) + (status.ready ? "" : " (disabled)") +
+                   " in " + String(status.modelInPsram ? "PSRAM" : "flash") +
+                   ", Infer=" + String(status.lastUs) + "us (max " + String(status.maxUs) +
+                   "), OverBudget=" + String(status.overBudget) + ", Runs=" + String(status.runs));
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        ClsZoneResult r = getClassifierResult(z);
+        if (!r.valid) continue;
+        Serial.println("  [" + String(getZoneName(z)) + "] " + String(clsClassString(r.result.label)) +
+                       " (normal " + String(r.result.prob[CLS_CLASS_NORMAL], 2) +
+                       ", nuisance " + String(r.result.prob[CLS_CLASS_NUISANCE], 2) +
+                       ", fire " + String(r.result.prob[CLS_CLASS_FIRE], 2) + ")" +
+                       (classifierVetoesSpray(z) ? " VETO" : ""));
+    }
+}
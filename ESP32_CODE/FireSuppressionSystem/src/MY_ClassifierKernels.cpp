@@ -0,0 +1,236 @@
+#include <math.h>
+#include <string.h>
+#include "MY_ClassifierKernels.h"
+
+#if CLS_USE_ESP_NN
+#include <esp_nn.h>
+#endif
+
+// ==================== 输入特征 ====================
+
+/**
+ * @brief 构造输入向量
+ *
+ * 顺序：烟雾均值、log1p(烟雾方差)、烟雾斜率、烟雾过零率、log1p(烟雾各频带能量)×3、
+ *       温度均值、升温速率 (°C/分钟)、log1p(温度方差)、湿度
+ * 方差与频带能量跨越几个数量级，取对数后再标准化
+ */
+void clsBuildInput(const DspFeatures* smoke, const DspFeatures* temp, float humidity,
+                   float out[CLS_INPUT_COUNT]) {
+    out[0] = smoke->mean;
+    out[1] = log1pf(fmaxf(smoke->variance, 0.0f));
+    out[2] = smoke->slope;
+    out[3] = smoke->zcr;
+    for (uint8_t b = 0; b < 3; b++) {
+        out[4 + b] = log1pf(fmaxf(smoke->bandEnergy[b], 0.0f));
+    }
+    if (temp != NULL) {
+        out[7] = temp->mean;
+        out[8] = temp->slope * 60.0f;
+        out[9] = log1pf(fmaxf(temp->variance, 0.0f));
+    } else {
+        out[7] = 25.0f;
+        out[8] = 0.0f;
+        out[9] = 0.0f;
+    }
+    out[10] = isnan(humidity) ? 50.0f : humidity;
+}
+
+// ==================== 模型检查与拷贝 ====================
+
+static size_t alignUp4(size_t bytes) {
+    return (bytes + 3) & ~(size_t)3;
+}
+
+bool clsModelValid(const ClsModel* model) {
+    if (model->layerCount == 0 || model->layerCount > CLS_MAX_LAYERS) return false;
+    for (uint8_t l = 0; l < model->layerCount; l++) {
+        const ClsLayer* layer = &model->layers[l];
+        if (layer->weights == NULL || layer->bias == NULL) return false;
+        if (layer->inputs == 0 || layer->outputs == 0) return false;
+        if (layer->inputs > CLS_MAX_WIDTH || layer->outputs > CLS_MAX_WIDTH) return false;
+        if (layer->activationMin < -128 || layer->activationMax > 127 ||
+            layer->activationMin > layer->activationMax) return false;
+        if (l == 0) {
+            if (layer->inputs != CLS_INPUT_COUNT) return false;
+        } else {
+            const ClsLayer* prev = &model->layers[l - 1];
+            if (layer->inputs != prev->outputs || layer->inputZeroPoint != prev->outputZeroPoint) return false;
+        }
+    }
+    return model->layers[model->layerCount - 1].outputs == CLS_CLASS_COUNT;
+}
+
+size_t clsModelDataBytes(const ClsModel* model) {
+    size_t bytes = 0;
+    for (uint8_t l = 0; l < model->layerCount; l++) {
+        const ClsLayer* layer = &model->layers[l];
+        bytes += alignUp4((size_t)layer->inputs * layer->outputs) + sizeof(int32_t) * layer->outputs;
+    }
+    return bytes;
+}
+
+/**
+ * @brief 拷贝模型
+ *
+ * 每层依次存放权重 (补齐到4字节) 和偏置
+ */
+void clsModelCopy(const ClsModel* src, void* storage, ClsModel* dst) {
+    *dst = *src;
+    uint8_t* cursor = (uint8_t*)storage;
+    for (uint8_t l = 0; l < src->layerCount; l++) {
+        const ClsLayer* layer = &src->layers[l];
+        size_t weightBytes = (size_t)layer->inputs * layer->outputs;
+        memcpy(cursor, layer->weights, weightBytes);
+        dst->layers[l].weights = (const int8_t*)cursor;
+        cursor += alignUp4(weightBytes);
+        memcpy(cursor, layer->bias, sizeof(int32_t) * layer->outputs);
+        dst->layers[l].bias = (const int32_t*)cursor;
+        cursor += sizeof(int32_t) * layer->outputs;
+    }
+}
+
+size_t clsArenaBytes() {
+    return 2 * CLS_MAX_WIDTH;
+}
+
+// ==================== 输出 ====================
+
+static void softmax(const float* logits, ClsResult* out) {
+    float maxLogit = logits[0];
+    for (uint8_t c = 1; c < CLS_CLASS_COUNT; c++) {
+        if (logits[c] > maxLogit) maxLogit = logits[c];
+    }
+    float sum = 0.0f;
+    for (uint8_t c = 0; c < CLS_CLASS_COUNT; c++) {
+        out->prob[c] = expf(logits[c] - maxLogit);
+        sum += out->prob[c];
+    }
+    out->label = CLS_CLASS_NORMAL;
+    for (uint8_t c = 0; c < CLS_CLASS_COUNT; c++) {
+        out->prob[c] /= sum;
+        if (out->prob[c] > out->prob[out->label]) out->label = (ClsClass)c;
+    }
+}
+
+// ==================== 标量参考实现 ====================
+
+void clsInferRef(const ClsModel* model, const float input[CLS_INPUT_COUNT], ClsResult* out) {
+    double act[2][CLS_MAX_WIDTH];
+    for (uint8_t i = 0; i < CLS_INPUT_COUNT; i++) {
+        act[0][i] = ((double)input[i] - model->inputMean[i]) * model->inputInvStd[i];
+    }
+
+    uint8_t cur = 0;
+    for (uint8_t l = 0; l < model->layerCount; l++) {
+        const ClsLayer* layer = &model->layers[l];
+        bool relu = layer->activationMin == layer->outputZeroPoint;
+        double biasScale = (double)layer->inputScale * layer->weightScale;
+        for (uint16_t o = 0; o < layer->outputs; o++) {
+            const int8_t* w = &layer->weights[(size_t)o * layer->inputs];
+            double acc = layer->bias[o] * biasScale;
+            for (uint16_t i = 0; i < layer->inputs; i++) {
+                acc += w[i] * (double)layer->weightScale * act[cur][i];
+            }
+            act[cur ^ 1][o] = (relu && acc < 0.0) ? 0.0 : acc;
+        }
+        cur ^= 1;
+    }
+
+    float logits[CLS_CLASS_COUNT];
+    for (uint8_t c = 0; c < CLS_CLASS_COUNT; c++) logits[c] = (float)act[cur][c];
+    softmax(logits, out);
+}
+
+// ==================== int8实现 ====================
+
+// 定点重新量化，与 TFLite Micro / esp-nn 的 MultiplyByQuantizedMultiplier 算法相同
+static int32_t saturatingRoundingDoublingHighMul(int32_t a, int32_t b) {
+    if (a == b && a == INT32_MIN) return INT32_MAX;
+    int64_t ab = (int64_t)a * b;
+    int32_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+    return (int32_t)((ab + nudge) / (1ll << 31));
+}
+
+static int32_t roundingDivideByPOT(int32_t x, int32_t exponent) {
+    int32_t mask = (int32_t)((1ll << exponent) - 1);
+    int32_t remainder = x & mask;
+    int32_t threshold = (mask >> 1) + (x < 0 ? 1 : 0);
+    return (x >> exponent) + (remainder > threshold ? 1 : 0);
+}
+
+static int32_t requantize(int32_t acc, int32_t multiplier, int32_t shift) {
+    int32_t leftShift = shift > 0 ? shift : 0;
+    int32_t rightShift = shift > 0 ? 0 : -shift;
+    return roundingDivideByPOT(saturatingRoundingDoublingHighMul(acc * (1 << leftShift), multiplier), rightShift);
+}
+
+#if !CLS_USE_ESP_NN
+// 可移植全连接层：Σ (in + offset) × w 拆成 Σ in × w + offset × Σ w，内层循环只做int8乘加
+static void fullyConnected(const ClsLayer* layer, const int8_t* in, int8_t* out) {
+    const int32_t inputOffset = -layer->inputZeroPoint;
+    for (uint16_t o = 0; o < layer->outputs; o++) {
+        const int8_t* w = &layer->weights[(size_t)o * layer->inputs];
+        int32_t dot = 0, weightSum = 0;
+        for (uint16_t i = 0; i < layer->inputs; i++) {
+            dot += in[i] * w[i];
+            weightSum += w[i];
+        }
+        int32_t acc = layer->bias[o] + dot + inputOffset * weightSum;
+        int32_t value = requantize(acc, layer->multiplier, layer->shift) + layer->outputZeroPoint;
+        if (value < layer->activationMin) value = layer->activationMin;
+        if (value > layer->activationMax) value = layer->activationMax;
+        out[o] = (int8_t)value;
+    }
+}
+#endif
+
+void clsInfer(const ClsModel* model, int8_t* arena, const float input[CLS_INPUT_COUNT], ClsResult* out) {
+    int8_t* act[2] = { arena, arena + CLS_MAX_WIDTH };
+
+    // 1. 标准化并量化输入
+    const ClsLayer* first = &model->layers[0];
+    for (uint8_t i = 0; i < CLS_INPUT_COUNT; i++) {
+        float x = (input[i] - model->inputMean[i]) * model->inputInvStd[i];
+        float q = roundf(x / first->inputScale) + first->inputZeroPoint;
+        if (q < -128.0f) q = -128.0f;
+        if (q > 127.0f) q = 127.0f;
+        act[0][i] = (int8_t)q;
+    }
+
+    // 2. 逐层计算
+    uint8_t cur = 0;
+    for (uint8_t l = 0; l < model->layerCount; l++) {
+        const ClsLayer* layer = &model->layers[l];
+#if CLS_USE_ESP_NN
+        esp_nn_fully_connected_s8(act[cur], -layer->inputZeroPoint, layer->inputs,
+                                  layer->weights, 0, layer->bias,
+                                  act[cur ^ 1], layer->outputs, layer->outputZeroPoint,
+                                  layer->shift, layer->multiplier,
+                                  layer->activationMin, layer->activationMax);
+#else
+        fullyConnected(layer, act[cur], act[cur ^ 1]);
+#endif
+        cur ^= 1;
+    }
+
+    // 3. 反量化 logit
+    const ClsLayer* last = &model->layers[model->layerCount - 1];
+    float logits[CLS_CLASS_COUNT];
+    for (uint8_t c = 0; c < CLS_CLASS_COUNT; c++) {
+        logits[c] = last->outputScale * (act[cur][c] - last->outputZeroPoint);
+    }
+    softmax(logits, out);
+}
+
+const char* clsBackendString() {
+    return CLS_USE_ESP_NN ? "esp-nn" : "portable";
+}
+
+const char* clsClassString(ClsClass label) {
+    switch (label) {
+        case CLS_CLASS_NUISANCE: return "nuisance";
+        case CLS_CLASS_FIRE: return "fire";
+        default: return "normal";
+    }
+}
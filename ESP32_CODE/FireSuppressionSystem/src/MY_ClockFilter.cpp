@@ -0,0 +1,139 @@
+#include "MY_ClockFilter.h"
+#include <string.h>
+#include <math.h>
+
+// ==================== 内部工具 ====================
+
+static int64_t absI64(int64_t value) {
+    return value < 0 ? -value : value;
+}
+
+// 漂移外推：driftPpm 即每秒偏差变化的微秒数
+static int64_t driftCorrection(float driftPpm, int64_t elapsedUs) {
+    return (int64_t)((double)driftPpm * (double)elapsedUs / 1000000.0);
+}
+
+/**
+ * @brief 以单个样本重新建立估计 (首次同步或跳变)
+ */
+static void clockFilterStep(ClockFilter* filter, const ClockSample* sample) {
+    filter->baseLocalUs = sample->localUs;
+    filter->baseOffsetUs = sample->offsetUs;
+    filter->driftPpm = 0.0f;
+    filter->driftErrPpm = CLOCK_FILTER_DRIFT_INIT_PPM;
+    filter->driftValid = false;
+    filter->jitterUs = 0.0f;
+    filter->historyCount = 0;
+    filter->historyHead = 0;
+    filter->synced = true;
+}
+
+// 采用门限：往返时延不超过近期最小值的1.5倍加容差
+static int64_t delayLimit(int64_t minDelayUs) {
+    return minDelayUs + minDelayUs / 2 + CLOCK_FILTER_DELAY_MARGIN_US;
+}
+
+static void historyPush(ClockFilter* filter, const ClockSample* sample) {
+    filter->history[filter->historyHead] = *sample;
+    filter->historyHead = (filter->historyHead + 1) % CLOCK_FILTER_HISTORY;
+    if (filter->historyCount < CLOCK_FILTER_HISTORY) filter->historyCount++;
+}
+
+// ==================== 公共接口 ====================
+
+void clockFilterReset(ClockFilter* filter) {
+    memset(filter, 0, sizeof(ClockFilter));
+}
+
+/**
+ * @brief 加入一次交换的样本，必要时更新偏差/漂移估计
+ * @return true=采用了新样本
+ */
+bool clockFilterAddSample(ClockFilter* filter, int64_t t1, int64_t t2, int64_t t3, int64_t t4) {
+    int64_t delayUs = (t4 - t1) - (t3 - t2);
+    if (t4 < t1 || t3 < t2 || delayUs < 0) return false;
+
+    ClockSample sample;
+    sample.localUs = t1 + (t4 - t1) / 2;
+    sample.offsetUs = ((t2 - t1) + (t3 - t4)) / 2;
+    sample.delayUs = delayUs;
+    filter->window[filter->head] = sample;
+    filter->head = (filter->head + 1) % CLOCK_FILTER_WINDOW;
+    if (filter->count < CLOCK_FILTER_WINDOW) filter->count++;
+    filter->samples++;
+
+    const ClockSample* best = &filter->window[0];
+    for (uint8_t i = 1; i < filter->count; i++) {
+        if (filter->window[i].delayUs < best->delayUs) best = &filter->window[i];
+    }
+
+    // 首次同步用窗口内往返时延最小的样本
+    if (!filter->synced) {
+        if (filter->count < CLOCK_FILTER_SYNC_SAMPLES) return false;
+        filter->usedDelayUs = best->delayUs;
+        filter->updates++;
+        clockFilterStep(filter, best);
+        historyPush(filter, best);
+        return true;
+    }
+
+    // 往返时延明显大于近期最小值的样本含排队时延，不采用
+    int64_t limitUs = delayLimit(best->delayUs);
+    if (sample.delayUs > limitUs) return false;
+
+    filter->usedDelayUs = sample.delayUs;
+    filter->updates++;
+
+    int64_t elapsedUs = sample.localUs - filter->baseLocalUs;
+    int64_t predicted = filter->baseOffsetUs + driftCorrection(filter->driftPpm, elapsedUs);
+    int64_t residual = sample.offsetUs - predicted;
+
+    if (absI64(residual) > CLOCK_FILTER_STEP_US) {
+        clockFilterStep(filter, &sample);
+        historyPush(filter, &sample);
+        filter->steps++;
+        return true;
+    }
+
+    // 漂移：与历史中最旧的、仍满足当前门限的采用样本之间的斜率 (微秒/秒 = ppm)
+    const ClockSample* oldest = NULL;
+    for (uint8_t i = 0; i < filter->historyCount && oldest == NULL; i++) {
+        uint8_t index = (filter->historyHead + CLOCK_FILTER_HISTORY - filter->historyCount + i) % CLOCK_FILTER_HISTORY;
+        if (filter->history[index].delayUs <= limitUs) oldest = &filter->history[index];
+    }
+    int64_t baselineUs = oldest != NULL ? sample.localUs - oldest->localUs : 0;
+    if (baselineUs >= CLOCK_FILTER_MIN_BASELINE_US) {
+        float slope = (float)((double)(sample.offsetUs - oldest->offsetUs) * 1000000.0 / (double)baselineUs);
+        float drift = slope;
+        if (filter->driftValid) {
+            float error = fabsf(slope - filter->driftPpm);
+            filter->driftErrPpm += (error - filter->driftErrPpm) / 4.0f;
+            if (filter->driftErrPpm < CLOCK_FILTER_DRIFT_ERR_PPM) filter->driftErrPpm = CLOCK_FILTER_DRIFT_ERR_PPM;
+            drift = filter->driftPpm + CLOCK_FILTER_BETA * (slope - filter->driftPpm);
+        }
+        if (drift > CLOCK_FILTER_MAX_DRIFT_PPM) drift = CLOCK_FILTER_MAX_DRIFT_PPM;
+        if (drift < -CLOCK_FILTER_MAX_DRIFT_PPM) drift = -CLOCK_FILTER_MAX_DRIFT_PPM;
+        filter->driftPpm = drift;
+        filter->driftValid = true;
+    }
+
+    // 偏差：预测值按 α 向样本靠拢
+    filter->baseLocalUs = sample.localUs;
+    filter->baseOffsetUs = predicted + (int64_t)(CLOCK_FILTER_ALPHA * (float)residual);
+    filter->jitterUs += ((float)absI64(residual) - filter->jitterUs) / 8.0f;
+    historyPush(filter, &sample);
+    return true;
+}
+
+int64_t clockFilterToReference(const ClockFilter* filter, int64_t localUs) {
+    if (!filter->synced) return 0;
+    int64_t elapsedUs = localUs - filter->baseLocalUs;
+    return localUs + filter->baseOffsetUs + driftCorrection(filter->driftPpm, elapsedUs);
+}
+
+int64_t clockFilterUncertaintyUs(const ClockFilter* filter, int64_t localUs) {
+    if (!filter->synced) return INT64_MAX;
+    int64_t ageUs = absI64(localUs - filter->baseLocalUs);
+    return filter->usedDelayUs / 2 + (int64_t)filter->jitterUs +
+           (int64_t)(filter->driftErrPpm * (double)ageUs / 1000000.0);
+}
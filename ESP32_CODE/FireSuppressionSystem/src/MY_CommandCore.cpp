@@ -0,0 +1,80 @@
+#include <string.h>
+#include "MY_CommandCore.h"
+#include "MY_JsonLite.h"
+
+static const char* const topicNames[COMMAND_TOPIC_COUNT] = {
+    COMMAND_TOPIC_FAN_CONTROL,
+    COMMAND_TOPIC_FAN_MODE,
+    COMMAND_TOPIC_PUMP_CONTROL,
+    COMMAND_TOPIC_PUMP_MODE,
+    COMMAND_TOPIC_BUZZER_CONTROL,
+    COMMAND_TOPIC_BUZZER_MODE,
+    COMMAND_TOPIC_CONFIG
+};
+
+// ==================== 内部函数 ====================
+
+static CommandAction decodeAction(const JsonLiteMember* action, bool control) {
+    if (control) {
+        if (jsonLiteEquals(action, "on")) return COMMAND_ACTION_ON;
+        if (jsonLiteEquals(action, "off")) return COMMAND_ACTION_OFF;
+    } else {
+        if (jsonLiteEquals(action, "auto")) return COMMAND_ACTION_AUTO;
+        if (jsonLiteEquals(action, "manual")) return COMMAND_ACTION_MANUAL;
+    }
+    return COMMAND_ACTION_NONE;
+}
+
+// 缺失或类型不符时保持默认值
+static void readUint(const JsonLiteObject* object, const char* key, uint32_t* value) {
+    uint32_t parsed;
+    if (jsonLiteToUint32(jsonLiteFind(object, key), &parsed)) *value = parsed;
+}
+
+// ==================== 解码 ====================
+
+const char* commandTopicName(CommandTopic topic) {
+    return (topic >= 0 && topic < COMMAND_TOPIC_COUNT) ? topicNames[topic] : NULL;
+}
+
+bool commandIsControl(CommandTopic topic) {
+    return topic == COMMAND_FAN_CONTROL || topic == COMMAND_PUMP_CONTROL || topic == COMMAND_BUZZER_CONTROL;
+}
+
+bool commandDecode(const char* topic, const char* payload, size_t length, ControlCommand* command) {
+    int found = -1;
+    for (int i = 0; i < COMMAND_TOPIC_COUNT; i++) {
+        if (strcmp(topic, topicNames[i]) == 0) {
+            found = i;
+            break;
+        }
+    }
+    if (found < 0) return false;
+
+    command->topic = (CommandTopic)found;
+    command->action = COMMAND_ACTION_NONE;
+    command->onMs = PUMP_MANUAL_SPRAY_MS;
+    command->offMs = 0;
+    command->cycles = 1;
+    command->pattern = COMMAND_PATTERN_EVACUATION;
+    if (command->topic == COMMAND_CONFIG) return true;
+
+    JsonLiteObject object;
+    if (!jsonLiteParse(payload, length, &object)) return true;
+    command->action = decodeAction(jsonLiteFind(&object, "action"), commandIsControl(command->topic));
+    if (command->action != COMMAND_ACTION_ON) return true;
+
+    if (command->topic == COMMAND_PUMP_CONTROL) {
+        readUint(&object, "duration_ms", &command->onMs);
+        readUint(&object, "on_ms", &command->onMs);
+        readUint(&object, "off_ms", &command->offMs);
+        uint32_t cycles = command->cycles;
+        readUint(&object, "cycles", &cycles);
+        if (cycles <= UINT16_MAX) command->cycles = (uint16_t)cycles;
+    } else if (command->topic == COMMAND_BUZZER_CONTROL) {
+        const JsonLiteMember* pattern = jsonLiteFind(&object, "pattern");
+        if (jsonLiteEquals(pattern, "smoke")) command->pattern = COMMAND_PATTERN_SMOKE;
+        else if (jsonLiteEquals(pattern, "continuous")) command->pattern = COMMAND_PATTERN_CONTINUOUS;
+    }
+    return true;
+}
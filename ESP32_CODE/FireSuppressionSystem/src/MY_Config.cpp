@@ -0,0 +1,206 @@
+#include <Arduino.h>
+#include <stddef.h>
+#include <atomic>
+#include <Preferences.h>
+#include "MY_Config.h"
+#include "MY_K230.h"
+#include "MY_TimeSync.h"
+#include "MY_Memory.h"
+
+// 心跳超时下限按两个心跳间隔给出
+static_assert(CONFIG_K230_HB_TIMEOUT_MIN_MS == 2 * K230_HEARTBEAT_INTERVAL_MS,
+              "CONFIG_K230_HB_TIMEOUT_MIN_MS must be two K230 heartbeat intervals");
+
+// ==================== 全局变量定义 ====================
+SemaphoreHandle_t configMutex = NULL;
+
+// RCU式快照：写者在空闲槽位中构造新配置，再原子切换指针
+// 读者只做一次原子读取，不加锁
+static SystemConfig configSlots[CONFIG_SLOT_COUNT];
+static std::atomic<const SystemConfig*> activeConfig(&configSlots[0]);
+static uint8_t activeSlot = 0;
+
+// 更新规则状态 (限频与拒绝计数)，持有configMutex时访问
+static ConfigCore configCore;
+
+static Preferences prefs;
+
+// ==================== 内部函数 ====================
+
+/**
+ * @brief 发布新快照（调用方需持有configMutex）
+ */
+static void publishSnapshot(const SystemConfig* candidate) {
+    uint8_t next = (activeSlot + 1) % CONFIG_SLOT_COUNT;
+    configSlots[next] = *candidate;
+    activeConfig.store(&configSlots[next], std::memory_order_release);
+    activeSlot = next;
+}
+
+/**
+ * @brief 逐字段保存配置
+ *
+ * 每个字段一个NVS键，结构体增减字段不影响其余字段的读取。
+ * 中途掉电可能只写入部分字段，下次启动由 configCoreValidate 兜底
+ */
+static bool saveConfig(const SystemConfig* cfg) {
+    bool ok = prefs.putUInt(CONFIG_NVS_REVISION_KEY, cfg->revision) == sizeof(uint32_t);
+    for (size_t i = 0; i < configFieldCount; i++) {
+        const ConfigField* field = &configFields[i];
+        if (field->type == CONFIG_FIELD_FLOAT) {
+            ok &= prefs.putFloat(field->nvs, configFieldGetFloat(cfg, field)) == sizeof(float);
+        } else {
+            ok &= prefs.putUInt(field->nvs, configFieldGetUint(cfg, field)) == sizeof(uint32_t);
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief 读取NVS中已保存的字段，缺失的键保持 cfg 中的原值
+ * @return 读到的字段数 (不含修订号)
+ */
+static uint8_t loadConfigKeys(SystemConfig* cfg) {
+    uint8_t found = 0;
+    if (prefs.isKey(CONFIG_NVS_REVISION_KEY)) {
+        cfg->revision = prefs.getUInt(CONFIG_NVS_REVISION_KEY, cfg->revision);
+    }
+    for (size_t i = 0; i < configFieldCount; i++) {
+        const ConfigField* field = &configFields[i];
+        if (!prefs.isKey(field->nvs)) continue;
+        if (field->type == CONFIG_FIELD_FLOAT) {
+            *configFieldFloat(cfg, field) = prefs.getFloat(field->nvs, *configFieldFloat(cfg, field));
+        } else {
+            *configFieldUint(cfg, field) = prefs.getUInt(field->nvs, *configFieldUint(cfg, field));
+        }
+        found++;
+    }
+    return found;
+}
+
+static void setError(char* error, size_t errorSize, const char* message) {
+    if (error != NULL && errorSize > 0) {
+        strncpy(error, message, errorSize - 1);
+        error[errorSize - 1] = '\0';
+    }
+}
+
+// ==================== 初始化函数 ====================
+
+void setupConfig() {
+    configMutex = CREATE_MODULE_MUTEX();
+    configCoreInit(&configCore);
+
+    SystemConfig loaded;
+    configCoreLoadDefaults(&loaded);
+
+    const char* source = "defaults";
+    if (prefs.begin(CONFIG_NVS_NAMESPACE, false)) {
+        SystemConfig stored = loaded;
+        uint8_t found = loadConfigKeys(&stored);
+        const char* invalid = configCoreValidate(&stored);
+        if (invalid != NULL) {
+            Serial.println("[CONFIG] Stored config rejected: " + String(invalid) + ", using defaults");
+        } else if (found > 0) {
+            loaded = stored;
+            source = found == configFieldCount ? "NVS" : "NVS + defaults for new fields";
+        }
+    } else {
+        Serial.println("[CONFIG] NVS open failed, using defaults");
+    }
+
+    configSlots[0] = loaded;
+    activeSlot = 0;
+    activeConfig.store(&configSlots[0], std::memory_order_release);
+
+    Serial.println("[CONFIG] ========== Config Module Init ==========");
+    Serial.println("[CONFIG] Source: " + String(source) + ", revision " + String(loaded.revision));
+    Serial.println("[CONFIG] Temp alarm/safe: " + String(loaded.tempAlarmThreshold) + "/" + String(loaded.tempSafeThreshold) + "°C");
+    Serial.println("[CONFIG] Smoke alarm/safe: " + String(loaded.smokeAlarmThreshold) + "/" + String(loaded.smokeSafeThreshold) + "%");
+    Serial.println("[CONFIG] ==========================================");
+}
+
+// ==================== 配置读取 ====================
+
+/**
+ * @brief 获取当前配置快照
+ *
+ * 只有一次原子读取，控制任务的热路径上不需要加锁。
+ * 新配置在下一个控制周期调用本函数时即生效。
+ */
+const SystemConfig* getConfig() {
+    return activeConfig.load(std::memory_order_acquire);
+}
+
+// ==================== 配置更新 ====================
+
+/**
+ * @brief 应用JSON配置更新 (规则见 configCoreUpdate)
+ *
+ * 支持的字段（均可选）：
+ *   temp_alarm, temp_safe, smoke_alarm, smoke_safe,
+ *   pump_auto_spray_ms, pump_max_duration_ms, pump_duty_window_ms, pump_duty_percent,
+ *   buzzer_auto_off_ms, k230_fire_timeout_ms, k230_pump_spray_ms,
+ *   k230_heartbeat_timeout_ms, k230_min_fps, k230_idle_report_ms, k230_alert_report_ms,
+ *   k230_conf_threshold, k230_roi_x, k230_roi_y, k230_roi_w, k230_roi_h,
+ *   outbox_drain_rate
+ * 另支持 {"action":"reset"} 恢复默认值
+ * 返回false时 error 中总有失败原因
+ */
+bool applyConfigJson(const char* json, char* error, size_t errorSize) {
+    setError(error, errorSize, "");
+
+    bool ok = false;
+    if (xSemaphoreTake(configMutex, portMAX_DELAY) == pdTRUE) {
+        SystemConfig candidate;
+        const char* reason = NULL;
+        ConfigUpdateResult result = configCoreUpdate(&configCore, getConfig(), json, strlen(json), millis(),
+                                                     &candidate, &reason);
+        if (result == CONFIG_UPDATE_REJECTED) {
+            setError(error, errorSize, reason);
+            Serial.println("[CONFIG] Update rejected: " + String(reason));
+        } else {
+            publishSnapshot(&candidate);
+            if (!saveConfig(&candidate)) {
+                Serial.println("[CONFIG] Warning: NVS save failed, config active until reboot");
+            }
+            Serial.println(String(result == CONFIG_UPDATE_RESET ? "[CONFIG] Reset to defaults, revision " :
+                                  "[CONFIG] Updated to revision ") + String(candidate.revision));
+            ok = true;
+        }
+        xSemaphoreGive(configMutex);
+    }
+    return ok;
+}
+
+bool resetConfigToDefaults() {
+    bool ok = false;
+    if (xSemaphoreTake(configMutex, portMAX_DELAY) == pdTRUE) {
+        SystemConfig defaults;
+        if (configCoreReset(&configCore, getConfig(), millis(), &defaults)) {
+            publishSnapshot(&defaults);
+            saveConfig(&defaults);
+            Serial.println("[CONFIG] Reset to defaults, revision " + String(defaults.revision));
+            ok = true;
+        }
+        xSemaphoreGive(configMutex);
+    }
+    return ok;
+}
+
+// ==================== 状态获取函数 ====================
+
+String createConfigJson() {
+    char payload[CONFIG_STATE_SIZE];
+    size_t length = configCoreBuildState(getConfig(), getConfigRejectCount(), timeSyncNowEpochUs(),
+                                         payload, sizeof(payload));
+    if (length >= sizeof(payload)) {
+        Serial.println("[CONFIG] config/state payload too large: " + String(length) + " bytes");
+        return String();
+    }
+    return String(payload);
+}
+
+uint32_t getConfigRejectCount() {
+    return configCore.rejects;
+}
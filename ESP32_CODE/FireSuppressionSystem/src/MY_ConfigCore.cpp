@@ -0,0 +1,230 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "MY_ConfigCore.h"
+#include "MY_JsonLite.h"
+
+// ==================== 字段表 ====================
+
+#define CONFIG_FIELD(json, nvs, type, member) { json, nvs, type, offsetof(SystemConfig, member) }
+
+const ConfigField configFields[] = {
+    CONFIG_FIELD("temp_alarm", "t_alarm", CONFIG_FIELD_FLOAT, tempAlarmThreshold),
+    CONFIG_FIELD("temp_safe", "t_safe", CONFIG_FIELD_FLOAT, tempSafeThreshold),
+    CONFIG_FIELD("smoke_alarm", "s_alarm", CONFIG_FIELD_FLOAT, smokeAlarmThreshold),
+    CONFIG_FIELD("smoke_safe", "s_safe", CONFIG_FIELD_FLOAT, smokeSafeThreshold),
+    CONFIG_FIELD("pump_auto_spray_ms", "p_spray", CONFIG_FIELD_UINT, pumpAutoSprayMs),
+    CONFIG_FIELD("pump_max_duration_ms", "p_max", CONFIG_FIELD_UINT, pumpMaxDurationMs),
+    CONFIG_FIELD("pump_duty_window_ms", "p_duty_win", CONFIG_FIELD_UINT, pumpDutyWindowMs),
+    CONFIG_FIELD("pump_duty_percent", "p_duty_pct", CONFIG_FIELD_UINT, pumpDutyPercent),
+    CONFIG_FIELD("buzzer_auto_off_ms", "b_auto_off", CONFIG_FIELD_UINT, buzzerAutoOffMs),
+    CONFIG_FIELD("k230_fire_timeout_ms", "k_fire_to", CONFIG_FIELD_UINT, k230FireTimeoutMs),
+    CONFIG_FIELD("k230_pump_spray_ms", "k_spray", CONFIG_FIELD_UINT, k230PumpSprayMs),
+    CONFIG_FIELD("k230_heartbeat_timeout_ms", "k_hb_to", CONFIG_FIELD_UINT, k230HeartbeatTimeoutMs),
+    CONFIG_FIELD("k230_min_fps", "k_min_fps", CONFIG_FIELD_FLOAT, k230MinFps),
+    CONFIG_FIELD("k230_idle_report_ms", "k_idle_ms", CONFIG_FIELD_UINT, k230IdleReportMs),
+    CONFIG_FIELD("k230_alert_report_ms", "k_alert_ms", CONFIG_FIELD_UINT, k230AlertReportMs),
+    CONFIG_FIELD("k230_conf_threshold", "k_conf", CONFIG_FIELD_FLOAT, k230ConfThreshold),
+    CONFIG_FIELD("k230_roi_x", "k_roi_x", CONFIG_FIELD_UINT, k230RoiX),
+    CONFIG_FIELD("k230_roi_y", "k_roi_y", CONFIG_FIELD_UINT, k230RoiY),
+    CONFIG_FIELD("k230_roi_w", "k_roi_w", CONFIG_FIELD_UINT, k230RoiW),
+    CONFIG_FIELD("k230_roi_h", "k_roi_h", CONFIG_FIELD_UINT, k230RoiH),
+    CONFIG_FIELD("outbox_drain_rate", "o_drain_rate", CONFIG_FIELD_UINT, outboxDrainRatePerSec),
+};
+
+const size_t configFieldCount = sizeof(configFields) / sizeof(configFields[0]);
+
+float* configFieldFloat(SystemConfig* cfg, const ConfigField* field) {
+    return (float*)((uint8_t*)cfg + field->offset);
+}
+
+uint32_t* configFieldUint(SystemConfig* cfg, const ConfigField* field) {
+    return (uint32_t*)((uint8_t*)cfg + field->offset);
+}
+
+float configFieldGetFloat(const SystemConfig* cfg, const ConfigField* field) {
+    return *(const float*)((const uint8_t*)cfg + field->offset);
+}
+
+uint32_t configFieldGetUint(const SystemConfig* cfg, const ConfigField* field) {
+    return *(const uint32_t*)((const uint8_t*)cfg + field->offset);
+}
+
+// ==================== 默认值与校验 ====================
+
+void configCoreInit(ConfigCore* core) {
+    memset(core, 0, sizeof(*core));
+}
+
+void configCoreLoadDefaults(SystemConfig* cfg) {
+    cfg->revision = 0;
+    cfg->tempAlarmThreshold = TEMP_ALARM_THRESHOLD;
+    cfg->tempSafeThreshold = TEMP_SAFE_THRESHOLD;
+    cfg->smokeAlarmThreshold = SMOKE_ALARM_THRESHOLD;
+    cfg->smokeSafeThreshold = SMOKE_SAFE_THRESHOLD;
+    cfg->pumpAutoSprayMs = PUMP_AUTO_SPRAY_MS;
+    cfg->pumpMaxDurationMs = PUMP_MAX_DURATION_MS;
+    cfg->pumpDutyWindowMs = PUMP_DUTY_WINDOW_MS;
+    cfg->pumpDutyPercent = PUMP_DUTY_PERCENT;
+    cfg->buzzerAutoOffMs = BUZZER_AUTO_OFF_MS;
+    cfg->k230FireTimeoutMs = K230_FIRE_TIMEOUT_MS;
+    cfg->k230PumpSprayMs = K230_PUMP_SPRAY_MS;
+    cfg->k230HeartbeatTimeoutMs = K230_HEARTBEAT_TIMEOUT_MS;
+    cfg->k230MinFps = K230_MIN_FPS;
+    cfg->k230IdleReportMs = K230_IDLE_REPORT_MS;
+    cfg->k230AlertReportMs = K230_ALERT_REPORT_MS;
+    cfg->k230ConfThreshold = K230_CONF_THRESHOLD;
+    cfg->k230RoiX = 0;
+    cfg->k230RoiY = 0;
+    cfg->k230RoiW = K230_ROI_FULL;
+    cfg->k230RoiH = K230_ROI_FULL;
+    cfg->outboxDrainRatePerSec = OUTBOX_DRAIN_RATE_PER_SEC;
+}
+
+const char* configCoreValidate(const SystemConfig* cfg) {
+    if (isnan(cfg->tempAlarmThreshold) || cfg->tempAlarmThreshold < 20.0f || cfg->tempAlarmThreshold > 150.0f)
+        return "temp_alarm out of range [20,150]";
+    if (isnan(cfg->tempSafeThreshold) || cfg->tempSafeThreshold < 0.0f || cfg->tempSafeThreshold >= cfg->tempAlarmThreshold)
+        return "temp_safe must be in [0,temp_alarm)";
+    if (isnan(cfg->smokeAlarmThreshold) || cfg->smokeAlarmThreshold < 1.0f || cfg->smokeAlarmThreshold > 100.0f)
+        return "smoke_alarm out of range [1,100]";
+    if (isnan(cfg->smokeSafeThreshold) || cfg->smokeSafeThreshold < 0.0f || cfg->smokeSafeThreshold >= cfg->smokeAlarmThreshold)
+        return "smoke_safe must be in [0,smoke_alarm)";
+    if (cfg->pumpMaxDurationMs < 500 || cfg->pumpMaxDurationMs > 60000)
+        return "pump_max_duration_ms out of range [500,60000]";
+    if (cfg->pumpAutoSprayMs < 100 || cfg->pumpAutoSprayMs > cfg->pumpMaxDurationMs)
+        return "pump_auto_spray_ms must be in [100,pump_max_duration_ms]";
+    if (cfg->pumpDutyWindowMs < 10000 || cfg->pumpDutyWindowMs > 600000)
+        return "pump_duty_window_ms out of range [10000,600000]";
+    if (cfg->pumpDutyPercent < 5 || cfg->pumpDutyPercent > 100)
+        return "pump_duty_percent out of range [5,100]";
+    // 保证一次最长喷水总能放进占空比预算
+    if ((uint64_t)cfg->pumpDutyWindowMs * cfg->pumpDutyPercent / 100 < cfg->pumpMaxDurationMs)
+        return "pump duty budget must be >= pump_max_duration_ms";
+    if (cfg->buzzerAutoOffMs < 1000 || cfg->buzzerAutoOffMs > 3600000)
+        return "buzzer_auto_off_ms out of range [1000,3600000]";
+    if (cfg->k230FireTimeoutMs < 500 || cfg->k230FireTimeoutMs > 60000)
+        return "k230_fire_timeout_ms out of range [500,60000]";
+    if (cfg->k230PumpSprayMs < 100 || cfg->k230PumpSprayMs > 60000)
+        return "k230_pump_spray_ms out of range [100,60000]";
+    // 至少容忍一次心跳丢失
+    if (cfg->k230HeartbeatTimeoutMs < CONFIG_K230_HB_TIMEOUT_MIN_MS || cfg->k230HeartbeatTimeoutMs > 300000)
+        return "k230_heartbeat_timeout_ms out of range [10000,300000]";
+    if (isnan(cfg->k230MinFps) || cfg->k230MinFps < 0.0f || cfg->k230MinFps > 60.0f)
+        return "k230_min_fps out of range [0,60]";
+    // 空闲间隔不超过视觉证据的新鲜期，否则两次上报之间证据会开始衰减
+    if (cfg->k230IdleReportMs < 100 || cfg->k230IdleReportMs > 2000)
+        return "k230_idle_report_ms out of range [100,2000]";
+    if (cfg->k230AlertReportMs < 50 || cfg->k230AlertReportMs > cfg->k230IdleReportMs)
+        return "k230_alert_report_ms must be in [50,k230_idle_report_ms]";
+    if (isnan(cfg->k230ConfThreshold) || cfg->k230ConfThreshold < 0.0f || cfg->k230ConfThreshold > 0.95f)
+        return "k230_conf_threshold out of range [0,0.95]";
+    if (cfg->k230RoiW < 100 || cfg->k230RoiW > K230_ROI_FULL || cfg->k230RoiH < 100 || cfg->k230RoiH > K230_ROI_FULL ||
+        cfg->k230RoiX > K230_ROI_FULL - cfg->k230RoiW || cfg->k230RoiY > K230_ROI_FULL - cfg->k230RoiH)
+        return "k230_roi must fit in 1000x1000 with w,h >= 100";
+    if (cfg->outboxDrainRatePerSec < 1 || cfg->outboxDrainRatePerSec > 100)
+        return "outbox_drain_rate out of range [1,100]";
+    return NULL;
+}
+
+// ==================== 更新规则 ====================
+
+static bool rateLimited(const ConfigCore* core, uint32_t nowMs) {
+    // 限制更新频率，保证被替换的快照已无读者
+    return core->updated && nowMs - core->lastUpdateMs < CONFIG_MIN_UPDATE_INTERVAL_MS;
+}
+
+static ConfigUpdateResult reject(ConfigCore* core, const char** error, const char* reason) {
+    core->rejects++;
+    if (error != NULL) *error = reason;
+    return CONFIG_UPDATE_REJECTED;
+}
+
+static void accept(ConfigCore* core, uint32_t nowMs) {
+    core->updated = true;
+    core->lastUpdateMs = nowMs;
+}
+
+/**
+ * @brief 读取负载中存在的字段，缺失或为 null 的字段保持原值
+ * @return 类型不符的字段名，全部可读时为NULL
+ */
+static const char* readFields(const JsonLiteObject* object, SystemConfig* cfg) {
+    for (size_t i = 0; i < configFieldCount; i++) {
+        const ConfigField* field = &configFields[i];
+        const JsonLiteMember* member = jsonLiteFind(object, field->json);
+        if (member == NULL || member->type == JSON_LITE_NULL) continue;
+        if (field->type == CONFIG_FIELD_FLOAT) {
+            double value;
+            if (!jsonLiteToDouble(member, &value)) return field->json;
+            *configFieldFloat(cfg, field) = (float)value;
+        } else {
+            if (!jsonLiteToUint32(member, configFieldUint(cfg, field))) return field->json;
+        }
+    }
+    return NULL;
+}
+
+ConfigUpdateResult configCoreUpdate(ConfigCore* core, const SystemConfig* current, const char* json, size_t length,
+                                    uint32_t nowMs, SystemConfig* next, const char** error) {
+    JsonLiteObject object;
+    if (!jsonLiteParse(json, length, &object)) {
+        return reject(core, error, "invalid json");
+    }
+
+    if (jsonLiteEquals(jsonLiteFind(&object, "action"), "reset")) {
+        if (!configCoreReset(core, current, nowMs, next)) {
+            if (error != NULL) *error = "update rate limited";
+            return CONFIG_UPDATE_REJECTED;
+        }
+        return CONFIG_UPDATE_RESET;
+    }
+
+    if (rateLimited(core, nowMs)) {
+        return reject(core, error, "update rate limited");
+    }
+
+    *next = *current;
+    if (readFields(&object, next) != NULL) {
+        return reject(core, error, "config fields must be numbers");
+    }
+    const char* invalid = configCoreValidate(next);
+    if (invalid != NULL) {
+        return reject(core, error, invalid);
+    }
+    next->revision = current->revision + 1;
+    accept(core, nowMs);
+    return CONFIG_UPDATE_APPLIED;
+}
+
+bool configCoreReset(ConfigCore* core, const SystemConfig* current, uint32_t nowMs, SystemConfig* next) {
+    if (rateLimited(core, nowMs)) {
+        core->rejects++;
+        return false;
+    }
+    configCoreLoadDefaults(next);
+    next->revision = current->revision + 1;
+    accept(core, nowMs);
+    return true;
+}
+
+// ==================== 配置状态 ====================
+
+size_t configCoreBuildState(const SystemConfig* cfg, uint32_t rejects, int64_t epochUs, char* buffer, size_t size) {
+    JsonLiteWriter w;
+    jsonLiteBegin(&w, buffer, size);
+    jsonLiteBeginObject(&w, NULL);
+    jsonLiteUint(&w, "revision", cfg->revision);
+    for (size_t i = 0; i < configFieldCount; i++) {
+        const ConfigField* field = &configFields[i];
+        if (field->type == CONFIG_FIELD_FLOAT) {
+            jsonLiteFloat(&w, field->json, configFieldGetFloat(cfg, field));
+        } else {
+            jsonLiteUint(&w, field->json, configFieldGetUint(cfg, field));
+        }
+    }
+    jsonLiteUint(&w, "rejected", rejects);
+    jsonLiteInt(&w, "epoch_us", epochUs);
+    jsonLiteEndObject(&w);
+    return jsonLiteEnd(&w);
+}
@@ -0,0 +1,319 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "MY_Dsp.h"
+#include "MY_Sensor.h"
+#include "MY_Classifier.h"
+#include "MY_Fusion.h"
+#include "MY_Supervisor.h"
+#include "MY_Memory.h"
+
+// ==================== 全局变量定义 ====================
+TaskHandle_t dspTaskHandle = NULL;
+SemaphoreHandle_t dspMutex = NULL;
+
+// 样本环形缓冲：每个样本同时写入 pos 和 pos+窗口长度，最近一个窗口总是从 pos 开始连续存放
+typedef struct {
+    DspSample smoke[ZONE_COUNT][DSP_SMOKE_WINDOW * 2];     // 只由DSP任务读写
+    uint16_t smokePos;
+    uint32_t smokeCount;
+    DspSample temp[ZONE_COUNT][DSP_TEMP_WINDOW * 2];       // 传感器任务写入，受 dspMutex 保护
+    uint16_t tempPos[ZONE_COUNT];
+    uint32_t tempCount[ZONE_COUNT];
+    bool tempPending[ZONE_COUNT];
+} DspBuffers;
+
+static DspBuffers buffers = {};
+// 计划含FFT工作区，只在DSP任务中使用
+static DspPlan smokePlan;
+static DspPlan tempPlan;
+static bool plansReady = false;
+
+static DspZoneFeatures zoneFeatures[ZONE_COUNT] = {};
+static DspStatus dspStatus = {};
+
+// ==================== 初始化函数 ====================
+
+void setupDsp() {
+    dspMutex = CREATE_MODULE_MUTEX();
+
+    static const DspBand smokeBands[] = DSP_SMOKE_BANDS;
+    static const DspBand tempBands[] = DSP_TEMP_BANDS;
+    plansReady = dspPlanInit(&smokePlan, DSP_SMOKE_WINDOW, DSP_SMOKE_RATE_HZ, DSP_SMOKE_SCALE,
+                             smokeBands, DSP_SMOKE_BAND_COUNT) &&
+                 dspPlanInit(&tempPlan, DSP_TEMP_WINDOW, 1000.0f / SENSOR_READ_INTERVAL_MS, DSP_TEMP_SCALE,
+                             tempBands, DSP_TEMP_BAND_COUNT);
+
+    if (plansReady) {
+        Serial.println("[DSP] Pipeline: " + String(getDspPipelineString()) + ", FFT: " + String(dspBackendString()) +
+                       ", smoke " + String(DSP_SMOKE_WINDOW) + "@" + String(DSP_SMOKE_RATE_HZ) + "Hz" +
+                       ", temp " + String(DSP_TEMP_WINDOW) + " samples");
+    } else {
+        Serial.println("[DSP] ERROR: invalid window configuration, features disabled");
+    }
+}
+
+// ==================== 样本转换 ====================
+
+static DspSample toSmokeSample(int adc) {
+#if DSP_PIPELINE_FIXED
+    return (DspSample)adc;
+#else
+    return adc * DSP_SMOKE_SCALE;
+#endif
+}
+
+static DspSample toTempSample(float temperature) {
+#if DSP_PIPELINE_FIXED
+    float raw = roundf(temperature / DSP_TEMP_SCALE);
+    if (raw > 32767.0f) raw = 32767.0f;
+    if (raw < -32768.0f) raw = -32768.0f;
+    return (DspSample)raw;
+#else
+    return temperature;
+#endif
+}
+
+static void computeFeatures(DspPlan* plan, const DspSample* window, DspFeatures* out) {
+#if DSP_PIPELINE_FIXED
+    dspFeaturesQ15(plan, window, out);
+#else
+    dspFeaturesF32(plan, window, out);
+#endif
+}
+
+// ==================== 温度输入 ====================
+
+/**
+ * @brief 送入一个温度样本（在传感器任务中调用）
+ *
+ * 只做拷贝，特征在DSP任务下一个采样周期计算
+ */
+void dspPushTemperature(uint8_t zone, float temperature) {
+    if (zone >= ZONE_COUNT || isnan(temperature)) return;
+    DspSample sample = toTempSample(temperature);
+    if (xSemaphoreTake(dspMutex, portMAX_DELAY) == pdTRUE) {
+        uint16_t pos = buffers.tempPos[zone];
+        buffers.temp[zone][pos] = sample;
+        buffers.temp[zone][pos + DSP_TEMP_WINDOW] = sample;
+        buffers.tempPos[zone] = (pos + 1) % DSP_TEMP_WINDOW;
+        buffers.tempCount[zone]++;
+        if (buffers.tempCount[zone] >= DSP_TEMP_WINDOW && buffers.tempCount[zone] % DSP_TEMP_HOP == 0) {
+            buffers.tempPending[zone] = true;
+        }
+        xSemaphoreGive(dspMutex);
+    }
+}
+
+// ==================== 特征计算 ====================
+
+static void computeSmokeFeatures() {
+    DspFeatures features[ZONE_COUNT];
+    int64_t start = esp_timer_get_time();
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        computeFeatures(&smokePlan, &buffers.smoke[z][buffers.smokePos], &features[z]);
+    }
+    uint32_t elapsedUs = (uint32_t)(esp_timer_get_time() - start);
+
+    unsigned long now = millis();
+    if (xSemaphoreTake(dspMutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+            zoneFeatures[z].smoke = features[z];
+            zoneFeatures[z].smokeValid = true;
+            zoneFeatures[z].smokeUpdatedMs = now;
+        }
+        dspStatus.smokeWindows += ZONE_COUNT;
+        dspStatus.smokeUs = elapsedUs;
+        if (elapsedUs > dspStatus.smokeMaxUs) dspStatus.smokeMaxUs = elapsedUs;
+        xSemaphoreGive(dspMutex);
+    }
+}
+
+static void computeTempFeatures() {
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        DspSample window[DSP_TEMP_WINDOW];
+        bool pending = false;
+        if (xSemaphoreTake(dspMutex, portMAX_DELAY) == pdTRUE) {
+            if (buffers.tempPending[z]) {
+                memcpy(window, &buffers.temp[z][buffers.tempPos[z]], sizeof(window));
+                buffers.tempPending[z] = false;
+                pending = true;
+            }
+            xSemaphoreGive(dspMutex);
+        }
+        if (!pending) continue;
+
+        DspFeatures features;
+        int64_t start = esp_timer_get_time();
+        computeFeatures(&tempPlan, window, &features);
+        uint32_t elapsedUs = (uint32_t)(esp_timer_get_time() - start);
+
+        if (xSemaphoreTake(dspMutex, portMAX_DELAY) == pdTRUE) {
+            zoneFeatures[z].temp = features;
+            zoneFeatures[z].tempValid = true;
+            zoneFeatures[z].tempUpdatedMs = millis();
+            dspStatus.tempWindows++;
+            dspStatus.tempUs = elapsedUs;
+            if (elapsedUs > dspStatus.tempMaxUs) dspStatus.tempMaxUs = elapsedUs;
+            xSemaphoreGive(dspMutex);
+        }
+    }
+}
+
+// ==================== 空闲暂停 ====================
+
+/**
+ * @brief 是否可以暂停高速采样
+ * 全部分区安全、置信度低于清除阈值且没有DO报警时不需要烟雾窗口特征
+ */
+static bool dspShouldIdle() {
+#if DSP_IDLE_PAUSE_ENABLE
+    if (getFireLevel() != FIRE_LEVEL_NONE || getFireScore() >= FUSION_CLEAR_SCORE) {
+        return false;
+    }
+    // 直接读DO引脚 (低电平报警)，不等传感器任务持有的互斥锁
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        if (digitalRead(zoneTable[z].mq2DoPin) == LOW) return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 进入或退出空闲暂停
+ * 进入时丢弃未采满的窗口并将烟雾特征置为无效，恢复后重新采满一个窗口
+ */
+static void dspSetIdle(bool idle) {
+    if (xSemaphoreTake(dspMutex, portMAX_DELAY) == pdTRUE) {
+        if (idle && !dspStatus.idle) {
+            dspStatus.idlePauses++;
+            for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+                zoneFeatures[z].smokeValid = false;
+            }
+        }
+        dspStatus.idle = idle;
+        xSemaphoreGive(dspMutex);
+    }
+    if (idle) {
+        buffers.smokeCount = 0;
+    }
+}
+
+// ==================== RTOS任务函数 ====================
+
+/**
+ * @brief DSP任务
+ *
+ * 固定周期采样各分区MQ-2模拟量写入环形缓冲，每 DSP_SMOKE_HOP 个样本计算一次烟雾窗口特征
+ * 并做一次场景分类，有新的温度样本时计算温度窗口特征。落后超过一个周期时不补采
+ * 空闲时暂停高速采样，只按 DSP_IDLE_POLL_MS 检查是否恢复并计算温度窗口
+ */
+void dspTask(void *pvParameters) {
+    Serial.println("[DSP] DSP task started on Core " + String(xPortGetCoreID()));
+
+    const uint32_t periodMs = 1000 / DSP_SMOKE_RATE_HZ;
+    int8_t supervisorId = supervisorRegister("DSP_Task", periodMs, DSP_TASK_DEADLINE_MS);
+    uint16_t sinceHop = 0;
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;) {
+        supervisorCheckIn(supervisorId);
+
+        // 空闲暂停：每 DSP_IDLE_POLL_MS 检查一次是否恢复
+        if (dspStatus.idle) {
+            if (dspShouldIdle()) {
+                if (plansReady) computeTempFeatures();
+                vTaskDelay(pdMS_TO_TICKS(DSP_IDLE_POLL_MS));
+                lastWake = xTaskGetTickCount();
+                continue;
+            }
+            dspSetIdle(false);
+            sinceHop = 0;
+        }
+
+        if (plansReady) {
+            // 1. 采样全部分区
+            uint16_t pos = buffers.smokePos;
+            for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+                DspSample sample = toSmokeSample(analogRead(zoneTable[z].mq2AoPin));
+                buffers.smoke[z][pos] = sample;
+                buffers.smoke[z][pos + DSP_SMOKE_WINDOW] = sample;
+            }
+            buffers.smokePos = (pos + 1) % DSP_SMOKE_WINDOW;
+            buffers.smokeCount++;
+
+            // 2. 采满一个窗口后每 DSP_SMOKE_HOP 个样本计算一次，并对新窗口做场景分类
+            if (++sinceHop >= DSP_SMOKE_HOP && buffers.smokeCount >= DSP_SMOKE_WINDOW) {
+                sinceHop = 0;
+                computeSmokeFeatures();
+                classifierRun();
+            }
+
+            // 3. 温度窗口
+            computeTempFeatures();
+
+            // 4. 每 DSP_SMOKE_HOP 个样本检查一次是否进入空闲暂停
+            if (buffers.smokeCount % DSP_SMOKE_HOP == 0 && dspShouldIdle()) {
+                dspSetIdle(true);
+            }
+        }
+
+        // 已错过下一个采样时刻一个周期以上时重新对齐，不连续补采
+        if (xTaskGetTickCount() - lastWake >= pdMS_TO_TICKS(periodMs) * 2) {
+            if (xSemaphoreTake(dspMutex, portMAX_DELAY) == pdTRUE) {
+                dspStatus.lateSamples++;
+                xSemaphoreGive(dspMutex);
+            }
+            lastWake = xTaskGetTickCount();
+        }
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(periodMs));
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+DspZoneFeatures getDspFeatures(uint8_t zone) {
+    DspZoneFeatures features = {};
+    if (zone < ZONE_COUNT && xSemaphoreTake(dspMutex, portMAX_DELAY) == pdTRUE) {
+        features = zoneFeatures[zone];
+        xSemaphoreGive(dspMutex);
+    }
+    return features;
+}
+
+DspStatus getDspStatus() {
+    DspStatus status = {};
+    if (xSemaphoreTake(dspMutex, portMAX_DELAY) == pdTRUE) {
+        status = dspStatus;
+        xSemaphoreGive(dspMutex);
+    }
+    return status;
+}
+
+const char* getDspPipelineString() {
+    return DSP_PIPELINE_FIXED ? "q15" : "f32";
+}
+
+void printDspReport() {
+    DspStatus status = getDspStatus();
+    Serial.println("DSP: Pipeline=" + String(getDspPipelineString()) + " (fft " + String(dspBackendString()) +
+                   "), Smoke=" + String(status.smokeUs) + "us (max " + String(status.smokeMaxUs) +
+                   "), Temp=" + String(status.tempUs) + "us (max " + String(status.tempMaxUs) +
+                   "), Windows=" + String(status.smokeWindows) + "/" + String(status.tempWindows) +
+                   ", Late=" + String(status.lateSamples) +
+                   ", Idle=" + String(status.idle ? "yes" : "no") + " (" + String(status.idlePauses) + ")");
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        DspZoneFeatures f = getDspFeatures(z);
+        if (!f.smokeValid) continue;
+        String line = "  [" + String(getZoneName(z)) + "] smoke var=" + String(f.smoke.variance, 4) +
+                      " slope=" + String(f.smoke.slope, 3) + "%/s zcr=" + String(f.smoke.zcr, 2) + " bands=";
+        for (uint8_t b = 0; b < DSP_SMOKE_BAND_COUNT; b++) {
+            line += (b == 0 ? "" : "/") + String(f.smoke.bandEnergy[b], 4);
+        }
+        if (f.tempValid) {
+            line += ", temp var=" + String(f.temp.variance, 3) + " slope=" + String(f.temp.slope * 60.0f, 2) + "C/min";
+        }
+        Serial.println(line);
+    }
+}
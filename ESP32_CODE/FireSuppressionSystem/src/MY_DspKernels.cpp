@@ -0,0 +1,364 @@
+#include <math.h>
+#include <string.h>
+#include "MY_DspKernels.h"
+
+#if DSP_USE_ESP_DSP
+#include <esp_dsp.h>
+
+// esp-dsp 的旋转因子表为全局表，按最大长度初始化一次，失败时退回可移植实现
+static bool espDspReady = false;
+static bool espDspTried = false;
+
+static void espDspInit() {
+    if (espDspTried) return;
+    espDspTried = true;
+    espDspReady = dsps_fft2r_init_fc32(NULL, DSP_MAX_WINDOW) == ESP_OK &&
+                  dsps_fft2r_init_sc16(NULL, DSP_MAX_WINDOW) == ESP_OK;
+}
+#endif
+
+// ==================== 计划初始化 ====================
+
+bool dspPlanInit(DspPlan* plan, uint16_t n, float sampleRateHz, float scale,
+                 const DspBand* bands, uint8_t bandCount) {
+    if (n < DSP_MIN_WINDOW || n > DSP_MAX_WINDOW || (n & (n - 1)) != 0) return false;
+    if (!(sampleRateHz > 0.0f) || bandCount > DSP_MAX_BANDS) return false;
+
+    memset(plan, 0, sizeof(DspPlan));
+    plan->n = n;
+    while ((1u << plan->log2n) < n) plan->log2n++;
+    plan->sampleRateHz = sampleRateHz;
+    plan->scale = scale;
+    plan->bandCount = bandCount;
+
+    // 频带按bin取整：bin k 的频率为 k·fs/N，不含直流，最高到 N/2
+    for (uint8_t b = 0; b < bandCount; b++) {
+        int lo = (int)ceilf(bands[b].loHz * n / sampleRateHz);
+        int hi = (int)ceilf(bands[b].hiHz * n / sampleRateHz);
+        if (lo < 1) lo = 1;
+        if (hi > n / 2 + 1) hi = n / 2 + 1;
+        if (hi < lo) hi = lo;
+        plan->bandLo[b] = (uint16_t)lo;
+        plan->bandHi[b] = (uint16_t)hi;
+    }
+
+    // 周期Hann窗
+    double sumW2 = 0.0;
+    for (uint16_t i = 0; i < n; i++) {
+        double w = 0.5 - 0.5 * cos(2.0 * M_PI * i / n);
+        plan->windowF32[i] = (float)w;
+        plan->windowQ15[i] = (int16_t)lround(w * 32767.0);
+        sumW2 += w * w;
+    }
+    plan->windowPower = (float)(sumW2 / n);
+    plan->indexVariance = (float)((double)n * ((double)n * n - 1.0) / 12.0);
+
+    for (uint16_t k = 0; k < n / 2; k++) {
+        double angle = -2.0 * M_PI * k / n;
+        plan->twiddleF32[2 * k] = (float)cos(angle);
+        plan->twiddleF32[2 * k + 1] = (float)sin(angle);
+        plan->twiddleQ15[2 * k] = (int16_t)lround(cos(angle) * 32767.0);
+        plan->twiddleQ15[2 * k + 1] = (int16_t)lround(sin(angle) * 32767.0);
+    }
+
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t r = 0;
+        for (uint8_t bit = 0; bit < plan->log2n; bit++) {
+            if (i & (1u << bit)) r |= (uint16_t)(1u << (plan->log2n - 1 - bit));
+        }
+        plan->bitReverse[i] = r;
+    }
+
+#if DSP_USE_ESP_DSP
+    espDspInit();
+#endif
+    return true;
+}
+
+// ==================== 标量参考实现 ====================
+
+/**
+ * @brief 参考实现：逐项按定义计算，频带能量用直接DFT
+ */
+void dspFeaturesRef(const DspPlan* plan, const float* x, DspFeatures* out) {
+    const uint16_t n = plan->n;
+    double sum = 0.0;
+    for (uint16_t i = 0; i < n; i++) sum += x[i];
+    double mean = sum / n;
+
+    double sumSq = 0.0;
+    double sumIx = 0.0;
+    double mid = (n - 1) * 0.5;
+    uint16_t crossings = 0;
+    double prev = 0.0;
+    for (uint16_t i = 0; i < n; i++) {
+        double d = x[i] - mean;
+        sumSq += d * d;
+        sumIx += (i - mid) * d;
+        if (i > 0 && ((d >= 0.0) != (prev >= 0.0))) crossings++;
+        prev = d;
+    }
+
+    memset(out, 0, sizeof(DspFeatures));
+    out->mean = (float)mean;
+    out->variance = (float)(sumSq / n);
+    out->slope = (float)(sumIx / ((double)n * ((double)n * n - 1.0) / 12.0) * plan->sampleRateHz);
+    out->zcr = (float)crossings / (float)(n - 1);
+
+    double sumW2 = 0.0;
+    for (uint16_t i = 0; i < n; i++) {
+        double w = 0.5 - 0.5 * cos(2.0 * M_PI * i / n);
+        sumW2 += w * w;
+    }
+    for (uint8_t b = 0; b < plan->bandCount; b++) {
+        double energy = 0.0;
+        for (uint16_t k = plan->bandLo[b]; k < plan->bandHi[b]; k++) {
+            double re = 0.0;
+            double im = 0.0;
+            for (uint16_t i = 0; i < n; i++) {
+                double v = (x[i] - mean) * (0.5 - 0.5 * cos(2.0 * M_PI * i / n));
+                double angle = -2.0 * M_PI * (double)k * i / n;
+                re += v * cos(angle);
+                im += v * sin(angle);
+            }
+            energy += (k == n / 2 ? 1.0 : 2.0) * (re * re + im * im);
+        }
+        out->bandEnergy[b] = (float)(energy / ((double)n * sumW2));
+    }
+}
+
+// ==================== 浮点实现 ====================
+
+static void fftF32(DspPlan* plan) {
+    const uint16_t n = plan->n;
+    float* a = plan->workF32;
+#if DSP_USE_ESP_DSP
+    if (espDspReady) {
+        dsps_fft2r_fc32(a, n);
+        dsps_bit_rev_fc32(a, n);
+        return;
+    }
+#endif
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t j = plan->bitReverse[i];
+        if (j > i) {
+            float re = a[2 * i], im = a[2 * i + 1];
+            a[2 * i] = a[2 * j];
+            a[2 * i + 1] = a[2 * j + 1];
+            a[2 * j] = re;
+            a[2 * j + 1] = im;
+        }
+    }
+    const float* tw = plan->twiddleF32;
+    for (uint16_t half = 1, step = n / 2; half < n; half <<= 1, step >>= 1) {
+        for (uint16_t start = 0; start < n; start += half * 2) {
+            for (uint16_t j = 0; j < half; j++) {
+                float wr = tw[2 * j * step];
+                float wi = tw[2 * j * step + 1];
+                uint16_t p = 2 * (start + j);
+                uint16_t q = p + 2 * half;
+                float tr = wr * a[q] - wi * a[q + 1];
+                float ti = wr * a[q + 1] + wi * a[q];
+                a[q] = a[p] - tr;
+                a[q + 1] = a[p + 1] - ti;
+                a[p] += tr;
+                a[p + 1] += ti;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 浮点实现
+ *
+ * 第一遍求均值；第二遍对去均值后的值求平方和、与中心化下标的乘积和、过零次数，
+ * 同时写入加窗后的FFT输入。两遍都按4路独立累加展开，便于流水线/向量化
+ */
+void dspFeaturesF32(DspPlan* plan, const float* x, DspFeatures* out) {
+    const uint16_t n = plan->n;
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (uint16_t i = 0; i < n; i += 4) {
+        s0 += x[i];
+        s1 += x[i + 1];
+        s2 += x[i + 2];
+        s3 += x[i + 3];
+    }
+    float mean = (s0 + s1 + s2 + s3) / n;
+
+    float q0 = 0.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;
+    float p0 = 0.0f, p1 = 0.0f, p2 = 0.0f, p3 = 0.0f;
+    float index = -(n - 1) * 0.5f;
+    uint32_t crossings = 0;
+    bool prevPositive = (x[0] - mean) >= 0.0f;
+    const float* w = plan->windowF32;
+    float* work = plan->workF32;
+    for (uint16_t i = 0; i < n; i += 4) {
+        float d0 = x[i] - mean;
+        float d1 = x[i + 1] - mean;
+        float d2 = x[i + 2] - mean;
+        float d3 = x[i + 3] - mean;
+        q0 += d0 * d0;
+        q1 += d1 * d1;
+        q2 += d2 * d2;
+        q3 += d3 * d3;
+        p0 += index * d0;
+        p1 += (index + 1.0f) * d1;
+        p2 += (index + 2.0f) * d2;
+        p3 += (index + 3.0f) * d3;
+        index += 4.0f;
+        bool b0 = d0 >= 0.0f, b1 = d1 >= 0.0f, b2 = d2 >= 0.0f, b3 = d3 >= 0.0f;
+        crossings += (uint32_t)(b0 != prevPositive) + (uint32_t)(b1 != b0) +
+                     (uint32_t)(b2 != b1) + (uint32_t)(b3 != b2);
+        prevPositive = b3;
+        work[2 * i] = d0 * w[i];
+        work[2 * i + 1] = 0.0f;
+        work[2 * i + 2] = d1 * w[i + 1];
+        work[2 * i + 3] = 0.0f;
+        work[2 * i + 4] = d2 * w[i + 2];
+        work[2 * i + 5] = 0.0f;
+        work[2 * i + 6] = d3 * w[i + 3];
+        work[2 * i + 7] = 0.0f;
+    }
+
+    out->mean = mean;
+    out->variance = (q0 + q1 + q2 + q3) / n;
+    out->slope = (p0 + p1 + p2 + p3) / plan->indexVariance * plan->sampleRateHz;
+    out->zcr = (float)crossings / (float)(n - 1);
+
+    fftF32(plan);
+    float norm = 1.0f / ((float)n * n * plan->windowPower);
+    for (uint8_t b = 0; b < DSP_MAX_BANDS; b++) {
+        float energy = 0.0f;
+        if (b < plan->bandCount) {
+            for (uint16_t k = plan->bandLo[b]; k < plan->bandHi[b]; k++) {
+                float re = work[2 * k];
+                float im = work[2 * k + 1];
+                energy += (k == n / 2 ? 1.0f : 2.0f) * (re * re + im * im);
+            }
+        }
+        out->bandEnergy[b] = energy * norm;
+    }
+}
+
+// ==================== 定点实现 ====================
+
+static void fftQ15(DspPlan* plan) {
+    const uint16_t n = plan->n;
+    int16_t* a = plan->workQ15;
+#if DSP_USE_ESP_DSP
+    if (espDspReady) {
+        // 与可移植实现相同：每级右移1位
+        dsps_fft2r_sc16(a, n);
+        dsps_bit_rev_sc16_ansi(a, n);
+        return;
+    }
+#endif
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t j = plan->bitReverse[i];
+        if (j > i) {
+            int16_t re = a[2 * i], im = a[2 * i + 1];
+            a[2 * i] = a[2 * j];
+            a[2 * i + 1] = a[2 * j + 1];
+            a[2 * j] = re;
+            a[2 * j + 1] = im;
+        }
+    }
+    const int16_t* tw = plan->twiddleQ15;
+    for (uint16_t half = 1, step = n / 2; half < n; half <<= 1, step >>= 1) {
+        for (uint16_t start = 0; start < n; start += half * 2) {
+            for (uint16_t j = 0; j < half; j++) {
+                int32_t wr = tw[2 * j * step];
+                int32_t wi = tw[2 * j * step + 1];
+                uint16_t p = 2 * (start + j);
+                uint16_t q = p + 2 * half;
+                int32_t tr = (wr * a[q] - wi * a[q + 1] + (1 << 14)) >> 15;
+                int32_t ti = (wr * a[q + 1] + wi * a[q] + (1 << 14)) >> 15;
+                int32_t ar = a[p];
+                int32_t ai = a[p + 1];
+                a[p] = (int16_t)((ar + tr) >> 1);
+                a[p + 1] = (int16_t)((ai + ti) >> 1);
+                a[q] = (int16_t)((ar - tr) >> 1);
+                a[q + 1] = (int16_t)((ai - ti) >> 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 定点实现
+ *
+ * 第一遍累加和、平方和、与 (2i-N+1) 的乘积和以及极值，均为精确整数；
+ * 第二遍用 N·x - Σx (N倍的精确去均值值) 判断过零，并按极值归一化到14位后加窗写入FFT输入。
+ * FFT输出为 (去均值加窗序列的DFT) × 2^shift，频带能量据此还原
+ */
+void dspFeaturesQ15(DspPlan* plan, const int16_t* x, DspFeatures* out) {
+    const int32_t n = plan->n;
+    int32_t sum = 0;
+    int64_t sumSq = 0;
+    int64_t sumIx = 0;
+    int16_t minValue = x[0];
+    int16_t maxValue = x[0];
+    for (int32_t i = 0; i < n; i++) {
+        int32_t v = x[i];
+        sum += v;
+        sumSq += v * v;
+        sumIx += (int64_t)(2 * i - n + 1) * v;
+        if (x[i] < minValue) minValue = x[i];
+        if (x[i] > maxValue) maxValue = x[i];
+    }
+
+    const float scale = plan->scale;
+    out->mean = (float)sum / n * scale;
+    out->variance = (float)((int64_t)n * sumSq - (int64_t)sum * sum) / ((float)n * n) * scale * scale;
+    out->slope = (float)sumIx * 0.5f / plan->indexVariance * scale * plan->sampleRateHz;
+
+    // 块浮点：N倍去均值值的最大幅度归一化到14位，蝶形运算不会溢出
+    int32_t maxAbs = maxValue * n - sum;
+    if (sum - minValue * n > maxAbs) maxAbs = sum - minValue * n;
+    int shift = 0;
+    if (maxAbs > 0) {
+        int bits = 32 - __builtin_clz((uint32_t)maxAbs);
+        shift = 14 - bits;
+    }
+
+    uint32_t crossings = 0;
+    bool prevPositive = (x[0] * n - sum) >= 0;
+    const int16_t* w = plan->windowQ15;
+    int16_t* work = plan->workQ15;
+    for (int32_t i = 0; i < n; i++) {
+        int32_t c = x[i] * n - sum;
+        bool positive = c >= 0;
+        crossings += (uint32_t)(positive != prevPositive);
+        prevPositive = positive;
+        int32_t y = shift >= 0 ? c * (1 << shift) : (c + (1 << (-shift - 1))) >> -shift;
+        work[2 * i] = (int16_t)((y * w[i] + (1 << 14)) >> 15);
+        work[2 * i + 1] = 0;
+    }
+    out->zcr = (float)crossings / (float)(n - 1);
+
+    if (maxAbs == 0) {
+        memset(out->bandEnergy, 0, sizeof(out->bandEnergy));
+        return;
+    }
+    fftQ15(plan);
+    float norm = ldexpf(1.0f, -2 * shift) * scale * scale / ((float)n * n * plan->windowPower);
+    for (uint8_t b = 0; b < DSP_MAX_BANDS; b++) {
+        int64_t energy = 0;
+        if (b < plan->bandCount) {
+            for (uint16_t k = plan->bandLo[b]; k < plan->bandHi[b]; k++) {
+                int32_t re = work[2 * k];
+                int32_t im = work[2 * k + 1];
+                int64_t power = (int64_t)re * re + (int64_t)im * im;
+                energy += k == n / 2 ? power : power * 2;
+            }
+        }
+        out->bandEnergy[b] = (float)energy * norm;
+    }
+}
+
+const char* dspBackendString() {
+#if DSP_USE_ESP_DSP
+    if (espDspReady) return "esp-dsp";
+#endif
+    return "portable";
+}
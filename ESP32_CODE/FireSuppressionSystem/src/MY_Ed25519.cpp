@@ -0,0 +1,385 @@
+#include "MY_Ed25519.h"
+#include "MY_Sha512.h"
+#include <string.h>
+
+// ==================== 域元素 ====================
+// GF(2^255-19) 元素：16个limb，每个16位 (运算中间值可超出，由 carry 归一)
+
+typedef int64_t Fe[16];
+
+static const Fe FE_ZERO = {0};
+static const Fe FE_ONE = {1};
+// 曲线参数 d = -121665/121666
+static const Fe FE_D = {
+    0x78a3, 0x1359, 0x4dca, 0x75eb, 0xd8ab, 0x4141, 0x0a4d, 0x0070,
+    0xe898, 0x7779, 0x4079, 0x8cc7, 0xfe73, 0x2b6f, 0x6cee, 0x5203
+};
+static const Fe FE_D2 = {
+    0xf159, 0x26b2, 0x9b94, 0xebd6, 0xb156, 0x8283, 0x149a, 0x00e0,
+    0xd130, 0xeef3, 0x80f2, 0x198e, 0xfce7, 0x56df, 0xd9dc, 0x2406
+};
+// 基点坐标
+static const Fe FE_BX = {
+    0xd51a, 0x8f25, 0x2d60, 0xc956, 0xa7b2, 0x9525, 0xc760, 0x692c,
+    0xdc5c, 0xfdd6, 0xe231, 0xc0a4, 0x53fe, 0xcd6e, 0x36d3, 0x2169
+};
+static const Fe FE_BY = {
+    0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666,
+    0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666
+};
+// sqrt(-1)
+static const Fe FE_SQRTM1 = {
+    0xa0b0, 0x4a0e, 0x1b27, 0xc4ee, 0xe478, 0xad2f, 0x1806, 0x2f43,
+    0xd7a7, 0x3dfb, 0x0099, 0x2b4d, 0xdf0b, 0x4fc1, 0x2480, 0x2b83
+};
+
+// 群阶 L = 2^252 + 27742317777372353535851937790883648493 (小端)
+static const uint8_t GROUP_ORDER[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10
+};
+
+static void feCopy(Fe out, const Fe a) {
+    memcpy(out, a, sizeof(Fe));
+}
+
+static void feCarry(Fe o) {
+    for (int i = 0; i < 16; i++) {
+        o[i] += (int64_t)1 << 16;
+        int64_t c = o[i] >> 16;
+        // 最高limb的进位按 2^256 = 38 (mod p) 折回最低limb
+        o[(i + 1) * (i < 15)] += c - 1 + 37 * (c - 1) * (i == 15);
+        o[i] -= c << 16;
+    }
+}
+
+// b=1 时交换 p/q，按位掩码实现，不产生分支
+static void feSwap(Fe p, Fe q, int b) {
+    int64_t mask = ~(int64_t)(b - 1);
+    for (int i = 0; i < 16; i++) {
+        int64_t t = mask & (p[i] ^ q[i]);
+        p[i] ^= t;
+        q[i] ^= t;
+    }
+}
+
+// 归一到 [0, p) 后按小端输出32字节
+static void fePack(uint8_t out[32], const Fe n) {
+    Fe t;
+    Fe m;
+    feCopy(t, n);
+    feCarry(t);
+    feCarry(t);
+    feCarry(t);
+    for (int j = 0; j < 2; j++) {
+        m[0] = t[0] - 0xffed;
+        for (int i = 1; i < 15; i++) {
+            m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+            m[i - 1] &= 0xffff;
+        }
+        m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+        int b = (int)((m[15] >> 16) & 1);
+        m[14] &= 0xffff;
+        feSwap(t, m, 1 - b);
+    }
+    for (int i = 0; i < 16; i++) {
+        out[2 * i] = (uint8_t)(t[i] & 0xff);
+        out[2 * i + 1] = (uint8_t)(t[i] >> 8);
+    }
+}
+
+static void feUnpack(Fe o, const uint8_t in[32]) {
+    for (int i = 0; i < 16; i++) {
+        o[i] = in[2 * i] + ((int64_t)in[2 * i + 1] << 8);
+    }
+    o[15] &= 0x7fff;
+}
+
+static bool feEqual(const Fe a, const Fe b) {
+    uint8_t pa[32];
+    uint8_t pb[32];
+    fePack(pa, a);
+    fePack(pb, b);
+    return memcmp(pa, pb, 32) == 0;
+}
+
+static int feParity(const Fe a) {
+    uint8_t d[32];
+    fePack(d, a);
+    return d[0] & 1;
+}
+
+static void feAdd(Fe o, const Fe a, const Fe b) {
+    for (int i = 0; i < 16; i++) o[i] = a[i] + b[i];
+}
+
+static void feSub(Fe o, const Fe a, const Fe b) {
+    for (int i = 0; i < 16; i++) o[i] = a[i] - b[i];
+}
+
+static void feMul(Fe o, const Fe a, const Fe b) {
+    int64_t t[31] = {0};
+    for (int i = 0; i < 16; i++) {
+        for (int j = 0; j < 16; j++) {
+            t[i + j] += a[i] * b[j];
+        }
+    }
+    // 2^256 = 38 (mod p)
+    for (int i = 0; i < 15; i++) {
+        t[i] += 38 * t[i + 16];
+    }
+    for (int i = 0; i < 16; i++) o[i] = t[i];
+    feCarry(o);
+    feCarry(o);
+}
+
+static void feSquare(Fe o, const Fe a) {
+    feMul(o, a, a);
+}
+
+// a^(p-2)
+static void feInvert(Fe o, const Fe in) {
+    Fe c;
+    feCopy(c, in);
+    for (int a = 253; a >= 0; a--) {
+        feSquare(c, c);
+        if (a != 2 && a != 4) feMul(c, c, in);
+    }
+    feCopy(o, c);
+}
+
+// a^((p-5)/8)，用于开平方
+static void fePow2523(Fe o, const Fe in) {
+    Fe c;
+    feCopy(c, in);
+    for (int a = 250; a >= 0; a--) {
+        feSquare(c, c);
+        if (a != 1) feMul(c, c, in);
+    }
+    feCopy(o, c);
+}
+
+// ==================== 曲线点 ====================
+// 扩展坐标 (X:Y:Z:T)，x = X/Z，y = Y/Z，xy = T/Z
+
+typedef Fe Point[4];
+
+static void pointAdd(Point p, const Point q) {
+    Fe a, b, c, d, t, e, f, g, h;
+    feSub(a, p[1], p[0]);
+    feSub(t, q[1], q[0]);
+    feMul(a, a, t);
+    feAdd(b, p[0], p[1]);
+    feAdd(t, q[0], q[1]);
+    feMul(b, b, t);
+    feMul(c, p[3], q[3]);
+    feMul(c, c, FE_D2);
+    feMul(d, p[2], q[2]);
+    feAdd(d, d, d);
+    feSub(e, b, a);
+    feSub(f, d, c);
+    feAdd(g, d, c);
+    feAdd(h, b, a);
+
+    feMul(p[0], e, f);
+    feMul(p[1], h, g);
+    feMul(p[2], g, f);
+    feMul(p[3], e, h);
+}
+
+static void pointSwap(Point p, Point q, int b) {
+    for (int i = 0; i < 4; i++) feSwap(p[i], q[i], b);
+}
+
+static void pointPack(uint8_t out[32], const Point p) {
+    Fe zi, tx, ty;
+    feInvert(zi, p[2]);
+    feMul(tx, p[0], zi);
+    feMul(ty, p[1], zi);
+    fePack(out, ty);
+    out[31] ^= (uint8_t)(feParity(tx) << 7);
+}
+
+// p = s * q (蒙哥马利阶梯，逐位条件交换)；q 被改写
+static void pointScalarMult(Point p, Point q, const uint8_t s[32]) {
+    feCopy(p[0], FE_ZERO);
+    feCopy(p[1], FE_ONE);
+    feCopy(p[2], FE_ONE);
+    feCopy(p[3], FE_ZERO);
+    for (int i = 255; i >= 0; i--) {
+        int b = (s[i / 8] >> (i & 7)) & 1;
+        pointSwap(p, q, b);
+        pointAdd(q, p);
+        pointAdd(p, p);
+        pointSwap(p, q, b);
+    }
+}
+
+static void pointScalarBase(Point p, const uint8_t s[32]) {
+    Point q;
+    feCopy(q[0], FE_BX);
+    feCopy(q[1], FE_BY);
+    feCopy(q[2], FE_ONE);
+    feMul(q[3], FE_BX, FE_BY);
+    pointScalarMult(p, q, s);
+}
+
+/**
+ * @brief 解码公钥并取负 (校验时计算 S*B - h*A)
+ * @return false=不是曲线上的点
+ */
+static bool pointUnpackNeg(Point r, const uint8_t in[32]) {
+    Fe t, chk, num, den, den2, den4, den6;
+    feCopy(r[2], FE_ONE);
+    feUnpack(r[1], in);
+    feSquare(num, r[1]);
+    feMul(den, num, FE_D);
+    feSub(num, num, r[2]);
+    feAdd(den, r[2], den);
+
+    // x = sqrt(num/den)，先按 (num*den^7)^((p-5)/8) 计算候选值
+    feSquare(den2, den);
+    feSquare(den4, den2);
+    feMul(den6, den4, den2);
+    feMul(t, den6, num);
+    feMul(t, t, den);
+    fePow2523(t, t);
+    feMul(t, t, num);
+    feMul(t, t, den);
+    feMul(t, t, den);
+    feMul(r[0], t, den);
+
+    feSquare(chk, r[0]);
+    feMul(chk, chk, den);
+    if (!feEqual(chk, num)) feMul(r[0], r[0], FE_SQRTM1);
+    feSquare(chk, r[0]);
+    feMul(chk, chk, den);
+    if (!feEqual(chk, num)) return false;
+
+    if (feParity(r[0]) == (in[31] >> 7)) feSub(r[0], FE_ZERO, r[0]);
+    feMul(r[3], r[0], r[1]);
+    return true;
+}
+
+// ==================== 标量 (模群阶) ====================
+
+static void scalarModOrder(uint8_t r[32], int64_t x[64]) {
+    int64_t carry;
+    for (int i = 63; i >= 32; i--) {
+        carry = 0;
+        int j;
+        for (j = i - 32; j < i - 12; j++) {
+            x[j] += carry - 16 * x[i] * GROUP_ORDER[j - (i - 32)];
+            carry = (x[j] + 128) >> 8;
+            x[j] -= carry * 256;
+        }
+        x[j] += carry;
+        x[i] = 0;
+    }
+    carry = 0;
+    for (int j = 0; j < 32; j++) {
+        x[j] += carry - (x[31] >> 4) * GROUP_ORDER[j];
+        carry = x[j] >> 8;
+        x[j] &= 255;
+    }
+    for (int j = 0; j < 32; j++) x[j] -= carry * GROUP_ORDER[j];
+    for (int i = 0; i < 32; i++) {
+        x[i + 1] += x[i] >> 8;
+        r[i] = (uint8_t)(x[i] & 255);
+    }
+}
+
+// 64字节哈希值模群阶，结果写回前32字节
+static void scalarReduce(uint8_t r[64]) {
+    int64_t x[64];
+    for (int i = 0; i < 64; i++) x[i] = (uint64_t)r[i];
+    memset(r, 0, 64);
+    scalarModOrder(r, x);
+}
+
+// S < L (RFC 8032 5.1.7，拒绝可延展的签名)
+static bool scalarCanonical(const uint8_t s[32]) {
+    for (int i = 31; i >= 0; i--) {
+        if (s[i] < GROUP_ORDER[i]) return true;
+        if (s[i] > GROUP_ORDER[i]) return false;
+    }
+    return false;
+}
+
+// SHA-512(a || b || c)，不需要的段传 NULL
+static void hashParts(uint8_t out[SHA512_DIGEST_SIZE], const uint8_t* a, size_t aLen, const uint8_t* b,
+                      size_t bLen, const uint8_t* c, size_t cLen) {
+    Sha512Context sha;
+    sha512Init(&sha);
+    if (a != NULL) sha512Update(&sha, a, aLen);
+    if (b != NULL) sha512Update(&sha, b, bLen);
+    if (c != NULL) sha512Update(&sha, c, cLen);
+    sha512Final(&sha, out);
+}
+
+// 种子 -> 截断的私有标量 (前32字节) 与签名前缀 (后32字节)
+static void expandSeed(const uint8_t seed[ED25519_SEED_SIZE], uint8_t expanded[SHA512_DIGEST_SIZE]) {
+    hashParts(expanded, seed, ED25519_SEED_SIZE, NULL, 0, NULL, 0);
+    expanded[0] &= 248;
+    expanded[31] &= 127;
+    expanded[31] |= 64;
+}
+
+// ==================== 公共接口 ====================
+
+bool ed25519Verify(const uint8_t signature[ED25519_SIGNATURE_SIZE], const uint8_t* message, size_t len,
+                   const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE]) {
+    if (!scalarCanonical(signature + 32)) return false;
+
+    Point p, q;
+    if (!pointUnpackNeg(q, publicKey)) return false;
+
+    // R == S*B - h*A，h = SHA-512(R || A || M) mod L
+    uint8_t h[SHA512_DIGEST_SIZE];
+    hashParts(h, signature, 32, publicKey, ED25519_PUBLIC_KEY_SIZE, message, len);
+    scalarReduce(h);
+    pointScalarMult(p, q, h);
+    pointScalarBase(q, signature + 32);
+    pointAdd(p, q);
+
+    uint8_t check[32];
+    pointPack(check, p);
+    return memcmp(check, signature, 32) == 0;
+}
+
+void ed25519PublicKey(const uint8_t seed[ED25519_SEED_SIZE], uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE]) {
+    uint8_t expanded[SHA512_DIGEST_SIZE];
+    expandSeed(seed, expanded);
+    Point p;
+    pointScalarBase(p, expanded);
+    pointPack(publicKey, p);
+}
+
+void ed25519Sign(const uint8_t seed[ED25519_SEED_SIZE], const uint8_t* message, size_t len,
+                 uint8_t signature[ED25519_SIGNATURE_SIZE]) {
+    uint8_t expanded[SHA512_DIGEST_SIZE];
+    uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE];
+    expandSeed(seed, expanded);
+    ed25519PublicKey(seed, publicKey);
+
+    // r = SHA-512(前缀 || M) mod L，R = r*B
+    uint8_t r[SHA512_DIGEST_SIZE];
+    hashParts(r, expanded + 32, 32, message, len, NULL, 0);
+    scalarReduce(r);
+    Point p;
+    pointScalarBase(p, r);
+    pointPack(signature, p);
+
+    // S = r + h*a mod L
+    uint8_t h[SHA512_DIGEST_SIZE];
+    hashParts(h, signature, 32, publicKey, ED25519_PUBLIC_KEY_SIZE, message, len);
+    scalarReduce(h);
+    int64_t x[64] = {0};
+    for (int i = 0; i < 32; i++) x[i] = (uint64_t)r[i];
+    for (int i = 0; i < 32; i++) {
+        for (int j = 0; j < 32; j++) {
+            x[i + j] += h[i] * (int64_t)expanded[j];
+        }
+    }
+    scalarModOrder(signature + 32, x);
+}
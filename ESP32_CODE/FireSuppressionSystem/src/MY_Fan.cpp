@@ -3,6 +3,14 @@
 #include "MY_MQ2.h"
 #include "MY_Sensor.h"
 #include "MY_K230.h"
+#include "MY_Fusion.h"
+#include "MY_MQTT.h"
+#include "MY_Boot.h"
+#include "MY_Config.h"
+#include "MY_Actuator.h"
+#include "MY_Power.h"
+#include "MY_Supervisor.h"
+#include "MY_Memory.h"
 
 // ==================== 全局变量定义 ====================
 FanControl fanControl = {
@@ -13,12 +21,136 @@ FanControl fanControl = {
     .lastTemp = 0.0f,
     .lastHumidity = 0.0f,
     .lastSmokeLevel = 0.0f,
-    .lastSmokeAlarm = false
+    .lastSmokeAlarm = false,
+    .targetSpeed = 0,
+    .speed = 0,
+    .purging = false
 };
 
 TaskHandle_t fanTaskHandle = NULL;
 SemaphoreHandle_t fanMutex = NULL;
 
+#if !FAN_PWM_ENABLE
+// 继电器输出 (高电平闭合，断开后至少保持 FAN_RELAY_MIN_OFF_MS)
+static Actuator<FAN_RELAY_PIN, HIGH, CooldownPolicy<FAN_RELAY_MIN_OFF_MS> > fanRelay;
+#endif
+
+// 内部变量：烟雾闭环控制 (由fanMutex保护)
+static float smokeFiltered = 0.0f;      // 滤波后的烟雾浓度
+static float smokeTrend = 0.0f;         // 烟雾浓度变化率 (%/s)
+static float piIntegral = 0.0f;         // PI积分项
+static unsigned long lastControlTime = 0;
+static bool filterPrimed = false;
+
+// 内部变量：报警事件与延时排烟
+static unsigned long eventStartTime = 0;
+static unsigned long purgeStartTime = 0;
+static unsigned long lastOutputTime = 0;
+
+// ==================== 内部函数 (调用方需持有fanMutex) ====================
+
+/**
+ * @brief 输出转速到硬件
+ * PWM模式写LEDC占空比，继电器模式下任意非零转速即闭合继电器 (受最短关闭时间限制)
+ */
+static void writeFanOutput(uint8_t percent) {
+#if FAN_PWM_ENABLE
+    uint32_t maxDuty = (1UL << FAN_PWM_RESOLUTION) - 1;
+    ledcWrite(FAN_PWM_CHANNEL, maxDuty * percent / 100);
+#else
+    // 冷却中被拒绝时转速记为0，stepFanOutput() 下个周期重试
+    percent = fanRelay.set(percent > 0) && percent > 0 ? 100 : 0;
+#endif
+    fanControl.speed = percent;
+}
+
+/**
+ * @brief 按软启动斜率把实际转速推向目标转速
+ * 从静止启动时直接跳到最低可靠转速，避免风扇堵转；降速立即生效
+ */
+static void stepFanOutput() {
+    unsigned long now = millis();
+    unsigned long elapsed = now - lastOutputTime;
+    lastOutputTime = now;
+
+    uint8_t target = fanControl.targetSpeed;
+    uint8_t current = fanControl.speed;
+    if (target == current) return;
+
+#if FAN_PWM_ENABLE
+    if (target > current) {
+        uint32_t step = (uint32_t)FAN_SOFT_START_PERCENT_PER_S * elapsed / 1000;
+        if (step == 0) step = 1;
+        uint32_t next = current + step;
+        if (current == 0 && next < FAN_PWM_MIN_PERCENT) next = FAN_PWM_MIN_PERCENT;
+        if (next > target) next = target;
+        writeFanOutput((uint8_t)next);
+        return;
+    }
+#endif
+    writeFanOutput(target);
+}
+
+/**
+ * @brief 更新烟雾滤波值与变化趋势
+ * 按实际时间间隔计算滤波系数，与调用频率无关
+ */
+static void updateSmokeFilter(float smokeLevel, float dtSec) {
+    if (!filterPrimed) {
+        smokeFiltered = smokeLevel;
+        smokeTrend = 0.0f;
+        filterPrimed = true;
+        return;
+    }
+    if (dtSec <= 0.0f) return;
+
+    float tau = FAN_SMOKE_FILTER_TAU_MS / 1000.0f;
+    float alpha = dtSec / (tau + dtSec);
+    float previous = smokeFiltered;
+    smokeFiltered += alpha * (smokeLevel - smokeFiltered);
+    float slope = (smokeFiltered - previous) / dtSec;
+    smokeTrend += alpha * (slope - smokeTrend);
+}
+
+/**
+ * @brief PI + 趋势前馈计算排烟转速
+ * 输出饱和时停止同向积分 (抗积分饱和)
+ */
+static uint8_t computeExtractionSpeed(float smokeSafe, float dtSec) {
+    float error = smokeFiltered - smokeSafe;
+    float trend = smokeTrend > 0.0f ? smokeTrend : 0.0f;   // 只对上升趋势提前加速
+    float output = FAN_PI_KP * error + piIntegral + FAN_TREND_GAIN * trend;
+
+    bool saturatedHigh = output >= 100.0f && error > 0.0f;
+    bool saturatedLow = output <= FAN_PWM_MIN_PERCENT && error < 0.0f;
+    if (!saturatedHigh && !saturatedLow) {
+        piIntegral += FAN_PI_KI * error * dtSec;
+        if (piIntegral > 100.0f) piIntegral = 100.0f;
+        if (piIntegral < 0.0f) piIntegral = 0.0f;
+    }
+
+    if (output > 100.0f) output = 100.0f;
+    if (output < FAN_PWM_MIN_PERCENT) output = FAN_PWM_MIN_PERCENT;
+    return (uint8_t)(output + 0.5f);
+}
+
+static void setFanTarget(uint8_t percent) {
+    fanControl.targetSpeed = percent;
+    FanState state = percent > 0 ? FAN_ON : FAN_OFF;
+    if (fanControl.state != state) {
+        fanControl.state = state;
+        fanControl.lastChange = millis();
+        powerSetHold(POWER_HOLD_FAN, state == FAN_ON);
+    }
+    // 降速/停机立即输出，升速由 stepFanOutput() 按斜率推进
+    if (percent < fanControl.speed || FAN_PWM_ENABLE == 0) {
+        writeFanOutput(percent);
+    } else if (fanControl.speed == 0) {
+        lastOutputTime = millis();
+        stepFanOutput();
+    }
+}
+
 // ==================== 初始化函数 ====================
 
 /**
@@ -26,11 +158,16 @@ SemaphoreHandle_t fanMutex = NULL;
  */
 void setupFan() {
     // 创建互斥锁
-    fanMutex = xSemaphoreCreateMutex();
+    fanMutex = CREATE_MODULE_MUTEX();
     
     // 配置GPIO
-    pinMode(FAN_RELAY_PIN, OUTPUT);
-    digitalWrite(FAN_RELAY_PIN, LOW);  // 初始关闭 (高电平断开继电器)
+#if FAN_PWM_ENABLE
+    ledcSetup(FAN_PWM_CHANNEL, FAN_PWM_FREQ_HZ, FAN_PWM_RESOLUTION);
+    ledcAttachPin(FAN_RELAY_PIN, FAN_PWM_CHANNEL);
+    ledcWrite(FAN_PWM_CHANNEL, 0);     // 初始关闭
+#else
+    fanRelay.begin();                  // 初始关闭
+#endif
     
     fanControl.state = FAN_OFF;
     fanControl.mode = FAN_MODE_AUTO;
@@ -40,24 +177,27 @@ void setupFan() {
     Serial.println("[FAN] ========== Fan Module Init ==========");
     Serial.println("[FAN] GPIO: " + String(FAN_RELAY_PIN));
     Serial.println("[FAN] Mode: AUTO (default)");
-    Serial.println("[FAN] Temp Alarm Threshold: " + String(TEMP_ALARM_THRESHOLD) + "°C");
-    Serial.println("[FAN] Smoke Alarm Threshold: " + String(SMOKE_ALARM_THRESHOLD) + "%");
+    Serial.println("[FAN] Output: " + String(FAN_PWM_ENABLE ? "PWM (PI smoke control)" : "Relay"));
+    Serial.println("[FAN] Temp Alarm Threshold: " + String(getConfig()->tempAlarmThreshold) + "°C");
+    Serial.println("[FAN] Smoke Alarm Threshold: " + String(getConfig()->smokeAlarmThreshold) + "%");
     Serial.println("[FAN] ======================================");
 }
 
 // ==================== 风扇控制函数 ====================
 
 /**
- * @brief 开启风扇
+ * @brief 开启风扇（全速，PWM模式下软启动）
  * 低电平触发继电器，NO口闭合，风扇转动
  */
 void fanOn() {
     if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
-        if (fanControl.state != FAN_ON) {
-            digitalWrite(FAN_RELAY_PIN, HIGH);
-            fanControl.state = FAN_ON;
-            fanControl.lastChange = millis();
-            Serial.println("[FAN] >>> FAN TURNED ON <<<");
+        fanControl.purging = false;
+        if (fanControl.state != FAN_ON || fanControl.targetSpeed != 100) {
+            bool wasOff = (fanControl.state != FAN_ON);
+            setFanTarget(100);
+            if (wasOff) {
+                Serial.println("[FAN] >>> FAN TURNED ON <<<");
+            }
         }
         xSemaphoreGive(fanMutex);
     }
@@ -69,17 +209,50 @@ void fanOn() {
  */
 void fanOff() {
     if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
+        fanControl.purging = false;
+        piIntegral = 0.0f;
         if (fanControl.state != FAN_OFF) {
-            digitalWrite(FAN_RELAY_PIN, LOW);
-            fanControl.state = FAN_OFF;
+            setFanTarget(0);
             fanControl.alarmReason = ALARM_NONE;
-            fanControl.lastChange = millis();
             Serial.println("[FAN] Fan turned OFF");
         }
         xSemaphoreGive(fanMutex);
     }
 }
 
+/**
+ * @brief 强制停止风扇输出
+ * 不获取fanMutex：监控模块在受控重启前调用，此时持有互斥锁的任务可能已经卡死
+ */
+void fanForceOff() {
+#if FAN_PWM_ENABLE
+    ledcWrite(FAN_PWM_CHANNEL, 0);
+#else
+    fanRelay.set(false);
+#endif
+}
+
+/**
+ * @brief 进入延时排烟
+ * 火灾解除后以 FAN_PURGE_PERCENT 继续运行 K230_FAN_DURATION_MS，由 fanTask 到时停机
+ */
+void fanStartPurge() {
+    bool started = false;
+    if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
+        if (fanControl.state == FAN_ON && !fanControl.purging) {
+            fanControl.purging = true;
+            purgeStartTime = millis();
+            piIntegral = 0.0f;
+            setFanTarget(FAN_PWM_ENABLE ? FAN_PURGE_PERCENT : 100);
+            started = true;
+        }
+        xSemaphoreGive(fanMutex);
+    }
+    if (started) {
+        Serial.println("[FAN] Purge run-on for " + String(K230_FAN_DURATION_MS / 1000) + "s");
+    }
+}
+
 /**
  * @brief 切换风扇状态
  */
@@ -120,6 +293,24 @@ AlarmReason getAlarmReason() {
     return reason;
 }
 
+uint8_t getFanSpeed() {
+    uint8_t speed = 0;
+    if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
+        speed = fanControl.speed;
+        xSemaphoreGive(fanMutex);
+    }
+    return speed;
+}
+
+bool isFanPurging() {
+    bool purging = false;
+    if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
+        purging = fanControl.purging;
+        xSemaphoreGive(fanMutex);
+    }
+    return purging;
+}
+
 // ==================== 模式设置函数 ====================
 
 /**
@@ -130,6 +321,7 @@ void setFanMode(FanMode mode) {
     if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
         if (fanControl.mode != mode) {
             fanControl.mode = mode;
+            fanControl.purging = false;     // 延时排烟只属于自动模式
             Serial.println("[FAN] Mode changed to: " + String(mode == FAN_MODE_AUTO ? "AUTO" : "MANUAL"));
             
             // 切换到自动模式时，立即根据当前传感器数据判断
@@ -170,11 +362,16 @@ const char* getFanModeString() {
  * @brief 根据传感器数据自动控制风扇
  * 
  * 火灾判定逻辑：
- * - 温度 > 50°C  → 高温报警，开启风扇
- * - 烟雾浓度 > 30% 或 烟雾报警触发 → 烟雾报警，开启风扇
+ * - 融合评估达到报警等级 (FIRE_LEVEL_ALARM 及以上) → 开启风扇
+ * - 报警原因取证据强度达到 FUSION_SOURCE_ACTIVE 的来源（高温/烟雾）
+ * 
+ * 转速控制 (PWM模式)：
+ * - 高温或达到灭火等级 → 全速
+ * - 仅烟雾报警 → 按滤波后烟雾浓度与上升趋势PI调速，软启动
  * 
  * 安全恢复逻辑：
- * - 温度 < 40°C 且 烟雾浓度 < 15% 且 无烟雾报警 → 关闭风扇
+ * - 融合评估恢复安全 (FIRE_LEVEL_NONE) → 延时排烟后关闭风扇
+ * - 报警持续不足 FAN_PURGE_MIN_EVENT_MS 视为误报，直接关闭
  * 
  * @param temperature 当前温度 (摄氏度)
  * @param humidity 当前湿度 (百分比)
@@ -187,67 +384,79 @@ void updateFanAutoControl(float temperature, float humidity, float smokeLevel, b
         return;
     }
     
-    // 更新传感器数据缓存
-    if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
-        fanControl.lastTemp = temperature;
-        fanControl.lastHumidity = humidity;
-        fanControl.lastSmokeLevel = smokeLevel;
-        fanControl.lastSmokeAlarm = smokeAlarm;
-        xSemaphoreGive(fanMutex);
-    }
+    // 判断是否处于火灾环境（融合置信度，阈值取当前配置快照）
+    const SystemConfig* cfg = getConfig();
+    FireAssessment fire = fusionAssessment();
+    bool highTemp = (fire.evidence[FUSION_SRC_TEMP] >= FUSION_SOURCE_ACTIVE);
     
-    // 判断是否处于火灾环境
-    bool highTemp = (temperature > TEMP_ALARM_THRESHOLD);
-    bool smokeDetected = (smokeLevel > SMOKE_ALARM_THRESHOLD) || smokeAlarm;
+    bool flameSeen = (fire.evidence[FUSION_SRC_K230] >= FUSION_SOURCE_ACTIVE);
     
-    // 确定报警原因
+    // 确定报警原因（达到灭火等级或视觉检测到火焰时按全速处理）
     AlarmReason reason = ALARM_NONE;
-    if (highTemp && smokeDetected) {
+    if (fire.level == FIRE_LEVEL_SUPPRESS || flameSeen) {
         reason = ALARM_BOTH;
-    } else if (highTemp) {
-        reason = ALARM_HIGH_TEMP;
-    } else if (smokeDetected) {
-        reason = ALARM_SMOKE_DETECTED;
+    } else if (fire.level == FIRE_LEVEL_ALARM) {
+        reason = highTemp ? ALARM_HIGH_TEMP : ALARM_SMOKE_DETECTED;
     }
 
-    // K230火焰确认
-    int K230FireConfirmed = 0;
-    if(xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE){
-        K230FireConfirmed = k230Control.fireState;
-        xSemaphoreGive(k230Mutex);
-    }
+    bool fireStarted = false;
+    bool purgeNow = false;
+    bool stopNow = false;
+    unsigned long now = millis();
 
-    if(K230FireConfirmed == K230_FIRE_CONFIRMED){
-        reason = ALARM_BOTH; // K230确认火焰检测时强制触发风扇开启
-    }
+    if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
+        // 更新传感器数据缓存
+        fanControl.lastTemp = temperature;
+        fanControl.lastHumidity = humidity;
+        fanControl.lastSmokeLevel = smokeLevel;
+        fanControl.lastSmokeAlarm = smokeAlarm;
 
-    // 火灾检测：开启风扇
-    if (reason != ALARM_NONE) {
-        if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
+        float dtSec = (lastControlTime == 0) ? 0.0f : (now - lastControlTime) / 1000.0f;
+        lastControlTime = now;
+        updateSmokeFilter(smokeLevel, dtSec);
+
+        if (reason != ALARM_NONE) {
+            // 火灾检测：开启风扇（延时排烟期间再次报警则恢复闭环控制）
             fanControl.alarmReason = reason;
-            xSemaphoreGive(fanMutex);
-        }
-        
-        if (getFanState() != FAN_ON) {
-            Serial.println("[FAN] !!! FIRE DETECTED !!!");
-            Serial.println("[FAN] Reason: " + String(
-                reason == ALARM_BOTH ? "High Temp + Smoke" :
-                reason == ALARM_HIGH_TEMP ? "High Temperature" : "Smoke Detected"
-            )); 
-            Serial.println("[FAN] Temp: " + String(temperature) + "°C, Smoke: " + String(smokeLevel) + "%");
-            fanOn();
+            fanControl.purging = false;
+            if (fanControl.state != FAN_ON) {
+                fireStarted = true;
+                eventStartTime = now;
+            }
+            uint8_t speed = 100;
+            if (FAN_PWM_ENABLE && reason == ALARM_SMOKE_DETECTED) {
+                speed = computeExtractionSpeed(cfg->smokeSafeThreshold, dtSec);
+            }
+            setFanTarget(speed);
+        } else if (fanControl.state == FAN_ON && !fanControl.purging) {
+            // 安全恢复（报警等级带迟滞，置信度低于清除阈值才到这里）：
+            // 持续时间足够的报警延时排烟，短暂误报直接停机
+            if (now - eventStartTime >= FAN_PURGE_MIN_EVENT_MS) {
+                purgeNow = true;
+            } else {
+                stopNow = true;
+            }
         }
-        return;
+        xSemaphoreGive(fanMutex);
     }
-    
-    // 安全恢复：关闭风扇
-    bool tempSafe = (temperature < TEMP_SAFE_THRESHOLD);
-    bool smokeSafe = (smokeLevel < SMOKE_SAFE_THRESHOLD) && !smokeAlarm;
-    
-    if (tempSafe && smokeSafe && K230FireConfirmed != K230_FIRE_CONFIRMED) {
-        if (getFanState() == FAN_ON) {
-            Serial.println("[FAN] Environment safe, turning off fan");
-            Serial.println("[FAN] Temp: " + String(temperature) + "°C, Smoke: " + String(smokeLevel) + "%");
+
+    if (fireStarted) {
+        Serial.println("[FAN] !!! FIRE DETECTED !!!");
+        Serial.println("[FAN] Reason: " + String(
+            reason == ALARM_BOTH ? "High Temp + Smoke" :
+            reason == ALARM_HIGH_TEMP ? "High Temperature" : "Smoke Detected"
+        )); 
+        Serial.println("[FAN] Temp: " + String(temperature) + "°C, Smoke: " + String(smokeLevel) + "%, Score: " + String(fire.score, 2));
+        queueAlarmEvent("fan", "fire_detected");
+    }
+
+    if (purgeNow || stopNow) {
+        Serial.println("[FAN] Environment safe" + String(purgeNow ? ", purging smoke" : ", short event, turning off fan"));
+        queueAlarmEvent("fan", "environment_safe");
+        Serial.println("[FAN] Temp: " + String(temperature) + "°C, Smoke: " + String(smokeLevel) + "%");
+        if (purgeNow) {
+            fanStartPurge();
+        } else {
             fanOff();
         }
     }
@@ -259,39 +468,53 @@ void updateFanAutoControl(float temperature, float humidity, float smokeLevel, b
  * @brief 风扇控制RTOS任务
  * 
  * 独立运行的任务，周期性读取传感器数据并执行自动控制
- * 任务周期：1秒
+ * 任务周期：继电器模式1秒，PWM模式 FAN_CONTROL_PERIOD_MS（软启动斜率更平滑）
  */
 void fanTask(void *pvParameters) {
     Serial.println("[FAN] Fan control task started on Core " + String(xPortGetCoreID()));
     
-    // 等待传感器预热
-    vTaskDelay(pdMS_TO_TICKS(2000)); 
+    // 等待首次采样（代替固定延时）
+    bootWaitFirstSample();
+
+    int8_t supervisorId = supervisorRegister("Fan_Task", FAN_PWM_ENABLE ? FAN_CONTROL_PERIOD_MS : 1000, FAN_TASK_DEADLINE_MS);
+    bootTaskReady(BOOT_READY_FAN);
     
     for (;;) {
+        supervisorCheckIn(supervisorId);
+
         // 仅在自动模式下读取传感器并控制
         if (isFanAutoMode()) {
         
-            // 获取传感器数据
-            float temperature;
-            float humidity;
-            float smokeLevel;
-            bool  smokeAlarm;
-            if(xSemaphoreTake(sensorMutex,portMAX_DELAY)==pdTRUE){
-                temperature = sensorData.temperature;
-                humidity = sensorData.humidity;
-                smokeLevel = sensorData.smokeLevel;
-                smokeAlarm = sensorData.smokeAlarm;
-                xSemaphoreGive(sensorMutex);
-            }
+            // 获取传感器数据（主风扇为整层排烟，取最严重分区的读数）
+            SensorData data = getSensorData(getFireZone());
+            float temperature = data.temperature;
+            float humidity = data.humidity;
+            float smokeLevel = data.smokeLevel;
+            bool  smokeAlarm = data.smokeAlarm;
 
-            // 检查DHT读取是否有效
-            if(!isnan(humidity) && !isnan(temperature)){
-                // 执行自动控制逻辑
-                updateFanAutoControl(temperature, humidity, smokeLevel, smokeAlarm);
+            // 执行自动控制逻辑（温度读取失败由融合评估的过期衰减处理）
+            updateFanAutoControl(temperature, humidity, smokeLevel, smokeAlarm);
+        }
+
+        // 延时排烟到时停机，并按软启动斜率推进转速
+        bool purgeDone = false;
+        if (xSemaphoreTake(fanMutex, portMAX_DELAY) == pdTRUE) {
+            if (fanControl.purging && millis() - purgeStartTime >= K230_FAN_DURATION_MS) {
+                purgeDone = true;
             }
+            stepFanOutput();
+            xSemaphoreGive(fanMutex);
+        }
+        if (purgeDone) {
+            Serial.println("[FAN] Purge complete");
+            fanOff();
         }
         
+#if FAN_PWM_ENABLE
+        vTaskDelay(pdMS_TO_TICKS(FAN_CONTROL_PERIOD_MS));
+#else
         // 任务周期：1秒
         vTaskDelay(pdMS_TO_TICKS(1000));
+#endif
     }
 }
@@ -0,0 +1,178 @@
+#include <Arduino.h>
+#include "MY_Fusion.h"
+#include "MY_Config.h"
+#include "MY_MQTT.h"
+#include "MY_Memory.h"
+
+// ==================== 全局变量定义 ====================
+// 融合状态只在本模块内访问 (持有fusionMutex)，setupFusion() 中初始化
+static FusionState fusionState;
+
+SemaphoreHandle_t fusionMutex = NULL;
+
+// ==================== 初始化函数 ====================
+
+void setupFusion() {
+    fusionMutex = CREATE_MODULE_MUTEX();
+    fusionKernelInit(&fusionState, ZONE_COUNT, K230_ZONE);
+
+    Serial.println("[FUSION] Fire confidence fusion initialized, zones: " + String(ZONE_COUNT));
+    Serial.println("[FUSION] Weights smoke/temp/do/k230: " + String(FUSION_WEIGHT_SMOKE) + "/" +
+                   String(FUSION_WEIGHT_TEMP) + "/" + String(FUSION_WEIGHT_MQ2_DO) + "/" + String(FUSION_WEIGHT_K230));
+    Serial.println("[FUSION] Alarm/suppress/clear score: " + String(FUSION_ALARM_SCORE) + "/" +
+                   String(FUSION_SUPPRESS_SCORE) + "/" + String(FUSION_CLEAR_SCORE));
+}
+
+// ==================== 证据更新 ====================
+
+/**
+ * @brief 更新全部分区的传感器证据 (传感器任务每次采样后调用)
+ * @param data 本周期各分区读数，温度为NaN表示该分区本次读取失败
+ */
+void fusionUpdateSensors(const ZoneSensorData* data) {
+    const SystemConfig* cfg = getConfig();
+    FusionThresholds thresholds = {
+        cfg->smokeSafeThreshold, cfg->smokeAlarmThreshold, cfg->tempSafeThreshold, cfg->tempAlarmThreshold
+    };
+    uint32_t now = millis();
+
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        fusionKernelUpdateSensors(&fusionState, &thresholds, data->temperature, data->smokeLevel,
+                                  data->smokeAlarm, now);
+        xSemaphoreGive(fusionMutex);
+    }
+}
+
+/**
+ * @brief 更新K230视觉证据 (每收到一帧火焰检测调用，计入 K230_ZONE)
+ * @param confidence 检测置信度 [0,1]，旧协议传 FUSION_K230_DEFAULT_CONF
+ */
+void fusionUpdateK230(float confidence) {
+    uint32_t now = millis();
+
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        fusionKernelUpdateK230(&fusionState, confidence, now);
+        xSemaphoreGive(fusionMutex);
+    }
+}
+
+// ==================== 融合评估 ====================
+
+/**
+ * @brief 计算全部分区的火灾置信度并按迟滞更新等级，等级变化时上报事件
+ *
+ * 只由传感器任务调用：每次采样后，以及K230帧到达时 (sensorRequestEvaluate)；
+ * 执行器与上报通过 fusionAssessment() / fusionZoneAssessment() 读取本次结果
+ */
+void fusionEvaluate() {
+    FireLevel previous[ZONE_COUNT];
+    FireLevel current[ZONE_COUNT];
+    float scores[ZONE_COUNT];
+    float peaks[ZONE_COUNT];
+    uint32_t now = millis();
+
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+            previous[z] = fusionState.level[z];
+        }
+        fusionKernelEvaluate(&fusionState, now);
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+            current[z] = fusionState.level[z];
+            scores[z] = fusionState.score[z];
+            peaks[z] = fusionState.peakScore[z];
+        }
+        xSemaphoreGive(fusionMutex);
+    } else {
+        return;
+    }
+
+    // 等级变化时上报 (互斥锁外执行)
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        if (current[z] == previous[z]) continue;
+        Serial.println("[FUSION] " + String(zoneTable[z].name) + " level " + String(getFireLevelName(previous[z])) +
+                       " -> " + String(getFireLevelName(current[z])) + ", score=" + String(scores[z], 2));
+        if (current[z] == FIRE_LEVEL_NONE) {
+            Serial.println("[FUSION] " + String(zoneTable[z].name) + " event cleared, peak score=" + String(peaks[z], 2));
+        }
+        queueAlarmEvent("fusion", getFireLevelName(current[z]), zoneTable[z].name);
+    }
+}
+
+/**
+ * @brief 最近一次评估的整层结果 (最严重的分区)
+ * 只读取缓存，不推进迟滞，可在任意任务中调用
+ */
+FireAssessment fusionAssessment() {
+    FireAssessment result = {};
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        result = fusionKernelResult(&fusionState, fusionState.worstZone);
+        xSemaphoreGive(fusionMutex);
+    }
+    return result;
+}
+
+/**
+ * @brief 最近一次评估中单个分区的结果
+ */
+FireAssessment fusionZoneAssessment(uint8_t zone) {
+    FireAssessment result = {};
+    if (zone >= ZONE_COUNT) return result;
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        result = fusionKernelResult(&fusionState, zone);
+        xSemaphoreGive(fusionMutex);
+    }
+    return result;
+}
+
+/**
+ * @brief 一次复制全部分区的等级
+ */
+void fusionGetLevels(FireLevel levels[ZONE_COUNT]) {
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+            levels[z] = fusionState.level[z];
+        }
+        xSemaphoreGive(fusionMutex);
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+float getFireScore() {
+    float score = 0.0f;
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        score = fusionState.score[fusionState.worstZone];
+        xSemaphoreGive(fusionMutex);
+    }
+    return score;
+}
+
+FireLevel getFireLevel() {
+    FireLevel level = FIRE_LEVEL_NONE;
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        level = fusionState.level[fusionState.worstZone];
+        xSemaphoreGive(fusionMutex);
+    }
+    return level;
+}
+
+uint8_t getFireZone() {
+    uint8_t zone = 0;
+    if (xSemaphoreTake(fusionMutex, portMAX_DELAY) == pdTRUE) {
+        zone = fusionState.worstZone;
+        xSemaphoreGive(fusionMutex);
+    }
+    return zone;
+}
+
+const char* getFireLevelName(FireLevel level) {
+    switch (level) {
+        case FIRE_LEVEL_ALARM: return "alarm";
+        case FIRE_LEVEL_SUPPRESS: return "suppress";
+        default: return "none";
+    }
+}
+
+const char* getFireLevelString() {
+    return getFireLevelName(getFireLevel());
+}
@@ -0,0 +1,234 @@
+#include <math.h>
+#include <string.h>
+#include "MY_FusionKernels.h"
+
+// 各证据源的权重与过期参数
+static const float sourceWeight[FUSION_SRC_COUNT] = {
+    FUSION_WEIGHT_SMOKE, FUSION_WEIGHT_TEMP, FUSION_WEIGHT_MQ2_DO, FUSION_WEIGHT_K230
+};
+static const uint32_t sourceFreshMs[FUSION_SRC_COUNT] = {
+    FUSION_SENSOR_FRESH_MS, FUSION_SENSOR_FRESH_MS, FUSION_SENSOR_FRESH_MS, FUSION_K230_FRESH_MS
+};
+static const uint32_t sourceTauMs[FUSION_SRC_COUNT] = {
+    FUSION_SENSOR_TAU_MS, FUSION_SENSOR_TAU_MS, FUSION_SENSOR_TAU_MS, FUSION_K230_TAU_MS
+};
+
+void fusionKernelInit(FusionState* state, uint8_t zoneCount, uint8_t k230Zone) {
+    memset(state, 0, sizeof(*state));
+    state->zoneCount = zoneCount;
+    state->k230Zone = k230Zone;
+}
+
+// ==================== 证据计算 ====================
+
+static float clamp01(float x) {
+    if (x < 0.0f) return 0.0f;
+    if (x > 1.0f) return 1.0f;
+    return x;
+}
+
+/**
+ * @brief 数值在 安全阈值→报警阈值 之间的位置加上斜率项，映射为证据强度
+ */
+static float levelEvidence(float value, float safeThreshold, float alarmThreshold, float slope, float slopeFull) {
+    float levelTerm = clamp01((value - safeThreshold) / (alarmThreshold - safeThreshold));
+    float slopeTerm = clamp01(slope / slopeFull);
+    return clamp01(levelTerm + FUSION_SLOPE_BONUS * slopeTerm);
+}
+
+/**
+ * @brief 证据过期衰减系数
+ */
+static float stalenessFactor(const FusionState* state, uint8_t source, uint8_t zone, uint32_t nowMs) {
+    if (!state->valid[source][zone]) {
+        return 0.0f;
+    }
+    uint32_t age = nowMs - state->updatedMs[source][zone];
+    if (age <= sourceFreshMs[source]) {
+        return 1.0f;
+    }
+    return expf(-(float)(age - sourceFreshMs[source]) / sourceTauMs[source]);
+}
+
+static void setEvidence(FusionState* state, uint8_t source, uint8_t zone, float evidence, uint32_t nowMs) {
+    state->evidence[source][zone] = evidence;
+    state->updatedMs[source][zone] = nowMs;
+    state->valid[source][zone] = true;
+}
+
+/**
+ * @brief 带迟滞的等级更新
+ *
+ * - 置信度 >= 报警/灭火阈值时升级
+ * - 灭火等级在置信度低于报警阈值后降为报警
+ * - 报警等级在置信度低于清除阈值后恢复安全
+ */
+FireLevel fusionNextLevel(FireLevel level, float score) {
+    if (score >= FUSION_SUPPRESS_SCORE) {
+        return FIRE_LEVEL_SUPPRESS;
+    }
+    if (score >= FUSION_ALARM_SCORE) {
+        return level == FIRE_LEVEL_NONE ? FIRE_LEVEL_ALARM : level;
+    }
+    if (level == FIRE_LEVEL_SUPPRESS) {
+        return FIRE_LEVEL_ALARM;
+    }
+    if (score < FUSION_CLEAR_SCORE) {
+        return FIRE_LEVEL_NONE;
+    }
+    return level;
+}
+
+// ==================== 证据更新 ====================
+
+void fusionKernelUpdateSensors(FusionState* state, const FusionThresholds* thresholds,
+                               const float* temperature, const float* smokeLevel, const bool* smokeAlarm,
+                               uint32_t nowMs) {
+    for (uint8_t z = 0; z < state->zoneCount; z++) {
+        // 烟雾浓度与上升斜率
+        float smoke = smokeLevel[z];
+        if (state->valid[FUSION_SRC_SMOKE][z] && nowMs != state->lastSmokeMs[z]) {
+            float slope = (smoke - state->lastSmokeLevel[z]) * 1000.0f / (nowMs - state->lastSmokeMs[z]);
+            state->smokeSlope[z] += FUSION_SLOPE_ALPHA * (slope - state->smokeSlope[z]);
+        }
+        state->lastSmokeLevel[z] = smoke;
+        state->lastSmokeMs[z] = nowMs;
+        setEvidence(state, FUSION_SRC_SMOKE, z,
+                    levelEvidence(smoke, thresholds->smokeSafe, thresholds->smokeAlarm,
+                                  state->smokeSlope[z], FUSION_SMOKE_SLOPE_FULL), nowMs);
+        if (smoke >= thresholds->smokeAlarm) {
+            if (!state->smokeHigh[z]) {
+                state->smokeHigh[z] = true;
+                state->smokeHighSinceMs[z] = nowMs;
+            }
+        } else if (smoke < 0.5f * (thresholds->smokeSafe + thresholds->smokeAlarm)) {
+            state->smokeHigh[z] = false;
+        }
+
+        // 温度与升温速率 (读取失败时不更新，证据自然过期)
+        float temp = temperature[z];
+        if (!isnan(temp)) {
+            if (!state->valid[FUSION_SRC_TEMP][z]) {
+                state->lastTemperature[z] = temp;
+                state->lastTempMs[z] = nowMs;
+            } else if (nowMs - state->lastTempMs[z] >= FUSION_TEMP_ROR_WINDOW_MS) {
+                float rise = temp - state->lastTemperature[z];
+                float excess = rise > FUSION_TEMP_RESOLUTION ? rise - FUSION_TEMP_RESOLUTION : 0.0f;
+                state->tempRor[z] = excess * 60000.0f / (nowMs - state->lastTempMs[z]);
+                state->lastTemperature[z] = temp;
+                state->lastTempMs[z] = nowMs;
+            }
+            setEvidence(state, FUSION_SRC_TEMP, z,
+                        levelEvidence(temp, thresholds->tempSafe, thresholds->tempAlarm,
+                                      state->tempRor[z], FUSION_TEMP_ROR_FULL), nowMs);
+        }
+
+        // MQ-2 数字报警
+        setEvidence(state, FUSION_SRC_MQ2_DO, z, smokeAlarm[z] ? 1.0f : 0.0f, nowMs);
+    }
+}
+
+/**
+ * @brief 计入一帧K230火焰检测
+ *
+ * 证据 = 平滑置信度 × 检测率项，单帧误检只能贡献约一半；
+ * 持续检测达到确认条件后证据为1 (旧协议的默认置信度也能确认)
+ */
+void fusionKernelUpdateK230(FusionState* state, float confidence, uint32_t nowMs) {
+    uint8_t zone = state->k230Zone;
+    confidence = clamp01(confidence);
+
+    float hitWeight = 1.0f;
+    if (state->valid[FUSION_SRC_K230][zone]) {
+        uint32_t sinceLast = nowMs - state->k230LastMs;
+        state->k230Hits *= expf(-(float)sinceLast / FUSION_K230_RATE_TAU_MS);
+        state->k230Confidence += FUSION_K230_CONF_ALPHA * (confidence - state->k230Confidence);
+        if (sinceLast < FUSION_K230_HIT_SPACING_MS) hitWeight = (float)sinceLast / FUSION_K230_HIT_SPACING_MS;
+    } else {
+        state->k230Hits = 0.0f;
+        state->k230Confidence = confidence;
+    }
+    state->k230Hits += hitWeight;
+    state->k230LastMs = nowMs;
+
+    float rateTerm = clamp01(state->k230Hits / FUSION_K230_FULL_HITS);
+    bool confirmed = state->k230Hits >= FUSION_K230_CONFIRM_HITS &&
+                     state->k230Confidence >= FUSION_K230_CONFIRM_CONF;
+    setEvidence(state, FUSION_SRC_K230, zone, confirmed ? 1.0f : state->k230Confidence * rateTerm, nowMs);
+}
+
+// ==================== 融合评估 ====================
+
+/**
+ * @brief 计算全部分区的火灾置信度并按迟滞更新等级
+ *
+ * - 传感器源 (烟雾/温度/DO) 的 noisy-OR 按健康度重新归一化：
+ *   容量_i = -ln(1 - 权重i)，健康度为过期衰减系数，
+ *   不发火概率取 Π(1 - 权重i × 证据i) ^ (Σ容量 / Σ健康度×容量)
+ *   全部传感器正常时指数为1，与原公式相同
+ * - K230不参与归一化 (它是补充来源，缺失不代表传感器故障)
+ * - 烟雾持续高于报警阈值超过 FUSION_SMOKE_CONFIRM_MS 时置信度至少为灭火阈值
+ * 每个分区只处理固定的几个证据源，总开销随分区数线性增长
+ */
+uint8_t fusionKernelEvaluate(FusionState* state, uint32_t nowMs) {
+    float capacity[FUSION_SRC_COUNT];
+    float totalCapacity = 0.0f;
+    for (uint8_t i = 0; i < FUSION_SRC_K230; i++) {
+        capacity[i] = -logf(1.0f - sourceWeight[i]);
+        totalCapacity += capacity[i];
+    }
+
+    uint8_t worst = 0;
+    for (uint8_t z = 0; z < state->zoneCount; z++) {
+        float sensorNotFire = 1.0f;
+        float healthyCapacity = 0.0f;
+        for (uint8_t i = 0; i < FUSION_SRC_K230; i++) {
+            float health = stalenessFactor(state, i, z, nowMs);
+            float effective = state->evidence[i][z] * health;
+            state->effective[i][z] = effective;
+            sensorNotFire *= 1.0f - sourceWeight[i] * effective;
+            healthyCapacity += health * capacity[i];
+        }
+        if (healthyCapacity > 0.0f && healthyCapacity < totalCapacity) {
+            sensorNotFire = powf(sensorNotFire, totalCapacity / healthyCapacity);
+        }
+
+        float k230 = state->evidence[FUSION_SRC_K230][z] * stalenessFactor(state, FUSION_SRC_K230, z, nowMs);
+        state->effective[FUSION_SRC_K230][z] = k230;
+        float score = 1.0f - sensorNotFire * (1.0f - sourceWeight[FUSION_SRC_K230] * k230);
+
+        if (state->smokeHigh[z] && state->effective[FUSION_SRC_SMOKE][z] > 0.0f &&
+            nowMs - state->smokeHighSinceMs[z] >= FUSION_SMOKE_CONFIRM_MS && score < FUSION_SUPPRESS_SCORE) {
+            score = FUSION_SUPPRESS_SCORE;
+        }
+
+        FireLevel previous = state->level[z];
+        FireLevel level = fusionNextLevel(previous, score);
+        if (previous == FIRE_LEVEL_NONE) {
+            state->peakScore[z] = 0.0f;
+        }
+        if (score > state->peakScore[z]) {
+            state->peakScore[z] = score;
+        }
+        state->level[z] = level;
+        state->score[z] = score;
+
+        if (level > state->level[worst] ||
+            (level == state->level[worst] && score > state->score[worst])) {
+            worst = z;
+        }
+    }
+    state->worstZone = worst;
+    return worst;
+}
+
+FireAssessment fusionKernelResult(const FusionState* state, uint8_t zone) {
+    FireAssessment result = {};
+    result.score = state->score[zone];
+    result.level = state->level[zone];
+    result.zone = zone;
+    for (uint8_t i = 0; i < FUSION_SRC_COUNT; i++) {
+        result.evidence[i] = state->effective[i][zone];
+    }
+    return result;
+}
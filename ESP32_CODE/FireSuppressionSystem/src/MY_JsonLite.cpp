@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "MY_JsonLite.h"
+
+// ==================== 写入 ====================
+
+static void appendRaw(JsonLiteWriter* w, const char* text, size_t n) {
+    // 保留结尾0的位置；放不下的部分只计入长度
+    if (w->length + 1 < w->size) {
+        size_t room = w->size - 1 - w->length;
+        memcpy(w->buffer + w->length, text, n < room ? n : room);
+    }
+    w->length += n;
+}
+
+static void appendChar(JsonLiteWriter* w, char c) {
+    appendRaw(w, &c, 1);
+}
+
+static void appendEscaped(JsonLiteWriter* w, const char* text) {
+    appendChar(w, '"');
+    for (const char* p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\') {
+            char escaped[2] = { '\\', (char)c };
+            appendRaw(w, escaped, 2);
+        } else if (c == '\n') {
+            appendRaw(w, "\\n", 2);
+        } else if (c == '\r') {
+            appendRaw(w, "\\r", 2);
+        } else if (c == '\t') {
+            appendRaw(w, "\\t", 2);
+        } else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            appendRaw(w, escaped, 6);
+        } else {
+            appendChar(w, (char)c);
+        }
+    }
+    appendChar(w, '"');
+}
+
+// 成员前的逗号与键
+static void appendPrefix(JsonLiteWriter* w, const char* key) {
+    if (w->needComma[w->depth]) appendChar(w, ',');
+    w->needComma[w->depth] = true;
+    if (key != NULL) {
+        appendEscaped(w, key);
+        appendChar(w, ':');
+    }
+}
+
+static void appendText(JsonLiteWriter* w, const char* key, const char* text) {
+    appendPrefix(w, key);
+    appendRaw(w, text, strlen(text));
+}
+
+void jsonLiteBegin(JsonLiteWriter* w, char* buffer, size_t size) {
+    w->buffer = buffer;
+    w->size = size;
+    w->length = 0;
+    w->depth = 0;
+    w->needComma[0] = false;
+    if (size > 0) buffer[0] = '\0';
+}
+
+static void beginContainer(JsonLiteWriter* w, const char* key, char open) {
+    appendPrefix(w, key);
+    appendChar(w, open);
+    if (w->depth + 1 < JSON_LITE_MAX_DEPTH) {
+        w->depth++;
+        w->needComma[w->depth] = false;
+    }
+}
+
+static void endContainer(JsonLiteWriter* w, char close) {
+    appendChar(w, close);
+    if (w->depth > 0) w->depth--;
+}
+
+void jsonLiteBeginObject(JsonLiteWriter* w, const char* key) {
+    beginContainer(w, key, '{');
+}
+
+void jsonLiteEndObject(JsonLiteWriter* w) {
+    endContainer(w, '}');
+}
+
+void jsonLiteBeginArray(JsonLiteWriter* w, const char* key) {
+    beginContainer(w, key, '[');
+}
+
+void jsonLiteEndArray(JsonLiteWriter* w) {
+    endContainer(w, ']');
+}
+
+void jsonLiteString(JsonLiteWriter* w, const char* key, const char* value) {
+    if (value == NULL) {
+        appendText(w, key, "null");
+        return;
+    }
+    appendPrefix(w, key);
+    appendEscaped(w, value);
+}
+
+void jsonLiteBool(JsonLiteWriter* w, const char* key, bool value) {
+    appendText(w, key, value ? "true" : "false");
+}
+
+void jsonLiteInt(JsonLiteWriter* w, const char* key, int64_t value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%lld", (long long)value);
+    appendText(w, key, text);
+}
+
+void jsonLiteUint(JsonLiteWriter* w, const char* key, uint64_t value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%llu", (unsigned long long)value);
+    appendText(w, key, text);
+}
+
+void jsonLiteFixed(JsonLiteWriter* w, const char* key, double value, uint8_t decimals) {
+    if (!isfinite(value)) {
+        appendText(w, key, "null");
+        return;
+    }
+    double scale = pow(10.0, decimals);
+    double rounded = round(value * scale) / scale;
+    char text[40];
+    int n = snprintf(text, sizeof(text), "%.*f", decimals, rounded);
+    if (n <= 0 || n >= (int)sizeof(text)) {
+        appendText(w, key, "null");
+        return;
+    }
+    // 去掉末尾的0和小数点
+    if (decimals > 0) {
+        while (n > 0 && text[n - 1] == '0') text[--n] = '\0';
+        if (n > 0 && text[n - 1] == '.') text[--n] = '\0';
+    }
+    appendText(w, key, strcmp(text, "-0") == 0 ? "0" : text);
+}
+
+void jsonLiteFloat(JsonLiteWriter* w, const char* key, float value) {
+    if (!isfinite(value)) {
+        appendText(w, key, "null");
+        return;
+    }
+    char text[24];
+    snprintf(text, sizeof(text), "%.6g", (double)value);
+    appendText(w, key, text);
+}
+
+size_t jsonLiteEnd(JsonLiteWriter* w) {
+    if (w->size > 0) {
+        w->buffer[w->length < w->size ? w->length : w->size - 1] = '\0';
+    }
+    return w->length;
+}
+
+// ==================== 读取 ====================
+
+typedef struct {
+    const char* p;
+    const char* end;
+} JsonLiteCursor;
+
+static void skipSpace(JsonLiteCursor* c) {
+    while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\r' || *c->p == '\n')) c->p++;
+}
+
+static bool isHex(char ch) {
+    return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+}
+
+static bool isDigit(char ch) {
+    return ch >= '0' && ch <= '9';
+}
+
+// 光标位于开引号；成功时停在闭引号之后，start/length 为引号内的原始文本
+static bool parseString(JsonLiteCursor* c, const char** start, size_t* length) {
+    c->p++;
+    *start = c->p;
+    while (c->p < c->end) {
+        unsigned char ch = (unsigned char)*c->p;
+        if (ch == '"') {
+            *length = (size_t)(c->p - *start);
+            c->p++;
+            return true;
+        }
+        if (ch < 0x20) return false;
+        if (ch == '\\') {
+            if (++c->p >= c->end) return false;
+            char e = *c->p;
+            if (e == 'u') {
+                if (c->end - c->p < 5) return false;
+                for (int i = 1; i <= 4; i++) {
+                    if (!isHex(c->p[i])) return false;
+                }
+                c->p += 4;
+            } else if (strchr("\"\\/bfnrt", e) == NULL) {
+                return false;
+            }
+        }
+        c->p++;
+    }
+    return false;
+}
+
+static bool parseNumber(JsonLiteCursor* c) {
+    if (c->p < c->end && *c->p == '-') c->p++;
+    if (c->p >= c->end || !isDigit(*c->p)) return false;
+    if (*c->p == '0') {
+        c->p++;
+    } else {
+        while (c->p < c->end && isDigit(*c->p)) c->p++;
+    }
+    if (c->p < c->end && *c->p == '.') {
+        c->p++;
+        if (c->p >= c->end || !isDigit(*c->p)) return false;
+        while (c->p < c->end && isDigit(*c->p)) c->p++;
+    }
+    if (c->p < c->end && (*c->p == 'e' || *c->p == 'E')) {
+        c->p++;
+        if (c->p < c->end && (*c->p == '+' || *c->p == '-')) c->p++;
+        if (c->p >= c->end || !isDigit(*c->p)) return false;
+        while (c->p < c->end && isDigit(*c->p)) c->p++;
+    }
+    return true;
+}
+
+static bool parseLiteral(JsonLiteCursor* c, const char* word) {
+    size_t n = strlen(word);
+    if ((size_t)(c->end - c->p) < n || memcmp(c->p, word, n) != 0) return false;
+    c->p += n;
+    return true;
+}
+
+static bool parseValue(JsonLiteCursor* c, uint8_t depth, JsonLiteObject* object, JsonLiteMember* out);
+
+// 光标位于 '{' 或 '['；object 非NULL时记录成员 (只用于顶层对象)
+static bool parseContainer(JsonLiteCursor* c, uint8_t depth, JsonLiteObject* object) {
+    if (depth >= JSON_LITE_MAX_DEPTH) return false;
+    bool isObject = *c->p == '{';
+    char close = isObject ? '}' : ']';
+    c->p++;
+    skipSpace(c);
+    if (c->p < c->end && *c->p == close) {
+        c->p++;
+        return true;
+    }
+
+    while (c->p < c->end) {
+        JsonLiteMember member;
+        if (isObject) {
+            if (*c->p != '"' || !parseString(c, &member.key, &member.keyLength)) return false;
+            skipSpace(c);
+            if (c->p >= c->end || *c->p != ':') return false;
+            c->p++;
+            skipSpace(c);
+        }
+        if (!parseValue(c, depth + 1, NULL, &member)) return false;
+        if (object != NULL && object->count < JSON_LITE_MAX_MEMBERS) {
+            object->members[object->count++] = member;
+        }
+
+        skipSpace(c);
+        if (c->p >= c->end) return false;
+        if (*c->p == close) {
+            c->p++;
+            return true;
+        }
+        if (*c->p != ',') return false;
+        c->p++;
+        skipSpace(c);
+    }
+    return false;
+}
+
+static bool parseValue(JsonLiteCursor* c, uint8_t depth, JsonLiteObject* object, JsonLiteMember* out) {
+    if (c->p >= c->end) return false;
+    const char* start = c->p;
+    char ch = *c->p;
+    bool ok;
+    if (ch == '"') {
+        out->type = JSON_LITE_STRING;
+        return parseString(c, &out->value, &out->valueLength);
+    } else if (ch == '{' || ch == '[') {
+        out->type = ch == '{' ? JSON_LITE_OBJECT : JSON_LITE_ARRAY;
+        ok = parseContainer(c, depth, object);
+    } else if (ch == 't' || ch == 'f') {
+        out->type = JSON_LITE_BOOL;
+        ok = parseLiteral(c, ch == 't' ? "true" : "false");
+    } else if (ch == 'n') {
+        out->type = JSON_LITE_NULL;
+        ok = parseLiteral(c, "null");
+    } else {
+        out->type = JSON_LITE_NUMBER;
+        ok = parseNumber(c);
+    }
+    out->value = start;
+    out->valueLength = (size_t)(c->p - start);
+    return ok;
+}
+
+bool jsonLiteParse(const char* json, size_t length, JsonLiteObject* object) {
+    JsonLiteCursor c = { json, json + length };
+    object->count = 0;
+    skipSpace(&c);
+    if (c.p >= c.end || *c.p != '{') return false;
+    if (!parseContainer(&c, 0, object)) return false;
+    skipSpace(&c);
+    return c.p == c.end;
+}
+
+const JsonLiteMember* jsonLiteFind(const JsonLiteObject* object, const char* key) {
+    size_t keyLength = strlen(key);
+    // 重复的键取最后一个
+    for (int i = (int)object->count - 1; i >= 0; i--) {
+        const JsonLiteMember* m = &object->members[i];
+        if (m->keyLength == keyLength && memcmp(m->key, key, keyLength) == 0) return m;
+    }
+    return NULL;
+}
+
+bool jsonLiteEquals(const JsonLiteMember* member, const char* text) {
+    return member != NULL && member->type == JSON_LITE_STRING &&
+           member->valueLength == strlen(text) && memcmp(member->value, text, member->valueLength) == 0;
+}
+
+bool jsonLiteToDouble(const JsonLiteMember* member, double* value) {
+    if (member == NULL || member->type != JSON_LITE_NUMBER || member->valueLength >= 32) return false;
+    char text[32];
+    memcpy(text, member->value, member->valueLength);
+    text[member->valueLength] = '\0';
+    double parsed = strtod(text, NULL);
+    if (!isfinite(parsed)) return false;
+    *value = parsed;
+    return true;
+}
+
+bool jsonLiteToUint32(const JsonLiteMember* member, uint32_t* value) {
+    double parsed;
+    if (!jsonLiteToDouble(member, &parsed) || parsed < 0.0 || parsed > 4294967295.0) return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
@@ -1,8 +1,17 @@
 #include <Arduino.h>
 #include "MY_K230.h"
-#include "MY_Fan.h"
-#include "MY_Pump.h"
 #include "MY_Buzzer.h"
+#include "MY_Fusion.h"
+#include "MY_Sensor.h"
+#include "MY_MQTT.h"
+#include "MY_Boot.h"
+#include "MY_Config.h"
+#include "MY_Power.h"
+#include "MY_Supervisor.h"
+#include "MY_Memory.h"
+#include "MY_Snapshot.h"
+#include <esp_timer.h>
+#include <esp_rom_crc.h>
 
 // ==================== 全局变量定义 ====================
 K230Control k230Control = {
@@ -14,6 +23,21 @@ K230Control k230Control = {
     .suppressionActive = false
 };
 
+// 全部字段为0：链路等待中 (K230_LINK_WAITING)，尚未收到心跳
+K230Health k230Health = {};
+
+K230LinkStats k230LinkStats = {
+    .baudState = K230_BAUD_BASE,
+    .baudRate = K230_BAUD_RATE,
+    .upgrades = 0,
+    .fallbacks = 0,
+    .rxBytes = 0,
+    .rxBytesPerSec = 0,
+    .frames = 0,
+    .crcErrors = 0,
+    .frameErrors = 0
+};
+
 TaskHandle_t k230TaskHandle = NULL;
 SemaphoreHandle_t k230Mutex = NULL;
 
@@ -21,29 +45,86 @@ SemaphoreHandle_t k230Mutex = NULL;
 static char rxBuffer[K230_BUFFER_SIZE];
 static uint8_t rxIndex = 0;
 
+// 链路监测起点 (上电后从未收到心跳时按此计算超时)
+static unsigned long linkWatchStart = 0;
+
+// 二进制帧接收状态：字节流在文本行与二进制帧之间切换
+typedef enum {
+    RX_MODE_TEXT = 0,       // 文本行
+    RX_MODE_MAGIC = 1,      // 已收到 0xA5，等待 0x5A
+    RX_MODE_HEADER = 2,     // 帧头
+    RX_MODE_PAYLOAD = 3,    // 数据
+    RX_MODE_CRC = 4         // CRC32
+} K230RxMode;
+
+static K230RxMode rxMode = RX_MODE_TEXT;
+static uint8_t frameHeader[K230_FRAME_HEADER_SIZE];
+static uint8_t framePayload[K230_FRAME_MAX_PAYLOAD];
+static uint8_t frameCrc[4];
+static uint16_t frameFill = 0;          // 当前段已收字节数
+static uint16_t frameLength = 0;        // 数据段长度
+static int64_t frameStartUs = 0;        // 帧首字节到达时间
+static unsigned long frameStartMs = 0;
+
+// 速率协商与吞吐统计 (只在K230任务中访问)
+static unsigned long baudPhaseStart = 0;
+static unsigned long baudRetryAt = 0;
+static unsigned long lastKeepaliveTime = 0;
+static bool baudConfirmSent = false;
+static uint32_t rateWindowBytes = 0;
+static unsigned long rateWindowStart = 0;
+
+// 检测参数下发 (状态由k230Mutex保护，下发过程只在K230任务中进行)
+static K230ControlStatus controlStatus = {};
+static K230DetectParams pendingParams = {};
+static bool cfgPending = false;
+static unsigned long cfgSentTime = 0;
+static uint8_t cfgAttempts = 0;
+static uint32_t lastRestarts = 0;
+
 // ==================== 初始化函数 ====================
 
+/**
+ * @brief 串口接收回调 (运行在UART事件任务中)
+ */
+static void k230RxCallback() {
+    if (k230TaskHandle != NULL) {
+        xTaskNotifyGive(k230TaskHandle);
+    }
+}
+
 /**
  * @brief 初始化K230串口通信模块
  */
 void setupK230() {
     // 创建互斥锁
-    k230Mutex = xSemaphoreCreateMutex();
+    k230Mutex = CREATE_MODULE_MUTEX();
     
     // 初始化串口1用于K230通信
+    // 驱动接收缓冲须在 begin() 之前设置：高速率下快照分块连续到达，中断把FIFO搬入该缓冲，
+    // K230任务再批量读取
+    K230_SERIAL.setRxBufferSize(K230_RX_BUFFER_SIZE);
     K230_SERIAL.begin(K230_BAUD_RATE, SERIAL_8N1, K230_RX_PIN, K230_TX_PIN);
     
     // 清空接收缓冲区
     while (K230_SERIAL.available()) {
         K230_SERIAL.read();
     }
+
+    // 收到一帧数据后唤醒K230任务，空闲时任务不再轮询
+    K230_SERIAL.onReceive(k230RxCallback);
+    linkWatchStart = millis();
+    rateWindowStart = millis();
     
     Serial.println("[K230] ========== K230 Module Init ==========");
     Serial.println("[K230] Serial: Serial1");
-    Serial.println("[K230] Baud Rate: " + String(K230_BAUD_RATE));
+    Serial.println("[K230] Baud Rate: " + String(K230_BAUD_RATE) +
+                   (K230_HIGH_BAUD_RATE > 0 ? ", negotiate " + String(K230_HIGH_BAUD_RATE) : String("")));
     Serial.println("[K230] RX Pin: " + String(K230_RX_PIN));
     Serial.println("[K230] TX Pin: " + String(K230_TX_PIN));
     Serial.println("[K230] Fire Command: \"" + String(K230_FIRE_CMD) + "\"");
+    Serial.println("[K230] Heartbeat: every " + String(K230_HEARTBEAT_INTERVAL_MS) + "ms, timeout " +
+                   String(getConfig()->k230HeartbeatTimeoutMs) + "ms, min FPS " + String(getConfig()->k230MinFps, 1));
     Serial.println("[K230] ========================================");
 }
 
@@ -82,18 +163,506 @@ const char* getK230FireStateString() {
     }
 }
 
+const char* getK230LinkStateString(K230LinkState state) {
+    switch (state) {
+        case K230_LINK_OK:      return "ok";
+        case K230_LINK_LOST:    return "lost";
+        case K230_LINK_STALLED: return "stalled";
+        case K230_LINK_LOW_FPS: return "low_fps";
+        default:                return "waiting";
+    }
+}
+
+// ==================== 视觉链路监测 ====================
+
+K230Health getK230Health() {
+    K230Health health = {};
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        health = k230Health;
+        xSemaphoreGive(k230Mutex);
+    }
+    return health;
+}
+
+static bool isFaultState(K230LinkState state) {
+    return state == K230_LINK_LOST || state == K230_LINK_STALLED || state == K230_LINK_LOW_FPS;
+}
+
+bool isK230VisionFault() {
+    return isFaultState(getK230Health().linkState);
+}
+
+/**
+ * @brief 切换链路状态（调用方需持有k230Mutex）
+ * @return true=状态发生变化
+ */
+static bool setLinkState(K230LinkState next) {
+    if (k230Health.linkState == next) return false;
+    if (isFaultState(next)) k230Health.faults++;
+    k230Health.linkState = next;
+    return true;
+}
+
+/**
+ * @brief 链路状态变化后的日志与报警事件（不持有锁时调用）
+ */
+static void reportLinkTransition(K230LinkState prev, K230LinkState next) {
+    Serial.println("[K230] Vision link " + String(getK230LinkStateString(prev)) + " -> " +
+                   String(getK230LinkStateString(next)));
+
+    switch (next) {
+        case K230_LINK_LOST:    queueAlarmEvent("k230", "vision_lost"); break;
+        case K230_LINK_STALLED: queueAlarmEvent("k230", "vision_stalled"); break;
+        case K230_LINK_LOW_FPS: queueAlarmEvent("k230", "vision_low_fps"); break;
+        case K230_LINK_OK:
+            if (isFaultState(prev)) queueAlarmEvent("k230", "vision_restored");
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 处理K230心跳
+ *
+ * 帧计数不增长判定为卡死；帧率连续 K230_LOW_FPS_COUNT 次低于下限判定为低帧率；
+ * 帧计数回退说明K230重启过，不算卡死
+ */
+static void handleK230Heartbeat(uint32_t frames, float fps, float inferMs, const char* modelId) {
+    const SystemConfig* cfg = getConfig();
+    K230LinkState prev = K230_LINK_WAITING;
+    K230LinkState next = K230_LINK_WAITING;
+    bool changed = false;
+
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        bool first = (k230Health.heartbeats == 0);
+        bool stalled = !first && frames == k230Health.frames;
+        if (!first && frames < k230Health.frames) {
+            k230Health.restarts++;
+        }
+
+        k230Health.lastHeartbeatTime = millis();
+        k230Health.heartbeats++;
+        k230Health.frames = frames;
+        k230Health.fps = fps;
+        k230Health.inferMs = inferMs;
+        k230Health.inferAvgMs = first ? inferMs
+                                      : k230Health.inferAvgMs + K230_INFER_EWMA_ALPHA * (inferMs - k230Health.inferAvgMs);
+        if (inferMs > k230Health.inferMaxMs) k230Health.inferMaxMs = inferMs;
+        strncpy(k230Health.modelId, modelId, K230_MODEL_ID_SIZE - 1);
+        k230Health.modelId[K230_MODEL_ID_SIZE - 1] = '\0';
+
+        if (cfg->k230MinFps > 0.0f && fps < cfg->k230MinFps) {
+            if (k230Health.lowFpsCount < 255) k230Health.lowFpsCount++;
+        } else {
+            k230Health.lowFpsCount = 0;
+        }
+
+        if (stalled) {
+            next = K230_LINK_STALLED;
+        } else if (k230Health.lowFpsCount >= K230_LOW_FPS_COUNT) {
+            next = K230_LINK_LOW_FPS;
+        } else {
+            next = K230_LINK_OK;
+        }
+        prev = k230Health.linkState;
+        changed = setLinkState(next);
+        xSemaphoreGive(k230Mutex);
+    }
+
+    if (changed) {
+        if (prev == K230_LINK_WAITING) {
+            Serial.println("[K230] Vision link up, model " + String(modelId[0] != '\0' ? modelId : "unknown") +
+                           ", " + String(fps, 1) + " FPS");
+        }
+        reportLinkTransition(prev, next);
+    }
+}
+
+/**
+ * @brief 心跳超时检查（K230任务每轮调用）
+ */
+static void checkK230Liveness() {
+    unsigned long timeoutMs = getConfig()->k230HeartbeatTimeoutMs;
+    K230LinkState prev = K230_LINK_WAITING;
+    bool changed = false;
+
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        unsigned long since = k230Health.heartbeats > 0 ? k230Health.lastHeartbeatTime : linkWatchStart;
+        if (k230Health.linkState != K230_LINK_LOST && millis() - since > timeoutMs) {
+            prev = k230Health.linkState;
+            changed = setLinkState(K230_LINK_LOST);
+        }
+        xSemaphoreGive(k230Mutex);
+    }
+
+    if (changed) {
+        reportLinkTransition(prev, K230_LINK_LOST);
+    }
+}
+
+static void countBadFrame() {
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        k230Health.badFrames++;
+        xSemaphoreGive(k230Mutex);
+    }
+}
+
+void printK230Report() {
+    K230Health health = getK230Health();
+    String line = "K230: Link=" + String(getK230LinkStateString(health.linkState));
+    if (health.heartbeats > 0) {
+        line += ", Model=" + String(health.modelId) +
+                ", FPS=" + String(health.fps, 1) +
+                ", Infer last/avg/max " + String(health.inferMs, 1) + "/" + String(health.inferAvgMs, 1) + "/" +
+                String(health.inferMaxMs, 1) + "ms" +
+                ", Frames=" + String(health.frames) +
+                ", HB age " + String(millis() - health.lastHeartbeatTime) + "ms";
+    }
+    line += ", Faults=" + String(health.faults) + ", Restarts=" + String(health.restarts) +
+            ", Bad=" + String(health.badFrames);
+    Serial.println(line);
+
+    K230LinkStats link = getK230LinkStats();
+    Serial.println("K230 UART: " + String(link.baudRate) + " baud (" + String(getK230BaudStateString(link.baudState)) +
+                   "), RX " + String(link.rxBytesPerSec / 1024.0f, 1) + " KB/s, Frames=" + String(link.frames) +
+                   ", CRC errors=" + String(link.crcErrors) + ", Frame errors=" + String(link.frameErrors) +
+                   ", Upgrades=" + String(link.upgrades) + ", Fallbacks=" + String(link.fallbacks));
+
+    K230ControlStatus control = getK230ControlStatus();
+    String params = control.synced ? String(control.applied.intervalMs) + "ms, threshold " +
+                                         String(control.applied.confThreshold, 2)
+                                   : String("not applied");
+    Serial.println("K230 Report: Mode=" + String(getK230ReportModeString(control.mode)) + " (" + params +
+                   "), Fire timeout " + String(getK230FireTimeoutMs()) + "ms, Commands=" + String(control.commands) +
+                   ", Mode changes=" + String(control.modeChanges));
+    printSnapshotReport();
+}
+
+// ==================== 串口速率协商 ====================
+
+K230LinkStats getK230LinkStats() {
+    K230LinkStats stats = {};
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        stats = k230LinkStats;
+        xSemaphoreGive(k230Mutex);
+    }
+    return stats;
+}
+
+const char* getK230BaudStateString(K230BaudState state) {
+    switch (state) {
+        case K230_BAUD_REQUESTED: return "requested";
+        case K230_BAUD_VERIFYING: return "verifying";
+        case K230_BAUD_HIGH:      return "high";
+        case K230_BAUD_FAILED:    return "failed";
+        default:                  return "base";
+    }
+}
+
+/**
+ * @brief 向K230发送一行文本
+ *
+ * 整行 (含换行) 一次写入，多个任务调用时不会交错
+ */
+void k230SendLine(const char* line) {
+    char buffer[K230_BUFFER_SIZE + 2];
+    int len = snprintf(buffer, sizeof(buffer), "%s\n", line);
+    if (len <= 0 || (size_t)len >= sizeof(buffer)) return;
+    K230_SERIAL.write((const uint8_t*)buffer, (size_t)len);
+}
+
+/**
+ * @brief 更新协商状态与当前速率（只在K230任务中调用）
+ */
+static void setBaudState(K230BaudState state, uint32_t baudRate) {
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        k230LinkStats.baudState = state;
+        k230LinkStats.baudRate = baudRate;
+        if (state == K230_BAUD_HIGH) k230LinkStats.upgrades++;
+        xSemaphoreGive(k230Mutex);
+    }
+    baudPhaseStart = millis();
+}
+
+/**
+ * @brief 切换本端波特率
+ *
+ * 先等待发送完成；接收侧未处理完的半行/半帧在新速率下已无意义，一并丢弃
+ */
+static void switchK230Baud(uint32_t baudRate) {
+    K230_SERIAL.flush();
+    K230_SERIAL.updateBaudRate(baudRate);
+    rxMode = RX_MODE_TEXT;
+    rxIndex = 0;
+}
+
+/**
+ * @brief 回落到基础速率
+ * @param retry true=链路丢失后回落，链路恢复即重新协商；false=协商失败，等待 K230_BAUD_RETRY_MS
+ */
+static void fallbackK230Baud(const char* reason, bool retry) {
+    switchK230Baud(K230_BAUD_RATE);
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        k230LinkStats.fallbacks++;
+        xSemaphoreGive(k230Mutex);
+    }
+    setBaudState(retry ? K230_BAUD_BASE : K230_BAUD_FAILED, K230_BAUD_RATE);
+    baudRetryAt = millis() + K230_BAUD_RETRY_MS;
+    Serial.println("[K230] Baud fallback to " + String(K230_BAUD_RATE) + ": " + String(reason));
+}
+
+/**
+ * @brief 处理K230的协商应答 "baud_ok <N>" / "baud_active <N>"
+ * @return true=是协商应答
+ */
+static bool handleK230BaudReply(const char* data) {
+    size_t okLen = strlen(K230_BAUD_OK_CMD);
+    size_t activeLen = strlen(K230_BAUD_ACTIVE_CMD);
+    bool ok = strncmp(data, K230_BAUD_OK_CMD, okLen) == 0 && data[okLen] == ' ';
+    bool active = strncmp(data, K230_BAUD_ACTIVE_CMD, activeLen) == 0 && data[activeLen] == ' ';
+    if (!ok && !active) return false;
+
+    uint32_t baudRate = (uint32_t)strtoul(data + (ok ? okLen : activeLen) + 1, NULL, 10);
+    if (baudRate != K230_HIGH_BAUD_RATE) return true;
+
+    K230BaudState state = getK230LinkStats().baudState;
+    if (ok && state == K230_BAUD_REQUESTED) {
+        // K230已应答并即将切换，本端立即切换，稍后在新速率下发送确认
+        switchK230Baud(baudRate);
+        baudConfirmSent = false;
+        setBaudState(K230_BAUD_VERIFYING, baudRate);
+    } else if (active && state == K230_BAUD_VERIFYING) {
+        setBaudState(K230_BAUD_HIGH, baudRate);
+        lastKeepaliveTime = millis();
+        Serial.println("[K230] UART upgraded to " + String(baudRate) + " baud");
+    }
+    return true;
+}
+
+/**
+ * @brief 速率协商状态机（K230任务每轮调用）
+ *
+ * 链路正常后请求高速率；任一步超时或高速率下心跳丢失都回落到基础速率，
+ * K230一侧收不到确认或保活同样自行回落，双方最终总能在基础速率下重新对上
+ */
+static void k230BaudPoll() {
+    if (K230_HIGH_BAUD_RATE == 0) return;
+
+    unsigned long now = millis();
+    K230BaudState state = getK230LinkStats().baudState;
+    K230LinkState link = getK230Health().linkState;
+
+    switch (state) {
+        case K230_BAUD_BASE:
+        case K230_BAUD_FAILED:
+            if (link == K230_LINK_OK && (state == K230_BAUD_BASE || (long)(now - baudRetryAt) >= 0)) {
+                char line[K230_BUFFER_SIZE];
+                snprintf(line, sizeof(line), "%s %lu", K230_BAUD_CMD, (unsigned long)K230_HIGH_BAUD_RATE);
+                k230SendLine(line);
+                setBaudState(K230_BAUD_REQUESTED, K230_BAUD_RATE);
+            }
+            break;
+
+        case K230_BAUD_REQUESTED:
+            // 旧版本K230脚本不认识该命令
+            if (now - baudPhaseStart > K230_BAUD_REPLY_MS) {
+                fallbackK230Baud("no reply", false);
+            }
+            break;
+
+        case K230_BAUD_VERIFYING:
+            if (!baudConfirmSent && now - baudPhaseStart >= K230_BAUD_SETTLE_MS) {
+                k230SendLine(K230_BAUD_CONFIRM_CMD);
+                baudConfirmSent = true;
+            }
+            if (now - baudPhaseStart > K230_BAUD_VERIFY_MS) {
+                fallbackK230Baud("not confirmed", false);
+            }
+            break;
+
+        case K230_BAUD_HIGH:
+            // K230重启后回到基础速率，此处表现为心跳丢失
+            if (link == K230_LINK_LOST) {
+                fallbackK230Baud("vision link lost", true);
+            } else if (now - lastKeepaliveTime >= K230_BAUD_KEEPALIVE_MS) {
+                k230SendLine(K230_BAUD_KEEPALIVE_CMD);
+                lastKeepaliveTime = now;
+            }
+            break;
+    }
+}
+
+// ==================== 检测参数下发 ====================
+
+const char* getK230ReportModeString(K230ReportMode mode) {
+    return mode == K230_REPORT_ALERT ? "alert" : "idle";
+}
+
+K230ControlStatus getK230ControlStatus() {
+    K230ControlStatus status = {};
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        status = controlStatus;
+        xSemaphoreGive(k230Mutex);
+    }
+    return status;
+}
+
+/**
+ * @brief 当前生效的火焰超时时间
+ *
+ * K230确认上报间隔后按 间隔 × K230_FIRE_TIMEOUT_REPORTS 缩短，不超过配置值；
+ * 未确认 (旧版本K230脚本) 时使用配置值
+ */
+unsigned long getK230FireTimeoutMs() {
+    unsigned long timeoutMs = getConfig()->k230FireTimeoutMs;
+    K230ControlStatus status = getK230ControlStatus();
+    if (status.synced) {
+        unsigned long byRate = status.applied.intervalMs * K230_FIRE_TIMEOUT_REPORTS;
+        if (byRate < K230_FIRE_TIMEOUT_MIN_MS) byRate = K230_FIRE_TIMEOUT_MIN_MS;
+        if (byRate < timeoutMs) timeoutMs = byRate;
+    }
+    return timeoutMs;
+}
+
+static K230DetectParams desiredParams(K230ReportMode mode, const SystemConfig* cfg) {
+    K230DetectParams params;
+    params.intervalMs = mode == K230_REPORT_ALERT ? cfg->k230AlertReportMs : cfg->k230IdleReportMs;
+    params.confThreshold = cfg->k230ConfThreshold;
+    params.roi[0] = (uint16_t)cfg->k230RoiX;
+    params.roi[1] = (uint16_t)cfg->k230RoiY;
+    params.roi[2] = (uint16_t)cfg->k230RoiW;
+    params.roi[3] = (uint16_t)cfg->k230RoiH;
+    return params;
+}
+
+// 阈值按两位小数传输
+static bool paramsEqual(const K230DetectParams* a, const K230DetectParams* b) {
+    return a->intervalMs == b->intervalMs && fabsf(a->confThreshold - b->confThreshold) < 0.005f &&
+           memcmp(a->roi, b->roi, sizeof(a->roi)) == 0;
+}
+
+/**
+ * @brief 是否满足警戒条件
+ *
+ * K230所在分区的任一传感器证据升高、火灾等级达到报警，或视觉已检测到火焰
+ */
+static bool isK230AlertCondition() {
+    if (isK230FireDetected()) return true;
+    FireAssessment zone = fusionZoneAssessment(K230_ZONE);
+    return zone.level >= FIRE_LEVEL_ALARM ||
+           zone.evidence[FUSION_SRC_SMOKE] >= K230_ALERT_EVIDENCE ||
+           zone.evidence[FUSION_SRC_TEMP] >= K230_ALERT_EVIDENCE ||
+           zone.evidence[FUSION_SRC_MQ2_DO] >= K230_ALERT_EVIDENCE;
+}
+
+/**
+ * @brief 处理K230的参数确认 "cfg_ok <间隔> <阈值> <x> <y> <w> <h>"
+ * @return true=是参数确认
+ */
+static bool handleK230CfgAck(const char* data) {
+    size_t cmdLen = strlen(K230_CFG_OK_CMD);
+    if (strncmp(data, K230_CFG_OK_CMD, cmdLen) != 0 || data[cmdLen] != ' ') return false;
+
+    K230DetectParams acked = {};
+    unsigned long intervalMs = 0;
+    unsigned int roi[4] = {0, 0, 0, 0};
+    int fields = sscanf(data + cmdLen + 1, "%lu %f %u %u %u %u", &intervalMs, &acked.confThreshold,
+                        &roi[0], &roi[1], &roi[2], &roi[3]);
+    if (fields != 6) return true;
+    acked.intervalMs = (uint32_t)intervalMs;
+    for (uint8_t i = 0; i < 4; i++) acked.roi[i] = (uint16_t)roi[i];
+    if (!cfgPending || !paramsEqual(&acked, &pendingParams)) return true;
+
+    cfgPending = false;
+    cfgAttempts = 0;
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        controlStatus.applied = acked;
+        controlStatus.synced = true;
+        xSemaphoreGive(k230Mutex);
+    }
+    Serial.println("[K230] Detection params applied: report " + String(acked.intervalMs) + "ms, threshold " +
+                   String(acked.confThreshold, 2) + ", ROI " + String(acked.roi[0]) + "," + String(acked.roi[1]) +
+                   " " + String(acked.roi[2]) + "x" + String(acked.roi[3]));
+    return true;
+}
+
+/**
+ * @brief 自适应上报与参数下发（K230任务每轮调用）
+ *
+ * 传感器读数升高时切换到警戒档快速上报，降低视觉检测与火焰解除的延迟；
+ * 触发条件消失 K230_ALERT_HOLD_MS 后回到空闲档稀疏上报，降低串口与两端CPU负载。
+ * K230重启或链路中断后恢复为脚本默认参数，链路恢复后重新下发；
+ * 未确认时按 K230_CFG_RETRY_MS 重发，连续3次无应答 (旧版本脚本) 后改为每 K230_BAUD_RETRY_MS 一次
+ */
+static void k230ControlPoll() {
+    const SystemConfig* cfg = getConfig();
+    unsigned long now = millis();
+    bool trigger = isK230AlertCondition();
+    K230Health health = getK230Health();
+    K230BaudState baud = getK230LinkStats().baudState;
+    bool linkUp = health.linkState != K230_LINK_WAITING && health.linkState != K230_LINK_LOST;
+    bool baudStable = baud != K230_BAUD_REQUESTED && baud != K230_BAUD_VERIFYING;
+
+    K230ReportMode prevMode = K230_REPORT_IDLE;
+    K230ReportMode mode = K230_REPORT_IDLE;
+    K230DetectParams desired = {};
+    bool needSend = false;
+
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        if (trigger) controlStatus.lastTriggerTime = now;
+        bool holding = controlStatus.lastTriggerTime != 0 && now - controlStatus.lastTriggerTime < K230_ALERT_HOLD_MS;
+        prevMode = controlStatus.mode;
+        mode = (trigger || holding) ? K230_REPORT_ALERT : K230_REPORT_IDLE;
+        if (mode != prevMode) {
+            controlStatus.mode = mode;
+            controlStatus.modeChanges++;
+        }
+
+        if (!linkUp || health.restarts != lastRestarts) {
+            controlStatus.synced = false;
+            lastRestarts = health.restarts;
+        }
+
+        desired = desiredParams(mode, cfg);
+        bool current = controlStatus.synced && paramsEqual(&controlStatus.applied, &desired);
+        unsigned long retryMs = cfgAttempts < 3 ? K230_CFG_RETRY_MS : K230_BAUD_RETRY_MS;
+        bool waiting = cfgPending && paramsEqual(&pendingParams, &desired) && now - cfgSentTime < retryMs;
+        needSend = linkUp && baudStable && !current && !waiting;
+        if (needSend) controlStatus.commands++;
+        xSemaphoreGive(k230Mutex);
+    }
+
+    if (mode != prevMode) {
+        Serial.println("[K230] Report mode " + String(getK230ReportModeString(prevMode)) + " -> " +
+                       String(getK230ReportModeString(mode)) + " (" + String(desired.intervalMs) + "ms)");
+    }
+    if (!needSend) return;
+
+    if (!cfgPending || !paramsEqual(&pendingParams, &desired)) cfgAttempts = 0;
+    char line[K230_BUFFER_SIZE];
+    snprintf(line, sizeof(line), "%s %lu %.2f %u %u %u %u", K230_CFG_CMD, (unsigned long)desired.intervalMs,
+             desired.confThreshold, desired.roi[0], desired.roi[1], desired.roi[2], desired.roi[3]);
+    k230SendLine(line);
+    pendingParams = desired;
+    cfgPending = true;
+    cfgSentTime = now;
+    if (cfgAttempts < 255) cfgAttempts++;
+}
+
 // ==================== 火焰处理函数 ====================
 
 /**
  * @brief 处理K230检测到火焰事件
  * 
- * 触发灭火响应：
- * 1. 立即开启蜂鸣器警报
- * 2. 立即开启风扇（排烟）
- * 3. 立即启动水泵喷水（灭火）
- * 4. 更新状态供MQTT上报
+ * 更新视觉火焰状态并把本帧作为证据送入融合评估，
+ * 是否报警/喷水由各执行器根据火灾置信度决定
+ * 
+ * @param confidence 本帧检测置信度 [0,1]
  */
-void handleK230FireDetected() {
+void handleK230FireDetected(float confidence) {
+    bool confirmedNow = false;
+
     if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
         unsigned long now = millis();
         
@@ -106,6 +675,7 @@ void handleK230FireDetected() {
             k230Control.fireState = K230_FIRE_DETECTED;
             k230Control.fireStartTime = now;
             k230Control.totalFireEvents++;
+            powerSetHold(POWER_HOLD_K230, true);
             
             Serial.println("[K230] !!! FIRE DETECTED BY VISION !!!");
             Serial.println("[K230] Event #" + String(k230Control.totalFireEvents));
@@ -116,43 +686,28 @@ void handleK230FireDetected() {
             k230Control.fireState == K230_FIRE_DETECTED) {
             k230Control.fireState = K230_FIRE_CONFIRMED;
             k230Control.suppressionActive = true;
+            confirmedNow = true;
             
-            Serial.println("[K230] >>> FIRE CONFIRMED - ACTIVATING SUPPRESSION <<<");
+            Serial.println("[K230] >>> FIRE CONFIRMED BY VISION <<<");
         }
         
         xSemaphoreGive(k230Mutex);
     }
     
-    // 触发灭火系统（在互斥锁外执行，避免死锁）
-    if (getK230FireState() == K230_FIRE_CONFIRMED) {
-        // 开启蜂鸣器警报
-        updateBuzzerAutoControl(true);
-        
-        // 开启风扇排烟（仅自动模式）
-        if (isFanAutoMode() && getFanState() != FAN_ON) {
-            Serial.println("[K230] Activating fan for smoke extraction");
-            fanOn();
-        }
-        
-        // 启动水泵喷水（仅自动模式）
-        if (isPumpAutoMode()) {
-            PumpState pumpState = getPumpState();
-            if (pumpState == PUMP_OFF) {
-                Serial.println("[K230] Activating pump for fire suppression");
-                pumpSpray(K230_PUMP_SPRAY_MS);
-            } else if (pumpState == PUMP_COOLDOWN && isPumpAvailable()) {
-                Serial.println("[K230] Pump ready, continuing suppression");
-                pumpSpray(K230_PUMP_SPRAY_MS);
-            }
-        }
+    if (confirmedNow) {
+        queueAlarmEvent("k230", "fire_confirmed");
     }
+
+    // 送入融合证据，并请求传感器任务立即重新评估（评估后唤醒蜂鸣器任务，水泵/风扇任务在下一周期响应）
+    fusionUpdateK230(confidence);
+    sensorRequestEvaluate();
 }
 
 /**
  * @brief 重置K230火焰状态
  * 
  * 当超过超时时间未收到火焰信号时调用
- * 同时关闭蜂鸣器，并检查是否需要关闭风扇和水泵
+ * 视觉证据随后按过期衰减退出融合评估，执行器由火灾置信度决定何时恢复
  */
 void resetK230FireState() {
     bool wasActive = false;
@@ -166,23 +721,14 @@ void resetK230FireState() {
             k230Control.fireState = K230_FIRE_NONE;
             k230Control.fireCount = 0;
             k230Control.suppressionActive = false;
+            powerSetHold(POWER_HOLD_K230, false);
         }
         xSemaphoreGive(k230Mutex);
     }
     
-    // 如果之前灭火系统是激活状态，现在需要关闭
     if (wasActive) {
-        // 关闭蜂鸣器警报
-        updateBuzzerAutoControl(false);
-        
-        // 关闭风扇（仅自动模式，且传感器数据正常时）
-        if (isFanAutoMode() && getFanState() == FAN_ON) {
-            Serial.println("[K230] Fire cleared, turning off fan");
-            fanOff();
-        }
-        
-        // 水泵会自动关闭（有定时器），这里不需要手动关闭
-        Serial.println("[K230] Suppression system deactivated");
+        queueAlarmEvent("k230", "fire_cleared");
+        buzzerNotify();
     }
 }
 
@@ -190,19 +736,61 @@ void resetK230FireState() {
 
 /**
  * @brief 解析接收到的串口数据
+ * 
+ * 协议: "fire" 或 "fire <置信度>"，旧版本K230不带置信度时使用默认值
+ * 
  * @param data 接收到的字符串
+ * @param confidence 输出检测置信度
  * @return true=识别到有效命令, false=无效数据
  */
-static bool parseK230Data(const char* data) {
+static bool parseK230Data(const char* data, float* confidence) {
     // 去除首尾空白字符进行比较
     String cmd = String(data);
     cmd.trim();
     
-    if (cmd.equalsIgnoreCase(K230_FIRE_CMD)) {
+    size_t cmdLen = strlen(K230_FIRE_CMD);
+    if (cmd.length() < cmdLen || !cmd.substring(0, cmdLen).equalsIgnoreCase(K230_FIRE_CMD)) {
+        return false;
+    }
+
+    if (cmd.length() == cmdLen) {
+        *confidence = FUSION_K230_DEFAULT_CONF;
         return true;
     }
-    
-    return false;
+    if (cmd.charAt(cmdLen) != ' ') {
+        return false;
+    }
+
+    String value = cmd.substring(cmdLen + 1);
+    value.trim();
+    char* end = NULL;
+    float parsed = strtof(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0' || isnan(parsed) || parsed < 0.0f || parsed > 1.0f) {
+        return false;
+    }
+    *confidence = parsed;
+    return true;
+}
+
+/**
+ * @brief 解析心跳帧 "hb <帧数> <FPS> <推理ms> [模型ID]"
+ * @return true=格式正确
+ */
+static bool parseK230Heartbeat(const char* data, uint32_t* frames, float* fps, float* inferMs, char* modelId) {
+    size_t cmdLen = strlen(K230_HEARTBEAT_CMD);
+    if (strncmp(data, K230_HEARTBEAT_CMD, cmdLen) != 0 || data[cmdLen] != ' ') {
+        return false;
+    }
+
+    // 模型ID最长 K230_MODEL_ID_SIZE-1 (23) 个字符，更长的截断
+    unsigned long parsedFrames = 0;
+    modelId[0] = '\0';
+    int fields = sscanf(data + cmdLen + 1, "%lu %f %f %23s", &parsedFrames, fps, inferMs, modelId);
+    if (fields < 3 || isnan(*fps) || isnan(*inferMs) || *fps < 0.0f || *inferMs < 0.0f) {
+        return false;
+    }
+    *frames = (uint32_t)parsedFrames;
+    return true;
 }
 
 /**
@@ -216,8 +804,19 @@ static void processK230Char(char c) {
             rxBuffer[rxIndex] = '\0';
             
             // 解析命令
-            if (parseK230Data(rxBuffer)) {
-                handleK230FireDetected();
+            float confidence = 0.0f;
+            uint32_t frames = 0;
+            float fps = 0.0f;
+            float inferMs = 0.0f;
+            char modelId[K230_MODEL_ID_SIZE];
+            if (handleK230BaudReply(rxBuffer) || handleK230CfgAck(rxBuffer)) {
+                // 速率协商应答 / 参数确认
+            } else if (parseK230Heartbeat(rxBuffer, &frames, &fps, &inferMs, modelId)) {
+                handleK230Heartbeat(frames, fps, inferMs, modelId);
+            } else if (parseK230Data(rxBuffer, &confidence)) {
+                handleK230FireDetected(confidence);
+            } else {
+                countBadFrame();
             }
             
             // 重置缓冲区
@@ -235,6 +834,170 @@ static void processK230Char(char c) {
     }
 }
 
+static uint16_t readLe16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t readLe32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void countFrameResult(bool crcOk, bool frameOk) {
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        if (!frameOk) {
+            k230LinkStats.frameErrors++;
+        } else if (!crcOk) {
+            k230LinkStats.crcErrors++;
+        } else {
+            k230LinkStats.frames++;
+        }
+        xSemaphoreGive(k230Mutex);
+    }
+}
+
+/**
+ * @brief 校验并分发一个完整的二进制帧
+ *
+ * 帧头: 类型(1) 快照ID(2) 块序号(2) 块数(2) 总长(4) 偏移(4) 长度(2)
+ */
+static void handleK230Frame() {
+    uint32_t crc = esp_rom_crc32_le(0, frameHeader, K230_FRAME_HEADER_SIZE);
+    crc = esp_rom_crc32_le(crc, framePayload, frameLength);
+    bool crcOk = (crc == readLe32(frameCrc));
+    countFrameResult(crcOk, true);
+    if (!crcOk) return;
+
+    // CRC错误的分块直接丢弃，快照因缺块在重组超时后放弃，K230不重传
+    if (frameHeader[0] == K230_FRAME_TYPE_JPEG) {
+        snapshotHandleChunk(readLe16(&frameHeader[1]), readLe16(&frameHeader[3]), readLe16(&frameHeader[5]),
+                            readLe32(&frameHeader[7]), readLe32(&frameHeader[11]), framePayload, frameLength,
+                            frameStartUs);
+    }
+}
+
+/**
+ * @brief 向当前帧段追加数据
+ * @return 消耗的字节数
+ */
+static size_t fillFrameSegment(uint8_t* segment, uint16_t segmentSize, const uint8_t* data, size_t len) {
+    size_t n = segmentSize - frameFill;
+    if (n > len) n = len;
+    memcpy(segment + frameFill, data, n);
+    frameFill += n;
+    return n;
+}
+
+/**
+ * @brief 处理一批串口数据
+ *
+ * 文本行逐字符处理；二进制帧的数据段整段拷贝，单帧最多 K230_FRAME_MAX_PAYLOAD 字节，
+ * 处理一帧只需一次拷贝和一次ROM CRC计算，帧之间的火焰/心跳行随即得到处理
+ */
+static void processK230Bytes(const uint8_t* data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        uint8_t b = data[i];
+        switch (rxMode) {
+            case RX_MODE_TEXT:
+                if (b == K230_FRAME_MAGIC0) {
+                    rxMode = RX_MODE_MAGIC;
+                    frameStartUs = esp_timer_get_time();
+                    frameStartMs = millis();
+                } else {
+                    processK230Char((char)b);
+                }
+                i++;
+                break;
+
+            case RX_MODE_MAGIC:
+                if (b == K230_FRAME_MAGIC1) {
+                    // 帧前未以换行结束的残字节不是完整命令，丢弃
+                    rxIndex = 0;
+                    frameFill = 0;
+                    rxMode = RX_MODE_HEADER;
+                } else if (b != K230_FRAME_MAGIC0) {
+                    rxMode = RX_MODE_TEXT;
+                    processK230Char((char)b);
+                }
+                i++;
+                break;
+
+            case RX_MODE_HEADER:
+                i += fillFrameSegment(frameHeader, K230_FRAME_HEADER_SIZE, data + i, len - i);
+                if (frameFill == K230_FRAME_HEADER_SIZE) {
+                    frameLength = readLe16(&frameHeader[15]);
+                    frameFill = 0;
+                    if (frameLength == 0 || frameLength > K230_FRAME_MAX_PAYLOAD) {
+                        countFrameResult(false, false);
+                        rxMode = RX_MODE_TEXT;
+                    } else {
+                        rxMode = RX_MODE_PAYLOAD;
+                    }
+                }
+                break;
+
+            case RX_MODE_PAYLOAD:
+                i += fillFrameSegment(framePayload, frameLength, data + i, len - i);
+                if (frameFill == frameLength) {
+                    frameFill = 0;
+                    rxMode = RX_MODE_CRC;
+                }
+                break;
+
+            case RX_MODE_CRC:
+                i += fillFrameSegment(frameCrc, sizeof(frameCrc), data + i, len - i);
+                if (frameFill == sizeof(frameCrc)) {
+                    handleK230Frame();
+                    rxMode = RX_MODE_TEXT;
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * @brief 半帧超时检查：发送端中途复位或丢字节时回到文本行解析
+ */
+static void checkK230FrameTimeout() {
+    if (rxMode != RX_MODE_TEXT && millis() - frameStartMs > K230_FRAME_TIMEOUT_MS) {
+        rxMode = RX_MODE_TEXT;
+        countFrameResult(false, false);
+    }
+}
+
+/**
+ * @brief 从驱动缓冲批量读取并解析，同时统计接收速率
+ */
+static void readK230Serial() {
+    static uint8_t chunk[K230_RX_CHUNK_SIZE];
+    uint32_t received = 0;
+
+    // 单轮最多读空一次驱动缓冲，持续高速接收时也能回到任务主循环检查超时
+    for (uint16_t reads = 0; reads < K230_RX_BUFFER_SIZE / K230_RX_CHUNK_SIZE; reads++) {
+        size_t n = K230_SERIAL.read(chunk, sizeof(chunk));
+        if (n == 0) break;
+        processK230Bytes(chunk, n);
+        received += n;
+    }
+
+    rateWindowBytes += received;
+    unsigned long now = millis();
+    unsigned long elapsed = now - rateWindowStart;
+    if (received == 0 && elapsed < K230_RATE_WINDOW_MS) return;
+
+    if (xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE) {
+        k230LinkStats.rxBytes += received;
+        if (elapsed >= K230_RATE_WINDOW_MS) {
+            k230LinkStats.rxBytesPerSec = (uint32_t)((uint64_t)rateWindowBytes * 1000 / elapsed);
+        }
+        xSemaphoreGive(k230Mutex);
+    }
+    if (elapsed >= K230_RATE_WINDOW_MS) {
+        rateWindowBytes = 0;
+        rateWindowStart = now;
+    }
+}
+
 // ==================== RTOS任务函数 ====================
 
 /**
@@ -245,33 +1008,47 @@ static void processK230Char(char c) {
  * 2. 解析火焰检测命令
  * 3. 触发灭火响应
  * 4. 管理火焰状态超时
+ * 5. 监测心跳，区分"无火"与视觉链路故障
+ * 6. 协商高速波特率，接收检测快照分块
+ * 7. 按传感器状态切换上报档位，下发检测参数
  * 
- * 任务周期：10ms（高频轮询确保快速响应）
+ * 串口收到数据时立即唤醒，空闲时每 K230_IDLE_WAIT_MS 检查一次超时
  */
 void k230Task(void *pvParameters) {
     Serial.println("[K230] K230 task started on Core " + String(xPortGetCoreID()));
     Serial.println("[K230] Waiting for fire detection signals...");
     
-    // 等待系统初始化
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    // 串口已在 setupK230 中打开，无需等待，创建后立即接收检测结果
+    int8_t supervisorId = supervisorRegister("K230_Task", K230_IDLE_WAIT_MS, K230_TASK_DEADLINE_MS);
+    bootTaskReady(BOOT_READY_K230);
     
     for (;;) {
-        // 1. 读取串口数据（非阻塞）
-        while (K230_SERIAL.available()) {
-            char c = K230_SERIAL.read();
-            processK230Char(c);
-        }
+        supervisorCheckIn(supervisorId);
+
+        // 1. 读取串口数据（非阻塞）：文本行与快照分块
+        readK230Serial();
+        checkK230FrameTimeout();
         
         // 2. 检查火焰状态超时
         if (isK230FireDetected()) {
             unsigned long lastFire = getK230LastFireTime();
-            if (millis() - lastFire > K230_FIRE_TIMEOUT_MS) {
+            if (millis() - lastFire > getK230FireTimeoutMs()) {
                 Serial.println("[K230] Fire signal timeout, resetting state");
                 resetK230FireState();
             }
         }
+
+        // 3. 心跳超时检查
+        checkK230Liveness();
+
+        // 4. 速率协商、检测参数下发与快照重组超时
+        k230BaudPoll();
+        k230ControlPoll();
+        snapshotPoll();
         
-        // 3. 高频轮询，确保快速响应
-        vTaskDelay(pdMS_TO_TICKS(10));
+        // 5. 等待串口数据，收到后记录唤醒延迟并延长清醒窗口
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(K230_IDLE_WAIT_MS)) > 0) {
+            powerK230Activity();
+        }
     }
 }
@@ -0,0 +1,113 @@
+#include <Arduino.h>
+#include "MY_LocalServer.h"
+#include "MY_MQTT.h"
+#include "MY_Sensor.h"
+#include "MY_Memory.h"
+
+// ==================== 全局变量定义 ====================
+TaskHandle_t localServerTaskHandle = NULL;
+SemaphoreHandle_t localServerMutex = NULL;
+
+// 未打开时 listenFd 为-1，推送与任务据此跳过
+static LocalServerCore core = { -1 };
+
+// 请求缓冲区 (仅服务器任务使用)
+static char requestBuffer[LOCAL_SERVER_REQUEST_SIZE];
+// GET /state 的响应缓冲区 (仅服务器任务使用，与遥测负载同大小，初始化时分配)
+static char* stateBuffer = NULL;
+
+// ==================== 处理函数 ====================
+
+static void lockServer(void* ctx) {
+    xSemaphoreTake(localServerMutex, portMAX_DELAY);
+}
+
+static void unlockServer(void* ctx) {
+    xSemaphoreGive(localServerMutex);
+}
+
+static size_t serializeState(void* ctx, char* buffer, size_t size) {
+    SensorData data = getSensorData(0);
+    return createJsonPayload(buffer, size, data.temperature, data.humidity, data.smokeLevel, data.smokeAlarm);
+}
+
+// /fan/control → fire_alarm/fan/control，与MQTT控制Topic一一对应
+static bool dispatchLocalCommand(void* ctx, const char* path, const char* body) {
+    char topic[64];
+    snprintf(topic, sizeof(topic), "fire_alarm%s", path);
+    return dispatchCommand(topic, body);
+}
+
+static void logServer(void* ctx, const char* message) {
+    Serial.println("[LOCAL] " + String(message));
+}
+
+// ==================== 初始化函数 ====================
+
+void setupLocalServer() {
+    localServerMutex = CREATE_MODULE_MUTEX();
+    stateBuffer = (char*)malloc(MQTT_TX_BUFFER_SIZE);
+    if (stateBuffer == NULL) {
+        Serial.println("[LOCAL] State buffer allocation failed, server disabled");
+        return;
+    }
+
+    static const LocalCoreHandlers handlers = {
+        NULL, lockServer, unlockServer, serializeState, dispatchLocalCommand, logServer
+    };
+    if (!localCoreOpen(&core, LOCAL_SERVER_PORT, LOCAL_SERVER_MAX_CLIENTS, LOCAL_SERVER_READ_TIMEOUT_MS,
+                       requestBuffer, sizeof(requestBuffer), stateBuffer, MQTT_TX_BUFFER_SIZE,
+                       &handlers)) {
+        Serial.println("[LOCAL] Bind/listen failed on port " + String(LOCAL_SERVER_PORT));
+        return;
+    }
+
+    Serial.println("[LOCAL] ========== Local Server Init ==========");
+    Serial.println("[LOCAL] Port: " + String(LOCAL_SERVER_PORT));
+    Serial.println("[LOCAL] Max SSE clients: " + String(LOCAL_SERVER_MAX_CLIENTS));
+    Serial.println("[LOCAL] ========================================");
+}
+
+// ==================== 推送函数 ====================
+
+/**
+ * @brief 推送一帧数据给所有SSE客户端（在遥测任务中调用）
+ *
+ * 同一个payload缓冲区被所有客户端共享，过慢的客户端被断开，见 localCoreBroadcast
+ */
+void localServerBroadcast(const char* json, size_t length) {
+    if (localServerMutex == NULL || core.listenFd < 0) return;
+    localCoreBroadcast(&core, json, length);
+}
+
+// ==================== 状态获取函数 ====================
+
+LocalServerStats getLocalServerStats() {
+    LocalServerStats snapshot = {0, 0, 0, 0, 0};
+    if (localServerMutex != NULL) {
+        snapshot = localCoreStats(&core);
+    }
+    return snapshot;
+}
+
+// ==================== RTOS任务函数 ====================
+
+/**
+ * @brief 本地服务器任务
+ *
+ * 单任务select模型，每轮最长等待 LOCAL_SERVER_POLL_MS，见 localCorePoll
+ */
+void localServerTask(void *pvParameters) {
+    Serial.println("[LOCAL] Server task started on Core " + String(xPortGetCoreID()));
+
+    if (core.listenFd < 0) {
+        Serial.println("[LOCAL] Server not listening, task exit");
+        localServerTaskHandle = NULL;
+        vTaskDelete(NULL);
+        return;
+    }
+
+    for (;;) {
+        localCorePoll(&core, LOCAL_SERVER_POLL_MS);
+    }
+}
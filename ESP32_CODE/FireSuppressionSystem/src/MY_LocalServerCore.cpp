@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MY_LocalServerCore.h"
+
+#if defined(ESP_PLATFORM)
+#include <lwip/sockets.h>
+#else
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define LOCAL_SEND_FLAGS (MSG_DONTWAIT | MSG_NOSIGNAL)
+#define LOCAL_BLOCKING_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define LOCAL_SEND_FLAGS MSG_DONTWAIT
+#define LOCAL_BLOCKING_SEND_FLAGS 0
+#endif
+
+// ==================== 内部函数 ====================
+
+static void lock(LocalServerCore* core) {
+    if (core->handlers.lock != NULL) core->handlers.lock(core->handlers.ctx);
+}
+
+static void unlock(LocalServerCore* core) {
+    if (core->handlers.unlock != NULL) core->handlers.unlock(core->handlers.ctx);
+}
+
+static void logMessage(LocalServerCore* core, const char* message) {
+    if (core->handlers.log != NULL) core->handlers.log(core->handlers.ctx, message);
+}
+
+static bool sendAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        int n = send(fd, data, length, LOCAL_BLOCKING_SEND_FLAGS);
+        if (n <= 0) return false;
+        data += n;
+        length -= n;
+    }
+    return true;
+}
+
+static void sendResponse(int fd, const char* status, const char* contentType, const char* body) {
+    char header[160];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %u\r\n"
+                     "Access-Control-Allow-Origin: *\r\nConnection: close\r\n\r\n",
+                     status, contentType, (unsigned)strlen(body));
+    if (sendAll(fd, header, n)) {
+        sendAll(fd, body, strlen(body));
+    }
+}
+
+/**
+ * @brief 读取一个完整的HTTP请求（请求头 + Content-Length指定的请求体）
+ * @return 请求体起始位置，失败返回NULL
+ */
+static char* readRequest(LocalServerCore* core, int fd) {
+    struct timeval tv;
+    tv.tv_sec = core->readTimeoutMs / 1000;
+    tv.tv_usec = (core->readTimeoutMs % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    char* buffer = core->request;
+    size_t used = 0;
+    char* body = NULL;
+    size_t contentLength = 0;
+
+    while (used < core->requestSize - 1) {
+        int n = recv(fd, buffer + used, core->requestSize - 1 - used, 0);
+        if (n <= 0) return NULL;
+        used += n;
+        buffer[used] = '\0';
+
+        if (body == NULL) {
+            char* headerEnd = strstr(buffer, "\r\n\r\n");
+            if (headerEnd == NULL) continue;
+            body = headerEnd + 4;
+            const char* lengthField = strstr(buffer, "Content-Length:");
+            if (lengthField != NULL && lengthField < headerEnd) {
+                contentLength = strtoul(lengthField + 15, NULL, 10);
+            }
+        }
+        if ((size_t)(buffer + used - body) >= contentLength) {
+            body[contentLength] = '\0';
+            return body;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 将连接登记为SSE客户端
+ * @return true=登记成功（连接保持打开）
+ */
+static bool acceptSseClient(LocalServerCore* core, int fd) {
+    bool added = false;
+    lock(core);
+    for (uint8_t i = 0; i < core->maxClients; i++) {
+        if (core->clients[i].fd < 0) {
+            static const char sseHeader[] =
+                "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                "Cache-Control: no-cache\r\nAccess-Control-Allow-Origin: *\r\n"
+                "Connection: keep-alive\r\n\r\n";
+            if (!sendAll(fd, sseHeader, sizeof(sseHeader) - 1)) break;
+            core->clients[i].fd = fd;
+            core->clients[i].closing = false;
+            core->stats.clients++;
+            added = true;
+            break;
+        }
+    }
+    if (!added) core->stats.rejected++;
+    unlock(core);
+    return added;
+}
+
+/**
+ * @brief 处理一个新连接
+ */
+static void handleConnection(LocalServerCore* core, int fd) {
+    char* body = readRequest(core, fd);
+    if (body == NULL) {
+        close(fd);
+        return;
+    }
+
+    char method[8] = {0};
+    char path[48] = {0};
+    if (sscanf(core->request, "%7s %47s", method, path) != 2) {
+        sendResponse(fd, "400 Bad Request", "text/plain", "bad request");
+        close(fd);
+        return;
+    }
+
+    if (strcmp(method, "GET") == 0 && strcmp(path, "/events") == 0) {
+        if (acceptSseClient(core, fd)) {
+            logMessage(core, "SSE client connected");
+            return;
+        }
+        sendResponse(fd, "503 Service Unavailable", "text/plain", "too many clients");
+    } else if (strcmp(method, "GET") == 0 && (strcmp(path, "/state") == 0 || strcmp(path, "/") == 0)) {
+        size_t length = core->handlers.state(core->handlers.ctx, core->response, core->responseSize);
+        if (length > 0) {
+            sendResponse(fd, "200 OK", "application/json", core->response);
+        } else {
+            sendResponse(fd, "500 Internal Server Error", "text/plain", "state unavailable");
+        }
+    } else if (strcmp(method, "POST") == 0) {
+        if (core->handlers.command(core->handlers.ctx, path, body)) {
+            lock(core);
+            core->stats.commands++;
+            unlock(core);
+            char message[96];
+            snprintf(message, sizeof(message), "Command: %s -> %.48s", path, body);
+            logMessage(core, message);
+            sendResponse(fd, "200 OK", "application/json", "{\"ok\":true}");
+        } else {
+            sendResponse(fd, "404 Not Found", "application/json", "{\"ok\":false}");
+        }
+    } else {
+        sendResponse(fd, "404 Not Found", "text/plain", "not found");
+    }
+    close(fd);
+}
+
+/**
+ * @brief 关闭发送失败或已断开的SSE客户端（调用方持有锁）
+ */
+static void closeClient(LocalServerCore* core, uint8_t index, bool dropped) {
+    close(core->clients[index].fd);
+    core->clients[index].fd = -1;
+    core->clients[index].closing = false;
+    core->stats.clients--;
+    if (dropped) core->stats.clientsDropped++;
+}
+
+// ==================== 打开与关闭 ====================
+
+bool localCoreOpen(LocalServerCore* core, uint16_t port, uint8_t maxClients, uint32_t readTimeoutMs,
+                   char* request, size_t requestSize, char* response, size_t responseSize,
+                   const LocalCoreHandlers* handlers) {
+    memset(core, 0, sizeof(*core));
+    core->listenFd = -1;
+    core->maxClients = maxClients > LOCAL_CORE_MAX_CLIENTS ? LOCAL_CORE_MAX_CLIENTS : maxClients;
+    core->readTimeoutMs = readTimeoutMs;
+    core->request = request;
+    core->requestSize = requestSize;
+    core->response = response;
+    core->responseSize = responseSize;
+    core->handlers = *handlers;
+    for (uint8_t i = 0; i < LOCAL_CORE_MAX_CLIENTS; i++) {
+        core->clients[i].fd = -1;
+    }
+    if (request == NULL || requestSize < 2 || response == NULL || responseSize == 0) return false;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, core->maxClients) != 0) {
+        close(fd);
+        return false;
+    }
+    core->listenFd = fd;
+    return true;
+}
+
+uint16_t localCorePort(const LocalServerCore* core) {
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    if (core->listenFd < 0 || getsockname(core->listenFd, (struct sockaddr*)&addr, &length) != 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+void localCoreClose(LocalServerCore* core) {
+    lock(core);
+    for (uint8_t i = 0; i < core->maxClients; i++) {
+        if (core->clients[i].fd >= 0) closeClient(core, i, false);
+    }
+    unlock(core);
+    if (core->listenFd >= 0) {
+        close(core->listenFd);
+        core->listenFd = -1;
+    }
+}
+
+// ==================== 轮询 ====================
+
+/**
+ * @brief 轮询一次
+ *
+ * 1. 关闭推送失败的客户端
+ * 2. 检测SSE客户端断开（对端关闭时socket可读，recv返回0）
+ * 3. 接受新连接并处理请求（命令/快照为短连接，SSE为长连接）
+ */
+void localCorePoll(LocalServerCore* core, uint32_t timeoutMs) {
+    if (core->listenFd < 0) return;
+
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(core->listenFd, &readSet);
+    int maxFd = core->listenFd;
+    uint8_t closed = 0;
+
+    lock(core);
+    for (uint8_t i = 0; i < core->maxClients; i++) {
+        if (core->clients[i].fd >= 0 && core->clients[i].closing) {
+            closeClient(core, i, true);
+            closed++;
+        }
+        if (core->clients[i].fd >= 0) {
+            FD_SET(core->clients[i].fd, &readSet);
+            if (core->clients[i].fd > maxFd) maxFd = core->clients[i].fd;
+        }
+    }
+    unlock(core);
+
+    struct timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    if (select(maxFd + 1, &readSet, NULL, NULL, &tv) > 0) {
+        // SSE客户端不应发送数据，可读即表示断开
+        lock(core);
+        for (uint8_t i = 0; i < core->maxClients; i++) {
+            if (core->clients[i].fd >= 0 && FD_ISSET(core->clients[i].fd, &readSet)) {
+                char scratch[32];
+                if (recv(core->clients[i].fd, scratch, sizeof(scratch), MSG_DONTWAIT) <= 0) {
+                    closeClient(core, i, false);
+                    closed++;
+                }
+            }
+        }
+        unlock(core);
+
+        if (FD_ISSET(core->listenFd, &readSet)) {
+            int fd = accept(core->listenFd, NULL, NULL);
+            if (fd >= 0) {
+                handleConnection(core, fd);
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < closed; i++) {
+        logMessage(core, "SSE client disconnected");
+    }
+}
+
+// ==================== 推送 ====================
+
+/**
+ * @brief 推送一帧数据给所有SSE客户端
+ *
+ * 非阻塞发送，发送不完整的客户端标记为待关闭，由轮询方关闭，避免与select并发操作同一fd
+ */
+void localCoreBroadcast(LocalServerCore* core, const char* json, size_t length) {
+    static const char prefix[] = "data: ";
+    static const char suffix[] = "\n\n";
+
+    struct iovec iov[3];
+    iov[0].iov_base = (void*)prefix;
+    iov[0].iov_len = sizeof(prefix) - 1;
+    iov[1].iov_base = (void*)json;
+    iov[1].iov_len = length;
+    iov[2].iov_base = (void*)suffix;
+    iov[2].iov_len = sizeof(suffix) - 1;
+    size_t total = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 3;
+
+    lock(core);
+    for (uint8_t i = 0; i < core->maxClients; i++) {
+        if (core->clients[i].fd < 0 || core->clients[i].closing) continue;
+        int sent = sendmsg(core->clients[i].fd, &msg, LOCAL_SEND_FLAGS);
+        if (sent == (int)total) {
+            core->stats.framesSent++;
+        } else {
+            core->clients[i].closing = true;
+        }
+    }
+    unlock(core);
+}
+
+// ==================== 状态获取函数 ====================
+
+LocalServerStats localCoreStats(LocalServerCore* core) {
+    lock(core);
+    LocalServerStats snapshot = core->stats;
+    unlock(core);
+    return snapshot;
+}
@@ -6,6 +6,27 @@
 #include "MY_Pump.h"
 #include "MY_Buzzer.h"
 #include "MY_Sensor.h"
+#include "MY_Outbox.h"
+#include "MY_LocalServer.h"
+#include "MY_Config.h"
+#include "MY_Power.h"
+#include "MY_Supervisor.h"
+#include "MY_Memory.h"
+#include "MY_Fusion.h"
+#include "MY_Zone.h"
+#include "MY_TimeSync.h"
+#include "MY_Snapshot.h"
+#include "MY_Ota.h"
+#include "MY_Boot.h"
+#include "MY_Dsp.h"
+#include "MY_Classifier.h"
+#include "MY_CommandCore.h"
+#include "MY_SensorPayload.h"
+#include <esp_timer.h>
+#include <errno.h>
+#include <lwip/sockets.h>
+#include <lwip/dns.h>
+#include <lwip/tcpip.h>
 
 // ==================== WiFi配置 ====================
 const char* WIFI_SSID = "1234";
@@ -16,48 +37,103 @@ const char* MQTT_BROKER = "broker.emqx.io";
 const int MQTT_PORT = 1883;
 const char* MQTT_CLIENT_ID = "esp32_fire_alarm_001";
 const char* DEVICE_ID = "esp32_fire_alarm_001";
+// Broker账号 (空=匿名连接)；开启固件升级时Broker须要求认证，并只允许发布主机的账号发布 fire_alarm/ota/#
+const char* MQTT_USERNAME = "";
+const char* MQTT_PASSWORD = "";
 
 // MQTT Topics
 const char* MQTT_TOPIC_SENSOR = "fire_alarm/sensor_data";
-const char* MQTT_TOPIC_FAN_CONTROL = "fire_alarm/fan/control";
-const char* MQTT_TOPIC_FAN_MODE = "fire_alarm/fan/mode";
-const char* MQTT_TOPIC_PUMP_CONTROL = "fire_alarm/pump/control";
-const char* MQTT_TOPIC_PUMP_MODE = "fire_alarm/pump/mode";
-const char* MQTT_TOPIC_BUZZER_CONTROL = "fire_alarm/buzzer/control";
-const char* MQTT_TOPIC_BUZZER_MODE = "fire_alarm/buzzer/mode";
+const char* MQTT_TOPIC_FAN_CONTROL = COMMAND_TOPIC_FAN_CONTROL;
+const char* MQTT_TOPIC_FAN_MODE = COMMAND_TOPIC_FAN_MODE;
+const char* MQTT_TOPIC_PUMP_CONTROL = COMMAND_TOPIC_PUMP_CONTROL;
+const char* MQTT_TOPIC_PUMP_MODE = COMMAND_TOPIC_PUMP_MODE;
+const char* MQTT_TOPIC_BUZZER_CONTROL = COMMAND_TOPIC_BUZZER_CONTROL;
+const char* MQTT_TOPIC_BUZZER_MODE = COMMAND_TOPIC_BUZZER_MODE;
+const char* MQTT_TOPIC_ALARM = "fire_alarm/alarm_event";
+const char* MQTT_TOPIC_STATUS = "fire_alarm/status";
+const char* MQTT_TOPIC_CONFIG = COMMAND_TOPIC_CONFIG;
+const char* MQTT_TOPIC_CONFIG_STATE = "fire_alarm/config/state";
+const char* MQTT_TOPIC_SNAPSHOT = "fire_alarm/snapshot";
+const char* MQTT_TOPIC_SNAPSHOT_DATA = "fire_alarm/snapshot/data";
+const char* MQTT_TOPIC_BOOT = "fire_alarm/boot";
 
 // ==================== 全局对象实例 ====================
 WiFiClient espClient;
 PubSubClient mqttClient(espClient);
 TaskHandle_t mqttTaskHandle = NULL;
+TaskHandle_t telemetryTaskHandle = NULL;
+
+// 发布缓冲池：遥测任务序列化完成后通过队列把缓冲区下标交给MQTT任务
+typedef struct {
+    unsigned long captureTime;          // 采集时间
+    char payload[MQTT_TX_BUFFER_SIZE];  // 已序列化的JSON
+} TxBuffer;
+
+static TxBuffer txPool[MQTT_TX_POOL_SIZE];
+static QueueHandle_t txFreeQueue = NULL;    // 空闲缓冲区下标
+static QueueHandle_t txReadyQueue = NULL;   // 待发布缓冲区下标
+static uint32_t txSkipped = 0;              // 缓冲池耗尽而跳过的样本数
+
+MqttLinkStats mqttLinkStats = {
+    .state = LINK_WIFI_DOWN,
+    .attempts = 0,
+    .reconnects = 0,
+    .wifiConnectMs = 0,
+    .mqttConnectMs = 0,
+    .lastOutageMs = 0,
+    .backoffMs = 0
+};
+
+// 状态机内部变量
+static unsigned long phaseStart = 0;        // 当前阶段开始时间
+static unsigned long nextAttemptTime = 0;   // 下次允许尝试的时间
+static unsigned long disconnectedSince = 0; // 断开时间 (用于统计断线时长)
+static uint8_t backoffExponent = 0;         // 退避指数
+
+// 建立Broker连接的子步骤 (MQTT_CONNECTING 状态内，每步都不阻塞)
+typedef enum {
+    BROKER_STEP_IDLE = 0,       // 等待退避到期
+    BROKER_STEP_RESOLVING = 1,  // 异步DNS解析中
+    BROKER_STEP_TCP = 2         // 非阻塞TCP连接中
+} BrokerStep;
+
+// DNS解析结果 (在lwIP线程的回调中写入)
+typedef enum {
+    DNS_RESULT_PENDING = 0,
+    DNS_RESULT_OK = 1,
+    DNS_RESULT_FAILED = 2
+} DnsResult;
+
+static BrokerStep brokerStep = BROKER_STEP_IDLE;
+static unsigned long brokerStepStart = 0;   // 当前子步骤开始时间
+static unsigned long attemptStart = 0;      // 本次连接尝试开始时间
+static int brokerFd = -1;                   // 连接中的Socket
+static volatile uint8_t dnsResult = DNS_RESULT_PENDING;
+static volatile uint32_t dnsAddr = 0;       // 解析结果 (IPv4，网络字节序)
+static volatile uint32_t dnsGeneration = 0; // 解析批次，丢弃已放弃的解析迟到的回调
+
+// 遗嘱/上线消息 (retained)
+static char presenceOffline[96];
+static char presenceOnline[128];
+
+static void publishConfigStateIfChanged(bool force);
+static void publishBootReportOnce();
 
 // ==================== WiFi连接功能 ====================
 
+/**
+ * @brief 发起WiFi连接（不等待结果）
+ *
+ * 连接结果、超时与重试由 updateMqttConnection 的状态机处理，
+ * setup 不再因WiFi阻塞，布防不受网络影响
+ */
 void setupWiFi() {
     Serial.println();
     Serial.print("Connecting to WiFi: ");
     Serial.println(WIFI_SSID);
 
-    WiFi.disconnect(true);
-    delay(100);
     WiFi.mode(WIFI_STA);
-    delay(100);
     WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-
-    int retryCount = 0;
-    while (WiFi.status() != WL_CONNECTED && retryCount < 40) {
-        delay(500);
-        Serial.print(".");
-        retryCount++;
-    }
-
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("\nWiFi connected!");
-        Serial.print("IP: ");
-        Serial.println(WiFi.localIP());
-    } else {
-        Serial.println("\nWiFi connection failed!");
-    }
 }
 
 // ==================== MQTT连接功能 ====================
@@ -65,30 +141,345 @@ void setupWiFi() {
 void setupMQTT() {
     mqttClient.setServer(MQTT_BROKER, MQTT_PORT);
     mqttClient.setCallback(mqttCallback);
-    mqttClient.setBufferSize(1024);
+    // 报文 = 固定头 + Topic + 负载
+    mqttClient.setBufferSize(MQTT_TX_BUFFER_SIZE + OUTBOX_TOPIC_SIZE + 8);
+    mqttClient.setKeepAlive(MQTT_KEEPALIVE_S);
+    mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT_S);
+
+    // 发布缓冲池
+    txFreeQueue = CREATE_MODULE_QUEUE(MQTT_TX_POOL_SIZE, sizeof(uint8_t));
+    txReadyQueue = CREATE_MODULE_QUEUE(MQTT_TX_POOL_SIZE, sizeof(uint8_t));
+    for (uint8_t i = 0; i < MQTT_TX_POOL_SIZE; i++) {
+        xQueueSend(txFreeQueue, &i, 0);
+    }
+
+    snprintf(presenceOffline, sizeof(presenceOffline),
+             "{\"device_id\":\"%s\",\"status\":\"offline\"}", DEVICE_ID);
+    // 首次立即尝试连接
+    nextAttemptTime = millis();
+    // setupWiFi 已发起连接，由状态机等待结果 (超时后按退避重试)
+    mqttLinkStats.state = (WiFi.status() == WL_CONNECTED) ? LINK_MQTT_CONNECTING : LINK_WIFI_CONNECTING;
+    phaseStart = millis();
+
     Serial.println("[MQTT] Configured: " + String(MQTT_BROKER) + ":" + String(MQTT_PORT));
 }
 
-void reconnectMQTT() {
-    if (WiFi.status() != WL_CONNECTED) {
-        WiFi.reconnect();
-        int retry = 0;
-        while (WiFi.status() != WL_CONNECTED && retry < 10) {
-            vTaskDelay(pdMS_TO_TICKS(500));
-            retry++;
+// ==================== 连接状态机 ====================
+
+static const char* linkStateName(MqttLinkState state) {
+    switch (state) {
+        case LINK_WIFI_CONNECTING: return "wifi_connecting";
+        case LINK_MQTT_CONNECTING: return "mqtt_connecting";
+        case LINK_CONNECTED:       return "connected";
+        default:                   return "wifi_down";
+    }
+}
+
+static void abortBrokerConnect();
+
+static void setLinkState(MqttLinkState state) {
+    if (mqttLinkStats.state != state) {
+        if (mqttLinkStats.state == LINK_MQTT_CONNECTING) {
+            abortBrokerConnect();
         }
-        if (WiFi.status() != WL_CONNECTED) return;
+        Serial.println("[MQTT] Link: " + String(linkStateName(mqttLinkStats.state)) + " -> " + String(linkStateName(state)));
+        mqttLinkStats.state = state;
+        phaseStart = millis();
     }
+}
 
-    while (!mqttClient.connected()) {
-        Serial.print("[MQTT] Connecting...");
-        if (mqttClient.connect(MQTT_CLIENT_ID)) {
-            Serial.println("connected!");
-            subscribeControlTopics();
-        } else {
-            Serial.println("failed, retrying in 5s");
-            vTaskDelay(pdMS_TO_TICKS(5000));
+/**
+ * @brief 计算下一次重试时间（指数退避 + 抖动）
+ *
+ * 退避时间 = [base/2, base] 区间内的随机值，base = MIN * 2^n，上限 MAX
+ * 抖动避免多台设备在Broker恢复后同时重连
+ */
+static void scheduleBackoff() {
+    unsigned long base = MQTT_BACKOFF_MIN_MS << backoffExponent;
+    if (base > MQTT_BACKOFF_MAX_MS) {
+        base = MQTT_BACKOFF_MAX_MS;
+    } else {
+        backoffExponent++;
+    }
+    unsigned long delayMs = base / 2 + random(base / 2 + 1);
+    mqttLinkStats.backoffMs = delayMs;
+    nextAttemptTime = millis() + delayMs;
+    Serial.println("[MQTT] Retry in " + String(delayMs) + "ms");
+}
+
+static bool attemptDue() {
+    return (long)(millis() - nextAttemptTime) >= 0;
+}
+
+// ==================== Broker连接子步骤 ====================
+// PubSubClient::connect 在底层Client未连接时会同步解析域名并建立TCP连接，
+// Broker不可达时阻塞到Socket超时。这里先用异步DNS和非阻塞Socket建好TCP连接，
+// 再交给 espClient，connect 只剩 CONNECT/CONNACK 握手 (最长 MQTT_SOCKET_TIMEOUT_S)
+
+static void dnsFoundCallback(const char* name, const ip_addr_t* addr, void* arg) {
+    if ((uint32_t)(uintptr_t)arg != dnsGeneration) return;
+    if (addr != NULL && IP_IS_V4(addr)) {
+        dnsAddr = ip_2_ip4(addr)->addr;
+        dnsResult = DNS_RESULT_OK;
+    } else {
+        dnsResult = DNS_RESULT_FAILED;
+    }
+}
+
+// 在lwIP线程中发起解析：已缓存或为IP字面量时直接得到结果，否则结果由回调给出
+static void dnsStartInTcpip(void* arg) {
+    ip_addr_t addr;
+    err_t err = dns_gethostbyname(MQTT_BROKER, &addr, dnsFoundCallback, arg);
+    if (err == ERR_OK) {
+        dnsFoundCallback(MQTT_BROKER, &addr, arg);
+    } else if (err != ERR_INPROGRESS) {
+        dnsFoundCallback(MQTT_BROKER, NULL, arg);
+    }
+}
+
+static bool startTcpConnect(uint32_t addr) {
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) return false;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    struct sockaddr_in server;
+    memset(&server, 0, sizeof(server));
+    server.sin_family = AF_INET;
+    server.sin_port = htons(MQTT_PORT);
+    server.sin_addr.s_addr = addr;
+    if (connect(fd, (struct sockaddr*)&server, sizeof(server)) < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return false;
+    }
+    brokerFd = fd;
+    return true;
+}
+
+/**
+ * @brief 查询TCP连接结果（不等待）
+ * @return 1=已连接, 0=进行中, -1=失败
+ */
+static int pollTcpConnect() {
+    fd_set writeSet;
+    FD_ZERO(&writeSet);
+    FD_SET(brokerFd, &writeSet);
+    struct timeval tv = {0, 0};
+    int ready = select(brokerFd + 1, NULL, &writeSet, NULL, &tv);
+    if (ready == 0) return 0;
+    if (ready < 0) return -1;
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(brokerFd, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) return -1;
+    return 1;
+}
+
+/**
+ * @brief 把已连接的Socket交给 espClient
+ *
+ * 与 WiFiClient::connect 一致：恢复阻塞模式并设置收发超时
+ */
+static void adoptBrokerSocket() {
+    fcntl(brokerFd, F_SETFL, fcntl(brokerFd, F_GETFL, 0) & ~O_NONBLOCK);
+    struct timeval timeout = {MQTT_SOCKET_TIMEOUT_S, 0};
+    setsockopt(brokerFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(brokerFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    int noDelay = 1;
+    setsockopt(brokerFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    espClient = WiFiClient(brokerFd);
+    brokerFd = -1;
+}
+
+static void abortBrokerConnect() {
+    if (brokerFd >= 0) {
+        close(brokerFd);
+        brokerFd = -1;
+    }
+    dnsGeneration++;
+    brokerStep = BROKER_STEP_IDLE;
+}
+
+static void startBrokerConnect() {
+    mqttLinkStats.attempts++;
+    attemptStart = millis();
+    // 释放上一次连接遗留的Socket
+    espClient.stop();
+
+    dnsResult = DNS_RESULT_PENDING;
+    uint32_t generation = ++dnsGeneration;
+    if (tcpip_callback(dnsStartInTcpip, (void*)(uintptr_t)generation) != ERR_OK) {
+        dnsResult = DNS_RESULT_FAILED;
+    }
+    brokerStep = BROKER_STEP_RESOLVING;
+    brokerStepStart = millis();
+}
+
+static void failBrokerConnect(const char* reason) {
+    mqttLinkStats.mqttConnectMs = millis() - attemptStart;
+    Serial.println("[MQTT] Connect failed: " + String(reason) +
+                   ", took " + String(mqttLinkStats.mqttConnectMs) + "ms");
+    abortBrokerConnect();
+}
+
+/**
+ * @brief 推进一步Broker连接
+ * @return 1=TCP已连接 (可发起MQTT握手), 0=进行中, -1=本次尝试失败
+ */
+static int stepBrokerConnect() {
+    unsigned long elapsed = millis() - brokerStepStart;
+    switch (brokerStep) {
+        case BROKER_STEP_RESOLVING:
+            if (dnsResult == DNS_RESULT_OK) {
+                if (!startTcpConnect(dnsAddr)) {
+                    failBrokerConnect("socket error");
+                    return -1;
+                }
+                brokerStep = BROKER_STEP_TCP;
+                brokerStepStart = millis();
+            } else if (dnsResult == DNS_RESULT_FAILED) {
+                failBrokerConnect("DNS lookup failed");
+                return -1;
+            } else if (elapsed >= MQTT_DNS_TIMEOUT_MS) {
+                failBrokerConnect("DNS timeout");
+                return -1;
+            }
+            return 0;
+
+        case BROKER_STEP_TCP: {
+            int result = pollTcpConnect();
+            if (result > 0) {
+                adoptBrokerSocket();
+                brokerStep = BROKER_STEP_IDLE;
+                return 1;
+            }
+            if (result < 0) {
+                failBrokerConnect("TCP connect refused or unreachable");
+                return -1;
+            }
+            if (elapsed >= MQTT_TCP_CONNECT_TIMEOUT_MS) {
+                failBrokerConnect("TCP connect timeout");
+                return -1;
+            }
+            return 0;
         }
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 在已建立的TCP连接上完成MQTT握手（带遗嘱消息）
+ *
+ * TCP连接已由 stepBrokerConnect 建好，这里只等待CONNACK，耗时受 MQTT_SOCKET_TIMEOUT_S 限制
+ */
+static bool connectBroker() {
+    bool ok = mqttClient.connect(MQTT_CLIENT_ID, MQTT_USERNAME[0] ? MQTT_USERNAME : NULL,
+                                 MQTT_PASSWORD[0] ? MQTT_PASSWORD : NULL, MQTT_TOPIC_STATUS, 1, true,
+                                 presenceOffline);
+    mqttLinkStats.mqttConnectMs = millis() - attemptStart;
+
+    if (!ok) {
+        Serial.println("[MQTT] Connect failed, rc=" + String(mqttClient.state()) +
+                       ", took " + String(mqttLinkStats.mqttConnectMs) + "ms");
+        return false;
+    }
+
+    // 上线消息覆盖Broker上保留的offline遗嘱 (遗嘱在连接前确定，无法携带时间戳)
+    snprintf(presenceOnline, sizeof(presenceOnline),
+             "{\"device_id\":\"%s\",\"status\":\"online\",\"epoch_us\":%lld}",
+             DEVICE_ID, (long long)timeSyncNowEpochUs());
+    mqttClient.publish(MQTT_TOPIC_STATUS, presenceOnline, true);
+    subscribeControlTopics();
+    timeSyncOnConnect();
+    otaOnConnect();
+    publishConfigStateIfChanged(true);
+    bootMark(BOOT_STAGE_MQTT);
+
+    if (disconnectedSince != 0) {
+        mqttLinkStats.lastOutageMs = millis() - disconnectedSince;
+        mqttLinkStats.reconnects++;
+        disconnectedSince = 0;
+    }
+    Serial.println("[MQTT] Connected in " + String(mqttLinkStats.mqttConnectMs) + "ms");
+    return true;
+}
+
+/**
+ * @brief 推进一步WiFi/MQTT连接状态机（非阻塞）
+ *
+ * 状态流转：
+ * WIFI_DOWN → WIFI_CONNECTING → MQTT_CONNECTING → CONNECTED
+ * MQTT_CONNECTING 内依次为：异步DNS解析 → 非阻塞TCP连接 → MQTT握手
+ * 任一阶段失败都按退避时间等待，期间立即返回，不阻塞调用任务
+ */
+void updateMqttConnection() {
+    bool wifiUp = (WiFi.status() == WL_CONNECTED);
+
+    // 连接丢失检测
+    if (mqttLinkStats.state == LINK_CONNECTED && (!wifiUp || !mqttClient.connected())) {
+        Serial.println("[MQTT] Connection lost");
+        disconnectedSince = millis();
+        backoffExponent = 0;
+        nextAttemptTime = millis();
+        setLinkState(wifiUp ? LINK_MQTT_CONNECTING : LINK_WIFI_DOWN);
+    } else if (!wifiUp && mqttLinkStats.state == LINK_MQTT_CONNECTING) {
+        setLinkState(LINK_WIFI_DOWN);
+    }
+
+    switch (mqttLinkStats.state) {
+        case LINK_WIFI_DOWN:
+            if (wifiUp) {
+                bootMark(BOOT_STAGE_WIFI);
+                setLinkState(LINK_MQTT_CONNECTING);
+            } else if (attemptDue()) {
+                WiFi.reconnect();
+                setLinkState(LINK_WIFI_CONNECTING);
+            }
+            break;
+
+        case LINK_WIFI_CONNECTING:
+            if (wifiUp) {
+                bootMark(BOOT_STAGE_WIFI);
+                mqttLinkStats.wifiConnectMs = millis() - phaseStart;
+                Serial.println("[MQTT] WiFi up in " + String(mqttLinkStats.wifiConnectMs) + "ms");
+                nextAttemptTime = millis();
+                setLinkState(LINK_MQTT_CONNECTING);
+            } else if (millis() - phaseStart >= WIFI_CONNECT_TIMEOUT_MS) {
+                Serial.println("[MQTT] WiFi connect timeout");
+                scheduleBackoff();
+                setLinkState(LINK_WIFI_DOWN);
+            }
+            break;
+
+        case LINK_MQTT_CONNECTING:
+            if (brokerStep == BROKER_STEP_IDLE) {
+                if (attemptDue()) {
+                    startBrokerConnect();
+                }
+                break;
+            }
+            switch (stepBrokerConnect()) {
+                case 1:
+                    if (connectBroker()) {
+                        backoffExponent = 0;
+                        mqttLinkStats.backoffMs = 0;
+                        setLinkState(LINK_CONNECTED);
+                    } else {
+                        scheduleBackoff();
+                    }
+                    break;
+                case -1:
+                    scheduleBackoff();
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        case LINK_CONNECTED:
+            break;
     }
 }
 
@@ -99,209 +490,589 @@ void subscribeControlTopics() {
     mqttClient.subscribe(MQTT_TOPIC_PUMP_MODE);
     mqttClient.subscribe(MQTT_TOPIC_BUZZER_CONTROL);
     mqttClient.subscribe(MQTT_TOPIC_BUZZER_MODE);
+    mqttClient.subscribe(MQTT_TOPIC_CONFIG);
+    mqttClient.subscribe(getTimeSyncResponseTopic());
+#if OTA_ENABLE
+    mqttClient.subscribe(getOtaOfferTopic());
+    mqttClient.subscribe(getOtaDataTopic());
+#endif
     Serial.println("[MQTT] Subscribed to all control topics");
 }
 
 // ==================== MQTT消息回调 ====================
 
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
+    // 时钟同步应答的到达时刻 (t4) 需在任何耗时操作之前记录
+    int64_t arrivalUs = esp_timer_get_time();
+
+    // 升级数据块为二进制且较大，不复制、不打印
+    if (otaHandleMessage(topic, payload, length)) return;
+
     char message[length + 1];
     memcpy(message, payload, length);
     message[length] = '\0';
+
+    // 时钟同步应答只走MQTT通道，且频繁，不打印
+    if (timeSyncHandleMessage(topic, message, arrivalUs)) return;
     
     Serial.println("[MQTT] Received: " + String(topic) + " -> " + String(message));
-    
-    if (strcmp(topic, MQTT_TOPIC_FAN_CONTROL) == 0) {
-        handleFanControlCommand(message);
-    } else if (strcmp(topic, MQTT_TOPIC_FAN_MODE) == 0) {
-        handleFanModeCommand(message);
-    } else if (strcmp(topic, MQTT_TOPIC_PUMP_CONTROL) == 0) {
-        handlePumpControlCommand(message);
-    } else if (strcmp(topic, MQTT_TOPIC_PUMP_MODE) == 0) {
-        handlePumpModeCommand(message);
-    } else if (strcmp(topic, MQTT_TOPIC_BUZZER_CONTROL) == 0) {
-        handleBuzzerControlCommand(message);
-    } else if (strcmp(topic, MQTT_TOPIC_BUZZER_MODE) == 0) {
-        handleBuzzerModeCommand(message);
+
+    dispatchCommand(topic, message);
+}
+
+// ==================== 命令执行 ====================
+
+static void executeFanCommand(const ControlCommand* command) {
+    switch (command->action) {
+        case COMMAND_ACTION_ON:     fanOn(); break;
+        case COMMAND_ACTION_OFF:    fanOff(); break;
+        case COMMAND_ACTION_AUTO:   setFanMode(FAN_MODE_AUTO); break;
+        case COMMAND_ACTION_MANUAL: setFanMode(FAN_MODE_MANUAL); break;
+        default: break;
     }
 }
 
-// ==================== 风扇命令处理 ====================
+static void executePumpCommand(const ControlCommand* command) {
+    switch (command->action) {
+        // 脉冲参数缺失时默认喷水 PUMP_MANUAL_SPRAY_MS（受最大持续时间限制）
+        case COMMAND_ACTION_ON:     pumpSprayPattern(command->onMs, command->offMs, command->cycles); break;
+        case COMMAND_ACTION_OFF:    pumpOff(); break;
+        case COMMAND_ACTION_AUTO:   setPumpMode(PUMP_MODE_AUTO); break;
+        case COMMAND_ACTION_MANUAL: setPumpMode(PUMP_MODE_MANUAL); break;
+        default: break;
+    }
+}
 
-void handleFanControlCommand(const char* payload) {
-    JsonDocument doc;
-    if (deserializeJson(doc, payload)) return;
-    
-    const char* action = doc["action"];
-    if (!action) return;
-    
-    if (isFanAutoMode()) {
+static void executeBuzzerCommand(const ControlCommand* command) {
+    switch (command->action) {
+        case COMMAND_ACTION_ON:
+            if (command->pattern == COMMAND_PATTERN_SMOKE) buzzerPlay(BUZZER_PATTERN_SMOKE);
+            else if (command->pattern == COMMAND_PATTERN_CONTINUOUS) buzzerPlay(BUZZER_PATTERN_CONTINUOUS);
+            else buzzerPlay(BUZZER_PATTERN_EVACUATION);
+            break;
+        case COMMAND_ACTION_OFF:    buzzerOff(); break;
+        case COMMAND_ACTION_AUTO:   setBuzzerMode(BUZZER_MODE_AUTO); break;
+        case COMMAND_ACTION_MANUAL: setBuzzerMode(BUZZER_MODE_MANUAL); break;
+        default: break;
+    }
+}
+
+/**
+ * @brief 按Topic分发控制命令
+ *
+ * MQTT回调与本地服务器共用此入口，保证两条通道的命令语义一致；
+ * 解码规则见 MY_CommandCore.h (主机端负载生成器使用同一份实现)
+ * @return true=Topic已识别
+ */
+bool dispatchCommand(const char* topic, const char* message) {
+    ControlCommand command;
+    if (!commandDecode(topic, message, strlen(message), &command)) return false;
+
+    if (command.topic == COMMAND_CONFIG) {
+        handleConfigCommand(message);
+        return true;
+    }
+    if (command.action == COMMAND_ACTION_NONE) return true;
+
+    // 自动模式下忽略控制命令 (模式命令总是执行)
+    if (command.topic == COMMAND_FAN_CONTROL && isFanAutoMode()) {
         Serial.println("[MQTT] Fan control ignored - AUTO mode");
-        return;
+    } else if (command.topic == COMMAND_PUMP_CONTROL && isPumpAutoMode()) {
+        Serial.println("[MQTT] Pump control ignored - AUTO mode");
+    } else if (command.topic == COMMAND_BUZZER_CONTROL && isBuzzerAutoMode()) {
+        Serial.println("[MQTT] Buzzer control ignored - AUTO mode");
+    } else if (command.topic == COMMAND_FAN_CONTROL || command.topic == COMMAND_FAN_MODE) {
+        executeFanCommand(&command);
+    } else if (command.topic == COMMAND_PUMP_CONTROL || command.topic == COMMAND_PUMP_MODE) {
+        executePumpCommand(&command);
+    } else {
+        executeBuzzerCommand(&command);
     }
-    
-    if (strcmp(action, "on") == 0) fanOn();
-    else if (strcmp(action, "off") == 0) fanOff();
+    return true;
 }
 
-void handleFanModeCommand(const char* payload) {
-    JsonDocument doc;
-    if (deserializeJson(doc, payload)) return;
-    
-    const char* action = doc["action"];
-    if (!action) return;
-    
-    if (strcmp(action, "auto") == 0) setFanMode(FAN_MODE_AUTO);
-    else if (strcmp(action, "manual") == 0) setFanMode(FAN_MODE_MANUAL);
+// ==================== 配置命令处理 ====================
+
+/**
+ * @brief 处理运行时配置更新
+ *
+ * 校验失败时保留原配置；无论成功与否，MQTT任务都会重新发布 config/state
+ */
+void handleConfigCommand(const char* payload) {
+    char error[64] = "";
+    if (!applyConfigJson(payload, error, sizeof(error))) {
+        Serial.println("[MQTT] Config update rejected: " + String(error));
+    }
 }
 
-// ==================== 水泵命令处理 ====================
+/**
+ * @brief 配置有变化（修订号或拒绝次数）时发布当前配置（在MQTT任务中调用）
+ */
+static void publishConfigStateIfChanged(bool force) {
+    static uint32_t reportedRevision = 0xFFFFFFFF;
+    static uint32_t reportedRejects = 0xFFFFFFFF;
 
-void handlePumpControlCommand(const char* payload) {
-    JsonDocument doc;
-    if (deserializeJson(doc, payload)) return;
-    
-    const char* action = doc["action"];
-    if (!action) return;
-    
-    if (isPumpAutoMode()) {
-        Serial.println("[MQTT] Pump control ignored - AUTO mode");
+    uint32_t revision = getConfig()->revision;
+    uint32_t rejects = getConfigRejectCount();
+    if (!force && revision == reportedRevision && rejects == reportedRejects) {
         return;
     }
-    
-    if (strcmp(action, "on") == 0) {
-        // 手动模式下喷水10秒
-        pumpSpray(10000);
-    } else if (strcmp(action, "off") == 0) {
-        pumpOff();
+
+    String payload = createConfigJson();
+    if (mqttClient.publish(MQTT_TOPIC_CONFIG_STATE, payload.c_str(), true)) {
+        reportedRevision = revision;
+        reportedRejects = rejects;
     }
 }
 
-void handlePumpModeCommand(const char* payload) {
-    JsonDocument doc;
-    if (deserializeJson(doc, payload)) return;
-    
-    const char* action = doc["action"];
-    if (!action) return;
-    
-    if (strcmp(action, "auto") == 0) setPumpMode(PUMP_MODE_AUTO);
-    else if (strcmp(action, "manual") == 0) setPumpMode(PUMP_MODE_MANUAL);
+/**
+ * @brief 发布启动报告（每次启动一次）
+ *
+ * 等到布防后发布，使报告包含完整的布防耗时；
+ * 超过 BOOT_FIRST_SAMPLE_WAIT_MS 仍未布防时照常发布 (armed_ok 为false)
+ */
+static void publishBootReportOnce() {
+    BootStatus status = getBootStatus();
+    if (status.reported) return;
+    if (!status.armed && esp_timer_get_time() / 1000 < BOOT_FIRST_SAMPLE_WAIT_MS) return;
+
+    char payload[384];
+    size_t len = buildBootReport(payload, sizeof(payload));
+    if (len > 0 && mqttClient.publish(MQTT_TOPIC_BOOT, payload)) {
+        bootMarkReported();
+        Serial.println("[BOOT] Report published: " + String(payload));
+    }
 }
 
-// ==================== 蜂鸣器命令处理 ====================
+// ==================== 数据发布功能 ====================
 
-void handleBuzzerControlCommand(const char* payload) {
-    JsonDocument doc;
-    if (deserializeJson(doc, payload)) return;
-    
-    const char* action = doc["action"];
-    if (!action) return;
-    
-    if (isBuzzerAutoMode()) {
-        Serial.println("[MQTT] Buzzer control ignored - AUTO mode");
+/**
+ * @brief 序列化传感器数据并交给MQTT任务发布（在遥测任务中调用）
+ *
+ * 序列化在低优先级的遥测任务中完成，MQTT任务只负责发送已完成的缓冲区
+ */
+void publishSensorData(float temperature, float humidity, float smokeLevel, bool smokeAlarm) {
+    uint8_t index;
+    if (xQueueReceive(txFreeQueue, &index, pdMS_TO_TICKS(MQTT_PUBLISH_INTERVAL_MS / 2)) != pdTRUE) {
+        // MQTT任务未及时取走缓冲区，跳过本次样本
+        txSkipped++;
         return;
     }
-    
-    if (strcmp(action, "on") == 0) buzzerOn();
-    else if (strcmp(action, "off") == 0) buzzerOff();
+
+    TxBuffer* buffer = &txPool[index];
+    buffer->captureTime = millis();
+    size_t length = createJsonPayload(buffer->payload, sizeof(buffer->payload), temperature, humidity, smokeLevel, smokeAlarm);
+    if (length == 0) {
+        // 负载超出缓冲区，归还缓冲区并计入跳过
+        txSkipped++;
+        xQueueSend(txFreeQueue, &index, 0);
+        return;
+    }
+
+#if LOCAL_SERVER_ENABLE
+    // 同一缓冲区推送给局域网SSE客户端
+    localServerBroadcast(buffer->payload, length);
+#else
+    (void)length;
+#endif
+
+    xQueueSend(txReadyQueue, &index, portMAX_DELAY);
 }
 
-void handleBuzzerModeCommand(const char* payload) {
-    JsonDocument doc;
-    if (deserializeJson(doc, payload)) return;
-    
-    const char* action = doc["action"];
-    if (!action) return;
-    
-    if (strcmp(action, "auto") == 0) setBuzzerMode(BUZZER_MODE_AUTO);
-    else if (strcmp(action, "manual") == 0) setBuzzerMode(BUZZER_MODE_MANUAL);
+/**
+ * @brief 发送一个已序列化的遥测缓冲区（在MQTT任务中调用）
+ *
+ * 已连接且无积压遥测时直接发布；否则进入离线缓存队列，
+ * 保证补发顺序与采集顺序一致
+ */
+static void publishTxBuffer(uint8_t index) {
+    TxBuffer* buffer = &txPool[index];
+
+    bool published = false;
+    if (mqttClient.connected() && !outboxHasTelemetry()) {
+        published = mqttClient.publish(MQTT_TOPIC_SENSOR, buffer->payload);
+        if (published) {
+            Serial.println("[MQTT] Published sensor data");
+        }
+    }
+    if (!published) {
+        outboxPush(OUTBOX_CLASS_TELEMETRY, MQTT_TOPIC_SENSOR, buffer->payload, buffer->captureTime);
+    }
+
+    xQueueSend(txFreeQueue, &index, 0);
 }
 
+/**
+ * @brief 离线缓存队列的补发回调
+ */
+static bool publishQueuedMessage(const char* topic, const char* payload) {
+    return mqttClient.publish(topic, payload);
+}
 
-// ==================== 数据发布功能 ====================
+/**
+ * @brief 生成报警事件并放入离线缓存队列
+ *
+ * 报警事件始终经队列发布（由MQTT任务统一补发），
+ * 因此可以在任意任务中调用
+ *
+ * @param source 事件来源 (k230 / pump / fan ...)
+ * @param event 事件名称 (fire_confirmed / fire_cleared ...)
+ */
+void queueAlarmEvent(const char* source, const char* event) {
+    queueAlarmEvent(source, event, NULL);
+}
 
-void publishSensorData(float temperature, float humidity, float smokeLevel, bool smokeAlarm) {
-    if (!mqttClient.connected()) return;
+/**
+ * @brief 生成带分区名称的报警事件
+ * @param zone 分区名称，NULL时不带 zone 字段
+ */
+void queueAlarmEvent(const char* source, const char* event, const char* zone) {
+    unsigned long captureTime = millis();
+    int64_t epochUs = timeSyncNowEpochUs();
 
-    String payload = createJsonPayload(temperature, humidity, smokeLevel, smokeAlarm);
-    
-    if (mqttClient.publish(MQTT_TOPIC_SENSOR, payload.c_str())) {
-        Serial.println("[MQTT] Published sensor data");
+    JsonDocument doc;
+    doc["device_id"] = DEVICE_ID;
+    doc["source"] = source;
+    doc["event"] = event;
+    if (zone != NULL) {
+        doc["zone"] = zone;
     }
+    doc["timestamp"] = captureTime;
+    doc["epoch_us"] = epochUs;
+
+    String payload;
+    serializeJson(doc, payload);
+
+    outboxPush(OUTBOX_CLASS_ALARM, MQTT_TOPIC_ALARM, payload.c_str(), captureTime);
 }
 
+// 一条遥测及其字段引用的存储 (遥测任务与本地服务器各自在栈上构造)
+typedef struct {
+    SensorPayload payload;
+    SensorPayloadZone zones[ZONE_COUNT];
+    K230Health vision;              // payload.k230Model 指向其中的 modelId
+} SensorPayloadStorage;
+
 /**
- * @brief 创建JSON格式的传感器数据负载
+ * @brief 收集遥测各字段 (字段顺序与取整规则见 MY_SensorPayload.h)
  * 
- * 包含传感器数据、风扇状态和水泵状态
+ * 包含传感器数据、执行器状态、融合评估与各模块统计
  */
-String createJsonPayload(float temperature, float humidity, float smokeLevel, bool smokeAlarm) {
-    JsonDocument doc;
-    
-    doc["device_id"] = DEVICE_ID;
-    doc["temperature"] = round(temperature * 10.0) / 10.0;
-    doc["humidity"] = round(humidity * 10.0) / 10.0;
-    doc["smoke_level"] = round(smokeLevel * 10.0) / 10.0;
-    doc["smoke_alarm"] = smokeAlarm;
-    
+static void collectSensorPayload(SensorPayloadStorage* storage, float temperature, float humidity,
+                                 float smokeLevel, bool smokeAlarm) {
+    SensorPayload* p = &storage->payload;
+    memset(p, 0, sizeof(*p));
+    p->deviceId = DEVICE_ID;
+    p->temperature = temperature;
+    p->humidity = humidity;
+    p->smokeLevel = smokeLevel;
+    p->smokeAlarm = smokeAlarm;
+
     // 风扇状态
-    doc["fan_state"] = getFanStateString();
-    doc["fan_mode"] = getFanModeString();
-    
+    p->fanState = getFanStateString();
+    p->fanMode = getFanModeString();
+    p->fanSpeed = getFanSpeed();
+    p->fanPurging = isFanPurging();
+
     // 水泵状态
-    doc["pump_state"] = getPumpStateString();
-    doc["pump_mode"] = getPumpModeString();
-    
+    p->pumpState = getPumpStateString();
+    p->pumpMode = getPumpModeString();
+    p->pumpRelay = isPumpRelayOn();
+    p->pumpPulsesLeft = getPumpPulsesRemaining();
+    p->pumpTimerLateUs = getPumpTimerMaxLateUs();
+    p->pumpHeld = isPumpSprayHeld();
+    p->pumpHolds = getPumpSprayHoldCount();
+    PumpDutyStatus duty = getPumpDutyStatus();
+    p->pumpDutyUsedMs = duty.usedMs;
+    p->pumpDutyCapMs = duty.capMs;
+    p->pumpDutyBudgetMs = duty.budgetMs;
+    p->pumpDutyRecoverMs = duty.recoverMs;
+
     // K230视觉火焰检测状态
-    doc["k230_fire"] = getK230FireStateString();
-    doc["k230_fire_detected"] = isK230FireDetected();
+    p->k230Fire = getK230FireStateString();
+    p->k230FireDetected = isK230FireDetected();
+
+    // K230视觉链路健康状态 (心跳)
+    K230Health& vision = storage->vision;
+    vision = getK230Health();
+    p->k230Link = getK230LinkStateString(vision.linkState);
+    p->k230Fps = vision.fps;
+    p->k230Frames = vision.frames;
+    p->k230InferMs = vision.inferMs;
+    p->k230InferAvgMs = vision.inferAvgMs;
+    p->k230InferMaxMs = vision.inferMaxMs;
+    p->k230Model = vision.modelId;
+    p->k230HeartbeatAgeMs = vision.heartbeats > 0 ? (int64_t)(millis() - vision.lastHeartbeatTime) : -1;
+    p->k230Faults = vision.faults;
+    p->k230Restarts = vision.restarts;
+
+    // K230上报档位与已确认的上报间隔 (未确认为-1)
+    K230ControlStatus k230Ctrl = getK230ControlStatus();
+    p->k230ReportMode = getK230ReportModeString(k230Ctrl.mode);
+    p->k230ReportMs = k230Ctrl.synced ? (int64_t)k230Ctrl.applied.intervalMs : -1;
+
+    // K230串口链路速率与检测快照
+    K230LinkStats k230Link = getK230LinkStats();
+    p->k230Baud = k230Link.baudRate;
+    p->k230RxBps = k230Link.rxBytesPerSec;
+    p->k230CrcErrors = k230Link.crcErrors;
+    SnapshotStats snapshot = getSnapshotStats();
+    p->snapshots = snapshot.published;
+    p->snapshotBytes = snapshot.lastBytes;
+    p->snapshotAssemblyMs = snapshot.lastAssemblyMs;
+    p->snapshotKBps = snapshot.lastRateKBps;
+
+    // 火灾置信度融合评估 (传感器任务最近一次的结果)
+    FireAssessment fire = fusionAssessment();
+    p->fireScore = fire.score;
+    p->fireLevel = getFireLevelName(fire.level);
+    p->fireZone = getZoneName(fire.zone);
+    memcpy(p->fireEvidence, fire.evidence, sizeof(p->fireEvidence));
     
     // 蜂鸣器状态
-    doc["buzzer_state"] = getBuzzerStateString();
-    doc["buzzer_mode"] = getBuzzerModeString();
-    
-    doc["timestamp"] = millis();
+    p->buzzerState = getBuzzerStateString();
+    p->buzzerMode = getBuzzerModeString();
+    p->buzzerPattern = getBuzzerPatternString();
+
+    // 各分区读数、火灾等级与分区执行器 (顶层字段为第0区，保持与APP兼容)
+    ZoneCycleStats cycle = getZoneCycleStats();
+    p->zoneSampleUs = cycle.sampleUs;
+    p->zoneSampleMaxUs = cycle.sampleMaxUs;
+    p->zoneEvalUs = cycle.evalUs;
+    p->zoneEvalMaxUs = cycle.evalMaxUs;
+    DspStatus dspStatus = getDspStatus();
+    p->dspPipeline = getDspPipelineString();
+    p->dspUs = dspStatus.smokeUs;
+    p->dspMaxUs = dspStatus.smokeMaxUs;
+    ClassifierStatus clsStatus = getClassifierStatus();
+    p->clsModel = clsStatus.modelVersion;
+    p->clsUs = clsStatus.lastUs;
+    p->clsMaxUs = clsStatus.maxUs;
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        SensorData data = getSensorData(z);
+        FireAssessment zoneFire = fusionZoneAssessment(z);
+        SensorPayloadZone* zone = &storage->zones[z];
+        zone->name = getZoneName(z);
+        zone->temperature = data.temperature;
+        zone->humidity = data.humidity;
+        zone->smokeLevel = data.smokeLevel;
+        zone->smokeAlarm = data.smokeAlarm;
+        zone->fireScore = zoneFire.score;
+        zone->fireLevel = getFireLevelName(zoneFire.level);
+        zone->fan = isZoneFanOn(z);
+        zone->valve = isZoneValveOpen(z);
+
+        // 窗口特征 (采满一个窗口后才有)
+        DspZoneFeatures features = getDspFeatures(z);
+        zone->smokeValid = features.smokeValid;
+        zone->smoke = features.smoke;
+        zone->smokeBandCount = DSP_SMOKE_BAND_COUNT;
+        zone->tempValid = features.tempValid;
+        zone->temp = features.temp;
+
+        // 场景分类
+        ClsZoneResult cls = getClassifierResult(z);
+        zone->clsValid = cls.valid;
+        zone->clsClass = clsClassString(cls.result.label);
+        zone->pNuisance = cls.result.prob[CLS_CLASS_NUISANCE];
+        zone->pFire = cls.result.prob[CLS_CLASS_FIRE];
+    }
+    p->zones = storage->zones;
+    p->zoneCount = ZONE_COUNT;
+
+    // 电源管理与唤醒延迟
+    PowerStatus power = getPowerStatus();
+    p->powerMode = getPowerModeString();
+    p->powerHolds = power.holdMask;
+    p->powerFullPct = power.fullPowerPct;
+    p->wakeSmokeUs = power.smokeWake.lastUs;
+    p->wakeSmokeMaxUs = power.smokeWake.maxUs;
+    p->wakeK230Us = power.k230Wake.lastUs;
+    p->wakeK230MaxUs = power.k230Wake.maxUs;
+
+    // 任务监控
+    p->deadlineMisses = getSupervisorTotalMisses();
+    p->resetReason = getLastResetReason();
+
+    // 固件版本与升级状态
+    OtaStatus ota = getOtaStatus();
+    p->fwVersion = FIRMWARE_VERSION;
+    p->otaState = getOtaStateString(ota.state);
+    p->otaBoot = otaBootStateString(ota.boot.state);
+    p->bootArmedMs = getBootStatus().stageMs[BOOT_STAGE_ARMED];
+
+    // 内部RAM堆碎片
+    HeapStatus heap = getHeapStatus();
+    p->heapFree = heap.freeBytes;
+    p->heapLargest = heap.largestBlock;
+    p->heapMinFree = heap.minFreeBytes;
+    p->heapFragPct = heap.fragPct;
+    p->heapFragMaxPct = heap.maxFragPct;
     
-    JsonObject unit = doc["unit"].to<JsonObject>();
-    unit["temperature"] = "celsius";
-    unit["humidity"] = "percent";
-    unit["smoke_level"] = "percent";
+    p->timestamp = millis();
+
+    // 参考时钟纪元微秒 (0=未同步) 及其不确定度
+    TimeSyncStatus timeSync = getTimeSyncStatus();
+    p->epochUs = timeSyncNowEpochUs();
+    p->clockUncertaintyUs = timeSync.uncertaintyUs;
+    p->clockDriftPpm = timeSync.driftPpm;
 
+    // 离线缓存队列状态
+    p->outboxDepth = getOutboxDepth();
+    p->outboxDropped = getOutboxDropped();
+    p->txSkipped = txSkipped;
+
+    // 连接统计
+    p->mqttReconnects = mqttLinkStats.reconnects;
+    p->wifiConnectMs = mqttLinkStats.wifiConnectMs;
+    p->mqttConnectMs = mqttLinkStats.mqttConnectMs;
+    p->lastOutageMs = mqttLinkStats.lastOutageMs;
+}
+
+/**
+ * @brief 创建JSON格式的传感器数据负载
+ */
+String createJsonPayload(float temperature, float humidity, float smokeLevel, bool smokeAlarm) {
+    char* buffer = (char*)malloc(MQTT_TX_BUFFER_SIZE);
+    if (buffer == NULL) return String();
     String payload;
-    serializeJson(doc, payload);
-    
+    if (createJsonPayload(buffer, MQTT_TX_BUFFER_SIZE, temperature, humidity, smokeLevel, smokeAlarm) > 0) {
+        payload = buffer;
+    }
+    free(buffer);
     return payload;
 }
 
+/**
+ * @brief 创建JSON格式的传感器数据负载（写入调用方提供的缓冲区）
+ *
+ * 放不下时不截断，记录错误并返回0 (调用方据此跳过发布)
+ * @return 写入的字节数（不含结尾0）
+ */
+size_t createJsonPayload(char* buffer, size_t size, float temperature, float humidity, float smokeLevel, bool smokeAlarm) {
+    SensorPayloadStorage storage;
+    collectSensorPayload(&storage, temperature, humidity, smokeLevel, smokeAlarm);
+    size_t needed = sensorPayloadBuild(&storage.payload, buffer, size);
+    if (needed >= size) {
+        Serial.println("[MQTT] sensor_data payload too large: " + String(needed) + " >= " +
+                       String(size) + " bytes, not published");
+        if (size > 0) buffer[0] = '\0';
+        return 0;
+    }
+    return needed;
+}
+
+/**
+ * @brief 序列化到固定缓冲区
+ *
+ * 超出缓冲区时serializeJson会截断为非法JSON，改为整条放弃并提示调整缓冲区
+ * @return 写入的字节数（不含结尾0），放不下时为0
+ */
+size_t serializeJsonChecked(const JsonDocument& doc, char* buffer, size_t size, const char* what) {
+    size_t needed = measureJson(doc);
+    if (needed >= size) {
+        Serial.println("[MQTT] " + String(what) + " payload too large: " + String(needed) + " >= " +
+                       String(size) + " bytes, not published");
+        if (size > 0) buffer[0] = '\0';
+        return 0;
+    }
+    return serializeJson(doc, buffer, size);
+}
+
 // ==================== MQTT FreeRTOS任务 ====================
 
+/**
+ * @brief 等待Socket可读，最长等待 timeoutMs
+ *
+ * 有入站数据时立即返回，使APP命令无需等待固定周期
+ */
+static void waitForInbound(uint32_t timeoutMs) {
+    int fd = espClient.fd();
+    if (fd < 0) {
+        vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+        return;
+    }
+
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(fd, &readSet);
+    struct timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = timeoutMs * 1000;
+    select(fd + 1, &readSet, NULL, NULL, &tv);
+}
+
+/**
+ * @brief MQTT收发任务
+ *
+ * 独占mqttClient，负责：
+ * 1. 推进连接状态机
+ * 2. 处理入站命令（Socket可读即处理）
+ * 3. 发送遥测任务交来的缓冲区和离线缓存队列中的消息
+ */
 void mqttTask(void *pvParameters) {
     Serial.println("[MQTT] Task started on Core " + String(xPortGetCoreID()));
 
     for (;;) {
-        if (!mqttClient.connected()) {
-            reconnectMQTT();
+        // 连接状态机：每次推进一步，不会阻塞整个周期
+        updateMqttConnection();
+
+        if (mqttClient.connected()) {
+            // 一次处理完已到达的所有报文
+            uint8_t packets = 0;
+            do {
+                mqttClient.loop();
+            } while (espClient.available() > 0 && ++packets < MQTT_RX_MAX_PACKETS);
+
+            // 补发离线期间积压的消息（报警事件优先）
+            outboxDrain(publishQueuedMessage);
+
+            // 配置变化后上报
+            publishConfigStateIfChanged(false);
+
+            // 本次启动的分阶段耗时 (每次启动发布一次)
+            publishBootReportOnce();
+
+            // 时钟同步请求
+            timeSyncPoll();
+
+            // 固件升级：试运行签到、状态与进度应答
+            otaPoll();
         }
-        
-        mqttClient.loop();
-
-        //获取传感器数据
-        float temperature;
-        float humidity;
-        float smokeLevel; 
-        bool smokeAlarm;
-        if(xSemaphoreTake(sensorMutex, portMAX_DELAY)==pdTRUE){
-            temperature = sensorData.temperature;
-            humidity = sensorData.humidity;
-            smokeLevel = sensorData.smokeLevel;
-            smokeAlarm = sensorData.smokeAlarm;
-            xSemaphoreGive(sensorMutex);
+
+        // 检测快照：每轮最多一块，断线时丢弃发布中的快照
+        snapshotPublishStep();
+
+        // 发送已序列化的遥测数据
+        uint8_t index;
+        while (xQueueReceive(txReadyQueue, &index, 0) == pdTRUE) {
+            publishTxBuffer(index);
         }
 
-        if (!isnan(humidity) && !isnan(temperature)) {
-            publishSensorData(temperature, humidity, smokeLevel, smokeAlarm);
+        if (mqttClient.connected()) {
+            waitForInbound(MQTT_RX_WAIT_MS);
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(MQTT_TASK_PERIOD_MS));
         }
+    }
+}
+
+/**
+ * @brief 遥测任务（低优先级）
+ *
+ * 固定周期采样传感器数据并序列化，序列化完成的缓冲区通过队列交给MQTT任务
+ */
+void telemetryTask(void *pvParameters) {
+    Serial.println("[MQTT] Telemetry task started on Core " + String(xPortGetCoreID()));
+
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;) {
+        //获取传感器数据（顶层字段为第0区，各分区读数在 zones 数组中）
+        // 不再因第0区DHT11读取失败跳过整条遥测，失败的读数序列化为null
+        SensorData data = getSensorData(0);
+        publishSensorData(data.temperature, data.humidity, data.smokeLevel, data.smokeAlarm);
 
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(MQTT_PUBLISH_INTERVAL_MS));
     }
 }
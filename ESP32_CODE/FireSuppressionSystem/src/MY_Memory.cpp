@@ -0,0 +1,86 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include "MY_Memory.h"
+
+// ==================== 全局变量定义 ====================
+
+// 已登记的任务 (只在setup()中创建任务时写入)
+typedef struct {
+    TaskHandle_t handle;
+    const char* name;
+    uint32_t stackBytes;
+} TrackedTask;
+
+static TrackedTask trackedTasks[MEMORY_MAX_TRACKED_TASKS];
+static uint8_t trackedCount = 0;
+
+static portMUX_TYPE heapMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t maxFragPct = 0;
+
+// ==================== 任务登记 ====================
+
+/**
+ * @brief 登记任务，用于栈高水位报告
+ * @return 原样返回任务句柄，便于在创建宏中直接赋值
+ */
+TaskHandle_t memoryTrackTask(TaskHandle_t handle, const char* name, uint32_t stackBytes) {
+    if (handle == NULL) {
+        Serial.println("[MEM] Failed to create task " + String(name));
+    } else if (trackedCount < MEMORY_MAX_TRACKED_TASKS) {
+        trackedTasks[trackedCount].handle = handle;
+        trackedTasks[trackedCount].name = name;
+        trackedTasks[trackedCount].stackBytes = stackBytes;
+        trackedCount++;
+    }
+    return handle;
+}
+
+// ==================== 状态获取函数 ====================
+
+/**
+ * @brief 获取内部RAM堆状态
+ * PSRAM只存放离线缓存等长期对象，碎片只统计内部RAM
+ */
+HeapStatus getHeapStatus() {
+    const uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    HeapStatus status;
+    status.freeBytes = heap_caps_get_free_size(caps);
+    status.largestBlock = heap_caps_get_largest_free_block(caps);
+    status.minFreeBytes = heap_caps_get_minimum_free_size(caps);
+    status.fragPct = status.freeBytes > 0
+        ? (uint8_t)(100 - (uint64_t)status.largestBlock * 100 / status.freeBytes)
+        : 0;
+
+    portENTER_CRITICAL(&heapMux);
+    if (status.fragPct > maxFragPct) {
+        maxFragPct = status.fragPct;
+    }
+    status.maxFragPct = maxFragPct;
+    portEXIT_CRITICAL(&heapMux);
+
+    return status;
+}
+
+// ==================== 报告 ====================
+
+/**
+ * @brief 打印堆碎片与各任务栈用量
+ * 建议栈大小 = 实际最大用量 + 余量，按256字节取整
+ */
+void printMemoryReport() {
+    HeapStatus heap = getHeapStatus();
+    Serial.println("Heap:  Free=" + String(heap.freeBytes) + ", Largest=" + String(heap.largestBlock) +
+                   ", MinFree=" + String(heap.minFreeBytes) + ", Frag=" + String(heap.fragPct) +
+                   "% (max " + String(heap.maxFragPct) + "%)" +
+                   (STATIC_ALLOCATION_ENABLE ? " [static]" : ""));
+
+    for (uint8_t i = 0; i < trackedCount; i++) {
+        const TrackedTask* task = &trackedTasks[i];
+        // ESP-IDF中高水位以字节为单位
+        uint32_t unused = uxTaskGetStackHighWaterMark(task->handle);
+        uint32_t used = task->stackBytes > unused ? task->stackBytes - unused : 0;
+        uint32_t suggested = (used + MEMORY_STACK_MARGIN_BYTES + 255) & ~255UL;
+        Serial.println("Stack: " + String(task->name) + " used " + String(used) + "/" +
+                       String(task->stackBytes) + " (suggest " + String(suggested) + ")");
+    }
+}
@@ -0,0 +1,694 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <esp_image_format.h>
+#include <esp_system.h>
+#include "MY_Ota.h"
+#include "MY_OtaKey.h"
+#include "MY_MQTT.h"
+#include "MY_Memory.h"
+#include "MY_Fusion.h"
+#include "MY_Supervisor.h"
+#include "MY_TimeSync.h"
+
+// 数据块需能放进 PubSubClient 的接收缓冲区 (与发送共用，见 setupMQTT)
+static_assert(OTA_DATA_HEADER_SIZE + OTA_CHUNK_MAX <= MQTT_TX_BUFFER_SIZE, "OTA chunk exceeds MQTT buffer");
+
+// 没有公钥时设备无法校验补丁来源，不允许开启升级
+#if OTA_ENABLE && !OTA_SIGNING_KEY_SET
+#error "OTA_ENABLE requires a signing key: run HOST_CODE/Ota/build/ota_keygen -H include/MY_OtaKey.h <key>"
+#endif
+
+// ==================== 全局变量定义 ====================
+TaskHandle_t otaTaskHandle = NULL;
+SemaphoreHandle_t otaMutex = NULL;
+
+static OtaStatus otaStatus = {};
+static uint8_t runningSha[SHA256_DIGEST_SIZE];
+static char offerTopic[OUTBOX_TOPIC_SIZE];
+static char dataTopic[OUTBOX_TOPIC_SIZE];
+
+// 接收缓冲池：MQTT回调复制数据块后通过队列把下标交给OTA任务，写入后归还
+typedef struct {
+    uint16_t otaId;
+    uint32_t index;
+    uint16_t length;
+    uint8_t data[OTA_CHUNK_MAX];
+} OtaRxSlot;
+
+static OtaRxSlot rxSlots[OTA_RX_SLOTS];
+static QueueHandle_t rxFreeQueue = NULL;
+static QueueHandle_t rxReadyQueue = NULL;
+
+// 以下变量受 otaMutex 保护 (MQTT任务与OTA任务共用)
+static uint32_t chunkSize = 0;
+static unsigned long lastDataTime = 0;
+static bool statusDue = false;              // 需要发布完整状态
+static bool ackDue = false;                 // 需要发布进度应答
+static uint16_t rejectId = 0;               // 忙时拒绝的升级编号 (0=无)
+
+// 以下变量只在OTA任务中访问
+static OtaPatch* patch = NULL;
+static const esp_partition_t* targetPartition = NULL;
+static esp_ota_handle_t otaHandle = 0;
+static bool otaOpen = false;
+static unsigned long rebootTime = 0;
+static unsigned long trialStartTime = 0;
+
+// ==================== 分区与记录 ====================
+
+static int8_t partitionSlot(const esp_partition_t* partition) {
+    if (partition == NULL || partition->subtype < ESP_PARTITION_SUBTYPE_APP_OTA_0 ||
+        partition->subtype > ESP_PARTITION_SUBTYPE_APP_OTA_1) {
+        return -1;
+    }
+    return (int8_t)(partition->subtype - ESP_PARTITION_SUBTYPE_APP_OTA_0);
+}
+
+static const esp_partition_t* slotPartition(uint8_t slot) {
+    return esp_partition_find_first(ESP_PARTITION_TYPE_APP,
+                                    (esp_partition_subtype_t)(ESP_PARTITION_SUBTYPE_APP_OTA_0 + slot), NULL);
+}
+
+static void saveBootRecord(const OtaBootRecord* record) {
+    Preferences prefs;
+    if (prefs.begin(OTA_NVS_NAMESPACE, false)) {
+        prefs.putBytes(OTA_NVS_KEY, record, sizeof(OtaBootRecord));
+        prefs.end();
+    }
+}
+
+/**
+ * @brief 切换启动分区并重启 (回滚)
+ */
+static void rollbackTo(uint8_t slot, const char* reason) {
+    const esp_partition_t* previous = slotPartition(slot);
+    Serial.println("[OTA] Rolling back to slot " + String(slot) + ": " + String(reason));
+    if (previous == NULL || esp_ota_set_boot_partition(previous) != ESP_OK) {
+        Serial.println("[OTA] Rollback failed, keeping current image");
+        return;
+    }
+    Serial.flush();
+    esp_restart();
+}
+
+/**
+ * @brief Arduino框架钩子：返回true时启动后不自动把镜像标记为有效，
+ *        开启了回滚功能的引导程序会在签到前的复位后自动回到原分区
+ */
+extern "C" bool verifyRollbackLater() {
+    return true;
+}
+
+// ==================== 初始化函数 ====================
+
+/**
+ * @brief 初始化OTA模块
+ *
+ * 1. 读取试运行记录：试运行期间反复重启时立即回滚
+ * 2. 新镜像试运行中：开始签到窗口计时
+ * 3. 上次升级的结果 (确认/回滚) 尚未上报时发送报警事件
+ */
+void setupOta() {
+    otaMutex = CREATE_MODULE_MUTEX();
+    rxFreeQueue = CREATE_MODULE_QUEUE(OTA_RX_SLOTS, sizeof(uint8_t));
+    rxReadyQueue = CREATE_MODULE_QUEUE(OTA_RX_SLOTS, sizeof(uint8_t));
+    for (uint8_t i = 0; i < OTA_RX_SLOTS; i++) {
+        xQueueSend(rxFreeQueue, &i, 0);
+    }
+    snprintf(offerTopic, sizeof(offerTopic), "%s%s", OTA_TOPIC_OFFER, DEVICE_ID);
+    snprintf(dataTopic, sizeof(dataTopic), "%s%s", OTA_TOPIC_DATA, DEVICE_ID);
+
+    OtaBootRecord record = {};
+    Preferences prefs;
+    if (prefs.begin(OTA_NVS_NAMESPACE, true)) {
+        if (prefs.getBytes(OTA_NVS_KEY, &record, sizeof(record)) != sizeof(record)) {
+            memset(&record, 0, sizeof(record));
+        }
+        prefs.end();
+    }
+    otaBootSanitize(&record);
+
+    otaStatus.runningSlot = partitionSlot(esp_ota_get_running_partition());
+    if (otaStatus.runningSlot >= 0) {
+        OtaBootRecord before = record;
+        OtaBootAction action = otaBootOnStart(&record, (uint8_t)otaStatus.runningSlot);
+        if (memcmp(&before, &record, sizeof(record)) != 0) saveBootRecord(&record);
+
+        if (action == OTA_BOOT_ACTION_ROLLBACK) {
+            rollbackTo(record.previousSlot, "too many restarts before check-in");
+        } else if (action == OTA_BOOT_ACTION_TRIAL) {
+            trialStartTime = millis();
+            Serial.println("[OTA] Trial boot " + String(record.trialBoots) + "/" + String(OTA_BOOT_MAX_TRIALS) +
+                           " of " + String(record.version) + ", check-in window " +
+                           String(OTA_CHECKIN_WINDOW_MS / 1000) + "s");
+        }
+    }
+
+    if (!record.reported && (record.state == OTA_BOOT_CONFIRMED || record.state == OTA_BOOT_ROLLED_BACK)) {
+        queueAlarmEvent("ota", record.state == OTA_BOOT_CONFIRMED ? "update_confirmed" : "update_rolled_back");
+        record.reported = 1;
+        saveBootRecord(&record);
+    }
+    otaStatus.boot = record;
+    otaStatus.state = OTA_IDLE;
+
+    Serial.println("[OTA] Firmware " + String(FIRMWARE_VERSION) + ", slot " + String(otaStatus.runningSlot) +
+                   ", boot " + String(otaBootStateString(record.state)) + ", offer topic: " + String(offerTopic));
+}
+
+const char* getOtaOfferTopic() {
+    return offerTopic;
+}
+
+const char* getOtaDataTopic() {
+    return dataTopic;
+}
+
+// ==================== 当前镜像 ====================
+
+/**
+ * @brief 计算当前运行镜像的长度与SHA-256 (增量补丁的基准)
+ *
+ * 长度取镜像头描述的实际长度 (含校验和与附加摘要)，与编译产物 firmware.bin 一致
+ */
+static void measureRunningImage() {
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    esp_partition_pos_t pos = { running->address, running->size };
+    esp_image_metadata_t meta = {};
+    if (esp_image_verify(ESP_IMAGE_VERIFY_SILENT, &pos, &meta) != ESP_OK) {
+        Serial.println("[OTA] Running image verify failed, delta updates disabled");
+        return;
+    }
+
+    static uint8_t buffer[OTA_PATCH_READ_BLOCK];
+    unsigned long start = millis();
+    Sha256Context sha;
+    sha256Init(&sha);
+    for (uint32_t offset = 0; offset < meta.image_len; offset += sizeof(buffer)) {
+        uint32_t len = meta.image_len - offset;
+        if (len > sizeof(buffer)) len = sizeof(buffer);
+        if (esp_partition_read(running, offset, buffer, len) != ESP_OK) return;
+        sha256Update(&sha, buffer, len);
+    }
+
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    char hex[SHA256_HEX_SIZE];
+    sha256Final(&sha, digest);
+    sha256ToHex(digest, hex);
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        memcpy(runningSha, digest, sizeof(digest));
+        memcpy(otaStatus.imageSha, hex, sizeof(hex));
+        otaStatus.imageSize = meta.image_len;
+        statusDue = true;
+        xSemaphoreGive(otaMutex);
+    }
+    Serial.println("[OTA] Running image " + String(meta.image_len) + " bytes, sha256 " +
+                   String(hex).substring(0, 16) + "..., took " + String(millis() - start) + "ms");
+}
+
+// ==================== 补丁写入 (OTA任务) ====================
+
+static bool ioReadBase(void* context, uint32_t offset, uint8_t* buf, size_t len) {
+    return esp_partition_read(esp_ota_get_running_partition(), offset, buf, len) == ESP_OK;
+}
+
+static bool ioWriteTarget(void* context, uint32_t offset, const uint8_t* buf, size_t len) {
+    // esp_ota_write 按顺序写入并按需擦除扇区，偏移由补丁模块保证连续
+    return esp_ota_write(otaHandle, buf, len) == ESP_OK;
+}
+
+static bool ioReadTarget(void* context, uint32_t offset, uint8_t* buf, size_t len) {
+    return esp_partition_read(targetPartition, offset, buf, len) == ESP_OK;
+}
+
+static void releaseSession() {
+    if (otaOpen) {
+        esp_ota_abort(otaHandle);
+        otaOpen = false;
+    }
+    if (patch != NULL) {
+        free(patch);
+        patch = NULL;
+    }
+}
+
+static void failUpdate(const char* reason) {
+    releaseSession();
+    uint16_t id = 0;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        otaStatus.state = OTA_FAILED;
+        otaStatus.error = reason;
+        otaStatus.failures++;
+        otaStatus.elapsedMs = millis() - otaStatus.startTime;
+        id = otaStatus.otaId;
+        statusDue = true;
+        xSemaphoreGive(otaMutex);
+    }
+    Serial.println("[OTA] Update " + String(id) + " failed: " + String(reason));
+}
+
+/**
+ * @brief 收到第0块时打开目标分区
+ */
+static bool beginSession() {
+    releaseSession();
+    targetPartition = esp_ota_get_next_update_partition(NULL);
+    if (targetPartition == NULL) {
+        failUpdate("no_partition");
+        return false;
+    }
+
+    // 约10KB，优先放在PSRAM
+    patch = (OtaPatch*)ps_malloc(sizeof(OtaPatch));
+    if (patch == NULL) patch = (OtaPatch*)malloc(sizeof(OtaPatch));
+    if (patch == NULL) {
+        failUpdate("no_memory");
+        return false;
+    }
+    if (esp_ota_begin(targetPartition, OTA_WITH_SEQUENTIAL_WRITES, &otaHandle) != ESP_OK) {
+        failUpdate("ota_begin");
+        return false;
+    }
+    otaOpen = true;
+
+    OtaPatchIo io = {};
+    io.readBase = ioReadBase;
+    io.writeTarget = ioWriteTarget;
+    io.readTarget = ioReadTarget;
+    io.targetCapacity = targetPartition->size;
+    uint8_t baseSha[SHA256_DIGEST_SIZE];
+    uint32_t baseSize = 0;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        memcpy(baseSha, runningSha, sizeof(baseSha));
+        baseSize = otaStatus.imageSize;
+        xSemaphoreGive(otaMutex);
+    }
+    otaPatchBegin(patch, &io, otaSigningPublicKey, baseSize, baseSha);
+    return true;
+}
+
+/**
+ * @brief 全部块写入后校验并切换启动分区
+ */
+static void completeUpdate() {
+    OtaPatchResult result = otaPatchFinish(patch);
+    if (result != OTA_PATCH_OK) {
+        failUpdate(otaPatchResultString(result));
+        return;
+    }
+    // esp_ota_end 再按镜像格式校验一次 (魔数、段表、附加摘要)
+    otaOpen = false;
+    if (esp_ota_end(otaHandle) != ESP_OK) {
+        failUpdate("image_invalid");
+        return;
+    }
+    if (esp_ota_set_boot_partition(targetPartition) != ESP_OK) {
+        failUpdate("set_boot");
+        return;
+    }
+
+    OtaBootRecord record;
+    unsigned long elapsedMs = millis() - otaStatus.startTime;
+    uint32_t diffBytes = patch->diffBytes;
+    uint32_t extraBytes = patch->extraBytes;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        otaBootArm(&otaStatus.boot, otaStatus.otaId, otaStatus.version, FIRMWARE_VERSION,
+                   (uint8_t)partitionSlot(targetPartition), (uint8_t)otaStatus.runningSlot);
+        record = otaStatus.boot;
+        otaStatus.state = OTA_REBOOTING;
+        otaStatus.elapsedMs = elapsedMs;
+        otaStatus.updates++;
+        statusDue = true;
+        xSemaphoreGive(otaMutex);
+    }
+    saveBootRecord(&record);
+    releaseSession();
+    rebootTime = millis() + OTA_REBOOT_DELAY_MS;
+
+    Serial.println("[OTA] Update " + String(record.otaId) + " to " + String(record.version) + " verified in " +
+                   String(elapsedMs) + "ms (" + String(diffBytes) + " bytes from base, " +
+                   String(extraBytes) + " literal), rebooting into slot " + String(record.trialSlot));
+}
+
+static void processChunk(const OtaRxSlot* slot) {
+    uint16_t otaId = 0;
+    OtaState state = OTA_IDLE;
+    uint32_t chunks = 0;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        otaId = otaStatus.otaId;
+        state = otaStatus.state;
+        chunks = otaStatus.chunks;
+        xSemaphoreGive(otaMutex);
+    }
+    // 已失败或被新升级取代的残留块
+    if (state != OTA_RECEIVING || slot->otaId != otaId) return;
+
+    if (slot->index == 0 && !beginSession()) return;
+    if (patch == NULL) return;
+
+    OtaPatchResult result = otaPatchFeed(patch, slot->data, slot->length);
+    if (result != OTA_PATCH_OK) {
+        failUpdate(otaPatchResultString(result));
+        return;
+    }
+
+    bool last = false;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        otaStatus.doneChunks = slot->index + 1;
+        if (otaPatchHeaderReady(patch)) {
+            otaStatus.targetBytes = patch->header.targetSize;
+            otaStatus.delta = (patch->header.flags & OTA_PATCH_FLAG_DELTA) != 0;
+        }
+        last = otaStatus.doneChunks == chunks;
+        ackDue = true;
+        xSemaphoreGive(otaMutex);
+    }
+    if (last) completeUpdate();
+}
+
+/**
+ * @brief 接收超时、延迟重启与签到窗口
+ */
+static void otaTimers() {
+    unsigned long now = millis();
+    OtaState state = OTA_IDLE;
+    unsigned long sinceData = 0;
+    uint8_t bootState = OTA_BOOT_NONE;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        state = otaStatus.state;
+        sinceData = now - lastDataTime;
+        bootState = otaStatus.boot.state;
+        xSemaphoreGive(otaMutex);
+    }
+
+    if (state == OTA_RECEIVING && sinceData > OTA_STALL_TIMEOUT_MS) {
+        failUpdate("stalled");
+    }
+
+    // 火警期间不重启，避免中断报警和喷水
+    bool fireActive = getFireLevel() != FIRE_LEVEL_NONE;
+    if (state == OTA_REBOOTING && (long)(now - rebootTime) >= 0 && !fireActive) {
+        Serial.println("[OTA] Restarting into new firmware");
+        Serial.flush();
+        esp_restart();
+    }
+
+    if (bootState == OTA_BOOT_TRIAL && now - trialStartTime > OTA_CHECKIN_WINDOW_MS && !fireActive) {
+        OtaBootRecord record;
+        int slot = -1;
+        if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+            slot = otaBootExpire(&otaStatus.boot);
+            record = otaStatus.boot;
+            xSemaphoreGive(otaMutex);
+        }
+        if (slot >= 0) {
+            saveBootRecord(&record);
+            rollbackTo((uint8_t)slot, "no check-in within window");
+        }
+    }
+}
+
+/**
+ * @brief OTA任务
+ *
+ * Flash擦写耗时不可预测，放在独立的低优先级任务中，不阻塞MQTT收发和各控制任务；
+ * 空闲时每 OTA_TASK_PERIOD_MS 检查一次超时
+ */
+void otaTask(void* pvParameters) {
+    Serial.println("[OTA] Task started on Core " + String(xPortGetCoreID()));
+    measureRunningImage();
+
+    for (;;) {
+        uint8_t index;
+        if (xQueueReceive(rxReadyQueue, &index, pdMS_TO_TICKS(OTA_TASK_PERIOD_MS)) == pdTRUE) {
+            processChunk(&rxSlots[index]);
+            xQueueSend(rxFreeQueue, &index, 0);
+        }
+        otaTimers();
+    }
+}
+
+// ==================== MQTT入口 (MQTT任务) ====================
+
+/**
+ * @brief 处理升级描述 {"ota_id", "version", "size", "chunks", "chunk_size", "base_sha256"}
+ *
+ * base_sha256 为空表示完整镜像；与当前镜像不符时立即拒绝，主机可改发完整镜像
+ */
+static void handleOffer(const uint8_t* payload, unsigned int length) {
+    JsonDocument doc;
+    if (deserializeJson(doc, payload, length)) return;
+
+    uint16_t id = doc["ota_id"] | 0;
+    const char* version = doc["version"] | "";
+    uint32_t size = doc["size"] | 0;
+    uint32_t chunks = doc["chunks"] | 0;
+    uint32_t offerChunkSize = doc["chunk_size"] | 0;
+    const char* baseHex = doc["base_sha256"] | "";
+
+    const char* error = NULL;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) != pdTRUE) return;
+
+    if (otaStatus.state == OTA_RECEIVING && id == otaStatus.otaId) {
+        // 主机未收到状态时重发的同一描述
+        statusDue = true;
+        xSemaphoreGive(otaMutex);
+        return;
+    }
+    if (otaStatus.state == OTA_RECEIVING || otaStatus.state == OTA_REBOOTING) {
+        rejectId = id;
+        xSemaphoreGive(otaMutex);
+        return;
+    }
+
+    uint8_t baseSha[SHA256_DIGEST_SIZE];
+    if (id == 0 || size == 0 || size > OTA_PATCH_MAX_BYTES || offerChunkSize == 0 ||
+        offerChunkSize > OTA_CHUNK_MAX || chunks != (size + offerChunkSize - 1) / offerChunkSize ||
+        strlen(version) >= OTA_VERSION_SIZE) {
+        error = "bad_offer";
+    } else if (otaStatus.runningSlot < 0) {
+        error = "no_partition";
+    } else if (baseHex[0] != '\0' && otaStatus.imageSize == 0) {
+        error = "not_ready";
+    } else if (baseHex[0] != '\0' && (!sha256FromHex(baseHex, strlen(baseHex), baseSha) ||
+                                      memcmp(baseSha, runningSha, SHA256_DIGEST_SIZE) != 0)) {
+        error = "base_mismatch";
+    }
+
+    otaStatus.otaId = id;
+    strncpy(otaStatus.version, version, OTA_VERSION_SIZE - 1);
+    otaStatus.version[OTA_VERSION_SIZE - 1] = '\0';
+    otaStatus.chunks = chunks;
+    otaStatus.nextChunk = 0;
+    otaStatus.doneChunks = 0;
+    otaStatus.patchBytes = size;
+    otaStatus.targetBytes = 0;
+    otaStatus.delta = baseHex[0] != '\0';
+    otaStatus.startTime = millis();
+    otaStatus.elapsedMs = 0;
+    otaStatus.error = error;
+    if (error != NULL) {
+        otaStatus.state = OTA_FAILED;
+        otaStatus.failures++;
+    } else {
+        otaStatus.state = OTA_RECEIVING;
+        chunkSize = offerChunkSize;
+        lastDataTime = millis();
+    }
+    statusDue = true;
+    xSemaphoreGive(otaMutex);
+
+    if (error != NULL) {
+        Serial.println("[OTA] Offer " + String(id) + " rejected: " + String(error));
+    } else {
+        Serial.println("[OTA] Offer " + String(id) + " accepted: " + String(version) + ", " + String(size) +
+                       " bytes in " + String(chunks) + " chunks" + (baseHex[0] != '\0' ? " (delta)" : ""));
+    }
+}
+
+/**
+ * @brief 处理数据块：只接受下一个期望的块，其余 (重复/乱序) 只触发应答
+ */
+static void handleData(const uint8_t* payload, unsigned int length) {
+    if (length <= OTA_DATA_HEADER_SIZE) return;
+    uint16_t id = (uint16_t)(payload[0] | (payload[1] << 8));
+    uint32_t index = (uint32_t)payload[4] | ((uint32_t)payload[5] << 8) | ((uint32_t)payload[6] << 16) |
+                     ((uint32_t)payload[7] << 24);
+    uint32_t dataLen = length - OTA_DATA_HEADER_SIZE;
+
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) != pdTRUE) return;
+    if (otaStatus.state != OTA_RECEIVING || id != otaStatus.otaId) {
+        xSemaphoreGive(otaMutex);
+        return;
+    }
+    ackDue = true;
+
+    uint32_t expectedLen = index + 1 < otaStatus.chunks ? chunkSize
+                                                       : otaStatus.patchBytes - index * chunkSize;
+    uint8_t slot;
+    if (index != otaStatus.nextChunk || dataLen != expectedLen || xQueueReceive(rxFreeQueue, &slot, 0) != pdTRUE) {
+        xSemaphoreGive(otaMutex);
+        return;
+    }
+
+    rxSlots[slot].otaId = id;
+    rxSlots[slot].index = index;
+    rxSlots[slot].length = (uint16_t)dataLen;
+    memcpy(rxSlots[slot].data, payload + OTA_DATA_HEADER_SIZE, dataLen);
+    otaStatus.nextChunk++;
+    lastDataTime = millis();
+    xSemaphoreGive(otaMutex);
+
+    xQueueSend(rxReadyQueue, &slot, 0);
+}
+
+bool otaHandleMessage(const char* topic, const uint8_t* payload, unsigned int length) {
+    if (strcmp(topic, dataTopic) == 0) {
+        handleData(payload, length);
+        return true;
+    }
+    if (strcmp(topic, offerTopic) == 0) {
+        handleOffer(payload, length);
+        return true;
+    }
+    return false;
+}
+
+void otaOnConnect() {
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        statusDue = true;
+        xSemaphoreGive(otaMutex);
+    }
+}
+
+// ==================== 签到与状态发布 ====================
+
+/**
+ * @brief 试运行签到：MQTT已连接 (调用本函数的前提)、运行平稳且任务监控无超时
+ */
+static void checkIn() {
+    if (millis() < OTA_CHECKIN_STABLE_MS || getSupervisorTotalMisses() != 0) return;
+
+    OtaBootRecord record;
+    bool changed = false;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        changed = otaBootCheckIn(&otaStatus.boot);
+        if (changed) {
+            otaStatus.boot.reported = 1;
+            statusDue = true;
+        }
+        record = otaStatus.boot;
+        xSemaphoreGive(otaMutex);
+    }
+    if (!changed) return;
+
+    saveBootRecord(&record);
+    esp_ota_mark_app_valid_cancel_rollback();
+    queueAlarmEvent("ota", "update_confirmed");
+    Serial.println("[OTA] Firmware " + String(record.version) + " checked in after " +
+                   String(millis() / 1000) + "s");
+}
+
+static size_t buildStatus(char* buffer, size_t size) {
+    JsonDocument doc;
+    doc["device_id"] = DEVICE_ID;
+    doc["ota_id"] = otaStatus.otaId;
+    doc["state"] = getOtaStateString(otaStatus.state);
+    doc["next"] = otaStatus.nextChunk;
+    doc["done"] = otaStatus.doneChunks;
+    doc["chunks"] = otaStatus.chunks;
+    doc["target_version"] = otaStatus.version;
+    if (otaStatus.error != NULL) doc["error"] = otaStatus.error;
+    doc["version"] = FIRMWARE_VERSION;
+    doc["slot"] = otaStatus.runningSlot;
+    doc["boot"] = otaBootStateString(otaStatus.boot.state);
+    doc["boot_ota_id"] = otaStatus.boot.otaId;
+    doc["image_size"] = otaStatus.imageSize;
+    doc["image_sha256"] = otaStatus.imageSha;
+    doc["window"] = OTA_RX_SLOTS;
+    doc["chunk_max"] = OTA_CHUNK_MAX;
+    doc["epoch_us"] = timeSyncNowEpochUs();
+    return serializeJsonChecked(doc, buffer, size, "ota_status");
+}
+
+/**
+ * @brief MQTT任务调用：签到，发布状态变化与进度应答 (直接发布，不进离线缓存)
+ */
+void otaPoll() {
+    checkIn();
+
+    char payload[512];
+    size_t len = 0;
+    bool full = false;
+    bool ack = false;
+    uint16_t rejected = 0;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        full = statusDue;
+        ack = ackDue;
+        rejected = rejectId;
+        if (full) {
+            len = buildStatus(payload, sizeof(payload));
+        } else if (ack) {
+            len = snprintf(payload, sizeof(payload),
+                           "{\"device_id\":\"%s\",\"ota_id\":%u,\"state\":\"%s\",\"next\":%lu,\"done\":%lu}",
+                           DEVICE_ID, otaStatus.otaId, getOtaStateString(otaStatus.state),
+                           (unsigned long)otaStatus.nextChunk, (unsigned long)otaStatus.doneChunks);
+        }
+        xSemaphoreGive(otaMutex);
+    }
+
+    if (rejected != 0) {
+        char reject[128];
+        snprintf(reject, sizeof(reject), "{\"device_id\":\"%s\",\"ota_id\":%u,\"state\":\"rejected\",\"error\":\"busy\"}",
+                 DEVICE_ID, rejected);
+        if (mqttClient.publish(OTA_TOPIC_STATUS, reject) && xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+            if (rejectId == rejected) rejectId = 0;
+            xSemaphoreGive(otaMutex);
+        }
+    }
+
+    if (len == 0 || !mqttClient.publish(OTA_TOPIC_STATUS, payload)) return;
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        if (full) statusDue = false;
+        ackDue = false;
+        xSemaphoreGive(otaMutex);
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+const char* getOtaStateString(OtaState state) {
+    switch (state) {
+        case OTA_IDLE:      return "idle";
+        case OTA_RECEIVING: return "receiving";
+        case OTA_REBOOTING: return "rebooting";
+        case OTA_FAILED:    return "failed";
+        default:            return "unknown";
+    }
+}
+
+OtaStatus getOtaStatus() {
+    OtaStatus status = {};
+    if (xSemaphoreTake(otaMutex, portMAX_DELAY) == pdTRUE) {
+        status = otaStatus;
+        xSemaphoreGive(otaMutex);
+    }
+    return status;
+}
+
+void printOtaReport() {
+    OtaStatus status = getOtaStatus();
+    String line = "OTA: State=" + String(getOtaStateString(status.state)) + ", Version=" + FIRMWARE_VERSION +
+                  " (slot " + String(status.runningSlot) + ", " + otaBootStateString(status.boot.state) + ")";
+    if (status.state == OTA_RECEIVING) {
+        line += ", Update " + String(status.otaId) + " -> " + status.version + " " + String(status.doneChunks) +
+                "/" + String(status.chunks) + " chunks";
+    } else if (status.error != NULL) {
+        line += ", Last error=" + String(status.error);
+    }
+    line += ", Updates=" + String(status.updates) + ", Failures=" + String(status.failures);
+    Serial.println(line);
+}
@@ -0,0 +1,74 @@
+#include "MY_OtaBoot.h"
+#include <string.h>
+
+// ==================== 公共接口 ====================
+
+void otaBootSanitize(OtaBootRecord* record) {
+    if (record->magic != OTA_BOOT_RECORD_MAGIC || record->state > OTA_BOOT_ROLLED_BACK) {
+        memset(record, 0, sizeof(OtaBootRecord));
+        record->magic = OTA_BOOT_RECORD_MAGIC;
+    }
+    record->version[OTA_VERSION_SIZE - 1] = '\0';
+    record->previousVersion[OTA_VERSION_SIZE - 1] = '\0';
+}
+
+void otaBootArm(OtaBootRecord* record, uint16_t otaId, const char* version, const char* previousVersion,
+                uint8_t trialSlot, uint8_t previousSlot) {
+    memset(record, 0, sizeof(OtaBootRecord));
+    record->magic = OTA_BOOT_RECORD_MAGIC;
+    record->state = OTA_BOOT_TRIAL;
+    record->trialSlot = trialSlot;
+    record->previousSlot = previousSlot;
+    record->otaId = otaId;
+    strncpy(record->version, version, OTA_VERSION_SIZE - 1);
+    strncpy(record->previousVersion, previousVersion, OTA_VERSION_SIZE - 1);
+}
+
+/**
+ * @brief 启动时的判断
+ *
+ * 试运行期间每次启动计数一次：新镜像在签到前崩溃/看门狗复位会反复进入这里，
+ * 超过 OTA_BOOT_MAX_TRIALS 次即回滚，不依赖引导程序是否开启了回滚功能
+ */
+OtaBootAction otaBootOnStart(OtaBootRecord* record, uint8_t runningSlot) {
+    if (record->state != OTA_BOOT_TRIAL) return OTA_BOOT_ACTION_NONE;
+
+    if (runningSlot != record->trialSlot) {
+        // 引导程序已回到原分区 (新镜像校验失败或已被标记无效)
+        record->state = OTA_BOOT_ROLLED_BACK;
+        record->reported = 0;
+        return OTA_BOOT_ACTION_NONE;
+    }
+
+    record->trialBoots++;
+    if (record->trialBoots > OTA_BOOT_MAX_TRIALS) {
+        record->state = OTA_BOOT_ROLLED_BACK;
+        record->reported = 0;
+        return OTA_BOOT_ACTION_ROLLBACK;
+    }
+    return OTA_BOOT_ACTION_TRIAL;
+}
+
+bool otaBootCheckIn(OtaBootRecord* record) {
+    if (record->state != OTA_BOOT_TRIAL) return false;
+    record->state = OTA_BOOT_CONFIRMED;
+    record->reported = 0;
+    return true;
+}
+
+int otaBootExpire(OtaBootRecord* record) {
+    if (record->state != OTA_BOOT_TRIAL) return -1;
+    record->state = OTA_BOOT_ROLLED_BACK;
+    record->reported = 0;
+    return record->previousSlot;
+}
+
+const char* otaBootStateString(uint8_t state) {
+    switch (state) {
+        case OTA_BOOT_NONE:         return "none";
+        case OTA_BOOT_TRIAL:        return "trial";
+        case OTA_BOOT_CONFIRMED:    return "confirmed";
+        case OTA_BOOT_ROLLED_BACK:  return "rolled_back";
+        default:                    return "unknown";
+    }
+}
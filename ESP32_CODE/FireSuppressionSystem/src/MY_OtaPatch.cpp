@@ -0,0 +1,421 @@
+#include "MY_OtaPatch.h"
+#include <string.h>
+
+// ==================== 内部状态 ====================
+
+enum {
+    LZ_FLAGS = 0,       // 等待标志字节
+    LZ_UNIT,            // 等待字面字节或匹配的低字节
+    LZ_MATCH_HI,        // 等待匹配的高字节
+    LZ_MATCH_EXT        // 等待追加长度 (varint)
+};
+
+enum {
+    OP_DIFF_LEN = 0,
+    OP_EXTRA_LEN,
+    OP_SEEK,
+    OP_DIFF,
+    OP_EXTRA
+};
+
+// varint 最多5字节 (32位)
+#define VARINT_MAX_SHIFT    28
+
+static void setError(OtaPatch* patch, OtaPatchResult result) {
+    if (patch->error == OTA_PATCH_OK) patch->error = result;
+}
+
+static uint32_t readLe32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void writeLe32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief 累加一个 varint 字节
+ * @return 1=完成, 0=还需要字节, -1=超长
+ */
+static int varintStep(uint32_t* value, uint8_t* shift, uint8_t byte) {
+    if (*shift > VARINT_MAX_SHIFT) return -1;
+    *value |= (uint32_t)(byte & 0x7F) << *shift;
+    *shift += 7;
+    return (byte & 0x80) ? 0 : 1;
+}
+
+// ==================== 目标输出 ====================
+
+static void flushWrite(OtaPatch* patch) {
+    if (patch->writeLen == 0 || patch->error != OTA_PATCH_OK) return;
+    if (!patch->io.writeTarget(patch->io.context, patch->written, patch->writeBuf, patch->writeLen)) {
+        setError(patch, OTA_PATCH_ERR_IO);
+        return;
+    }
+    sha256Update(&patch->sha, patch->writeBuf, patch->writeLen);
+    patch->written += patch->writeLen;
+    patch->writeLen = 0;
+}
+
+static inline void outputByte(OtaPatch* patch, uint8_t byte) {
+    patch->writeBuf[patch->writeLen++] = byte;
+    patch->produced++;
+    if (patch->writeLen == OTA_PATCH_WRITE_BLOCK) flushWrite(patch);
+}
+
+/**
+ * @brief 读取基准镜像的一个字节 (按块缓存)
+ */
+static bool baseByte(OtaPatch* patch, uint32_t pos, uint8_t* out) {
+    if (pos < patch->readStart || pos >= patch->readStart + patch->readLen) {
+        uint32_t len = patch->header.baseSize - pos;
+        if (len > OTA_PATCH_READ_BLOCK) len = OTA_PATCH_READ_BLOCK;
+        if (patch->io.readBase == NULL || !patch->io.readBase(patch->io.context, pos, patch->readBuf, len)) {
+            setError(patch, OTA_PATCH_ERR_IO);
+            return false;
+        }
+        patch->readStart = pos;
+        patch->readLen = len;
+    }
+    *out = patch->readBuf[pos - patch->readStart];
+    return true;
+}
+
+// ==================== 指令解析 ====================
+
+// 一条指令的数据部分结束：按 seek 移动基准位置
+static void finishInstruction(OtaPatch* patch) {
+    patch->oldPos += patch->seek;
+    if (patch->oldPos < 0 || patch->oldPos > (int64_t)patch->header.baseSize) {
+        setError(patch, OTA_PATCH_ERR_RANGE);
+    }
+    patch->opState = OP_DIFF_LEN;
+    patch->opVarint = 0;
+    patch->opShift = 0;
+}
+
+/**
+ * @brief 处理解压后的指令流
+ */
+static void applyStream(OtaPatch* patch, const uint8_t* data, size_t len) {
+    size_t i = 0;
+    while (i < len && patch->error == OTA_PATCH_OK) {
+        switch (patch->opState) {
+            case OP_DIFF_LEN:
+            case OP_EXTRA_LEN:
+            case OP_SEEK: {
+                // 目标已写满后不应再有指令
+                if (patch->opState == OP_DIFF_LEN && patch->opShift == 0 &&
+                    patch->produced == patch->header.targetSize) {
+                    setError(patch, OTA_PATCH_ERR_FORMAT);
+                    break;
+                }
+                int step = varintStep(&patch->opVarint, &patch->opShift, data[i++]);
+                if (step < 0) {
+                    setError(patch, OTA_PATCH_ERR_FORMAT);
+                    break;
+                }
+                if (step == 0) break;
+
+                uint32_t value = patch->opVarint;
+                patch->opVarint = 0;
+                patch->opShift = 0;
+                uint32_t remaining = patch->header.targetSize - patch->produced;
+                if (patch->opState == OP_DIFF_LEN) {
+                    if (value > remaining || patch->oldPos + value > (int64_t)patch->header.baseSize) {
+                        setError(patch, value > remaining ? OTA_PATCH_ERR_FORMAT : OTA_PATCH_ERR_RANGE);
+                        break;
+                    }
+                    patch->diffRemain = value;
+                    patch->opState = OP_EXTRA_LEN;
+                } else if (patch->opState == OP_EXTRA_LEN) {
+                    if (value > remaining - patch->diffRemain) {
+                        setError(patch, OTA_PATCH_ERR_FORMAT);
+                        break;
+                    }
+                    patch->extraRemain = value;
+                    patch->opState = OP_SEEK;
+                } else {
+                    // zigzag: 0,-1,1,-2... -> 0,1,2,3...
+                    patch->seek = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+                    if (patch->diffRemain > 0) {
+                        patch->opState = OP_DIFF;
+                    } else if (patch->extraRemain > 0) {
+                        patch->opState = OP_EXTRA;
+                    } else {
+                        finishInstruction(patch);
+                    }
+                }
+                break;
+            }
+
+            case OP_DIFF: {
+                size_t take = len - i;
+                if (take > patch->diffRemain) take = patch->diffRemain;
+                for (size_t k = 0; k < take && patch->error == OTA_PATCH_OK; k++) {
+                    uint8_t old;
+                    if (!baseByte(patch, (uint32_t)patch->oldPos, &old)) break;
+                    outputByte(patch, (uint8_t)(old + data[i + k]));
+                    patch->oldPos++;
+                }
+                i += take;
+                patch->diffRemain -= (uint32_t)take;
+                patch->diffBytes += (uint32_t)take;
+                if (patch->diffRemain == 0) {
+                    if (patch->extraRemain > 0) {
+                        patch->opState = OP_EXTRA;
+                    } else {
+                        finishInstruction(patch);
+                    }
+                }
+                break;
+            }
+
+            case OP_EXTRA: {
+                size_t take = len - i;
+                if (take > patch->extraRemain) take = patch->extraRemain;
+                for (size_t k = 0; k < take; k++) {
+                    outputByte(patch, data[i + k]);
+                }
+                i += take;
+                patch->extraRemain -= (uint32_t)take;
+                patch->extraBytes += (uint32_t)take;
+                if (patch->extraRemain == 0) finishInstruction(patch);
+                break;
+            }
+        }
+    }
+}
+
+// ==================== LZ解压 ====================
+
+static void flushStage(OtaPatch* patch) {
+    if (patch->stageLen == 0) return;
+    applyStream(patch, patch->stage, patch->stageLen);
+    patch->stageLen = 0;
+}
+
+static inline void lzEmit(OtaPatch* patch, uint8_t byte) {
+    patch->window[patch->decoded & (OTA_LZ_WINDOW - 1)] = byte;
+    patch->decoded++;
+    patch->stage[patch->stageLen++] = byte;
+    if (patch->stageLen == OTA_PATCH_STAGE_SIZE) flushStage(patch);
+}
+
+static void lzNextUnit(OtaPatch* patch) {
+    patch->lzBit++;
+    patch->lzState = patch->lzBit == 8 ? LZ_FLAGS : LZ_UNIT;
+}
+
+/**
+ * @brief 复制窗口中的匹配 (输出不依赖后续输入，一次完成)
+ */
+static void lzCopy(OtaPatch* patch, uint32_t distance, uint32_t length) {
+    if (distance > patch->decoded || length > OTA_LZ_MAX_MATCH) {
+        setError(patch, OTA_PATCH_ERR_FORMAT);
+        return;
+    }
+    for (uint32_t k = 0; k < length && patch->error == OTA_PATCH_OK; k++) {
+        lzEmit(patch, patch->window[(patch->decoded - distance) & (OTA_LZ_WINDOW - 1)]);
+    }
+}
+
+static void lzDecodeByte(OtaPatch* patch, uint8_t byte) {
+    switch (patch->lzState) {
+        case LZ_FLAGS:
+            patch->lzFlags = byte;
+            patch->lzBit = 0;
+            patch->lzState = LZ_UNIT;
+            break;
+
+        case LZ_UNIT:
+            if (patch->lzFlags & (1 << patch->lzBit)) {
+                patch->lzWord = byte;
+                patch->lzState = LZ_MATCH_HI;
+            } else {
+                lzEmit(patch, byte);
+                lzNextUnit(patch);
+            }
+            break;
+
+        case LZ_MATCH_HI:
+            patch->lzWord |= (uint16_t)byte << 8;
+            if ((patch->lzWord & 0x0F) == OTA_LZ_LEN_EXTENDED) {
+                patch->lzVarint = 0;
+                patch->lzShift = 0;
+                patch->lzState = LZ_MATCH_EXT;
+            } else {
+                lzCopy(patch, (patch->lzWord >> 4) + 1, (patch->lzWord & 0x0F) + OTA_LZ_MIN_MATCH);
+                lzNextUnit(patch);
+            }
+            break;
+
+        case LZ_MATCH_EXT: {
+            int step = varintStep(&patch->lzVarint, &patch->lzShift, byte);
+            if (step < 0) {
+                setError(patch, OTA_PATCH_ERR_FORMAT);
+            } else if (step > 0) {
+                lzCopy(patch, (patch->lzWord >> 4) + 1, OTA_LZ_LEN_EXTENDED + OTA_LZ_MIN_MATCH + patch->lzVarint);
+                lzNextUnit(patch);
+            }
+            break;
+        }
+    }
+}
+
+// ==================== 头部 ====================
+
+void otaPatchEncodeHeader(const OtaPatchHeader* header, uint8_t out[OTA_PATCH_HEADER_SIZE]) {
+    memset(out, 0, OTA_PATCH_HEADER_SIZE);
+    memcpy(out, OTA_PATCH_MAGIC, 4);
+    out[4] = OTA_PATCH_VERSION;
+    out[5] = header->flags;
+    writeLe32(out + 8, header->baseSize);
+    writeLe32(out + 12, header->targetSize);
+    memcpy(out + 16, header->baseSha, SHA256_DIGEST_SIZE);
+    memcpy(out + 48, header->targetSha, SHA256_DIGEST_SIZE);
+}
+
+bool otaPatchDecodeHeader(const uint8_t in[OTA_PATCH_HEADER_SIZE], OtaPatchHeader* header) {
+    if (memcmp(in, OTA_PATCH_MAGIC, 4) != 0 || in[4] != OTA_PATCH_VERSION) return false;
+    header->flags = in[5];
+    header->baseSize = readLe32(in + 8);
+    header->targetSize = readLe32(in + 12);
+    memcpy(header->baseSha, in + 16, SHA256_DIGEST_SIZE);
+    memcpy(header->targetSha, in + 48, SHA256_DIGEST_SIZE);
+    return true;
+}
+
+void otaPatchSignHeader(uint8_t header[OTA_PATCH_HEADER_SIZE], const uint8_t seed[ED25519_SEED_SIZE]) {
+    ed25519Sign(seed, header, OTA_PATCH_SIGNED_SIZE, header + OTA_PATCH_SIGNED_SIZE);
+}
+
+bool otaPatchVerifyHeader(const uint8_t header[OTA_PATCH_HEADER_SIZE],
+                          const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE]) {
+    return ed25519Verify(header + OTA_PATCH_SIGNED_SIZE, header, OTA_PATCH_SIGNED_SIZE, publicKey);
+}
+
+/**
+ * @brief 头部收齐后检查格式、签名、基准与容量 (此前没有写入任何数据)
+ */
+static void acceptHeader(OtaPatch* patch) {
+    if (!otaPatchDecodeHeader(patch->headerBuf, &patch->header)) {
+        setError(patch, OTA_PATCH_ERR_HEADER);
+        return;
+    }
+    if (!otaPatchVerifyHeader(patch->headerBuf, patch->publicKey)) {
+        setError(patch, OTA_PATCH_ERR_SIGNATURE);
+        return;
+    }
+    if (patch->header.flags & OTA_PATCH_FLAG_DELTA) {
+        if (patch->header.baseSize != patch->runningSize ||
+            memcmp(patch->header.baseSha, patch->runningSha, SHA256_DIGEST_SIZE) != 0) {
+            setError(patch, OTA_PATCH_ERR_BASE);
+            return;
+        }
+    } else if (patch->header.baseSize != 0) {
+        setError(patch, OTA_PATCH_ERR_HEADER);
+        return;
+    }
+    if (patch->header.targetSize == 0 || patch->header.targetSize > patch->io.targetCapacity) {
+        setError(patch, OTA_PATCH_ERR_TOO_LARGE);
+        return;
+    }
+    patch->headerReady = true;
+}
+
+// ==================== 公共接口 ====================
+
+void otaPatchBegin(OtaPatch* patch, const OtaPatchIo* io, const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE],
+                   uint32_t runningSize, const uint8_t runningSha[SHA256_DIGEST_SIZE]) {
+    memset(patch, 0, sizeof(OtaPatch));
+    patch->io = *io;
+    memcpy(patch->publicKey, publicKey, ED25519_PUBLIC_KEY_SIZE);
+    patch->runningSize = runningSize;
+    memcpy(patch->runningSha, runningSha, SHA256_DIGEST_SIZE);
+    patch->lzState = LZ_FLAGS;
+    patch->opState = OP_DIFF_LEN;
+    sha256Init(&patch->sha);
+}
+
+OtaPatchResult otaPatchFeed(OtaPatch* patch, const uint8_t* data, size_t len) {
+    patch->inputBytes += (uint32_t)len;
+    size_t i = 0;
+
+    if (!patch->headerReady && patch->error == OTA_PATCH_OK) {
+        size_t take = OTA_PATCH_HEADER_SIZE - patch->headerLen;
+        if (take > len) take = len;
+        memcpy(patch->headerBuf + patch->headerLen, data, take);
+        patch->headerLen += (uint8_t)take;
+        i = take;
+        if (patch->headerLen == OTA_PATCH_HEADER_SIZE) acceptHeader(patch);
+    }
+
+    while (i < len && patch->error == OTA_PATCH_OK) {
+        lzDecodeByte(patch, data[i++]);
+    }
+    // 每次送入的数据都立即应用，分块边界不影响结果
+    if (patch->error == OTA_PATCH_OK) flushStage(patch);
+    return patch->error;
+}
+
+OtaPatchResult otaPatchFinish(OtaPatch* patch) {
+    if (patch->error != OTA_PATCH_OK) return patch->error;
+    if (!patch->headerReady || patch->produced != patch->header.targetSize || patch->opState != OP_DIFF_LEN ||
+        patch->opShift != 0) {
+        return OTA_PATCH_ERR_INCOMPLETE;
+    }
+
+    flushWrite(patch);
+    if (patch->error != OTA_PATCH_OK) return patch->error;
+
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256Final(&patch->sha, digest);
+    if (memcmp(digest, patch->header.targetSha, SHA256_DIGEST_SIZE) != 0) {
+        setError(patch, OTA_PATCH_ERR_HASH);
+        return patch->error;
+    }
+
+    // 回读分区再算一次，发现写入过程中的Flash错误
+    Sha256Context verify;
+    sha256Init(&verify);
+    for (uint32_t offset = 0; offset < patch->header.targetSize; offset += OTA_PATCH_READ_BLOCK) {
+        uint32_t len = patch->header.targetSize - offset;
+        if (len > OTA_PATCH_READ_BLOCK) len = OTA_PATCH_READ_BLOCK;
+        if (!patch->io.readTarget(patch->io.context, offset, patch->readBuf, len)) {
+            setError(patch, OTA_PATCH_ERR_IO);
+            return patch->error;
+        }
+        sha256Update(&verify, patch->readBuf, len);
+    }
+    patch->readLen = 0;
+    sha256Final(&verify, digest);
+    if (memcmp(digest, patch->header.targetSha, SHA256_DIGEST_SIZE) != 0) {
+        setError(patch, OTA_PATCH_ERR_VERIFY);
+    }
+    return patch->error;
+}
+
+bool otaPatchHeaderReady(const OtaPatch* patch) {
+    return patch->headerReady;
+}
+
+const char* otaPatchResultString(OtaPatchResult result) {
+    switch (result) {
+        case OTA_PATCH_OK:              return "ok";
+        case OTA_PATCH_ERR_HEADER:      return "bad_header";
+        case OTA_PATCH_ERR_SIGNATURE:   return "bad_signature";
+        case OTA_PATCH_ERR_BASE:        return "base_mismatch";
+        case OTA_PATCH_ERR_TOO_LARGE:   return "too_large";
+        case OTA_PATCH_ERR_FORMAT:      return "corrupt";
+        case OTA_PATCH_ERR_RANGE:       return "out_of_range";
+        case OTA_PATCH_ERR_IO:          return "flash_io";
+        case OTA_PATCH_ERR_INCOMPLETE:  return "incomplete";
+        case OTA_PATCH_ERR_HASH:        return "sha256_mismatch";
+        case OTA_PATCH_ERR_VERIFY:      return "readback_mismatch";
+        default:                        return "unknown";
+    }
+}
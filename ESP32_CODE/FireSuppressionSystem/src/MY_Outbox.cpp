@@ -0,0 +1,227 @@
+#include <Arduino.h>
+#include "MY_Outbox.h"
+#include "MY_Memory.h"
+#include "MY_Config.h"
+#if OUTBOX_FLASH_SPILL
+#include <LittleFS.h>
+#endif
+
+// ==================== 全局变量定义 ====================
+SemaphoreHandle_t outboxMutex = NULL;
+
+// 队列状态 (环形队列、计数、令牌桶)，由 outboxMutex 保护
+static OutboxCore outboxCore;
+
+// 补发时的拷贝缓冲区 (发布过程中不持有互斥锁)
+static OutboxEntryHeader drainHeader;
+static char* drainPayload = NULL;
+
+#if OUTBOX_FLASH_SPILL
+static bool spillReady = false;
+static uint32_t spillWritten = 0;   // 文件中已写入的条目数
+static uint32_t spillRead = 0;      // 已补发的条目数
+#endif
+
+// ==================== 内部函数 ====================
+
+static void allocRing(OutboxRing* ring, uint32_t capacity) {
+    OutboxEntryHeader* headers = NULL;
+    char* payloads = NULL;
+    if (psramFound()) {
+        headers = (OutboxEntryHeader*)ps_malloc(sizeof(OutboxEntryHeader) * capacity);
+        payloads = (char*)ps_malloc((size_t)OUTBOX_PAYLOAD_SIZE * capacity);
+    }
+    if (headers == NULL || payloads == NULL) {
+        // 无PSRAM时降级为内部RAM小容量队列
+        free(headers);
+        free(payloads);
+        capacity = OUTBOX_FALLBACK_CAPACITY;
+        headers = (OutboxEntryHeader*)malloc(sizeof(OutboxEntryHeader) * capacity);
+        payloads = (char*)malloc((size_t)OUTBOX_PAYLOAD_SIZE * capacity);
+    }
+    if (headers == NULL || payloads == NULL) {
+        free(headers);
+        free(payloads);
+        headers = NULL;
+        payloads = NULL;
+    }
+    outboxRingInit(ring, headers, payloads, capacity);
+}
+
+#if OUTBOX_FLASH_SPILL
+// 文件中每条记录为条目头 + 定长payload
+#define OUTBOX_SPILL_RECORD_SIZE    (sizeof(OutboxEntryHeader) + OUTBOX_PAYLOAD_SIZE)
+
+/**
+ * @brief 把遥测队列最旧的条目写入Flash
+ * @return true=写入成功（调用方可覆盖该条目）
+ */
+static bool spillOldest(void* ctx, const OutboxEntryHeader* header, const char* payload) {
+    (void)ctx;
+    if (!spillReady || spillWritten - spillRead >= OUTBOX_SPILL_MAX_ENTRIES) {
+        return false;
+    }
+    File f = LittleFS.open(OUTBOX_SPILL_FILE, FILE_APPEND);
+    if (!f) return false;
+    size_t n = f.write((const uint8_t*)header, sizeof(OutboxEntryHeader));
+    n += f.write((const uint8_t*)payload, OUTBOX_PAYLOAD_SIZE);
+    f.close();
+    if (n != OUTBOX_SPILL_RECORD_SIZE) return false;
+    spillWritten++;
+    return true;
+}
+
+static bool readSpilled(void* ctx, OutboxEntryHeader* header, char* payload) {
+    (void)ctx;
+    File f = LittleFS.open(OUTBOX_SPILL_FILE, FILE_READ);
+    if (!f) return false;
+    bool ok = f.seek(spillRead * OUTBOX_SPILL_RECORD_SIZE) &&
+              f.read((uint8_t*)header, sizeof(OutboxEntryHeader)) == sizeof(OutboxEntryHeader) &&
+              f.read((uint8_t*)payload, OUTBOX_PAYLOAD_SIZE) == OUTBOX_PAYLOAD_SIZE;
+    f.close();
+    return ok;
+}
+
+static void popSpilled(void* ctx) {
+    (void)ctx;
+    spillRead++;
+    if (spillRead >= spillWritten) {
+        // 全部补发完成，删除文件
+        LittleFS.remove(OUTBOX_SPILL_FILE);
+        spillRead = 0;
+        spillWritten = 0;
+    }
+}
+
+static uint32_t spilledDepth(void* ctx) {
+    (void)ctx;
+    return spillWritten - spillRead;
+}
+
+static const OutboxSpillHandlers spillHandlers = { NULL, spillOldest, readSpilled, popSpilled, spilledDepth };
+#endif
+
+// ==================== 初始化函数 ====================
+
+void setupOutbox() {
+    outboxMutex = CREATE_MODULE_MUTEX();
+
+#if OUTBOX_FLASH_SPILL
+    outboxCoreInit(&outboxCore, OUTBOX_PAYLOAD_SIZE, &spillHandlers, millis());
+#else
+    outboxCoreInit(&outboxCore, OUTBOX_PAYLOAD_SIZE, NULL, millis());
+#endif
+    allocRing(&outboxCore.alarm, OUTBOX_ALARM_CAPACITY);
+    allocRing(&outboxCore.telemetry, OUTBOX_TELEMETRY_CAPACITY);
+    drainPayload = (char*)malloc(OUTBOX_PAYLOAD_SIZE);
+
+#if OUTBOX_FLASH_SPILL
+    spillReady = LittleFS.begin(true);
+    if (spillReady) {
+        // 上次运行遗留的溢出数据无法保证时间基准一致，直接丢弃
+        LittleFS.remove(OUTBOX_SPILL_FILE);
+    }
+#endif
+
+    Serial.println("[OUTBOX] ========== Outbox Module Init ==========");
+    Serial.println("[OUTBOX] Storage: " + String(psramFound() ? "PSRAM" : "internal RAM"));
+    Serial.println("[OUTBOX] Alarm capacity: " + String(outboxCore.alarm.capacity));
+    Serial.println("[OUTBOX] Telemetry capacity: " + String(outboxCore.telemetry.capacity));
+    Serial.println("[OUTBOX] Drain rate: " + String(getConfig()->outboxDrainRatePerSec) + " msg/s");
+#if OUTBOX_FLASH_SPILL
+    Serial.println("[OUTBOX] Flash spill: " + String(spillReady ? "ENABLED" : "FAILED"));
+#endif
+    Serial.println("[OUTBOX] ==========================================");
+}
+
+// ==================== 入队函数 ====================
+
+/**
+ * @brief 消息入队 (规则见 outboxCorePush)
+ *
+ * @param msgClass 消息类别
+ * @param topic 发布Topic
+ * @param payload 消息内容（已包含采集时间戳）
+ * @param captureTime 采集时间 millis()
+ */
+bool outboxPush(OutboxClass msgClass, const char* topic, const char* payload, unsigned long captureTime) {
+    if (outboxMutex == NULL) return false;
+
+    bool queued = false;
+    if (xSemaphoreTake(outboxMutex, portMAX_DELAY) == pdTRUE) {
+        queued = outboxCorePush(&outboxCore, msgClass, topic, payload, (uint32_t)captureTime);
+        xSemaphoreGive(outboxMutex);
+    }
+    return queued;
+}
+
+// ==================== 补发函数 ====================
+
+/**
+ * @brief 按配置速率补发队列中的消息
+ *
+ * 补发顺序：报警事件 → Flash溢出的遥测 → RAM中的遥测
+ * 每条消息的payload保持入队时的原样（含原始采集时间戳）
+ *
+ * @param publish 发布回调，返回false时停止本轮补发
+ * @return 本次成功补发的条数
+ */
+uint32_t outboxDrain(OutboxPublishFn publish) {
+    if (outboxMutex == NULL || drainPayload == NULL) return 0;
+
+    // 令牌桶只由补发方访问
+    uint32_t tokens = outboxCoreRefill(&outboxCore, millis(), getConfig()->outboxDrainRatePerSec);
+
+    uint32_t sentNow = 0;
+    while (sentNow < tokens) {
+        if (xSemaphoreTake(outboxMutex, portMAX_DELAY) != pdTRUE) break;
+        OutboxSource source = outboxCorePeek(&outboxCore, &drainHeader, drainPayload);
+        xSemaphoreGive(outboxMutex);
+        if (source == OUTBOX_SOURCE_NONE) break;
+
+        // 发布时不持有互斥锁，入队方不会被网络IO阻塞
+        if (!publish(drainHeader.topic, drainPayload)) {
+            break;
+        }
+
+        if (xSemaphoreTake(outboxMutex, portMAX_DELAY) == pdTRUE) {
+            outboxCoreComplete(&outboxCore, source, drainHeader.seq);
+            xSemaphoreGive(outboxMutex);
+        }
+        sentNow++;
+    }
+
+    if (sentNow > 0) {
+        Serial.println("[OUTBOX] Drained " + String(sentNow) + " queued message(s), depth: " + String(getOutboxDepth()));
+    }
+    return sentNow;
+}
+
+// ==================== 状态获取函数 ====================
+
+bool outboxHasTelemetry() {
+    bool pending = false;
+    if (outboxMutex != NULL && xSemaphoreTake(outboxMutex, portMAX_DELAY) == pdTRUE) {
+        pending = outboxCoreHasTelemetry(&outboxCore);
+        xSemaphoreGive(outboxMutex);
+    }
+    return pending;
+}
+
+OutboxStats getOutboxStats() {
+    OutboxStats snapshot = {0, 0, 0, 0, 0, 0};
+    if (outboxMutex != NULL && xSemaphoreTake(outboxMutex, portMAX_DELAY) == pdTRUE) {
+        snapshot = outboxCoreStats(&outboxCore);
+        xSemaphoreGive(outboxMutex);
+    }
+    return snapshot;
+}
+
+uint32_t getOutboxDepth() {
+    OutboxStats s = getOutboxStats();
+    return s.alarmDepth + s.telemetryDepth + s.spilledDepth;
+}
+
+uint32_t getOutboxDropped() {
+    return getOutboxStats().dropped;
+}
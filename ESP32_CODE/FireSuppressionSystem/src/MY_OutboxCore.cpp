@@ -0,0 +1,182 @@
+#include <string.h>
+#include "MY_OutboxCore.h"
+
+// ==================== 内部函数 ====================
+
+static char* payloadAt(const OutboxCore* core, const OutboxRing* ring, uint32_t slot) {
+    return ring->payloads + (size_t)slot * core->payloadSize;
+}
+
+static uint32_t slotAt(const OutboxRing* ring, uint32_t offset) {
+    return (ring->head + offset) % ring->capacity;
+}
+
+static void ringPop(OutboxRing* ring) {
+    ring->head = (ring->head + 1) % ring->capacity;
+    ring->count--;
+}
+
+static void fillSlot(OutboxCore* core, OutboxRing* ring, uint32_t slot, OutboxClass msgClass,
+                     const char* topic, const char* payload, uint32_t captureTime) {
+    OutboxEntryHeader* header = &ring->headers[slot];
+    header->seq = core->nextSeq++;
+    header->captureTime = captureTime;
+    header->msgClass = (uint8_t)msgClass;
+    strncpy(header->topic, topic, OUTBOX_TOPIC_SIZE - 1);
+    header->topic[OUTBOX_TOPIC_SIZE - 1] = '\0';
+    char* dst = payloadAt(core, ring, slot);
+    strncpy(dst, payload, core->payloadSize - 1);
+    dst[core->payloadSize - 1] = '\0';
+}
+
+static uint32_t spilledDepth(const OutboxCore* core) {
+    return core->spill != NULL ? core->spill->depth(core->spill->ctx) : 0;
+}
+
+// ==================== 初始化函数 ====================
+
+void outboxCoreInit(OutboxCore* core, size_t payloadSize, const OutboxSpillHandlers* spill, uint32_t nowMs) {
+    memset(core, 0, sizeof(*core));
+    core->payloadSize = payloadSize;
+    core->spill = spill;
+    core->nextSeq = 1;
+    core->drainTokens = OUTBOX_DRAIN_BURST;
+    core->lastDrainRefill = nowMs;
+}
+
+void outboxRingInit(OutboxRing* ring, OutboxEntryHeader* headers, char* payloads, uint32_t capacity) {
+    ring->headers = headers;
+    ring->payloads = payloads;
+    ring->capacity = (headers != NULL && payloads != NULL) ? capacity : 0;
+    ring->head = 0;
+    ring->count = 0;
+}
+
+// ==================== 入队函数 ====================
+
+/**
+ * @brief 消息入队
+ *
+ * - 报警事件：追加到报警队列，队列满时丢弃最旧事件
+ * - 遥测数据：合并窗口内覆盖队尾样本；队列满时溢出到存储或丢弃最旧样本
+ */
+bool outboxCorePush(OutboxCore* core, OutboxClass msgClass, const char* topic, const char* payload, uint32_t captureTime) {
+    OutboxRing* ring = (msgClass == OUTBOX_CLASS_ALARM) ? &core->alarm : &core->telemetry;
+
+    if (ring->capacity == 0) {
+        core->stats.dropped++;
+        return false;
+    }
+
+    // 遥测合并：同一窗口内只保留最新样本
+    if (msgClass == OUTBOX_CLASS_TELEMETRY && ring->count > 0 &&
+        captureTime - core->telemetryWindowStart < OUTBOX_COALESCE_MS) {
+        fillSlot(core, ring, slotAt(ring, ring->count - 1), msgClass, topic, payload, captureTime);
+        core->stats.coalesced++;
+        return true;
+    }
+
+    // 队列已满：腾出队头
+    if (ring->count >= ring->capacity) {
+        uint32_t oldest = slotAt(ring, 0);
+        bool spilled = msgClass == OUTBOX_CLASS_TELEMETRY && core->spill != NULL &&
+                       core->spill->write(core->spill->ctx, &ring->headers[oldest], payloadAt(core, ring, oldest));
+        if (!spilled) {
+            core->stats.dropped++;
+        }
+        ringPop(ring);
+    }
+
+    fillSlot(core, ring, slotAt(ring, ring->count), msgClass, topic, payload, captureTime);
+    ring->count++;
+    if (msgClass == OUTBOX_CLASS_TELEMETRY) {
+        core->telemetryWindowStart = captureTime;
+    }
+    return true;
+}
+
+// ==================== 补发函数 ====================
+
+uint32_t outboxCoreRefill(OutboxCore* core, uint32_t nowMs, uint32_t ratePerSec) {
+    // 速率为0：不再补充，已有令牌仍可用
+    if (ratePerSec == 0) {
+        core->lastDrainRefill = nowMs;
+        return core->drainTokens;
+    }
+    // 64位相乘：断网数天后 (间隔 × 速率) 超出32位
+    uint64_t gained64 = (uint64_t)(nowMs - core->lastDrainRefill) * ratePerSec / 1000;
+    uint32_t gained = gained64 > OUTBOX_DRAIN_BURST ? OUTBOX_DRAIN_BURST : (uint32_t)gained64;
+    if (gained > 0) {
+        core->drainTokens += gained;
+        core->lastDrainRefill += gained * 1000 / ratePerSec;
+        if (core->drainTokens >= OUTBOX_DRAIN_BURST) {
+            core->drainTokens = OUTBOX_DRAIN_BURST;
+            core->lastDrainRefill = nowMs;
+        }
+    }
+    return core->drainTokens;
+}
+
+/**
+ * @brief 拷贝下一条待补发的条目
+ *
+ * 补发顺序：报警事件 → 溢出存储中的遥测 → RAM中的遥测
+ * 每条消息的payload保持入队时的原样（含原始采集时间戳）
+ */
+OutboxSource outboxCorePeek(OutboxCore* core, OutboxEntryHeader* header, char* payload) {
+    if (core->alarm.count > 0) {
+        uint32_t slot = slotAt(&core->alarm, 0);
+        *header = core->alarm.headers[slot];
+        memcpy(payload, payloadAt(core, &core->alarm, slot), core->payloadSize);
+        return OUTBOX_SOURCE_ALARM;
+    }
+    if (spilledDepth(core) > 0 && core->spill->read(core->spill->ctx, header, payload)) {
+        return OUTBOX_SOURCE_SPILL;
+    }
+    if (core->telemetry.count > 0) {
+        uint32_t slot = slotAt(&core->telemetry, 0);
+        *header = core->telemetry.headers[slot];
+        memcpy(payload, payloadAt(core, &core->telemetry, slot), core->payloadSize);
+        return OUTBOX_SOURCE_TELEMETRY;
+    }
+    return OUTBOX_SOURCE_NONE;
+}
+
+/**
+ * @brief 发布成功后确认出队
+ *
+ * 发布期间队头可能被合并改写，此时保留新内容下次再发，不计入已补发
+ */
+void outboxCoreComplete(OutboxCore* core, OutboxSource source, uint32_t seq) {
+    bool removed = false;
+    if (source == OUTBOX_SOURCE_SPILL) {
+        core->spill->pop(core->spill->ctx);
+        removed = true;
+    } else if (source == OUTBOX_SOURCE_ALARM || source == OUTBOX_SOURCE_TELEMETRY) {
+        OutboxRing* ring = (source == OUTBOX_SOURCE_ALARM) ? &core->alarm : &core->telemetry;
+        if (ring->count > 0 && ring->headers[slotAt(ring, 0)].seq == seq) {
+            ringPop(ring);
+            removed = true;
+        }
+    }
+    if (removed) {
+        core->stats.sent++;
+    }
+    if (core->drainTokens > 0) {
+        core->drainTokens--;
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+OutboxStats outboxCoreStats(const OutboxCore* core) {
+    OutboxStats snapshot = core->stats;
+    snapshot.alarmDepth = core->alarm.count;
+    snapshot.telemetryDepth = core->telemetry.count;
+    snapshot.spilledDepth = spilledDepth(core);
+    return snapshot;
+}
+
+bool outboxCoreHasTelemetry(const OutboxCore* core) {
+    return core->telemetry.count > 0 || spilledDepth(core) > 0;
+}
@@ -0,0 +1,337 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include "MY_Power.h"
+#include "MY_MQ2.h"
+#include "MY_K230.h"
+#include "MY_Sensor.h"
+#include "MY_Pump.h"
+#include "MY_Fan.h"
+#include "MY_Buzzer.h"
+#include "MY_Zone.h"
+#include "MY_Memory.h"
+
+// ==================== 全局变量定义 ====================
+SemaphoreHandle_t powerMutex = NULL;
+
+static PowerMode powerMode = POWER_MODE_OFF;
+static uint32_t holdMask = 0;
+static int64_t holdSinceUs = 0;         // 本次持有电源锁的开始时刻
+static int64_t heldUs = 0;              // 已结束的持有时间累计
+static PowerWakeStats smokeStats = {0, 0, 0};
+static PowerWakeStats k230Stats = {0, 0, 0};
+
+// 电源锁 (未开启电源管理时为NULL)
+static esp_pm_lock_handle_t cpuLock = NULL;     // 全速运行
+static esp_pm_lock_handle_t sleepLock = NULL;   // 禁止Light-sleep
+static esp_pm_lock_handle_t k230Lock = NULL;    // K230清醒窗口
+
+// 唤醒中断与任务之间共享 (wakeMux保护)
+static portMUX_TYPE wakeMux = portMUX_INITIALIZER_UNLOCKED;
+static int64_t smokeEdgeUs = 0;         // 0=没有待处理的唤醒
+static int64_t k230EdgeUs = 0;
+static bool k230Awake = false;
+static esp_timer_handle_t k230AwakeTimer = NULL;
+
+// ==================== 唤醒中断 ====================
+
+/**
+ * @brief MQ-2 DO低电平中断 (各分区共用，arg为触发的DO引脚)
+ * 电平中断会持续触发，进入后先关闭，由传感器任务在DO恢复高电平后重新开启
+ */
+static void IRAM_ATTR smokeWakeIsr(void* arg) {
+    gpio_intr_disable((gpio_num_t)(uintptr_t)arg);
+
+    portENTER_CRITICAL_ISR(&wakeMux);
+    smokeEdgeUs = esp_timer_get_time();
+    portEXIT_CRITICAL_ISR(&wakeMux);
+
+    BaseType_t woken = pdFALSE;
+    if (sensorTaskHandle != NULL) {
+        xTaskNotifyFromISR(sensorTaskHandle, SENSOR_NOTIFY_SAMPLE, eSetBits, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief K230 RX低电平中断 (串口起始位)
+ * 打开清醒窗口，窗口结束前不再响应，避免数据位反复触发
+ */
+static void IRAM_ATTR k230WakeIsr(void* arg) {
+    gpio_intr_disable((gpio_num_t)K230_RX_PIN);
+
+    portENTER_CRITICAL_ISR(&wakeMux);
+    if (!k230Awake) {
+        k230Awake = true;
+        esp_pm_lock_acquire(k230Lock);
+    }
+    k230EdgeUs = esp_timer_get_time();
+    portEXIT_CRITICAL_ISR(&wakeMux);
+
+    BaseType_t woken = pdFALSE;
+    if (k230TaskHandle != NULL) {
+        vTaskNotifyGiveFromISR(k230TaskHandle, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief K230清醒窗口结束，释放电源锁并重新开启线路唤醒
+ */
+static void k230AwakeTimerCallback(void* arg) {
+    portENTER_CRITICAL(&wakeMux);
+    if (k230Awake) {
+        k230Awake = false;
+        esp_pm_lock_release(k230Lock);
+    }
+    portEXIT_CRITICAL(&wakeMux);
+
+    gpio_intr_enable((gpio_num_t)K230_RX_PIN);
+}
+
+// ==================== 内部函数 ====================
+
+static void recordWake(PowerWakeStats* stats, int64_t latencyUs) {
+    uint32_t us = latencyUs > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)latencyUs;
+    if (xSemaphoreTake(powerMutex, portMAX_DELAY) == pdTRUE) {
+        stats->count++;
+        stats->lastUs = us;
+        if (us > stats->maxUs) {
+            stats->maxUs = us;
+        }
+        xSemaphoreGive(powerMutex);
+    }
+}
+
+/**
+ * @brief 按sdkconfig能力配置调频/睡眠，返回实际生效的模式
+ */
+static PowerMode configurePowerManagement() {
+#if POWER_MGMT_ENABLE
+#if CONFIG_PM_ENABLE
+    esp_pm_config_esp32s3_t pmConfig;
+    pmConfig.max_freq_mhz = POWER_CPU_MAX_MHZ;
+    pmConfig.min_freq_mhz = POWER_CPU_MIN_MHZ;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    pmConfig.light_sleep_enable = true;
+#else
+    pmConfig.light_sleep_enable = false;
+    Serial.println("[POWER] CONFIG_FREERTOS_USE_TICKLESS_IDLE not set, light sleep disabled");
+#endif
+
+    esp_err_t err = esp_pm_configure(&pmConfig);
+    if (err != ESP_OK) {
+        Serial.println("[POWER] esp_pm_configure failed: " + String(esp_err_to_name(err)));
+        return POWER_MODE_OFF;
+    }
+
+    esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "hold_cpu", &cpuLock);
+    esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "hold_sleep", &sleepLock);
+    if (!pmConfig.light_sleep_enable) {
+        return POWER_MODE_DFS;
+    }
+    esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "k230_awake", &k230Lock);
+    return POWER_MODE_LIGHT_SLEEP;
+#else
+    Serial.println("[POWER] CONFIG_PM_ENABLE not set, power management unavailable");
+#endif
+#endif
+    return POWER_MODE_OFF;
+}
+
+/**
+ * @brief 配置Light-sleep唤醒源
+ * 执行器引脚关闭睡眠切换，保证睡眠期间继电器/蜂鸣器电平不变
+ */
+static void setupSleepWakeSources() {
+    const gpio_num_t keepPins[] = {
+        (gpio_num_t)PUMP_RELAY_PIN, (gpio_num_t)FAN_RELAY_PIN, (gpio_num_t)BUZZER_PIN,
+        (gpio_num_t)K230_RX_PIN
+    };
+    for (size_t i = 0; i < sizeof(keepPins) / sizeof(keepPins[0]); i++) {
+        gpio_sleep_sel_dis(keepPins[i]);
+    }
+    // 各分区的DO唤醒引脚与分区执行器
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        gpio_sleep_sel_dis((gpio_num_t)zoneTable[z].mq2DoPin);
+        gpio_wakeup_enable((gpio_num_t)zoneTable[z].mq2DoPin, GPIO_INTR_LOW_LEVEL);
+        if (zoneTable[z].fanPin != ZONE_NO_PIN) gpio_sleep_sel_dis((gpio_num_t)zoneTable[z].fanPin);
+        if (zoneTable[z].valvePin != ZONE_NO_PIN) gpio_sleep_sel_dis((gpio_num_t)zoneTable[z].valvePin);
+    }
+
+    gpio_wakeup_enable((gpio_num_t)K230_RX_PIN, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = k230AwakeTimerCallback;
+    timerArgs.name = "k230_awake";
+    esp_timer_create(&timerArgs, &k230AwakeTimer);
+
+    gpio_isr_handler_add((gpio_num_t)K230_RX_PIN, k230WakeIsr, NULL);
+    gpio_intr_enable((gpio_num_t)K230_RX_PIN);
+}
+
+// ==================== 初始化函数 ====================
+
+/**
+ * @brief 初始化电源管理模块
+ *
+ * 各分区的MQ-2 DO中断在任何模式下都开启，烟雾出现时无需等到下一个采样周期
+ */
+void setupPower() {
+    // 创建互斥锁
+    powerMutex = CREATE_MODULE_MUTEX();
+
+    powerMode = configurePowerManagement();
+
+    // 已被其他模块安装时返回ESP_ERR_INVALID_STATE，可忽略
+    gpio_install_isr_service(0);
+
+    if (powerMode == POWER_MODE_LIGHT_SLEEP) {
+        setupSleepWakeSources();
+    }
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        gpio_num_t doPin = (gpio_num_t)zoneTable[z].mq2DoPin;
+        if (powerMode != POWER_MODE_LIGHT_SLEEP) {
+            gpio_set_intr_type(doPin, GPIO_INTR_LOW_LEVEL);
+        }
+        gpio_isr_handler_add(doPin, smokeWakeIsr, (void*)(uintptr_t)doPin);
+        gpio_intr_enable(doPin);
+    }
+
+    Serial.println("[POWER] ========== Power Module Init ==========");
+    Serial.println("[POWER] Mode: " + String(getPowerModeString()));
+    if (powerMode != POWER_MODE_OFF) {
+        Serial.println("[POWER] CPU: " + String(POWER_CPU_MIN_MHZ) + "-" + String(POWER_CPU_MAX_MHZ) + " MHz");
+    }
+    if (powerMode == POWER_MODE_LIGHT_SLEEP) {
+        Serial.println("[POWER] Wake: MQ-2 DO (" + String(ZONE_COUNT) + " zones), K230 RX (GPIO" + String(K230_RX_PIN) + "), timers");
+    }
+    Serial.println("[POWER] ========================================");
+}
+
+// ==================== 电源锁 ====================
+
+/**
+ * @brief 设置/清除电源锁持有者
+ *
+ * 第一个持有者出现时获取全速和禁止睡眠锁，最后一个释放时归还
+ * 可在定时器回调中调用，不可在中断中调用
+ */
+void powerSetHold(uint32_t source, bool active) {
+    if (powerMutex == NULL) return;
+
+    if (xSemaphoreTake(powerMutex, portMAX_DELAY) == pdTRUE) {
+        uint32_t mask = active ? (holdMask | source) : (holdMask & ~source);
+        int64_t now = esp_timer_get_time();
+
+        if (holdMask == 0 && mask != 0) {
+            if (cpuLock != NULL) esp_pm_lock_acquire(cpuLock);
+            if (sleepLock != NULL) esp_pm_lock_acquire(sleepLock);
+            holdSinceUs = now;
+        } else if (holdMask != 0 && mask == 0) {
+            if (sleepLock != NULL) esp_pm_lock_release(sleepLock);
+            if (cpuLock != NULL) esp_pm_lock_release(cpuLock);
+            heldUs += now - holdSinceUs;
+        }
+        holdMask = mask;
+
+        xSemaphoreGive(powerMutex);
+    }
+}
+
+// ==================== 唤醒处理 ====================
+
+/**
+ * @brief 传感器任务被唤醒后对每个分区调用
+ * @param doPin 分区的MQ-2 DO引脚
+ * @param smokeAlarm 本次采样DO是否为报警电平
+ */
+void powerSmokeWakeHandled(uint8_t doPin, bool smokeAlarm) {
+    if (powerMutex == NULL) return;
+
+    portENTER_CRITICAL(&wakeMux);
+    int64_t edgeUs = smokeEdgeUs;
+    smokeEdgeUs = 0;
+    portEXIT_CRITICAL(&wakeMux);
+
+    if (edgeUs != 0) {
+        recordWake(&smokeStats, esp_timer_get_time() - edgeUs);
+    }
+
+    // DO仍为低电平时保持关闭，避免电平中断反复进入
+    if (!smokeAlarm) {
+        gpio_intr_enable((gpio_num_t)doPin);
+    }
+}
+
+/**
+ * @brief K230任务收到数据后调用
+ */
+void powerK230Activity() {
+    if (powerMode != POWER_MODE_LIGHT_SLEEP) return;
+
+    portENTER_CRITICAL(&wakeMux);
+    int64_t edgeUs = k230EdgeUs;
+    k230EdgeUs = 0;
+    bool awake = k230Awake;
+    portEXIT_CRITICAL(&wakeMux);
+
+    if (edgeUs != 0) {
+        recordWake(&k230Stats, esp_timer_get_time() - edgeUs);
+    }
+
+    // 持续有数据时延长窗口
+    if (awake) {
+        esp_timer_stop(k230AwakeTimer);
+        esp_timer_start_once(k230AwakeTimer, (uint64_t)POWER_K230_AWAKE_MS * 1000);
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+PowerStatus getPowerStatus() {
+    PowerStatus status = {};
+    status.mode = powerMode;
+    if (powerMutex == NULL) return status;
+
+    if (xSemaphoreTake(powerMutex, portMAX_DELAY) == pdTRUE) {
+        int64_t now = esp_timer_get_time();
+        int64_t held = heldUs + (holdMask != 0 ? now - holdSinceUs : 0);
+        status.holdMask = holdMask;
+        status.fullPowerPct = now > 0 ? (uint8_t)(held * 100 / now) : 0;
+        status.smokeWake = smokeStats;
+        status.k230Wake = k230Stats;
+        xSemaphoreGive(powerMutex);
+    }
+    return status;
+}
+
+const char* getPowerModeString() {
+    switch (powerMode) {
+        case POWER_MODE_DFS:         return "dfs";
+        case POWER_MODE_LIGHT_SLEEP: return "light_sleep";
+        default:                     return "off";
+    }
+}
+
+/**
+ * @brief 打印电源状态
+ * 开启 CONFIG_PM_PROFILING 时附带各电源锁持有时间与各频率/睡眠模式的驻留时间，
+ * 结合外接电流表读数可估算空闲电流
+ */
+void printPowerReport() {
+    PowerStatus status = getPowerStatus();
+    Serial.println("Power: Mode=" + String(getPowerModeString()) +
+                   ", Holds=0x" + String(status.holdMask, HEX) +
+                   ", FullPower=" + String(status.fullPowerPct) + "%");
+    Serial.println("Wake:  Smoke " + String(status.smokeWake.count) + "x last/max " +
+                   String(status.smokeWake.lastUs) + "/" + String(status.smokeWake.maxUs) + "us" +
+                   ", K230 " + String(status.k230Wake.count) + "x last/max " +
+                   String(status.k230Wake.lastUs) + "/" + String(status.k230Wake.maxUs) + "us");
+#if CONFIG_PM_PROFILING
+    esp_pm_dump_locks(stdout);
+#endif
+}
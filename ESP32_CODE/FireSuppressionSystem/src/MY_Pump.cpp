@@ -1,9 +1,22 @@
+#include <Arduino.h>
+#include <esp_timer.h>
 #include "MY_Pump.h"
 #include "MY_DHT11.h"
 #include "MY_MQ2.h"
 #include "MY_Fan.h"
 #include "MY_Sensor.h"
 #include "MY_K230.h"
+#include "MY_Fusion.h"
+#include "MY_Zone.h"
+#include "MY_MQTT.h"
+#include "MY_Boot.h"
+#include "MY_Config.h"
+#include "MY_Actuator.h"
+#include "MY_Power.h"
+#include "MY_Supervisor.h"
+#include "MY_Memory.h"
+#include "MY_Classifier.h"
+
 // ==================== 全局变量定义 ====================
 PumpControl pumpControl = {
     .state = PUMP_OFF,
@@ -12,68 +25,332 @@ PumpControl pumpControl = {
     .lastStopTime = 0,
     .totalSprayTime = 0,
     .sprayCount = 0,
-    .fireDetected = false
+    .fireDetected = false,
+    .relayOn = false,
+    .pulsesRemaining = 0,
+    .timerMaxLateUs = 0,
+    .sprayHeld = false,
+    .sprayHoldCount = 0
 };
 
 TaskHandle_t pumpTaskHandle = NULL;
 SemaphoreHandle_t pumpMutex = NULL;
 
-// 内部变量：自动关闭定时器
-static unsigned long autoStopTime = 0;
-static bool autoStopEnabled = false;
+// 喷水阶段 (由定时器推进)
+typedef enum {
+    SPRAY_PHASE_IDLE = 0,       // 无定时任务
+    SPRAY_PHASE_ON,             // 脉冲喷水中
+    SPRAY_PHASE_OFF,            // 脉冲间隔
+    SPRAY_PHASE_COOLDOWN        // 占空比预算耗尽，等待恢复
+} SprayPhase;
+
+// 内部变量：喷水节拍定时器
+// 时间统一使用 esp_timer_get_time() 的64位微秒计数，不存在 millis() 回绕问题
+static Actuator<PUMP_RELAY_PIN, HIGH, MaxOnTimePolicy<PUMP_HARD_MAX_ON_MS> > pumpRelay;
+static esp_timer_handle_t sprayTimer = NULL;
+
+// 定时器回调与水泵任务共享 (sprayMux保护)：回调只按截止时间切换继电器并记下切换时刻，
+// 占空比记账与下一阶段的安排由 pumpTask 在pumpMutex内完成 (见 advanceSprayPhase)
+static portMUX_TYPE sprayMux = portMUX_INITIALIZER_UNLOCKED;
+static SprayPhase sprayPhase = SPRAY_PHASE_IDLE;
+static int64_t phaseDeadlineUs = 0;     // 当前阶段结束时刻
+static bool relayAtDeadline = false;    // 截止时刻继电器应切换到的电平
+static int64_t edgeUs = 0;              // 回调已切换、尚未记账的时刻 (0=无)
+
+// 以下只在持有pumpMutex时访问
+static uint32_t patternOnMs = 0;
+static uint32_t patternOffMs = 0;
+static uint32_t nextPulseMs = 0;        // 脉冲间隔结束后下一个脉冲的长度 (已按预算截短)
+
+// 内部变量：占空比模型 (见 MY_PumpDuty.h)
+static PumpDutyModel dutyModel;
+
+// ==================== 占空比模型 (调用方需持有pumpMutex) ====================
+
+// 窗口与占空比取自运行时配置，在线修改后立即生效
+static PumpDutyLimits dutyLimits() {
+    const SystemConfig* cfg = getConfig();
+    return pumpDutyMakeLimits(cfg->pumpDutyWindowMs, cfg->pumpDutyPercent);
+}
+
+static int64_t dutyBudgetAtUs(int64_t atUs, int64_t nowUs) {
+    PumpDutyLimits limits = dutyLimits();
+    return pumpDutyBudgetAtUs(&dutyModel, &limits, atUs, nowUs);
+}
+
+static int64_t dutyBudgetUs(int64_t nowUs) {
+    return dutyBudgetAtUs(nowUs, nowUs);
+}
+
+// 停泵状态下恢复可用 (预算达到 PUMP_DUTY_RESUME_MS) 还需的时间 (毫秒)
+static uint32_t dutyResumeWaitMs(int64_t nowUs) {
+    PumpDutyLimits limits = dutyLimits();
+    return pumpDutyWaitMs(&dutyModel, &limits, nowUs, pumpDutyResumeUs(&limits));
+}
+
+// ==================== 继电器输出 (定时器回调与任务共用) ====================
+
+/**
+ * @brief 进入新阶段并启动单次定时器
+ *
+ * 继电器输出与阶段切换在同一临界区内完成，过期回调只能看到新阶段，不会覆盖本次输出。
+ * 定时器只负责按时唤醒，是否切换由 applyDueEdge() 根据截止时间判断
+ */
+static void enterPhase(SprayPhase phase, bool relayOn, int64_t deadlineUs, bool levelAtDeadline) {
+    portENTER_CRITICAL(&sprayMux);
+    pumpRelay.set(relayOn);
+    sprayPhase = phase;
+    phaseDeadlineUs = deadlineUs;
+    relayAtDeadline = levelAtDeadline;
+    edgeUs = 0;
+    portEXIT_CRITICAL(&sprayMux);
+
+    if (sprayTimer != NULL) {
+        esp_timer_stop(sprayTimer);
+        if (phase != SPRAY_PHASE_IDLE) {
+            int64_t delayUs = deadlineUs - esp_timer_get_time();
+            esp_timer_start_once(sprayTimer, delayUs > 0 ? (uint64_t)delayUs : 0);
+        }
+    }
+}
+
+/**
+ * @brief 截止时间已到则切换继电器并记下切换时刻
+ * @return true=本次发生了切换，需要 advanceSprayPhase() 记账
+ */
+static bool applyDueEdge(int64_t nowUs) {
+    bool applied = false;
+    portENTER_CRITICAL(&sprayMux);
+    if (sprayPhase != SPRAY_PHASE_IDLE && edgeUs == 0 && nowUs >= phaseDeadlineUs) {
+        pumpRelay.set(relayAtDeadline);
+        edgeUs = nowUs;
+        applied = true;
+    }
+    portEXIT_CRITICAL(&sprayMux);
+    return applied;
+}
+
+/**
+ * @brief esp_timer 回调 (运行在esp_timer任务中)
+ * 不获取pumpMutex，切换继电器后通知 pumpTask 记账；不打印日志，状态变化由 pumpTask 输出
+ */
+static void sprayTimerCallback(void* arg) {
+    if (applyDueEdge(esp_timer_get_time()) && pumpTaskHandle != NULL) {
+        xTaskNotifyGive(pumpTaskHandle);
+    }
+}
+
+// ==================== 内部函数 (调用方需持有pumpMutex) ====================
+
+// 继电器切换后的记账 (输出已由 enterPhase/applyDueEdge 完成)
+static void noteRelay(bool on, int64_t atUs) {
+    if (on && !pumpControl.relayOn) {
+        pumpDutyStart(&dutyModel, atUs);
+    } else if (!on && pumpControl.relayOn) {
+        PumpDutyLimits limits = dutyLimits();
+        pumpControl.totalSprayTime += (unsigned long)(pumpDutyStop(&dutyModel, &limits, atUs) / 1000);
+    }
+    pumpControl.relayOn = on;
+    powerSetHold(POWER_HOLD_PUMP, on);
+}
+
+/**
+ * @brief 停泵后根据剩余预算决定状态
+ * 预算足够则立即可用 (PUMP_OFF)，否则进入 PUMP_COOLDOWN 并在预算恢复时自动退出
+ */
+static void updateRestState(int64_t nowUs) {
+    uint32_t waitMs = dutyResumeWaitMs(nowUs);
+    if (waitMs == 0) {
+        pumpControl.state = PUMP_OFF;
+        enterPhase(SPRAY_PHASE_IDLE, false, 0, false);
+    } else {
+        pumpControl.state = PUMP_COOLDOWN;
+        enterPhase(SPRAY_PHASE_COOLDOWN, false, nowUs + (int64_t)waitMs * 1000, false);
+    }
+}
+
+static void finishSpray(int64_t nowUs) {
+    enterPhase(SPRAY_PHASE_IDLE, false, 0, false);
+    noteRelay(false, nowUs);
+    pumpControl.lastStopTime = millis();
+    pumpControl.pulsesRemaining = 0;
+    updateRestState(nowUs);
+}
+
+/**
+ * @brief 按剩余预算开始一个脉冲
+ * @return false=预算不足一个最短脉冲
+ */
+static bool startPulse(uint32_t onMs, int64_t nowUs) {
+    uint32_t budgetMs = (uint32_t)(dutyBudgetUs(nowUs) / 1000);
+    if (onMs > budgetMs) onMs = budgetMs;
+    if (onMs < PUMP_MIN_PULSE_MS) return false;
+
+    enterPhase(SPRAY_PHASE_ON, true, nowUs + (int64_t)onMs * 1000, false);
+    noteRelay(true, nowUs);
+    return true;
+}
+
+/**
+ * @brief 为回调已完成的切换记账，并安排下一阶段
+ *
+ * 由 pumpTask 在收到定时器通知后调用，每个周期也会调用一次作为兜底
+ * (定时器创建失败或回调未运行时，在此按截止时间切换)。
+ * 记账使用回调记下的切换时刻，任务调度延迟不影响占空比统计和下一阶段的截止时间。
+ * 脉冲间隔的下一个脉冲长度在进入间隔时就已按预算算好，回调到期直接导通即可。
+ */
+static void advanceSprayPhase() {
+    applyDueEdge(esp_timer_get_time());
+
+    portENTER_CRITICAL(&sprayMux);
+    SprayPhase phase = sprayPhase;
+    int64_t deadlineUs = phaseDeadlineUs;
+    bool relayOn = relayAtDeadline;
+    int64_t atUs = edgeUs;
+    portEXIT_CRITICAL(&sprayMux);
+    if (atUs == 0) return;
+
+    uint32_t lateUs = (uint32_t)(atUs - deadlineUs);
+    if (lateUs > pumpControl.timerMaxLateUs) {
+        pumpControl.timerMaxLateUs = lateUs;
+    }
+
+    switch (phase) {
+        case SPRAY_PHASE_ON:
+            noteRelay(false, atUs);
+            if (pumpControl.pulsesRemaining > 0) {
+                pumpControl.pulsesRemaining--;
+            }
+            if (pumpControl.pulsesRemaining > 0) {
+                // 间隔期间不喷水，间隔结束时的预算现在就能确定
+                int64_t offEndUs = atUs + (int64_t)patternOffMs * 1000;
+                uint32_t budgetMs = (uint32_t)(dutyBudgetAtUs(offEndUs, atUs) / 1000);
+                nextPulseMs = patternOnMs < budgetMs ? patternOnMs : budgetMs;
+                enterPhase(SPRAY_PHASE_OFF, false, offEndUs, nextPulseMs >= PUMP_MIN_PULSE_MS);
+            } else {
+                finishSpray(atUs);
+            }
+            break;
+
+        case SPRAY_PHASE_OFF:
+            if (relayOn) {
+                noteRelay(true, atUs);
+                enterPhase(SPRAY_PHASE_ON, true, atUs + (int64_t)nextPulseMs * 1000, false);
+            } else {
+                finishSpray(atUs);
+            }
+            break;
+
+        case SPRAY_PHASE_COOLDOWN:
+            updateRestState(atUs);
+            break;
+
+        default:
+            break;
+    }
+}
 
 // ==================== 初始化函数 ====================
 
 void setupPump() {
     // 创建互斥锁
-    pumpMutex = xSemaphoreCreateMutex();
+    pumpMutex = CREATE_MODULE_MUTEX();
     
-    // 配置GPIO
-    pinMode(PUMP_RELAY_PIN, OUTPUT);
-    digitalWrite(PUMP_RELAY_PIN, LOW);  // 初始关闭
+    // 配置GPIO (初始关闭)
+    pumpRelay.begin();
     
     pumpControl.state = PUMP_OFF;
     pumpControl.mode = PUMP_MODE_AUTO;
     pumpControl.lastStopTime = millis();
+
+    // 创建喷水定时器
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = sprayTimerCallback;
+    timerArgs.arg = NULL;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "pump_spray";
+    if (esp_timer_create(&timerArgs, &sprayTimer) != ESP_OK) {
+        sprayTimer = NULL;
+        Serial.println("[PUMP] Warning: spray timer create failed, falling back to task polling");
+    }
     
     Serial.println("[PUMP] ========== Pump Module Init ==========");
     Serial.println("[PUMP] GPIO: " + String(PUMP_RELAY_PIN));
     Serial.println("[PUMP] Mode: AUTO (default)");
-    Serial.println("[PUMP] Max spray duration: " + String(PUMP_MAX_DURATION_MS / 1000) + "s");
-    Serial.println("[PUMP] Cooldown time: " + String(PUMP_COOLDOWN_MS / 1000) + "s");
+    Serial.println("[PUMP] Max spray duration: " + String(getConfig()->pumpMaxDurationMs / 1000) + "s");
+    Serial.println("[PUMP] Duty limit: " + String(getConfig()->pumpDutyPercent) + "% of " + String(getConfig()->pumpDutyWindowMs / 1000) + "s window");
     Serial.println("[PUMP] ========================================");
 }
 
 // ==================== 水泵控制函数 ====================
 
 /**
- * @brief 开启水泵
- * 高电平触发继电器，NO口闭合，水泵启动
+ * @brief 脉冲喷水
+ * @param onMs 每个脉冲的喷水时间（受最大持续时间限制）
+ * @param offMs 脉冲间隔
+ * @param cycles 脉冲次数
+ * @return true=已开始, false=占空比预算不足
+ *
+ * 高电平触发继电器，NO口闭合，水泵启动。
+ * 每个脉冲还会被截短到当前剩余预算，预算用尽后提前结束并进入冷却。
+ * 正在喷水时调用会以新参数重新开始计时（与原 pumpSpray 行为一致）。
  */
-void pumpOn() {
+bool pumpSprayPattern(uint32_t onMs, uint32_t offMs, uint16_t cycles) {
+    uint32_t maxDuration = getConfig()->pumpMaxDurationMs;
+    if (onMs > maxDuration) onMs = maxDuration;
+    if (onMs < PUMP_MIN_PULSE_MS) onMs = PUMP_MIN_PULSE_MS;
+    if (cycles == 0) cycles = 1;
+    if (cycles > PUMP_MAX_PULSE_CYCLES) cycles = PUMP_MAX_PULSE_CYCLES;
+    if (offMs < PUMP_MIN_PULSE_OFF_MS) cycles = 1;
+
+    bool started = false;
+    bool wasOff = false;
+    uint32_t waitMs = 0;
     if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
-        // 检查是否在冷却中
-        if (pumpControl.state == PUMP_COOLDOWN) {
-            unsigned long remaining = getPumpRemainingCooldown();
-            Serial.println("[PUMP] Pump in cooldown, " + String(remaining / 1000) + "s remaining");
-            xSemaphoreGive(pumpMutex);
-            return;
+        advanceSprayPhase();
+        int64_t now = esp_timer_get_time();
+        // 冷却状态以模型为准：定时器尚未推进但预算已恢复时允许启动
+        waitMs = (pumpControl.state == PUMP_ON) ? 0 : dutyResumeWaitMs(now);
+        if (waitMs == 0) {
+            wasOff = (pumpControl.state != PUMP_ON);
+            patternOnMs = onMs;
+            patternOffMs = offMs;
+            if (startPulse(onMs, now)) {
+                if (wasOff) {
+                    pumpControl.sprayCount++;
+                    pumpControl.lastStartTime = millis();
+                }
+                pumpControl.pulsesRemaining = cycles;
+                pumpControl.state = PUMP_ON;
+                started = true;
+            } else if (pumpControl.state == PUMP_ON) {
+                // 喷水中重新下发但预算已不足：按正常结束处理
+                finishSpray(now);
+            }
         }
-        
-        if (pumpControl.state != PUMP_ON) {
-            digitalWrite(PUMP_RELAY_PIN, HIGH);  // 高电平触发
-            pumpControl.state = PUMP_ON;
-            pumpControl.lastStartTime = millis();
-            pumpControl.sprayCount++;
-            
-            // 设置最大运行时间保护
-            autoStopTime = millis() + PUMP_MAX_DURATION_MS;
-            autoStopEnabled = true;
-            
+        xSemaphoreGive(pumpMutex);
+    }
+
+    if (waitMs > 0) {
+        Serial.println("[PUMP] Duty budget exhausted, " + String(waitMs / 1000.0, 1) + "s until available");
+    } else if (started) {
+        if (wasOff) {
             Serial.println("[PUMP] >>> PUMP TURNED ON - SPRAYING <<<");
         }
-        xSemaphoreGive(pumpMutex);
+        if (cycles > 1) {
+            Serial.println("[PUMP] Pulse pattern: " + String(onMs) + "ms on / " + String(offMs) + "ms off x" + String(cycles));
+        } else {
+            Serial.println("[PUMP] Spray scheduled for " + String(onMs / 1000.0, 1) + "s");
+        }
     }
+    return started;
+}
+
+/**
+ * @brief 开启水泵（最长运行 pumpMaxDurationMs 后自动关闭）
+ */
+void pumpOn() {
+    pumpSprayPattern(getConfig()->pumpMaxDurationMs, 0, 1);
 }
 
 /**
@@ -81,25 +358,35 @@ void pumpOn() {
  * 低电平断开继电器，NO口断开，水泵停止
  */
 void pumpOff() {
+    bool stopped = false;
+    unsigned long sprayDuration = 0;
+    uint32_t budgetMs = 0;
     if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+        advanceSprayPhase();
         if (pumpControl.state == PUMP_ON) {
-            digitalWrite(PUMP_RELAY_PIN, LOW);  // 低电平断开
-            
-            // 计算本次喷水时间
-            unsigned long sprayDuration = millis() - pumpControl.lastStartTime;
-            pumpControl.totalSprayTime += sprayDuration;
-            
-            // 进入冷却状态
-            pumpControl.state = PUMP_COOLDOWN;
-            pumpControl.lastStopTime = millis();
-            autoStopEnabled = false;
-            
-            Serial.println("[PUMP] Pump turned OFF");
-            Serial.println("[PUMP] Spray duration: " + String(sprayDuration / 1000.0, 1) + "s");
-            Serial.println("[PUMP] Entering cooldown for " + String(PUMP_COOLDOWN_MS / 1000) + "s");
+            int64_t now = esp_timer_get_time();
+            finishSpray(now);
+            sprayDuration = pumpControl.lastStopTime - pumpControl.lastStartTime;
+            budgetMs = (uint32_t)(dutyBudgetUs(now) / 1000);
+            stopped = true;
         }
         xSemaphoreGive(pumpMutex);
     }
+
+    if (stopped) {
+        Serial.println("[PUMP] Pump turned OFF");
+        Serial.println("[PUMP] Spray duration: " + String(sprayDuration / 1000.0, 1) + "s");
+        Serial.println("[PUMP] Duty budget left: " + String(budgetMs / 1000.0, 1) + "s");
+    }
+}
+
+/**
+ * @brief 强制断开水泵继电器
+ * 不获取pumpMutex：监控模块在受控重启前调用，此时持有互斥锁的任务可能已经卡死
+ * 只进入临界区，同时停用定时阶段，过期回调不会重新接通继电器
+ */
+void pumpForceOff() {
+    enterPhase(SPRAY_PHASE_IDLE, false, 0, false);
 }
 
 /**
@@ -107,26 +394,7 @@ void pumpOff() {
  * @param durationMs 喷水持续时间（毫秒）
  */
 void pumpSpray(unsigned long durationMs) {
-    // 限制最大喷水时间
-    if (durationMs > PUMP_MAX_DURATION_MS) {
-        durationMs = PUMP_MAX_DURATION_MS;
-    }
-    
-    if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
-        if (pumpControl.state == PUMP_OFF || pumpControl.state == PUMP_ON) {
-            // 设置自动关闭时间
-            autoStopTime = millis() + durationMs;
-            autoStopEnabled = true;
-            xSemaphoreGive(pumpMutex);
-            
-            // 开启水泵
-            pumpOn();
-            
-            Serial.println("[PUMP] Spray scheduled for " + String(durationMs / 1000.0, 1) + "s");
-        } else {
-            xSemaphoreGive(pumpMutex);
-        }
-    }
+    pumpSprayPattern(durationMs, 0, 1);
 }
 
 // ==================== 状态获取函数 ====================
@@ -151,12 +419,13 @@ PumpMode getPumpMode() {
 
 /**
  * @brief 检查水泵是否可用
- * @return true=可用, false=冷却中
+ * @return true=喷水中或占空比预算已恢复, false=预算不足（冷却中）
  */
 bool isPumpAvailable() {
     bool available = false;
     if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
-        available = (pumpControl.state != PUMP_COOLDOWN);
+        available = (pumpControl.state == PUMP_ON) ||
+                    dutyResumeWaitMs(esp_timer_get_time()) == 0;
         xSemaphoreGive(pumpMutex);
     }
     return available;
@@ -164,22 +433,82 @@ bool isPumpAvailable() {
 
 /**
  * @brief 获取剩余冷却时间
- * @return 剩余冷却时间（毫秒），0表示已就绪
+ * @return 占空比预算恢复所需时间（毫秒），0表示已就绪
  */
 unsigned long getPumpRemainingCooldown() {
     unsigned long remaining = 0;
     if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
-        if (pumpControl.state == PUMP_COOLDOWN) {
-            unsigned long elapsed = millis() - pumpControl.lastStopTime;
-            if (elapsed < PUMP_COOLDOWN_MS) {
-                remaining = PUMP_COOLDOWN_MS - elapsed;
-            }
+        if (pumpControl.state != PUMP_ON) {
+            remaining = dutyResumeWaitMs(esp_timer_get_time());
         }
         xSemaphoreGive(pumpMutex);
     }
     return remaining;
 }
 
+/**
+ * @brief 获取占空比模型状态 (用于遥测上报)
+ */
+PumpDutyStatus getPumpDutyStatus() {
+    PumpDutyStatus status = {};
+    if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+        int64_t now = esp_timer_get_time();
+        PumpDutyLimits limits = dutyLimits();
+        status.windowMs = getConfig()->pumpDutyWindowMs;
+        status.capMs = (uint32_t)(limits.capUs / 1000);
+        status.usedMs = (uint32_t)(pumpDutyUsedUs(&dutyModel, &limits, now, now) / 1000);
+        status.budgetMs = (uint32_t)(dutyBudgetUs(now) / 1000);
+        status.recoverMs = (pumpControl.state == PUMP_ON) ? 0 : dutyResumeWaitMs(now);
+        xSemaphoreGive(pumpMutex);
+    }
+    return status;
+}
+
+bool isPumpRelayOn() {
+    bool on = false;
+    if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+        on = pumpControl.relayOn;
+        xSemaphoreGive(pumpMutex);
+    }
+    return on;
+}
+
+uint16_t getPumpPulsesRemaining() {
+    uint16_t pulses = 0;
+    if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+        pulses = pumpControl.pulsesRemaining;
+        xSemaphoreGive(pumpMutex);
+    }
+    return pulses;
+}
+
+uint32_t getPumpTimerMaxLateUs() {
+    uint32_t lateUs = 0;
+    if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+        lateUs = pumpControl.timerMaxLateUs;
+        xSemaphoreGive(pumpMutex);
+    }
+    return lateUs;
+}
+
+bool isPumpSprayHeld() {
+    bool held = false;
+    if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+        held = pumpControl.sprayHeld;
+        xSemaphoreGive(pumpMutex);
+    }
+    return held;
+}
+
+uint32_t getPumpSprayHoldCount() {
+    uint32_t count = 0;
+    if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+        count = pumpControl.sprayHoldCount;
+        xSemaphoreGive(pumpMutex);
+    }
+    return count;
+}
+
 // ==================== 模式设置函数 ====================
 
 void setPumpMode(PumpMode mode) {
@@ -214,16 +543,50 @@ const char* getPumpModeString() {
 
 // ==================== 自动控制函数 ====================
 
+// 干扰源暂缓 (只在水泵任务中访问)
+static bool sprayHoldStarted = false;       // 本次火灾已开始暂缓
+static unsigned long sprayHoldStartMs = 0;
+
 /**
- * @brief 根据传感器数据自动控制水泵
+ * @brief 本次火灾首次喷水前，判断是否因干扰源暂缓喷水
+ *
+ * K230视觉已确认火情时不暂缓；暂缓时长从本次火灾第一次暂缓起算，
+ * 分类结果中途翻转、等级在灭火与报警之间往复都不会重新计时，超过 CLS_MAX_HOLD_MS 后照常喷水
+ */
+static bool holdSprayForNuisance(const FireAssessment& fire) {
+    bool veto = fire.evidence[FUSION_SRC_K230] < FUSION_SOURCE_ACTIVE && classifierVetoesSpray(fire.zone);
+    if (!veto) return false;
+
+    unsigned long now = millis();
+    if (!sprayHoldStarted) {
+        sprayHoldStarted = true;
+        sprayHoldStartMs = now;
+        ClsZoneResult cls = getClassifierResult(fire.zone);
+        Serial.println("[PUMP] Nuisance source suspected in " + String(getZoneName(fire.zone)) +
+                       " (p=" + String(cls.result.prob[CLS_CLASS_NUISANCE], 2) + "), holding spray up to " +
+                       String(CLS_MAX_HOLD_MS / 1000) + "s");
+        queueAlarmEvent("pump", "spray_held", getZoneName(fire.zone));
+        if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+            pumpControl.sprayHoldCount++;
+            xSemaphoreGive(pumpMutex);
+        }
+    }
+    return now - sprayHoldStartMs < CLS_MAX_HOLD_MS;
+}
+
+/**
+ * @brief 根据火灾置信度自动控制水泵
  * 
- * 火灾判定逻辑（与风扇相同）：
- * - 温度 > 50°C 或 烟雾浓度 > 30% 或 烟雾报警 → 检测到火灾
+ * 火灾判定逻辑：
+ * - 融合评估达到灭火等级 (FIRE_LEVEL_SUPPRESS) → 检测到火灾
+ * - 单一传感器异常不足以触发喷水
+ * - 首次喷水前场景分类判定为干扰源时暂缓喷水，最多 CLS_MAX_HOLD_MS (见 holdSprayForNuisance)
  * 
  * 喷水策略：
- * - 检测到火灾时，自动喷水15秒
- * - 喷水后进入冷却期，防止水泵过热
- * - 冷却期结束后，如果仍检测到火灾，继续喷水
+ * - 检测到火灾时，自动喷水 pumpAutoSprayMs（视觉证据为主时使用 k230PumpSprayMs）
+ * - 喷水结束后只要占空比预算充足，仍检测到火灾就立即继续喷水
+ * - 预算用尽进入冷却，恢复后继续喷水
+ * - 每次火灾只上报一次 spray_started 事件，等级恢复安全 (FIRE_LEVEL_NONE) 才算本次火灾结束
  */
 void updatePumpAutoControl(float temperature, float smokeLevel, bool smokeAlarm) {
     // 仅在自动模式下执行
@@ -231,41 +594,48 @@ void updatePumpAutoControl(float temperature, float smokeLevel, bool smokeAlarm)
         return;
     }
     
-    // 判断是否处于火灾环境（使用与风扇相同的阈值）
-    bool highTemp = (temperature > TEMP_ALARM_THRESHOLD);
-    bool smokeDetected = (smokeLevel > SMOKE_ALARM_THRESHOLD) || smokeAlarm;
-    bool fireDetected = highTemp || smokeDetected;
+    // 判断是否处于火灾环境（融合置信度达到灭火等级）
+    const SystemConfig* cfg = getConfig();
+    FireAssessment fire = fusionAssessment();
+    bool fireDetected = (fire.level == FIRE_LEVEL_SUPPRESS);
+    uint32_t sprayMs = (fire.evidence[FUSION_SRC_K230] >= FUSION_SOURCE_ACTIVE) ? cfg->k230PumpSprayMs : cfg->pumpAutoSprayMs;
+
+    // 火灾检测：启动喷水
+    // 本次火灾 (已上报的 spray_started 与暂缓计时) 持续到融合等级恢复安全为止：
+    // 喷水压低读数后等级在灭火与报警之间往复属于同一次火灾，不重新上报、不重新暂缓
+    static bool fireEpisode = false;
+    bool held = false;
+    if (fire.level == FIRE_LEVEL_NONE) {
+        fireEpisode = false;
+        sprayHoldStarted = false;
+    } else if (fireDetected && !fireEpisode) {
+        held = holdSprayForNuisance(fire);
+    }
 
     // 更新火灾检测状态
     if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
         pumpControl.fireDetected = fireDetected;
+        pumpControl.sprayHeld = held;
         xSemaphoreGive(pumpMutex);
     }
 
-    // k230火焰确认
-    int K230FireConfirmed = 0;
-    if(xSemaphoreTake(k230Mutex, portMAX_DELAY) == pdTRUE){
-        K230FireConfirmed = k230Control.fireState;
-        xSemaphoreGive(k230Mutex);
-    }
-
-    if(K230FireConfirmed == K230_FIRE_CONFIRMED){
-        fireDetected = true; // K230确认火焰检测时强制触发喷水
-    }
-    
-    // 火灾检测：启动喷水
-    if (fireDetected) {
+    if (fireDetected && !held) {
         PumpState currentState = getPumpState();
         
         if (currentState == PUMP_OFF) {
-            Serial.println("[PUMP] !!! FIRE DETECTED - STARTING SPRAY !!!");
-            Serial.println("[PUMP] Temp: " + String(temperature) + "°C, Smoke: " + String(smokeLevel) + "%");
-            pumpSpray(PUMP_AUTO_SPRAY_MS);
+            if (!fireEpisode) {
+                Serial.println("[PUMP] !!! FIRE DETECTED - STARTING SPRAY !!!");
+                Serial.println("[PUMP] Temp: " + String(temperature) + "°C, Smoke: " + String(smokeLevel) + "%" +
+                               (smokeAlarm ? " (DO)" : "") + ", Score: " + String(fire.score, 2));
+                queueAlarmEvent("pump", "spray_started");
+                fireEpisode = true;
+            }
+            pumpSpray(sprayMs);
         } else if (currentState == PUMP_COOLDOWN) {
             // 冷却中，检查是否可以重新启动
             if (isPumpAvailable()) {
                 Serial.println("[PUMP] Cooldown complete, fire still detected, restarting spray");
-                pumpSpray(PUMP_AUTO_SPRAY_MS);
+                pumpSpray(sprayMs);
             }
         }
         // 如果正在喷水中，不做任何操作
@@ -279,55 +649,78 @@ void updatePumpAutoControl(float temperature, float smokeLevel, bool smokeAlarm)
  * @brief 水泵控制RTOS任务
  * 
  * 职责：
- * 1. 检查自动关闭定时器
- * 2. 管理冷却状态转换
- * 3. 在自动模式下根据传感器数据控制喷水
+ * 1. 为定时器回调的继电器切换记账并输出状态变化（回调切换后通知本任务）
+ * 2. 在自动模式下根据传感器数据控制喷水
  */
 void pumpTask(void *pvParameters) {
     Serial.println("[PUMP] Pump control task started on Core " + String(xPortGetCoreID()));
     
-    // 等待系统初始化
-    vTaskDelay(pdMS_TO_TICKS(3000));
+    // 等待首次采样（代替固定延时）
+    bootWaitFirstSample();
+
+    PumpState lastState = getPumpState();
+    int8_t supervisorId = supervisorRegister("Pump_Task", PUMP_TASK_PERIOD_MS, PUMP_TASK_DEADLINE_MS);
+    bootTaskReady(BOOT_READY_PUMP);
     
     for (;;) {
-        // 1. 检查自动关闭定时器
-        if (autoStopEnabled && millis() >= autoStopTime) {
-            Serial.println("[PUMP] Auto-stop timer triggered");
-            pumpOff();
-        }
-        
-        // 2. 检查冷却状态是否结束
+        supervisorCheckIn(supervisorId);
+
+        // 1. 兜底推进定时阶段（定时器正常时此处不会有动作），并记录状态变化
+        PumpState state = PUMP_OFF;
+        bool forcedOff = false;
         if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
-            if (pumpControl.state == PUMP_COOLDOWN) {
-                unsigned long elapsed = millis() - pumpControl.lastStopTime;
-                if (elapsed >= PUMP_COOLDOWN_MS) {
-                    pumpControl.state = PUMP_OFF;
-                    Serial.println("[PUMP] Cooldown complete, pump ready");
-                }
+            advanceSprayPhase();
+            // 继电器导通超过硬件上限时强制停泵（定时器失效时的最后防线）
+            portENTER_CRITICAL(&sprayMux);
+            bool expired = pumpRelay.service();
+            portEXIT_CRITICAL(&sprayMux);
+            if (expired) {
+                finishSpray(esp_timer_get_time());
+                forcedOff = true;
             }
+            state = pumpControl.state;
             xSemaphoreGive(pumpMutex);
         }
-        
-        // 获取传感器数据
-        float temperature;
-        float humidity;
-        float smokeLevel;
-        bool smokeAlarm;
-        if(xSemaphoreTake(sensorMutex, portMAX_DELAY) == pdTRUE){
-            temperature = sensorData.temperature;
-            humidity = sensorData.humidity;
-            smokeLevel = sensorData.smokeLevel;
-            smokeAlarm = sensorData.smokeAlarm;
-            xSemaphoreGive(sensorMutex);
+        if (forcedOff) {
+            Serial.println("[PUMP] !!! Relay on-time limit reached, pump forced OFF !!!");
         }
-        // 3. 自动模式下的传感器检测
-        if (isPumpAutoMode()) {
-            if (!isnan(sensorData.temperature)) {
-                updatePumpAutoControl(temperature, smokeLevel, smokeAlarm); 
+        if (state != lastState) {
+            if (state == PUMP_COOLDOWN) {
+                Serial.println("[PUMP] Duty budget exhausted, cooling down for " + String(getPumpRemainingCooldown() / 1000.0, 1) + "s");
+            } else if (lastState == PUMP_COOLDOWN && state == PUMP_OFF) {
+                Serial.println("[PUMP] Duty budget recovered, pump ready");
+            } else if (lastState == PUMP_ON && state == PUMP_OFF) {
+                Serial.println("[PUMP] Spray finished");
             }
+            lastState = state;
+        }
+        
+        // 获取传感器数据（水泵整层共用，取最严重分区的读数）
+        SensorData data = getSensorData(getFireZone());
+        float temperature = data.temperature;
+        float humidity = data.humidity;
+        float smokeLevel = data.smokeLevel;
+        bool smokeAlarm = data.smokeAlarm;
+
+        // 2. 先按各分区等级开关喷淋阀，阀门打开后水泵再喷水
+        zoneApplyOutputs();
+
+        // 3. 自动模式下按火灾置信度控制（温度读取失败由融合评估的过期衰减处理）
+        if (isPumpAutoMode()) {
+            updatePumpAutoControl(temperature, smokeLevel, smokeAlarm); 
         }
         
         // 任务周期：500ms（比风扇更频繁，确保及时响应）
-        vTaskDelay(pdMS_TO_TICKS(500));
+        // 等待期间收到定时器通知就立即记账，不等到下个周期
+        TickType_t periodStart = xTaskGetTickCount();
+        TickType_t period = pdMS_TO_TICKS(PUMP_TASK_PERIOD_MS);
+        TickType_t elapsed;
+        while ((elapsed = xTaskGetTickCount() - periodStart) < period) {
+            if (ulTaskNotifyTake(pdTRUE, period - elapsed) == 0) break;
+            if (xSemaphoreTake(pumpMutex, portMAX_DELAY) == pdTRUE) {
+                advanceSprayPhase();
+                xSemaphoreGive(pumpMutex);
+            }
+        }
     }
 }
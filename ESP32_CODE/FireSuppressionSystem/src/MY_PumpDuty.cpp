@@ -0,0 +1,98 @@
+#include <string.h>
+#include "MY_PumpDuty.h"
+
+PumpDutyLimits pumpDutyMakeLimits(uint32_t windowMs, uint32_t percent) {
+    PumpDutyLimits limits;
+    limits.windowUs = (int64_t)windowMs * 1000;
+    limits.capUs = (int64_t)windowMs * percent * 10;
+    return limits;
+}
+
+void pumpDutyInit(PumpDutyModel* model) {
+    memset(model, 0, sizeof(*model));
+}
+
+int64_t pumpDutyResumeUs(const PumpDutyLimits* limits) {
+    int64_t resume = (int64_t)PUMP_DUTY_RESUME_MS * 1000;
+    return resume < limits->capUs ? resume : limits->capUs;
+}
+
+static int64_t overlapUs(int64_t startUs, int64_t endUs, int64_t fromUs, int64_t toUs) {
+    if (startUs < fromUs) startUs = fromUs;
+    if (endUs > toUs) endUs = toUs;
+    return endUs > startUs ? endUs - startUs : 0;
+}
+
+int64_t pumpDutyUsedUs(const PumpDutyModel* model, const PumpDutyLimits* limits, int64_t atUs, int64_t nowUs) {
+    int64_t from = atUs - limits->windowUs;
+    int64_t used = 0;
+    for (uint8_t i = 0; i < model->count; i++) {
+        const OnInterval& iv = model->history[(model->head + i) % PUMP_DUTY_HISTORY];
+        used += overlapUs(iv.startUs, iv.endUs, from, atUs);
+    }
+    if (model->on) {
+        used += overlapUs(model->onSinceUs, nowUs, from, atUs);
+    }
+    return used;
+}
+
+int64_t pumpDutyBudgetAtUs(const PumpDutyModel* model, const PumpDutyLimits* limits, int64_t atUs, int64_t nowUs) {
+    int64_t budget = limits->capUs - pumpDutyUsedUs(model, limits, atUs, nowUs);
+    return budget > 0 ? budget : 0;
+}
+
+/**
+ * @brief 停泵后窗口内占用只减不增，二分查找预算恢复的时刻 (精度1毫秒)
+ */
+uint32_t pumpDutyWaitMs(const PumpDutyModel* model, const PumpDutyLimits* limits, int64_t nowUs, int64_t targetUs) {
+    if (limits->capUs - pumpDutyUsedUs(model, limits, nowUs, nowUs) >= targetUs) return 0;
+
+    int64_t lo = 0;
+    int64_t hi = limits->windowUs;      // 一个完整窗口后历史全部过期
+    while (hi - lo > 1000) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (limits->capUs - pumpDutyUsedUs(model, limits, nowUs + mid, nowUs) >= targetUs) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    return (uint32_t)((hi + 999) / 1000);
+}
+
+void pumpDutyStart(PumpDutyModel* model, int64_t atUs) {
+    if (model->on) return;
+    model->on = true;
+    model->onSinceUs = atUs;
+}
+
+static void recordOnInterval(PumpDutyModel* model, const PumpDutyLimits* limits, int64_t startUs, int64_t endUs) {
+    if (endUs <= startUs) return;
+
+    // 丢弃已滑出窗口的记录
+    int64_t from = endUs - limits->windowUs;
+    while (model->count > 0 && model->history[model->head].endUs <= from) {
+        model->head = (model->head + 1) % PUMP_DUTY_HISTORY;
+        model->count--;
+    }
+
+    // 记录已满：把最旧的两条合并为一条（合并后只会高估占用，偏安全）
+    if (model->count == PUMP_DUTY_HISTORY) {
+        uint8_t next = (model->head + 1) % PUMP_DUTY_HISTORY;
+        model->history[next].startUs = model->history[model->head].startUs;
+        model->head = next;
+        model->count--;
+    }
+
+    OnInterval& slot = model->history[(model->head + model->count) % PUMP_DUTY_HISTORY];
+    slot.startUs = startUs;
+    slot.endUs = endUs;
+    model->count++;
+}
+
+int64_t pumpDutyStop(PumpDutyModel* model, const PumpDutyLimits* limits, int64_t atUs) {
+    if (!model->on) return 0;
+    model->on = false;
+    recordOnInterval(model, limits, model->onSinceUs, atUs);
+    return atUs - model->onSinceUs;
+}
@@ -1,55 +1,149 @@
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "MY_Sensor.h"
 #include "MY_DHT11.h"
 #include "MY_MQ2.h"
+#include "MY_Buzzer.h"
+#include "MY_Power.h"
+#include "MY_Fusion.h"
+#include "MY_Zone.h"
+#include "MY_Supervisor.h"
+#include "MY_Memory.h"
+#include "MY_Boot.h"
+#include "MY_Dsp.h"
 
-SensorData sensorData = {
-    .temperature = 0.0f,
-    .humidity = 0.0f,
-    .smokeLevel = 0.0f,
-    .smokeAlarm = false
-};
+// 所有分区初始为0
+ZoneSensorData zoneSensorData = {};
 
 TaskHandle_t sensorTaskHandle = NULL;
 SemaphoreHandle_t sensorMutex = NULL; //互斥锁
 
+// 各分区的DHT11对象，第0区复用原有的全局 dht
+static DHT* zoneDht[ZONE_COUNT] = {};
+
 // ==================== 初始化函数 ====================
 
+/**
+ * @brief 初始化传感器模块
+ * 第0区的DHT11与MQ-2已在 setup() 中初始化，其余分区在此创建并配置
+ */
 void setupSensor() {
     // 创建互斥锁
-    sensorMutex = xSemaphoreCreateMutex();
+    sensorMutex = CREATE_MODULE_MUTEX();
+
+    zoneDht[0] = &dht;
+    for (uint8_t z = 1; z < ZONE_COUNT; z++) {
+        // 开机时一次性分配，之后不再释放
+        zoneDht[z] = new DHT(zoneTable[z].dhtPin, DHTTYPE);
+        zoneDht[z]->begin();
+        setupMQ2Pins(zoneTable[z].mq2AoPin, zoneTable[z].mq2DoPin);
+    }
     
-    Serial.println("[SENSOR] Sensor module initialized");
+    Serial.println("[SENSOR] Sensor module initialized, zones: " + String(ZONE_COUNT));
 }
 
 void sensorTask(void *pvParameters) {
     Serial.println("Sensor Task Started on Core " + String(xPortGetCoreID()));
+
+    int8_t supervisorId = supervisorRegister("Sensor_Task", SENSOR_READ_INTERVAL_MS, SENSOR_TASK_DEADLINE_MS);
+    bool firstSample = true;
     
     for (;;) {
-        // 读取DHT11传感器数据
-        if(xSemaphoreTake(sensorMutex,portMAX_DELAY)==pdTRUE){
-            sensorData.humidity = dht.readHumidity();
-            sensorData.temperature = dht.readTemperature();
+        supervisorCheckIn(supervisorId);
 
-            MQ2Data mq2Data = readMQ2();
+        // 依次读取全部分区的DHT11与MQ-2
+        int64_t sampleStart = esp_timer_get_time();
+        if(xSemaphoreTake(sensorMutex,portMAX_DELAY)==pdTRUE){
+            for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+                zoneSensorData.humidity[z] = zoneDht[z]->readHumidity();
+                zoneSensorData.temperature[z] = zoneDht[z]->readTemperature();
 
-            sensorData.smokeLevel = mq2Data.smokeLevel;
-            sensorData.smokeAlarm = mq2Data.digitalAlarm;
+                MQ2Data mq2Data = readMQ2Pins(zoneTable[z].mq2AoPin, zoneTable[z].mq2DoPin);
 
+                zoneSensorData.smokeLevel[z] = mq2Data.smokeLevel;
+                zoneSensorData.smokeAlarm[z] = mq2Data.digitalAlarm;
+            }
             xSemaphoreGive(sensorMutex);
         }
+        int64_t evalStart = esp_timer_get_time();
+
+        // 温度送入窗口特征 (MQ-2由DSP任务高速采样)
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+            dspPushTemperature(z, zoneSensorData.temperature[z]);
+        }
+
+        // 更新融合评估证据并一次评估全部分区（温度为NaN时仅跳过该分区温度源）
+        fusionUpdateSensors(&zoneSensorData);
+        fusionEvaluate();
+        int64_t evalEnd = esp_timer_get_time();
+
+        zoneRecordCycle((uint32_t)(evalStart - sampleStart), (uint32_t)(evalEnd - evalStart));
+
+        // 新数据就绪，唤醒蜂鸣器任务重新评估
+        buzzerNotify();
+
+        // 首次采样完成，放行等待中的控制任务
+        if (firstSample) {
+            bootTaskReady(BOOT_READY_SENSOR);
+            firstSample = false;
+        }
 
-        // 输出传感器数据到串口
-        Serial.print(F("Sensor Data - Temp: "));
-        Serial.print(sensorData.temperature);
-        Serial.print(F("°C, Humidity: "));
-        Serial.print(sensorData.humidity);
-        Serial.print(F("%, Smoke Level: "));
-        Serial.print(sensorData.smokeLevel);
-        Serial.print(F("%, Smoke Alarm: "));
-        Serial.println(sensorData.smokeAlarm ? "YES" : "NO");
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+            SensorData data = getSensorData(z);
+
+            // 记录烟雾唤醒延迟，DO恢复后重新开启唤醒中断
+            powerSmokeWakeHandled(zoneTable[z].mq2DoPin, data.smokeAlarm);
+
+            // 输出传感器数据到串口
+            Serial.print(F("Sensor Data ["));
+            Serial.print(zoneTable[z].name);
+            Serial.print(F("] - Temp: "));
+            Serial.print(data.temperature);
+            Serial.print(F("°C, Humidity: "));
+            Serial.print(data.humidity);
+            Serial.print(F("%, Smoke Level: "));
+            Serial.print(data.smokeLevel);
+            Serial.print(F("%, Smoke Alarm: "));
+            Serial.println(data.smokeAlarm ? "YES" : "NO");
+        }
         
-        // 延时2秒后再次读取
-        vTaskDelay(pdMS_TO_TICKS(2000));
+        // 每2秒读取一次，MQ-2 DO报警时由中断提前唤醒；
+        // K230帧到达时只重新评估并唤醒蜂鸣器任务，采样周期不变
+        TickType_t periodStart = xTaskGetTickCount();
+        TickType_t period = pdMS_TO_TICKS(SENSOR_READ_INTERVAL_MS);
+        TickType_t elapsed;
+        while ((elapsed = xTaskGetTickCount() - periodStart) < period) {
+            uint32_t bits = 0;
+            if (xTaskNotifyWait(0, UINT32_MAX, &bits, period - elapsed) == pdFALSE) break;
+            if (bits & SENSOR_NOTIFY_SAMPLE) break;
+            if (bits & SENSOR_NOTIFY_EVALUATE) {
+                fusionEvaluate();
+                buzzerNotify();
+            }
+        }
+    }
+}
+
+/**
+ * @brief 请求传感器任务立即重新评估融合等级
+ * 评估只在传感器任务中进行，这里只设置通知位
+ */
+void sensorRequestEvaluate() {
+    if (sensorTaskHandle != NULL) {
+        xTaskNotify(sensorTaskHandle, SENSOR_NOTIFY_EVALUATE, eSetBits);
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+SensorData getSensorData(uint8_t zone) {
+    SensorData data = {NAN, NAN, 0.0f, false};
+    if (zone < ZONE_COUNT && xSemaphoreTake(sensorMutex, portMAX_DELAY) == pdTRUE) {
+        data.temperature = zoneSensorData.temperature[zone];
+        data.humidity = zoneSensorData.humidity[zone];
+        data.smokeLevel = zoneSensorData.smokeLevel[zone];
+        data.smokeAlarm = zoneSensorData.smokeAlarm[zone];
+        xSemaphoreGive(sensorMutex);
     }
-}
\ No newline at end of file
+    return data;
+}
@@ -0,0 +1,190 @@
+#include "MY_SensorPayload.h"
+#include "MY_JsonLite.h"
+
+// ==================== 内部函数 ====================
+
+static void writeZone(JsonLiteWriter* w, const SensorPayloadZone* zone) {
+    jsonLiteBeginObject(w, NULL);
+    jsonLiteString(w, "name", zone->name);
+    jsonLiteFixed(w, "temperature", zone->temperature, 1);
+    jsonLiteFixed(w, "humidity", zone->humidity, 1);
+    jsonLiteFixed(w, "smoke_level", zone->smokeLevel, 1);
+    jsonLiteBool(w, "smoke_alarm", zone->smokeAlarm);
+    jsonLiteFixed(w, "fire_score", zone->fireScore, 3);
+    jsonLiteString(w, "fire_level", zone->fireLevel);
+    jsonLiteBool(w, "fan", zone->fan);
+    jsonLiteBool(w, "valve", zone->valve);
+
+    if (zone->smokeValid) {
+        jsonLiteBeginObject(w, "dsp");
+        jsonLiteFixed(w, "smoke_var", zone->smoke.variance, 3);
+        jsonLiteFixed(w, "smoke_slope", zone->smoke.slope, 3);
+        jsonLiteFixed(w, "smoke_zcr", zone->smoke.zcr, 2);
+        jsonLiteBeginArray(w, "smoke_bands");
+        for (uint8_t b = 0; b < zone->smokeBandCount && b < DSP_MAX_BANDS; b++) {
+            jsonLiteFixed(w, NULL, zone->smoke.bandEnergy[b], 3);
+        }
+        jsonLiteEndArray(w);
+        if (zone->tempValid) {
+            jsonLiteFixed(w, "temp_var", zone->temp.variance, 3);
+            jsonLiteFixed(w, "temp_slope", zone->temp.slope, 4);
+            jsonLiteFixed(w, "temp_zcr", zone->temp.zcr, 2);
+        }
+        jsonLiteEndObject(w);
+    }
+
+    if (zone->clsValid) {
+        jsonLiteBeginObject(w, "cls");
+        jsonLiteString(w, "class", zone->clsClass);
+        jsonLiteFixed(w, "p_nuisance", zone->pNuisance, 2);
+        jsonLiteFixed(w, "p_fire", zone->pFire, 2);
+        jsonLiteEndObject(w);
+    }
+    jsonLiteEndObject(w);
+}
+
+// ==================== 序列化 ====================
+
+size_t sensorPayloadBuild(const SensorPayload* p, char* buffer, size_t size) {
+    JsonLiteWriter w;
+    jsonLiteBegin(&w, buffer, size);
+    jsonLiteBeginObject(&w, NULL);
+
+    jsonLiteString(&w, "device_id", p->deviceId);
+    jsonLiteFixed(&w, "temperature", p->temperature, 1);
+    jsonLiteFixed(&w, "humidity", p->humidity, 1);
+    jsonLiteFixed(&w, "smoke_level", p->smokeLevel, 1);
+    jsonLiteBool(&w, "smoke_alarm", p->smokeAlarm);
+
+    // 风扇状态
+    jsonLiteString(&w, "fan_state", p->fanState);
+    jsonLiteString(&w, "fan_mode", p->fanMode);
+    jsonLiteUint(&w, "fan_speed", p->fanSpeed);
+    jsonLiteBool(&w, "fan_purging", p->fanPurging);
+
+    // 水泵状态
+    jsonLiteString(&w, "pump_state", p->pumpState);
+    jsonLiteString(&w, "pump_mode", p->pumpMode);
+    jsonLiteBool(&w, "pump_relay", p->pumpRelay);
+    jsonLiteUint(&w, "pump_pulses_left", p->pumpPulsesLeft);
+    jsonLiteUint(&w, "pump_timer_late_us", p->pumpTimerLateUs);
+    jsonLiteBool(&w, "pump_held", p->pumpHeld);
+    jsonLiteUint(&w, "pump_holds", p->pumpHolds);
+    jsonLiteUint(&w, "pump_duty_used_ms", p->pumpDutyUsedMs);
+    jsonLiteUint(&w, "pump_duty_cap_ms", p->pumpDutyCapMs);
+    jsonLiteUint(&w, "pump_duty_budget_ms", p->pumpDutyBudgetMs);
+    jsonLiteUint(&w, "pump_duty_recover_ms", p->pumpDutyRecoverMs);
+
+    // K230视觉火焰检测状态与链路健康
+    jsonLiteString(&w, "k230_fire", p->k230Fire);
+    jsonLiteBool(&w, "k230_fire_detected", p->k230FireDetected);
+    jsonLiteString(&w, "k230_link", p->k230Link);
+    jsonLiteFixed(&w, "k230_fps", p->k230Fps, 1);
+    jsonLiteUint(&w, "k230_frames", p->k230Frames);
+    jsonLiteFixed(&w, "k230_infer_ms", p->k230InferMs, 1);
+    jsonLiteFixed(&w, "k230_infer_avg_ms", p->k230InferAvgMs, 1);
+    jsonLiteFixed(&w, "k230_infer_max_ms", p->k230InferMaxMs, 1);
+    jsonLiteString(&w, "k230_model", p->k230Model);
+    jsonLiteInt(&w, "k230_heartbeat_age_ms", p->k230HeartbeatAgeMs);
+    jsonLiteUint(&w, "k230_faults", p->k230Faults);
+    jsonLiteUint(&w, "k230_restarts", p->k230Restarts);
+
+    // K230上报档位与已确认的上报间隔
+    jsonLiteString(&w, "k230_report_mode", p->k230ReportMode);
+    jsonLiteInt(&w, "k230_report_ms", p->k230ReportMs);
+
+    // K230串口链路速率与检测快照
+    jsonLiteUint(&w, "k230_baud", p->k230Baud);
+    jsonLiteUint(&w, "k230_rx_bps", p->k230RxBps);
+    jsonLiteUint(&w, "k230_crc_errors", p->k230CrcErrors);
+    jsonLiteUint(&w, "snapshots", p->snapshots);
+    jsonLiteUint(&w, "snapshot_bytes", p->snapshotBytes);
+    jsonLiteUint(&w, "snapshot_assembly_ms", p->snapshotAssemblyMs);
+    jsonLiteFixed(&w, "snapshot_kbps", p->snapshotKBps, 1);
+
+    // 火灾置信度融合评估
+    jsonLiteFixed(&w, "fire_score", p->fireScore, 3);
+    jsonLiteString(&w, "fire_level", p->fireLevel);
+    jsonLiteString(&w, "fire_zone", p->fireZone);
+    jsonLiteBeginObject(&w, "fire_evidence");
+    jsonLiteFixed(&w, "smoke", p->fireEvidence[FUSION_SRC_SMOKE], 3);
+    jsonLiteFixed(&w, "temp", p->fireEvidence[FUSION_SRC_TEMP], 3);
+    jsonLiteFixed(&w, "mq2_do", p->fireEvidence[FUSION_SRC_MQ2_DO], 3);
+    jsonLiteFixed(&w, "k230", p->fireEvidence[FUSION_SRC_K230], 3);
+    jsonLiteEndObject(&w);
+
+    // 蜂鸣器状态
+    jsonLiteString(&w, "buzzer_state", p->buzzerState);
+    jsonLiteString(&w, "buzzer_mode", p->buzzerMode);
+    jsonLiteString(&w, "buzzer_pattern", p->buzzerPattern);
+
+    // 分区周期耗时、DSP与分类器
+    jsonLiteUint(&w, "zone_sample_us", p->zoneSampleUs);
+    jsonLiteUint(&w, "zone_sample_max_us", p->zoneSampleMaxUs);
+    jsonLiteUint(&w, "zone_eval_us", p->zoneEvalUs);
+    jsonLiteUint(&w, "zone_eval_max_us", p->zoneEvalMaxUs);
+    jsonLiteString(&w, "dsp_pipeline", p->dspPipeline);
+    jsonLiteUint(&w, "dsp_us", p->dspUs);
+    jsonLiteUint(&w, "dsp_max_us", p->dspMaxUs);
+    jsonLiteUint(&w, "cls_model", p->clsModel);
+    jsonLiteUint(&w, "cls_us", p->clsUs);
+    jsonLiteUint(&w, "cls_max_us", p->clsMaxUs);
+    jsonLiteBeginArray(&w, "zones");
+    for (uint8_t z = 0; z < p->zoneCount; z++) {
+        writeZone(&w, &p->zones[z]);
+    }
+    jsonLiteEndArray(&w);
+
+    // 电源管理与唤醒延迟
+    jsonLiteString(&w, "power_mode", p->powerMode);
+    jsonLiteUint(&w, "power_holds", p->powerHolds);
+    jsonLiteUint(&w, "power_full_pct", p->powerFullPct);
+    jsonLiteUint(&w, "wake_smoke_us", p->wakeSmokeUs);
+    jsonLiteUint(&w, "wake_smoke_max_us", p->wakeSmokeMaxUs);
+    jsonLiteUint(&w, "wake_k230_us", p->wakeK230Us);
+    jsonLiteUint(&w, "wake_k230_max_us", p->wakeK230MaxUs);
+
+    // 任务监控
+    jsonLiteUint(&w, "deadline_misses", p->deadlineMisses);
+    jsonLiteString(&w, "reset_reason", p->resetReason);
+
+    // 固件版本与升级状态
+    jsonLiteString(&w, "fw_version", p->fwVersion);
+    jsonLiteString(&w, "ota_state", p->otaState);
+    jsonLiteString(&w, "ota_boot", p->otaBoot);
+    jsonLiteUint(&w, "boot_armed_ms", p->bootArmedMs);
+
+    // 内部RAM堆碎片
+    jsonLiteUint(&w, "heap_free", p->heapFree);
+    jsonLiteUint(&w, "heap_largest", p->heapLargest);
+    jsonLiteUint(&w, "heap_min_free", p->heapMinFree);
+    jsonLiteUint(&w, "heap_frag_pct", p->heapFragPct);
+    jsonLiteUint(&w, "heap_frag_max_pct", p->heapFragMaxPct);
+
+    jsonLiteUint(&w, "timestamp", p->timestamp);
+
+    // 参考时钟纪元微秒及其不确定度
+    jsonLiteInt(&w, "epoch_us", p->epochUs);
+    jsonLiteInt(&w, "clock_uncertainty_us", p->clockUncertaintyUs);
+    jsonLiteFixed(&w, "clock_drift_ppm", p->clockDriftPpm, 2);
+
+    // 离线缓存队列状态
+    jsonLiteUint(&w, "outbox_depth", p->outboxDepth);
+    jsonLiteUint(&w, "outbox_dropped", p->outboxDropped);
+    jsonLiteUint(&w, "tx_skipped", p->txSkipped);
+
+    // 连接统计
+    jsonLiteUint(&w, "mqtt_reconnects", p->mqttReconnects);
+    jsonLiteUint(&w, "wifi_connect_ms", p->wifiConnectMs);
+    jsonLiteUint(&w, "mqtt_connect_ms", p->mqttConnectMs);
+    jsonLiteUint(&w, "last_outage_ms", p->lastOutageMs);
+
+    jsonLiteBeginObject(&w, "unit");
+    jsonLiteString(&w, "temperature", "celsius");
+    jsonLiteString(&w, "humidity", "percent");
+    jsonLiteString(&w, "smoke_level", "percent");
+    jsonLiteEndObject(&w);
+
+    jsonLiteEndObject(&w);
+    return jsonLiteEnd(&w);
+}
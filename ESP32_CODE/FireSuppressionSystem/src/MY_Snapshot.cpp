@@ -0,0 +1,375 @@
+#include <Arduino.h>
+#include "MY_Snapshot.h"
+#include "MY_MQTT.h"
+#include "MY_TimeSync.h"
+#include "MY_Memory.h"
+#include <esp_timer.h>
+
+// ==================== 内部状态 ====================
+
+// 槽位所有权：重组中的槽位只由K230任务读写，待发布/发布中的槽位只由MQTT任务读取，
+// 状态切换与统计在互斥锁内完成
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_ASSEMBLING = 1,    // K230任务正在写入
+    SLOT_READY = 2,         // 收齐，等待发布
+    SLOT_PUBLISHING = 3     // MQTT任务正在发布
+} SnapshotSlotState;
+
+typedef struct {
+    SnapshotSlotState state;
+    uint8_t* data;                              // 存储区 (PSRAM)
+    uint16_t id;                                // K230分配的快照ID
+    uint16_t chunkCount;                        // 串口分块数
+    uint16_t received;                          // 已收到的分块数
+    uint32_t size;                              // 快照总字节数
+    uint32_t bitmap[SNAPSHOT_MAX_CHUNKS / 32];  // 已收到的分块 (去重)
+    int64_t startUs;                            // 首块首字节到达时间
+    unsigned long startMs;                      // 重组开始时间 (超时判断)
+    unsigned long readyMs;                      // 收齐时间
+    uint32_t assemblyMs;
+    float rateKBps;
+    int64_t epochUs;                            // 首块到达时刻的参考纪元微秒
+    uint16_t publishIndex;                      // 下一个待发布的MQTT块
+    unsigned long publishStartMs;
+} SnapshotSlot;
+
+static SnapshotSlot slots[SNAPSHOT_SLOTS];
+static SnapshotStats stats = {};
+static SemaphoreHandle_t snapshotMutex = NULL;
+
+// 被拒绝或刚完成的快照ID，其后续分块直接忽略，避免同一张快照重复计数
+static int32_t rejectedId = -1;
+static int32_t lastCompletedId = -1;
+
+// ==================== 初始化 ====================
+
+/**
+ * @brief 分配PSRAM快照槽位
+ *
+ * 快照只是辅助信息，无PSRAM时不占用内部RAM，直接关闭该功能
+ */
+void setupSnapshot() {
+    snapshotMutex = CREATE_MODULE_MUTEX();
+
+    bool ready = SNAPSHOT_ENABLE && psramFound();
+    for (uint8_t i = 0; i < SNAPSHOT_SLOTS && ready; i++) {
+        slots[i].state = SLOT_FREE;
+        slots[i].data = (uint8_t*)ps_malloc(SNAPSHOT_MAX_BYTES);
+        if (slots[i].data == NULL) ready = false;
+    }
+    stats.storageReady = ready;
+
+    if (ready) {
+        Serial.println("[SNAP] " + String(SNAPSHOT_SLOTS) + " x " + String(SNAPSHOT_MAX_BYTES / 1024) +
+                       "KB slots in PSRAM, MQTT chunk " + String(SNAPSHOT_MQTT_CHUNK_SIZE) + " bytes");
+    } else {
+        Serial.println("[SNAP] Snapshots disabled (no PSRAM)");
+    }
+}
+
+// ==================== 重组 (K230任务) ====================
+
+static bool chunkSeen(const SnapshotSlot* slot, uint16_t index) {
+    return (slot->bitmap[index / 32] & (1UL << (index % 32))) != 0;
+}
+
+static void markChunk(SnapshotSlot* slot, uint16_t index) {
+    slot->bitmap[index / 32] |= (1UL << (index % 32));
+}
+
+/**
+ * @brief 为新快照分配槽位（调用方需持有snapshotMutex）
+ *
+ * K230按顺序发送快照，正在重组的旧快照若仍未收齐说明有分块丢失，直接放弃
+ * @return 槽位，全忙时返回NULL
+ */
+static SnapshotSlot* beginAssembly(uint16_t id, uint16_t count, uint32_t totalBytes, int64_t frameStartUs,
+                                   bool* abandoned) {
+    SnapshotSlot* slot = NULL;
+    for (uint8_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+        if (slots[i].state == SLOT_ASSEMBLING) {
+            slots[i].state = SLOT_FREE;
+            stats.incomplete++;
+            *abandoned = true;
+        }
+        if (slots[i].state == SLOT_FREE && slot == NULL) slot = &slots[i];
+    }
+    if (slot == NULL) return NULL;
+
+    slot->state = SLOT_ASSEMBLING;
+    slot->id = id;
+    slot->chunkCount = count;
+    slot->received = 0;
+    slot->size = totalBytes;
+    memset(slot->bitmap, 0, sizeof(slot->bitmap));
+    slot->startUs = frameStartUs;
+    slot->startMs = millis();
+    slot->epochUs = timeSyncEpochUs(frameStartUs);
+    return slot;
+}
+
+static SnapshotSlot* findAssembling(uint16_t id) {
+    for (uint8_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+        if (slots[i].state == SLOT_ASSEMBLING && slots[i].id == id) return &slots[i];
+    }
+    return NULL;
+}
+
+static void rejectSnapshot(uint16_t id, const String& reason) {
+    if (xSemaphoreTake(snapshotMutex, portMAX_DELAY) == pdTRUE) {
+        stats.dropped++;
+        xSemaphoreGive(snapshotMutex);
+    }
+    rejectedId = id;
+    Serial.println("[SNAP] Snapshot #" + String(id) + " dropped: " + reason);
+}
+
+/**
+ * @brief 写入一个校验通过的分块
+ *
+ * 只做边界检查和一次PSRAM拷贝，不等待任何资源，K230任务随即继续处理后续文本行
+ */
+void snapshotHandleChunk(uint16_t snapshotId, uint16_t index, uint16_t count, uint32_t totalBytes,
+                         uint32_t offset, const uint8_t* data, uint16_t length, int64_t frameStartUs) {
+    if (!stats.storageReady || snapshotId == rejectedId || snapshotId == lastCompletedId) return;
+
+    if (count == 0 || count > SNAPSHOT_MAX_CHUNKS || totalBytes > SNAPSHOT_MAX_BYTES) {
+        rejectSnapshot(snapshotId, "too large (" + String(totalBytes) + " bytes, " + String(count) + " chunks)");
+        return;
+    }
+    if (index >= count || offset + length > totalBytes) return;
+
+    SnapshotSlot* slot = NULL;
+    bool abandoned = false;
+    if (xSemaphoreTake(snapshotMutex, portMAX_DELAY) == pdTRUE) {
+        slot = findAssembling(snapshotId);
+        if (slot == NULL) slot = beginAssembly(snapshotId, count, totalBytes, frameStartUs, &abandoned);
+        xSemaphoreGive(snapshotMutex);
+    }
+    if (abandoned) {
+        Serial.println("[SNAP] Previous snapshot incomplete, discarded");
+    }
+    if (slot == NULL) {
+        rejectSnapshot(snapshotId, "all slots busy");
+        return;
+    }
+    if (slot->chunkCount != count || slot->size != totalBytes || chunkSeen(slot, index)) return;
+
+    memcpy(slot->data + offset, data, length);
+    markChunk(slot, index);
+    slot->received++;
+    if (slot->received < slot->chunkCount) return;
+
+    // 收齐：串口分块已逐块校验CRC，这里只确认是JPEG (SOI标记)
+    bool valid = slot->size >= 2 && slot->data[0] == 0xFF && slot->data[1] == 0xD8;
+    uint32_t size = slot->size;
+    uint16_t chunks = slot->chunkCount;
+    int64_t elapsedUs = esp_timer_get_time() - slot->startUs;
+    uint32_t assemblyMs = (uint32_t)(elapsedUs / 1000);
+    float rateKBps = elapsedUs > 0 ? (float)slot->size * 1000000.0f / (float)elapsedUs / 1024.0f : 0.0f;
+
+    if (xSemaphoreTake(snapshotMutex, portMAX_DELAY) == pdTRUE) {
+        if (valid) {
+            slot->state = SLOT_READY;
+            slot->readyMs = millis();
+            slot->assemblyMs = assemblyMs;
+            slot->rateKBps = rateKBps;
+            stats.completed++;
+            stats.lastBytes = slot->size;
+            stats.lastAssemblyMs = assemblyMs;
+            stats.lastRateKBps = rateKBps;
+            if (assemblyMs > stats.maxAssemblyMs) stats.maxAssemblyMs = assemblyMs;
+        } else {
+            slot->state = SLOT_FREE;
+            stats.dropped++;
+        }
+        xSemaphoreGive(snapshotMutex);
+    }
+    lastCompletedId = snapshotId;
+
+    if (valid) {
+        Serial.println("[SNAP] Snapshot #" + String(snapshotId) + ": " + String(size) + " bytes in " +
+                       String(chunks) + " chunks, " + String(assemblyMs) + "ms (" + String(rateKBps, 1) +
+                       " KB/s)");
+    } else {
+        Serial.println("[SNAP] Snapshot #" + String(snapshotId) + " dropped: not a JPEG");
+    }
+}
+
+/**
+ * @brief 重组超时检查（K230任务每轮调用）
+ */
+void snapshotPoll() {
+    if (!stats.storageReady) return;
+
+    bool expired = false;
+    if (xSemaphoreTake(snapshotMutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+            if (slots[i].state == SLOT_ASSEMBLING && millis() - slots[i].startMs > SNAPSHOT_ASSEMBLY_TIMEOUT_MS) {
+                slots[i].state = SLOT_FREE;
+                stats.incomplete++;
+                expired = true;
+            }
+        }
+        xSemaphoreGive(snapshotMutex);
+    }
+    if (expired) {
+        Serial.println("[SNAP] Snapshot assembly timeout, discarded");
+    }
+}
+
+// ==================== 发布 (MQTT任务) ====================
+
+static uint16_t mqttChunkCount(const SnapshotSlot* slot) {
+    return (uint16_t)((slot->size + SNAPSHOT_MQTT_CHUNK_SIZE - 1) / SNAPSHOT_MQTT_CHUNK_SIZE);
+}
+
+/**
+ * @brief 取得正在发布或最早收齐的快照（调用方需持有snapshotMutex）
+ *
+ * 等待发布超时的快照在这里丢弃
+ */
+static SnapshotSlot* selectForPublish(bool connected, bool* expired) {
+    SnapshotSlot* oldest = NULL;
+    for (uint8_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+        SnapshotSlot* slot = &slots[i];
+        if (slot->state == SLOT_PUBLISHING) return slot;
+        if (slot->state != SLOT_READY) continue;
+        if (millis() - slot->readyMs > SNAPSHOT_PUBLISH_TIMEOUT_MS) {
+            slot->state = SLOT_FREE;
+            stats.publishFailed++;
+            *expired = true;
+            continue;
+        }
+        if (oldest == NULL || (long)(slot->readyMs - oldest->readyMs) < 0) oldest = slot;
+    }
+    if (oldest == NULL || !connected) return NULL;
+
+    oldest->state = SLOT_PUBLISHING;
+    oldest->publishIndex = 0;
+    oldest->publishStartMs = millis();
+    return oldest;
+}
+
+static void releaseSlot(SnapshotSlot* slot, bool published) {
+    if (xSemaphoreTake(snapshotMutex, portMAX_DELAY) == pdTRUE) {
+        slot->state = SLOT_FREE;
+        if (published) {
+            stats.published++;
+            stats.lastPublishMs = millis() - slot->publishStartMs;
+        } else {
+            stats.publishFailed++;
+        }
+        xSemaphoreGive(snapshotMutex);
+    }
+}
+
+/**
+ * @brief 发布快照描述 (JSON)，接收方据此准备接收数据块
+ */
+static bool publishSnapshotMeta(const SnapshotSlot* slot) {
+    JsonDocument doc;
+    doc["device_id"] = DEVICE_ID;
+    doc["snapshot_id"] = slot->id;
+    doc["format"] = "jpeg";
+    doc["bytes"] = slot->size;
+    doc["chunks"] = mqttChunkCount(slot);
+    doc["chunk_size"] = SNAPSHOT_MQTT_CHUNK_SIZE;
+    doc["assembly_ms"] = slot->assemblyMs;
+    doc["rate_kbps"] = round(slot->rateKBps * 10.0) / 10.0;
+    doc["epoch_us"] = slot->epochUs;
+    doc["timestamp"] = millis();
+
+    char payload[256];
+    if (serializeJsonChecked(doc, payload, sizeof(payload), "snapshot") == 0) return false;
+    return mqttClient.publish(MQTT_TOPIC_SNAPSHOT, payload);
+}
+
+/**
+ * @brief 发布一个数据块：8字节块头 + JPEG数据，流式写入Socket，不占用MQTT发送缓冲区
+ */
+static bool publishSnapshotChunk(const SnapshotSlot* slot, uint16_t index) {
+    uint16_t count = mqttChunkCount(slot);
+    uint32_t offset = (uint32_t)index * SNAPSHOT_MQTT_CHUNK_SIZE;
+    uint32_t length = slot->size - offset;
+    if (length > SNAPSHOT_MQTT_CHUNK_SIZE) length = SNAPSHOT_MQTT_CHUNK_SIZE;
+
+    uint8_t header[SNAPSHOT_MQTT_HEADER_SIZE] = {
+        (uint8_t)(slot->id & 0xFF), (uint8_t)(slot->id >> 8),
+        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
+        (uint8_t)(count & 0xFF), (uint8_t)(count >> 8),
+        0, 0
+    };
+
+    return mqttClient.beginPublish(MQTT_TOPIC_SNAPSHOT_DATA, SNAPSHOT_MQTT_HEADER_SIZE + length, false) &&
+           mqttClient.write(header, SNAPSHOT_MQTT_HEADER_SIZE) == SNAPSHOT_MQTT_HEADER_SIZE &&
+           mqttClient.write(slot->data + offset, length) == length &&
+           mqttClient.endPublish();
+}
+
+/**
+ * @brief 发布下一块（MQTT任务每轮调用）
+ *
+ * 每轮最多发布描述加一个数据块，报警补发、遥测和命令处理不会被整张快照阻塞；
+ * 快照不进入离线缓存队列，发布中途断线则整张放弃
+ */
+void snapshotPublishStep() {
+    if (!stats.storageReady) return;
+
+    bool connected = mqttClient.connected();
+    bool expired = false;
+    SnapshotSlot* slot = NULL;
+    if (xSemaphoreTake(snapshotMutex, portMAX_DELAY) == pdTRUE) {
+        slot = selectForPublish(connected, &expired);
+        xSemaphoreGive(snapshotMutex);
+    }
+    if (expired) {
+        Serial.println("[SNAP] Snapshot not published in time, discarded");
+    }
+    if (slot == NULL) return;
+
+    // 释放槽位后K230任务可能立即复用，日志所需字段先取出
+    uint16_t id = slot->id;
+    uint16_t chunks = mqttChunkCount(slot);
+    bool ok = connected;
+    if (ok && slot->publishIndex == 0) {
+        ok = publishSnapshotMeta(slot);
+    }
+    if (ok) {
+        ok = publishSnapshotChunk(slot, slot->publishIndex);
+    }
+    if (!ok) {
+        releaseSlot(slot, false);
+        Serial.println("[SNAP] Snapshot #" + String(id) + " publish failed");
+        return;
+    }
+
+    slot->publishIndex++;
+    if (slot->publishIndex >= chunks) {
+        releaseSlot(slot, true);
+        Serial.println("[SNAP] Snapshot #" + String(id) + " published in " + String(chunks) + " MQTT chunks");
+    }
+}
+
+// ==================== 状态查询 ====================
+
+SnapshotStats getSnapshotStats() {
+    SnapshotStats copy = {};
+    if (snapshotMutex == NULL) return copy;
+    if (xSemaphoreTake(snapshotMutex, portMAX_DELAY) == pdTRUE) {
+        copy = stats;
+        xSemaphoreGive(snapshotMutex);
+    }
+    return copy;
+}
+
+void printSnapshotReport() {
+    SnapshotStats s = getSnapshotStats();
+    if (!s.storageReady) return;
+    Serial.println("Snapshot: Completed=" + String(s.completed) + ", Published=" + String(s.published) +
+                   ", Last " + String(s.lastBytes) + " bytes in " + String(s.lastAssemblyMs) + "ms (max " +
+                   String(s.maxAssemblyMs) + "ms, " + String(s.lastRateKBps, 1) + " KB/s), publish " +
+                   String(s.lastPublishMs) + "ms, Incomplete=" + String(s.incomplete) + ", Dropped=" +
+                   String(s.dropped) + ", PublishFailed=" + String(s.publishFailed));
+}
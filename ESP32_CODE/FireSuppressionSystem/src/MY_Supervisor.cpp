@@ -0,0 +1,318 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include <Preferences.h>
+#include "MY_Supervisor.h"
+#include "MY_Pump.h"
+#include "MY_Fan.h"
+#include "MY_Buzzer.h"
+#include "MY_Zone.h"
+#include "MY_MQTT.h"
+#include "MY_Memory.h"
+#include "MY_Boot.h"
+
+// ==================== 全局变量定义 ====================
+TaskHandle_t supervisorTaskHandle = NULL;
+SemaphoreHandle_t supervisorMutex = NULL;
+
+static SupervisedTask supervised[SUPERVISOR_MAX_TASKS];
+static uint8_t supervisedCount = 0;
+static uint32_t totalMisses = 0;
+static uint32_t restartCount = 0;          // 累计受控重启次数 (来自NVS)
+static char lastResetReason[32] = "unknown";
+
+static const uint32_t histEdgesPct[SUPERVISOR_HIST_BUCKETS - 1] = SUPERVISOR_HIST_EDGES_PCT;
+
+// ==================== 内部函数 ====================
+
+static const char* resetReasonString(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON:   return "power_on";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "int_wdt";
+        case ESP_RST_TASK_WDT:  return "task_wdt";
+        case ESP_RST_WDT:       return "wdt";
+        case ESP_RST_DEEPSLEEP: return "deep_sleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        default:                return "unknown";
+    }
+}
+
+static bool isAbnormalReset(esp_reset_reason_t reason) {
+    return reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT ||
+           reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT ||
+           reason == ESP_RST_BROWNOUT;
+}
+
+/**
+ * @brief 签到间隔所在的直方图桶
+ */
+static uint8_t histogramBucket(uint32_t intervalMs, uint32_t deadlineMs) {
+    uint64_t pct = (uint64_t)intervalMs * 100 / deadlineMs;
+    uint8_t bucket = 0;
+    while (bucket < SUPERVISOR_HIST_BUCKETS - 1 && pct >= histEdgesPct[bucket]) {
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief 计一次超时 (调用方需持有supervisorMutex)
+ */
+static void countMiss(SupervisedTask* task) {
+    task->misses++;
+    task->consecutiveMisses++;
+    totalMisses++;
+}
+
+/**
+ * @brief 执行器进入安全状态，保存原因后重启
+ *
+ * 安全状态：水泵继电器断开、风扇停止、蜂鸣器停止。
+ * 不获取任何模块互斥锁，卡死的任务可能正持有它们。
+ */
+static void restartToSafeState(SupervisorResetReason reason, const char* taskName,
+                               uint32_t misses, uint32_t sinceCheckInMs) {
+    pumpForceOff();
+    fanForceOff();
+    buzzerForceOff();
+    zoneForceOff();
+
+    Serial.println("[SUP] !!! " + String(taskName) + (reason == SUPERVISOR_RESET_HANG ? " hung" : " missed deadlines") +
+                   " (misses " + String(misses) + ", last check-in " + String(sinceCheckInMs) + "ms ago) !!!");
+    Serial.println("[SUP] Actuators in safe state, restarting...");
+
+    SupervisorResetRecord record = {};
+    record.reason = reason;
+    strncpy(record.task, taskName, sizeof(record.task) - 1);
+    record.misses = misses;
+    record.sinceCheckInMs = sinceCheckInMs;
+    record.restarts = restartCount + 1;
+
+    Preferences prefs;
+    if (prefs.begin(SUPERVISOR_NVS_NAMESPACE, false)) {
+        prefs.putBytes(SUPERVISOR_NVS_KEY, &record, sizeof(record));
+        prefs.end();
+    }
+
+    Serial.flush();
+    esp_restart();
+}
+
+// ==================== 初始化函数 ====================
+
+/**
+ * @brief 初始化任务监控模块
+ *
+ * 1. 读取上次受控重启记录（读后清除原因，保留累计次数）
+ * 2. 非正常复位时向APP发送报警事件（需在 setupOutbox() 之后调用）
+ * 3. 配置任务看门狗，只监视监控任务本身
+ */
+void setupSupervisor() {
+    // 创建互斥锁
+    supervisorMutex = CREATE_MODULE_MUTEX();
+
+    esp_reset_reason_t hwReason = esp_reset_reason();
+    SupervisorResetRecord record = {};
+
+    Preferences prefs;
+    if (prefs.begin(SUPERVISOR_NVS_NAMESPACE, false)) {
+        if (prefs.getBytes(SUPERVISOR_NVS_KEY, &record, sizeof(record)) != sizeof(record)) {
+            memset(&record, 0, sizeof(record));
+        }
+        if (record.reason != SUPERVISOR_RESET_NONE) {
+            SupervisorResetRecord cleared = {};
+            cleared.restarts = record.restarts;
+            prefs.putBytes(SUPERVISOR_NVS_KEY, &cleared, sizeof(cleared));
+        }
+        prefs.end();
+    }
+    restartCount = record.restarts;
+
+    bool abnormal = true;
+    if (record.reason != SUPERVISOR_RESET_NONE) {
+        record.task[sizeof(record.task) - 1] = '\0';
+        snprintf(lastResetReason, sizeof(lastResetReason), "%s:%s",
+                 record.reason == SUPERVISOR_RESET_HANG ? "hang" : "deadline", record.task);
+    } else {
+        strncpy(lastResetReason, resetReasonString(hwReason), sizeof(lastResetReason) - 1);
+        abnormal = isAbnormalReset(hwReason);
+    }
+
+    if (abnormal) {
+        queueAlarmEvent("supervisor", lastResetReason);
+    }
+
+    // 重新配置任务看门狗（替代原来的 esp_task_wdt_deinit），不监视空闲任务
+    esp_task_wdt_init(SUPERVISOR_WDT_TIMEOUT_S, true);
+    for (UBaseType_t cpu = 0; cpu < portNUM_PROCESSORS; cpu++) {
+        esp_task_wdt_delete(xTaskGetIdleTaskHandleForCPU(cpu));
+    }
+
+    Serial.println("[SUP] ========== Supervisor Init ==========");
+    Serial.println("[SUP] Last reset: " + String(lastResetReason) + (abnormal ? " (abnormal)" : ""));
+    Serial.println("[SUP] Supervised restarts so far: " + String(restartCount));
+    Serial.println("[SUP] Task WDT: " + String(SUPERVISOR_WDT_TIMEOUT_S) + "s");
+    Serial.println("[SUP] ========================================");
+}
+
+// ==================== 注册与签到 ====================
+
+/**
+ * @brief 注册被监控任务
+ * @param name       任务名 (需为静态字符串)
+ * @param periodMs   正常周期
+ * @param deadlineMs 两次签到的最大允许间隔
+ */
+int8_t supervisorRegister(const char* name, uint32_t periodMs, uint32_t deadlineMs) {
+    int8_t id = -1;
+    if (xSemaphoreTake(supervisorMutex, portMAX_DELAY) == pdTRUE) {
+        if (supervisedCount < SUPERVISOR_MAX_TASKS) {
+            id = supervisedCount++;
+            SupervisedTask* task = &supervised[id];
+            memset(task, 0, sizeof(SupervisedTask));
+            task->name = name;
+            task->periodMs = periodMs;
+            task->deadlineMs = deadlineMs;
+            task->lastCheckInUs = esp_timer_get_time();
+        }
+        xSemaphoreGive(supervisorMutex);
+    }
+
+    if (id >= 0) {
+        Serial.println("[SUP] Watching " + String(name) + ": period " + String(periodMs) +
+                       "ms, deadline " + String(deadlineMs) + "ms");
+    } else {
+        Serial.println("[SUP] Too many supervised tasks, " + String(name) + " not watched");
+    }
+    return id;
+}
+
+/**
+ * @brief 任务签到
+ * 间隔超过截止时间计为一次超时，按时签到则清零连续超时计数
+ */
+void supervisorCheckIn(int8_t id) {
+    if (id < 0) return;
+    int64_t now = esp_timer_get_time();
+
+    if (xSemaphoreTake(supervisorMutex, portMAX_DELAY) == pdTRUE) {
+        SupervisedTask* task = &supervised[id];
+        uint32_t intervalMs = (uint32_t)((now - task->lastCheckInUs) / 1000);
+        task->lastCheckInUs = now;
+        task->checkIns++;
+        task->histogram[histogramBucket(intervalMs, task->deadlineMs)]++;
+        if (intervalMs > task->maxIntervalMs) {
+            task->maxIntervalMs = intervalMs;
+        }
+
+        if (intervalMs > task->deadlineMs) {
+            // 监控任务已在等待期间计过这次超时
+            if (!task->stalled) {
+                countMiss(task);
+            }
+        } else {
+            task->consecutiveMisses = 0;
+        }
+        task->stalled = false;
+        xSemaphoreGive(supervisorMutex);
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+uint32_t getSupervisorTotalMisses() {
+    uint32_t misses = 0;
+    if (xSemaphoreTake(supervisorMutex, portMAX_DELAY) == pdTRUE) {
+        misses = totalMisses;
+        xSemaphoreGive(supervisorMutex);
+    }
+    return misses;
+}
+
+const char* getLastResetReason() {
+    return lastResetReason;
+}
+
+/**
+ * @brief 打印各任务签到统计
+ * 直方图各桶为签到间隔占截止时间的 <25% / <50% / <75% / <100% / <200% / >=200%
+ */
+void printSupervisorReport() {
+    if (xSemaphoreTake(supervisorMutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t i = 0; i < supervisedCount; i++) {
+            const SupervisedTask* task = &supervised[i];
+            String line = "Task: " + String(task->name) + " misses=" + String(task->misses) +
+                          " max=" + String(task->maxIntervalMs) + "ms hist=[";
+            for (uint8_t b = 0; b < SUPERVISOR_HIST_BUCKETS; b++) {
+                if (b > 0) line += " ";
+                line += String(task->histogram[b]);
+            }
+            line += "]";
+            Serial.println(line);
+        }
+        xSemaphoreGive(supervisorMutex);
+    }
+}
+
+// ==================== RTOS任务函数 ====================
+
+/**
+ * @brief 监控任务
+ *
+ * 最高优先级，周期检查各任务距上次签到的时间：
+ * - 超过截止时间计一次超时（同一次等待只计一次）
+ * - 连续超时 SUPERVISOR_MAX_CONSECUTIVE_MISSES 次，或超过 截止时间×SUPERVISOR_HANG_MULTIPLIER
+ *   仍未签到，执行器进入安全状态后受控重启
+ * 自身每个周期喂任务看门狗
+ */
+void supervisorTask(void *pvParameters) {
+    Serial.println("[SUP] Supervisor task started on Core " + String(xPortGetCoreID()));
+
+    esp_task_wdt_add(NULL);
+    TickType_t lastWake = xTaskGetTickCount();
+    bootTaskReady(BOOT_READY_SUPERVISOR);
+
+    for (;;) {
+        esp_task_wdt_reset();
+
+        SupervisorResetReason reason = SUPERVISOR_RESET_NONE;
+        const char* culprit = NULL;
+        uint32_t culpritMisses = 0;
+        uint32_t culpritSinceMs = 0;
+
+        int64_t now = esp_timer_get_time();
+        if (xSemaphoreTake(supervisorMutex, portMAX_DELAY) == pdTRUE) {
+            for (uint8_t i = 0; i < supervisedCount && reason == SUPERVISOR_RESET_NONE; i++) {
+                SupervisedTask* task = &supervised[i];
+                uint32_t sinceMs = (uint32_t)((now - task->lastCheckInUs) / 1000);
+
+                if (sinceMs > task->deadlineMs && !task->stalled) {
+                    task->stalled = true;
+                    countMiss(task);
+                }
+
+                if (sinceMs > task->deadlineMs * SUPERVISOR_HANG_MULTIPLIER) {
+                    reason = SUPERVISOR_RESET_HANG;
+                } else if (task->consecutiveMisses >= SUPERVISOR_MAX_CONSECUTIVE_MISSES) {
+                    reason = SUPERVISOR_RESET_DEADLINE;
+                }
+                if (reason != SUPERVISOR_RESET_NONE) {
+                    culprit = task->name;
+                    culpritMisses = task->misses;
+                    culpritSinceMs = sinceMs;
+                }
+            }
+            xSemaphoreGive(supervisorMutex);
+        }
+
+        if (reason != SUPERVISOR_RESET_NONE) {
+            restartToSafeState(reason, culprit, culpritMisses, culpritSinceMs);
+        }
+
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(SUPERVISOR_PERIOD_MS));
+    }
+}
@@ -0,0 +1,163 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <ArduinoJson.h>
+#include "MY_TimeSync.h"
+#include "MY_MQTT.h"
+#include "MY_Memory.h"
+
+// ==================== 全局变量定义 ====================
+SemaphoreHandle_t timeSyncMutex = NULL;
+
+static ClockFilter clockFilter;
+static TimeSyncStatus timeSyncStats = {};
+static char responseTopic[OUTBOX_TOPIC_SIZE];
+
+// 以下变量只在MQTT任务中访问
+static uint32_t requestSeq = 0;
+static bool requestPending = false;
+static int64_t pendingT1 = 0;               // 未完成请求的发送时刻 (本地微秒)
+static unsigned long lastRequestMs = 0;
+static uint8_t burstRemaining = TIMESYNC_BURST_SAMPLES;
+
+// ==================== 初始化函数 ====================
+
+void setupTimeSync() {
+    timeSyncMutex = CREATE_MODULE_MUTEX();
+    clockFilterReset(&clockFilter);
+    snprintf(responseTopic, sizeof(responseTopic), "%s%s", TIMESYNC_TOPIC_RESPONSE, DEVICE_ID);
+
+    Serial.println("[TIME] Clock sync over MQTT, response topic: " + String(responseTopic));
+}
+
+const char* getTimeSyncResponseTopic() {
+    return responseTopic;
+}
+
+// ==================== 请求/应答 ====================
+
+void timeSyncOnConnect() {
+    // 重连后链路时延可能已变化，重新快速采样 (滤波器保留，漂移估计不丢失)
+    requestPending = false;
+    burstRemaining = TIMESYNC_BURST_SAMPLES;
+    lastRequestMs = millis() - TIMESYNC_INTERVAL_MS;
+}
+
+/**
+ * @brief 按节奏发布同步请求 (只在MQTT任务中调用)
+ *
+ * 请求直接发布而不进离线缓存队列：排队过的请求 t1 已失效
+ */
+void timeSyncPoll() {
+    unsigned long now = millis();
+
+    if (requestPending) {
+        if (now - lastRequestMs < TIMESYNC_TIMEOUT_MS) return;
+        requestPending = false;
+        if (xSemaphoreTake(timeSyncMutex, portMAX_DELAY) == pdTRUE) {
+            timeSyncStats.timeouts++;
+            xSemaphoreGive(timeSyncMutex);
+        }
+    }
+
+    unsigned long interval = (burstRemaining > 0 || !clockFilter.synced) ? TIMESYNC_BURST_MS : TIMESYNC_INTERVAL_MS;
+    if (now - lastRequestMs < interval) return;
+
+    char payload[128];
+    requestSeq++;
+    int64_t t1 = esp_timer_get_time();
+    snprintf(payload, sizeof(payload), "{\"device_id\":\"%s\",\"seq\":%lu,\"t1\":%lld}",
+             DEVICE_ID, (unsigned long)requestSeq, (long long)t1);
+
+    lastRequestMs = now;
+    if (!mqttClient.publish(TIMESYNC_TOPIC_REQUEST, payload)) return;
+
+    pendingT1 = t1;
+    requestPending = true;
+    if (xSemaphoreTake(timeSyncMutex, portMAX_DELAY) == pdTRUE) {
+        timeSyncStats.requests++;
+        xSemaphoreGive(timeSyncMutex);
+    }
+}
+
+/**
+ * @brief 处理参考进程的应答
+ * @param localUs 报文到达时刻 (t4)，由回调入口尽早记录
+ */
+bool timeSyncHandleMessage(const char* topic, const char* message, int64_t localUs) {
+    if (strcmp(topic, responseTopic) != 0) return false;
+
+    JsonDocument doc;
+    if (deserializeJson(doc, message)) return true;
+
+    // 只接受当前未完成请求的应答，过期或重复的应答会把排队时间算进偏差
+    uint32_t seq = doc["seq"] | 0;
+    if (!requestPending || seq != requestSeq) return true;
+    requestPending = false;
+
+    int64_t t2 = doc["t2"].as<int64_t>();
+    int64_t t3 = doc["t3"].as<int64_t>();
+    if (t2 <= 0 || t3 <= 0) return true;
+
+    if (xSemaphoreTake(timeSyncMutex, portMAX_DELAY) == pdTRUE) {
+        bool wasSynced = clockFilter.synced;
+        clockFilterAddSample(&clockFilter, pendingT1, t2, t3, localUs);
+        if (clockFilter.samples != timeSyncStats.samples) {
+            timeSyncStats.lastDelayUs = (localUs - pendingT1) - (t3 - t2);
+        }
+        timeSyncStats.samples = clockFilter.samples;
+        timeSyncStats.steps = clockFilter.steps;
+        xSemaphoreGive(timeSyncMutex);
+
+        if (!wasSynced && clockFilter.synced) {
+            Serial.println("[TIME] Synced, rtt " + String((long)(localUs - pendingT1)) + "us");
+        }
+    }
+    if (burstRemaining > 0) burstRemaining--;
+    return true;
+}
+
+// ==================== 状态获取函数 ====================
+
+int64_t timeSyncEpochUs(int64_t localUs) {
+    int64_t epochUs = 0;
+    if (xSemaphoreTake(timeSyncMutex, portMAX_DELAY) == pdTRUE) {
+        epochUs = clockFilterToReference(&clockFilter, localUs);
+        xSemaphoreGive(timeSyncMutex);
+    }
+    return epochUs;
+}
+
+int64_t timeSyncNowEpochUs() {
+    return timeSyncEpochUs(esp_timer_get_time());
+}
+
+TimeSyncStatus getTimeSyncStatus() {
+    TimeSyncStatus status = {};
+    int64_t now = esp_timer_get_time();
+    if (xSemaphoreTake(timeSyncMutex, portMAX_DELAY) == pdTRUE) {
+        status = timeSyncStats;
+        status.synced = clockFilter.synced;
+        status.driftPpm = clockFilter.driftPpm;
+        if (clockFilter.synced) {
+            status.offsetUs = clockFilterToReference(&clockFilter, now) - now;
+            status.uncertaintyUs = clockFilterUncertaintyUs(&clockFilter, now);
+        } else {
+            status.uncertaintyUs = -1;
+        }
+        xSemaphoreGive(timeSyncMutex);
+    }
+    return status;
+}
+
+void printTimeSyncReport() {
+    TimeSyncStatus status = getTimeSyncStatus();
+    if (!status.synced) {
+        Serial.println("Time: Unsynced, requests " + String(status.requests) + ", timeouts " + String(status.timeouts));
+        return;
+    }
+    Serial.println("Time: Offset=" + String((double)status.offsetUs / 1000.0, 3) + "ms" +
+                   ", Drift=" + String(status.driftPpm, 2) + "ppm" +
+                   ", +/-" + String((long)status.uncertaintyUs) + "us" +
+                   ", Samples=" + String(status.samples) + "/" + String(status.requests) +
+                   ", Steps=" + String(status.steps));
+}
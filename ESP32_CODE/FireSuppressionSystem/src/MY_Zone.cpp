@@ -0,0 +1,185 @@
+#include <Arduino.h>
+#include "MY_Zone.h"
+#include "MY_DHT11.h"
+#include "MY_MQ2.h"
+#include "MY_Fusion.h"
+#include "MY_Pump.h"
+#include "MY_Fan.h"
+#include "MY_Power.h"
+#include "MY_Memory.h"
+#include "MY_Actuator.h"
+
+// ==================== 分区硬件表 ====================
+// 每行一个分区：名称, DHT11, MQ-2 AO, MQ-2 DO, 分区风扇, 喷淋阀
+// 第0区使用原有的单房间接线，新增分区时增加一行并修改 ZONE_COUNT，例如：
+//     { "room2", 4, 5, 6, 10, 11 },
+const ZoneDescriptor zoneTable[ZONE_COUNT] = {
+    { "zone0", DHTPIN, MQ2_AO_PIN, MQ2_DO_PIN, ZONE_NO_PIN, ZONE_NO_PIN },
+};
+
+// ==================== 全局变量定义 ====================
+// 所有分区初始为关闭 (false/0)
+ZoneOutputs zoneOutputs = {};
+
+SemaphoreHandle_t zoneMutex = NULL;
+
+static ZoneCycleStats cycleStats = {0, 0, 0, 0};
+
+// ==================== 内部函数 (调用方需持有zoneMutex) ====================
+
+// 引脚来自分区表，与固定引脚的执行器共用寄存器写入路径
+static void writeZonePin(uint8_t pin, bool on) {
+    if (pin == ZONE_NO_PIN) return;
+    actuatorWritePin(pin, on == (ZONE_OUTPUT_ACTIVE_LEVEL == HIGH));
+}
+
+// ==================== 初始化函数 ====================
+
+/**
+ * @brief 初始化分区模块
+ * 配置各分区的风扇和喷淋阀输出引脚并置为关闭
+ */
+void setupZones() {
+    zoneMutex = CREATE_MODULE_MUTEX();
+
+    Serial.println("[ZONE] ========== Zone Module Init ==========");
+    Serial.println("[ZONE] Zones: " + String(ZONE_COUNT) + ", K230 camera in " + String(zoneTable[K230_ZONE].name));
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        const ZoneDescriptor* zone = &zoneTable[z];
+        if (zone->fanPin != ZONE_NO_PIN) {
+            pinMode(zone->fanPin, OUTPUT);
+            writeZonePin(zone->fanPin, false);
+        }
+        if (zone->valvePin != ZONE_NO_PIN) {
+            pinMode(zone->valvePin, OUTPUT);
+            writeZonePin(zone->valvePin, false);
+        }
+        Serial.println("[ZONE] " + String(zone->name) + ": DHT=" + String(zone->dhtPin) +
+                       " AO=" + String(zone->mq2AoPin) + " DO=" + String(zone->mq2DoPin) +
+                       " Fan=" + (zone->fanPin == ZONE_NO_PIN ? String("-") : String(zone->fanPin)) +
+                       " Valve=" + (zone->valvePin == ZONE_NO_PIN ? String("-") : String(zone->valvePin)));
+    }
+    Serial.println("[ZONE] ======================================");
+}
+
+// ==================== 分区执行器 ====================
+
+/**
+ * @brief 按各分区火灾等级更新分区风扇和喷淋阀
+ *
+ * 自动模式：
+ * - 风扇：分区等级 >= 报警时开启，恢复安全后关闭
+ * - 喷淋阀：分区达到灭火等级时打开，之后保持到水泵停止，避免喷水中途关阀憋压
+ * 手动模式：分区风扇跟随主风扇，喷淋阀跟随水泵 (由操作人员决定整层喷水)
+ */
+void zoneApplyOutputs() {
+    FireLevel levels[ZONE_COUNT];
+    fusionGetLevels(levels);
+
+    bool fanAuto = isFanAutoMode();
+    bool fanManualOn = !fanAuto && getFanState() == FAN_ON;
+    bool pumpAuto = isPumpAutoMode();
+    bool pumpRunning = isPumpRelayOn();
+
+    bool anyOpen = false;
+    if (xSemaphoreTake(zoneMutex, portMAX_DELAY) == pdTRUE) {
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+            bool fan = fanAuto ? (levels[z] != FIRE_LEVEL_NONE) : fanManualOn;
+            bool valve = pumpAuto ? (levels[z] == FIRE_LEVEL_SUPPRESS || (zoneOutputs.valveOpen[z] && pumpRunning))
+                                  : pumpRunning;
+
+            if (fan != zoneOutputs.fanOn[z]) {
+                zoneOutputs.fanOn[z] = fan;
+                writeZonePin(zoneTable[z].fanPin, fan);
+            }
+            if (valve != zoneOutputs.valveOpen[z]) {
+                zoneOutputs.valveOpen[z] = valve;
+                writeZonePin(zoneTable[z].valvePin, valve);
+                if (valve) {
+                    zoneOutputs.valveOpens[z]++;
+                }
+            }
+            anyOpen = anyOpen || fan || valve;
+        }
+        xSemaphoreGive(zoneMutex);
+    }
+
+    // 分区执行器动作期间保持全速，与主风扇/水泵一致
+    powerSetHold(POWER_HOLD_ZONE, anyOpen);
+}
+
+/**
+ * @brief 强制关闭全部分区输出
+ * 不获取zoneMutex：监控模块在受控重启前调用，此时持有互斥锁的任务可能已经卡死
+ * 每个引脚只是一次寄存器写入，不经过GPIO驱动的锁
+ */
+void zoneForceOff() {
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        writeZonePin(zoneTable[z].fanPin, false);
+        writeZonePin(zoneTable[z].valvePin, false);
+    }
+}
+
+/**
+ * @brief 记录一个传感器周期的耗时 (传感器任务调用)
+ * @param sampleUs 采样全部分区的耗时
+ * @param evalUs 融合评估全部分区的耗时
+ */
+void zoneRecordCycle(uint32_t sampleUs, uint32_t evalUs) {
+    if (xSemaphoreTake(zoneMutex, portMAX_DELAY) == pdTRUE) {
+        cycleStats.sampleUs = sampleUs;
+        cycleStats.evalUs = evalUs;
+        if (sampleUs > cycleStats.sampleMaxUs) cycleStats.sampleMaxUs = sampleUs;
+        if (evalUs > cycleStats.evalMaxUs) cycleStats.evalMaxUs = evalUs;
+        xSemaphoreGive(zoneMutex);
+    }
+}
+
+// ==================== 状态获取函数 ====================
+
+const char* getZoneName(uint8_t zone) {
+    return zone < ZONE_COUNT ? zoneTable[zone].name : "unknown";
+}
+
+bool isZoneFanOn(uint8_t zone) {
+    bool on = false;
+    if (zone < ZONE_COUNT && xSemaphoreTake(zoneMutex, portMAX_DELAY) == pdTRUE) {
+        on = zoneOutputs.fanOn[zone];
+        xSemaphoreGive(zoneMutex);
+    }
+    return on;
+}
+
+bool isZoneValveOpen(uint8_t zone) {
+    bool open = false;
+    if (zone < ZONE_COUNT && xSemaphoreTake(zoneMutex, portMAX_DELAY) == pdTRUE) {
+        open = zoneOutputs.valveOpen[zone];
+        xSemaphoreGive(zoneMutex);
+    }
+    return open;
+}
+
+ZoneCycleStats getZoneCycleStats() {
+    ZoneCycleStats stats = {0, 0, 0, 0};
+    if (xSemaphoreTake(zoneMutex, portMAX_DELAY) == pdTRUE) {
+        stats = cycleStats;
+        xSemaphoreGive(zoneMutex);
+    }
+    return stats;
+}
+
+/**
+ * @brief 打印各分区火灾等级、执行器状态与周期耗时
+ */
+void printZoneReport() {
+    ZoneCycleStats stats = getZoneCycleStats();
+    Serial.println("Zones: " + String(ZONE_COUNT) + ", sample " + String(stats.sampleUs) + "us (max " +
+                   String(stats.sampleMaxUs) + "), eval " + String(stats.evalUs) + "us (max " +
+                   String(stats.evalMaxUs) + ")");
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+        FireAssessment fire = fusionZoneAssessment(z);
+        Serial.println("Zone: " + String(zoneTable[z].name) + " level=" + String(getFireLevelName(fire.level)) + " score=" + String(fire.score, 2) +
+                       " fan=" + String(isZoneFanOn(z) ? "on" : "off") +
+                       " valve=" + String(isZoneValveOpen(z) ? "open" : "closed"));
+    }
+}
@@ -5,117 +5,223 @@
 #include "MY_Fan.h"
 #include "MY_Pump.h"
 #include "MY_K230.h"
+#include "MY_Snapshot.h"
 #include "MY_Buzzer.h"
-#include <esp_task_wdt.h>
 #include "MY_Sensor.h"
+#include "MY_Outbox.h"
+#include "MY_LocalServer.h"
+#include "MY_Config.h"
+#include "MY_Power.h"
+#include "MY_Supervisor.h"
+#include "MY_Memory.h"
+#include "MY_Fusion.h"
+#include "MY_Zone.h"
+#include "MY_TimeSync.h"
+#include "MY_Ota.h"
+#include "MY_Boot.h"
+#include "MY_Dsp.h"
+#include "MY_Classifier.h"
 void setup() {
-    // ==================== 禁用看门狗 ====================
-    esp_task_wdt_deinit();
+    // 记录启动时刻（需最先调用，之后各阶段耗时均以此为准）
+    setupBoot();
 
     // 关闭ESP32-S3上的RGB灯
     neopixelWrite(48, 0, 0, 0);
     
-    // 初始化串口
+    // 初始化串口（不再等待串口监视器，布防不受其影响）
     Serial.begin(115200);
-    delay(2000); 
 
     Serial.println("========================================");
     Serial.println("ESP32-S3 Fire Suppression System");
     Serial.println("========================================");
 
+    // ---------- 安全阶段：传感器、执行器与K230，不依赖网络 ----------
+
+    // 加载运行时配置（需在各控制模块之前）
+    setupConfig();
+
     // 初始化 DHT 传感器
     dht.begin();
     
     // 初始化 MQ-2 烟雾传感器
     setupMQ2();
 
+    // 初始化火灾置信度融合评估（需在传感器与各执行器模块之前）
+    setupFusion();
+
     // 初始化传感器数据
     setupSensor();
 
+    // 初始化传感器流窗口特征（需在传感器模块之后）
+    setupDsp();
+
+    // 初始化场景分类模型（PSRAM中存放权重与推理工作区）
+    setupClassifier();
+
     // 初始化风扇控制模块
     setupFan();
     
     // 初始化水泵控制模块
     setupPump();
 
+    // 初始化检测快照PSRAM槽位（需在K230模块之前）
+    setupSnapshot();
+
     // 初始化K230视觉模块串口通信
     setupK230();
 
     // 初始化蜂鸣器模块
     setupBuzzer();
 
-    // 初始化WiFi
-    Serial.println("Initializing WiFi...");
-    setupWiFi();
-    
-    // 初始化MQTT
-    setupMQTT();
+    // 初始化分区风扇与喷淋阀（需在各执行器模块之后）
+    setupZones();
 
-    // 创建风扇控制任务 (Core 0)
-    xTaskCreatePinnedToCore(
-        fanTask,
-        "Fan_Task",
-        4096,
-        NULL,
-        2,
-        &fanTaskHandle,
-        0
+    // 初始化电源管理（需在各执行器/传感器引脚配置之后）
+    setupPower();
+
+    // 初始化离线缓存队列（需在MQTT及各控制任务之前）
+    setupOutbox();
+
+    // 初始化任务监控与看门狗（读取上次重启原因，需在离线缓存队列之后）
+    setupSupervisor();
+
+    // 初始化固件升级：试运行期间反复重启时在此回滚（需在离线缓存队列之后、各任务创建之前）
+    setupOta();
+
+    // 初始化MQTT时钟同步（需在MQTT之前）
+    setupTimeSync();
+
+    bootMark(BOOT_STAGE_CONTROL_INIT);
+
+    // 创建任务监控任务 (Core 1, 最高优先级)
+    CREATE_PINNED_TASK(
+        supervisorTask,
+        "Supervisor_Task",
+        TASK_STACK_SUPERVISOR,
+        6,              // 优先级6，高于所有被监控任务
+        &supervisorTaskHandle,
+        1
     );
-    
+
+    // 创建传感器读取数据任务 (Core 1, 首次采样完成后各控制任务开始工作)
+    CREATE_PINNED_TASK(
+        sensorTask,
+        "Sensor_Task",
+        TASK_STACK_SENSOR,
+        5,
+        &sensorTaskHandle,
+        1
+    );
+
     // 创建水泵控制任务 (Core 0)
-    xTaskCreatePinnedToCore(
+    CREATE_PINNED_TASK(
         pumpTask,
         "Pump_Task",
-        4096,
-        NULL,
+        TASK_STACK_PUMP,
         3,              // 优先级3，最高（灭火最重要）
         &pumpTaskHandle,
         0
     );
 
-    // 创建K230视觉检测任务 (Core 0, 最高优先级)
-    xTaskCreatePinnedToCore(
+    // 创建风扇控制任务 (Core 0)
+    CREATE_PINNED_TASK(
+        fanTask,
+        "Fan_Task",
+        TASK_STACK_FAN,
+        2,
+        &fanTaskHandle,
+        0
+    );
+
+    // 创建K230视觉检测任务 (Core 0, 最高优先级，创建后立即接收检测结果)
+    CREATE_PINNED_TASK(
         k230Task,
         "K230_Task",
-        4096,
-        NULL,
+        TASK_STACK_K230,
         4,              // 优先级4，最高（火焰检测最重要）
         &k230TaskHandle,
         0
     );
 
     // 创建蜂鸣器控制任务 (Core 0)
-    xTaskCreatePinnedToCore(
+    CREATE_PINNED_TASK(
         buzzerTask,
         "Buzzer_Task",
-        2048,
-        NULL,
+        TASK_STACK_BUZZER,
         1,              // 优先级1，较低
         &buzzerTaskHandle,
         0
     );
 
-    // 创建 MQTT 任务 (Core 1)
-    xTaskCreatePinnedToCore(
+    bootMark(BOOT_STAGE_TASKS);
+
+    // 创建传感器流特征提取任务 (Core 1, 不参与布防)
+    CREATE_PINNED_TASK(
+        dspTask,
+        "DSP_Task",
+        TASK_STACK_DSP,
+        4,              // 优先级4，低于传感器任务，保证采样节奏
+        &dspTaskHandle,
+        1
+    );
+
+    // ---------- 网络阶段：WiFi后台连接，MQTT由MQTT任务的连接状态机推进 ----------
+
+    // 初始化WiFi（只发起连接，不等待结果）
+    Serial.println("Initializing WiFi...");
+    setupWiFi();
+    
+    // 初始化MQTT
+    setupMQTT();
+
+#if LOCAL_SERVER_ENABLE
+    // 初始化局域网本地服务器（socket需在WiFi初始化之后创建）
+    setupLocalServer();
+#endif
+
+    // 创建 MQTT 收发任务 (Core 1)
+    CREATE_PINNED_TASK(
         mqttTask,
         "MQTT_Task",
-        16384,
-        NULL,
-        1,
+        TASK_STACK_MQTT,
+        3,              // 优先级3，APP命令需及时处理
         &mqttTaskHandle,
         1
     );
 
-    // 创建传感器读取数据任务
-    xTaskCreatePinnedToCore(
-        sensorTask,
-        "Sensor_Task",
-        4096,
-        NULL,
-        5,
-        &sensorTaskHandle,
+    // 创建遥测序列化任务 (Core 1)
+    CREATE_PINNED_TASK(
+        telemetryTask,
+        "Telemetry_Task",
+        TASK_STACK_TELEMETRY,
+        1,              // 优先级1，较低
+        &telemetryTaskHandle,
+        1
+    );
+
+#if OTA_ENABLE
+    // 创建固件升级任务 (Core 1, Flash擦写耗时不定，最低优先级)
+    CREATE_PINNED_TASK(
+        otaTask,
+        "OTA_Task",
+        TASK_STACK_OTA,
+        1,
+        &otaTaskHandle,
+        1
+    );
+#endif
+
+#if LOCAL_SERVER_ENABLE
+    // 创建局域网本地服务器任务 (Core 1)
+    CREATE_PINNED_TASK(
+        localServerTask,
+        "Local_Server_Task",
+        TASK_STACK_LOCAL_SERVER,
+        1,
+        &localServerTaskHandle,
         1
     );
+#endif
 
     Serial.println("========================================");
     Serial.println("All tasks created successfully!");
@@ -127,9 +233,7 @@ void setup() {
 void loop() {
     // 每10秒打印一次系统状态
     Serial.println("\n========== System Status ==========");
-    Serial.print("Free Heap: ");
-    Serial.print(ESP.getFreeHeap());
-    Serial.println(" bytes");
+    printMemoryReport();
     Serial.println("-----------------------------------");
     Serial.print("Fan:  State=");
     Serial.print(getFanStateString());
@@ -141,10 +245,25 @@ void loop() {
     Serial.println(getPumpModeString());
     Serial.print("K230: Fire=");
     Serial.println(getK230FireStateString());
+    printK230Report();
+    Serial.print("Fire: Level=");
+    Serial.print(getFireLevelString());
+    Serial.print(", Score=");
+    Serial.print(getFireScore(), 2);
+    Serial.print(", Zone=");
+    Serial.println(getZoneName(getFireZone()));
+    printZoneReport();
     Serial.print("Buzzer: State=");
     Serial.print(getBuzzerStateString());
     Serial.print(", Mode=");
     Serial.println(getBuzzerModeString());
+    printPowerReport();
+    printSupervisorReport();
+    printTimeSyncReport();
+    printOtaReport();
+    printBootReport();
+    printDspReport();
+    printClassifierReport();
     Serial.println("===================================");
     
     delay(10000);
@@ -0,0 +1,19 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+
+// ==================== 主机端 Arduino 替身 ====================
+// 只提供 MY_Actuator.h 用到的部分：电平常量、pinMode 与可由测试设定的 millis()
+
+#define HIGH    0x1
+#define LOW     0x0
+#define OUTPUT  0x03
+
+extern uint32_t hostMillis;
+extern uint8_t hostPinMode[64];
+
+static inline uint32_t millis() { return hostMillis; }
+static inline void pinMode(uint8_t pin, uint8_t mode) { hostPinMode[pin] = mode; }
+
+#endif
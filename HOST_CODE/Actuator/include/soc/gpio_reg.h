@@ -0,0 +1,10 @@
+#ifndef HOST_GPIO_REG_H
+#define HOST_GPIO_REG_H
+
+// 与 ESP32-S3 的寄存器地址相同，主机端只用作 hostRegWrite 的区分
+#define GPIO_OUT_W1TS_REG       0x60004008
+#define GPIO_OUT_W1TC_REG       0x6000400C
+#define GPIO_OUT1_W1TS_REG      0x60004014
+#define GPIO_OUT1_W1TC_REG      0x60004018
+
+#endif
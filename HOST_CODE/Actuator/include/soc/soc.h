@@ -0,0 +1,13 @@
+#ifndef HOST_SOC_H
+#define HOST_SOC_H
+
+#include <stdint.h>
+
+// ==================== 主机端寄存器替身 ====================
+// REG_WRITE 记录到模拟的GPIO输出寄存器，测试据此检查引脚电平
+
+void hostRegWrite(uint32_t reg, uint32_t value);
+
+#define REG_WRITE(reg, value) hostRegWrite((reg), (value))
+
+#endif
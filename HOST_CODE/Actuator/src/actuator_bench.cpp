@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#else
+#define BENCH_HAS_TSC 0
+#endif
+#include "MY_Actuator.h"
+
+/*
+ * 执行器输出耗时对比：Actuator<>::set 与改动前模块直接调用的 digitalWrite 路径
+ *   - 旧路径按 arduino-esp32 2.x 建模：digitalWrite → gpio_set_level，两者在库的不同编译单元中，
+ *     不能内联；gpio_set_level 运行时检查引脚并按编号选择寄存器组
+ *   - 新路径为固件中实际使用的实例：水泵 MaxOnTimePolicy、风扇 CooldownPolicy、蜂鸣器 NoSafetyPolicy
+ *   - 每个被测路径包在一个 noinline 的 bench_* 函数中，代码大小由 make bench 用 nm 列出
+ * 寄存器写为对 volatile 数组的一次存储，两条路径相同；结果是主机 (x86) 上的数字，
+ * 只用于比较两条路径的相对开销，设备上的周期数与Flash占用需在ESP32-S3上测量
+ */
+
+// ==================== 寄存器替身 ====================
+
+uint32_t hostMillis = 0;
+uint8_t hostPinMode[64];
+
+static volatile uint32_t gpioRegs[8];
+
+void hostRegWrite(uint32_t reg, uint32_t value) {
+    gpioRegs[(reg >> 2) & 7] = value;
+}
+
+// ==================== 旧路径模型 ====================
+
+// 可输出的GPIO (ESP32-S3：0~21、26~48)
+#define LEGACY_GPIO_OUTPUT_MASK     0x0001FFFFFC3FFFFFULL
+
+extern "C" __attribute__((noinline)) void legacy_gpio_set_level(uint32_t gpio, uint32_t level) {
+    if (gpio >= 49 || !((LEGACY_GPIO_OUTPUT_MASK >> gpio) & 1)) return;
+    if (level) {
+        if (gpio < 32) REG_WRITE(GPIO_OUT_W1TS_REG, 1UL << gpio);
+        else REG_WRITE(GPIO_OUT1_W1TS_REG, 1UL << (gpio - 32));
+    } else {
+        if (gpio < 32) REG_WRITE(GPIO_OUT_W1TC_REG, 1UL << gpio);
+        else REG_WRITE(GPIO_OUT1_W1TC_REG, 1UL << (gpio - 32));
+    }
+}
+
+extern "C" __attribute__((noinline)) void legacy_digitalWrite(uint8_t pin, uint8_t val) {
+    legacy_gpio_set_level(pin, val);
+}
+
+// ==================== 被测路径 ====================
+
+#define BENCH_PUMP_PIN      14
+#define BENCH_FAN_PIN       21
+#define BENCH_BUZZER_PIN    38
+
+static Actuator<BENCH_PUMP_PIN, HIGH, MaxOnTimePolicy<65000> > pumpRelay;
+static Actuator<BENCH_FAN_PIN, HIGH, CooldownPolicy<3000> > fanRelay;
+static Actuator<BENCH_BUZZER_PIN, LOW> buzzerOut;
+
+// 改动前：水泵/风扇 digitalWrite(pin, on ? HIGH : LOW)，蜂鸣器低电平有效
+extern "C" __attribute__((noinline)) void bench_legacy_pump(bool on) {
+    legacy_digitalWrite(BENCH_PUMP_PIN, on ? HIGH : LOW);
+}
+
+extern "C" __attribute__((noinline)) void bench_legacy_buzzer(bool on) {
+    legacy_digitalWrite(BENCH_BUZZER_PIN, on ? LOW : HIGH);
+}
+
+// 改动后
+extern "C" __attribute__((noinline)) void bench_actuator_pump(bool on) {
+    pumpRelay.set(on);
+}
+
+extern "C" __attribute__((noinline)) void bench_actuator_fan(bool on) {
+    fanRelay.set(on);
+}
+
+extern "C" __attribute__((noinline)) void bench_actuator_buzzer(bool on) {
+    buzzerOut.set(on);
+}
+
+extern "C" __attribute__((noinline)) void bench_actuator_write_pin(bool on) {
+    actuatorWritePin(BENCH_PUMP_PIN, on);
+}
+
+// ==================== 计时 ====================
+
+#define BENCH_ITERATIONS    50000000
+
+typedef struct {
+    const char* name;
+    void (*fn)(bool);
+} BenchCase;
+
+static const BenchCase cases[] = {
+    { "legacy digitalWrite (pump)", bench_legacy_pump },
+    { "legacy digitalWrite (buzzer, pin 38)", bench_legacy_buzzer },
+    { "Actuator<14,HIGH,MaxOnTime>::set", bench_actuator_pump },
+    { "Actuator<21,HIGH,Cooldown>::set", bench_actuator_fan },
+    { "Actuator<38,LOW>::set", bench_actuator_buzzer },
+    { "actuatorWritePin (runtime pin)", bench_actuator_write_pin },
+};
+
+int main() {
+    pumpRelay.begin();
+    fanRelay.begin();
+    buzzerOut.begin();
+
+    printf("[BENCH] %d calls per case, alternating on/off\n", BENCH_ITERATIONS);
+    for (const BenchCase& c : cases) {
+        // 风扇冷却期内 set(true) 被拒绝；时间每次前进足够长，使每次开关都真正写入
+        hostMillis = 0;
+        auto start = std::chrono::steady_clock::now();
+#if BENCH_HAS_TSC
+        uint64_t tscStart = __rdtsc();
+#endif
+        for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+            hostMillis += 4000;
+            c.fn(i & 1);
+        }
+#if BENCH_HAS_TSC
+        uint64_t tscEnd = __rdtsc();
+#endif
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / BENCH_ITERATIONS;
+#if BENCH_HAS_TSC
+        double cycles = (double)(tscEnd - tscStart) / BENCH_ITERATIONS;
+        printf("[BENCH] %-40s %6.2f ns/call  %6.2f TSC cycles/call\n", c.name, ns, cycles);
+#else
+        printf("[BENCH] %-40s %6.2f ns/call\n", c.name, ns);
+#endif
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "MY_Actuator.h"
+
+/*
+ * 执行器输出模板测试：直接包含固件的 MY_Actuator.h，寄存器与 millis() 由 include/ 中的替身提供
+ *   1. 寄存器写入：低/高两组GPIO、有效电平、分区输出的运行时引脚
+ *   2. MaxOnTimePolicy：到达上限时 service() 强制关闭，重复开启不重新计时，millis() 回绕
+ *   3. CooldownPolicy：关闭后冷却期内拒绝导通且不写寄存器，上电后首次导通不受限
+ *   4. NoSafetyPolicy：service() 从不动作
+ * 任一检查失败时退出码为1
+ */
+
+// ==================== 寄存器替身 ====================
+
+uint32_t hostMillis = 0;
+uint8_t hostPinMode[64];
+
+static uint32_t gpioOut[2];     // 模拟的 GPIO_OUT / GPIO_OUT1
+static uint32_t regWrites = 0;
+
+void hostRegWrite(uint32_t reg, uint32_t value) {
+    regWrites++;
+    switch (reg) {
+        case GPIO_OUT_W1TS_REG: gpioOut[0] |= value; break;
+        case GPIO_OUT_W1TC_REG: gpioOut[0] &= ~value; break;
+        case GPIO_OUT1_W1TS_REG: gpioOut[1] |= value; break;
+        case GPIO_OUT1_W1TC_REG: gpioOut[1] &= ~value; break;
+        default: break;
+    }
+}
+
+static bool pinHigh(uint8_t pin) {
+    return (gpioOut[pin / 32] >> (pin % 32)) & 1;
+}
+
+// ==================== 检查 ====================
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("[ACTUATOR] %-58s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+// ==================== 测试用例 ====================
+
+static void testRegisters() {
+    gpioOut[0] = 0;
+    gpioOut[1] = 0xFFFFFFFF;
+
+    // 低组引脚，高电平有效 (水泵继电器的接法)
+    Actuator<14, HIGH> relay;
+    relay.begin();
+    check(hostPinMode[14] == OUTPUT && !pinHigh(14), "begin() configures output at the inactive level");
+    relay.set(true);
+    check(pinHigh(14) && relay.isActive(), "active-high pin 14 goes high when on");
+    relay.set(false);
+    check(!pinHigh(14) && !relay.isActive(), "active-high pin 14 goes low when off");
+
+    // 高组引脚，低电平有效 (蜂鸣器的接法)
+    Actuator<38, LOW> buzzer;
+    buzzer.begin();
+    check(pinHigh(38), "active-low pin 38 idles high");
+    buzzer.set(true);
+    check(!pinHigh(38) && gpioOut[1] == ~(uint32_t)(1u << 6), "active-low pin 38 goes low, other GPIO_OUT1 bits untouched");
+
+    // 分区输出的运行时引脚
+    actuatorWritePin(21, true);
+    actuatorWritePin(47, false);
+    check(pinHigh(21) && !pinHigh(47), "actuatorWritePin() drives runtime pins in both banks");
+
+    uint32_t before = regWrites;
+    relay.set(true);
+    check(regWrites == before + 1, "set() is a single register write");
+}
+
+static void testMaxOnTime() {
+    Actuator<14, HIGH, MaxOnTimePolicy<1000> > relay;
+    hostMillis = 5000;
+    relay.begin();
+    relay.set(true);
+    hostMillis = 5500;
+    relay.set(true);            // 已导通时重复开启不重新计时
+    hostMillis = 5999;
+    check(!relay.service() && pinHigh(14), "MaxOnTime: still on 1ms before the limit");
+    hostMillis = 6000;
+    check(relay.service() && !pinHigh(14) && !relay.isActive(), "MaxOnTime: forced off at the limit");
+    check(!relay.service(), "MaxOnTime: service() is idle while off");
+
+    // 导通期间 millis() 回绕
+    hostMillis = 0xFFFFFF00;
+    relay.set(true);
+    hostMillis = 0x000002E7;    // 回绕后经过 999ms
+    check(!relay.service(), "MaxOnTime: no early trip across millis() wrap");
+    hostMillis = 0x000002E8;
+    check(relay.service() && !pinHigh(14), "MaxOnTime: trips on time across millis() wrap");
+}
+
+static void testCooldown() {
+    Actuator<13, HIGH, CooldownPolicy<3000> > fan;
+    hostMillis = 100;
+    fan.begin();
+    check(fan.set(true) && pinHigh(13), "Cooldown: first start after begin() is allowed");
+
+    hostMillis = 200;
+    fan.set(false);
+    hostMillis = 3199;
+    uint32_t before = regWrites;
+    check(!fan.set(true) && !pinHigh(13) && !fan.isActive() && regWrites == before,
+          "Cooldown: restart refused 1ms early without a write");
+    check(fan.set(false) && !pinHigh(13), "Cooldown: switching off is always allowed");
+    hostMillis = 3200;
+    check(fan.set(true) && pinHigh(13), "Cooldown: restart allowed once the cooldown elapsed");
+
+    // 冷却只从导通到关闭的跳变起算，重复关闭不延长
+    hostMillis = 4000;
+    fan.set(false);
+    hostMillis = 6000;
+    fan.set(false);
+    hostMillis = 7000;
+    check(fan.set(true), "Cooldown: repeated off does not extend the cooldown");
+    check(!fan.service(), "Cooldown: service() never forces the output off");
+}
+
+static void testNoSafety() {
+    Actuator<14, HIGH> relay;
+    hostMillis = 0;
+    relay.begin();
+    relay.set(true);
+    hostMillis = 0x7FFFFFFF;
+    check(!relay.service() && pinHigh(14), "NoSafety: service() never acts");
+    relay.set(false);
+    check(relay.set(true), "NoSafety: immediate restart allowed");
+}
+
+// ==================== 主程序 ====================
+
+int main() {
+    testRegisters();
+    testMaxOnTime();
+    testCooldown();
+    testNoSafety();
+
+    printf("[ACTUATOR] %s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
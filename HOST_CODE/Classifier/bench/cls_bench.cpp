@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "MY_ClassifierKernels.h"
+#include "MY_ClassifierModel.h"
+#include "MY_Scenario.h"
+#include "MY_Eval.h"
+
+/*
+ * 场景分类推理基准：直接编译固件的 MY_ClassifierKernels.cpp 与 MY_ClassifierModel.h
+ *   1. 精度：用训练时未见过的随机种子生成测试集，比较参考实现 (激活不量化) 与int8推理，
+ *            统计准确率、两者判定一致率和按固件门控规则的拦截率，超出容差时退出码为1
+ *   2. 拷贝：按固件的方式把模型拷贝到独立存储区 (设备上为PSRAM)，结果须与原模型逐位一致
+ *   3. 耗时：每次推理 (含输入标准化与量化、softmax) 的耗时
+ */
+
+// ==================== 基准参数 ====================
+#define BENCH_DEFAULT_PER_SCENE     1000    // 每种场景的测试样本数
+#define BENCH_DEFAULT_SEED          7       // 训练默认使用种子1，验证集使用1001
+#define BENCH_DEFAULT_ROUNDS        20
+#define BENCH_MIN_TIME_S            0.2
+// 与固件 MY_Classifier.h 的 CLS_VETO_NUISANCE_PROB 一致
+#define BENCH_VETO_PROB             0.80f
+
+// 容差
+#define TOL_ACCURACY_DROP           0.01f   // int8 相对参考实现的准确率下降
+#define TOL_MIN_AGREEMENT           0.97f   // int8 与参考实现判定一致的比例
+#define TOL_MAX_FIRE_VETO           0.03f   // 火灾样本被拦截的比例
+
+// ==================== 计时 ====================
+
+static double wallSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static volatile float sink;
+
+typedef void (*InferFn)(const ClsModel* model, int8_t* arena, const float* input, ClsResult* out);
+
+static void runRef(const ClsModel* model, int8_t*, const float* input, ClsResult* out) {
+    clsInferRef(model, input, out);
+}
+
+static void runInt8(const ClsModel* model, int8_t* arena, const float* input, ClsResult* out) {
+    clsInfer(model, arena, input, out);
+}
+
+static double timeInference(InferFn fn, const ClsModel* model, int8_t* arena,
+                            const std::vector<ScenarioSample>& samples, int rounds) {
+    size_t calls = 0;
+    double start = wallSeconds(), elapsed = 0.0;
+    do {
+        for (int r = 0; r < rounds; r++) {
+            for (const ScenarioSample& s : samples) {
+                ClsResult result;
+                fn(model, arena, s.input, &result);
+                sink = result.prob[CLS_CLASS_FIRE];
+            }
+            calls += samples.size();
+        }
+        elapsed = wallSeconds() - start;
+    } while (elapsed < BENCH_MIN_TIME_S);
+    return elapsed * 1e9 / calls;
+}
+
+// ==================== 主程序 ====================
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [-n per_scene] [-r rounds] [-s seed]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    int perScene = BENCH_DEFAULT_PER_SCENE;
+    int rounds = BENCH_DEFAULT_ROUNDS;
+    uint64_t seed = BENCH_DEFAULT_SEED;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:s:")) != -1) {
+        switch (opt) {
+            case 'n': perScene = atoi(optarg); break;
+            case 'r': rounds = atoi(optarg); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (perScene <= 0 || rounds <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const ClsModel* model = &clsDefaultModel;
+    if (!clsModelValid(model)) {
+        printf("[BENCH] model v%u is invalid\n", (unsigned)model->version);
+        return 1;
+    }
+    printf("[BENCH] model v%u, %u layers, %zu bytes of weights, arena %zu bytes, backend %s\n",
+           (unsigned)model->version, model->layerCount, clsModelDataBytes(model), clsArenaBytes(),
+           clsBackendString());
+
+    ScenarioGen gen;
+    if (!scenarioInit(&gen, seed)) {
+        printf("[BENCH] invalid DSP configuration\n");
+        return 1;
+    }
+    std::vector<ScenarioSample> samples = scenarioMakeSet(&gen, perScene);
+    printf("[BENCH] %zu test samples (seed %llu)\n", samples.size(), (unsigned long long)seed);
+
+    // 模型拷贝 (设备上拷贝到PSRAM)
+    std::vector<uint8_t> storage(clsModelDataBytes(model));
+    ClsModel copy;
+    clsModelCopy(model, storage.data(), &copy);
+    std::vector<int8_t> arena(clsArenaBytes());
+
+    // 1. 精度
+    EvalStats refStats, int8Stats;
+    evalReset(&refStats);
+    evalReset(&int8Stats);
+    size_t agree = 0, copyMismatch = 0;
+    float maxProbDiff = 0.0f;
+    for (const ScenarioSample& s : samples) {
+        ClsResult ref, q, c;
+        clsInferRef(model, s.input, &ref);
+        clsInfer(model, arena.data(), s.input, &q);
+        clsInfer(&copy, arena.data(), s.input, &c);
+        evalAdd(&refStats, &s, &ref, BENCH_VETO_PROB);
+        evalAdd(&int8Stats, &s, &q, BENCH_VETO_PROB);
+        if (ref.label == q.label) agree++;
+        if (memcmp(&q, &c, sizeof(ClsResult)) != 0) copyMismatch++;
+        for (int k = 0; k < CLS_CLASS_COUNT; k++) {
+            maxProbDiff = fmaxf(maxProbDiff, fabsf(ref.prob[k] - q.prob[k]));
+        }
+    }
+    evalPrint("ref", &refStats);
+    evalPrint("int8", &int8Stats);
+
+    float agreement = (float)agree / samples.size();
+    float drop = evalAccuracy(&refStats) - evalAccuracy(&int8Stats);
+    float fireVeto = evalVetoRate(&int8Stats, CLS_CLASS_FIRE);
+    bool ok = drop <= TOL_ACCURACY_DROP && agreement >= TOL_MIN_AGREEMENT &&
+              fireVeto <= TOL_MAX_FIRE_VETO && copyMismatch == 0;
+    printf("[BENCH] int8 vs ref: agreement %.2f%%, accuracy drop %.2f%%, max prob diff %.3f; "
+           "fire veto %.2f%%; copied model mismatches %zu  %s\n",
+           agreement * 100.0f, drop * 100.0f, maxProbDiff, fireVeto * 100.0f, copyMismatch,
+           ok ? "OK" : "FAIL");
+
+    // 2. 耗时
+    double refNs = timeInference(runRef, model, arena.data(), samples, rounds);
+    double int8Ns = timeInference(runInt8, model, arena.data(), samples, rounds);
+    double copyNs = timeInference(runInt8, &copy, arena.data(), samples, rounds);
+    printf("[BENCH] ref   speed: %8.0f ns/inference\n", refNs);
+    printf("[BENCH] int8  speed: %8.0f ns/inference (%.1fx ref)\n", int8Ns, refNs / int8Ns);
+    printf("[BENCH] copy  speed: %8.0f ns/inference\n", copyNs);
+
+    printf("[BENCH] %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#ifndef MY_EVAL_H
+#define MY_EVAL_H
+
+#include <stdint.h>
+#include "MY_ClassifierKernels.h"
+#include "MY_Scenario.h"
+
+/*
+ * 分类评估：混淆矩阵、各场景准确率，以及按固件门控规则统计的拦截率
+ *   拦截：干扰源概率 >= vetoProb 时固件暂缓自动喷水
+ *   火灾被拦截率越低越好 (拦截时间有上限，但会推迟灭火)，干扰源被拦截率越高越好
+ */
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint32_t confusion[CLS_CLASS_COUNT][CLS_CLASS_COUNT];   // [真实][预测]
+    uint32_t sceneTotal[SCENE_COUNT];
+    uint32_t sceneCorrect[SCENE_COUNT];
+    uint32_t vetoed[CLS_CLASS_COUNT];                       // 各真实类别被拦截的样本数
+    uint32_t total;
+} EvalStats;
+
+// ==================== 函数声明 ====================
+
+void evalReset(EvalStats* stats);
+void evalAdd(EvalStats* stats, const ScenarioSample* sample, const ClsResult* result, float vetoProb);
+
+float evalAccuracy(const EvalStats* stats);
+float evalRecall(const EvalStats* stats, ClsClass label);
+float evalVetoRate(const EvalStats* stats, ClsClass label);
+
+// 打印混淆矩阵与各场景准确率
+void evalPrint(const char* name, const EvalStats* stats);
+
+#endif
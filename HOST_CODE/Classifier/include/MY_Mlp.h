@@ -0,0 +1,64 @@
+#ifndef MY_MLP_H
+#define MY_MLP_H
+
+#include <stdint.h>
+#include <vector>
+#include "MY_ClassifierKernels.h"
+#include "MY_Scenario.h"
+
+/*
+ * 浮点MLP训练与训练后量化：
+ *   训练：隐藏层ReLU，输出softmax交叉熵，Adam，小批量，学习率余弦衰减；
+ *         各类别损失按权重加权 (火灾权重高于其他类别，减少把火灾判为干扰源)
+ *   量化：与固件 MY_ClassifierKernels 的约定一致
+ *         输入与各层激活为非对称int8，范围取校准集上的最小/最大值；权重按层对称量化；
+ *         偏置按 输入scale × 权重scale 量化为int32；重新量化乘数为 Q31 + 移位
+ *   导出：生成固件的 MY_ClassifierModel.h
+ */
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint8_t layerCount;
+    uint16_t sizes[CLS_MAX_LAYERS + 1];         // sizes[0] = CLS_INPUT_COUNT，最后为 CLS_CLASS_COUNT
+    std::vector<float> weights[CLS_MAX_LAYERS]; // [out][in]
+    std::vector<float> bias[CLS_MAX_LAYERS];
+    float inputMean[CLS_INPUT_COUNT];
+    float inputInvStd[CLS_INPUT_COUNT];
+} MlpModel;
+
+typedef struct {
+    int epochs;
+    int batchSize;
+    float learningRate;
+    float weightDecay;
+    float classWeight[CLS_CLASS_COUNT];
+    uint64_t seed;
+} MlpTrainOptions;
+
+// 量化模型：model 中的指针指向本结构体内的数组 (不可拷贝)
+typedef struct {
+    ClsModel model;
+    std::vector<int8_t> weights[CLS_MAX_LAYERS];
+    std::vector<int32_t> bias[CLS_MAX_LAYERS];
+} MlpQuantModel;
+
+// ==================== 函数声明 ====================
+
+// 建立网络 (hidden 为各隐藏层宽度) 并按训练集计算输入标准化参数
+bool mlpInit(MlpModel* mlp, const uint16_t* hidden, uint8_t hiddenCount,
+             const std::vector<ScenarioSample>& train, uint64_t seed);
+
+// 训练，返回最后一轮的平均损失
+float mlpTrain(MlpModel* mlp, const std::vector<ScenarioSample>& train, const MlpTrainOptions* options);
+
+// 浮点推理
+void mlpInfer(const MlpModel* mlp, const float input[CLS_INPUT_COUNT], ClsResult* out);
+
+// 训练后量化 (calib 为校准集)
+bool mlpQuantize(const MlpModel* mlp, const std::vector<ScenarioSample>& calib, MlpQuantModel* out);
+
+// 写出固件模型头文件，summary 写入文件注释
+bool mlpWriteHeader(const MlpQuantModel* quant, const char* path, const char* summary);
+
+#endif
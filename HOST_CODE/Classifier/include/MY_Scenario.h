@@ -0,0 +1,65 @@
+#ifndef MY_SCENARIO_H
+#define MY_SCENARIO_H
+
+#include <stdint.h>
+#include <vector>
+#include "MY_DspKernels.h"
+#include "MY_ClassifierKernels.h"
+
+/*
+ * 合成场景：按场景参数生成一个分区在评估时刻之前的
+ *   MQ-2 ADC计数 (50Hz，一个烟雾窗口)、温度 (0.5Hz，0.01°C，一个温度窗口) 和当前湿度，
+ *   再用固件的定点窗口特征 (dspFeaturesQ15) 和 clsBuildInput 得到分类器输入
+ *   每个样本的参数 (基线、事件强度、事件已持续时间、湍流频率等) 都随机抽取
+ */
+
+// ==================== 流配置 (与固件 MY_Dsp.h 一致) ====================
+#define SCENE_SMOKE_RATE_HZ         50.0f
+#define SCENE_SMOKE_WINDOW          128
+#define SCENE_SMOKE_SCALE           (100.0f / 4095.0f)
+#define SCENE_TEMP_RATE_HZ          0.5f
+#define SCENE_TEMP_WINDOW           32
+#define SCENE_TEMP_SCALE            0.01f
+
+// ==================== 枚举定义 ====================
+
+typedef enum {
+    SCENE_CLEAN = 0,            // 洁净空气
+    SCENE_DRAFT = 1,            // 空调/开门气流：烟雾读数缓慢起伏
+    SCENE_SMOULDER = 2,         // 阴燃：烟雾缓升伴随湍流，温度滞后上升
+    SCENE_FLAMING = 3,          // 明火：烟雾快速上升、强烈闪烁，温度快速上升
+    SCENE_STEAM = 4,            // 水汽：烟雾读数平滑上升，湿度大幅上升
+    SCENE_COOKING = 5,          // 烹饪油烟：烟雾中等起伏，温度与湿度小幅上升
+    SCENE_DUST = 6,             // 粉尘：短促尖峰，高频成分为主
+    SCENE_COUNT = 7
+} SceneKind;
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    SceneKind kind;
+    ClsClass label;
+    float input[CLS_INPUT_COUNT];
+} ScenarioSample;
+
+// 生成器 (含特征计算计划与随机数状态)
+typedef struct {
+    DspPlan smokePlan;
+    DspPlan tempPlan;
+    uint64_t rng;
+} ScenarioGen;
+
+// ==================== 函数声明 ====================
+
+bool scenarioInit(ScenarioGen* gen, uint64_t seed);
+
+// 生成一个样本
+void scenarioMake(ScenarioGen* gen, SceneKind kind, ScenarioSample* out);
+
+// 每种场景生成 perScene 个样本 (按场景顺序排列)
+std::vector<ScenarioSample> scenarioMakeSet(ScenarioGen* gen, int perScene);
+
+ClsClass scenarioLabel(SceneKind kind);
+const char* scenarioName(SceneKind kind);
+
+#endif
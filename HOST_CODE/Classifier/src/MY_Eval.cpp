@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <string.h>
+#include "MY_Eval.h"
+
+// ==================== 统计 ====================
+
+void evalReset(EvalStats* stats) {
+    memset(stats, 0, sizeof(EvalStats));
+}
+
+void evalAdd(EvalStats* stats, const ScenarioSample* sample, const ClsResult* result, float vetoProb) {
+    stats->confusion[sample->label][result->label]++;
+    stats->sceneTotal[sample->kind]++;
+    if (result->label == sample->label) stats->sceneCorrect[sample->kind]++;
+    if (result->prob[CLS_CLASS_NUISANCE] >= vetoProb) stats->vetoed[sample->label]++;
+    stats->total++;
+}
+
+static uint32_t classTotal(const EvalStats* stats, ClsClass label) {
+    uint32_t total = 0;
+    for (int p = 0; p < CLS_CLASS_COUNT; p++) total += stats->confusion[label][p];
+    return total;
+}
+
+float evalAccuracy(const EvalStats* stats) {
+    uint32_t correct = 0;
+    for (int c = 0; c < CLS_CLASS_COUNT; c++) correct += stats->confusion[c][c];
+    return stats->total > 0 ? (float)correct / stats->total : 0.0f;
+}
+
+float evalRecall(const EvalStats* stats, ClsClass label) {
+    uint32_t total = classTotal(stats, label);
+    return total > 0 ? (float)stats->confusion[label][label] / total : 0.0f;
+}
+
+float evalVetoRate(const EvalStats* stats, ClsClass label) {
+    uint32_t total = classTotal(stats, label);
+    return total > 0 ? (float)stats->vetoed[label] / total : 0.0f;
+}
+
+// ==================== 输出 ====================
+
+void evalPrint(const char* name, const EvalStats* stats) {
+    printf("[EVAL] %s: accuracy %.2f%%, veto fire %.2f%% / nuisance %.2f%%\n", name,
+           evalAccuracy(stats) * 100.0f, evalVetoRate(stats, CLS_CLASS_FIRE) * 100.0f,
+           evalVetoRate(stats, CLS_CLASS_NUISANCE) * 100.0f);
+    printf("[EVAL]   %-10s %8s %8s %8s\n", "true\\pred", "normal", "nuisance", "fire");
+    for (int c = 0; c < CLS_CLASS_COUNT; c++) {
+        printf("[EVAL]   %-10s %8u %8u %8u\n", clsClassString((ClsClass)c),
+               stats->confusion[c][0], stats->confusion[c][1], stats->confusion[c][2]);
+    }
+    printf("[EVAL]  ");
+    for (int k = 0; k < SCENE_COUNT; k++) {
+        if (stats->sceneTotal[k] == 0) continue;
+        printf(" %s %.1f%%", scenarioName((SceneKind)k), 100.0f * stats->sceneCorrect[k] / stats->sceneTotal[k]);
+    }
+    printf("\n");
+}
@@ -0,0 +1,373 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "MY_Mlp.h"
+
+// ==================== 随机数 ====================
+
+static double uniform(uint64_t* state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ((*state >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gaussian(uint64_t* state) {
+    return sqrt(-2.0 * log(uniform(state))) * cos(2.0 * M_PI * uniform(state));
+}
+
+// ==================== 前向计算 ====================
+
+static void normalize(const MlpModel* mlp, const float* input, float* out) {
+    for (int i = 0; i < CLS_INPUT_COUNT; i++) {
+        out[i] = (input[i] - mlp->inputMean[i]) * mlp->inputInvStd[i];
+    }
+}
+
+// acts[l] 为第 l 层的输入 (acts[0] 为标准化后的输入)，acts[layerCount] 为 logit
+static void forward(const MlpModel* mlp, const float* input, float acts[][CLS_MAX_WIDTH]) {
+    normalize(mlp, input, acts[0]);
+    for (uint8_t l = 0; l < mlp->layerCount; l++) {
+        uint16_t in = mlp->sizes[l], outSize = mlp->sizes[l + 1];
+        bool relu = l + 1 < mlp->layerCount;
+        for (uint16_t o = 0; o < outSize; o++) {
+            const float* w = &mlp->weights[l][(size_t)o * in];
+            float acc = mlp->bias[l][o];
+            for (uint16_t i = 0; i < in; i++) acc += w[i] * acts[l][i];
+            acts[l + 1][o] = (relu && acc < 0.0f) ? 0.0f : acc;
+        }
+    }
+}
+
+static void softmax(const float* logits, float* prob) {
+    float maxLogit = *std::max_element(logits, logits + CLS_CLASS_COUNT);
+    float sum = 0.0f;
+    for (int c = 0; c < CLS_CLASS_COUNT; c++) {
+        prob[c] = expf(logits[c] - maxLogit);
+        sum += prob[c];
+    }
+    for (int c = 0; c < CLS_CLASS_COUNT; c++) prob[c] /= sum;
+}
+
+void mlpInfer(const MlpModel* mlp, const float input[CLS_INPUT_COUNT], ClsResult* out) {
+    float acts[CLS_MAX_LAYERS + 1][CLS_MAX_WIDTH];
+    forward(mlp, input, acts);
+    softmax(acts[mlp->layerCount], out->prob);
+    out->label = CLS_CLASS_NORMAL;
+    for (int c = 1; c < CLS_CLASS_COUNT; c++) {
+        if (out->prob[c] > out->prob[out->label]) out->label = (ClsClass)c;
+    }
+}
+
+// ==================== 初始化 ====================
+
+bool mlpInit(MlpModel* mlp, const uint16_t* hidden, uint8_t hiddenCount,
+             const std::vector<ScenarioSample>& train, uint64_t seed) {
+    if (hiddenCount + 1 > CLS_MAX_LAYERS || train.empty()) return false;
+    mlp->layerCount = hiddenCount + 1;
+    mlp->sizes[0] = CLS_INPUT_COUNT;
+    for (uint8_t h = 0; h < hiddenCount; h++) {
+        if (hidden[h] == 0 || hidden[h] > CLS_MAX_WIDTH) return false;
+        mlp->sizes[h + 1] = hidden[h];
+    }
+    mlp->sizes[mlp->layerCount] = CLS_CLASS_COUNT;
+
+    // 标准化参数
+    for (int i = 0; i < CLS_INPUT_COUNT; i++) {
+        double sum = 0.0, sumSq = 0.0;
+        for (const ScenarioSample& s : train) {
+            sum += s.input[i];
+            sumSq += (double)s.input[i] * s.input[i];
+        }
+        double mean = sum / train.size();
+        double var = sumSq / train.size() - mean * mean;
+        mlp->inputMean[i] = (float)mean;
+        mlp->inputInvStd[i] = var > 1e-12 ? (float)(1.0 / sqrt(var)) : 1.0f;
+    }
+
+    // He初始化
+    uint64_t rng = seed;
+    for (uint8_t l = 0; l < mlp->layerCount; l++) {
+        uint16_t in = mlp->sizes[l], out = mlp->sizes[l + 1];
+        mlp->weights[l].resize((size_t)in * out);
+        mlp->bias[l].assign(out, 0.0f);
+        double stddev = sqrt(2.0 / in);
+        for (float& w : mlp->weights[l]) w = (float)(stddev * gaussian(&rng));
+    }
+    return true;
+}
+
+// ==================== 训练 ====================
+
+typedef struct {
+    std::vector<float> m;
+    std::vector<float> v;
+} AdamState;
+
+static void adamStep(std::vector<float>* param, const std::vector<float>& grad, AdamState* state,
+                     float lr, float decay, int step) {
+    const float beta1 = 0.9f, beta2 = 0.999f, eps = 1e-8f;
+    float c1 = 1.0f - powf(beta1, (float)step);
+    float c2 = 1.0f - powf(beta2, (float)step);
+    for (size_t i = 0; i < param->size(); i++) {
+        state->m[i] = beta1 * state->m[i] + (1.0f - beta1) * grad[i];
+        state->v[i] = beta2 * state->v[i] + (1.0f - beta2) * grad[i] * grad[i];
+        float update = (state->m[i] / c1) / (sqrtf(state->v[i] / c2) + eps);
+        (*param)[i] -= lr * (update + decay * (*param)[i]);
+    }
+}
+
+/**
+ * @brief 小批量训练
+ *
+ * 每个样本的梯度按其类别权重加权，批内取平均；权重衰减只作用于权重 (AdamW)
+ */
+float mlpTrain(MlpModel* mlp, const std::vector<ScenarioSample>& train, const MlpTrainOptions* options) {
+    uint8_t layers = mlp->layerCount;
+    std::vector<float> gradW[CLS_MAX_LAYERS], gradB[CLS_MAX_LAYERS];
+    AdamState adamW[CLS_MAX_LAYERS], adamB[CLS_MAX_LAYERS];
+    for (uint8_t l = 0; l < layers; l++) {
+        gradW[l].resize(mlp->weights[l].size());
+        gradB[l].resize(mlp->bias[l].size());
+        adamW[l].m.assign(mlp->weights[l].size(), 0.0f);
+        adamW[l].v.assign(mlp->weights[l].size(), 0.0f);
+        adamB[l].m.assign(mlp->bias[l].size(), 0.0f);
+        adamB[l].v.assign(mlp->bias[l].size(), 0.0f);
+    }
+
+    std::vector<size_t> order(train.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    uint64_t rng = options->seed;
+    int step = 0;
+    float epochLoss = 0.0f;
+
+    for (int epoch = 0; epoch < options->epochs; epoch++) {
+        for (size_t i = order.size() - 1; i > 0; i--) {
+            std::swap(order[i], order[(size_t)(uniform(&rng) * (i + 1))]);
+        }
+        float lr = options->learningRate * 0.5f * (1.0f + cosf((float)M_PI * epoch / options->epochs));
+        double lossSum = 0.0;
+
+        for (size_t start = 0; start < order.size(); start += options->batchSize) {
+            size_t end = std::min(order.size(), start + (size_t)options->batchSize);
+            for (uint8_t l = 0; l < layers; l++) {
+                std::fill(gradW[l].begin(), gradW[l].end(), 0.0f);
+                std::fill(gradB[l].begin(), gradB[l].end(), 0.0f);
+            }
+
+            for (size_t b = start; b < end; b++) {
+                const ScenarioSample& s = train[order[b]];
+                float acts[CLS_MAX_LAYERS + 1][CLS_MAX_WIDTH];
+                forward(mlp, s.input, acts);
+                float prob[CLS_CLASS_COUNT];
+                softmax(acts[layers], prob);
+                float weight = options->classWeight[s.label];
+                lossSum += -weight * logf(fmaxf(prob[s.label], 1e-12f));
+
+                // 反向传播
+                float delta[CLS_MAX_WIDTH], prevDelta[CLS_MAX_WIDTH];
+                for (int c = 0; c < CLS_CLASS_COUNT; c++) {
+                    delta[c] = weight * (prob[c] - (c == s.label ? 1.0f : 0.0f));
+                }
+                for (int l = layers - 1; l >= 0; l--) {
+                    uint16_t in = mlp->sizes[l], out = mlp->sizes[l + 1];
+                    for (uint16_t i = 0; i < in; i++) prevDelta[i] = 0.0f;
+                    for (uint16_t o = 0; o < out; o++) {
+                        float* gw = &gradW[l][(size_t)o * in];
+                        const float* w = &mlp->weights[l][(size_t)o * in];
+                        gradB[l][o] += delta[o];
+                        for (uint16_t i = 0; i < in; i++) {
+                            gw[i] += delta[o] * acts[l][i];
+                            prevDelta[i] += delta[o] * w[i];
+                        }
+                    }
+                    for (uint16_t i = 0; i < in; i++) {
+                        delta[i] = (l > 0 && acts[l][i] <= 0.0f) ? 0.0f : prevDelta[i];
+                    }
+                }
+            }
+
+            float inv = 1.0f / (end - start);
+            step++;
+            for (uint8_t l = 0; l < layers; l++) {
+                for (float& g : gradW[l]) g *= inv;
+                for (float& g : gradB[l]) g *= inv;
+                adamStep(&mlp->weights[l], gradW[l], &adamW[l], lr, options->weightDecay, step);
+                adamStep(&mlp->bias[l], gradB[l], &adamB[l], lr, 0.0f, step);
+            }
+        }
+        epochLoss = (float)(lossSum / train.size());
+    }
+    return epochLoss;
+}
+
+// ==================== 量化 ====================
+
+typedef struct {
+    float scale;
+    int32_t zeroPoint;
+} QuantParams;
+
+// 按分位数取范围 (排除个别离群值)，范围总是包含0
+static QuantParams chooseActivation(std::vector<float>* values, bool nonNegative) {
+    std::sort(values->begin(), values->end());
+    size_t n = values->size();
+    float lo = nonNegative ? 0.0f : (*values)[(size_t)(n * 0.001)];
+    float hi = (*values)[std::min(n - 1, (size_t)(n * 0.999))];
+    lo = fminf(lo, 0.0f);
+    hi = fmaxf(hi, lo + 1e-6f);
+    hi = fmaxf(hi, 0.0f);
+
+    QuantParams q;
+    q.scale = (hi - lo) / 255.0f;
+    long zp = lroundf(-128.0f - lo / q.scale);
+    q.zeroPoint = (int32_t)std::min(127L, std::max(-128L, zp));
+    return q;
+}
+
+static void quantizeMultiplier(double real, int32_t* multiplier, int32_t* shift) {
+    if (real <= 0.0) {
+        *multiplier = 0;
+        *shift = 0;
+        return;
+    }
+    int exponent = 0;
+    double mantissa = frexp(real, &exponent);
+    int64_t q = llround(mantissa * (double)(1ll << 31));
+    if (q == (1ll << 31)) {
+        q /= 2;
+        exponent++;
+    }
+    if (exponent < -31) {
+        q = 0;
+        exponent = 0;
+    }
+    *multiplier = (int32_t)q;
+    *shift = exponent;
+}
+
+bool mlpQuantize(const MlpModel* mlp, const std::vector<ScenarioSample>& calib, MlpQuantModel* out) {
+    if (calib.empty()) return false;
+    uint8_t layers = mlp->layerCount;
+
+    // 1. 校准：收集各层输入与输出的取值
+    std::vector<float> values[CLS_MAX_LAYERS + 1];
+    for (const ScenarioSample& s : calib) {
+        float acts[CLS_MAX_LAYERS + 1][CLS_MAX_WIDTH];
+        forward(mlp, s.input, acts);
+        for (uint8_t l = 0; l <= layers; l++) {
+            values[l].insert(values[l].end(), acts[l], acts[l] + mlp->sizes[l]);
+        }
+    }
+    QuantParams act[CLS_MAX_LAYERS + 1];
+    for (uint8_t l = 0; l <= layers; l++) {
+        bool nonNegative = l > 0 && l < layers;
+        act[l] = chooseActivation(&values[l], nonNegative);
+    }
+
+    // 2. 各层权重、偏置与重新量化参数
+    memset(&out->model, 0, sizeof(ClsModel));
+    out->model.layerCount = layers;
+    memcpy(out->model.inputMean, mlp->inputMean, sizeof(mlp->inputMean));
+    memcpy(out->model.inputInvStd, mlp->inputInvStd, sizeof(mlp->inputInvStd));
+    for (uint8_t l = 0; l < layers; l++) {
+        uint16_t in = mlp->sizes[l], outSize = mlp->sizes[l + 1];
+        float maxAbs = 0.0f;
+        for (float w : mlp->weights[l]) maxAbs = fmaxf(maxAbs, fabsf(w));
+        float weightScale = maxAbs > 0.0f ? maxAbs / 127.0f : 1.0f;
+
+        out->weights[l].resize(mlp->weights[l].size());
+        for (size_t i = 0; i < mlp->weights[l].size(); i++) {
+            long q = lroundf(mlp->weights[l][i] / weightScale);
+            out->weights[l][i] = (int8_t)std::min(127L, std::max(-127L, q));
+        }
+        double biasScale = (double)act[l].scale * weightScale;
+        out->bias[l].resize(outSize);
+        for (uint16_t o = 0; o < outSize; o++) {
+            out->bias[l][o] = (int32_t)llround(mlp->bias[l][o] / biasScale);
+        }
+
+        ClsLayer* layer = &out->model.layers[l];
+        layer->inputs = in;
+        layer->outputs = outSize;
+        layer->weights = out->weights[l].data();
+        layer->bias = out->bias[l].data();
+        layer->inputScale = act[l].scale;
+        layer->inputZeroPoint = act[l].zeroPoint;
+        layer->weightScale = weightScale;
+        layer->outputScale = act[l + 1].scale;
+        layer->outputZeroPoint = act[l + 1].zeroPoint;
+        quantizeMultiplier(biasScale / act[l + 1].scale, &layer->multiplier, &layer->shift);
+        bool relu = l + 1 < layers;
+        layer->activationMin = relu ? act[l + 1].zeroPoint : -128;
+        layer->activationMax = 127;
+    }
+    return clsModelValid(&out->model);
+}
+
+// ==================== 导出 ====================
+
+// 输出可直接作为C++浮点字面量的文本
+static void formatFloat(char* buf, size_t size, float value) {
+    snprintf(buf, size, "%.9g", value);
+    if (strpbrk(buf, ".e") == NULL) strncat(buf, ".0", size - strlen(buf) - 1);
+    strncat(buf, "f", size - strlen(buf) - 1);
+}
+
+static void writeFloatArray(FILE* f, const float* values, int count) {
+    char buf[32];
+    fprintf(f, "{ ");
+    for (int i = 0; i < count; i++) {
+        formatFloat(buf, sizeof(buf), values[i]);
+        fprintf(f, "%s%s", buf, i + 1 < count ? ", " : " ");
+    }
+    fprintf(f, "}");
+}
+
+bool mlpWriteHeader(const MlpQuantModel* quant, const char* path, const char* summary) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) return false;
+    const ClsModel* model = &quant->model;
+
+    fprintf(f, "#ifndef MY_CLASSIFIER_MODEL_H\n#define MY_CLASSIFIER_MODEL_H\n\n");
+    fprintf(f, "#include \"MY_ClassifierKernels.h\"\n\n");
+    fprintf(f, "// ==================== 场景分类模型 ====================\n");
+    fprintf(f, "// 由 HOST_CODE/Classifier 的 cls_train 生成，不要手工修改\n");
+    fprintf(f, "// %s\n\n", summary);
+    fprintf(f, "#define CLS_MODEL_VERSION           %u\n\n", (unsigned)model->version);
+
+    for (uint8_t l = 0; l < model->layerCount; l++) {
+        const ClsLayer* layer = &model->layers[l];
+        fprintf(f, "static const int8_t clsModelWeights%u[%u * %u] = {", l, layer->outputs, layer->inputs);
+        for (size_t i = 0; i < (size_t)layer->outputs * layer->inputs; i++) {
+            fprintf(f, "%s%d%s", i % layer->inputs == 0 ? "\n    " : " ", layer->weights[i],
+                    i + 1 < (size_t)layer->outputs * layer->inputs ? "," : "");
+        }
+        fprintf(f, "\n};\n\n");
+        fprintf(f, "static const int32_t clsModelBias%u[%u] = {\n    ", l, layer->outputs);
+        for (uint16_t o = 0; o < layer->outputs; o++) {
+            fprintf(f, "%d%s", layer->bias[o], o + 1 < layer->outputs ? ", " : "");
+        }
+        fprintf(f, "\n};\n\n");
+    }
+
+    char a[32], b[32], c[32];
+    fprintf(f, "static const ClsModel clsDefaultModel = {\n");
+    fprintf(f, "    CLS_MODEL_VERSION,\n    %u,\n    {\n", model->layerCount);
+    for (uint8_t l = 0; l < model->layerCount; l++) {
+        const ClsLayer* layer = &model->layers[l];
+        formatFloat(a, sizeof(a), layer->inputScale);
+        formatFloat(b, sizeof(b), layer->weightScale);
+        formatFloat(c, sizeof(c), layer->outputScale);
+        fprintf(f, "        { %u, %u, clsModelWeights%u, clsModelBias%u, %s, %d, %s, %s, %d, %d, %d, %d, %d },\n",
+                layer->inputs, layer->outputs, l, l, a, layer->inputZeroPoint, b, c, layer->outputZeroPoint,
+                layer->multiplier, layer->shift, layer->activationMin, layer->activationMax);
+    }
+    fprintf(f, "    },\n    ");
+    writeFloatArray(f, model->inputMean, CLS_INPUT_COUNT);
+    fprintf(f, ",\n    ");
+    writeFloatArray(f, model->inputInvStd, CLS_INPUT_COUNT);
+    fprintf(f, ",\n};\n\n#endif\n");
+
+    bool ok = ferror(f) == 0;
+    return fclose(f) == 0 && ok;
+}
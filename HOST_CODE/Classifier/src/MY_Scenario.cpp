@@ -0,0 +1,245 @@
+#include <math.h>
+#include <string.h>
+#include "MY_Scenario.h"
+
+// ==================== 场景参数 ====================
+
+#define SCENE_TURB_TONES            3
+#define SCENE_MAX_BURSTS            8
+
+// 时间以评估时刻为0，事件从 -age 开始
+typedef struct {
+    double age;                     // 事件已持续时间 (秒)
+    // 烟雾 (浓度%)
+    double smokeBase;
+    double smokeDrift;              // %/秒
+    double smokePeak;               // 事件带来的最终增量
+    double smokeTau;                // 趋近时间常数 (秒)
+    double turbRel;                 // 湍流幅度：相对事件增量
+    double turbAbs;                 // 湍流幅度：绝对值
+    double turbFreq[SCENE_TURB_TONES];
+    double turbPhase[SCENE_TURB_TONES];
+    double smokeNoise;
+    int bursts;                     // 粉尘尖峰
+    double burstAt[SCENE_MAX_BURSTS];
+    double burstWidth[SCENE_MAX_BURSTS];
+    double burstAmp[SCENE_MAX_BURSTS];
+    double burstFreq[SCENE_MAX_BURSTS];
+    // 温度 (°C)
+    double temp0;
+    double tempRate;                // °C/分钟
+    double tempDelay;               // 事件开始后多久开始升温
+    double tempCap;                 // 最大升幅
+    double tempNoise;
+    double tempStep;                // DHT11 分辨率
+    // 湿度 (%)
+    double hum0;
+    double humRise;
+    double humTau;
+} SceneParams;
+
+// ==================== 随机数 ====================
+
+static double uniform(ScenarioGen* gen) {
+    gen->rng = gen->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ((gen->rng >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double range(ScenarioGen* gen, double lo, double hi) {
+    return lo + (hi - lo) * uniform(gen);
+}
+
+static double gaussian(ScenarioGen* gen) {
+    return sqrt(-2.0 * log(uniform(gen))) * cos(2.0 * M_PI * uniform(gen));
+}
+
+// ==================== 参数抽取 ====================
+
+static void drawBaseline(ScenarioGen* gen, SceneParams* p) {
+    memset(p, 0, sizeof(SceneParams));
+    p->age = range(gen, 5.0, 180.0);
+    p->smokeBase = range(gen, 3.0, 12.0);
+    p->smokeDrift = range(gen, -0.01, 0.01);
+    p->smokeTau = 1.0;
+    p->smokeNoise = range(gen, 0.03, 0.25);
+    p->turbAbs = range(gen, 0.0, 0.3);
+    for (int k = 0; k < SCENE_TURB_TONES; k++) {
+        p->turbFreq[k] = range(gen, 0.05, 0.3);
+        p->turbPhase[k] = range(gen, 0.0, 2.0 * M_PI);
+    }
+    p->temp0 = range(gen, 12.0, 35.0);
+    p->tempRate = range(gen, -0.5, 0.5);
+    p->tempDelay = -1000.0;         // 基线漂移覆盖整个温度窗口
+    p->tempCap = 1000.0;
+    p->tempNoise = range(gen, 0.05, 0.3);
+    p->tempStep = uniform(gen) < 0.5 ? 0.1 : 1.0;
+    p->hum0 = range(gen, 20.0, 75.0);
+    p->humTau = 30.0;
+}
+
+static void setTurbulence(ScenarioGen* gen, SceneParams* p, double rel, double loHz, double hiHz) {
+    p->turbRel = rel;
+    for (int k = 0; k < SCENE_TURB_TONES; k++) {
+        p->turbFreq[k] = range(gen, loHz, hiHz);
+    }
+}
+
+static void setHeating(ScenarioGen* gen, SceneParams* p, double delayLo, double delayHi,
+                       double rateLo, double rateHi, double cap) {
+    p->tempDelay = range(gen, delayLo, delayHi);
+    p->tempRate = range(gen, rateLo, rateHi);
+    p->tempCap = cap;
+}
+
+static void drawParams(ScenarioGen* gen, SceneKind kind, SceneParams* p) {
+    drawBaseline(gen, p);
+    switch (kind) {
+        case SCENE_CLEAN:
+            break;
+        case SCENE_DRAFT:
+            p->turbAbs = range(gen, 0.5, 3.0);
+            p->turbFreq[2] = range(gen, 0.4, 1.5);
+            p->tempRate = range(gen, -2.0, 2.0);
+            break;
+        case SCENE_SMOULDER:
+            p->smokePeak = range(gen, 20.0, 80.0);
+            p->smokeTau = range(gen, 30.0, 240.0);
+            setTurbulence(gen, p, range(gen, 0.03, 0.12), 0.5, 3.0);
+            setHeating(gen, p, 0.0, 60.0, 0.5, 6.0, 40.0);
+            p->humRise = range(gen, -6.0, 0.0);
+            break;
+        case SCENE_FLAMING:
+            p->smokePeak = range(gen, 30.0, 95.0);
+            p->smokeTau = range(gen, 10.0, 60.0);
+            setTurbulence(gen, p, range(gen, 0.05, 0.2), 1.0, 4.0);
+            setHeating(gen, p, 0.0, 20.0, 5.0, 30.0, 80.0);
+            p->humRise = range(gen, -12.0, -2.0);
+            break;
+        case SCENE_STEAM:
+            p->smokePeak = range(gen, 15.0, 60.0);
+            p->smokeTau = range(gen, 5.0, 40.0);
+            setTurbulence(gen, p, range(gen, 0.003, 0.02), 0.1, 0.5);
+            setHeating(gen, p, 0.0, 10.0, 0.0, 4.0, 10.0);
+            p->hum0 = range(gen, 30.0, 60.0);
+            p->humRise = range(gen, 15.0, 45.0);
+            p->humTau = range(gen, 10.0, 60.0);
+            break;
+        case SCENE_COOKING:
+            p->smokePeak = range(gen, 10.0, 50.0);
+            p->smokeTau = range(gen, 20.0, 120.0);
+            setTurbulence(gen, p, range(gen, 0.01, 0.05), 0.2, 1.2);
+            setHeating(gen, p, 0.0, 60.0, 0.5, 6.0, 15.0);
+            p->humRise = range(gen, 3.0, 20.0);
+            break;
+        case SCENE_DUST:
+            p->bursts = 2 + (int)(uniform(gen) * 7);
+            for (int b = 0; b < p->bursts; b++) {
+                p->burstAt[b] = range(gen, -SCENE_SMOKE_WINDOW / SCENE_SMOKE_RATE_HZ, 0.0);
+                p->burstWidth[b] = range(gen, 0.05, 0.3);
+                p->burstAmp[b] = range(gen, 5.0, 40.0);
+                p->burstFreq[b] = range(gen, 8.0, 20.0);
+            }
+            p->smokeNoise = range(gen, 0.2, 1.0);
+            break;
+        default:
+            break;
+    }
+}
+
+// ==================== 信号 ====================
+
+static double smokeAt(ScenarioGen* gen, const SceneParams* p, double t) {
+    double dt = t + p->age;
+    double event = dt > 0.0 ? p->smokePeak * (1.0 - exp(-dt / p->smokeTau)) : 0.0;
+    double v = p->smokeBase + p->smokeDrift * t + event;
+
+    double amp = (p->turbRel * event + p->turbAbs) / sqrt((double)SCENE_TURB_TONES);
+    for (int k = 0; k < SCENE_TURB_TONES; k++) {
+        v += amp * sin(2.0 * M_PI * p->turbFreq[k] * t + p->turbPhase[k]);
+    }
+    for (int b = 0; b < p->bursts; b++) {
+        double z = (t - p->burstAt[b]) / p->burstWidth[b];
+        v += p->burstAmp[b] * exp(-0.5 * z * z) * (0.6 + 0.4 * sin(2.0 * M_PI * p->burstFreq[b] * t));
+    }
+    return v + p->smokeNoise * gaussian(gen);
+}
+
+static double temperatureAt(ScenarioGen* gen, const SceneParams* p, double t) {
+    double dt = t + p->age - p->tempDelay;
+    double rise = dt > 0.0 ? fmin(p->tempRate / 60.0 * dt, p->tempCap) : 0.0;
+    double c = p->temp0 + rise + p->tempNoise * gaussian(gen);
+    return round(c / p->tempStep) * p->tempStep;
+}
+
+static double humidityNow(ScenarioGen* gen, const SceneParams* p) {
+    double h = p->hum0 + p->humRise * (1.0 - exp(-p->age / p->humTau)) + 0.5 * gaussian(gen);
+    return fmin(fmax(h, 5.0), 99.0);
+}
+
+static int16_t clampRaw(double v, double lo, double hi) {
+    return (int16_t)lround(fmin(fmax(v, lo), hi));
+}
+
+// ==================== 样本生成 ====================
+
+bool scenarioInit(ScenarioGen* gen, uint64_t seed) {
+    static const DspBand smokeBands[] = { {0.4f, 2.0f}, {2.0f, 8.0f}, {8.0f, 25.0f} };
+    static const DspBand tempBands[] = { {0.015f, 0.06f}, {0.06f, 0.25f} };
+    gen->rng = seed;
+    return dspPlanInit(&gen->smokePlan, SCENE_SMOKE_WINDOW, SCENE_SMOKE_RATE_HZ, SCENE_SMOKE_SCALE, smokeBands, 3) &&
+           dspPlanInit(&gen->tempPlan, SCENE_TEMP_WINDOW, SCENE_TEMP_RATE_HZ, SCENE_TEMP_SCALE, tempBands, 2);
+}
+
+void scenarioMake(ScenarioGen* gen, SceneKind kind, ScenarioSample* out) {
+    SceneParams p;
+    drawParams(gen, kind, &p);
+
+    int16_t smoke[SCENE_SMOKE_WINDOW];
+    for (int i = 0; i < SCENE_SMOKE_WINDOW; i++) {
+        double t = (i - SCENE_SMOKE_WINDOW) / SCENE_SMOKE_RATE_HZ;
+        smoke[i] = clampRaw(smokeAt(gen, &p, t) / SCENE_SMOKE_SCALE, 0.0, 4095.0);
+    }
+    int16_t temp[SCENE_TEMP_WINDOW];
+    for (int i = 0; i < SCENE_TEMP_WINDOW; i++) {
+        double t = (i + 1 - SCENE_TEMP_WINDOW) / SCENE_TEMP_RATE_HZ;
+        temp[i] = clampRaw(temperatureAt(gen, &p, t) / SCENE_TEMP_SCALE, -32768.0, 32767.0);
+    }
+
+    DspFeatures smokeFeatures, tempFeatures;
+    dspFeaturesQ15(&gen->smokePlan, smoke, &smokeFeatures);
+    dspFeaturesQ15(&gen->tempPlan, temp, &tempFeatures);
+
+    out->kind = kind;
+    out->label = scenarioLabel(kind);
+    clsBuildInput(&smokeFeatures, &tempFeatures, (float)humidityNow(gen, &p), out->input);
+}
+
+std::vector<ScenarioSample> scenarioMakeSet(ScenarioGen* gen, int perScene) {
+    std::vector<ScenarioSample> samples((size_t)perScene * SCENE_COUNT);
+    size_t next = 0;
+    for (int k = 0; k < SCENE_COUNT; k++) {
+        for (int i = 0; i < perScene; i++) {
+            scenarioMake(gen, (SceneKind)k, &samples[next++]);
+        }
+    }
+    return samples;
+}
+
+ClsClass scenarioLabel(SceneKind kind) {
+    switch (kind) {
+        case SCENE_SMOULDER:
+        case SCENE_FLAMING:
+            return CLS_CLASS_FIRE;
+        case SCENE_STEAM:
+        case SCENE_COOKING:
+        case SCENE_DUST:
+            return CLS_CLASS_NUISANCE;
+        default:
+            return CLS_CLASS_NORMAL;
+    }
+}
+
+const char* scenarioName(SceneKind kind) {
+    static const char* names[SCENE_COUNT] = { "clean", "draft", "smoulder", "flaming", "steam", "cooking", "dust" };
+    return kind < SCENE_COUNT ? names[kind] : "?";
+}
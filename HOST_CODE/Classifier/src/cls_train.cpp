@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "MY_Scenario.h"
+#include "MY_Mlp.h"
+#include "MY_Eval.h"
+
+/*
+ * 场景分类模型训练：
+ *   1. 用合成场景生成训练集与验证集 (验证集使用另一个随机种子)
+ *   2. 训练浮点MLP，训练集兼作量化校准集
+ *   3. 量化为int8，验证集上分别评估浮点模型与固件推理代码 (clsInfer)
+ *   4. 写出固件的 MY_ClassifierModel.h
+ */
+
+// ==================== 训练参数 ====================
+#define TRAIN_DEFAULT_PER_SCENE     2000    // 每种场景的训练样本数
+#define TRAIN_VALID_PER_SCENE       500
+#define TRAIN_VALID_SEED_OFFSET     1000
+#define TRAIN_DEFAULT_EPOCHS        60
+#define TRAIN_DEFAULT_SEED          1
+#define TRAIN_MAX_HIDDEN            (CLS_MAX_LAYERS - 1)
+// 与固件 MY_Classifier.h 的 CLS_VETO_NUISANCE_PROB 一致
+#define TRAIN_VETO_PROB             0.80f
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-o header] [-n per_scene] [-e epochs] [-H 32,16] [-s seed] [-V version]\n"
+            "  -o  output model header (default: print summary only)\n"
+            "  -n  training samples per scene (default %d)\n"
+            "  -e  epochs (default %d)\n"
+            "  -H  hidden layer widths, comma separated (default 32,16)\n"
+            "  -s  random seed (default %d)\n"
+            "  -V  model version written to the header (default 1)\n",
+            prog, TRAIN_DEFAULT_PER_SCENE, TRAIN_DEFAULT_EPOCHS, TRAIN_DEFAULT_SEED);
+}
+
+static int parseHidden(const char* text, uint16_t* hidden) {
+    int count = 0;
+    const char* p = text;
+    while (*p != '\0' && count < TRAIN_MAX_HIDDEN) {
+        char* end = NULL;
+        long width = strtol(p, &end, 10);
+        if (end == p || width <= 0 || width > CLS_MAX_WIDTH) return -1;
+        hidden[count++] = (uint16_t)width;
+        p = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return -1;
+    }
+    return *p == '\0' ? count : -1;
+}
+
+int main(int argc, char** argv) {
+    const char* output = NULL;
+    int perScene = TRAIN_DEFAULT_PER_SCENE;
+    uint16_t hidden[TRAIN_MAX_HIDDEN] = { 32, 16 };
+    int hiddenCount = 2;
+    uint64_t seed = TRAIN_DEFAULT_SEED;
+    unsigned version = 1;
+    MlpTrainOptions options = {};
+    options.epochs = TRAIN_DEFAULT_EPOCHS;
+    options.batchSize = 64;
+    options.learningRate = 3e-3f;
+    options.weightDecay = 1e-4f;
+    options.classWeight[CLS_CLASS_NORMAL] = 1.0f;
+    options.classWeight[CLS_CLASS_NUISANCE] = 1.0f;
+    options.classWeight[CLS_CLASS_FIRE] = 2.0f;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:n:e:H:s:V:")) != -1) {
+        switch (opt) {
+            case 'o': output = optarg; break;
+            case 'n': perScene = atoi(optarg); break;
+            case 'e': options.epochs = atoi(optarg); break;
+            case 'H': hiddenCount = parseHidden(optarg, hidden); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'V': version = (unsigned)atoi(optarg); break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (perScene <= 0 || options.epochs <= 0 || hiddenCount <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    options.seed = seed;
+
+    // 1. 数据
+    ScenarioGen gen;
+    if (!scenarioInit(&gen, seed)) {
+        fprintf(stderr, "[TRAIN] invalid DSP configuration\n");
+        return 1;
+    }
+    std::vector<ScenarioSample> train = scenarioMakeSet(&gen, perScene);
+    scenarioInit(&gen, seed + TRAIN_VALID_SEED_OFFSET);
+    std::vector<ScenarioSample> valid = scenarioMakeSet(&gen, TRAIN_VALID_PER_SCENE);
+
+    // 2. 训练
+    MlpModel mlp;
+    if (!mlpInit(&mlp, hidden, (uint8_t)hiddenCount, train, seed)) {
+        fprintf(stderr, "[TRAIN] invalid network shape\n");
+        return 1;
+    }
+    char shape[64];
+    int len = snprintf(shape, sizeof(shape), "%d", CLS_INPUT_COUNT);
+    for (int h = 0; h < hiddenCount; h++) len += snprintf(shape + len, sizeof(shape) - len, "-%u", hidden[h]);
+    snprintf(shape + len, sizeof(shape) - len, "-%d", CLS_CLASS_COUNT);
+    printf("[TRAIN] network %s, %zu training / %zu validation samples, %d epochs\n",
+           shape, train.size(), valid.size(), options.epochs);
+    float loss = mlpTrain(&mlp, train, &options);
+    printf("[TRAIN] final loss %.4f\n", loss);
+
+    // 3. 量化与评估
+    MlpQuantModel quant;
+    if (!mlpQuantize(&mlp, train, &quant)) {
+        fprintf(stderr, "[TRAIN] quantization failed\n");
+        return 1;
+    }
+    quant.model.version = version;
+
+    EvalStats floatStats, int8Stats;
+    evalReset(&floatStats);
+    evalReset(&int8Stats);
+    std::vector<int8_t> arena(clsArenaBytes());
+    for (const ScenarioSample& s : valid) {
+        ClsResult result;
+        mlpInfer(&mlp, s.input, &result);
+        evalAdd(&floatStats, &s, &result, TRAIN_VETO_PROB);
+        clsInfer(&quant.model, arena.data(), s.input, &result);
+        evalAdd(&int8Stats, &s, &result, TRAIN_VETO_PROB);
+    }
+    evalPrint("float", &floatStats);
+    evalPrint("int8", &int8Stats);
+
+    // 4. 导出
+    if (output != NULL) {
+        size_t bytes = clsModelDataBytes(&quant.model);
+        char summary[256];
+        snprintf(summary, sizeof(summary),
+                 "网络 %s，权重与偏置 %zu 字节；合成场景训练 %zu 个样本 (种子 %llu)，"
+                 "验证集准确率 浮点 %.1f%% / int8 %.1f%%",
+                 shape, bytes, train.size(), (unsigned long long)seed,
+                 evalAccuracy(&floatStats) * 100.0f, evalAccuracy(&int8Stats) * 100.0f);
+        if (!mlpWriteHeader(&quant, output, summary)) {
+            fprintf(stderr, "[TRAIN] cannot write %s\n", output);
+            return 1;
+        }
+        printf("[TRAIN] wrote %s (%zu bytes of weights)\n", output, bytes);
+    }
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "MY_DspKernels.h"
+
+/*
+ * 窗口特征基准：直接编译固件的 MY_DspKernels.cpp
+ *   1. 精度：浮点/定点实现与标量参考实现逐窗口比较，超出容差时退出码为1
+ *   2. 吞吐：每种实现 每窗口耗时 / 每秒样本数 / 相对参考实现的加速比
+ * 合成数据为原始整数 (ADC计数、0.01°C)，参考与浮点实现的输入为 原始值 × scale
+ */
+
+// ==================== 基准参数 ====================
+#define BENCH_DEFAULT_SECONDS       600     // 每种场景的合成时长 (秒)
+#define BENCH_DEFAULT_ROUNDS        20      // 吞吐测试遍历次数
+#define BENCH_MIN_TIME_S            0.2     // 每项吞吐测试至少运行的时间
+
+// 容差：均值/方差/斜率为相对误差，过零率为绝对值，频带能量为占窗口方差的比例
+#define TOL_F32_MOMENT              1e-3
+#define TOL_F32_BAND                1e-3
+#define TOL_Q15_MOMENT              1e-4
+#define TOL_Q15_BAND                2e-2
+#define TOL_ZCR_CROSSINGS           2       // 样本恰在均值附近时允许翻转的过零次数
+
+// ==================== 流配置 (与固件 MY_Dsp.h 一致) ====================
+
+typedef struct {
+    const char* name;
+    uint16_t n;
+    uint16_t hop;
+    float rateHz;
+    float scale;
+    DspBand bands[DSP_MAX_BANDS];
+    uint8_t bandCount;
+} StreamConfig;
+
+static const StreamConfig streams[] = {
+    { "smoke",     128, 64, 50.0f, 100.0f / 4095.0f, { {0.4f, 2.0f}, {2.0f, 8.0f}, {8.0f, 25.0f} }, 3 },
+    { "smoke-256", 256, 64, 50.0f, 100.0f / 4095.0f, { {0.4f, 2.0f}, {2.0f, 8.0f}, {8.0f, 25.0f} }, 3 },
+    { "temp",       32,  1,  0.5f, 0.01f,            { {0.015f, 0.06f}, {0.06f, 0.25f} },          2 },
+};
+
+// ==================== 合成数据 ====================
+
+static uint64_t rngState = 1;
+
+static double uniform() {
+    rngState = rngState * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ((rngState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gaussian() {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+static int16_t clampSample(double v) {
+    if (v < 0.0) return 0;
+    if (v > 32767.0) return 32767;
+    return (int16_t)lround(v);
+}
+
+/**
+ * @brief MQ-2 ADC计数：洁净空气 → 阴燃 (缓升 + 0.5~3Hz 湍流) → 水汽 (陡升陡降) → 洁净空气
+ */
+static std::vector<int16_t> makeSmokeStream(float rateHz, int seconds) {
+    std::vector<int16_t> out;
+    int count = (int)(rateHz * seconds);
+    double phase[3] = { 0.0, 1.0, 2.0 };
+    const double freq[3] = { 0.7, 1.6, 2.9 };
+    for (int i = 0; i < count; i++) {
+        double t = i / rateHz;
+        double seg = t / seconds;
+        double v = 420.0 + 2.0 * gaussian();
+        if (seg >= 0.25 && seg < 0.5) {
+            double ts = t - 0.25 * seconds;
+            v += 1.5 * ts;
+            for (int k = 0; k < 3; k++) {
+                phase[k] += 2.0 * M_PI * freq[k] / rateHz * (1.0 + 0.05 * gaussian());
+                v += (6.0 + 0.02 * ts) * sin(phase[k]);
+            }
+        } else if (seg >= 0.5 && seg < 0.75) {
+            double ts = t - 0.5 * seconds;
+            double cycle = fmod(ts, 30.0);
+            v += cycle < 4.0 ? 80.0 * cycle : 320.0 * exp(-(cycle - 4.0) / 3.0);
+            v += 8.0 * gaussian();
+        }
+        out.push_back(clampSample(v));
+    }
+    return out;
+}
+
+/**
+ * @brief 温度 (0.01°C)：室温噪声 → 缓慢升温 → 阶跃后回落
+ */
+static std::vector<int16_t> makeTempStream(float rateHz, int seconds) {
+    std::vector<int16_t> out;
+    int count = (int)(rateHz * seconds);
+    for (int i = 0; i < count; i++) {
+        double t = i / rateHz;
+        double seg = t / seconds;
+        double c = 25.0 + 0.2 * gaussian();
+        if (seg >= 0.3 && seg < 0.7) c += 0.03 * (t - 0.3 * seconds);
+        if (seg >= 0.7) c += 12.0 * exp(-(t - 0.7 * seconds) / 60.0);
+        out.push_back(clampSample(c * 100.0));
+    }
+    return out;
+}
+
+// ==================== 精度 ====================
+
+typedef struct {
+    double mean;
+    double variance;
+    double slope;
+    uint32_t zcrCrossings;
+    double band;
+} ErrorStats;
+
+static void accumulateError(const DspFeatures& ref, const DspFeatures& got, const StreamConfig& cfg,
+                            ErrorStats* err) {
+    double floorValue = 1e-9;
+    double std = sqrt(ref.variance);
+    double e = fabs(got.mean - ref.mean) / fmax(fabs(ref.mean), floorValue);
+    if (e > err->mean) err->mean = e;
+    e = fabs(got.variance - ref.variance) / fmax(ref.variance, cfg.scale * cfg.scale);
+    if (e > err->variance) err->variance = e;
+    // 斜率以 "一个窗口内变化一个标准差" 为尺度
+    e = fabs(got.slope - ref.slope) / fmax(fabs(ref.slope), fmax(std, cfg.scale) * cfg.rateHz / cfg.n);
+    if (e > err->slope) err->slope = e;
+    uint32_t crossings = (uint32_t)lround(fabs(got.zcr - ref.zcr) * (cfg.n - 1));
+    if (crossings > err->zcrCrossings) err->zcrCrossings = crossings;
+    for (uint8_t b = 0; b < cfg.bandCount; b++) {
+        e = fabs(got.bandEnergy[b] - ref.bandEnergy[b]) / fmax(ref.variance, cfg.scale * cfg.scale);
+        if (e > err->band) err->band = e;
+    }
+}
+
+static bool reportError(const char* stream, const char* impl, const ErrorStats& err,
+                        double tolMoment, double tolBand) {
+    bool ok = err.mean <= tolMoment && err.variance <= tolMoment && err.slope <= tolMoment &&
+              err.zcrCrossings <= TOL_ZCR_CROSSINGS && err.band <= tolBand;
+    printf("[BENCH] %-9s %-4s error: mean=%.1e var=%.1e slope=%.1e zcr=%u crossings band=%.1e  %s\n",
+           stream, impl, err.mean, err.variance, err.slope, err.zcrCrossings, err.band, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// ==================== 吞吐 ====================
+
+static double wallSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static volatile float sink;
+
+typedef void (*RunFn)(DspPlan* plan, const std::vector<int16_t>& raw, const std::vector<float>& phys,
+                      size_t start);
+
+static void runRef(DspPlan* plan, const std::vector<int16_t>&, const std::vector<float>& phys, size_t start) {
+    DspFeatures f;
+    dspFeaturesRef(plan, phys.data() + start, &f);
+    sink = f.variance + f.bandEnergy[0];
+}
+
+static void runF32(DspPlan* plan, const std::vector<int16_t>&, const std::vector<float>& phys, size_t start) {
+    DspFeatures f;
+    dspFeaturesF32(plan, phys.data() + start, &f);
+    sink = f.variance + f.bandEnergy[0];
+}
+
+static void runQ15(DspPlan* plan, const std::vector<int16_t>& raw, const std::vector<float>&, size_t start) {
+    DspFeatures f;
+    dspFeaturesQ15(plan, raw.data() + start, &f);
+    sink = f.variance + f.bandEnergy[0];
+}
+
+/**
+ * @brief 按窗口步进遍历整段数据，返回每窗口耗时 (纳秒)
+ */
+static double timeWindows(RunFn fn, DspPlan* plan, const std::vector<int16_t>& raw,
+                          const std::vector<float>& phys, const StreamConfig& cfg, int rounds) {
+    size_t windows = 0;
+    double start = wallSeconds();
+    double elapsed = 0.0;
+    for (int r = 0; r < rounds || elapsed < BENCH_MIN_TIME_S; r++) {
+        for (size_t s = 0; s + cfg.n <= raw.size(); s += cfg.hop) {
+            fn(plan, raw, phys, s);
+            windows++;
+        }
+        elapsed = wallSeconds() - start;
+    }
+    return elapsed * 1e9 / windows;
+}
+
+// ==================== 主程序 ====================
+
+static bool benchStream(const StreamConfig& cfg, int seconds, int rounds) {
+    static DspPlan plan;
+    if (!dspPlanInit(&plan, cfg.n, cfg.rateHz, cfg.scale, cfg.bands, cfg.bandCount)) {
+        printf("[BENCH] %s: invalid plan\n", cfg.name);
+        return false;
+    }
+
+    // 温度流样本稀疏 (0.5Hz)，按10倍时长合成
+    int streamSeconds = cfg.rateHz >= 1.0f ? seconds : seconds * 10;
+    std::vector<int16_t> raw = cfg.rateHz >= 1.0f ? makeSmokeStream(cfg.rateHz, streamSeconds)
+                                                 : makeTempStream(cfg.rateHz, streamSeconds);
+    std::vector<float> phys(raw.size());
+    for (size_t i = 0; i < raw.size(); i++) phys[i] = raw[i] * cfg.scale;
+
+    ErrorStats errF32 = {};
+    ErrorStats errQ15 = {};
+    size_t windows = 0;
+    for (size_t s = 0; s + cfg.n <= raw.size(); s += cfg.hop) {
+        DspFeatures ref, f32, q15;
+        dspFeaturesRef(&plan, phys.data() + s, &ref);
+        dspFeaturesF32(&plan, phys.data() + s, &f32);
+        dspFeaturesQ15(&plan, raw.data() + s, &q15);
+        accumulateError(ref, f32, cfg, &errF32);
+        accumulateError(ref, q15, cfg, &errQ15);
+        windows++;
+    }
+    printf("[BENCH] %s: N=%u hop=%u fs=%.2fHz bands=%u, %zu samples, %zu windows\n",
+           cfg.name, cfg.n, cfg.hop, cfg.rateHz, cfg.bandCount, raw.size(), windows);
+    bool ok = reportError(cfg.name, "f32", errF32, TOL_F32_MOMENT, TOL_F32_BAND);
+    ok = reportError(cfg.name, "q15", errQ15, TOL_Q15_MOMENT, TOL_Q15_BAND) && ok;
+
+    // 参考实现为直接DFT，单独限制遍历次数
+    double refNs = timeWindows(runRef, &plan, raw, phys, cfg, 1);
+    double f32Ns = timeWindows(runF32, &plan, raw, phys, cfg, rounds);
+    double q15Ns = timeWindows(runQ15, &plan, raw, phys, cfg, rounds);
+    const char* names[3] = { "ref", "f32", "q15" };
+    double ns[3] = { refNs, f32Ns, q15Ns };
+    for (int i = 0; i < 3; i++) {
+        printf("[BENCH] %-9s %-4s speed: %10.0f ns/window, %8.2f Msample/s, %6.1fx ref\n",
+               cfg.name, names[i], ns[i], cfg.n / ns[i] * 1e3, refNs / ns[i]);
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int seconds = BENCH_DEFAULT_SECONDS;
+    int rounds = BENCH_DEFAULT_ROUNDS;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:r:s:")) != -1) {
+        switch (opt) {
+            case 't': seconds = atoi(optarg); break;
+            case 'r': rounds = atoi(optarg); break;
+            case 's': rngState = strtoull(optarg, NULL, 10); break;
+            default:
+                printf("Usage: %s [-t seconds] [-r rounds] [-s seed]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (seconds < 10 || rounds <= 0) return 2;
+
+    printf("[BENCH] DSP features: fft=%s, %d s per stream, %d rounds\n", dspBackendString(), seconds, rounds);
+    bool ok = true;
+    for (const StreamConfig& cfg : streams) {
+        ok = benchStream(cfg, seconds, rounds) && ok;
+    }
+    printf("[BENCH] %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
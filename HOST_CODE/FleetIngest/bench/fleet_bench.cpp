@@ -0,0 +1,283 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <string>
+#include <vector>
+#include "MY_MqttWire.h"
+#include "MY_MqttSession.h"
+#include "MY_Ingest.h"
+#include "MY_JsonScan.h"
+
+/*
+ * 接入吞吐基准：
+ *   1. 解析：只解析负载 (不写存储)
+ *   2. 解析+存储：ingestMessage 完整路径
+ *   3. 端到端：本进程内的Broker替身经回环TCP推送PUBLISH，接入端走 MqttSession → ingestMessage
+ * 每项给出 消息/秒 与 消息/秒/核 (按接入线程CPU时间计算)
+ */
+
+// ==================== 基准参数 ====================
+#define BENCH_DEFAULT_DEVICES       1000
+#define BENCH_DEFAULT_MESSAGES      1000000
+#define BENCH_VARIANTS              4       // 每台设备的负载变体数 (不同读数/等级)
+#define BENCH_PAYLOAD_SIZE          2048
+
+// ==================== 计时 ====================
+
+static double wallSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double threadCpuSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ==================== 负载生成 ====================
+
+/**
+ * @brief 生成一条与固件 buildSensorDocument 字段和顺序一致的遥测
+ * variant 决定读数和火灾等级：0/1 安全，2 报警，3 灭火
+ */
+static std::string buildSamplePayload(int device, int variant) {
+    static const char* const levels[] = {"none", "none", "alarm", "suppress"};
+    float temperature = 24.0f + device % 7 + variant * 9.5f;
+    float smoke = 4.0f + device % 5 + variant * 8.0f;
+    float score = variant < 2 ? 0.05f * variant : (variant == 2 ? 0.6f : 0.88f);
+    bool alarm = variant >= 2;
+    const char* level = levels[variant];
+
+    char buf[BENCH_PAYLOAD_SIZE];
+    int len = snprintf(buf, sizeof(buf),
+        "{\"device_id\":\"esp32_fire_alarm_%05d\",\"temperature\":%.1f,\"humidity\":%.1f,"
+        "\"smoke_level\":%.1f,\"smoke_alarm\":%s,"
+        "\"fan_state\":\"%s\",\"fan_mode\":\"auto\",\"fan_speed\":%d,\"fan_purging\":false,"
+        "\"pump_state\":\"%s\",\"pump_mode\":\"auto\",\"pump_relay\":%s,\"pump_pulses_left\":%d,"
+        "\"pump_timer_late_us\":%d,\"pump_duty_used_ms\":%d,\"pump_duty_cap_ms\":60000,"
+        "\"pump_duty_budget_ms\":%d,\"pump_duty_recover_ms\":0,"
+        "\"k230_fire\":\"%s\",\"k230_fire_detected\":%s,"
+        "\"fire_score\":%.3f,\"fire_level\":\"%s\",\"fire_zone\":\"zone0\","
+        "\"fire_evidence\":{\"smoke\":%.3f,\"temp\":%.3f,\"mq2_do\":%d,\"k230\":0},"
+        "\"buzzer_state\":\"%s\",\"buzzer_mode\":\"auto\",\"buzzer_pattern\":\"%s\","
+        "\"zone_sample_us\":%d,\"zone_sample_max_us\":%d,\"zone_eval_us\":%d,\"zone_eval_max_us\":%d,"
+        "\"zones\":[{\"name\":\"zone0\",\"temperature\":%.1f,\"humidity\":%.1f,\"smoke_level\":%.1f,"
+        "\"smoke_alarm\":%s,\"fire_score\":%.3f,\"fire_level\":\"%s\",\"fan\":%s,\"valve\":%s}],"
+        "\"power_mode\":\"light_sleep\",\"power_holds\":%d,\"power_full_pct\":%d,"
+        "\"wake_smoke_us\":%d,\"wake_smoke_max_us\":%d,\"wake_k230_us\":%d,\"wake_k230_max_us\":%d,"
+        "\"deadline_misses\":%d,\"reset_reason\":\"power_on\","
+        "\"heap_free\":%d,\"heap_largest\":%d,\"heap_min_free\":%d,\"heap_frag_pct\":%d,\"heap_frag_max_pct\":%d,"
+        "\"timestamp\":%d,\"outbox_depth\":%d,\"outbox_dropped\":0,\"tx_skipped\":0,"
+        "\"mqtt_reconnects\":%d,\"wifi_connect_ms\":%d,\"mqtt_connect_ms\":%d,\"last_outage_ms\":0,"
+        "\"unit\":{\"temperature\":\"celsius\",\"humidity\":\"percent\",\"smoke_level\":\"percent\"}}",
+        device, temperature, 45.0f + variant, smoke, alarm ? "true" : "false",
+        alarm ? "on" : "off", alarm ? 100 : 0,
+        variant == 3 ? "on" : "off", variant == 3 ? "true" : "false", variant == 3 ? 3 : 0,
+        device % 300, variant * 1000, 60000 - variant * 1000,
+        variant == 3 ? "fire" : "none", variant == 3 ? "true" : "false",
+        score, level,
+        alarm ? 0.9f : 0.0f, alarm ? 0.7f : 0.0f, alarm ? 1 : 0,
+        alarm ? "on" : "off", variant == 3 ? "evacuation" : (alarm ? "smoke" : "none"),
+        31000 + device % 900, 33000, 40 + variant, 120,
+        temperature, 45.0f + variant, smoke,
+        alarm ? "true" : "false", score, level, alarm ? "true" : "false", variant == 3 ? "true" : "false",
+        alarm ? 6 : 0, 2 + variant, 1800 + device % 400, 4200, 150 + device % 50, 900,
+        device % 3, 182000 - device % 1000, 110000, 170000, 7 + variant, 19,
+        device * 1000 + variant, variant, device % 4, 2300 + device % 500, 180 + device % 40);
+
+    return std::string(buf, len > 0 && len < (int)sizeof(buf) ? len : 0);
+}
+
+// ==================== 1/2. 解析与存储 ====================
+
+static void benchParse(const std::vector<std::string>& payloads, uint64_t count) {
+    SensorParser parser;
+    SensorRecord record;
+    uint64_t ok = 0;
+    uint64_t bytes = 0;
+
+    double wall0 = wallSeconds();
+    double cpu0 = threadCpuSeconds();
+    for (uint64_t i = 0; i < count; i++) {
+        const std::string& payload = payloads[i % payloads.size()];
+        ok += parseSensorRecord(&parser, payload, &record);
+        bytes += payload.size();
+    }
+    double wall = wallSeconds() - wall0;
+    double cpu = threadCpuSeconds() - cpu0;
+
+    printf("[BENCH] parse:          %10.0f msg/s, %10.0f msg/s/core, %7.1f MB/s (%llu/%llu ok)\n",
+           count / wall, count / cpu, bytes / wall / 1e6, (unsigned long long)ok, (unsigned long long)count);
+}
+
+static void benchIngest(const std::vector<std::string>& payloads, uint64_t count, int devices) {
+    static IngestContext ctx;
+    ingestInit(&ctx, INGEST_TOPIC_SENSOR, devices, false);
+
+    double wall0 = wallSeconds();
+    double cpu0 = threadCpuSeconds();
+    for (uint64_t i = 0; i < count; i++) {
+        ingestMessage(&ctx, INGEST_TOPIC_SENSOR, payloads[i % payloads.size()]);
+    }
+    double wall = wallSeconds() - wall0;
+    double cpu = threadCpuSeconds() - cpu0;
+
+    printf("[BENCH] parse+store:    %10.0f msg/s, %10.0f msg/s/core, %zu devices, %llu level changes, %llu errors\n",
+           count / wall, count / cpu, fleetStoreDeviceCount(&ctx.store),
+           (unsigned long long)ctx.levelChanges, (unsigned long long)ctx.parseErrors);
+}
+
+// ==================== 3. 端到端 (本地Broker替身) ====================
+
+typedef struct {
+    int listenFd;
+    const std::vector<uint8_t>* stream;     // 预编码的PUBLISH报文序列
+    uint64_t streamMessages;
+    uint64_t totalMessages;
+} BrokerStandIn;
+
+static bool readPacket(int fd, std::vector<uint8_t>* rx, MqttPacket* packet) {
+    size_t len = 0;
+    for (;;) {
+        if (mqttParsePacket(rx->data(), len, packet) == MQTT_PARSE_OK) return true;
+        if (len == rx->size()) return false;
+        ssize_t n = recv(fd, rx->data() + len, rx->size() - len, 0);
+        if (n <= 0) return false;
+        len += (size_t)n;
+    }
+}
+
+/**
+ * @brief Broker替身：完成 CONNECT/SUBSCRIBE 握手后尽快推送全部消息并关闭连接
+ * 只服务一个连接，不做路由，用于排除真实Broker的开销
+ */
+static void* brokerThread(void* arg) {
+    BrokerStandIn* broker = (BrokerStandIn*)arg;
+    int fd = accept(broker->listenFd, NULL, NULL);
+    if (fd < 0) return NULL;
+
+    int sndbuf = 4 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+    std::vector<uint8_t> rx(1024);
+    uint8_t tx[16];
+    MqttPacket packet;
+    uint16_t packetId;
+    std::string_view topic;
+
+    if (readPacket(fd, &rx, &packet) && packet.type == MQTT_PKT_CONNECT) {
+        send(fd, tx, mqttEncodeConnack(tx, sizeof(tx), 0), MSG_NOSIGNAL);
+        if (readPacket(fd, &rx, &packet) && mqttParseSubscribe(&packet, &packetId, &topic)) {
+            send(fd, tx, mqttEncodeSuback(tx, sizeof(tx), packetId), MSG_NOSIGNAL);
+
+            const std::vector<uint8_t>& stream = *broker->stream;
+            for (uint64_t sent = 0; sent < broker->totalMessages; sent += broker->streamMessages) {
+                size_t off = 0;
+                while (off < stream.size()) {
+                    ssize_t n = send(fd, stream.data() + off, stream.size() - off, MSG_NOSIGNAL);
+                    if (n <= 0) break;
+                    off += (size_t)n;
+                }
+            }
+        }
+    }
+    close(fd);
+    return NULL;
+}
+
+static void benchEndToEnd(const std::vector<std::string>& payloads, uint64_t count, int devices) {
+    // 预编码一轮PUBLISH报文，Broker替身循环发送
+    std::vector<uint8_t> stream;
+    for (const std::string& payload : payloads) {
+        uint8_t buf[BENCH_PAYLOAD_SIZE + 64];
+        size_t len = mqttEncodePublish(buf, sizeof(buf), INGEST_TOPIC_SENSOR, payload);
+        stream.insert(stream.end(), buf, buf + len);
+    }
+
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 1) != 0 ||
+        getsockname(listenFd, (struct sockaddr*)&addr, &addrLen) != 0) {
+        printf("[BENCH] end-to-end:     skipped (cannot listen on loopback)\n");
+        if (listenFd >= 0) close(listenFd);
+        return;
+    }
+
+    uint64_t rounds = (count + payloads.size() - 1) / payloads.size();
+    BrokerStandIn broker = {listenFd, &stream, payloads.size(), rounds * payloads.size()};
+    pthread_t thread;
+    pthread_create(&thread, NULL, brokerThread, &broker);
+
+    static IngestContext ctx;
+    ingestInit(&ctx, INGEST_TOPIC_SENSOR, devices, false);
+    MqttSession session;
+    mqttSessionInit(&session);
+
+    bool connected = mqttSessionConnect(&session, "127.0.0.1", ntohs(addr.sin_port), "fleet_bench") &&
+                     mqttSessionSubscribe(&session, INGEST_TOPIC_SENSOR);
+
+    double wall0 = wallSeconds();
+    double cpu0 = threadCpuSeconds();
+    while (connected && mqttSessionPoll(&session, 1000, ingestMessage, &ctx)) {
+    }
+    double wall = wallSeconds() - wall0;
+    double cpu = threadCpuSeconds() - cpu0;
+
+    mqttSessionClose(&session);
+    pthread_join(thread, NULL);
+    close(listenFd);
+
+    printf("[BENCH] end-to-end:     %10.0f msg/s, %10.0f msg/s/core, %7.1f MB/s (%llu msgs, %zu devices, %llu errors)\n",
+           ctx.messages / wall, ctx.messages / cpu, session.rxBytes / wall / 1e6,
+           (unsigned long long)ctx.messages, fleetStoreDeviceCount(&ctx.store),
+           (unsigned long long)ctx.parseErrors);
+}
+
+// ==================== 入口 ====================
+
+int main(int argc, char** argv) {
+    int devices = BENCH_DEFAULT_DEVICES;
+    uint64_t messages = BENCH_DEFAULT_MESSAGES;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:n:")) != -1) {
+        switch (opt) {
+            case 'd': devices = atoi(optarg); break;
+            case 'n': messages = strtoull(optarg, NULL, 10); break;
+            default:
+                printf("Usage: %s [-d devices] [-n messages]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (devices <= 0 || messages == 0) return 1;
+
+    // 设备交错排列，同一设备的相邻消息读数/等级不同
+    std::vector<std::string> payloads;
+    size_t totalBytes = 0;
+    for (int variant = 0; variant < BENCH_VARIANTS; variant++) {
+        for (int device = 0; device < devices; device++) {
+            payloads.push_back(buildSamplePayload(device, variant));
+            totalBytes += payloads.back().size();
+        }
+    }
+
+    printf("[BENCH] JSON scan: %s, %d devices, %zu payloads, avg %zu bytes, %llu messages per run\n",
+           jsonScanImplementation(), devices, payloads.size(), totalBytes / payloads.size(),
+           (unsigned long long)messages);
+
+    benchParse(payloads, messages);
+    benchIngest(payloads, messages, devices);
+    benchEndToEnd(payloads, messages, devices);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#ifndef MY_FLEET_STORE_H
+#define MY_FLEET_STORE_H
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include "MY_SensorRecord.h"
+
+/*
+ * 机队最新状态存储 (列式)：
+ *   每台设备占一行，行号由 device_id 哈希索引得到，各字段按列分数组存放
+ *   状态字符串 (fan_state 等) 做字典编码，列中只存1字节编号
+ *   报警视图：等级不为 none 的行号集合，按行记录在集合中的位置，加入/移除都是 O(1)
+ *   单线程使用，不加锁
+ */
+
+// ==================== 配置 ====================
+#define FLEET_DICT_MAX              255     // 每个字典最多的不同字符串数 (超出记为 "?")
+#define FLEET_DICT_OVERFLOW         255
+
+// ==================== 数据结构 ====================
+
+// 透明哈希：用 string_view 查找 string 键，查找时不构造临时字符串
+struct FleetKeyHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+};
+
+// 字符串字典 (字典编码列)
+typedef struct {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint8_t, FleetKeyHash, std::equal_to<>> codes;
+} FleetDict;
+
+// 等级变化 (fleetStoreApply 的输出)
+typedef struct {
+    bool changed;
+    uint8_t previous;       // RecordFireLevel
+    uint8_t current;
+} FleetLevelChange;
+
+typedef struct {
+    // 设备索引
+    std::unordered_map<std::string, uint32_t, FleetKeyHash, std::equal_to<>> index;
+    std::vector<std::string> deviceId;
+
+    // 数值列
+    std::vector<float> temperature;
+    std::vector<float> humidity;
+    std::vector<float> smokeLevel;
+    std::vector<float> fireScore;
+    std::vector<uint8_t> smokeAlarm;
+    std::vector<uint8_t> pumpRelay;
+    std::vector<uint8_t> k230FireDetected;
+    std::vector<uint8_t> fireLevel;
+    std::vector<uint32_t> deadlineMisses;
+    std::vector<uint32_t> heapFree;
+    std::vector<uint32_t> outboxDepth;
+    std::vector<uint64_t> deviceTimestamp;      // 设备 millis()
+    std::vector<int64_t> receivedMs;            // 本机接收时间
+    std::vector<uint64_t> messages;             // 该设备累计消息数
+
+    // 字典编码列
+    std::vector<uint8_t> fanState;
+    std::vector<uint8_t> pumpState;
+    std::vector<uint8_t> buzzerState;
+    std::vector<uint8_t> fireZone;
+    std::vector<uint8_t> resetReason;
+    FleetDict fanStateDict;
+    FleetDict pumpStateDict;
+    FleetDict buzzerStateDict;
+    FleetDict fireZoneDict;
+    FleetDict resetReasonDict;
+
+    // 报警视图
+    std::vector<uint32_t> alarmRows;            // 等级不为 none 的行
+    std::vector<int32_t> alarmSlot;             // 行在 alarmRows 中的位置，-1=不在
+    uint32_t levelCount[RECORD_FIRE_LEVEL_COUNT];
+
+    // 统计
+    uint64_t applied;
+    uint64_t missingDeviceId;
+} FleetStore;
+
+// ==================== 函数声明 ====================
+
+// 初始化，expectedDevices 用于预分配
+void fleetStoreInit(FleetStore* store, size_t expectedDevices);
+
+// 写入一条记录 (只更新记录中出现的字段)，返回行号，缺少 device_id 时返回 UINT32_MAX
+uint32_t fleetStoreApply(FleetStore* store, const SensorRecord* record, int64_t nowMs, FleetLevelChange* change);
+
+// 查询
+uint32_t fleetStoreFind(const FleetStore* store, std::string_view deviceId);
+size_t fleetStoreDeviceCount(const FleetStore* store);
+const char* fleetDictName(const FleetDict* dict, uint8_t code);
+const char* getRecordFireLevelName(uint8_t level);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef MY_INGEST_H
+#define MY_INGEST_H
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include "MY_FleetStore.h"
+#include "MY_SensorRecord.h"
+
+// ==================== 配置 ====================
+#define INGEST_TOPIC_SENSOR         "fire_alarm/sensor_data"    // 与固件 MQTT_TOPIC_SENSOR 一致
+#define INGEST_REPORT_INTERVAL_S    10      // 状态打印间隔
+#define INGEST_REPORT_MAX_ALARMS    20      // 状态打印中最多列出的报警设备数
+#define INGEST_EXPECTED_DEVICES     1024    // 存储预分配行数
+
+// ==================== 数据结构 ====================
+
+// 接入上下文 (作为 MqttMessageHandler 的 context)
+typedef struct {
+    FleetStore store;
+    SensorParser parser;
+    std::string topic;              // 只处理该Topic的消息
+    bool logLevelChanges;           // 等级变化时打印 (基准测试关闭)
+    uint64_t messages;
+    uint64_t bytes;
+    uint64_t parseErrors;
+    uint64_t otherTopic;
+    uint64_t levelChanges;
+} IngestContext;
+
+// ==================== 函数声明 ====================
+
+void ingestInit(IngestContext* ctx, const char* topic, size_t expectedDevices, bool logLevelChanges);
+
+// 处理一条消息 (签名与 MqttMessageHandler 一致)
+void ingestMessage(void* context, std::string_view topic, std::string_view payload);
+
+// 打印设备数、各等级计数、吞吐与报警设备列表
+void ingestPrintReport(const IngestContext* ctx, double rateMsgPerSec);
+
+#endif
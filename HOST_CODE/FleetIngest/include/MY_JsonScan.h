@@ -0,0 +1,29 @@
+#ifndef MY_JSON_SCAN_H
+#define MY_JSON_SCAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * JSON结构字符索引 (两阶段解析的第一阶段)：
+ *   每次处理64字节，用SIMD比较一次得到引号、反斜杠和结构字符 {}[]:, 的位掩码，
+ *   引号掩码做前缀异或得到"字符串内部"掩码，去掉字符串内的结构字符后
+ *   输出所有结构字符和未转义引号的位置
+ *   第二阶段 (MY_SensorRecord) 只需按索引跳转，不再逐字节扫描
+ *
+ * x86-64 使用 SSE2 (基线指令集，无需 -march)，其他平台使用逐字节实现，结果相同
+ */
+
+// 单块字节数 (一个 uint64_t 位掩码)
+#define JSON_SCAN_BLOCK             64
+
+// ==================== 函数声明 ====================
+
+// 输出结构字符位置到 indices，容量需 >= len
+// 返回找到的数量，字符串未闭合时返回 SIZE_MAX
+size_t jsonScanStructurals(const char* data, size_t len, uint32_t* indices, size_t capacity);
+
+// 当前编译使用的实现 ("sse2" / "scalar")
+const char* jsonScanImplementation();
+
+#endif
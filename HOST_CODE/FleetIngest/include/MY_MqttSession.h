@@ -0,0 +1,54 @@
+#ifndef MY_MQTT_SESSION_H
+#define MY_MQTT_SESSION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string_view>
+#include <vector>
+
+// ==================== 会话参数 ====================
+#define MQTT_SESSION_KEEPALIVE_S    30          // 心跳间隔
+#define MQTT_SESSION_CONNECT_MS     5000        // 等待CONNACK/SUBACK的超时时间
+#define MQTT_SESSION_RX_CHUNK       65536       // 单次 recv 读取的最大字节数
+#define MQTT_SESSION_RX_MAX         (1 << 20)   // 单个报文的最大长度，超过视为异常
+
+// ==================== 数据结构 ====================
+
+// 收到一条PUBLISH时的回调 (topic/payload 仅在回调期间有效)
+typedef void (*MqttMessageHandler)(void* context, std::string_view topic, std::string_view payload);
+
+// 单个Broker连接 (阻塞Socket，调用方单线程驱动)
+typedef struct {
+    int fd;                         // -1=未连接
+    std::vector<uint8_t> rx;        // 接收缓冲区
+    size_t rxLen;                   // 缓冲区中的有效字节数
+    int64_t lastTxMs;               // 最近一次发送时间 (用于心跳)
+    uint64_t rxBytes;               // 累计接收字节数
+    uint64_t rxMessages;            // 累计收到的PUBLISH数
+} MqttSession;
+
+// ==================== 函数声明 ====================
+
+// 初始化会话结构
+void mqttSessionInit(MqttSession* session);
+
+// 连接Broker并完成 CONNECT/CONNACK，成功返回true
+bool mqttSessionConnect(MqttSession* session, const char* host, uint16_t port, const char* clientId);
+
+// 订阅单个Topic并等待SUBACK
+bool mqttSessionSubscribe(MqttSession* session, const char* topic);
+
+// 发布一条 QoS 0 消息
+bool mqttSessionPublish(MqttSession* session, std::string_view topic, std::string_view payload, bool retain = false);
+
+// 等待最多 timeoutMs 接收数据，每个完整的PUBLISH调用一次 handler
+// 需要时发送心跳，连接断开或协议错误返回false
+bool mqttSessionPoll(MqttSession* session, int timeoutMs, MqttMessageHandler handler, void* context);
+
+// 发送DISCONNECT并关闭Socket
+void mqttSessionClose(MqttSession* session);
+
+// 单调时钟 (毫秒)
+int64_t mqttSessionNowMs();
+
+#endif
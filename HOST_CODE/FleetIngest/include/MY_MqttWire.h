@@ -0,0 +1,73 @@
+#ifndef MY_MQTT_WIRE_H
+#define MY_MQTT_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string_view>
+
+/*
+ * MQTT 3.1.1 报文编解码 (只实现本项目用到的子集：QoS 0 发布/订阅)
+ *   编码函数写入调用方提供的缓冲区，返回写入字节数，空间不足返回0
+ *   解码函数不复制数据，结果指向输入缓冲区
+ */
+
+// ==================== 协议参数 ====================
+#define MQTT_WIRE_MAX_REMAINING     268435455   // 剩余长度字段最大值 (4字节变长编码)
+#define MQTT_WIRE_HEADER_MAX        5           // 固定头最大长度
+
+// ==================== 枚举定义 ====================
+
+// 报文类型 (固定头高4位)
+typedef enum {
+    MQTT_PKT_CONNECT = 1,
+    MQTT_PKT_CONNACK = 2,
+    MQTT_PKT_PUBLISH = 3,
+    MQTT_PKT_PUBACK = 4,
+    MQTT_PKT_SUBSCRIBE = 8,
+    MQTT_PKT_SUBACK = 9,
+    MQTT_PKT_PINGREQ = 12,
+    MQTT_PKT_PINGRESP = 13,
+    MQTT_PKT_DISCONNECT = 14
+} MqttPacketType;
+
+// 解码结果
+typedef enum {
+    MQTT_PARSE_OK = 0,          // 得到一个完整报文
+    MQTT_PARSE_INCOMPLETE = 1,  // 数据不足，需继续接收
+    MQTT_PARSE_MALFORMED = 2    // 格式错误，应断开连接
+} MqttParseResult;
+
+// ==================== 数据结构 ====================
+
+// 一个完整报文 (指向输入缓冲区)
+typedef struct {
+    uint8_t type;               // MqttPacketType
+    uint8_t flags;              // 固定头低4位
+    const uint8_t* body;        // 可变头 + 负载
+    size_t bodyLen;
+    size_t totalLen;            // 含固定头的总长度
+} MqttPacket;
+
+// ==================== 函数声明 ====================
+
+// 编码 (客户端)
+size_t mqttEncodeConnect(uint8_t* buf, size_t size, const char* clientId, uint16_t keepAliveS);
+// 带遗嘱的CONNECT (与固件一致：遗嘱为 retained 的 offline 消息)
+size_t mqttEncodeConnectWill(uint8_t* buf, size_t size, const char* clientId, uint16_t keepAliveS,
+                             std::string_view willTopic, std::string_view willPayload, uint8_t willQos, bool willRetain);
+size_t mqttEncodeSubscribe(uint8_t* buf, size_t size, uint16_t packetId, const char* topic);
+size_t mqttEncodePublish(uint8_t* buf, size_t size, std::string_view topic, std::string_view payload, bool retain = false);
+size_t mqttEncodePingreq(uint8_t* buf, size_t size);
+size_t mqttEncodeDisconnect(uint8_t* buf, size_t size);
+
+// 编码 (Broker端，供本地Broker替身使用)
+size_t mqttEncodeConnack(uint8_t* buf, size_t size, uint8_t returnCode);
+size_t mqttEncodeSuback(uint8_t* buf, size_t size, uint16_t packetId);
+size_t mqttEncodePingresp(uint8_t* buf, size_t size);
+
+// 解码
+MqttParseResult mqttParsePacket(const uint8_t* data, size_t len, MqttPacket* packet);
+bool mqttParsePublish(const MqttPacket* packet, std::string_view* topic, std::string_view* payload);
+bool mqttParseSubscribe(const MqttPacket* packet, uint16_t* packetId, std::string_view* topic);
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef MY_SENSOR_RECORD_H
+#define MY_SENSOR_RECORD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string_view>
+#include <vector>
+
+/*
+ * fire_alarm/sensor_data 负载解析 (字段与固件 buildSensorDocument 一致)
+ *   只提取机队视图需要的顶层字段，其余字段及嵌套的对象/数组按结构索引整体跳过
+ *   字符串字段指向原始负载，不复制也不做反转义 (固件输出的名称/状态不含转义字符)
+ *   固件中读取失败的数值序列化为 null，解析为 NaN
+ */
+
+// ==================== 枚举定义 ====================
+
+// 提取的字段
+typedef enum {
+    FIELD_DEVICE_ID = 0,
+    FIELD_TEMPERATURE,
+    FIELD_HUMIDITY,
+    FIELD_SMOKE_LEVEL,
+    FIELD_SMOKE_ALARM,
+    FIELD_FAN_STATE,
+    FIELD_PUMP_STATE,
+    FIELD_PUMP_RELAY,
+    FIELD_K230_FIRE_DETECTED,
+    FIELD_FIRE_SCORE,
+    FIELD_FIRE_LEVEL,
+    FIELD_FIRE_ZONE,
+    FIELD_BUZZER_STATE,
+    FIELD_DEADLINE_MISSES,
+    FIELD_RESET_REASON,
+    FIELD_HEAP_FREE,
+    FIELD_OUTBOX_DEPTH,
+    FIELD_TIMESTAMP,
+    FIELD_COUNT
+} SensorField;
+
+// 火灾等级 (与固件 getFireLevelName 一致)
+typedef enum {
+    RECORD_FIRE_NONE = 0,
+    RECORD_FIRE_ALARM = 1,
+    RECORD_FIRE_SUPPRESS = 2,
+    RECORD_FIRE_LEVEL_COUNT = 3
+} RecordFireLevel;
+
+// ==================== 数据结构 ====================
+
+// 一条遥测中提取出的字段
+typedef struct {
+    uint32_t present;               // 第 SensorField 位为1表示该字段出现
+    std::string_view deviceId;
+    float temperature;
+    float humidity;
+    float smokeLevel;
+    float fireScore;
+    bool smokeAlarm;
+    bool pumpRelay;
+    bool k230FireDetected;
+    uint8_t fireLevel;              // RecordFireLevel
+    std::string_view fanState;
+    std::string_view pumpState;
+    std::string_view buzzerState;
+    std::string_view fireZone;
+    std::string_view resetReason;
+    uint32_t deadlineMisses;
+    uint32_t heapFree;
+    uint32_t outboxDepth;
+    uint64_t timestamp;             // 设备 millis()
+} SensorRecord;
+
+// 解析工作区 (结构索引缓冲区，按最大负载长度复用，避免每条消息分配)
+typedef struct {
+    std::vector<uint32_t> indices;
+} SensorParser;
+
+// ==================== 函数声明 ====================
+
+// 解析一条负载，失败 (非对象、字符串未闭合、结构不匹配) 返回false
+bool parseSensorRecord(SensorParser* parser, std::string_view payload, SensorRecord* record);
+
+// 字段名 (调试输出用)
+const char* getSensorFieldName(SensorField field);
+
+static inline bool recordHas(const SensorRecord* record, SensorField field) {
+    return (record->present >> field) & 1;
+}
+
+#endif
@@ -0,0 +1,165 @@
+#include <math.h>
+#include "MY_FleetStore.h"
+
+// ==================== 字典编码 ====================
+
+static uint8_t dictEncode(FleetDict* dict, std::string_view name) {
+    auto it = dict->codes.find(name);
+    if (it != dict->codes.end()) return it->second;
+
+    if (dict->names.size() >= FLEET_DICT_MAX) return FLEET_DICT_OVERFLOW;
+    uint8_t code = (uint8_t)dict->names.size();
+    dict->names.emplace_back(name);
+    dict->codes.emplace(dict->names.back(), code);
+    return code;
+}
+
+const char* fleetDictName(const FleetDict* dict, uint8_t code) {
+    return code < dict->names.size() ? dict->names[code].c_str() : "?";
+}
+
+// ==================== 报警视图 ====================
+
+static void alarmInsert(FleetStore* store, uint32_t row) {
+    if (store->alarmSlot[row] >= 0) return;
+    store->alarmSlot[row] = (int32_t)store->alarmRows.size();
+    store->alarmRows.push_back(row);
+}
+
+/**
+ * @brief 移除：用最后一个元素填补空位
+ */
+static void alarmRemove(FleetStore* store, uint32_t row) {
+    int32_t slot = store->alarmSlot[row];
+    if (slot < 0) return;
+
+    uint32_t last = store->alarmRows.back();
+    store->alarmRows[slot] = last;
+    store->alarmSlot[last] = slot;
+    store->alarmRows.pop_back();
+    store->alarmSlot[row] = -1;
+}
+
+// ==================== 初始化 ====================
+
+void fleetStoreInit(FleetStore* store, size_t expectedDevices) {
+    *store = FleetStore{};
+    store->index.reserve(expectedDevices);
+    store->deviceId.reserve(expectedDevices);
+    store->alarmRows.reserve(expectedDevices);
+}
+
+/**
+ * @brief 为新设备追加一行，各列填默认值
+ */
+static uint32_t appendRow(FleetStore* store, std::string_view deviceId) {
+    uint32_t row = (uint32_t)store->deviceId.size();
+    store->deviceId.emplace_back(deviceId);
+    store->index.emplace(store->deviceId.back(), row);
+
+    store->temperature.push_back(NAN);
+    store->humidity.push_back(NAN);
+    store->smokeLevel.push_back(NAN);
+    store->fireScore.push_back(0.0f);
+    store->smokeAlarm.push_back(0);
+    store->pumpRelay.push_back(0);
+    store->k230FireDetected.push_back(0);
+    store->fireLevel.push_back(RECORD_FIRE_NONE);
+    store->deadlineMisses.push_back(0);
+    store->heapFree.push_back(0);
+    store->outboxDepth.push_back(0);
+    store->deviceTimestamp.push_back(0);
+    store->receivedMs.push_back(0);
+    store->messages.push_back(0);
+    store->fanState.push_back(FLEET_DICT_OVERFLOW);
+    store->pumpState.push_back(FLEET_DICT_OVERFLOW);
+    store->buzzerState.push_back(FLEET_DICT_OVERFLOW);
+    store->fireZone.push_back(FLEET_DICT_OVERFLOW);
+    store->resetReason.push_back(FLEET_DICT_OVERFLOW);
+    store->alarmSlot.push_back(-1);
+
+    store->levelCount[RECORD_FIRE_NONE]++;
+    return row;
+}
+
+// ==================== 写入 ====================
+
+/**
+ * @brief 写入一条记录
+ *
+ * 一次哈希查找定位行，之后每个字段都是直接下标写入；
+ * 等级变化时同步更新报警视图和各等级计数
+ */
+uint32_t fleetStoreApply(FleetStore* store, const SensorRecord* record, int64_t nowMs, FleetLevelChange* change) {
+    change->changed = false;
+    if (!recordHas(record, FIELD_DEVICE_ID)) {
+        store->missingDeviceId++;
+        return UINT32_MAX;
+    }
+
+    uint32_t row;
+    auto it = store->index.find(record->deviceId);
+    if (it != store->index.end()) {
+        row = it->second;
+    } else {
+        row = appendRow(store, record->deviceId);
+    }
+
+    if (recordHas(record, FIELD_TEMPERATURE)) store->temperature[row] = record->temperature;
+    if (recordHas(record, FIELD_HUMIDITY)) store->humidity[row] = record->humidity;
+    if (recordHas(record, FIELD_SMOKE_LEVEL)) store->smokeLevel[row] = record->smokeLevel;
+    if (recordHas(record, FIELD_FIRE_SCORE)) store->fireScore[row] = record->fireScore;
+    if (recordHas(record, FIELD_SMOKE_ALARM)) store->smokeAlarm[row] = record->smokeAlarm;
+    if (recordHas(record, FIELD_PUMP_RELAY)) store->pumpRelay[row] = record->pumpRelay;
+    if (recordHas(record, FIELD_K230_FIRE_DETECTED)) store->k230FireDetected[row] = record->k230FireDetected;
+    if (recordHas(record, FIELD_DEADLINE_MISSES)) store->deadlineMisses[row] = record->deadlineMisses;
+    if (recordHas(record, FIELD_HEAP_FREE)) store->heapFree[row] = record->heapFree;
+    if (recordHas(record, FIELD_OUTBOX_DEPTH)) store->outboxDepth[row] = record->outboxDepth;
+    if (recordHas(record, FIELD_TIMESTAMP)) store->deviceTimestamp[row] = record->timestamp;
+    if (recordHas(record, FIELD_FAN_STATE)) store->fanState[row] = dictEncode(&store->fanStateDict, record->fanState);
+    if (recordHas(record, FIELD_PUMP_STATE)) store->pumpState[row] = dictEncode(&store->pumpStateDict, record->pumpState);
+    if (recordHas(record, FIELD_BUZZER_STATE)) store->buzzerState[row] = dictEncode(&store->buzzerStateDict, record->buzzerState);
+    if (recordHas(record, FIELD_FIRE_ZONE)) store->fireZone[row] = dictEncode(&store->fireZoneDict, record->fireZone);
+    if (recordHas(record, FIELD_RESET_REASON)) store->resetReason[row] = dictEncode(&store->resetReasonDict, record->resetReason);
+    store->receivedMs[row] = nowMs;
+    store->messages[row]++;
+
+    if (recordHas(record, FIELD_FIRE_LEVEL) && record->fireLevel != store->fireLevel[row]) {
+        uint8_t previous = store->fireLevel[row];
+        store->levelCount[previous]--;
+        store->levelCount[record->fireLevel]++;
+        store->fireLevel[row] = record->fireLevel;
+
+        if (record->fireLevel == RECORD_FIRE_NONE) {
+            alarmRemove(store, row);
+        } else {
+            alarmInsert(store, row);
+        }
+
+        change->changed = true;
+        change->previous = previous;
+        change->current = record->fireLevel;
+    }
+
+    store->applied++;
+    return row;
+}
+
+// ==================== 查询 ====================
+
+uint32_t fleetStoreFind(const FleetStore* store, std::string_view deviceId) {
+    auto it = store->index.find(deviceId);
+    return it != store->index.end() ? it->second : UINT32_MAX;
+}
+
+size_t fleetStoreDeviceCount(const FleetStore* store) {
+    return store->deviceId.size();
+}
+
+const char* getRecordFireLevelName(uint8_t level) {
+    switch (level) {
+        case RECORD_FIRE_ALARM: return "alarm";
+        case RECORD_FIRE_SUPPRESS: return "suppress";
+        default: return "none";
+    }
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include "MY_Ingest.h"
+#include "MY_MqttSession.h"
+
+// ==================== 初始化 ====================
+
+void ingestInit(IngestContext* ctx, const char* topic, size_t expectedDevices, bool logLevelChanges) {
+    *ctx = IngestContext{};
+    fleetStoreInit(&ctx->store, expectedDevices);
+    ctx->topic = topic;
+    ctx->logLevelChanges = logLevelChanges;
+}
+
+// ==================== 消息处理 ====================
+
+/**
+ * @brief 解析一条遥测并写入存储
+ */
+void ingestMessage(void* context, std::string_view topic, std::string_view payload) {
+    IngestContext* ctx = (IngestContext*)context;
+
+    if (topic != ctx->topic) {
+        ctx->otherTopic++;
+        return;
+    }
+    ctx->messages++;
+    ctx->bytes += payload.size();
+
+    SensorRecord record;
+    if (!parseSensorRecord(&ctx->parser, payload, &record)) {
+        ctx->parseErrors++;
+        return;
+    }
+
+    FleetLevelChange change;
+    uint32_t row = fleetStoreApply(&ctx->store, &record, mqttSessionNowMs(), &change);
+    if (row == UINT32_MAX) {
+        ctx->parseErrors++;
+        return;
+    }
+
+    if (change.changed) {
+        ctx->levelChanges++;
+        if (ctx->logLevelChanges) {
+            printf("[ALARM] %s: %s -> %s, zone=%s, score=%.2f\n",
+                   ctx->store.deviceId[row].c_str(),
+                   getRecordFireLevelName(change.previous), getRecordFireLevelName(change.current),
+                   fleetDictName(&ctx->store.fireZoneDict, ctx->store.fireZone[row]),
+                   ctx->store.fireScore[row]);
+        }
+    }
+}
+
+// ==================== 状态打印 ====================
+
+void ingestPrintReport(const IngestContext* ctx, double rateMsgPerSec) {
+    const FleetStore* store = &ctx->store;
+    int64_t now = mqttSessionNowMs();
+
+    printf("\n========== Fleet Status ==========\n");
+    printf("Devices: %zu (none %u, alarm %u, suppress %u)\n", fleetStoreDeviceCount(store),
+           store->levelCount[RECORD_FIRE_NONE], store->levelCount[RECORD_FIRE_ALARM],
+           store->levelCount[RECORD_FIRE_SUPPRESS]);
+    printf("Messages: %llu (%.0f msg/s), %llu bytes, parse errors %llu, other topic %llu\n",
+           (unsigned long long)ctx->messages, rateMsgPerSec, (unsigned long long)ctx->bytes,
+           (unsigned long long)ctx->parseErrors, (unsigned long long)ctx->otherTopic);
+
+    size_t shown = 0;
+    for (uint32_t row : store->alarmRows) {
+        if (shown++ >= INGEST_REPORT_MAX_ALARMS) {
+            printf("  ... %zu more\n", store->alarmRows.size() - INGEST_REPORT_MAX_ALARMS);
+            break;
+        }
+        printf("  %-24s %-8s zone=%-10s score=%.2f temp=%.1f smoke=%.1f pump=%s relay=%d age=%llds\n",
+               store->deviceId[row].c_str(), getRecordFireLevelName(store->fireLevel[row]),
+               fleetDictName(&store->fireZoneDict, store->fireZone[row]), store->fireScore[row],
+               store->temperature[row], store->smokeLevel[row],
+               fleetDictName(&store->pumpStateDict, store->pumpState[row]), store->pumpRelay[row],
+               (long long)((now - store->receivedMs[row]) / 1000));
+    }
+    printf("==================================\n");
+    fflush(stdout);
+}
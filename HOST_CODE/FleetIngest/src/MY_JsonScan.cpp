@@ -0,0 +1,161 @@
+#include <string.h>
+#include "MY_JsonScan.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ==================== 块内掩码 ====================
+
+// 一个64字节块的字符分类
+typedef struct {
+    uint64_t quote;         // "
+    uint64_t backslash;     // \ .
+    uint64_t structural;    // { } [ ] : ,
+} BlockMasks;
+
+#if defined(__SSE2__)
+
+static inline uint64_t movemask(__m128i v0, __m128i v1, __m128i v2, __m128i v3) {
+    return (uint64_t)(uint16_t)_mm_movemask_epi8(v0) |
+           ((uint64_t)(uint16_t)_mm_movemask_epi8(v1) << 16) |
+           ((uint64_t)(uint16_t)_mm_movemask_epi8(v2) << 32) |
+           ((uint64_t)(uint16_t)_mm_movemask_epi8(v3) << 48);
+}
+
+static inline __m128i structuralLane(__m128i v) {
+    // { } [ ] : , 六个字符逐一比较后合并
+    __m128i r = _mm_cmpeq_epi8(v, _mm_set1_epi8('{'));
+    r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8('}')));
+    r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8('[')));
+    r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8(']')));
+    r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+    r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+    return r;
+}
+
+static inline BlockMasks classifyBlock(const char* p) {
+    __m128i v0 = _mm_loadu_si128((const __m128i*)(p + 0));
+    __m128i v1 = _mm_loadu_si128((const __m128i*)(p + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i*)(p + 32));
+    __m128i v3 = _mm_loadu_si128((const __m128i*)(p + 48));
+
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    BlockMasks masks;
+    masks.quote = movemask(_mm_cmpeq_epi8(v0, quote), _mm_cmpeq_epi8(v1, quote),
+                           _mm_cmpeq_epi8(v2, quote), _mm_cmpeq_epi8(v3, quote));
+    masks.backslash = movemask(_mm_cmpeq_epi8(v0, backslash), _mm_cmpeq_epi8(v1, backslash),
+                               _mm_cmpeq_epi8(v2, backslash), _mm_cmpeq_epi8(v3, backslash));
+    masks.structural = movemask(structuralLane(v0), structuralLane(v1), structuralLane(v2), structuralLane(v3));
+    return masks;
+}
+
+const char* jsonScanImplementation() {
+    return "sse2";
+}
+
+#else
+
+static inline BlockMasks classifyBlock(const char* p) {
+    BlockMasks masks = {0, 0, 0};
+    for (int i = 0; i < JSON_SCAN_BLOCK; i++) {
+        uint64_t bit = 1ULL << i;
+        switch (p[i]) {
+            case '"': masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                masks.structural |= bit;
+                break;
+            default: break;
+        }
+    }
+    return masks;
+}
+
+const char* jsonScanImplementation() {
+    return "scalar";
+}
+
+#endif
+
+// ==================== 掩码运算 ====================
+
+/**
+ * @brief 前缀异或：第i位 = 第0..i位的异或
+ * 对引号掩码求前缀异或，得到从开引号 (含) 到闭引号 (不含) 的字符串内部掩码
+ */
+static inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/**
+ * @brief 计算被反斜杠转义的字符
+ * 遥测负载中几乎不出现反斜杠，有反斜杠的块才逐位处理
+ */
+static inline uint64_t escapedMask(uint64_t backslash, bool* carry) {
+    if (backslash == 0 && !*carry) return 0;
+
+    uint64_t escaped = 0;
+    bool escape = *carry;
+    for (int i = 0; i < JSON_SCAN_BLOCK; i++) {
+        if (escape) {
+            escaped |= 1ULL << i;
+            escape = false;
+        } else if (backslash & (1ULL << i)) {
+            escape = true;
+        }
+    }
+    *carry = escape;
+    return escaped;
+}
+
+static inline size_t flattenBits(uint64_t bits, uint32_t base, uint32_t* out, size_t count) {
+    while (bits != 0) {
+        out[count++] = base + (uint32_t)__builtin_ctzll(bits);
+        bits &= bits - 1;
+    }
+    return count;
+}
+
+// ==================== 扫描 ====================
+
+/**
+ * @brief 扫描结构字符
+ *
+ * 跨块状态只有两位：上一块结尾是否在字符串内、是否有待转义的反斜杠
+ */
+size_t jsonScanStructurals(const char* data, size_t len, uint32_t* indices, size_t capacity) {
+    if (capacity < len) return SIZE_MAX;
+
+    uint64_t inStringCarry = 0;     // 全1表示上一块结尾处于字符串内
+    bool escapeCarry = false;
+    size_t count = 0;
+
+    char tail[JSON_SCAN_BLOCK];
+    for (size_t base = 0; base < len; base += JSON_SCAN_BLOCK) {
+        const char* block = data + base;
+        if (len - base < JSON_SCAN_BLOCK) {
+            // 最后不足64字节的部分用空格补齐
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, len - base);
+            block = tail;
+        }
+
+        BlockMasks masks = classifyBlock(block);
+        uint64_t quote = masks.quote & ~escapedMask(masks.backslash, &escapeCarry);
+        uint64_t inString = prefixXor(quote) ^ inStringCarry;
+        inStringCarry = (uint64_t)((int64_t)inString >> 63);
+
+        count = flattenBits((masks.structural & ~inString) | quote, (uint32_t)base, indices, count);
+    }
+
+    return inStringCarry != 0 ? SIZE_MAX : count;
+}
@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "MY_MqttSession.h"
+#include "MY_MqttWire.h"
+
+// ==================== 内部函数 ====================
+
+int64_t mqttSessionNowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static bool sendAll(MqttSession* session, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(session->fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    session->lastTxMs = mqttSessionNowMs();
+    return true;
+}
+
+/**
+ * @brief 接收一次数据追加到接收缓冲区
+ * @return 1=收到数据, 0=超时, -1=连接断开或出错
+ */
+static int receiveChunk(MqttSession* session, int timeoutMs) {
+    struct pollfd pfd = {session->fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready == 0) return 0;
+    if (ready < 0) return errno == EINTR ? 0 : -1;
+
+    // 保证至少有一个读取块的空间，单个报文超过上限时视为异常
+    if (session->rx.size() - session->rxLen < MQTT_SESSION_RX_CHUNK) {
+        if (session->rx.size() >= MQTT_SESSION_RX_MAX + MQTT_SESSION_RX_CHUNK) return -1;
+        session->rx.resize(session->rx.size() * 2);
+    }
+
+    ssize_t n = recv(session->fd, session->rx.data() + session->rxLen, MQTT_SESSION_RX_CHUNK, 0);
+    if (n < 0) return errno == EINTR ? 0 : -1;
+    if (n == 0) return -1;
+
+    session->rxLen += (size_t)n;
+    session->rxBytes += (uint64_t)n;
+    return 1;
+}
+
+/**
+ * @brief 丢弃缓冲区头部已处理的字节
+ */
+static void consume(MqttSession* session, size_t len) {
+    session->rxLen -= len;
+    if (session->rxLen > 0) {
+        memmove(session->rx.data(), session->rx.data() + len, session->rxLen);
+    }
+}
+
+/**
+ * @brief 等待指定类型的报文 (握手阶段使用，只消耗到该报文为止)
+ */
+static bool waitForPacket(MqttSession* session, uint8_t type, MqttPacket* out, std::vector<uint8_t>* body) {
+    int64_t deadline = mqttSessionNowMs() + MQTT_SESSION_CONNECT_MS;
+    for (;;) {
+        MqttPacket packet;
+        MqttParseResult result = mqttParsePacket(session->rx.data(), session->rxLen, &packet);
+        if (result == MQTT_PARSE_MALFORMED) return false;
+        if (result == MQTT_PARSE_OK) {
+            bool match = packet.type == type;
+            if (match) {
+                *out = packet;
+                body->assign(packet.body, packet.body + packet.bodyLen);
+                out->body = body->data();
+            }
+            consume(session, packet.totalLen);
+            if (match) return true;
+            continue;
+        }
+
+        int64_t left = deadline - mqttSessionNowMs();
+        if (left <= 0 || receiveChunk(session, (int)left) < 0) return false;
+    }
+}
+
+// ==================== 连接管理 ====================
+
+void mqttSessionInit(MqttSession* session) {
+    session->fd = -1;
+    session->rx.assign(MQTT_SESSION_RX_CHUNK * 2, 0);
+    session->rxLen = 0;
+    session->lastTxMs = 0;
+    session->rxBytes = 0;
+    session->rxMessages = 0;
+}
+
+/**
+ * @brief 连接Broker并完成握手
+ */
+bool mqttSessionConnect(MqttSession* session, const char* host, uint16_t port, const char* clientId) {
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* list = NULL;
+    if (getaddrinfo(host, portStr, &hints, &list) != 0) {
+        fprintf(stderr, "[MQTT] Cannot resolve %s\n", host);
+        return false;
+    }
+
+    int fd = -1;
+    for (struct addrinfo* ai = list; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(list);
+    if (fd < 0) {
+        fprintf(stderr, "[MQTT] Connect to %s:%u failed: %s\n", host, port, strerror(errno));
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    int rcvbuf = 4 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    session->fd = fd;
+    session->rxLen = 0;
+
+    uint8_t buf[512];
+    size_t len = mqttEncodeConnect(buf, sizeof(buf), clientId, MQTT_SESSION_KEEPALIVE_S);
+    MqttPacket connack;
+    std::vector<uint8_t> body;
+    if (len == 0 || !sendAll(session, buf, len) || !waitForPacket(session, MQTT_PKT_CONNACK, &connack, &body) ||
+        connack.bodyLen < 2 || connack.body[1] != 0) {
+        fprintf(stderr, "[MQTT] Broker rejected connection\n");
+        mqttSessionClose(session);
+        return false;
+    }
+    return true;
+}
+
+bool mqttSessionSubscribe(MqttSession* session, const char* topic) {
+    static uint16_t packetId = 0;
+    packetId = (uint16_t)(packetId % 0xFFFF + 1);
+
+    uint8_t buf[512];
+    size_t len = mqttEncodeSubscribe(buf, sizeof(buf), packetId, topic);
+    MqttPacket suback;
+    std::vector<uint8_t> body;
+    if (len == 0 || !sendAll(session, buf, len) || !waitForPacket(session, MQTT_PKT_SUBACK, &suback, &body) ||
+        suback.bodyLen < 3 || suback.body[2] == 0x80) {
+        fprintf(stderr, "[MQTT] Subscribe to %s failed\n", topic);
+        return false;
+    }
+    return true;
+}
+
+bool mqttSessionPublish(MqttSession* session, std::string_view topic, std::string_view payload, bool retain) {
+    if (session->fd < 0) return false;
+
+    std::vector<uint8_t> buf(topic.size() + payload.size() + MQTT_WIRE_HEADER_MAX + 2);
+    size_t len = mqttEncodePublish(buf.data(), buf.size(), topic, payload, retain);
+    return len > 0 && sendAll(session, buf.data(), len);
+}
+
+void mqttSessionClose(MqttSession* session) {
+    if (session->fd < 0) return;
+
+    uint8_t buf[2];
+    size_t len = mqttEncodeDisconnect(buf, sizeof(buf));
+    send(session->fd, buf, len, MSG_NOSIGNAL);
+    close(session->fd);
+    session->fd = -1;
+    session->rxLen = 0;
+}
+
+// ==================== 接收 ====================
+
+/**
+ * @brief 接收并分发消息
+ *
+ * 一次 recv 可能包含多个报文，全部处理后只移动一次剩余数据
+ */
+bool mqttSessionPoll(MqttSession* session, int timeoutMs, MqttMessageHandler handler, void* context) {
+    if (session->fd < 0) return false;
+
+    // 心跳：空闲超过一半的心跳间隔时发送PINGREQ
+    if (mqttSessionNowMs() - session->lastTxMs >= MQTT_SESSION_KEEPALIVE_S * 1000 / 2) {
+        uint8_t ping[2];
+        if (!sendAll(session, ping, mqttEncodePingreq(ping, sizeof(ping)))) return false;
+    }
+
+    int received = receiveChunk(session, timeoutMs);
+    if (received < 0) return false;
+    if (received == 0) return true;
+
+    size_t pos = 0;
+    for (;;) {
+        MqttPacket packet;
+        MqttParseResult result = mqttParsePacket(session->rx.data() + pos, session->rxLen - pos, &packet);
+        if (result == MQTT_PARSE_MALFORMED) return false;
+        if (result == MQTT_PARSE_INCOMPLETE) break;
+
+        if (packet.type == MQTT_PKT_PUBLISH) {
+            std::string_view topic, payload;
+            if (mqttParsePublish(&packet, &topic, &payload)) {
+                session->rxMessages++;
+                handler(context, topic, payload);
+            }
+        }
+        pos += packet.totalLen;
+    }
+    consume(session, pos);
+    return true;
+}
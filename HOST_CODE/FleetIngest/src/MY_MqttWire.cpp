@@ -0,0 +1,222 @@
+#include <string.h>
+#include "MY_MqttWire.h"
+
+// ==================== 内部函数 ====================
+
+/**
+ * @brief 写入固定头 (类型/标志 + 变长剩余长度)
+ * @return 固定头长度，空间不足返回0
+ */
+static size_t writeFixedHeader(uint8_t* buf, size_t size, uint8_t type, uint8_t flags, size_t remaining) {
+    if (remaining > MQTT_WIRE_MAX_REMAINING || size < 1) return 0;
+
+    size_t pos = 0;
+    buf[pos++] = (uint8_t)((type << 4) | (flags & 0x0F));
+    do {
+        if (pos >= size) return 0;
+        uint8_t digit = remaining % 128;
+        remaining /= 128;
+        if (remaining > 0) digit |= 0x80;
+        buf[pos++] = digit;
+    } while (remaining > 0);
+    return pos;
+}
+
+static size_t headerLength(size_t remaining) {
+    size_t len = 2;
+    while (remaining >= 128) {
+        remaining /= 128;
+        len++;
+    }
+    return len;
+}
+
+static void writeU16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)(value & 0xFF);
+}
+
+static uint16_t readU16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief 写入 2字节长度 + 字符串
+ */
+static uint8_t* writeString(uint8_t* p, std::string_view str) {
+    writeU16(p, (uint16_t)str.size());
+    memcpy(p + 2, str.data(), str.size());
+    return p + 2 + str.size();
+}
+
+// ==================== 客户端报文 ====================
+
+/**
+ * @brief CONNECT：Clean Session，无用户名/密码/遗嘱
+ */
+size_t mqttEncodeConnect(uint8_t* buf, size_t size, const char* clientId, uint16_t keepAliveS) {
+    return mqttEncodeConnectWill(buf, size, clientId, keepAliveS, std::string_view(), std::string_view(), 0, false);
+}
+
+/**
+ * @brief CONNECT：Clean Session，willTopic 为空时不带遗嘱
+ */
+size_t mqttEncodeConnectWill(uint8_t* buf, size_t size, const char* clientId, uint16_t keepAliveS,
+                             std::string_view willTopic, std::string_view willPayload, uint8_t willQos, bool willRetain) {
+    std::string_view id(clientId);
+    bool will = !willTopic.empty();
+    if (id.size() > 0xFFFF || willTopic.size() > 0xFFFF || willPayload.size() > 0xFFFF || willQos > 2) return 0;
+
+    size_t remaining = 10 + 2 + id.size();
+    if (will) remaining += 2 + willTopic.size() + 2 + willPayload.size();
+    size_t total = headerLength(remaining) + remaining;
+    if (total > size) return 0;
+
+    uint8_t flags = 0x02;                       // Clean Session
+    if (will) {
+        flags |= 0x04 | (uint8_t)(willQos << 3);
+        if (willRetain) flags |= 0x20;
+    }
+
+    uint8_t* p = buf + writeFixedHeader(buf, size, MQTT_PKT_CONNECT, 0, remaining);
+    p = writeString(p, "MQTT");
+    *p++ = 4;           // 协议级别 3.1.1
+    *p++ = flags;
+    writeU16(p, keepAliveS);
+    p += 2;
+    p = writeString(p, id);
+    if (will) {
+        p = writeString(p, willTopic);
+        writeString(p, willPayload);
+    }
+    return total;
+}
+
+/**
+ * @brief SUBSCRIBE：单个Topic，QoS 0
+ */
+size_t mqttEncodeSubscribe(uint8_t* buf, size_t size, uint16_t packetId, const char* topic) {
+    std::string_view filter(topic);
+    if (filter.size() > 0xFFFF) return 0;
+
+    size_t remaining = 2 + 2 + filter.size() + 1;
+    size_t total = headerLength(remaining) + remaining;
+    if (total > size) return 0;
+
+    // SUBSCRIBE 固定头标志位必须为 0010
+    uint8_t* p = buf + writeFixedHeader(buf, size, MQTT_PKT_SUBSCRIBE, 0x02, remaining);
+    writeU16(p, packetId);
+    p = writeString(p + 2, filter);
+    *p = 0;             // 请求QoS 0
+    return total;
+}
+
+/**
+ * @brief PUBLISH：QoS 0
+ * @param retain 是否要求Broker保留 (上线状态、配置状态)
+ */
+size_t mqttEncodePublish(uint8_t* buf, size_t size, std::string_view topic, std::string_view payload, bool retain) {
+    if (topic.size() > 0xFFFF) return 0;
+
+    size_t remaining = 2 + topic.size() + payload.size();
+    size_t total = headerLength(remaining) + remaining;
+    if (remaining > MQTT_WIRE_MAX_REMAINING || total > size) return 0;
+
+    uint8_t* p = buf + writeFixedHeader(buf, size, MQTT_PKT_PUBLISH, retain ? 0x01 : 0, remaining);
+    p = writeString(p, topic);
+    memcpy(p, payload.data(), payload.size());
+    return total;
+}
+
+size_t mqttEncodePingreq(uint8_t* buf, size_t size) {
+    return writeFixedHeader(buf, size, MQTT_PKT_PINGREQ, 0, 0);
+}
+
+size_t mqttEncodeDisconnect(uint8_t* buf, size_t size) {
+    return writeFixedHeader(buf, size, MQTT_PKT_DISCONNECT, 0, 0);
+}
+
+// ==================== Broker端报文 ====================
+
+size_t mqttEncodeConnack(uint8_t* buf, size_t size, uint8_t returnCode) {
+    if (size < 4) return 0;
+    size_t pos = writeFixedHeader(buf, size, MQTT_PKT_CONNACK, 0, 2);
+    buf[pos++] = 0;     // 无会话
+    buf[pos++] = returnCode;
+    return pos;
+}
+
+size_t mqttEncodeSuback(uint8_t* buf, size_t size, uint16_t packetId) {
+    if (size < 5) return 0;
+    size_t pos = writeFixedHeader(buf, size, MQTT_PKT_SUBACK, 0, 3);
+    writeU16(buf + pos, packetId);
+    buf[pos + 2] = 0;   // 授予QoS 0
+    return pos + 3;
+}
+
+size_t mqttEncodePingresp(uint8_t* buf, size_t size) {
+    return writeFixedHeader(buf, size, MQTT_PKT_PINGRESP, 0, 0);
+}
+
+// ==================== 解码 ====================
+
+/**
+ * @brief 从接收缓冲区头部取出一个完整报文
+ * @param data 接收缓冲区
+ * @param len 缓冲区中的有效字节数
+ * @param packet 输出，指向 data 内部
+ */
+MqttParseResult mqttParsePacket(const uint8_t* data, size_t len, MqttPacket* packet) {
+    if (len < 2) return MQTT_PARSE_INCOMPLETE;
+
+    size_t remaining = 0;
+    size_t multiplier = 1;
+    size_t pos = 1;
+    for (;;) {
+        if (pos >= len) return MQTT_PARSE_INCOMPLETE;
+        if (pos > 4) return MQTT_PARSE_MALFORMED;
+        uint8_t digit = data[pos++];
+        remaining += (digit & 0x7F) * multiplier;
+        if ((digit & 0x80) == 0) break;
+        multiplier *= 128;
+    }
+    if (len - pos < remaining) return MQTT_PARSE_INCOMPLETE;
+
+    packet->type = data[0] >> 4;
+    packet->flags = data[0] & 0x0F;
+    packet->body = data + pos;
+    packet->bodyLen = remaining;
+    packet->totalLen = pos + remaining;
+    return MQTT_PARSE_OK;
+}
+
+/**
+ * @brief 解析PUBLISH报文的Topic与负载 (支持QoS 1/2的报文ID字段)
+ */
+bool mqttParsePublish(const MqttPacket* packet, std::string_view* topic, std::string_view* payload) {
+    if (packet->type != MQTT_PKT_PUBLISH || packet->bodyLen < 2) return false;
+
+    size_t topicLen = readU16(packet->body);
+    size_t pos = 2 + topicLen;
+    uint8_t qos = (packet->flags >> 1) & 0x03;
+    if (qos > 0) pos += 2;
+    if (qos > 2 || pos > packet->bodyLen) return false;
+
+    *topic = std::string_view((const char*)packet->body + 2, topicLen);
+    *payload = std::string_view((const char*)packet->body + pos, packet->bodyLen - pos);
+    return true;
+}
+
+/**
+ * @brief 解析SUBSCRIBE报文的报文ID与第一个Topic
+ */
+bool mqttParseSubscribe(const MqttPacket* packet, uint16_t* packetId, std::string_view* topic) {
+    if (packet->type != MQTT_PKT_SUBSCRIBE || packet->bodyLen < 5) return false;
+
+    size_t topicLen = readU16(packet->body + 2);
+    if (4 + topicLen + 1 > packet->bodyLen) return false;
+
+    *packetId = readU16(packet->body);
+    *topic = std::string_view((const char*)packet->body + 4, topicLen);
+    return true;
+}
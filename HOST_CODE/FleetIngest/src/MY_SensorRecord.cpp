@@ -0,0 +1,237 @@
+#include <string.h>
+#include <math.h>
+#include <charconv>
+#include "MY_SensorRecord.h"
+#include "MY_JsonScan.h"
+
+// ==================== 字段名查找表 ====================
+// 开放寻址哈希表，启动时构建一次，每个键只需一次哈希和一次比较
+
+#define FIELD_TABLE_SIZE            64      // 2的幂，远大于字段数，几乎无冲突
+
+static const char* const fieldNames[FIELD_COUNT] = {
+    "device_id", "temperature", "humidity", "smoke_level", "smoke_alarm",
+    "fan_state", "pump_state", "pump_relay", "k230_fire_detected",
+    "fire_score", "fire_level", "fire_zone", "buzzer_state",
+    "deadline_misses", "reset_reason", "heap_free", "outbox_depth", "timestamp"
+};
+
+static int8_t fieldTable[FIELD_TABLE_SIZE];
+
+static inline uint32_t hashKey(std::string_view key) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (char c : key) {
+        h = (h ^ (uint8_t)c) * 16777619u;
+    }
+    return h;
+}
+
+static bool buildFieldTable() {
+    memset(fieldTable, -1, sizeof(fieldTable));
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        uint32_t slot = hashKey(fieldNames[f]) & (FIELD_TABLE_SIZE - 1);
+        while (fieldTable[slot] >= 0) {
+            slot = (slot + 1) & (FIELD_TABLE_SIZE - 1);
+        }
+        fieldTable[slot] = (int8_t)f;
+    }
+    return true;
+}
+
+static const bool fieldTableReady = buildFieldTable();
+
+static int lookupField(std::string_view key) {
+    uint32_t slot = hashKey(key) & (FIELD_TABLE_SIZE - 1);
+    while (fieldTable[slot] >= 0) {
+        if (key == fieldNames[fieldTable[slot]]) return fieldTable[slot];
+        slot = (slot + 1) & (FIELD_TABLE_SIZE - 1);
+    }
+    return -1;
+}
+
+const char* getSensorFieldName(SensorField field) {
+    return field < FIELD_COUNT ? fieldNames[field] : "unknown";
+}
+
+// ==================== 值解析 ====================
+
+static inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool parseFloat(std::string_view text, float* value) {
+    if (text == "null") {
+        *value = NAN;
+        return true;
+    }
+    auto result = std::from_chars(text.data(), text.data() + text.size(), *value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+template <typename T>
+static bool parseUnsigned(std::string_view text, T* value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), *value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+static bool parseBool(std::string_view text, bool* value) {
+    if (text == "true") {
+        *value = true;
+        return true;
+    }
+    if (text == "false") {
+        *value = false;
+        return true;
+    }
+    return false;
+}
+
+static bool parseFireLevel(std::string_view text, uint8_t* level) {
+    if (text == "none") *level = RECORD_FIRE_NONE;
+    else if (text == "alarm") *level = RECORD_FIRE_ALARM;
+    else if (text == "suppress") *level = RECORD_FIRE_SUPPRESS;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief 把一个值写入记录
+ * @param isString 值是否为字符串 (类型不符的字段忽略)
+ */
+static void storeField(SensorRecord* record, int field, std::string_view text, bool isString) {
+    bool ok = false;
+    switch (field) {
+        case FIELD_DEVICE_ID:
+            if (isString) { record->deviceId = text; ok = true; }
+            break;
+        case FIELD_FAN_STATE:
+            if (isString) { record->fanState = text; ok = true; }
+            break;
+        case FIELD_PUMP_STATE:
+            if (isString) { record->pumpState = text; ok = true; }
+            break;
+        case FIELD_BUZZER_STATE:
+            if (isString) { record->buzzerState = text; ok = true; }
+            break;
+        case FIELD_FIRE_ZONE:
+            if (isString) { record->fireZone = text; ok = true; }
+            break;
+        case FIELD_RESET_REASON:
+            if (isString) { record->resetReason = text; ok = true; }
+            break;
+        case FIELD_FIRE_LEVEL:
+            ok = isString && parseFireLevel(text, &record->fireLevel);
+            break;
+        case FIELD_TEMPERATURE:
+            ok = !isString && parseFloat(text, &record->temperature);
+            break;
+        case FIELD_HUMIDITY:
+            ok = !isString && parseFloat(text, &record->humidity);
+            break;
+        case FIELD_SMOKE_LEVEL:
+            ok = !isString && parseFloat(text, &record->smokeLevel);
+            break;
+        case FIELD_FIRE_SCORE:
+            ok = !isString && parseFloat(text, &record->fireScore);
+            break;
+        case FIELD_SMOKE_ALARM:
+            ok = !isString && parseBool(text, &record->smokeAlarm);
+            break;
+        case FIELD_PUMP_RELAY:
+            ok = !isString && parseBool(text, &record->pumpRelay);
+            break;
+        case FIELD_K230_FIRE_DETECTED:
+            ok = !isString && parseBool(text, &record->k230FireDetected);
+            break;
+        case FIELD_DEADLINE_MISSES:
+            ok = !isString && parseUnsigned(text, &record->deadlineMisses);
+            break;
+        case FIELD_HEAP_FREE:
+            ok = !isString && parseUnsigned(text, &record->heapFree);
+            break;
+        case FIELD_OUTBOX_DEPTH:
+            ok = !isString && parseUnsigned(text, &record->outboxDepth);
+            break;
+        case FIELD_TIMESTAMP:
+            ok = !isString && parseUnsigned(text, &record->timestamp);
+            break;
+        default:
+            break;
+    }
+    if (ok) {
+        record->present |= 1u << field;
+    }
+}
+
+// ==================== 解析 ====================
+
+/**
+ * @brief 解析一条遥测负载
+ *
+ * 第一阶段得到结构字符位置后，第二阶段按 键 : 值 , 的顺序在索引上跳转：
+ * - 字符串值：两个相邻引号之间
+ * - 对象/数组：按括号深度跳到匹配的结束括号
+ * - 数字/布尔/null：冒号之后到下一个结构字符之间
+ */
+bool parseSensorRecord(SensorParser* parser, std::string_view payload, SensorRecord* record) {
+    *record = SensorRecord{};
+
+    if (parser->indices.size() < payload.size()) {
+        parser->indices.resize(payload.size());
+    }
+    const char* data = payload.data();
+    const uint32_t* idx = parser->indices.data();
+    size_t n = jsonScanStructurals(data, payload.size(), parser->indices.data(), parser->indices.size());
+    if (n == SIZE_MAX || n < 2 || data[idx[0]] != '{') return false;
+
+    size_t i = 1;
+    if (data[idx[i]] == '}') return true;
+
+    for (;;) {
+        // 键
+        if (i + 2 >= n || data[idx[i]] != '"' || data[idx[i + 1]] != '"' || data[idx[i + 2]] != ':') return false;
+        std::string_view key(data + idx[i] + 1, idx[i + 1] - idx[i] - 1);
+        uint32_t colon = idx[i + 2];
+        i += 3;
+        if (i >= n) return false;
+
+        int field = lookupField(key);
+
+        // 值的第一个非空白字符
+        uint32_t start = colon + 1;
+        while (start < idx[i] && isSpace(data[start])) start++;
+
+        char c = data[start];
+        if (c == '"' && start == idx[i]) {
+            if (i + 1 >= n) return false;
+            if (field >= 0) {
+                storeField(record, field, std::string_view(data + start + 1, idx[i + 1] - start - 1), true);
+            }
+            i += 2;
+        } else if ((c == '{' || c == '[') && start == idx[i]) {
+            // 嵌套对象/数组整体跳过
+            int depth = 0;
+            do {
+                char s = data[idx[i]];
+                if (s == '{' || s == '[') depth++;
+                else if (s == '}' || s == ']') depth--;
+                i++;
+            } while (depth > 0 && i < n);
+            if (depth != 0) return false;
+        } else {
+            uint32_t end = idx[i];
+            while (end > start && isSpace(data[end - 1])) end--;
+            if (end == start) return false;
+            if (field >= 0) {
+                storeField(record, field, std::string_view(data + start, end - start), false);
+            }
+        }
+
+        if (i >= n) return false;
+        char sep = data[idx[i]];
+        if (sep == '}') return i == n - 1;
+        if (sep != ',') return false;
+        i++;
+    }
+}
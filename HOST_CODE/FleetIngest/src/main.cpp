@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <string>
+#include "MY_MqttSession.h"
+#include "MY_Ingest.h"
+#include "MY_JsonScan.h"
+
+// ==================== 运行参数 ====================
+#define INGEST_POLL_MS              200     // 单次等待数据的最长时间
+#define INGEST_BACKOFF_MIN_MS       1000    // 重连退避最小值 (与固件一致)
+#define INGEST_BACKOFF_MAX_MS       60000   // 重连退避最大值
+
+static volatile sig_atomic_t running = 1;
+
+static void handleSignal(int) {
+    running = 0;
+}
+
+static void printUsage(const char* name) {
+    printf("Usage: %s [-h host] [-p port] [-t topic] [-c client_id] [-i report_interval_s]\n", name);
+}
+
+/**
+ * @brief 机队遥测接入服务
+ *
+ * 订阅本地Broker上的 fire_alarm/sensor_data，解析后写入列式存储，
+ * 周期打印机队状态，设备火灾等级变化时立即打印
+ */
+int main(int argc, char** argv) {
+    std::string host = "127.0.0.1";
+    uint16_t port = 1883;
+    std::string topic = INGEST_TOPIC_SENSOR;
+    std::string clientId = "fleet_ingest_" + std::to_string(getpid());
+    int reportIntervalS = INGEST_REPORT_INTERVAL_S;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:t:c:i:")) != -1) {
+        switch (opt) {
+            case 'h': host = optarg; break;
+            case 'p': port = (uint16_t)atoi(optarg); break;
+            case 't': topic = optarg; break;
+            case 'c': clientId = optarg; break;
+            case 'i': reportIntervalS = atoi(optarg); break;
+            default:
+                printUsage(argv[0]);
+                return 1;
+        }
+    }
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    static IngestContext ctx;
+    ingestInit(&ctx, topic.c_str(), INGEST_EXPECTED_DEVICES, true);
+
+    printf("[INGEST] Broker %s:%u, topic %s, JSON scan: %s\n", host.c_str(), port, topic.c_str(),
+           jsonScanImplementation());
+
+    MqttSession session;
+    mqttSessionInit(&session);
+
+    int64_t backoffMs = INGEST_BACKOFF_MIN_MS;
+    int64_t lastReportMs = mqttSessionNowMs();
+    uint64_t lastReportMessages = 0;
+
+    while (running) {
+        if (session.fd < 0) {
+            if (!mqttSessionConnect(&session, host.c_str(), port, clientId.c_str()) ||
+                !mqttSessionSubscribe(&session, topic.c_str())) {
+                mqttSessionClose(&session);
+                printf("[INGEST] Retry in %llds\n", (long long)(backoffMs / 1000));
+                for (int64_t waited = 0; running && waited < backoffMs; waited += INGEST_POLL_MS) {
+                    usleep(INGEST_POLL_MS * 1000);
+                }
+                backoffMs = backoffMs * 2 > INGEST_BACKOFF_MAX_MS ? INGEST_BACKOFF_MAX_MS : backoffMs * 2;
+                continue;
+            }
+            printf("[INGEST] Connected and subscribed\n");
+            backoffMs = INGEST_BACKOFF_MIN_MS;
+        }
+
+        if (!mqttSessionPoll(&session, INGEST_POLL_MS, ingestMessage, &ctx)) {
+            printf("[INGEST] Connection lost\n");
+            mqttSessionClose(&session);
+        }
+
+        int64_t now = mqttSessionNowMs();
+        if (now - lastReportMs >= reportIntervalS * 1000LL) {
+            double rate = (ctx.messages - lastReportMessages) * 1000.0 / (now - lastReportMs);
+            ingestPrintReport(&ctx, rate);
+            lastReportMs = now;
+            lastReportMessages = ctx.messages;
+        }
+    }
+
+    mqttSessionClose(&session);
+    ingestPrintReport(&ctx, 0.0);
+    return 0;
+}
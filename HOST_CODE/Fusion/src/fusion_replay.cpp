@@ -0,0 +1,524 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include "MY_FusionKernels.h"
+
+/*
+ * 多源融合回放：直接编译固件的 MY_FusionKernels.cpp，按固件的调用顺序回放传感器与K230轨迹
+ *   - 传感器每个采样周期更新证据后评估一次，K230帧更新证据后也立即评估 (与 Sensor_Task 相同)
+ *   - 火灾轨迹：统计从起火时刻到报警/灭火等级的时间，以及漏报
+ *   - 干扰源与正常轨迹：统计达到报警/灭火等级的比例 (误报警/误喷水)
+ *   - 火灾场景各有起火到灭火的 p90 上限，超出即判失败
+ * 内置场景用固定种子合成，也可用 -f 回放采集的CSV轨迹；超出容差时退出码为1
+ */
+
+// ==================== 回放参数 ====================
+#define REPLAY_DEFAULT_RUNS         500     // 每种内置场景的轨迹数
+#define REPLAY_DEFAULT_SEED         1
+#define REPLAY_SAMPLE_MS            2000    // 与固件 SENSOR_READ_INTERVAL_MS 一致
+#define REPLAY_K230_FAST_MS         500     // K230检测到火焰后的快速上报间隔
+#define REPLAY_ONSET_MS             60000   // 内置场景的事件开始时刻
+
+// 与固件默认配置一致 (MY_MQ2.h / MY_DHT11.h)
+static const FusionThresholds defaultThresholds = { 15.0f, 30.0f, 40.0f, 50.0f };
+
+// 容差
+#define TOL_MIN_FIRE_SUPPRESS       0.95f   // 火灾轨迹到达灭火等级的比例
+#define TOL_MAX_NUISANCE_SUPPRESS   0.0f    // 单一来源干扰触发喷水的比例
+#define TOL_MAX_CLEAN_ALARM         0.0f    // 正常轨迹触发报警的比例
+// 起火到灭火的 p90 上限 (秒)
+#define SMOULDER_MAX_SUPPRESS_S     540.0f  // 阴燃：烟雾持续确认 (5分钟) 加上慢速阴燃升到报警阈值的时间
+#define FLAMING_MAX_SUPPRESS_S      60.0f
+#define K230_MAX_SUPPRESS_S         30.0f   // K230确认约需6秒持续检测，加上首次检测延迟
+#define NO_DHT11_MAX_SUPPRESS_S     90.0f   // DHT11损坏：仅烟雾与DO
+
+// ==================== 轨迹 ====================
+
+typedef enum {
+    TRACE_CLEAN = 0,        // 正常：不应报警
+    TRACE_NUISANCE = 1,     // 单一来源干扰：可以报警，不应喷水
+    TRACE_FIRE = 2          // 火灾：应在起火后到达灭火等级
+} TraceLabel;
+
+static const char* labelNames[] = { "clean", "nuisance", "fire" };
+
+typedef struct {
+    uint32_t ms;
+    bool k230;              // true: K230帧；false: 传感器采样
+    float temperature;      // NaN 表示本次DHT11读取失败
+    float smoke;
+    bool smokeAlarm;
+    float confidence;
+} TraceEvent;
+
+typedef struct {
+    TraceLabel label;
+    uint32_t onsetMs;
+    std::vector<TraceEvent> events;     // 按时间排序
+    float maxSuppressS;                 // 起火到灭火的 p90 上限 (秒)，0 表示不检查
+} Trace;
+
+// 一条轨迹的回放结果
+typedef struct {
+    int64_t alarmMs;        // 首次到达报警等级的时刻，-1 表示未到达
+    int64_t suppressMs;     // 首次到达灭火等级的时刻
+    bool earlyAlarm;        // 起火前已报警 (火灾轨迹)
+    float peakScore;
+} ReplayResult;
+
+static ReplayResult replay(const Trace& trace, const FusionThresholds* thresholds) {
+    FusionState state;
+    fusionKernelInit(&state, 1, 0);
+    ReplayResult result = { -1, -1, false, 0.0f };
+
+    for (const TraceEvent& e : trace.events) {
+        if (e.k230) {
+            fusionKernelUpdateK230(&state, e.confidence, e.ms);
+        } else {
+            fusionKernelUpdateSensors(&state, thresholds, &e.temperature, &e.smoke, &e.smokeAlarm, e.ms);
+        }
+        fusionKernelEvaluate(&state, e.ms);
+
+        FireLevel level = state.level[0];
+        result.peakScore = fmaxf(result.peakScore, state.score[0]);
+        if (level >= FIRE_LEVEL_ALARM && result.alarmMs < 0) {
+            result.alarmMs = e.ms;
+            if (trace.label == TRACE_FIRE && e.ms < trace.onsetMs) result.earlyAlarm = true;
+        }
+        if (level == FIRE_LEVEL_SUPPRESS && result.suppressMs < 0) {
+            result.suppressMs = e.ms;
+        }
+    }
+    return result;
+}
+
+// ==================== 合成场景 ====================
+
+static uint64_t rng;
+
+static double uniform() {
+    rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ((rng >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double range(double lo, double hi) {
+    return lo + (hi - lo) * uniform();
+}
+
+static double gaussian() {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+// 传感器共用参数：基线、噪声、DHT11 1°C分辨率与偶发读取失败、MQ-2 DO电位器阈值
+typedef struct {
+    double smoke0;
+    double temp0;
+    double doThreshold;
+} SensorBase;
+
+static SensorBase randomBase() {
+    SensorBase b;
+    b.smoke0 = range(3.0, 8.0);
+    b.temp0 = range(18.0, 28.0);
+    b.doThreshold = range(35.0, 50.0);
+    return b;
+}
+
+static TraceEvent sensorSample(const SensorBase& b, uint32_t ms, double smokeRise, double tempRise) {
+    TraceEvent e = {};
+    e.ms = ms;
+    double smoke = b.smoke0 + smokeRise + 0.8 * gaussian();
+    e.smoke = (float)std::min(100.0, std::max(0.0, smoke));
+    e.smokeAlarm = e.smoke > b.doThreshold;
+    e.temperature = uniform() < 0.01 ? NAN : (float)round(b.temp0 + tempRise + 0.3 * gaussian());
+    return e;
+}
+
+static TraceEvent k230Frame(uint32_t ms, double confidence) {
+    TraceEvent e = {};
+    e.ms = ms;
+    e.k230 = true;
+    e.confidence = (float)std::min(1.0, std::max(0.0, confidence));
+    return e;
+}
+
+static void sortEvents(Trace* trace) {
+    std::stable_sort(trace->events.begin(), trace->events.end(),
+                     [](const TraceEvent& a, const TraceEvent& b) { return a.ms < b.ms; });
+}
+
+// 事件前后的上升过程：先按 tau 趋近 amplitude，持续 holdS 后按同一时间常数回落
+static double episode(double t, double amplitude, double tau, double holdS) {
+    if (t <= 0.0) return 0.0;
+    if (t <= holdS) return amplitude * (1.0 - exp(-t / tau));
+    double top = amplitude * (1.0 - exp(-holdS / tau));
+    return top * exp(-(t - holdS) / tau);
+}
+
+// 正常：只有噪声和缓慢漂移
+static Trace makeClean() {
+    Trace tr = { TRACE_CLEAN, REPLAY_ONSET_MS, {}, 0.0f };
+    SensorBase b = randomBase();
+    double drift = range(-1.0, 1.0);
+    for (uint32_t ms = 0; ms <= 600000; ms += REPLAY_SAMPLE_MS) {
+        double f = ms / 600000.0;
+        tr.events.push_back(sensorSample(b, ms, 2.0 * drift * f, drift * f));
+    }
+    return tr;
+}
+
+// 阴燃：烟雾缓慢线性上升，温度滞后后缓慢上升
+static Trace makeSmoulder() {
+    Trace tr = { TRACE_FIRE, REPLAY_ONSET_MS, {}, SMOULDER_MAX_SUPPRESS_S };
+    SensorBase b = randomBase();
+    double smokeRate = range(0.05, 0.30);       // %/秒
+    double tempDelay = range(30.0, 120.0);
+    double tempRor = range(1.5, 6.0);           // °C/分钟
+    for (uint32_t ms = 0; ms <= 900000; ms += REPLAY_SAMPLE_MS) {
+        double t = ((double)ms - tr.onsetMs) / 1000.0;
+        double smoke = t > 0 ? std::min(80.0, smokeRate * t) : 0.0;
+        double temp = t > tempDelay ? tempRor * (t - tempDelay) / 60.0 : 0.0;
+        tr.events.push_back(sensorSample(b, ms, smoke, temp));
+    }
+    return tr;
+}
+
+// 明火：烟雾与温度都快速上升
+static Trace makeFlaming() {
+    Trace tr = { TRACE_FIRE, REPLAY_ONSET_MS, {}, FLAMING_MAX_SUPPRESS_S };
+    SensorBase b = randomBase();
+    double smokeRate = range(0.8, 3.0);
+    double tempDelay = range(5.0, 20.0);
+    double tempRor = range(10.0, 40.0);
+    for (uint32_t ms = 0; ms <= 300000; ms += REPLAY_SAMPLE_MS) {
+        double t = ((double)ms - tr.onsetMs) / 1000.0;
+        double smoke = t > 0 ? std::min(90.0, smokeRate * t) : 0.0;
+        double temp = t > tempDelay ? tempRor * (t - tempDelay) / 60.0 : 0.0;
+        tr.events.push_back(sensorSample(b, ms, smoke, temp));
+    }
+    return tr;
+}
+
+// 摄像头视野内起火：K230连续检测 (快速上报、偶有漏帧)，烟雾与温度只缓慢上升
+static Trace makeK230Fire() {
+    Trace tr = { TRACE_FIRE, REPLAY_ONSET_MS, {}, K230_MAX_SUPPRESS_S };
+    SensorBase b = randomBase();
+    double smokeRate = range(0.02, 0.10);
+    double tempRor = range(0.5, 2.0);
+    double conf = range(0.75, 0.95);
+    double k230Delay = range(2.0, 10.0);
+    for (uint32_t ms = 0; ms <= 300000; ms += REPLAY_SAMPLE_MS) {
+        double t = ((double)ms - tr.onsetMs) / 1000.0;
+        double smoke = t > 0 ? smokeRate * t : 0.0;
+        double temp = t > 0 ? tempRor * t / 60.0 : 0.0;
+        tr.events.push_back(sensorSample(b, ms, smoke, temp));
+    }
+    for (uint32_t ms = tr.onsetMs + (uint32_t)(k230Delay * 1000); ms <= 300000; ms += REPLAY_K230_FAST_MS) {
+        if (uniform() < 0.2) continue;
+        tr.events.push_back(k230Frame(ms, conf + 0.05 * gaussian()));
+    }
+    sortEvents(&tr);
+    return tr;
+}
+
+// DHT11损坏 (从未读到温度) 时的明火：只有烟雾与DO
+static Trace makeFlamingNoDht11() {
+    Trace tr = makeFlaming();
+    tr.maxSuppressS = NO_DHT11_MAX_SUPPRESS_S;
+    for (TraceEvent& e : tr.events) {
+        e.temperature = NAN;
+    }
+    return tr;
+}
+
+// 旧协议K230 (只有"fire"，置信度取默认值) 视野内起火
+static Trace makeK230Legacy() {
+    Trace tr = makeK230Fire();
+    for (TraceEvent& e : tr.events) {
+        if (e.k230) e.confidence = FUSION_K230_DEFAULT_CONF;
+    }
+    return tr;
+}
+
+// 水汽/烹饪：烟雾读数平滑上升后回落，温度小幅上升，DO可能短暂触发
+static Trace makeSteam() {
+    Trace tr = { TRACE_NUISANCE, REPLAY_ONSET_MS, {}, 0.0f };
+    SensorBase b = randomBase();
+    double amplitude = range(10.0, 35.0);
+    double tau = range(20.0, 60.0);
+    double hold = range(60.0, 240.0);
+    double warm = range(0.0, 3.0);
+    for (uint32_t ms = 0; ms <= 600000; ms += REPLAY_SAMPLE_MS) {
+        double t = ((double)ms - tr.onsetMs) / 1000.0;
+        double e = episode(t, 1.0, tau, hold);
+        tr.events.push_back(sensorSample(b, ms, amplitude * e, warm * e));
+    }
+    return tr;
+}
+
+// 烤焦食物：烟雾快速升到高位并触发DO，温度不变
+static Trace makeToast() {
+    Trace tr = { TRACE_NUISANCE, REPLAY_ONSET_MS, {}, 0.0f };
+    SensorBase b = randomBase();
+    double amplitude = range(30.0, 70.0);
+    double tau = range(10.0, 30.0);
+    double hold = range(30.0, 120.0);
+    for (uint32_t ms = 0; ms <= 600000; ms += REPLAY_SAMPLE_MS) {
+        double t = ((double)ms - tr.onsetMs) / 1000.0;
+        tr.events.push_back(sensorSample(b, ms, episode(t, amplitude, tau, hold), 0.0));
+    }
+    return tr;
+}
+
+// 取暖器靠近探头：温度持续上升到报警阈值以上，烟雾不变
+static Trace makeHeater() {
+    Trace tr = { TRACE_NUISANCE, REPLAY_ONSET_MS, {}, 0.0f };
+    SensorBase b = randomBase();
+    double target = range(45.0, 65.0);
+    double ror = range(2.0, 10.0);
+    for (uint32_t ms = 0; ms <= 900000; ms += REPLAY_SAMPLE_MS) {
+        double t = ((double)ms - tr.onsetMs) / 1000.0;
+        double temp = t > 0 ? std::min(target - b.temp0, ror * t / 60.0) : 0.0;
+        tr.events.push_back(sensorSample(b, ms, 0.0, temp));
+    }
+    return tr;
+}
+
+// K230零星误检：孤立的单帧高置信度检测 (反光、红色物体)，间隔至少10秒，传感器正常
+static Trace makeK230FalsePositive() {
+    Trace tr = { TRACE_NUISANCE, REPLAY_ONSET_MS, {}, 0.0f };
+    SensorBase b = randomBase();
+    for (uint32_t ms = 0; ms <= 600000; ms += REPLAY_SAMPLE_MS) {
+        tr.events.push_back(sensorSample(b, ms, 0.0, 0.0));
+    }
+    double t = tr.onsetMs / 1000.0;
+    for (;;) {
+        t += 10.0 - 30.0 * log(uniform());
+        if (t > 600.0) break;
+        tr.events.push_back(k230Frame((uint32_t)(t * 1000), range(0.5, 0.95)));
+    }
+    sortEvents(&tr);
+    return tr;
+}
+
+typedef struct {
+    const char* name;
+    Trace (*make)();
+} Scenario;
+
+static const Scenario scenarios[] = {
+    { "clean", makeClean },
+    { "smoulder", makeSmoulder },
+    { "flaming", makeFlaming },
+    { "k230_fire", makeK230Fire },
+    { "no_dht11", makeFlamingNoDht11 },
+    { "k230_old", makeK230Legacy },
+    { "steam", makeSteam },
+    { "toast", makeToast },
+    { "heater", makeHeater },
+    { "k230_fp", makeK230FalsePositive },
+};
+
+// ==================== CSV轨迹 ====================
+
+/*
+ * 每行一个事件，时间为毫秒：
+ *   t_ms,S,temperature,smoke,do     传感器采样 (温度为 nan 表示读取失败，do 为 0/1)
+ *   t_ms,K,confidence               K230火焰检测帧
+ *   # label=clean|nuisance|fire     轨迹类别 (默认 nuisance)
+ *   # onset_ms=N                    起火/干扰开始时刻 (默认 0)
+ *   # max_suppress_s=N              起火到灭火的上限 (默认不检查)
+ */
+static bool loadTrace(const char* path, Trace* trace) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        printf("[REPLAY] cannot open %s\n", path);
+        return false;
+    }
+    trace->label = TRACE_NUISANCE;
+    trace->onsetMs = 0;
+    trace->maxSuppressS = 0.0f;
+    trace->events.clear();
+
+    char line[256];
+    int lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f) != NULL) {
+        lineNo++;
+        if (line[0] == '#') {
+            char value[32];
+            unsigned long onset;
+            float bound;
+            if (sscanf(line, "# label=%31s", value) == 1) {
+                if (strcmp(value, "clean") == 0) trace->label = TRACE_CLEAN;
+                else if (strcmp(value, "fire") == 0) trace->label = TRACE_FIRE;
+                else if (strcmp(value, "nuisance") == 0) trace->label = TRACE_NUISANCE;
+                else ok = false;
+            } else if (sscanf(line, "# onset_ms=%lu", &onset) == 1) {
+                trace->onsetMs = (uint32_t)onset;
+            } else if (sscanf(line, "# max_suppress_s=%f", &bound) == 1) {
+                trace->maxSuppressS = bound;
+            }
+            continue;
+        }
+        if (strspn(line, " \t\r\n") == strlen(line)) continue;
+
+        unsigned long ms;
+        char kind;
+        char temp[16];
+        float smoke, confidence;
+        int smokeAlarm;
+        TraceEvent e = {};
+        if (sscanf(line, "%lu,%c,", &ms, &kind) != 2) {
+            ok = false;
+        } else if (kind == 'S' && sscanf(line, "%lu,S,%15[^,],%f,%d", &ms, temp, &smoke, &smokeAlarm) == 4) {
+            e.ms = (uint32_t)ms;
+            e.temperature = strtof(temp, NULL);
+            e.smoke = smoke;
+            e.smokeAlarm = smokeAlarm != 0;
+            trace->events.push_back(e);
+        } else if (kind == 'K' && sscanf(line, "%lu,K,%f", &ms, &confidence) == 2) {
+            trace->events.push_back(k230Frame((uint32_t)ms, confidence));
+        } else {
+            ok = false;
+        }
+    }
+    fclose(f);
+    if (!ok) {
+        printf("[REPLAY] %s:%d: malformed line\n", path, lineNo);
+        return false;
+    }
+    sortEvents(trace);
+    return true;
+}
+
+// ==================== 统计 ====================
+
+typedef struct {
+    const char* name;
+    TraceLabel label;
+    int runs;
+    int alarms;
+    int suppresses;
+    int earlyAlarms;
+    std::vector<double> alarmS;         // 起火到报警的时间 (秒)
+    std::vector<double> suppressS;      // 起火到灭火的时间 (秒)
+    float peakScore;
+    float maxSuppressS;
+} ScenarioStats;
+
+static void addResult(ScenarioStats* s, const Trace& trace, const ReplayResult& r) {
+    s->runs++;
+    if (r.alarmMs >= 0) {
+        s->alarms++;
+        s->alarmS.push_back((r.alarmMs - (int64_t)trace.onsetMs) / 1000.0);
+    }
+    if (r.suppressMs >= 0) {
+        s->suppresses++;
+        s->suppressS.push_back((r.suppressMs - (int64_t)trace.onsetMs) / 1000.0);
+    }
+    if (r.earlyAlarm) s->earlyAlarms++;
+    s->peakScore = fmaxf(s->peakScore, r.peakScore);
+}
+
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return NAN;
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)(p * (v.size() - 1) + 0.5);
+    return v[i];
+}
+
+static bool reportScenario(const ScenarioStats& s) {
+    float alarmRate = s.runs ? (float)s.alarms / s.runs : 0.0f;
+    float suppressRate = s.runs ? (float)s.suppresses / s.runs : 0.0f;
+    bool ok;
+    if (s.label == TRACE_FIRE) {
+        double suppressP90 = percentile(s.suppressS, 0.9);
+        ok = suppressRate >= TOL_MIN_FIRE_SUPPRESS && s.earlyAlarms == 0 &&
+             (s.maxSuppressS <= 0.0f || suppressP90 <= s.maxSuppressS);
+        printf("[REPLAY] %-10s %-8s %4d runs  alarm %6.1f%%  suppress %6.1f%%  "
+               "to alarm p50 %6.1fs p90 %6.1fs  to suppress p50 %6.1fs p90 %6.1fs (max %.0fs)  %s\n",
+               s.name, labelNames[s.label], s.runs, alarmRate * 100.0f, suppressRate * 100.0f,
+               percentile(s.alarmS, 0.5), percentile(s.alarmS, 0.9),
+               percentile(s.suppressS, 0.5), suppressP90, s.maxSuppressS, ok ? "OK" : "FAIL");
+    } else {
+        ok = suppressRate <= TOL_MAX_NUISANCE_SUPPRESS &&
+             (s.label != TRACE_CLEAN || alarmRate <= TOL_MAX_CLEAN_ALARM);
+        printf("[REPLAY] %-10s %-8s %4d runs  false alarm %6.1f%%  false suppress %6.1f%%  "
+               "peak score %.2f  %s\n",
+               s.name, labelNames[s.label], s.runs, alarmRate * 100.0f, suppressRate * 100.0f,
+               s.peakScore, ok ? "OK" : "FAIL");
+    }
+    return ok;
+}
+
+// ==================== 主程序 ====================
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [-n runs] [-s seed] [-f trace.csv]...\n", prog);
+}
+
+int main(int argc, char** argv) {
+    int runs = REPLAY_DEFAULT_RUNS;
+    uint64_t seed = REPLAY_DEFAULT_SEED;
+    std::vector<const char*> files;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:f:")) != -1) {
+        switch (opt) {
+            case 'n': runs = atoi(optarg); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'f': files.push_back(optarg); break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (runs <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const FusionThresholds* thresholds = &defaultThresholds;
+    printf("[REPLAY] weights smoke/temp/do/k230 %.2f/%.2f/%.2f/%.2f, alarm/suppress/clear %.2f/%.2f/%.2f\n",
+           FUSION_WEIGHT_SMOKE, FUSION_WEIGHT_TEMP, FUSION_WEIGHT_MQ2_DO, FUSION_WEIGHT_K230,
+           FUSION_ALARM_SCORE, FUSION_SUPPRESS_SCORE, FUSION_CLEAR_SCORE);
+    printf("[REPLAY] smoke %.0f/%.0f%%, temperature %.0f/%.0f C (safe/alarm)\n",
+           thresholds->smokeSafe, thresholds->smokeAlarm, thresholds->tempSafe, thresholds->tempAlarm);
+
+    bool ok = true;
+    if (files.empty()) {
+        rng = seed;
+        printf("[REPLAY] %d runs per scenario (seed %llu)\n", runs, (unsigned long long)seed);
+        for (const Scenario& sc : scenarios) {
+            ScenarioStats stats = {};
+            stats.name = sc.name;
+            for (int i = 0; i < runs; i++) {
+                Trace trace = sc.make();
+                stats.label = trace.label;
+                stats.maxSuppressS = trace.maxSuppressS;
+                addResult(&stats, trace, replay(trace, thresholds));
+            }
+            ok = reportScenario(stats) && ok;
+        }
+    } else {
+        for (const char* path : files) {
+            Trace trace;
+            if (!loadTrace(path, &trace)) {
+                ok = false;
+                continue;
+            }
+            ScenarioStats stats = {};
+            const char* base = strrchr(path, '/');
+            stats.name = base ? base + 1 : path;
+            stats.label = trace.label;
+            stats.maxSuppressS = trace.maxSuppressS;
+            addResult(&stats, trace, replay(trace, thresholds));
+            ok = reportScenario(stats) && ok;
+        }
+    }
+
+    printf("[REPLAY] %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+#ifndef MY_LATENCY_HIST_H
+#define MY_LATENCY_HIST_H
+
+#include <stdint.h>
+
+/*
+ * 延迟直方图 (微秒，对数-线性分桶)
+ *   每个2的幂区间再等分为 2^LATENCY_SUB_BITS 档，相对误差不超过 1/2^LATENCY_SUB_BITS
+ *   记录为 O(1)，不分配内存，可覆盖 0us 到 2^64us
+ */
+
+// ==================== 配置 ====================
+#define LATENCY_SUB_BITS            4       // 每个2的幂区间16档，误差 < 6.25%
+#define LATENCY_SUB_COUNT           (1u << LATENCY_SUB_BITS)
+#define LATENCY_BUCKET_COUNT        ((64 - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT)
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint64_t counts[LATENCY_BUCKET_COUNT];
+    uint64_t total;
+    uint64_t sumUs;
+    uint64_t maxUs;
+} LatencyHist;
+
+// ==================== 函数声明 ====================
+
+void latencyHistReset(LatencyHist* hist);
+void latencyHistRecord(LatencyHist* hist, uint64_t us);
+
+// 百分位 (0~100)，返回所在分桶的上界 (不超过最大值)；无样本返回0
+uint64_t latencyHistPercentile(const LatencyHist* hist, double percent);
+
+// 打印一行: 名称 样本数 平均 p50 p90 p99 p99.9 最大
+void latencyHistPrint(const LatencyHist* hist, const char* name);
+
+#endif
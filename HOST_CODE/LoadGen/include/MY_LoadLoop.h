@@ -0,0 +1,52 @@
+#ifndef MY_LOAD_LOOP_H
+#define MY_LOAD_LOOP_H
+
+#include <stdint.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#include "MY_LoadScript.h"
+
+/*
+ * 负载事件循环 (单线程 epoll)
+ *   每台虚拟控制器一个非阻塞TCP会话，连接按速率爬坡建立；
+ *   遥测、火灾脚本、心跳和重连统一由最小堆定时器驱动
+ *   另有两个辅助会话：
+ *     监控会话：订阅遥测/报警/config/state，按 device_id + timestamp 匹配发送时刻，统计端到端延迟
+ *     操作员会话：发布命令；配置命令的往返延迟 = 发布 → 各设备 config/state 到达监控会话
+ */
+
+// ==================== 配置 ====================
+#define LOADGEN_DEFAULT_DEVICES     1000
+#define LOADGEN_DEFAULT_RAMP        500     // 每秒新建连接数
+#define LOADGEN_REPORT_INTERVAL_S   10
+#define LOADGEN_EPOLL_EVENTS        1024
+#define LOADGEN_RX_INITIAL          512     // 设备会话接收缓冲区初始大小 (只收命令)
+#define LOADGEN_MONITOR_RX_INITIAL  (256 * 1024)
+#define LOADGEN_CONNECT_TIMEOUT_MS  10000   // TCP + CONNACK 超时
+#define LOADGEN_BACKOFF_MIN_MS      1000    // 重连退避 (与固件一致)
+#define LOADGEN_BACKOFF_MAX_MS      60000
+#define LOADGEN_COMMAND_TIMEOUT_MS  10000   // 配置命令往返等待上限
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    std::string host;
+    uint16_t port;
+    uint32_t devices;
+    uint32_t telemetryIntervalMs;   // 遥测间隔 (固件为 MQTT_PUBLISH_INTERVAL_MS)
+    uint32_t rampPerSec;
+    uint32_t sourceAddrs;           // >0 时本地地址轮流绑定 127.0.0.1 ~ 127.0.0.N，突破单源端口数限制
+    double firesPerMin;             // 随机火灾频率 (全机队)
+    double commandsPerSec;          // 配置命令往返探测频率
+    uint32_t durationS;             // 0 表示运行到 Ctrl+C
+    uint32_t reportIntervalS;
+    std::vector<ScriptStep> script;
+} LoadConfig;
+
+// ==================== 函数声明 ====================
+
+// 运行负载直到 durationS 或 *running 变为0，结束时打印汇总；初始化失败返回false
+bool loadLoopRun(const LoadConfig* config, volatile sig_atomic_t* running);
+
+#endif
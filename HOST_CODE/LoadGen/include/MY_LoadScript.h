@@ -0,0 +1,44 @@
+#ifndef MY_LOAD_SCRIPT_H
+#define MY_LOAD_SCRIPT_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+ * 负载脚本：按时间触发火灾或下发命令
+ *   每行一个步骤，时间为相对启动的秒数 (可带小数)，# 开头为注释:
+ *     10    fire     *                     全部设备开始一次火灾
+ *     12.5  fire     42                    第42台设备
+ *     15    fire     random                随机一台已连接设备
+ *     20    command  fire_alarm/fan/mode   {"action":"manual"}
+ *   命令由操作员会话发布，负载取该行剩余部分
+ */
+
+// ==================== 配置 ====================
+#define SCRIPT_DEVICE_ALL           -1
+#define SCRIPT_DEVICE_RANDOM        -2
+
+// ==================== 枚举定义 ====================
+
+typedef enum {
+    SCRIPT_FIRE = 0,
+    SCRIPT_COMMAND = 1
+} ScriptAction;
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint64_t atMs;              // 相对启动的触发时间
+    uint8_t action;             // ScriptAction
+    int32_t device;             // 设备序号，或 SCRIPT_DEVICE_ALL / SCRIPT_DEVICE_RANDOM
+    std::string topic;
+    std::string payload;
+} ScriptStep;
+
+// ==================== 函数声明 ====================
+
+// 读取脚本文件，按时间排序；格式错误时打印行号并返回false
+bool loadScriptFile(const char* path, std::vector<ScriptStep>* steps);
+
+#endif
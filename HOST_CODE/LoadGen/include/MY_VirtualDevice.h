@@ -0,0 +1,129 @@
+#ifndef MY_VIRTUAL_DEVICE_H
+#define MY_VIRTUAL_DEVICE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string_view>
+#include "MY_ConfigCore.h"
+#include "MY_CommandCore.h"
+
+/*
+ * 虚拟控制器：在主机上复现固件 MY_MQTT.cpp 的 MQTT 行为
+ *   与固件编译同一份源码的部分：
+ *     配置字段表、默认值、校验、限频与 config/state 负载 (MY_ConfigCore)、
+ *     命令Topic与负载解码 (MY_CommandCore)、遥测字段、顺序与取整 (MY_SensorPayload)
+ *   本模块只负责执行：遗嘱/上线消息、自动模式下忽略控制命令、config/state 的发布时机与执行器状态
+ *   传感器读数与火灾等级由脚本驱动，不模拟物理过程
+ */
+
+// ==================== Topic (与固件一致，控制Topic见 MY_CommandCore.h) ====================
+#define DEVICE_TOPIC_SENSOR         "fire_alarm/sensor_data"
+#define DEVICE_TOPIC_ALARM          "fire_alarm/alarm_event"
+#define DEVICE_TOPIC_STATUS         "fire_alarm/status"
+#define DEVICE_TOPIC_CONFIG_STATE   "fire_alarm/config/state"
+
+// ==================== 固件参数 ====================
+#define DEVICE_ID_PREFIX            "esp32_fire_alarm_"
+#define DEVICE_PAYLOAD_SIZE         (2176 + 448)    // 单区的 OUTBOX_PAYLOAD_SIZE
+#define DEVICE_KEEPALIVE_S          10      // MQTT_KEEPALIVE_S
+#define DEVICE_FW_VERSION           "1.0.0" // FIRMWARE_VERSION
+#define DEVICE_ZONE_NAME            "zone0"
+#define DEVICE_SENT_HISTORY         4       // 记录最近几条消息的发送时刻
+
+// ==================== 火灾脚本时序 ====================
+#define DEVICE_FIRE_SUPPRESS_MS     4000    // 报警后升级为灭火的时间
+#define DEVICE_FIRE_CLEAR_MS        20000   // 灭火后解除的时间
+
+// ==================== 枚举定义 ====================
+
+// 火灾等级 (与固件 FireLevel 一致)
+typedef enum {
+    DEVICE_FIRE_NONE = 0,
+    DEVICE_FIRE_ALARM = 1,
+    DEVICE_FIRE_SUPPRESS = 2
+} DeviceFireLevel;
+
+// ==================== 数据结构 ====================
+
+// 一条已发送消息的 timestamp 字段与发送时刻
+typedef struct {
+    uint64_t ms;
+    uint64_t us;
+} DeviceSentStamp;
+
+// 消息输出 (由事件循环编码为PUBLISH)
+typedef struct {
+    void (*publish)(void* ctx, const char* topic, std::string_view payload, bool retain);
+    void* ctx;
+} DeviceSink;
+
+// 单台虚拟控制器
+typedef struct {
+    uint32_t index;
+    char id[32];
+    uint64_t bootUs;                // 对应固件 millis() 的零点
+    uint32_t seed;                  // 读数抖动用的随机状态
+
+    // 执行器
+    bool fanAuto;
+    bool pumpAuto;
+    bool buzzerAuto;
+    bool fanOn;
+    bool buzzerOn;
+    const char* buzzerPattern;
+    uint64_t pumpOffUs;             // 0 表示水泵关闭
+
+    // 火灾脚本
+    uint8_t fireLevel;              // DeviceFireLevel
+    float fireScore;
+    uint64_t fireNextUs;            // 下一次等级切换时间，0 表示无脚本在运行
+
+    // 配置 (更新规则的时间基准为 deviceMillis，同固件 millis())
+    SystemConfig config;
+    ConfigCore configCore;
+
+    // 连接统计 (遥测中的 mqtt_reconnects 等字段)
+    uint32_t reconnects;
+    uint32_t mqttConnectMs;
+    uint32_t lastOutageMs;
+
+    // 最近几条遥测 / 报警事件的发送记录，监控端按 timestamp 匹配后计算延迟
+    DeviceSentStamp telemetrySent[DEVICE_SENT_HISTORY];
+    DeviceSentStamp eventSent[DEVICE_SENT_HISTORY];
+    uint8_t telemetryHead;
+    uint8_t eventHead;
+} VirtualDevice;
+
+// ==================== 函数声明 ====================
+
+void deviceInit(VirtualDevice* dev, uint32_t index, uint64_t nowUs);
+
+// 遗嘱/上线负载
+size_t deviceBuildPresence(const VirtualDevice* dev, bool online, char* buf, size_t size);
+
+// 连接建立：发布 online，再由调用方订阅控制Topic，最后发布 config/state
+void devicePublishOnline(VirtualDevice* dev, const DeviceSink* sink);
+void devicePublishConfigState(VirtualDevice* dev, const DeviceSink* sink);
+
+// 发布一条遥测 (sensorPayloadBuild)
+void devicePublishTelemetry(VirtualDevice* dev, uint64_t nowUs, const DeviceSink* sink);
+
+// 处理一条下行命令 (dispatchCommand)，返回false表示Topic不识别
+bool deviceHandleCommand(VirtualDevice* dev, uint64_t nowUs, std::string_view topic, std::string_view payload,
+                         const DeviceSink* sink);
+
+// 开始一次火灾脚本：报警 → 灭火 → 解除，已在进行时忽略并返回false
+bool deviceStartFire(VirtualDevice* dev, uint64_t nowUs, const DeviceSink* sink);
+
+// 推进火灾脚本与执行器定时，返回下一次需要调用的时间 (0 表示无)
+uint64_t deviceAdvance(VirtualDevice* dev, uint64_t nowUs, const DeviceSink* sink);
+
+// 按 timestamp 查找发送时刻，找不到返回false
+bool deviceLookupSent(const DeviceSentStamp* history, uint64_t ms, uint64_t* sentUs);
+
+// 解析 device_id 的序号 (DEVICE_ID_PREFIX + 序号)，失败返回 UINT32_MAX
+uint32_t parseDeviceIndex(std::string_view deviceId);
+
+const char* getDeviceFireLevelName(uint8_t level);
+
+#endif
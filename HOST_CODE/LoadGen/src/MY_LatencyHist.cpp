@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <string.h>
+#include "MY_LatencyHist.h"
+
+// ==================== 内部函数 ====================
+
+/**
+ * @brief 数值 → 分桶序号
+ * 小于 2^LATENCY_SUB_BITS 的值一一对应；其余按最高位所在区间 + 其后 LATENCY_SUB_BITS 位分档
+ */
+static uint32_t bucketIndex(uint64_t value) {
+    if (value < LATENCY_SUB_COUNT) return (uint32_t)value;
+
+    uint32_t exponent = 63 - (uint32_t)__builtin_clzll(value);
+    uint32_t sub = (uint32_t)(value >> (exponent - LATENCY_SUB_BITS)) & (LATENCY_SUB_COUNT - 1);
+    return (exponent - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT + sub;
+}
+
+/**
+ * @brief 分桶上界 (含)
+ */
+static uint64_t bucketUpper(uint32_t index) {
+    if (index < LATENCY_SUB_COUNT) return index;
+
+    uint32_t exponent = index / LATENCY_SUB_COUNT + LATENCY_SUB_BITS - 1;
+    uint64_t sub = index % LATENCY_SUB_COUNT;
+    uint64_t width = 1ull << (exponent - LATENCY_SUB_BITS);
+    uint64_t lower = (1ull << exponent) + sub * width;
+    return lower + (width - 1);
+}
+
+// ==================== 接口函数 ====================
+
+void latencyHistReset(LatencyHist* hist) {
+    memset(hist, 0, sizeof(*hist));
+}
+
+void latencyHistRecord(LatencyHist* hist, uint64_t us) {
+    hist->counts[bucketIndex(us)]++;
+    hist->total++;
+    hist->sumUs += us;
+    if (us > hist->maxUs) hist->maxUs = us;
+}
+
+uint64_t latencyHistPercentile(const LatencyHist* hist, double percent) {
+    if (hist->total == 0) return 0;
+
+    uint64_t rank = (uint64_t)(hist->total * percent / 100.0 + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > hist->total) rank = hist->total;
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            uint64_t upper = bucketUpper(i);
+            return upper < hist->maxUs ? upper : hist->maxUs;
+        }
+    }
+    return hist->maxUs;
+}
+
+void latencyHistPrint(const LatencyHist* hist, const char* name) {
+    if (hist->total == 0) {
+        printf("[LOADGEN]   %-10s n=0\n", name);
+        return;
+    }
+    printf("[LOADGEN]   %-10s n=%-9llu avg=%.2fms p50=%.2fms p90=%.2fms p99=%.2fms p99.9=%.2fms max=%.2fms\n",
+           name, (unsigned long long)hist->total,
+           hist->sumUs / (double)hist->total / 1000.0,
+           latencyHistPercentile(hist, 50.0) / 1000.0,
+           latencyHistPercentile(hist, 90.0) / 1000.0,
+           latencyHistPercentile(hist, 99.0) / 1000.0,
+           latencyHistPercentile(hist, 99.9) / 1000.0,
+           hist->maxUs / 1000.0);
+}
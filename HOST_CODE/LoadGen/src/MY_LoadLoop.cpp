@@ -0,0 +1,906 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <queue>
+#include "MY_LoadLoop.h"
+#include "MY_LatencyHist.h"
+#include "MY_VirtualDevice.h"
+#include "MY_MqttWire.h"
+#include "MY_SensorRecord.h"
+
+// ==================== 内部配置 ====================
+#define LOADGEN_TX_MAX_PENDING      (1024 * 1024)   // 单会话待发送上限，超出时丢弃新消息
+#define LOADGEN_RECV_BURST          16              // 单次可读事件最多 recv 次数
+#define LOADGEN_POLL_MAX_MS         100
+#define LOADGEN_DEVICE_START_MS     200             // 设备会话晚于监控会话启动，保证监控先完成订阅
+
+// ==================== 枚举定义 ====================
+
+typedef enum {
+    SESSION_DEVICE = 0,
+    SESSION_MONITOR = 1,
+    SESSION_OPERATOR = 2
+} SessionRole;
+
+typedef enum {
+    SESSION_IDLE = 0,               // 未连接 (等待重连定时器)
+    SESSION_TCP_CONNECTING = 1,     // 非阻塞connect进行中
+    SESSION_MQTT_CONNECTING = 2,    // 已发送CONNECT，等待CONNACK
+    SESSION_READY = 3
+} SessionState;
+
+typedef enum {
+    TIMER_CONNECT = 0,
+    TIMER_TELEMETRY,
+    TIMER_DEVICE,                   // 火灾脚本 / 水泵定时
+    TIMER_PING,                     // 心跳
+    TIMER_CONNECT_TIMEOUT,          // TCP + CONNACK 超时
+    TIMER_FIRE,                     // 随机火灾 (全局)
+    TIMER_COMMAND,                  // 配置命令往返探测 (全局)
+    TIMER_SCRIPT,                   // 脚本步骤 (全局，session 字段为步骤序号)
+    TIMER_REPORT
+} TimerKind;
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    int fd;
+    uint8_t role;                   // SessionRole
+    uint8_t state;                  // SessionState
+    bool writeArmed;                // 已注册 EPOLLOUT
+    uint16_t keepAliveS;
+    uint32_t generation;            // 每次断开+1，用于丢弃过期定时器
+    uint32_t backoffMs;
+    uint64_t connectStartUs;
+    uint64_t disconnectedUs;        // 断开时刻，0 表示未断开过或已恢复
+    uint64_t lastTxUs;
+    uint64_t advanceDueUs;          // 已登记的 TIMER_DEVICE 时间，0 表示无
+    std::vector<uint8_t> rx;
+    size_t rxLen;
+    std::vector<uint8_t> tx;        // 待发送数据 [txOff, tx.size())
+    size_t txOff;
+} LoadSession;
+
+typedef struct {
+    uint64_t dueUs;
+    uint32_t session;
+    uint32_t generation;
+    uint8_t kind;                   // TimerKind
+} LoadTimer;
+
+struct TimerLater {
+    bool operator()(const LoadTimer& a, const LoadTimer& b) const { return a.dueUs > b.dueUs; }
+};
+
+typedef struct {
+    LatencyHist telemetry;          // 设备发布 → 监控收到
+    LatencyHist alarm;              // 报警事件 发布 → 监控收到
+    LatencyHist command;            // 配置命令 发布 → 各设备 config/state 到达监控
+    LatencyHist connect;            // TCP connect → CONNACK
+} LoadHists;
+
+typedef struct {
+    uint64_t published;
+    uint64_t publishedBytes;
+    uint64_t txDropped;
+    uint64_t received;              // 监控会话收到的消息
+    uint64_t unmatched;             // 找不到发送记录的遥测/事件
+    uint64_t connects;
+    uint64_t disconnects;
+    uint64_t connectFailures;
+    uint64_t fires;
+    uint64_t commandsSent;
+    uint64_t commandTimeouts;
+} LoadCounters;
+
+// 配置命令往返探测 (同一时刻只有一条在途，Topic为全机队共享)
+typedef struct {
+    bool active;
+    uint64_t sentUs;
+    uint32_t expected;              // 发送时已连接的设备数
+    uint32_t received;
+    uint32_t nextSprayMs;           // 交替下发的 pump_auto_spray_ms
+} CommandProbe;
+
+typedef struct {
+    const LoadConfig* config;
+    int epfd;
+    struct sockaddr_in broker;
+    uint32_t monitorIndex;
+    uint32_t operatorIndex;
+    std::vector<LoadSession> sessions;      // [0,N) 设备，N 监控，N+1 操作员
+    std::vector<VirtualDevice> devices;
+    std::priority_queue<LoadTimer, std::vector<LoadTimer>, TimerLater> timers;
+    std::vector<uint8_t> scratch;           // PUBLISH 编码缓冲区
+    SensorParser parser;
+    uint64_t rng;
+    uint64_t startUs;
+    uint32_t connectedDevices;
+    CommandProbe probe;
+    LoadCounters counters;
+    LoadCounters lastCounters;              // 上一次打印时的计数，用于计算速率
+    uint64_t lastReportUs;
+    LoadHists interval;
+    LoadHists total;
+} LoadLoop;
+
+// ==================== 内部函数声明 ====================
+static void sessionFail(LoadLoop* loop, uint32_t index);
+static void scheduleDeviceAdvance(LoadLoop* loop, uint32_t index, uint64_t nowUs);
+
+// ==================== 工具函数 ====================
+
+static uint64_t nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// xorshift64*
+static uint64_t nextRandom(LoadLoop* loop) {
+    uint64_t x = loop->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    loop->rng = x;
+    return x * 2685821657736338717ull;
+}
+
+// 指数分布间隔 (泊松过程)
+static uint64_t poissonIntervalUs(LoadLoop* loop, double perSecond) {
+    double u = ((nextRandom(loop) >> 11) + 1) / 9007199254740993.0;
+    return (uint64_t)(-log(u) / perSecond * 1e6);
+}
+
+static void scheduleTimer(LoadLoop* loop, uint64_t dueUs, uint32_t session, uint8_t kind) {
+    uint32_t generation = session < loop->sessions.size() ? loop->sessions[session].generation : 0;
+    loop->timers.push(LoadTimer{dueUs, session, generation, kind});
+}
+
+static void recordLatency(LoadLoop* loop, LatencyHist LoadHists::*hist, uint64_t us) {
+    latencyHistRecord(&(loop->interval.*hist), us);
+    latencyHistRecord(&(loop->total.*hist), us);
+}
+
+// ==================== 发送 ====================
+
+static void updateEpoll(LoadLoop* loop, uint32_t index, bool wantWrite) {
+    LoadSession* session = &loop->sessions[index];
+    if (session->writeArmed == wantWrite) return;
+
+    struct epoll_event ev;
+    ev.events = wantWrite ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    ev.data.u32 = index;
+    epoll_ctl(loop->epfd, EPOLL_CTL_MOD, session->fd, &ev);
+    session->writeArmed = wantWrite;
+}
+
+/**
+ * @brief 发送数据：无积压时直接写Socket，剩余部分进入待发送缓冲区并等待可写
+ * @return false=会话未连接或已断开
+ */
+static bool sessionSend(LoadLoop* loop, uint32_t index, const uint8_t* data, size_t len) {
+    LoadSession* session = &loop->sessions[index];
+    if (session->fd < 0 || session->state < SESSION_MQTT_CONNECTING) return false;
+
+    size_t sent = 0;
+    if (session->txOff == session->tx.size()) {
+        ssize_t n = send(session->fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                sessionFail(loop, index);
+                return false;
+            }
+            n = 0;
+        }
+        sent = (size_t)n;
+    }
+
+    if (sent < len) {
+        // 已写出一部分的报文必须完整排队，否则字节流错位
+        if (sent == 0 && session->tx.size() - session->txOff + len > LOADGEN_TX_MAX_PENDING) {
+            loop->counters.txDropped++;
+            return true;
+        }
+        if (session->txOff > 0 && session->txOff == session->tx.size()) {
+            session->tx.clear();
+            session->txOff = 0;
+        }
+        session->tx.insert(session->tx.end(), data + sent, data + len);
+        updateEpoll(loop, index, true);
+    }
+    session->lastTxUs = nowUs();
+    return true;
+}
+
+static void sessionFlush(LoadLoop* loop, uint32_t index) {
+    LoadSession* session = &loop->sessions[index];
+    while (session->txOff < session->tx.size()) {
+        ssize_t n = send(session->fd, session->tx.data() + session->txOff, session->tx.size() - session->txOff,
+                         MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            sessionFail(loop, index);
+            return;
+        }
+        session->txOff += (size_t)n;
+    }
+    session->tx.clear();
+    session->txOff = 0;
+    updateEpoll(loop, index, false);
+}
+
+static bool sessionPublish(LoadLoop* loop, uint32_t index, const char* topic, std::string_view payload, bool retain) {
+    size_t need = strlen(topic) + payload.size() + MQTT_WIRE_HEADER_MAX + 2;
+    if (loop->scratch.size() < need) loop->scratch.resize(need);
+
+    size_t len = mqttEncodePublish(loop->scratch.data(), loop->scratch.size(), topic, payload, retain);
+    if (len == 0 || !sessionSend(loop, index, loop->scratch.data(), len)) return false;
+
+    loop->counters.published++;
+    loop->counters.publishedBytes += len;
+    return true;
+}
+
+static bool sessionSubscribe(LoadLoop* loop, uint32_t index, uint16_t packetId, const char* topic) {
+    uint8_t buf[128];
+    size_t len = mqttEncodeSubscribe(buf, sizeof(buf), packetId, topic);
+    return len > 0 && sessionSend(loop, index, buf, len);
+}
+
+// 设备输出 → 对应会话的PUBLISH
+typedef struct {
+    LoadLoop* loop;
+    uint32_t index;
+} SinkContext;
+
+static void sinkPublish(void* ctx, const char* topic, std::string_view payload, bool retain) {
+    SinkContext* sink = (SinkContext*)ctx;
+    sessionPublish(sink->loop, sink->index, topic, payload, retain);
+}
+
+// ==================== 连接管理 ====================
+
+static void sessionStartConnect(LoadLoop* loop, uint32_t index) {
+    LoadSession* session = &loop->sessions[index];
+    uint64_t now = nowUs();
+    session->connectStartUs = now;
+    session->state = SESSION_TCP_CONNECTING;
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        sessionFail(loop, index);
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (loop->config->sourceAddrs > 0) {
+        struct sockaddr_in local;
+        memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(0x7F000001u + index % loop->config->sourceAddrs);
+        bind(fd, (struct sockaddr*)&local, sizeof(local));
+    }
+
+    session->fd = fd;
+    if (connect(fd, (struct sockaddr*)&loop->broker, sizeof(loop->broker)) < 0 && errno != EINPROGRESS) {
+        sessionFail(loop, index);
+        return;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.u32 = index;
+    epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev);
+    session->writeArmed = true;
+
+    scheduleTimer(loop, now + (uint64_t)LOADGEN_CONNECT_TIMEOUT_MS * 1000, index, TIMER_CONNECT_TIMEOUT);
+}
+
+/**
+ * @brief 断开会话并按退避时间安排重连 (1s 起指数退避至 60s，与固件一致)
+ */
+static void sessionFail(LoadLoop* loop, uint32_t index) {
+    LoadSession* session = &loop->sessions[index];
+    uint64_t now = nowUs();
+
+    if (session->state == SESSION_READY) {
+        loop->counters.disconnects++;
+        session->disconnectedUs = now;
+        session->backoffMs = LOADGEN_BACKOFF_MIN_MS;
+        if (session->role == SESSION_DEVICE) loop->connectedDevices--;
+    } else if (session->state != SESSION_IDLE) {
+        loop->counters.connectFailures++;
+    }
+
+    if (session->fd >= 0) {
+        close(session->fd);
+        session->fd = -1;
+    }
+    session->state = SESSION_IDLE;
+    session->writeArmed = false;
+    session->generation++;
+    session->advanceDueUs = 0;
+    session->rxLen = 0;
+    session->tx.clear();
+    session->txOff = 0;
+
+    scheduleTimer(loop, now + (uint64_t)session->backoffMs * 1000, index, TIMER_CONNECT);
+    session->backoffMs = session->backoffMs * 2 > LOADGEN_BACKOFF_MAX_MS ? LOADGEN_BACKOFF_MAX_MS : session->backoffMs * 2;
+}
+
+/**
+ * @brief TCP连接完成：发送CONNECT (设备带 retained 的 offline 遗嘱)
+ */
+static void sessionConnected(LoadLoop* loop, uint32_t index) {
+    LoadSession* session = &loop->sessions[index];
+    int err = 0;
+    socklen_t errLen = sizeof(err);
+    if (getsockopt(session->fd, SOL_SOCKET, SO_ERROR, &err, &errLen) < 0 || err != 0) {
+        sessionFail(loop, index);
+        return;
+    }
+
+    session->state = SESSION_MQTT_CONNECTING;
+    uint8_t buf[256];
+    size_t len;
+    if (session->role == SESSION_DEVICE) {
+        VirtualDevice* dev = &loop->devices[index];
+        char will[96];
+        size_t willLen = deviceBuildPresence(dev, false, will, sizeof(will));
+        len = mqttEncodeConnectWill(buf, sizeof(buf), dev->id, session->keepAliveS, DEVICE_TOPIC_STATUS,
+                                    std::string_view(will, willLen), 1, true);
+    } else {
+        char clientId[48];
+        snprintf(clientId, sizeof(clientId), "loadgen_%s_%d",
+                 session->role == SESSION_MONITOR ? "monitor" : "operator", (int)getpid());
+        len = mqttEncodeConnect(buf, sizeof(buf), clientId, session->keepAliveS);
+    }
+
+    updateEpoll(loop, index, false);
+    if (len == 0 || !sessionSend(loop, index, buf, len)) {
+        if (session->fd >= 0) sessionFail(loop, index);
+    }
+}
+
+/**
+ * @brief 收到CONNACK：与固件 connectBroker() 相同的上线顺序
+ *   online (retained) → 订阅控制Topic → config/state (retained)
+ */
+static void sessionReady(LoadLoop* loop, uint32_t index) {
+    LoadSession* session = &loop->sessions[index];
+    uint64_t now = nowUs();
+    uint32_t generation = session->generation;
+
+    session->state = SESSION_READY;
+    session->backoffMs = LOADGEN_BACKOFF_MIN_MS;
+    loop->counters.connects++;
+    recordLatency(loop, &LoadHists::connect, now - session->connectStartUs);
+
+    if (session->role == SESSION_DEVICE) {
+        VirtualDevice* dev = &loop->devices[index];
+        dev->mqttConnectMs = (uint32_t)((now - session->connectStartUs) / 1000);
+        if (session->disconnectedUs != 0) {
+            dev->lastOutageMs = (uint32_t)((now - session->disconnectedUs) / 1000);
+            dev->reconnects++;
+            session->disconnectedUs = 0;
+        }
+        loop->connectedDevices++;
+
+        SinkContext ctx = {loop, index};
+        DeviceSink sink = {sinkPublish, &ctx};
+        devicePublishOnline(dev, &sink);
+        for (int i = 0; i < COMMAND_TOPIC_COUNT; i++) {
+            sessionSubscribe(loop, index, (uint16_t)(i + 1), commandTopicName((CommandTopic)i));
+        }
+        devicePublishConfigState(dev, &sink);
+        if (session->generation != generation) return;      // 发送过程中断开
+
+        // 随机相位，避免所有设备同时发布
+        uint64_t intervalUs = (uint64_t)loop->config->telemetryIntervalMs * 1000;
+        scheduleTimer(loop, now + nextRandom(loop) % intervalUs, index, TIMER_TELEMETRY);
+        scheduleDeviceAdvance(loop, index, now);
+    } else if (session->role == SESSION_MONITOR) {
+        session->disconnectedUs = 0;
+        sessionSubscribe(loop, index, 1, DEVICE_TOPIC_SENSOR);
+        sessionSubscribe(loop, index, 2, DEVICE_TOPIC_ALARM);
+        sessionSubscribe(loop, index, 3, DEVICE_TOPIC_CONFIG_STATE);
+        sessionSubscribe(loop, index, 4, DEVICE_TOPIC_STATUS);
+    } else {
+        session->disconnectedUs = 0;
+    }
+
+    if (session->generation == generation) {
+        scheduleTimer(loop, now + (uint64_t)session->keepAliveS * 500000, index, TIMER_PING);
+    }
+}
+
+// ==================== 接收 ====================
+
+/**
+ * @brief 监控会话：按 device_id + timestamp 找到发送时刻，计算端到端延迟
+ */
+static void monitorHandlePublish(LoadLoop* loop, std::string_view topic, std::string_view payload, uint64_t now) {
+    loop->counters.received++;
+
+    if (topic == DEVICE_TOPIC_CONFIG_STATE) {
+        CommandProbe* probe = &loop->probe;
+        if (probe->active) {
+            recordLatency(loop, &LoadHists::command, now - probe->sentUs);
+            if (++probe->received >= probe->expected) probe->active = false;
+        }
+        return;
+    }
+
+    bool telemetry = (topic == DEVICE_TOPIC_SENSOR);
+    if (!telemetry && topic != DEVICE_TOPIC_ALARM) return;
+
+    SensorRecord record;
+    if (!parseSensorRecord(&loop->parser, payload, &record) ||
+        !recordHas(&record, FIELD_DEVICE_ID) || !recordHas(&record, FIELD_TIMESTAMP)) {
+        loop->counters.unmatched++;
+        return;
+    }
+
+    uint32_t device = parseDeviceIndex(record.deviceId);
+    uint64_t sentUs;
+    if (device >= loop->devices.size()) {
+        loop->counters.unmatched++;
+        return;
+    }
+    const VirtualDevice* dev = &loop->devices[device];
+    if (!deviceLookupSent(telemetry ? dev->telemetrySent : dev->eventSent, record.timestamp, &sentUs)) {
+        loop->counters.unmatched++;
+        return;
+    }
+    recordLatency(loop, telemetry ? &LoadHists::telemetry : &LoadHists::alarm, now - sentUs);
+}
+
+static void handlePacket(LoadLoop* loop, uint32_t index, const MqttPacket* packet) {
+    LoadSession* session = &loop->sessions[index];
+
+    switch (packet->type) {
+        case MQTT_PKT_CONNACK:
+            if (session->state == SESSION_MQTT_CONNECTING && packet->bodyLen >= 2 && packet->body[1] == 0) {
+                sessionReady(loop, index);
+            } else {
+                sessionFail(loop, index);
+            }
+            break;
+
+        case MQTT_PKT_PUBLISH: {
+            std::string_view topic;
+            std::string_view payload;
+            if (!mqttParsePublish(packet, &topic, &payload)) {
+                sessionFail(loop, index);
+                break;
+            }
+            uint64_t now = nowUs();
+            if (session->role == SESSION_DEVICE) {
+                SinkContext ctx = {loop, index};
+                DeviceSink sink = {sinkPublish, &ctx};
+                deviceHandleCommand(&loop->devices[index], now, topic, payload, &sink);
+                scheduleDeviceAdvance(loop, index, now);
+            } else if (session->role == SESSION_MONITOR) {
+                monitorHandlePublish(loop, topic, payload, now);
+            }
+            break;
+        }
+
+        default:
+            break;      // SUBACK / PINGRESP
+    }
+}
+
+static void sessionReadable(LoadLoop* loop, uint32_t index) {
+    LoadSession* session = &loop->sessions[index];
+    uint32_t generation = session->generation;
+
+    for (int burst = 0; burst < LOADGEN_RECV_BURST; burst++) {
+        if (session->rxLen == session->rx.size()) {
+            session->rx.resize(session->rx.size() * 2);
+        }
+        size_t space = session->rx.size() - session->rxLen;
+        ssize_t n = recv(session->fd, session->rx.data() + session->rxLen, space, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            sessionFail(loop, index);
+            return;
+        }
+        if (n < 0) break;
+        session->rxLen += (size_t)n;
+
+        // 批量处理缓冲区中的完整报文
+        size_t offset = 0;
+        MqttPacket packet;
+        for (;;) {
+            MqttParseResult result = mqttParsePacket(session->rx.data() + offset, session->rxLen - offset, &packet);
+            if (result == MQTT_PARSE_INCOMPLETE) break;
+            if (result == MQTT_PARSE_MALFORMED) {
+                sessionFail(loop, index);
+                return;
+            }
+            handlePacket(loop, index, &packet);
+            if (session->generation != generation) return;
+            offset += packet.totalLen;
+        }
+        if (offset > 0) {
+            memmove(session->rx.data(), session->rx.data() + offset, session->rxLen - offset);
+            session->rxLen -= offset;
+        }
+        if ((size_t)n < space) break;       // 已读空
+    }
+}
+
+// ==================== 负载动作 ====================
+
+static void scheduleDeviceAdvance(LoadLoop* loop, uint32_t index, uint64_t now) {
+    LoadSession* session = &loop->sessions[index];
+    SinkContext ctx = {loop, index};
+    DeviceSink sink = {sinkPublish, &ctx};
+    uint64_t next = deviceAdvance(&loop->devices[index], now, &sink);
+    if (next != 0 && (session->advanceDueUs == 0 || next < session->advanceDueUs)) {
+        session->advanceDueUs = next;
+        scheduleTimer(loop, next, index, TIMER_DEVICE);
+    }
+}
+
+static void startFire(LoadLoop* loop, uint32_t index, uint64_t now) {
+    if (loop->sessions[index].state != SESSION_READY) return;
+    SinkContext ctx = {loop, index};
+    DeviceSink sink = {sinkPublish, &ctx};
+    if (deviceStartFire(&loop->devices[index], now, &sink)) {
+        scheduleDeviceAdvance(loop, index, now);
+        loop->counters.fires++;
+    }
+}
+
+static void startRandomFire(LoadLoop* loop, uint64_t now) {
+    if (loop->connectedDevices == 0) return;
+    // 随机选取，未连接时顺延到下一台
+    uint32_t count = (uint32_t)loop->devices.size();
+    uint32_t start = (uint32_t)(nextRandom(loop) % count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = (start + i) % count;
+        if (loop->sessions[index].state == SESSION_READY) {
+            startFire(loop, index, now);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 操作员会话发布命令；配置命令开始一次往返探测
+ */
+static void sendCommand(LoadLoop* loop, const char* topic, std::string_view payload, uint64_t now) {
+    bool config = strcmp(topic, COMMAND_TOPIC_CONFIG) == 0;
+    if (config && loop->probe.active) return;       // 上一条尚未收齐
+    if (!sessionPublish(loop, loop->operatorIndex, topic, payload, false)) return;
+
+    loop->counters.commandsSent++;
+    if (config && loop->connectedDevices > 0) {
+        loop->probe.active = true;
+        loop->probe.sentUs = now;
+        loop->probe.expected = loop->connectedDevices;
+        loop->probe.received = 0;
+    }
+}
+
+static void commandTick(LoadLoop* loop, uint64_t now) {
+    CommandProbe* probe = &loop->probe;
+    if (probe->active && now - probe->sentUs > (uint64_t)LOADGEN_COMMAND_TIMEOUT_MS * 1000) {
+        loop->counters.commandTimeouts++;
+        probe->active = false;
+    }
+    if (probe->active || loop->connectedDevices == 0) return;
+
+    // 在默认值附近交替修改，保证校验通过；2秒内的重复命令会被设备限频拒绝，同样产生 config/state
+    char payload[64];
+    int len = snprintf(payload, sizeof(payload), "{\"pump_auto_spray_ms\":%u}", probe->nextSprayMs);
+    probe->nextSprayMs = probe->nextSprayMs == 5000 ? 4000 : 5000;
+    sendCommand(loop, COMMAND_TOPIC_CONFIG, std::string_view(payload, len), now);
+}
+
+static void runScriptStep(LoadLoop* loop, const ScriptStep* step, uint64_t now) {
+    if (step->action == SCRIPT_COMMAND) {
+        sendCommand(loop, step->topic.c_str(), step->payload, now);
+    } else if (step->device == SCRIPT_DEVICE_ALL) {
+        for (uint32_t i = 0; i < loop->devices.size(); i++) startFire(loop, i, now);
+    } else if (step->device == SCRIPT_DEVICE_RANDOM) {
+        startRandomFire(loop, now);
+    } else if ((uint32_t)step->device < loop->devices.size()) {
+        startFire(loop, (uint32_t)step->device, now);
+    }
+}
+
+// ==================== 状态打印 ====================
+
+static void printReport(LoadLoop* loop, uint64_t now, bool final) {
+    const LoadCounters* c = &loop->counters;
+    const LoadCounters* last = final ? NULL : &loop->lastCounters;
+    double seconds = final ? (now - loop->startUs) / 1e6 : (now - loop->lastReportUs) / 1e6;
+    if (seconds <= 0) seconds = 1e-6;
+
+    uint64_t published = c->published - (last ? last->published : 0);
+    uint64_t bytes = c->publishedBytes - (last ? last->publishedBytes : 0);
+    uint64_t received = c->received - (last ? last->received : 0);
+
+    printf("[LOADGEN] %s t=%.0fs: %u/%zu devices connected, tx %.0f msg/s (%.1f MB/s), monitor rx %.0f msg/s\n",
+           final ? "Summary" : "Report", (now - loop->startUs) / 1e6, loop->connectedDevices, loop->devices.size(),
+           published / seconds, bytes / seconds / 1e6, received / seconds);
+    printf("[LOADGEN]   connects %llu, disconnects %llu, connect failures %llu, fires %llu, commands %llu "
+           "(timeouts %llu), unmatched %llu, tx dropped %llu\n",
+           (unsigned long long)c->connects, (unsigned long long)c->disconnects,
+           (unsigned long long)c->connectFailures, (unsigned long long)c->fires,
+           (unsigned long long)c->commandsSent, (unsigned long long)c->commandTimeouts,
+           (unsigned long long)c->unmatched, (unsigned long long)c->txDropped);
+
+    if (final) {
+        struct timespec cpu;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+        double cpuSeconds = cpu.tv_sec + cpu.tv_nsec / 1e9;
+        printf("[LOADGEN]   cpu %.1fs (%.0f%% of one core)\n", cpuSeconds, cpuSeconds / seconds * 100.0);
+    }
+
+    const LoadHists* hists = final ? &loop->total : &loop->interval;
+    latencyHistPrint(&hists->telemetry, "telemetry");
+    latencyHistPrint(&hists->alarm, "alarm");
+    latencyHistPrint(&hists->command, "command");
+    latencyHistPrint(&hists->connect, "connect");
+    fflush(stdout);
+
+    loop->lastCounters = *c;
+    loop->lastReportUs = now;
+    latencyHistReset(&loop->interval.telemetry);
+    latencyHistReset(&loop->interval.alarm);
+    latencyHistReset(&loop->interval.command);
+    latencyHistReset(&loop->interval.connect);
+}
+
+// ==================== 定时器 ====================
+
+static void handleTimer(LoadLoop* loop, const LoadTimer* timer, uint64_t now) {
+    const LoadConfig* config = loop->config;
+
+    // 全局定时器
+    switch (timer->kind) {
+        case TIMER_FIRE:
+            startRandomFire(loop, now);
+            scheduleTimer(loop, now + poissonIntervalUs(loop, config->firesPerMin / 60.0), UINT32_MAX, TIMER_FIRE);
+            return;
+        case TIMER_COMMAND:
+            commandTick(loop, now);
+            scheduleTimer(loop, now + (uint64_t)(1e6 / config->commandsPerSec), UINT32_MAX, TIMER_COMMAND);
+            return;
+        case TIMER_SCRIPT:
+            runScriptStep(loop, &config->script[timer->session], now);
+            return;
+        case TIMER_REPORT:
+            printReport(loop, now, false);
+            scheduleTimer(loop, now + (uint64_t)config->reportIntervalS * 1000000, UINT32_MAX, TIMER_REPORT);
+            return;
+        default:
+            break;
+    }
+
+    // 会话定时器：断开后生成的过期定时器直接丢弃
+    LoadSession* session = &loop->sessions[timer->session];
+    if (timer->generation != session->generation) return;
+
+    switch (timer->kind) {
+        case TIMER_CONNECT:
+            if (session->state == SESSION_IDLE) sessionStartConnect(loop, timer->session);
+            break;
+
+        case TIMER_TELEMETRY: {
+            if (session->state != SESSION_READY) break;
+            SinkContext ctx = {loop, timer->session};
+            DeviceSink sink = {sinkPublish, &ctx};
+            devicePublishTelemetry(&loop->devices[timer->session], now, &sink);
+
+            // 保持固定相位；落后超过一个周期时重新对齐
+            uint64_t intervalUs = (uint64_t)config->telemetryIntervalMs * 1000;
+            uint64_t next = timer->dueUs + intervalUs;
+            if (next <= now) next = now + intervalUs;
+            scheduleTimer(loop, next, timer->session, TIMER_TELEMETRY);
+            break;
+        }
+
+        case TIMER_DEVICE:
+            if (timer->dueUs != session->advanceDueUs) break;
+            session->advanceDueUs = 0;
+            if (session->state == SESSION_READY) scheduleDeviceAdvance(loop, timer->session, now);
+            break;
+
+        case TIMER_CONNECT_TIMEOUT:
+            if (session->state != SESSION_READY) sessionFail(loop, timer->session);
+            break;
+
+        case TIMER_PING: {
+            if (session->state != SESSION_READY) break;
+            uint64_t halfUs = (uint64_t)session->keepAliveS * 500000;
+            if (now - session->lastTxUs >= halfUs) {
+                uint8_t buf[2];
+                sessionSend(loop, timer->session, buf, mqttEncodePingreq(buf, sizeof(buf)));
+            }
+            if (session->generation == timer->generation) {
+                scheduleTimer(loop, now + halfUs, timer->session, TIMER_PING);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// ==================== 初始化 ====================
+
+static bool resolveBroker(const LoadConfig* config, struct sockaddr_in* addr) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* result = NULL;
+    if (getaddrinfo(config->host.c_str(), NULL, &hints, &result) != 0 || result == NULL) {
+        printf("[LOADGEN] Cannot resolve %s\n", config->host.c_str());
+        return false;
+    }
+    memcpy(addr, result->ai_addr, sizeof(*addr));
+    addr->sin_port = htons(config->port);
+    freeaddrinfo(result);
+    return true;
+}
+
+static void initSession(LoadSession* session, uint8_t role, uint16_t keepAliveS, size_t rxSize) {
+    session->fd = -1;
+    session->role = role;
+    session->state = SESSION_IDLE;
+    session->writeArmed = false;
+    session->keepAliveS = keepAliveS;
+    session->generation = 0;
+    session->backoffMs = LOADGEN_BACKOFF_MIN_MS;
+    session->connectStartUs = 0;
+    session->disconnectedUs = 0;
+    session->lastTxUs = 0;
+    session->advanceDueUs = 0;
+    session->rx.resize(rxSize);
+    session->rxLen = 0;
+    session->txOff = 0;
+}
+
+// ==================== 接口函数 ====================
+
+/**
+ * @brief 运行负载
+ *
+ * 监控与操作员会话先连接，设备会话按 rampPerSec 依次发起连接；
+ * 之后全部由 epoll 事件与定时器驱动，单线程无锁
+ */
+bool loadLoopRun(const LoadConfig* config, volatile sig_atomic_t* running) {
+    LoadLoop* loop = new LoadLoop();
+    loop->config = config;
+    if (!resolveBroker(config, &loop->broker)) {
+        delete loop;
+        return false;
+    }
+    loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epfd < 0) {
+        printf("[LOADGEN] epoll_create1 failed: %s\n", strerror(errno));
+        delete loop;
+        return false;
+    }
+
+    uint64_t start = nowUs();
+    uint32_t count = config->devices;
+    loop->startUs = start;
+    loop->lastReportUs = start;
+    loop->rng = start | 1;
+    loop->probe.nextSprayMs = 4000;
+    loop->monitorIndex = count;
+    loop->operatorIndex = count + 1;
+    loop->scratch.resize(DEVICE_PAYLOAD_SIZE + 256);
+
+    // 遥测间隔大于固件心跳的一半时放宽 keepalive，避免纯心跳流量
+    uint32_t keepAliveS = DEVICE_KEEPALIVE_S;
+    if (config->telemetryIntervalMs * 2 / 1000 > keepAliveS) keepAliveS = config->telemetryIntervalMs * 2 / 1000;
+
+    loop->devices.resize(count);
+    loop->sessions.resize(count + 2);
+    for (uint32_t i = 0; i < count; i++) {
+        deviceInit(&loop->devices[i], i, start);
+        initSession(&loop->sessions[i], SESSION_DEVICE, (uint16_t)keepAliveS, LOADGEN_RX_INITIAL);
+    }
+    initSession(&loop->sessions[loop->monitorIndex], SESSION_MONITOR, DEVICE_KEEPALIVE_S, LOADGEN_MONITOR_RX_INITIAL);
+    initSession(&loop->sessions[loop->operatorIndex], SESSION_OPERATOR, DEVICE_KEEPALIVE_S, LOADGEN_RX_INITIAL);
+
+    // 连接爬坡
+    scheduleTimer(loop, start, loop->monitorIndex, TIMER_CONNECT);
+    scheduleTimer(loop, start, loop->operatorIndex, TIMER_CONNECT);
+    uint64_t rampStart = start + LOADGEN_DEVICE_START_MS * 1000;
+    for (uint32_t i = 0; i < count; i++) {
+        scheduleTimer(loop, rampStart + (uint64_t)i * 1000000 / config->rampPerSec, i, TIMER_CONNECT);
+    }
+
+    if (config->firesPerMin > 0) {
+        scheduleTimer(loop, rampStart + poissonIntervalUs(loop, config->firesPerMin / 60.0), UINT32_MAX, TIMER_FIRE);
+    }
+    if (config->commandsPerSec > 0) {
+        scheduleTimer(loop, rampStart + (uint64_t)(1e6 / config->commandsPerSec), UINT32_MAX, TIMER_COMMAND);
+    }
+    for (size_t i = 0; i < config->script.size(); i++) {
+        scheduleTimer(loop, start + config->script[i].atMs * 1000, (uint32_t)i, TIMER_SCRIPT);
+    }
+    scheduleTimer(loop, start + (uint64_t)config->reportIntervalS * 1000000, UINT32_MAX, TIMER_REPORT);
+
+    uint64_t endUs = config->durationS > 0 ? start + (uint64_t)config->durationS * 1000000 : 0;
+    struct epoll_event events[LOADGEN_EPOLL_EVENTS];
+
+    while (*running) {
+        uint64_t now = nowUs();
+        if (endUs != 0 && now >= endUs) break;
+
+        int timeoutMs = LOADGEN_POLL_MAX_MS;
+        if (!loop->timers.empty()) {
+            uint64_t due = loop->timers.top().dueUs;
+            int64_t waitMs = due > now ? (int64_t)((due - now + 999) / 1000) : 0;
+            if (waitMs < timeoutMs) timeoutMs = (int)waitMs;
+        }
+
+        int n = epoll_wait(loop->epfd, events, LOADGEN_EPOLL_EVENTS, timeoutMs);
+        if (n < 0 && errno != EINTR) {
+            printf("[LOADGEN] epoll_wait failed: %s\n", strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            uint32_t index = events[i].data.u32;
+            LoadSession* session = &loop->sessions[index];
+            uint32_t generation = session->generation;
+
+            if (session->state == SESSION_TCP_CONNECTING) {
+                if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) sessionConnected(loop, index);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                sessionReadable(loop, index);
+            }
+            if ((events[i].events & EPOLLOUT) && session->generation == generation && session->fd >= 0) {
+                sessionFlush(loop, index);
+            }
+        }
+
+        now = nowUs();
+        while (!loop->timers.empty() && loop->timers.top().dueUs <= now) {
+            LoadTimer timer = loop->timers.top();
+            loop->timers.pop();
+            handleTimer(loop, &timer, now);
+        }
+    }
+
+    printReport(loop, nowUs(), true);
+
+    // 正常断开：Broker不发布遗嘱
+    uint8_t buf[2];
+    size_t len = mqttEncodeDisconnect(buf, sizeof(buf));
+    for (LoadSession& session : loop->sessions) {
+        if (session.fd >= 0) {
+            if (session.state == SESSION_READY) send(session.fd, buf, len, MSG_NOSIGNAL);
+            close(session.fd);
+        }
+    }
+    close(loop->epfd);
+    delete loop;
+    return true;
+}
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "MY_LoadScript.h"
+
+// ==================== 内部函数 ====================
+
+// 取下一个以空白分隔的词，返回词首，*rest 指向其后
+static const char* nextWord(const char* p, size_t* len, const char** rest) {
+    while (*p == ' ' || *p == '\t') p++;
+    const char* start = p;
+    while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+    *len = (size_t)(p - start);
+    *rest = p;
+    return start;
+}
+
+static bool wordIs(const char* word, size_t len, const char* expected) {
+    return len == strlen(expected) && memcmp(word, expected, len) == 0;
+}
+
+/**
+ * @brief 解析一行，空行与注释返回true且不输出步骤
+ */
+static bool parseLine(const char* line, ScriptStep* step, bool* hasStep) {
+    *hasStep = false;
+    size_t len;
+    const char* rest;
+    const char* word = nextWord(line, &len, &rest);
+    if (len == 0 || word[0] == '#') return true;
+
+    char* end;
+    double seconds = strtod(word, &end);
+    if (end != word + len || seconds < 0) return false;
+    step->atMs = (uint64_t)(seconds * 1000.0 + 0.5);
+
+    word = nextWord(rest, &len, &rest);
+    if (wordIs(word, len, "fire")) {
+        step->action = SCRIPT_FIRE;
+        word = nextWord(rest, &len, &rest);
+        if (wordIs(word, len, "*")) {
+            step->device = SCRIPT_DEVICE_ALL;
+        } else if (wordIs(word, len, "random")) {
+            step->device = SCRIPT_DEVICE_RANDOM;
+        } else {
+            long device = strtol(word, &end, 10);
+            if (len == 0 || end != word + len || device < 0) return false;
+            step->device = (int32_t)device;
+        }
+    } else if (wordIs(word, len, "command")) {
+        step->action = SCRIPT_COMMAND;
+        word = nextWord(rest, &len, &rest);
+        if (len == 0) return false;
+        step->topic.assign(word, len);
+
+        while (*rest == ' ' || *rest == '\t') rest++;
+        size_t payloadLen = strcspn(rest, "\r\n");
+        if (payloadLen == 0) return false;
+        step->payload.assign(rest, payloadLen);
+    } else {
+        return false;
+    }
+
+    *hasStep = true;
+    return true;
+}
+
+// ==================== 接口函数 ====================
+
+bool loadScriptFile(const char* path, std::vector<ScriptStep>* steps) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("[SCRIPT] Cannot open %s\n", path);
+        return false;
+    }
+
+    char line[1024];
+    int lineNo = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNo++;
+        ScriptStep step;
+        bool hasStep;
+        if (!parseLine(line, &step, &hasStep)) {
+            printf("[SCRIPT] %s:%d: invalid step\n", path, lineNo);
+            ok = false;
+            break;
+        }
+        if (hasStep) steps->push_back(step);
+    }
+    fclose(file);
+
+    std::stable_sort(steps->begin(), steps->end(),
+                     [](const ScriptStep& a, const ScriptStep& b) { return a.atMs < b.atMs; });
+    return ok;
+}
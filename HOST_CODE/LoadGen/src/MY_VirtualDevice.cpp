@@ -0,0 +1,368 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "MY_VirtualDevice.h"
+#include "MY_SensorPayload.h"
+
+// ==================== 内部函数 ====================
+
+static uint64_t deviceMillis(const VirtualDevice* dev, uint64_t nowUs) {
+    return (nowUs - dev->bootUs) / 1000;
+}
+
+static void recordSent(DeviceSentStamp* history, uint8_t* head, uint64_t ms, uint64_t us) {
+    history[*head].ms = ms;
+    history[*head].us = us;
+    *head = (uint8_t)((*head + 1) % DEVICE_SENT_HISTORY);
+}
+
+// xorshift32，读数抖动用
+static float jitter(VirtualDevice* dev, float amplitude) {
+    uint32_t x = dev->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    dev->seed = x;
+    return ((x & 0xFFFF) / 65535.0f * 2.0f - 1.0f) * amplitude;
+}
+
+/**
+ * @brief 报警事件 (与固件 queueAlarmEvent 字段一致)
+ */
+static void publishAlarmEvent(VirtualDevice* dev, uint64_t nowUs, const char* source, const char* event,
+                              const char* zone, const DeviceSink* sink) {
+    char buf[256];
+    uint64_t ms = deviceMillis(dev, nowUs);
+    int len;
+    if (zone != NULL) {
+        len = snprintf(buf, sizeof(buf),
+                       "{\"device_id\":\"%s\",\"source\":\"%s\",\"event\":\"%s\",\"zone\":\"%s\",\"timestamp\":%llu}",
+                       dev->id, source, event, zone, (unsigned long long)ms);
+    } else {
+        len = snprintf(buf, sizeof(buf),
+                       "{\"device_id\":\"%s\",\"source\":\"%s\",\"event\":\"%s\",\"timestamp\":%llu}",
+                       dev->id, source, event, (unsigned long long)ms);
+    }
+    if (len <= 0 || len >= (int)sizeof(buf)) return;
+
+    recordSent(dev->eventSent, &dev->eventHead, ms, nowUs);
+    sink->publish(sink->ctx, DEVICE_TOPIC_ALARM, std::string_view(buf, len), false);
+}
+
+static void pumpSpray(VirtualDevice* dev, uint64_t nowUs, uint32_t onMs) {
+    if (onMs > dev->config.pumpMaxDurationMs) onMs = dev->config.pumpMaxDurationMs;
+    dev->pumpOffUs = nowUs + (uint64_t)onMs * 1000;
+}
+
+/**
+ * @brief 自动模式下的执行器跟随火灾等级 (风扇/蜂鸣器在报警时开启，灭火时水泵喷水)
+ */
+static void applyAutoOutputs(VirtualDevice* dev, uint64_t nowUs, bool levelRaised, const DeviceSink* sink) {
+    bool fire = dev->fireLevel >= DEVICE_FIRE_ALARM;
+    if (dev->fanAuto) dev->fanOn = fire;
+    if (dev->buzzerAuto) {
+        dev->buzzerOn = fire;
+        dev->buzzerPattern = !fire ? "none" : (dev->fireLevel == DEVICE_FIRE_SUPPRESS ? "evacuation" : "smoke");
+    }
+    if (dev->pumpAuto && levelRaised && dev->fireLevel == DEVICE_FIRE_SUPPRESS && dev->pumpOffUs == 0) {
+        pumpSpray(dev, nowUs, dev->config.pumpAutoSprayMs);
+        publishAlarmEvent(dev, nowUs, "pump", "spray_started", NULL, sink);
+    }
+}
+
+static void setFireLevel(VirtualDevice* dev, uint64_t nowUs, uint8_t level, const DeviceSink* sink) {
+    static const float scores[] = {0.05f, 0.62f, 0.88f};
+    uint8_t previous = dev->fireLevel;
+    if (level == previous) return;
+
+    dev->fireLevel = level;
+    dev->fireScore = scores[level];
+    publishAlarmEvent(dev, nowUs, "fusion", getDeviceFireLevelName(level), DEVICE_ZONE_NAME, sink);
+    if (previous == DEVICE_FIRE_NONE) {
+        publishAlarmEvent(dev, nowUs, "fan", "fire_detected", NULL, sink);
+    } else if (level == DEVICE_FIRE_NONE) {
+        publishAlarmEvent(dev, nowUs, "fan", "environment_safe", NULL, sink);
+    }
+    applyAutoOutputs(dev, nowUs, level > previous, sink);
+}
+
+// ==================== 初始化 ====================
+
+void deviceInit(VirtualDevice* dev, uint32_t index, uint64_t nowUs) {
+    memset(dev, 0, sizeof(*dev));
+    dev->index = index;
+    snprintf(dev->id, sizeof(dev->id), DEVICE_ID_PREFIX "%05u", index);
+    dev->bootUs = nowUs;
+    dev->seed = index * 2654435761u + 1;
+
+    dev->fanAuto = true;
+    dev->pumpAuto = true;
+    dev->buzzerAuto = true;
+    dev->buzzerPattern = "none";
+    dev->fireScore = 0.05f;
+    configCoreInit(&dev->configCore);
+    configCoreLoadDefaults(&dev->config);
+}
+
+// ==================== 上线与配置状态 ====================
+
+size_t deviceBuildPresence(const VirtualDevice* dev, bool online, char* buf, size_t size) {
+    int len = snprintf(buf, size, "{\"device_id\":\"%s\",\"status\":\"%s\"}", dev->id, online ? "online" : "offline");
+    return (len > 0 && (size_t)len < size) ? (size_t)len : 0;
+}
+
+void devicePublishOnline(VirtualDevice* dev, const DeviceSink* sink) {
+    char buf[96];
+    size_t len = deviceBuildPresence(dev, true, buf, sizeof(buf));
+    if (len > 0) {
+        sink->publish(sink->ctx, DEVICE_TOPIC_STATUS, std::string_view(buf, len), true);
+    }
+}
+
+/**
+ * @brief 发布 config/state (configCoreBuildState，未同步时钟，epoch_us 为0)
+ */
+void devicePublishConfigState(VirtualDevice* dev, const DeviceSink* sink) {
+    char buf[CONFIG_STATE_SIZE];
+    size_t len = configCoreBuildState(&dev->config, dev->configCore.rejects, 0, buf, sizeof(buf));
+    if (len < sizeof(buf)) {
+        sink->publish(sink->ctx, DEVICE_TOPIC_CONFIG_STATE, std::string_view(buf, len), true);
+    }
+}
+
+// ==================== 遥测 ====================
+
+/**
+ * @brief 发布一条遥测 (sensorPayloadBuild，单区)
+ * 没有对应硬件的字段取空闲值：K230未连接、DSP窗口未采满、电源管理关闭
+ */
+void devicePublishTelemetry(VirtualDevice* dev, uint64_t nowUs, const DeviceSink* sink) {
+    static const float tempRise[] = {0.0f, 26.0f, 38.0f};
+    static const float smokeRise[] = {0.0f, 30.0f, 48.0f};
+
+    uint8_t level = dev->fireLevel;
+    float temperature = 24.0f + dev->index % 7 + tempRise[level] + jitter(dev, 0.3f);
+    float humidity = 45.0f + jitter(dev, 1.0f);
+    float smoke = 4.0f + dev->index % 5 + smokeRise[level] + jitter(dev, 0.5f);
+    bool smokeAlarm = smoke >= dev->config.smokeAlarmThreshold;
+    bool pumpOn = dev->pumpOffUs != 0;
+    bool fire = level >= DEVICE_FIRE_ALARM;
+    const char* levelName = getDeviceFireLevelName(level);
+    uint64_t ms = deviceMillis(dev, nowUs);
+
+    SensorPayloadZone zone;
+    memset(&zone, 0, sizeof(zone));
+    zone.name = DEVICE_ZONE_NAME;
+    zone.temperature = temperature;
+    zone.humidity = humidity;
+    zone.smokeLevel = smoke;
+    zone.smokeAlarm = smokeAlarm;
+    zone.fireScore = dev->fireScore;
+    zone.fireLevel = levelName;
+    zone.fan = dev->fanOn;
+    zone.valve = pumpOn;
+
+    SensorPayload p;
+    memset(&p, 0, sizeof(p));
+    p.deviceId = dev->id;
+    p.temperature = temperature;
+    p.humidity = humidity;
+    p.smokeLevel = smoke;
+    p.smokeAlarm = smokeAlarm;
+
+    p.fanState = dev->fanOn ? "on" : "off";
+    p.fanMode = dev->fanAuto ? "auto" : "manual";
+    p.fanSpeed = dev->fanOn ? 100 : 0;
+
+    p.pumpState = pumpOn ? "on" : "off";
+    p.pumpMode = dev->pumpAuto ? "auto" : "manual";
+    p.pumpRelay = pumpOn;
+    p.pumpPulsesLeft = pumpOn ? 1 : 0;
+    p.pumpDutyCapMs = (uint32_t)((uint64_t)dev->config.pumpDutyWindowMs * dev->config.pumpDutyPercent / 100);
+    p.pumpDutyBudgetMs = p.pumpDutyCapMs;
+
+    p.k230Fire = "none";
+    p.k230Link = "waiting";
+    p.k230Model = "";
+    p.k230HeartbeatAgeMs = -1;
+    p.k230ReportMode = "idle";
+    p.k230ReportMs = -1;
+    p.k230Baud = 115200;
+
+    p.fireScore = dev->fireScore;
+    p.fireLevel = levelName;
+    p.fireZone = DEVICE_ZONE_NAME;
+    p.fireEvidence[FUSION_SRC_SMOKE] = fire ? 0.9f : 0.0f;
+    p.fireEvidence[FUSION_SRC_TEMP] = fire ? 0.7f : 0.0f;
+    p.fireEvidence[FUSION_SRC_MQ2_DO] = smokeAlarm ? 1.0f : 0.0f;
+
+    p.buzzerState = dev->buzzerOn ? "on" : "off";
+    p.buzzerMode = dev->buzzerAuto ? "auto" : "manual";
+    p.buzzerPattern = dev->buzzerPattern;
+
+    p.dspPipeline = "q15";
+    p.zones = &zone;
+    p.zoneCount = 1;
+
+    p.powerMode = "off";
+    p.powerFullPct = 100;
+    p.resetReason = "power_on";
+    p.fwVersion = DEVICE_FW_VERSION;
+    p.otaState = "idle";
+    p.otaBoot = "none";
+
+    p.heapFree = 180000;
+    p.heapLargest = 110000;
+    p.heapMinFree = 170000;
+
+    p.timestamp = ms;
+    p.clockUncertaintyUs = -1;
+
+    p.mqttReconnects = dev->reconnects;
+    p.mqttConnectMs = dev->mqttConnectMs;
+    p.lastOutageMs = dev->lastOutageMs;
+
+    char buf[DEVICE_PAYLOAD_SIZE];
+    size_t len = sensorPayloadBuild(&p, buf, sizeof(buf));
+    if (len >= sizeof(buf)) return;
+
+    recordSent(dev->telemetrySent, &dev->telemetryHead, ms, nowUs);
+    sink->publish(sink->ctx, DEVICE_TOPIC_SENSOR, std::string_view(buf, len), false);
+}
+
+// ==================== 命令处理 ====================
+
+/**
+ * @brief 按Topic分发下行命令 (解码同固件 dispatchCommand，执行作用于虚拟执行器)
+ * 配置命令无论成功与否都会改变修订号或拒绝计数，因此总会重新发布 config/state
+ */
+bool deviceHandleCommand(VirtualDevice* dev, uint64_t nowUs, std::string_view topic, std::string_view payload,
+                         const DeviceSink* sink) {
+    char name[64];
+    if (topic.size() >= sizeof(name)) return false;
+    memcpy(name, topic.data(), topic.size());
+    name[topic.size()] = '\0';
+
+    ControlCommand command;
+    if (!commandDecode(name, payload.data(), payload.size(), &command)) return false;
+
+    if (command.topic == COMMAND_CONFIG) {
+        SystemConfig next;
+        if (configCoreUpdate(&dev->configCore, &dev->config, payload.data(), payload.size(),
+                             (uint32_t)deviceMillis(dev, nowUs), &next, NULL) != CONFIG_UPDATE_REJECTED) {
+            dev->config = next;
+        }
+        devicePublishConfigState(dev, sink);
+        return true;
+    }
+    if (command.action == COMMAND_ACTION_NONE) return true;
+
+    // 自动模式下忽略控制命令
+    if ((command.topic == COMMAND_FAN_CONTROL && dev->fanAuto) ||
+        (command.topic == COMMAND_PUMP_CONTROL && dev->pumpAuto) ||
+        (command.topic == COMMAND_BUZZER_CONTROL && dev->buzzerAuto)) {
+        return true;
+    }
+
+    bool on = command.action == COMMAND_ACTION_ON;
+    bool automatic = command.action == COMMAND_ACTION_AUTO;
+    switch (command.topic) {
+        case COMMAND_FAN_CONTROL:
+            dev->fanOn = on;
+            break;
+        case COMMAND_FAN_MODE:
+            dev->fanAuto = automatic;
+            applyAutoOutputs(dev, nowUs, false, sink);
+            break;
+        case COMMAND_PUMP_CONTROL:
+            if (on) pumpSpray(dev, nowUs, command.onMs);
+            else dev->pumpOffUs = 0;
+            break;
+        case COMMAND_PUMP_MODE:
+            dev->pumpAuto = automatic;
+            break;
+        case COMMAND_BUZZER_CONTROL:
+            dev->buzzerOn = on;
+            if (!on) dev->buzzerPattern = "none";
+            else if (command.pattern == COMMAND_PATTERN_SMOKE) dev->buzzerPattern = "smoke";
+            else if (command.pattern == COMMAND_PATTERN_CONTINUOUS) dev->buzzerPattern = "continuous";
+            else dev->buzzerPattern = "evacuation";
+            break;
+        case COMMAND_BUZZER_MODE:
+            dev->buzzerAuto = automatic;
+            applyAutoOutputs(dev, nowUs, false, sink);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+// ==================== 火灾脚本 ====================
+
+bool deviceStartFire(VirtualDevice* dev, uint64_t nowUs, const DeviceSink* sink) {
+    if (dev->fireNextUs != 0) return false;
+    setFireLevel(dev, nowUs, DEVICE_FIRE_ALARM, sink);
+    dev->fireNextUs = nowUs + (uint64_t)DEVICE_FIRE_SUPPRESS_MS * 1000;
+    return true;
+}
+
+/**
+ * @brief 推进火灾脚本 (报警 → 灭火 → 解除) 与水泵定时
+ */
+uint64_t deviceAdvance(VirtualDevice* dev, uint64_t nowUs, const DeviceSink* sink) {
+    if (dev->pumpOffUs != 0 && nowUs >= dev->pumpOffUs) {
+        dev->pumpOffUs = 0;
+    }
+
+    if (dev->fireNextUs != 0 && nowUs >= dev->fireNextUs) {
+        if (dev->fireLevel == DEVICE_FIRE_ALARM) {
+            setFireLevel(dev, nowUs, DEVICE_FIRE_SUPPRESS, sink);
+            dev->fireNextUs = nowUs + (uint64_t)DEVICE_FIRE_CLEAR_MS * 1000;
+        } else {
+            setFireLevel(dev, nowUs, DEVICE_FIRE_NONE, sink);
+            dev->fireNextUs = 0;
+        }
+    }
+
+    uint64_t next = dev->fireNextUs;
+    if (dev->pumpOffUs != 0 && (next == 0 || dev->pumpOffUs < next)) next = dev->pumpOffUs;
+    return next;
+}
+
+// ==================== 工具函数 ====================
+
+bool deviceLookupSent(const DeviceSentStamp* history, uint64_t ms, uint64_t* sentUs) {
+    for (int i = 0; i < DEVICE_SENT_HISTORY; i++) {
+        if (history[i].us != 0 && history[i].ms == ms) {
+            *sentUs = history[i].us;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t parseDeviceIndex(std::string_view deviceId) {
+    static const size_t prefixLen = sizeof(DEVICE_ID_PREFIX) - 1;
+    if (deviceId.size() <= prefixLen || deviceId.size() > prefixLen + 9 ||
+        deviceId.compare(0, prefixLen, DEVICE_ID_PREFIX) != 0) {
+        return UINT32_MAX;
+    }
+
+    uint32_t index = 0;
+    for (size_t i = prefixLen; i < deviceId.size(); i++) {
+        char c = deviceId[i];
+        if (c < '0' || c > '9') return UINT32_MAX;
+        index = index * 10 + (uint32_t)(c - '0');
+    }
+    return index;
+}
+
+const char* getDeviceFireLevelName(uint8_t level) {
+    switch (level) {
+        case DEVICE_FIRE_ALARM: return "alarm";
+        case DEVICE_FIRE_SUPPRESS: return "suppress";
+        default: return "none";
+    }
+}
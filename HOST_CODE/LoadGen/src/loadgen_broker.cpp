@@ -0,0 +1,343 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MY_MqttWire.h"
+
+/*
+ * 本地Broker替身 (只用于在没有 mosquitto 的环境里验证负载生成器)
+ *   单线程 epoll；QoS 0；Topic 精确匹配 (不支持通配符)；
+ *   支持 retained 消息与遗嘱 (非正常断开时发布)
+ *   不是通用Broker，测得的延迟不能代表生产Broker
+ */
+
+// ==================== 配置 ====================
+#define BROKER_DEFAULT_PORT         1883
+#define BROKER_EPOLL_EVENTS         1024
+#define BROKER_RX_INITIAL           4096
+#define BROKER_TX_MAX_PENDING       (8 * 1024 * 1024)   // 慢订阅者的待发送上限，超出时丢弃
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    int fd;
+    bool connected;                 // 已收到CONNECT
+    bool writeArmed;
+    std::vector<uint8_t> rx;
+    size_t rxLen;
+    std::vector<uint8_t> tx;
+    size_t txOff;
+    std::vector<std::string> topics;
+    std::string willTopic;          // 为空表示无遗嘱
+    std::string willPayload;
+    bool willRetain;
+} BrokerClient;
+
+static volatile sig_atomic_t running = 1;
+static int epfd = -1;
+static std::vector<BrokerClient*> clients;                      // 按fd索引
+static std::unordered_map<std::string, std::vector<int>> subscriptions;
+static std::unordered_map<std::string, std::string> retained;
+static uint64_t routed = 0;
+static uint64_t dropped = 0;
+
+static void handleSignal(int) {
+    running = 0;
+}
+
+// ==================== 发送 ====================
+
+static void armWrite(BrokerClient* client, bool want) {
+    if (client->writeArmed == want) return;
+    struct epoll_event ev;
+    ev.events = want ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    ev.data.fd = client->fd;
+    epoll_ctl(epfd, EPOLL_CTL_MOD, client->fd, &ev);
+    client->writeArmed = want;
+}
+
+static void clientSend(BrokerClient* client, const uint8_t* data, size_t len) {
+    size_t sent = 0;
+    if (client->txOff == client->tx.size()) {
+        ssize_t n = send(client->fd, data, len, MSG_NOSIGNAL);
+        sent = n > 0 ? (size_t)n : 0;
+    }
+    if (sent < len) {
+        if (sent == 0 && client->tx.size() - client->txOff + len > BROKER_TX_MAX_PENDING) {
+            dropped++;
+            return;
+        }
+        client->tx.insert(client->tx.end(), data + sent, data + len);
+        armWrite(client, true);
+    }
+}
+
+static void clientFlush(BrokerClient* client) {
+    while (client->txOff < client->tx.size()) {
+        ssize_t n = send(client->fd, client->tx.data() + client->txOff, client->tx.size() - client->txOff, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        client->txOff += (size_t)n;
+    }
+    client->tx.clear();
+    client->txOff = 0;
+    armWrite(client, false);
+}
+
+/**
+ * @brief 按Topic转发给全部订阅者 (报文只编码一次)
+ */
+static void route(const std::string& topic, std::string_view payload, bool retain) {
+    if (retain) {
+        if (payload.empty()) retained.erase(topic);
+        else retained[topic] = std::string(payload);
+    }
+
+    auto it = subscriptions.find(topic);
+    if (it == subscriptions.end() || it->second.empty()) return;
+
+    std::vector<uint8_t> packet(topic.size() + payload.size() + MQTT_WIRE_HEADER_MAX + 2);
+    size_t len = mqttEncodePublish(packet.data(), packet.size(), topic, payload, false);
+    for (int fd : it->second) {
+        clientSend(clients[fd], packet.data(), len);
+        routed++;
+    }
+}
+
+// ==================== 连接管理 ====================
+
+static void closeClient(BrokerClient* client, bool publishWill) {
+    if (publishWill && !client->willTopic.empty()) {
+        route(client->willTopic, client->willPayload, client->willRetain);
+    }
+    for (const std::string& topic : client->topics) {
+        std::vector<int>& fds = subscriptions[topic];
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (fds[i] == client->fd) {
+                fds[i] = fds.back();
+                fds.pop_back();
+                break;
+            }
+        }
+    }
+    close(client->fd);
+    clients[client->fd] = NULL;
+    delete client;
+}
+
+static uint16_t readU16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief 解析CONNECT中的遗嘱字段 (忽略用户名/密码)
+ */
+static bool handleConnect(BrokerClient* client, const MqttPacket* packet) {
+    const uint8_t* p = packet->body;
+    size_t len = packet->bodyLen;
+    if (len < 12) return false;
+
+    size_t protoLen = readU16(p);
+    size_t pos = 2 + protoLen;
+    if (pos + 4 > len) return false;
+    uint8_t flags = p[pos + 1];
+    pos += 4;
+
+    // Client ID
+    if (pos + 2 > len) return false;
+    pos += 2 + readU16(p + pos);
+
+    if (flags & 0x04) {
+        if (pos + 2 > len) return false;
+        size_t topicLen = readU16(p + pos);
+        if (pos + 2 + topicLen + 2 > len) return false;
+        client->willTopic.assign((const char*)p + pos + 2, topicLen);
+        pos += 2 + topicLen;
+        size_t payloadLen = readU16(p + pos);
+        if (pos + 2 + payloadLen > len) return false;
+        client->willPayload.assign((const char*)p + pos + 2, payloadLen);
+        client->willRetain = (flags & 0x20) != 0;
+    }
+
+    client->connected = true;
+    uint8_t buf[4];
+    clientSend(client, buf, mqttEncodeConnack(buf, sizeof(buf), 0));
+    return true;
+}
+
+/**
+ * @return false=应断开连接
+ */
+static bool handlePacket(BrokerClient* client, const MqttPacket* packet, bool* graceful) {
+    if (!client->connected && packet->type != MQTT_PKT_CONNECT) return false;
+
+    switch (packet->type) {
+        case MQTT_PKT_CONNECT:
+            return handleConnect(client, packet);
+
+        case MQTT_PKT_PUBLISH: {
+            std::string_view topic;
+            std::string_view payload;
+            if (!mqttParsePublish(packet, &topic, &payload)) return false;
+            route(std::string(topic), payload, (packet->flags & 0x01) != 0);
+            return true;
+        }
+
+        case MQTT_PKT_SUBSCRIBE: {
+            uint16_t packetId;
+            std::string_view topicView;
+            if (!mqttParseSubscribe(packet, &packetId, &topicView)) return false;
+            std::string topic(topicView);
+            subscriptions[topic].push_back(client->fd);
+            client->topics.push_back(topic);
+
+            uint8_t buf[8];
+            clientSend(client, buf, mqttEncodeSuback(buf, sizeof(buf), packetId));
+
+            auto it = retained.find(topic);
+            if (it != retained.end()) {
+                std::vector<uint8_t> msg(topic.size() + it->second.size() + MQTT_WIRE_HEADER_MAX + 2);
+                clientSend(client, msg.data(), mqttEncodePublish(msg.data(), msg.size(), topic, it->second, true));
+            }
+            return true;
+        }
+
+        case MQTT_PKT_PINGREQ: {
+            uint8_t buf[2];
+            clientSend(client, buf, mqttEncodePingresp(buf, sizeof(buf)));
+            return true;
+        }
+
+        case MQTT_PKT_DISCONNECT:
+            *graceful = true;
+            return false;
+
+        default:
+            return true;
+    }
+}
+
+static void clientReadable(BrokerClient* client) {
+    if (client->rxLen == client->rx.size()) client->rx.resize(client->rx.size() * 2);
+    ssize_t n = recv(client->fd, client->rx.data() + client->rxLen, client->rx.size() - client->rxLen, 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        closeClient(client, true);
+        return;
+    }
+    if (n < 0) return;
+    client->rxLen += (size_t)n;
+
+    size_t offset = 0;
+    MqttPacket packet;
+    for (;;) {
+        MqttParseResult result = mqttParsePacket(client->rx.data() + offset, client->rxLen - offset, &packet);
+        if (result == MQTT_PARSE_INCOMPLETE) break;
+        bool graceful = false;
+        if (result == MQTT_PARSE_MALFORMED || !handlePacket(client, &packet, &graceful)) {
+            closeClient(client, !graceful);
+            return;
+        }
+        offset += packet.totalLen;
+    }
+    memmove(client->rx.data(), client->rx.data() + offset, client->rxLen - offset);
+    client->rxLen -= offset;
+}
+
+static void acceptClients(int listenFd) {
+    for (;;) {
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if ((size_t)fd >= clients.size()) clients.resize(fd + 1024, NULL);
+
+        BrokerClient* client = new BrokerClient();
+        client->fd = fd;
+        client->connected = false;
+        client->writeArmed = false;
+        client->rx.resize(BROKER_RX_INITIAL);
+        client->rxLen = 0;
+        client->txOff = 0;
+        client->willRetain = false;
+        clients[fd] = client;
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+// ==================== 主程序 ====================
+
+int main(int argc, char** argv) {
+    uint16_t port = BROKER_DEFAULT_PORT;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:")) != -1) {
+        if (opt == 'p') {
+            port = (uint16_t)atoi(optarg);
+        } else {
+            printf("Usage: %s [-p port]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    int listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 4096) < 0) {
+        printf("[BROKER] Cannot listen on port %u: %s\n", port, strerror(errno));
+        return 1;
+    }
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, listenFd, &ev);
+    printf("[BROKER] Listening on 127.0.0.1:%u\n", port);
+    fflush(stdout);
+
+    struct epoll_event events[BROKER_EPOLL_EVENTS];
+    while (running) {
+        int n = epoll_wait(epfd, events, BROKER_EPOLL_EVENTS, 200);
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptClients(listenFd);
+                continue;
+            }
+            BrokerClient* client = clients[fd];
+            if (client == NULL) continue;
+            if (events[i].events & EPOLLOUT) clientFlush(client);
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) clientReadable(client);
+        }
+    }
+
+    printf("[BROKER] Routed %llu messages, dropped %llu\n", (unsigned long long)routed, (unsigned long long)dropped);
+    return 0;
+}
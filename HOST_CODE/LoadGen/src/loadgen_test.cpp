@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include "MY_VirtualDevice.h"
+#include "MY_SensorPayload.h"
+#include "MY_JsonLite.h"
+#include "MY_SensorRecord.h"
+
+/*
+ * 虚拟控制器一致性测试：配置、命令与遥测直接编译固件的
+ * MY_ConfigCore.cpp、MY_CommandCore.cpp、MY_SensorPayload.cpp 与 MY_JsonLite.cpp
+ *   1. 遥测：虚拟设备的负载是合法JSON，接入服务能解析出关键字段；NaN输出为 null；
+ *            单区满字段负载放得进固件的发布缓冲区
+ *   2. 配置：部分更新、限频、范围校验、类型不符、非法JSON、恢复默认值与拒绝计数
+ *   3. 命令：脉冲参数优先级与默认值、蜂鸣器图案、模式命令、不识别的动作与Topic
+ *   4. 虚拟设备：配置命令总会发布 config/state，自动模式下忽略控制命令
+ * 任一检查失败时退出码为1
+ */
+
+// ==================== 检查 ====================
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("[LOADGEN] %-62s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+static bool contains(const std::string& text, const char* part) {
+    return text.find(part) != std::string::npos;
+}
+
+// ==================== 捕获输出 ====================
+
+typedef struct {
+    std::string topic;
+    std::string payload;
+    int count;
+} Captured;
+
+static void capturePublish(void* ctx, const char* topic, std::string_view payload, bool) {
+    Captured* captured = (Captured*)ctx;
+    captured->topic = topic;
+    captured->payload.assign(payload.data(), payload.size());
+    captured->count++;
+}
+
+static bool sendCommand(VirtualDevice* dev, uint64_t nowUs, const char* topic, const char* payload,
+                        Captured* captured) {
+    DeviceSink sink = {capturePublish, captured};
+    return deviceHandleCommand(dev, nowUs, topic, payload, &sink);
+}
+
+// ==================== 遥测 ====================
+
+static void testTelemetry() {
+    VirtualDevice dev;
+    deviceInit(&dev, 42, 1000000);
+    Captured captured = {};
+    DeviceSink sink = {capturePublish, &captured};
+    devicePublishTelemetry(&dev, 1000000 + 1234567, &sink);
+
+    JsonLiteObject object;
+    check(captured.topic == DEVICE_TOPIC_SENSOR &&
+          jsonLiteParse(captured.payload.data(), captured.payload.size(), &object),
+          "virtual telemetry is one valid JSON object");
+
+    SensorParser parser;
+    SensorRecord record;
+    bool parsed = parseSensorRecord(&parser, captured.payload, &record);
+    check(parsed && recordHas(&record, FIELD_DEVICE_ID) && record.deviceId == "esp32_fire_alarm_00042" &&
+          recordHas(&record, FIELD_TIMESTAMP) && record.timestamp == 1234,
+          "ingest parser reads device_id and timestamp");
+    check(parsed && recordHas(&record, FIELD_FIRE_LEVEL) && recordHas(&record, FIELD_HEAP_FREE) &&
+          recordHas(&record, FIELD_RESET_REASON),
+          "ingest parser finds fire_level, heap_free and reset_reason");
+    check(contains(captured.payload, "\"pump_held\":false") && contains(captured.payload, "\"k230_link\":") &&
+          contains(captured.payload, "\"epoch_us\":0"),
+          "virtual telemetry carries every firmware field");
+
+    // 读取失败的传感器输出为 null，定点值去掉末尾的0
+    SensorPayload p;
+    memset(&p, 0, sizeof(p));
+    p.temperature = NAN;
+    p.humidity = 45.25f;
+    p.fireScore = 0.1234f;
+    char buf[DEVICE_PAYLOAD_SIZE];
+    size_t len = sensorPayloadBuild(&p, buf, sizeof(buf));
+    std::string text(buf, len < sizeof(buf) ? len : 0);
+    check(contains(text, "\"temperature\":null") && contains(text, "\"humidity\":45.3") &&
+          contains(text, "\"fire_score\":0.123") && contains(text, "\"smoke_level\":0,"),
+          "NaN is null, readings 1 decimal, scores 3 decimals");
+    check(jsonLiteParse(buf, len, &object), "payload with null strings is still valid JSON");
+
+    // 单区满字段 (窗口特征、分类结果、最长字符串、49天运行后的计数器) 放得进固件单区发布缓冲区
+    SensorPayloadZone zone;
+    memset(&zone, 0, sizeof(zone));
+    zone.name = "zone0";
+    zone.temperature = -40.5f;
+    zone.humidity = 100.0f;
+    zone.smokeLevel = 100.0f;
+    zone.fireScore = 0.999f;
+    zone.fireLevel = "suppress";
+    zone.smokeValid = true;
+    zone.tempValid = true;
+    zone.smokeBandCount = 3;
+    zone.smoke.variance = 123456.789f;
+    zone.smoke.slope = -1234.567f;
+    zone.smoke.zcr = 0.99f;
+    for (int b = 0; b < 3; b++) zone.smoke.bandEnergy[b] = 98765.432f;
+    zone.temp.variance = 1234.567f;
+    zone.temp.slope = -12.3456f;
+    zone.temp.zcr = 0.99f;
+    zone.clsValid = true;
+    zone.clsClass = "nuisance";
+    zone.pNuisance = 0.99f;
+    zone.pFire = 0.01f;
+    memset(&p, 0, sizeof(p));
+    p.deviceId = "esp32_fire_alarm_001";
+    p.temperature = p.humidity = p.smokeLevel = -40.5f;
+    p.fanState = p.fanMode = p.pumpState = p.pumpMode = p.k230Fire = p.k230Link = "cooldown";
+    p.k230Fps = p.k230InferMs = p.k230InferAvgMs = p.k230InferMaxMs = p.snapshotKBps = 9999.9f;
+    p.k230Model = "yolov8n_fire_320_v12345";
+    p.k230HeartbeatAgeMs = UINT32_MAX;
+    p.k230Frames = 127000000;
+    p.k230Baud = 2000000;
+    p.k230RxBps = 250000;
+    p.pumpDutyCapMs = p.pumpDutyBudgetMs = p.pumpDutyUsedMs = p.pumpDutyRecoverMs = 300000;
+    p.snapshots = p.k230CrcErrors = p.k230Faults = p.k230Restarts = p.pumpHolds = 999999;
+    p.snapshotBytes = 65535;
+    p.zoneSampleUs = p.zoneSampleMaxUs = p.zoneEvalUs = p.zoneEvalMaxUs = p.dspUs = p.dspMaxUs = 99999;
+    p.clsModel = 20260101;
+    p.powerHolds = 0xFFFF;
+    p.powerFullPct = 100;
+    p.deadlineMisses = p.outboxDepth = p.outboxDropped = p.txSkipped = p.mqttReconnects = 999999;
+    p.heapFree = p.heapLargest = p.heapMinFree = 327680;
+    p.timestamp = UINT32_MAX;
+    p.k230ReportMode = p.fireLevel = p.fireZone = "suppress";
+    p.fireScore = 0.999f;
+    for (int i = 0; i < FUSION_SRC_COUNT; i++) p.fireEvidence[i] = 0.999f;
+    p.buzzerState = p.buzzerMode = p.buzzerPattern = "evacuation";
+    p.dspPipeline = "f32";
+    p.zones = &zone;
+    p.zoneCount = 1;
+    p.powerMode = "light_sleep";
+    p.resetReason = "hang:Telemetry_Task";
+    p.fwVersion = "10.10.10";
+    p.otaState = "receiving";
+    p.otaBoot = "rolled_back";
+    p.epochUs = 4102444800000000LL;
+    p.clockUncertaintyUs = 999999;
+    p.clockDriftPpm = -500.25f;
+    len = sensorPayloadBuild(&p, buf, sizeof(buf));
+    printf("[LOADGEN] long-uptime single zone payload: %zu bytes\n", len);
+    check(len < sizeof(buf) && jsonLiteParse(buf, len, &object),
+          "long-uptime single zone payload fits OUTBOX_PAYLOAD_SIZE");
+
+    // 缓冲区不足时返回所需长度且不越界
+    char small[16];
+    memset(small, 'x', sizeof(small));
+    check(sensorPayloadBuild(&p, small, 8) == len && small[7] == '\0' && small[8] == 'x',
+          "short buffer: full length returned, output truncated in place");
+}
+
+// ==================== 配置 ====================
+
+static void testConfig() {
+    ConfigCore core;
+    SystemConfig current, next;
+    const char* error = NULL;
+    configCoreInit(&core);
+    configCoreLoadDefaults(&current);
+    check(configCoreValidate(&current) == NULL, "factory defaults pass validation");
+
+    const char* update = "{\"temp_alarm\":60,\"pump_auto_spray_ms\":4000}";
+    ConfigUpdateResult result = configCoreUpdate(&core, &current, update, strlen(update), 10000, &next, &error);
+    check(result == CONFIG_UPDATE_APPLIED && next.revision == 1 && next.tempAlarmThreshold == 60.0f &&
+          next.pumpAutoSprayMs == 4000 && next.smokeAlarmThreshold == current.smokeAlarmThreshold,
+          "partial update applied, other fields kept, revision 1");
+    current = next;
+
+    const char* later = "{\"temp_safe\":35}";
+    result = configCoreUpdate(&core, &current, later, strlen(later), 11999, &next, &error);
+    check(result == CONFIG_UPDATE_REJECTED && strcmp(error, "update rate limited") == 0 && core.rejects == 1,
+          "update within CONFIG_MIN_UPDATE_INTERVAL_MS rate limited");
+    result = configCoreUpdate(&core, &current, later, strlen(later), 12000, &next, &error);
+    check(result == CONFIG_UPDATE_APPLIED && next.revision == 2 && next.tempSafeThreshold == 35.0f,
+          "update accepted once the interval has passed");
+    current = next;
+
+    const char* range = "{\"temp_alarm\":10}";
+    result = configCoreUpdate(&core, &current, range, strlen(range), 20000, &next, &error);
+    check(result == CONFIG_UPDATE_REJECTED && strcmp(error, "temp_alarm out of range [20,150]") == 0,
+          "out of range rejected with the validator reason");
+    const char* type = "{\"pump_duty_percent\":\"50\"}";
+    result = configCoreUpdate(&core, &current, type, strlen(type), 20000, &next, &error);
+    check(result == CONFIG_UPDATE_REJECTED && strcmp(error, "config fields must be numbers") == 0,
+          "string value rejected");
+    const char* negative = "{\"pump_duty_percent\":-5}";
+    result = configCoreUpdate(&core, &current, negative, strlen(negative), 20000, &next, &error);
+    check(result == CONFIG_UPDATE_REJECTED, "negative unsigned field rejected");
+    const char* broken = "{\"temp_alarm\":60";
+    result = configCoreUpdate(&core, &current, broken, strlen(broken), 20000, &next, &error);
+    check(result == CONFIG_UPDATE_REJECTED && strcmp(error, "invalid json") == 0 && core.rejects == 5,
+          "invalid JSON rejected, every reject counted");
+    const char* nulled = "{\"temp_alarm\":null,\"outbox_drain_rate\":20}";
+    result = configCoreUpdate(&core, &current, nulled, strlen(nulled), 20000, &next, &error);
+    check(result == CONFIG_UPDATE_APPLIED && next.tempAlarmThreshold == 60.0f && next.outboxDrainRatePerSec == 20,
+          "null field keeps the current value");
+    current = next;
+
+    const char* reset = "{\"action\":\"reset\"}";
+    result = configCoreUpdate(&core, &current, reset, strlen(reset), 21000, &next, &error);
+    check(result == CONFIG_UPDATE_REJECTED && core.rejects == 6, "reset rate limited like updates");
+    result = configCoreUpdate(&core, &current, reset, strlen(reset), 22000, &next, &error);
+    check(result == CONFIG_UPDATE_RESET && next.revision == current.revision + 1 &&
+          next.tempAlarmThreshold == TEMP_ALARM_THRESHOLD && next.outboxDrainRatePerSec == OUTBOX_DRAIN_RATE_PER_SEC,
+          "reset restores defaults with revision + 1");
+
+    char state[CONFIG_STATE_SIZE];
+    size_t len = configCoreBuildState(&next, core.rejects, 1700000000000000LL, state, sizeof(state));
+    JsonLiteObject object;
+    uint32_t revision = 0, rejected = 0;
+    bool parsed = len < sizeof(state) && jsonLiteParse(state, len, &object);
+    check(parsed && jsonLiteToUint32(jsonLiteFind(&object, "revision"), &revision) && revision == next.revision &&
+          jsonLiteToUint32(jsonLiteFind(&object, "rejected"), &rejected) && rejected == 6,
+          "config/state carries revision and reject count");
+    bool allFields = parsed;
+    for (size_t i = 0; i < configFieldCount; i++) {
+        allFields &= jsonLiteFind(&object, configFields[i].json) != NULL;
+    }
+    check(allFields && object.count == configFieldCount + 3, "config/state lists every field in the table");
+}
+
+// ==================== 命令 ====================
+
+static ControlCommand decode(const char* topic, const char* payload, bool* known) {
+    ControlCommand command;
+    memset(&command, 0xEE, sizeof(command));
+    *known = commandDecode(topic, payload, strlen(payload), &command);
+    return command;
+}
+
+static void testCommands() {
+    bool known;
+    ControlCommand c = decode(COMMAND_TOPIC_PUMP_CONTROL, "{\"action\":\"on\"}", &known);
+    check(known && c.topic == COMMAND_PUMP_CONTROL && c.action == COMMAND_ACTION_ON &&
+          c.onMs == PUMP_MANUAL_SPRAY_MS && c.offMs == 0 && c.cycles == 1,
+          "pump on defaults to PUMP_MANUAL_SPRAY_MS, one cycle");
+    c = decode(COMMAND_TOPIC_PUMP_CONTROL, "{\"action\":\"on\",\"duration_ms\":3000}", &known);
+    check(c.onMs == 3000, "duration_ms sets the spray time");
+    c = decode(COMMAND_TOPIC_PUMP_CONTROL,
+               "{\"action\":\"on\",\"on_ms\":2000,\"duration_ms\":3000,\"off_ms\":1000,\"cycles\":3}", &known);
+    check(c.onMs == 2000 && c.offMs == 1000 && c.cycles == 3, "on_ms takes precedence over duration_ms");
+    c = decode(COMMAND_TOPIC_PUMP_CONTROL, "{\"action\":\"on\",\"cycles\":70000,\"off_ms\":\"x\"}", &known);
+    check(c.cycles == 1 && c.offMs == 0, "out of range or mistyped pulse fields keep defaults");
+
+    c = decode(COMMAND_TOPIC_BUZZER_CONTROL, "{\"action\":\"on\",\"pattern\":\"smoke\"}", &known);
+    check(c.action == COMMAND_ACTION_ON && c.pattern == COMMAND_PATTERN_SMOKE, "buzzer pattern smoke");
+    c = decode(COMMAND_TOPIC_BUZZER_CONTROL, "{\"action\":\"on\",\"pattern\":\"disco\"}", &known);
+    check(c.pattern == COMMAND_PATTERN_EVACUATION, "unknown pattern falls back to evacuation");
+
+    c = decode(COMMAND_TOPIC_FAN_MODE, "{\"action\":\"manual\"}", &known);
+    check(c.topic == COMMAND_FAN_MODE && c.action == COMMAND_ACTION_MANUAL, "mode command decoded");
+    c = decode(COMMAND_TOPIC_FAN_MODE, "{\"action\":\"on\"}", &known);
+    check(known && c.action == COMMAND_ACTION_NONE, "control action on a mode topic ignored");
+    c = decode(COMMAND_TOPIC_FAN_CONTROL, "{\"action\":\"spin\"}", &known);
+    check(known && c.action == COMMAND_ACTION_NONE, "unknown action ignored");
+    c = decode(COMMAND_TOPIC_FAN_CONTROL, "{\"action\":\"on\"", &known);
+    check(known && c.action == COMMAND_ACTION_NONE, "invalid JSON ignored");
+    c = decode(COMMAND_TOPIC_CONFIG, "not json", &known);
+    check(known && c.topic == COMMAND_CONFIG, "config topic recognised regardless of payload");
+    decode("fire_alarm/fan/speed", "{\"action\":\"on\"}", &known);
+    check(!known, "unknown topic not recognised");
+
+    bool names = true;
+    for (int i = 0; i < COMMAND_TOPIC_COUNT; i++) {
+        decode(commandTopicName((CommandTopic)i), "{}", &known);
+        names &= known;
+    }
+    check(names && commandTopicName(COMMAND_TOPIC_COUNT) == NULL, "every subscribed topic decodes");
+}
+
+// ==================== 虚拟设备 ====================
+
+static void testVirtualDevice() {
+    VirtualDevice dev;
+    deviceInit(&dev, 7, 0);
+    Captured captured = {};
+
+    sendCommand(&dev, 5000000, COMMAND_TOPIC_CONFIG, "{\"pump_auto_spray_ms\":4000}", &captured);
+    check(captured.count == 1 && captured.topic == DEVICE_TOPIC_CONFIG_STATE &&
+          contains(captured.payload, "\"revision\":1,") && dev.config.pumpAutoSprayMs == 4000,
+          "config command applied and config/state published");
+    sendCommand(&dev, 6000000, COMMAND_TOPIC_CONFIG, "{\"pump_auto_spray_ms\":5000}", &captured);
+    check(captured.count == 2 && contains(captured.payload, "\"rejected\":1,") && dev.config.revision == 1,
+          "rate-limited config still publishes config/state");
+
+    sendCommand(&dev, 7000000, COMMAND_TOPIC_PUMP_CONTROL, "{\"action\":\"on\"}", &captured);
+    check(dev.pumpOffUs == 0, "pump control ignored in auto mode");
+    sendCommand(&dev, 7000000, COMMAND_TOPIC_PUMP_MODE, "{\"action\":\"manual\"}", &captured);
+    sendCommand(&dev, 7000000, COMMAND_TOPIC_PUMP_CONTROL, "{\"action\":\"on\",\"on_ms\":2000}", &captured);
+    check(!dev.pumpAuto && dev.pumpOffUs == 9000000, "manual pump on sprays for on_ms");
+    sendCommand(&dev, 7000000, COMMAND_TOPIC_PUMP_CONTROL, "{\"action\":\"on\"}", &captured);
+    check(dev.pumpOffUs == 7000000 + (uint64_t)dev.config.pumpMaxDurationMs * 1000,
+          "default spray capped at pump_max_duration_ms");
+
+    sendCommand(&dev, 7000000, COMMAND_TOPIC_BUZZER_MODE, "{\"action\":\"manual\"}", &captured);
+    sendCommand(&dev, 7000000, COMMAND_TOPIC_BUZZER_CONTROL, "{\"action\":\"on\",\"pattern\":\"continuous\"}",
+                &captured);
+    check(dev.buzzerOn && strcmp(dev.buzzerPattern, "continuous") == 0, "manual buzzer plays the pattern");
+    check(!sendCommand(&dev, 7000000, "fire_alarm/unknown", "{}", &captured), "unknown topic reported");
+}
+
+int main() {
+    testTelemetry();
+    testConfig();
+    testCommands();
+    testVirtualDevice();
+
+    printf("[LOADGEN] %s (%d failures)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
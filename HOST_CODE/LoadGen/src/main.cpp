@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "MY_LoadLoop.h"
+#include "MY_JsonScan.h"
+
+// ==================== 运行参数 ====================
+#define LOADGEN_FD_RESERVE          64      // 监控/操作员会话与标准输入输出等
+
+static volatile sig_atomic_t running = 1;
+
+static void handleSignal(int) {
+    running = 0;
+}
+
+static void printUsage(const char* name) {
+    printf("Usage: %s [-h host] [-p port] [-n devices] [-r connects_per_s] [-t telemetry_ms]\n"
+           "          [-f fires_per_min] [-q commands_per_s] [-s script] [-d duration_s] [-i report_s]\n"
+           "          [-S source_addrs]\n", name);
+}
+
+/**
+ * @brief 提高文件描述符上限，每台虚拟设备占用一个Socket
+ */
+static bool raiseFdLimit(uint32_t devices) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return false;
+
+    rlim_t need = (rlim_t)devices + LOADGEN_FD_RESERVE;
+    if (limit.rlim_cur >= need) return true;
+    limit.rlim_cur = need < limit.rlim_max ? need : limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    return limit.rlim_cur >= need;
+}
+
+/**
+ * @brief 机队负载生成器
+ *
+ * 模拟N台控制器连接本地Broker，按固件的Topic与负载格式发布遥测、
+ * 响应命令并按脚本/随机触发火灾，统计端到端延迟百分位
+ */
+int main(int argc, char** argv) {
+    LoadConfig config;
+    config.host = "127.0.0.1";
+    config.port = 1883;
+    config.devices = LOADGEN_DEFAULT_DEVICES;
+    config.telemetryIntervalMs = 1000;      // MQTT_PUBLISH_INTERVAL_MS
+    config.rampPerSec = LOADGEN_DEFAULT_RAMP;
+    config.sourceAddrs = 0;
+    config.firesPerMin = 0;
+    config.commandsPerSec = 0;
+    config.durationS = 0;
+    config.reportIntervalS = LOADGEN_REPORT_INTERVAL_S;
+    const char* scriptPath = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:n:r:t:f:q:s:d:i:S:")) != -1) {
+        switch (opt) {
+            case 'h': config.host = optarg; break;
+            case 'p': config.port = (uint16_t)atoi(optarg); break;
+            case 'n': config.devices = (uint32_t)atoi(optarg); break;
+            case 'r': config.rampPerSec = (uint32_t)atoi(optarg); break;
+            case 't': config.telemetryIntervalMs = (uint32_t)atoi(optarg); break;
+            case 'f': config.firesPerMin = atof(optarg); break;
+            case 'q': config.commandsPerSec = atof(optarg); break;
+            case 's': scriptPath = optarg; break;
+            case 'd': config.durationS = (uint32_t)atoi(optarg); break;
+            case 'i': config.reportIntervalS = (uint32_t)atoi(optarg); break;
+            case 'S': config.sourceAddrs = (uint32_t)atoi(optarg); break;
+            default:
+                printUsage(argv[0]);
+                return 1;
+        }
+    }
+    if (config.devices == 0 || config.rampPerSec == 0 || config.telemetryIntervalMs == 0 ||
+        config.reportIntervalS == 0 || config.sourceAddrs > 254) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (scriptPath != NULL && !loadScriptFile(scriptPath, &config.script)) {
+        return 1;
+    }
+    if (!raiseFdLimit(config.devices)) {
+        printf("[LOADGEN] Warning: fd limit below %u, some devices will fail to connect\n",
+               config.devices + LOADGEN_FD_RESERVE);
+    }
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    printf("[LOADGEN] Broker %s:%u, %u devices, telemetry %ums, ramp %u/s, fires %.1f/min, commands %.2f/s, "
+           "script %zu steps, JSON scan: %s\n",
+           config.host.c_str(), config.port, config.devices, config.telemetryIntervalMs, config.rampPerSec,
+           config.firesPerMin, config.commandsPerSec, config.script.size(), jsonScanImplementation());
+
+    return loadLoopRun(&config, &running) ? 0 : 1;
+}
@@ -0,0 +1,374 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MY_LocalServerCore.h"
+
+/*
+ * 本地服务器回环测试：直接编译固件的 MY_LocalServerCore.cpp，在127.0.0.1上运行
+ *   服务器线程按固件 localServerTask 的方式循环 localCorePoll，主线程按遥测任务的方式推送，
+ *   两者通过 LocalCoreHandlers 的锁互斥，与设备上的任务划分相同
+ *   1. 短连接：GET /state、POST 命令、未知路径、非法请求
+ *   2. SSE：连接数上限与503、每帧在所有客户端上完整且顺序一致、对端断开后回收槽位
+ *   3. 慢客户端：接收缓冲区很小且不读取的客户端被断开，其余客户端不丢帧
+ *   4. 推送耗时：每帧 (全部客户端) 的 localCoreBroadcast 耗时
+ * 任一检查失败时退出码为1
+ */
+
+// ==================== 测试参数 ====================
+#define TEST_MAX_CLIENTS            4       // 与固件 LOCAL_SERVER_MAX_CLIENTS 一致
+#define TEST_REQUEST_SIZE           1024    // 与固件 LOCAL_SERVER_REQUEST_SIZE 一致
+#define TEST_READ_TIMEOUT_MS        500
+#define TEST_POLL_MS                20
+#define TEST_FRAME_BYTES            2600    // 约一条单分区遥测的长度
+#define TEST_DEFAULT_FRAMES         2000
+#define TEST_SLOW_MAX_FRAMES        50000   // 慢客户端须在这么多帧内被断开
+#define TEST_WAIT_MS                2000    // 等待服务器线程处理的最长时间
+
+// ==================== 被测服务器 ====================
+
+static LocalServerCore core;
+static std::mutex coreMutex;
+static std::atomic<bool> serverRunning(true);
+static char requestBuffer[TEST_REQUEST_SIZE];
+static char responseBuffer[TEST_FRAME_BYTES];
+static bool verbose = false;
+
+static const char* STATE_JSON = "{\"device_id\":\"loopback\",\"temperature\":25.5}";
+
+static std::mutex commandMutex;
+static std::string lastCommandPath;
+static std::string lastCommandBody;
+
+static void lockCore(void*) { coreMutex.lock(); }
+static void unlockCore(void*) { coreMutex.unlock(); }
+
+static size_t serializeState(void*, char* buffer, size_t size) {
+    return (size_t)snprintf(buffer, size, "%s", STATE_JSON);
+}
+
+static bool dispatchTestCommand(void*, const char* path, const char* body) {
+    static const char* known[] = { "/fan/control", "/fan/mode", "/pump/control", "/pump/mode",
+                                   "/buzzer/control", "/buzzer/mode", "/config" };
+    for (const char* k : known) {
+        if (strcmp(path, k) == 0) {
+            std::lock_guard<std::mutex> guard(commandMutex);
+            lastCommandPath = path;
+            lastCommandBody = body;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void logServer(void*, const char* message) {
+    if (verbose) printf("[LOCAL] %s\n", message);
+}
+
+static void serverThread() {
+    while (serverRunning) {
+        localCorePoll(&core, TEST_POLL_MS);
+    }
+}
+
+// ==================== 客户端 ====================
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("[LOOPBACK] %-58s %s\n", what, ok ? "OK" : "FAIL");
+    if (!ok) failures++;
+}
+
+static double wallSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int connectServer(uint16_t port, int receiveBuffer) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (receiveBuffer > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    struct timeval tv = {2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+}
+
+static bool sendText(int fd, const std::string& text) {
+    return send(fd, text.data(), text.size(), MSG_NOSIGNAL) == (ssize_t)text.size();
+}
+
+// 短连接：发送请求，读到对端关闭为止
+static std::string httpExchange(uint16_t port, const std::string& request) {
+    int fd = connectServer(port, 0);
+    if (fd < 0) return "";
+    std::string response;
+    if (sendText(fd, request)) {
+        char buffer[1024];
+        ssize_t n;
+        while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, n);
+        }
+    }
+    close(fd);
+    return response;
+}
+
+static std::string httpBody(const std::string& response) {
+    size_t end = response.find("\r\n\r\n");
+    return end == std::string::npos ? "" : response.substr(end + 4);
+}
+
+// 读取SSE响应头
+static bool readSseHeader(int fd, std::string* rest) {
+    std::string data;
+    char buffer[512];
+    while (data.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) return false;
+        data.append(buffer, n);
+    }
+    size_t end = data.find("\r\n\r\n") + 4;
+    *rest = data.substr(end);
+    return data.compare(0, 15, "HTTP/1.1 200 OK") == 0 &&
+           data.find("Content-Type: text/event-stream") < end;
+}
+
+// SSE接收方：逐帧校验格式与序号
+typedef struct {
+    int fd;
+    std::string pending;
+    std::atomic<uint32_t> frames;
+    std::atomic<uint32_t> errors;
+    uint32_t lastSeq;
+} SseReader;
+
+static bool parseFrame(const std::string& frame, uint32_t* seq) {
+    // data: {"seq":N,"pad":"xxx..."}
+    if (frame.size() != TEST_FRAME_BYTES + 8 || frame.compare(0, 6, "data: ") != 0) return false;
+    if (frame.compare(frame.size() - 2, 2, "\n\n") != 0) return false;
+    return sscanf(frame.c_str() + 6, "{\"seq\":%u,", seq) == 1;
+}
+
+static void readerThread(SseReader* reader) {
+    char buffer[16384];
+    for (;;) {
+        ssize_t n = recv(reader->fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        reader->pending.append(buffer, n);
+        size_t end;
+        while ((end = reader->pending.find("\n\n")) != std::string::npos) {
+            std::string frame = reader->pending.substr(0, end + 2);
+            reader->pending.erase(0, end + 2);
+            uint32_t seq;
+            if (!parseFrame(frame, &seq)) {
+                reader->errors++;
+                continue;
+            }
+            if (reader->frames > 0 && seq != reader->lastSeq + 1) reader->errors++;
+            reader->lastSeq = seq;
+            reader->frames++;
+        }
+    }
+}
+
+static void makeFrame(char* buffer, uint32_t seq) {
+    int n = snprintf(buffer, TEST_FRAME_BYTES + 1, "{\"seq\":%u,\"pad\":\"", seq);
+    memset(buffer + n, 'x', TEST_FRAME_BYTES - n - 2);
+    buffer[TEST_FRAME_BYTES - 2] = '"';
+    buffer[TEST_FRAME_BYTES - 1] = '}';
+    buffer[TEST_FRAME_BYTES] = '\0';
+}
+
+// 等待服务器线程把统计推进到期望值
+template <typename Pred>
+static bool waitFor(Pred pred) {
+    double deadline = wallSeconds() + TEST_WAIT_MS / 1000.0;
+    while (wallSeconds() < deadline) {
+        if (pred(localCoreStats(&core))) return true;
+        usleep(1000);
+    }
+    return pred(localCoreStats(&core));
+}
+
+// ==================== 主程序 ====================
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [-n frames] [-v]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    int frames = TEST_DEFAULT_FRAMES;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:v")) != -1) {
+        switch (opt) {
+            case 'n': frames = atoi(optarg); break;
+            case 'v': verbose = true; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (frames <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    LocalCoreHandlers handlers = { NULL, lockCore, unlockCore, serializeState, dispatchTestCommand, logServer };
+    if (!localCoreOpen(&core, 0, TEST_MAX_CLIENTS, TEST_READ_TIMEOUT_MS, requestBuffer, sizeof(requestBuffer),
+                       responseBuffer, sizeof(responseBuffer), &handlers)) {
+        printf("[LOOPBACK] listen failed\n");
+        return 1;
+    }
+    uint16_t port = localCorePort(&core);
+    printf("[LOOPBACK] listening on 127.0.0.1:%u, %d SSE clients max\n", port, TEST_MAX_CLIENTS);
+    std::thread server(serverThread);
+
+    // 1. 短连接
+    std::string response = httpExchange(port, "GET /state HTTP/1.1\r\nHost: x\r\n\r\n");
+    check(response.compare(0, 15, "HTTP/1.1 200 OK") == 0 && httpBody(response) == STATE_JSON,
+          "GET /state returns the state JSON");
+
+    const std::string body = "{\"action\":\"on\",\"duration\":5000}";
+    response = httpExchange(port, "POST /pump/control HTTP/1.1\r\nContent-Length: " +
+                                  std::to_string(body.size()) + "\r\n\r\n" + body);
+    bool dispatched;
+    {
+        std::lock_guard<std::mutex> guard(commandMutex);
+        dispatched = lastCommandPath == "/pump/control" && lastCommandBody == body;
+    }
+    check(response.compare(0, 15, "HTTP/1.1 200 OK") == 0 && dispatched && localCoreStats(&core).commands == 1,
+          "POST /pump/control dispatches the body");
+
+    // 请求体分两次到达
+    int fd = connectServer(port, 0);
+    sendText(fd, "POST /fan/mode HTTP/1.1\r\nContent-Length: 15\r\n\r\n{\"mode\":");
+    usleep(50000);
+    sendText(fd, "\"auto\"}");
+    char buffer[256] = {0};
+    recv(fd, buffer, sizeof(buffer) - 1, MSG_WAITALL);
+    close(fd);
+    {
+        std::lock_guard<std::mutex> guard(commandMutex);
+        dispatched = lastCommandPath == "/fan/mode" && lastCommandBody == "{\"mode\":\"auto\"}";
+    }
+    check(strncmp(buffer, "HTTP/1.1 200 OK", 15) == 0 && dispatched, "POST body split across segments");
+
+    response = httpExchange(port, "POST /door/open HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}");
+    check(response.compare(0, 22, "HTTP/1.1 404 Not Found") == 0, "POST to an unknown path returns 404");
+
+    response = httpExchange(port, "HELLO\r\n\r\n");
+    check(response.compare(0, 24, "HTTP/1.1 400 Bad Request") == 0, "malformed request line returns 400");
+
+    // 2. SSE：连接数上限
+    std::vector<SseReader*> readers;
+    bool headersOk = true;
+    for (int i = 0; i < TEST_MAX_CLIENTS; i++) {
+        SseReader* reader = new SseReader();
+        reader->fd = connectServer(port, 0);
+        sendText(reader->fd, "GET /events HTTP/1.1\r\n\r\n");
+        headersOk = headersOk && readSseHeader(reader->fd, &reader->pending);
+        readers.push_back(reader);
+    }
+    check(headersOk && waitFor([](LocalServerStats s) { return s.clients == TEST_MAX_CLIENTS; }),
+          "SSE clients up to the cap get an event stream");
+
+    response = httpExchange(port, "GET /events HTTP/1.1\r\n\r\n");
+    check(response.compare(0, 15, "HTTP/1.1 503 Se") == 0 && localCoreStats(&core).rejected == 1,
+          "one more SSE client is rejected with 503");
+
+    std::vector<std::thread> readerThreads;
+    for (SseReader* reader : readers) {
+        readerThreads.emplace_back(readerThread, reader);
+    }
+
+    // 推送：每帧在所有客户端上完整且顺序一致
+    std::vector<char> frame(TEST_FRAME_BYTES + 1);
+    uint32_t seq = 0;
+    double start = wallSeconds();
+    for (int i = 0; i < frames; i++) {
+        makeFrame(frame.data(), seq++);
+        localCoreBroadcast(&core, frame.data(), TEST_FRAME_BYTES);
+    }
+    double broadcastUs = (wallSeconds() - start) * 1e6 / frames;
+    bool delivered = true;
+    double deadline = wallSeconds() + TEST_WAIT_MS / 1000.0;
+    for (SseReader* reader : readers) {
+        while (reader->frames < (uint32_t)frames && wallSeconds() < deadline) usleep(1000);
+        delivered = delivered && reader->frames == (uint32_t)frames && reader->errors == 0;
+    }
+    LocalServerStats stats = localCoreStats(&core);
+    check(delivered && stats.framesSent == (uint32_t)(frames * TEST_MAX_CLIENTS) && stats.clientsDropped == 0,
+          "every frame reaches every client intact and in order");
+
+    // 对端断开后回收槽位，不计为被断开
+    shutdown(readers[0]->fd, SHUT_RDWR);
+    readerThreads[0].join();
+    close(readers[0]->fd);
+    check(waitFor([](LocalServerStats s) { return s.clients == TEST_MAX_CLIENTS - 1; }) &&
+          localCoreStats(&core).clientsDropped == 0,
+          "client disconnect frees its slot");
+
+    // 3. 慢客户端：接收缓冲区很小且从不读取
+    int slowFd = connectServer(port, 1024);
+    sendText(slowFd, "GET /events HTTP/1.1\r\n\r\n");
+    std::string ignored;
+    bool slowUp = readSseHeader(slowFd, &ignored) &&
+                  waitFor([](LocalServerStats s) { return s.clients == TEST_MAX_CLIENTS; });
+    uint32_t before[TEST_MAX_CLIENTS];
+    for (int i = 1; i < TEST_MAX_CLIENTS; i++) before[i] = readers[i]->frames;
+    int slowFrames = 0;
+    while (slowFrames < TEST_SLOW_MAX_FRAMES && localCoreStats(&core).clientsDropped == 0) {
+        makeFrame(frame.data(), seq++);
+        localCoreBroadcast(&core, frame.data(), TEST_FRAME_BYTES);
+        slowFrames++;
+    }
+    bool dropped = slowUp && localCoreStats(&core).clientsDropped == 1 &&
+                   waitFor([](LocalServerStats s) { return s.clients == TEST_MAX_CLIENTS - 1; });
+    bool othersOk = true;
+    deadline = wallSeconds() + TEST_WAIT_MS / 1000.0;
+    for (int i = 1; i < TEST_MAX_CLIENTS; i++) {
+        while (readers[i]->frames < before[i] + slowFrames && wallSeconds() < deadline) usleep(1000);
+        othersOk = othersOk && readers[i]->frames == before[i] + slowFrames && readers[i]->errors == 0;
+    }
+    printf("[LOOPBACK] slow client dropped after %d frames\n", slowFrames);
+    check(dropped, "a client that stops reading is disconnected");
+    check(othersOk, "other clients lose no frames meanwhile");
+    close(slowFd);
+
+    // 4. 推送耗时
+    printf("[LOOPBACK] broadcast: %.1f us/frame to %d clients (%d-byte payload, %d frames)\n",
+           broadcastUs, TEST_MAX_CLIENTS, TEST_FRAME_BYTES, frames);
+
+    serverRunning = false;
+    server.join();
+    localCoreClose(&core);
+    for (size_t i = 1; i < readers.size(); i++) {
+        readerThreads[i].join();
+    }
+    for (SseReader* reader : readers) delete reader;
+
+    printf("[LOOPBACK] %s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
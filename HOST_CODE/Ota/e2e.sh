@@ -0,0 +1,79 @@
+#!/bin/bash
+# 端到端测试：本地Broker替身 + 设备模拟器 (文件模拟Flash) + ota_server
+#   1. 增量补丁升级到 1.1.0，签到成功，分区内容与镜像逐字节一致
+#   2. 其他密钥签名的补丁在写入前被拒绝 (bad_signature)，设备仍运行 1.1.0
+#   3. 升级到不签到的 1.2.0，签到窗口超时后回滚到 1.1.0
+#   4. 升级到启动即崩溃的 1.3.0，试运行启动次数超限后回滚到 1.1.0
+#   5. 补丁基准不是设备当前镜像，退回完整镜像升级到 1.4.0
+# 签名密钥只在临时目录中生成，测试结束后删除
+# 用法: ./e2e.sh <loadgen_broker> <port>
+
+BROKER_BIN=$1
+PORT=$2
+BIN=build
+WORK=$(mktemp -d /tmp/ota_e2e.XXXXXX)
+FAILED=0
+
+cleanup() {
+    kill $DEVICE $BROKER 2>/dev/null
+    wait 2>/dev/null
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+run_case() {
+    local name=$1 expect=$2
+    shift 2
+    ./$BIN/ota_server -p $PORT -t 60 "$@"
+    local status=$?
+    if [ $status -eq $expect ]; then
+        echo "[E2E] PASS: $name"
+    else
+        echo "[E2E] FAIL: $name (exit $status, expected $expect)"
+        FAILED=1
+    fi
+}
+
+# 签名密钥 (设备信任 signing.pub)、镜像与补丁
+./$BIN/ota_keygen $WORK/signing.key > /dev/null || exit 1
+./$BIN/ota_keygen $WORK/rogue.key > /dev/null || exit 1
+./$BIN/ota_imagegen -s 1024 -V 1.0.0 $WORK/v100.bin || exit 1
+./$BIN/ota_imagegen -s 1024 -c 20 -V 1.1.0 $WORK/v110.bin || exit 1
+./$BIN/ota_imagegen -s 1024 -c 28 -C 3 -V 1.2.0 -b no_checkin $WORK/v120.bin || exit 1
+./$BIN/ota_imagegen -s 1024 -c 24 -C 4 -V 1.3.0 -b crash $WORK/v130.bin || exit 1
+./$BIN/ota_imagegen -s 1024 -c 40 -C 5 -V 1.4.0 $WORK/v140.bin || exit 1
+KEY="-k $WORK/signing.key"
+./$BIN/ota_diff $KEY $WORK/v100.bin $WORK/v110.bin $WORK/110.patch || exit 1
+./$BIN/ota_diff $KEY $WORK/v110.bin $WORK/v120.bin $WORK/120.patch || exit 1
+./$BIN/ota_diff -k $WORK/rogue.key $WORK/v110.bin $WORK/v120.bin $WORK/120_rogue.patch || exit 1
+./$BIN/ota_diff $KEY $WORK/v110.bin $WORK/v130.bin $WORK/130.patch || exit 1
+./$BIN/ota_diff $KEY $WORK/v100.bin $WORK/v140.bin $WORK/140.patch || exit 1
+./$BIN/ota_diff $KEY -f $WORK/v140.bin $WORK/140_full.patch || exit 1
+
+$BROKER_BIN -p $PORT & BROKER=$!
+sleep 0.3
+./$BIN/ota_device -p $PORT -d $WORK/flash -K $WORK/signing.pub -I $WORK/v100.bin -w 5 -s 1 > $WORK/device.log 2>&1 & DEVICE=$!
+sleep 0.5
+
+run_case "delta update 1.0.0 -> 1.1.0 confirmed" 0 -P $WORK/110.patch -V 1.1.0
+SIZE=$(stat -c %s $WORK/v110.bin)
+if cmp -s -n $SIZE $WORK/flash/ota_1.bin $WORK/v110.bin; then
+    echo "[E2E] PASS: slot 1 matches 1.1.0 byte for byte"
+else
+    echo "[E2E] FAIL: slot 1 differs from 1.1.0"
+    FAILED=1
+fi
+run_case "patch signed with another key rejected" 1 -P $WORK/120_rogue.patch -V 1.2.0
+if grep -q "bad_signature" $WORK/device.log; then
+    echo "[E2E] PASS: device reported bad_signature"
+else
+    echo "[E2E] FAIL: device did not report bad_signature"
+    FAILED=1
+fi
+run_case "no check-in 1.1.0 -> 1.2.0 rolled back" 3 -P $WORK/120.patch -V 1.2.0
+run_case "crash loop 1.1.0 -> 1.3.0 rolled back" 3 -P $WORK/130.patch -V 1.3.0
+run_case "base mismatch falls back to full image 1.4.0" 0 -P $WORK/140.patch -F $WORK/140_full.patch -V 1.4.0
+
+echo "[E2E] ---- device log ----"
+cat $WORK/device.log
+exit $FAILED
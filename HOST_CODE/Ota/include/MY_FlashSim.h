@@ -0,0 +1,59 @@
+#ifndef MY_FLASH_SIM_H
+#define MY_FLASH_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "MY_OtaBoot.h"
+
+// ==================== 文件模拟的Flash ====================
+// 目录下的文件对应设备分区 (default_16MB.csv)：
+//   ota_0.bin / ota_1.bin   两个应用分区，各 FLASH_SIM_SLOT_SIZE 字节 (稀疏文件)
+//   otadata.bin             启动分区与各分区镜像长度 (设备上由 otadata 与镜像头描述)
+//   nvs_ota.bin             试运行记录 OtaBootRecord (设备上保存在NVS)
+// 进程退出后内容保留，重新启动模拟器即等同于设备复位
+
+#define FLASH_SIM_SLOT_SIZE         0x640000
+#define FLASH_SIM_SLOTS             2
+#define FLASH_SIM_MAGIC             0x46534D31      // "FSM1"
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint32_t magic;
+    uint32_t bootSlot;
+    uint32_t imageSize[FLASH_SIM_SLOTS];    // 0=分区为空
+} FlashSimMeta;
+
+typedef struct {
+    char dir[256];
+    int fd[FLASH_SIM_SLOTS];
+    FlashSimMeta meta;
+} FlashSim;
+
+// ==================== 函数声明 ====================
+
+// 打开 (不存在时创建) 模拟Flash
+bool flashSimOpen(FlashSim* flash, const char* dir);
+void flashSimClose(FlashSim* flash);
+
+// 串口烧录：写入镜像并设为启动分区，清除试运行记录
+bool flashSimProvision(FlashSim* flash, uint8_t slot, const std::vector<uint8_t>& image);
+
+bool flashSimRead(FlashSim* flash, uint8_t slot, uint32_t offset, uint8_t* buf, size_t len);
+bool flashSimWrite(FlashSim* flash, uint8_t slot, uint32_t offset, const uint8_t* buf, size_t len);
+// 擦除整个分区 (esp_ota_begin)
+bool flashSimErase(FlashSim* flash, uint8_t slot);
+
+// 写完后登记镜像长度 (esp_ota_end)，切换启动分区 (esp_ota_set_boot_partition)
+bool flashSimSetImage(FlashSim* flash, uint8_t slot, uint32_t size);
+bool flashSimSetBoot(FlashSim* flash, uint8_t slot);
+
+// 读出分区中的镜像 (长度为登记值)
+bool flashSimLoadImage(FlashSim* flash, uint8_t slot, std::vector<uint8_t>* image);
+
+// 试运行记录
+void flashSimLoadRecord(FlashSim* flash, OtaBootRecord* record);
+bool flashSimSaveRecord(FlashSim* flash, const OtaBootRecord* record);
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef MY_OTA_WIRE_H
+#define MY_OTA_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string_view>
+#include <vector>
+
+/*
+ * 固件升级报文 (与固件 MY_Ota 一致)：
+ *   描述  fire_alarm/ota/offer/<device_id>  {"ota_id", "version", "size", "chunks", "chunk_size", "base_sha256"}
+ *   数据  fire_alarm/ota/data/<device_id>   升级编号(2) 保留(2) 块序号(4) 小端 + 补丁数据
+ *   状态  fire_alarm/ota/status             完整状态或进度应答 {"device_id", "ota_id", "state", "next", "done"}
+ */
+
+// ==================== Topic与参数 (与 MY_Ota.h 一致) ====================
+#define OTA_TOPIC_OFFER             "fire_alarm/ota/offer/"
+#define OTA_TOPIC_DATA              "fire_alarm/ota/data/"
+#define OTA_TOPIC_STATUS            "fire_alarm/ota/status"
+#define OTA_DATA_HEADER_SIZE        8
+#define OTA_CHUNK_MAX               2048
+#define OTA_RX_SLOTS                4
+#define OTA_PATCH_MAX_BYTES         (4 * 1024 * 1024)
+#define OTA_PAYLOAD_MAX             640
+
+// 合成镜像中的标记 (ota_imagegen 写入，ota_device 读取)
+#define OTA_IMAGE_VERSION_TAG       "FWVER="
+#define OTA_IMAGE_NO_CHECKIN_TAG    "OTA_NO_CHECKIN"     // 启动后不签到 (如连不上Broker)
+#define OTA_IMAGE_CRASH_TAG         "OTA_CRASH_LOOP"     // 启动后立即复位
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    uint16_t otaId;
+    std::string_view version;
+    uint32_t size;
+    uint32_t chunks;
+    uint32_t chunkSize;
+    std::string_view baseSha;       // 空=完整镜像
+} OtaOffer;
+
+// 状态报文：进度应答只有前5个字段，其余保持默认值
+typedef struct {
+    std::string_view deviceId;
+    uint16_t otaId;
+    std::string_view state;         // idle/receiving/rebooting/failed/rejected
+    uint32_t next;
+    uint32_t done;
+    uint32_t chunks;
+    std::string_view error;
+    std::string_view version;       // 正在运行的版本
+    std::string_view boot;          // none/trial/confirmed/rolled_back
+    uint16_t bootOtaId;             // 试运行记录对应的升级编号
+    int32_t slot;
+    uint32_t imageSize;
+    std::string_view imageSha;
+    uint32_t window;
+    uint32_t chunkMax;
+    bool full;                      // 完整状态 (含 boot 字段)
+} OtaStatusMessage;
+
+// ==================== 函数声明 ====================
+
+bool otaParseOffer(std::string_view payload, OtaOffer* out);
+size_t otaEncodeOffer(char* buf, size_t size, const OtaOffer* offer);
+
+bool otaParseStatus(std::string_view payload, OtaStatusMessage* out);
+size_t otaEncodeStatus(char* buf, size_t size, const OtaStatusMessage* status);
+size_t otaEncodeAck(char* buf, size_t size, const OtaStatusMessage* status);
+
+void otaEncodeDataHeader(uint8_t out[OTA_DATA_HEADER_SIZE], uint16_t otaId, uint32_t index);
+bool otaParseDataHeader(std::string_view payload, uint16_t* otaId, uint32_t* index);
+
+// 文件读写
+bool otaReadFile(const char* path, std::vector<uint8_t>* data);
+bool otaWriteFile(const char* path, const std::vector<uint8_t>& data);
+
+// 签名密钥文件：一行十六进制 (私钥种子或公钥，各32字节)；secret=true 时文件权限为 0600
+bool otaReadKeyFile(const char* path, uint8_t* key, size_t size);
+bool otaWriteKeyFile(const char* path, const uint8_t* key, size_t size, bool secret);
+
+// 在镜像中查找标记，返回版本号 (找不到时为 "unknown")
+std::string_view otaImageVersion(const std::vector<uint8_t>& image);
+bool otaImageHasTag(const std::vector<uint8_t>& image, std::string_view tag);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef MY_PATCH_WRITER_H
+#define MY_PATCH_WRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "MY_Ed25519.h"
+
+// ==================== 补丁生成 ====================
+// 输出格式见固件 MY_OtaPatch.h，设备端与 ota_device 直接编译同一份解码源码
+// 差分：对旧镜像建后缀数组，按 bsdiff 的做法寻找近似匹配 (允许少量字节不同)，
+//       匹配区间输出逐字节差值 (地址平移后的代码差值大多为0)，其余输出原始字节
+// 压缩：LZSS，窗口 OTA_LZ_WINDOW，哈希链查找最长匹配
+// 签名：头部用发布者私钥种子签名 (Ed25519)，设备只接受与其公钥匹配的补丁
+
+typedef struct {
+    size_t instructions;            // 指令条数
+    size_t diffBytes;               // 由基准+差值生成的字节数
+    size_t extraBytes;              // 直接携带的字节数
+    size_t rawBytes;                // 压缩前的指令流字节数
+    size_t patchBytes;              // 补丁总字节数 (含头部)
+} PatchStats;
+
+// ==================== 函数声明 ====================
+
+// 以 base 为基准生成 target 的增量补丁
+std::vector<uint8_t> patchBuildDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& target,
+                                     const uint8_t seed[ED25519_SEED_SIZE], PatchStats* stats);
+
+// 完整镜像补丁 (基准不匹配时使用)
+std::vector<uint8_t> patchBuildFull(const std::vector<uint8_t>& target, const uint8_t seed[ED25519_SEED_SIZE],
+                                    PatchStats* stats);
+
+// LZSS压缩 (单独导出便于对比)
+std::vector<uint8_t> patchCompress(const uint8_t* data, size_t len);
+
+#endif
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "MY_FlashSim.h"
+
+// ==================== 内部工具 ====================
+
+static void filePath(const FlashSim* flash, const char* name, char* out, size_t size) {
+    snprintf(out, size, "%s/%s", flash->dir, name);
+}
+
+static bool readFile(const FlashSim* flash, const char* name, void* buf, size_t len) {
+    char path[320];
+    filePath(flash, name, path, sizeof(path));
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return false;
+    bool ok = fread(buf, 1, len, f) == len;
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief 先写临时文件再改名，进程中途被杀也不会留下半个记录 (对应NVS的原子写)
+ */
+static bool writeFile(const FlashSim* flash, const char* name, const void* buf, size_t len) {
+    char path[320];
+    char tmp[330];
+    filePath(flash, name, path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* f = fopen(tmp, "wb");
+    if (f == NULL) return false;
+    bool ok = fwrite(buf, 1, len, f) == len;
+    ok = fflush(f) == 0 && ok;
+    fclose(f);
+    return ok && rename(tmp, path) == 0;
+}
+
+static bool saveMeta(FlashSim* flash) {
+    return writeFile(flash, "otadata.bin", &flash->meta, sizeof(flash->meta));
+}
+
+static bool validRange(uint8_t slot, uint32_t offset, size_t len) {
+    return slot < FLASH_SIM_SLOTS && (uint64_t)offset + len <= FLASH_SIM_SLOT_SIZE;
+}
+
+// ==================== 公共接口 ====================
+
+bool flashSimOpen(FlashSim* flash, const char* dir) {
+    memset(flash, 0, sizeof(FlashSim));
+    snprintf(flash->dir, sizeof(flash->dir), "%s", dir);
+    for (uint8_t slot = 0; slot < FLASH_SIM_SLOTS; slot++) flash->fd[slot] = -1;
+    mkdir(dir, 0755);
+
+    for (uint8_t slot = 0; slot < FLASH_SIM_SLOTS; slot++) {
+        char name[16];
+        char path[320];
+        snprintf(name, sizeof(name), "ota_%u.bin", slot);
+        filePath(flash, name, path, sizeof(path));
+        flash->fd[slot] = open(path, O_RDWR | O_CREAT, 0644);
+        if (flash->fd[slot] < 0 || ftruncate(flash->fd[slot], FLASH_SIM_SLOT_SIZE) != 0) {
+            perror(path);
+            flashSimClose(flash);
+            return false;
+        }
+    }
+
+    if (!readFile(flash, "otadata.bin", &flash->meta, sizeof(flash->meta)) || flash->meta.magic != FLASH_SIM_MAGIC ||
+        flash->meta.bootSlot >= FLASH_SIM_SLOTS) {
+        memset(&flash->meta, 0, sizeof(flash->meta));
+        flash->meta.magic = FLASH_SIM_MAGIC;
+    }
+    return true;
+}
+
+void flashSimClose(FlashSim* flash) {
+    for (uint8_t slot = 0; slot < FLASH_SIM_SLOTS; slot++) {
+        if (flash->fd[slot] >= 0) close(flash->fd[slot]);
+        flash->fd[slot] = -1;
+    }
+}
+
+bool flashSimProvision(FlashSim* flash, uint8_t slot, const std::vector<uint8_t>& image) {
+    if (!flashSimErase(flash, slot) || !flashSimWrite(flash, slot, 0, image.data(), image.size()) ||
+        !flashSimSetImage(flash, slot, (uint32_t)image.size()) || !flashSimSetBoot(flash, slot)) {
+        return false;
+    }
+    OtaBootRecord record = {};
+    otaBootSanitize(&record);
+    return flashSimSaveRecord(flash, &record);
+}
+
+bool flashSimRead(FlashSim* flash, uint8_t slot, uint32_t offset, uint8_t* buf, size_t len) {
+    if (!validRange(slot, offset, len)) return false;
+    return pread(flash->fd[slot], buf, len, offset) == (ssize_t)len;
+}
+
+bool flashSimWrite(FlashSim* flash, uint8_t slot, uint32_t offset, const uint8_t* buf, size_t len) {
+    if (!validRange(slot, offset, len)) return false;
+    return pwrite(flash->fd[slot], buf, len, offset) == (ssize_t)len;
+}
+
+bool flashSimErase(FlashSim* flash, uint8_t slot) {
+    if (slot >= FLASH_SIM_SLOTS) return false;
+    // 截断再扩展：内容全部清零 (稀疏)，同时作废登记的镜像长度
+    flash->meta.imageSize[slot] = 0;
+    return ftruncate(flash->fd[slot], 0) == 0 && ftruncate(flash->fd[slot], FLASH_SIM_SLOT_SIZE) == 0 &&
+           saveMeta(flash);
+}
+
+bool flashSimSetImage(FlashSim* flash, uint8_t slot, uint32_t size) {
+    if (slot >= FLASH_SIM_SLOTS || size > FLASH_SIM_SLOT_SIZE) return false;
+    flash->meta.imageSize[slot] = size;
+    return fsync(flash->fd[slot]) == 0 && saveMeta(flash);
+}
+
+bool flashSimSetBoot(FlashSim* flash, uint8_t slot) {
+    if (slot >= FLASH_SIM_SLOTS || flash->meta.imageSize[slot] == 0) return false;
+    flash->meta.bootSlot = slot;
+    return saveMeta(flash);
+}
+
+bool flashSimLoadImage(FlashSim* flash, uint8_t slot, std::vector<uint8_t>* image) {
+    if (slot >= FLASH_SIM_SLOTS) return false;
+    image->resize(flash->meta.imageSize[slot]);
+    return image->empty() || flashSimRead(flash, slot, 0, image->data(), image->size());
+}
+
+void flashSimLoadRecord(FlashSim* flash, OtaBootRecord* record) {
+    if (!readFile(flash, "nvs_ota.bin", record, sizeof(OtaBootRecord))) {
+        memset(record, 0, sizeof(OtaBootRecord));
+    }
+    otaBootSanitize(record);
+}
+
+bool flashSimSaveRecord(FlashSim* flash, const OtaBootRecord* record) {
+    return writeFile(flash, "nvs_ota.bin", record, sizeof(OtaBootRecord));
+}
@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include "MY_OtaWire.h"
+
+// ==================== 字段查找 ====================
+
+/**
+ * @brief 查找 "key": 之后的值起始位置 (报文为扁平对象，键名不会出现在字符串值中)
+ */
+static size_t findValue(std::string_view payload, std::string_view key) {
+    char pattern[32];
+    int len = snprintf(pattern, sizeof(pattern), "\"%.*s\"", (int)key.size(), key.data());
+    size_t pos = payload.find(std::string_view(pattern, (size_t)len));
+    if (pos == std::string_view::npos) return pos;
+
+    pos += (size_t)len;
+    while (pos < payload.size() && (payload[pos] == ' ' || payload[pos] == ':')) pos++;
+    return pos < payload.size() ? pos : std::string_view::npos;
+}
+
+static bool findInt(std::string_view payload, std::string_view key, int64_t* out) {
+    size_t pos = findValue(payload, key);
+    if (pos == std::string_view::npos) return false;
+
+    // 负载不保证以0结尾，复制数字部分再转换
+    char digits[24];
+    size_t n = 0;
+    while (pos + n < payload.size() && n < sizeof(digits) - 1 &&
+           (payload[pos + n] == '-' || (payload[pos + n] >= '0' && payload[pos + n] <= '9'))) {
+        digits[n] = payload[pos + n];
+        n++;
+    }
+    if (n == 0) return false;
+    digits[n] = '\0';
+    *out = strtoll(digits, NULL, 10);
+    return true;
+}
+
+static bool findString(std::string_view payload, std::string_view key, std::string_view* out) {
+    size_t pos = findValue(payload, key);
+    if (pos == std::string_view::npos || payload[pos] != '"') return false;
+    size_t end = payload.find('"', pos + 1);
+    if (end == std::string_view::npos) return false;
+    *out = payload.substr(pos + 1, end - pos - 1);
+    return true;
+}
+
+static uint32_t findU32(std::string_view payload, std::string_view key, uint32_t fallback) {
+    int64_t value = 0;
+    return findInt(payload, key, &value) && value >= 0 ? (uint32_t)value : fallback;
+}
+
+// ==================== 报文编解码 ====================
+
+bool otaParseOffer(std::string_view payload, OtaOffer* out) {
+    *out = {};
+    int64_t id = 0;
+    if (!findInt(payload, "ota_id", &id) || id <= 0 || id > 0xFFFF) return false;
+    out->otaId = (uint16_t)id;
+    findString(payload, "version", &out->version);
+    out->size = findU32(payload, "size", 0);
+    out->chunks = findU32(payload, "chunks", 0);
+    out->chunkSize = findU32(payload, "chunk_size", 0);
+    findString(payload, "base_sha256", &out->baseSha);
+    return true;
+}
+
+size_t otaEncodeOffer(char* buf, size_t size, const OtaOffer* offer) {
+    int len = snprintf(buf, size,
+                       "{\"ota_id\":%u,\"version\":\"%.*s\",\"size\":%u,\"chunks\":%u,\"chunk_size\":%u,"
+                       "\"base_sha256\":\"%.*s\"}",
+                       offer->otaId, (int)offer->version.size(), offer->version.data(), offer->size,
+                       offer->chunks, offer->chunkSize, (int)offer->baseSha.size(), offer->baseSha.data());
+    return (len > 0 && (size_t)len < size) ? (size_t)len : 0;
+}
+
+bool otaParseStatus(std::string_view payload, OtaStatusMessage* out) {
+    *out = {};
+    int64_t id = 0;
+    if (!findString(payload, "device_id", &out->deviceId) || out->deviceId.empty() ||
+        !findInt(payload, "ota_id", &id) || !findString(payload, "state", &out->state)) {
+        return false;
+    }
+    out->otaId = (uint16_t)id;
+    out->next = findU32(payload, "next", 0);
+    out->done = findU32(payload, "done", 0);
+    out->chunks = findU32(payload, "chunks", 0);
+    findString(payload, "error", &out->error);
+    findString(payload, "version", &out->version);
+    out->full = findString(payload, "boot", &out->boot);
+    out->bootOtaId = (uint16_t)findU32(payload, "boot_ota_id", 0);
+    int64_t slot = -1;
+    findInt(payload, "slot", &slot);
+    out->slot = (int32_t)slot;
+    out->imageSize = findU32(payload, "image_size", 0);
+    findString(payload, "image_sha256", &out->imageSha);
+    out->window = findU32(payload, "window", OTA_RX_SLOTS);
+    out->chunkMax = findU32(payload, "chunk_max", OTA_CHUNK_MAX);
+    return true;
+}
+
+size_t otaEncodeStatus(char* buf, size_t size, const OtaStatusMessage* s) {
+    char error[48] = "";
+    if (!s->error.empty()) snprintf(error, sizeof(error), "\"error\":\"%.*s\",", (int)s->error.size(), s->error.data());
+    int len = snprintf(buf, size,
+                       "{\"device_id\":\"%.*s\",\"ota_id\":%u,\"state\":\"%.*s\",\"next\":%u,\"done\":%u,"
+                       "\"chunks\":%u,%s\"version\":\"%.*s\",\"slot\":%d,\"boot\":\"%.*s\",\"boot_ota_id\":%u,"
+                       "\"image_size\":%u,\"image_sha256\":\"%.*s\",\"window\":%u,\"chunk_max\":%u}",
+                       (int)s->deviceId.size(), s->deviceId.data(), s->otaId, (int)s->state.size(), s->state.data(),
+                       s->next, s->done, s->chunks, error, (int)s->version.size(), s->version.data(), s->slot,
+                       (int)s->boot.size(), s->boot.data(), s->bootOtaId, s->imageSize, (int)s->imageSha.size(),
+                       s->imageSha.data(), s->window, s->chunkMax);
+    return (len > 0 && (size_t)len < size) ? (size_t)len : 0;
+}
+
+size_t otaEncodeAck(char* buf, size_t size, const OtaStatusMessage* s) {
+    int len = snprintf(buf, size, "{\"device_id\":\"%.*s\",\"ota_id\":%u,\"state\":\"%.*s\",\"next\":%u,\"done\":%u}",
+                       (int)s->deviceId.size(), s->deviceId.data(), s->otaId, (int)s->state.size(), s->state.data(),
+                       s->next, s->done);
+    return (len > 0 && (size_t)len < size) ? (size_t)len : 0;
+}
+
+void otaEncodeDataHeader(uint8_t out[OTA_DATA_HEADER_SIZE], uint16_t otaId, uint32_t index) {
+    out[0] = (uint8_t)otaId;
+    out[1] = (uint8_t)(otaId >> 8);
+    out[2] = 0;
+    out[3] = 0;
+    for (int i = 0; i < 4; i++) out[4 + i] = (uint8_t)(index >> (8 * i));
+}
+
+bool otaParseDataHeader(std::string_view payload, uint16_t* otaId, uint32_t* index) {
+    if (payload.size() <= OTA_DATA_HEADER_SIZE) return false;
+    const uint8_t* p = (const uint8_t*)payload.data();
+    *otaId = (uint16_t)(p[0] | (p[1] << 8));
+    *index = (uint32_t)p[4] | ((uint32_t)p[5] << 8) | ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+    return true;
+}
+
+// ==================== 文件与镜像 ====================
+
+bool otaReadFile(const char* path, std::vector<uint8_t>* data) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    data->clear();
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data->insert(data->end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+bool otaWriteFile(const char* path, const std::vector<uint8_t>& data) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+bool otaReadKeyFile(const char* path, uint8_t* key, size_t size) {
+    std::vector<uint8_t> text;
+    if (!otaReadFile(path, &text)) return false;
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r' || text.back() == ' ')) text.pop_back();
+    if (text.size() != size * 2) {
+        fprintf(stderr, "%s: expected %zu hex digits\n", path, size * 2);
+        return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+        char digits[3] = { (char)text[i * 2], (char)text[i * 2 + 1], 0 };
+        char* end;
+        key[i] = (uint8_t)strtoul(digits, &end, 16);
+        if (end != digits + 2) {
+            fprintf(stderr, "%s: invalid hex\n", path);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool otaWriteKeyFile(const char* path, const uint8_t* key, size_t size, bool secret) {
+    // 私钥不覆盖已有文件，避免误操作丢失正在使用的密钥
+    int fd = open(path, O_WRONLY | O_CREAT | (secret ? O_EXCL : O_TRUNC), secret ? 0600 : 0644);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    std::string text;
+    char digits[3];
+    for (size_t i = 0; i < size; i++) {
+        snprintf(digits, sizeof(digits), "%02x", key[i]);
+        text += digits;
+    }
+    text += '\n';
+    bool ok = write(fd, text.data(), text.size()) == (ssize_t)text.size();
+    close(fd);
+    return ok;
+}
+
+std::string_view otaImageVersion(const std::vector<uint8_t>& image) {
+    std::string_view text((const char*)image.data(), image.size());
+    size_t pos = text.find(OTA_IMAGE_VERSION_TAG);
+    if (pos == std::string_view::npos) return "unknown";
+    pos += sizeof(OTA_IMAGE_VERSION_TAG) - 1;
+    size_t end = text.find('\0', pos);
+    if (end == std::string_view::npos) end = text.size();
+    return text.substr(pos, std::min<size_t>(end - pos, 23));
+}
+
+bool otaImageHasTag(const std::vector<uint8_t>& image, std::string_view tag) {
+    std::string_view text((const char*)image.data(), image.size());
+    return text.find(tag) != std::string_view::npos;
+}
@@ -0,0 +1,297 @@
+#include <string.h>
+#include <algorithm>
+#include "MY_PatchWriter.h"
+#include "MY_OtaPatch.h"
+
+// LZ哈希链：3字节哈希，每个位置最多比较 LZ_CHAIN_DEPTH 个候选
+#define LZ_HASH_BITS        15
+#define LZ_CHAIN_DEPTH      64
+// 近似匹配长度比逐字节对齐的得分多出此值才切换到新的匹配 (bsdiff 取8)
+#define DIFF_SWITCH_MARGIN  8
+
+// ==================== 编码工具 ====================
+
+static void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static void putInstruction(std::vector<uint8_t>& ops, const uint8_t* diff, uint32_t diffLen,
+                           const uint8_t* extra, uint32_t extraLen, int32_t seek) {
+    putVarint(ops, diffLen);
+    putVarint(ops, extraLen);
+    putVarint(ops, ((uint32_t)seek << 1) ^ (uint32_t)(seek >> 31));
+    ops.insert(ops.end(), diff, diff + diffLen);
+    ops.insert(ops.end(), extra, extra + extraLen);
+}
+
+static std::vector<uint8_t> assemble(const OtaPatchHeader& header, const std::vector<uint8_t>& ops,
+                                     const uint8_t seed[ED25519_SEED_SIZE], PatchStats* stats) {
+    std::vector<uint8_t> patch(OTA_PATCH_HEADER_SIZE);
+    otaPatchEncodeHeader(&header, patch.data());
+    otaPatchSignHeader(patch.data(), seed);
+    std::vector<uint8_t> body = patchCompress(ops.data(), ops.size());
+    patch.insert(patch.end(), body.begin(), body.end());
+    stats->rawBytes = ops.size();
+    stats->patchBytes = patch.size();
+    return patch;
+}
+
+static void digest(const std::vector<uint8_t>& data, uint8_t out[SHA256_DIGEST_SIZE]) {
+    Sha256Context sha;
+    sha256Init(&sha);
+    sha256Update(&sha, data.data(), data.size());
+    sha256Final(&sha, out);
+}
+
+// ==================== 后缀数组 ====================
+
+/**
+ * @brief 倍增法构造后缀数组，每轮两次计数排序，O(n log n)
+ */
+static std::vector<int32_t> buildSuffixArray(const uint8_t* s, int32_t n) {
+    std::vector<int32_t> sa(n), rank(n), next(n), order(n);
+    int32_t classes = std::max<int32_t>(256, n) + 2;
+    std::vector<int32_t> count(classes);
+    for (int32_t i = 0; i < n; i++) rank[i] = s[i] + 1;
+
+    for (int32_t k = 1;; k <<= 1) {
+        auto second = [&](int32_t i) { return i + k < n ? rank[i + k] : 0; };
+
+        std::fill(count.begin(), count.end(), 0);
+        for (int32_t i = 0; i < n; i++) count[second(i)]++;
+        for (int32_t c = 1; c < classes; c++) count[c] += count[c - 1];
+        for (int32_t i = n - 1; i >= 0; i--) order[--count[second(i)]] = i;
+
+        std::fill(count.begin(), count.end(), 0);
+        for (int32_t i = 0; i < n; i++) count[rank[i]]++;
+        for (int32_t c = 1; c < classes; c++) count[c] += count[c - 1];
+        for (int32_t j = n - 1; j >= 0; j--) sa[--count[rank[order[j]]]] = order[j];
+
+        next[sa[0]] = 1;
+        for (int32_t j = 1; j < n; j++) {
+            bool same = rank[sa[j]] == rank[sa[j - 1]] && second(sa[j]) == second(sa[j - 1]);
+            next[sa[j]] = next[sa[j - 1]] + (same ? 0 : 1);
+        }
+        rank.swap(next);
+        if (rank[sa[n - 1]] == n || k >= n) break;
+    }
+    return sa;
+}
+
+static int32_t matchLength(const uint8_t* a, int32_t aLen, const uint8_t* b, int32_t bLen) {
+    int32_t i = 0;
+    while (i < aLen && i < bLen && a[i] == b[i]) i++;
+    return i;
+}
+
+/**
+ * @brief 在后缀数组中二分查找与 target 最长的公共前缀
+ */
+static int32_t searchLongest(const std::vector<int32_t>& sa, const uint8_t* base, int32_t baseLen,
+                             const uint8_t* target, int32_t targetLen, int32_t* pos) {
+    int32_t lo = 0;
+    int32_t hi = baseLen - 1;
+    while (hi - lo >= 2) {
+        int32_t mid = lo + (hi - lo) / 2;
+        int32_t len = std::min(baseLen - sa[mid], targetLen);
+        if (memcmp(base + sa[mid], target, (size_t)len) < 0) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    int32_t loLen = matchLength(base + sa[lo], baseLen - sa[lo], target, targetLen);
+    int32_t hiLen = matchLength(base + sa[hi], baseLen - sa[hi], target, targetLen);
+    if (loLen > hiLen) {
+        *pos = sa[lo];
+        return loLen;
+    }
+    *pos = sa[hi];
+    return hiLen;
+}
+
+// ==================== 公共接口 ====================
+
+/**
+ * @brief 生成增量补丁 (bsdiff 的匹配策略)
+ *
+ * 逐位置查找精确最长匹配；当新匹配比沿用上一段对齐方式能多对上 DIFF_SWITCH_MARGIN 字节以上时，
+ * 把上一段对齐向前、新匹配向后各自扩展 (允许不同字节，只要相同字节过半)，
+ * 两段之间剩下的部分作为 extra 原样携带
+ */
+std::vector<uint8_t> patchBuildDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& target,
+                                     const uint8_t seed[ED25519_SEED_SIZE], PatchStats* stats) {
+    *stats = {};
+    const uint8_t* oldData = base.data();
+    const uint8_t* newData = target.data();
+    int32_t oldSize = (int32_t)base.size();
+    int32_t newSize = (int32_t)target.size();
+    std::vector<int32_t> sa = buildSuffixArray(oldData, oldSize);
+
+    std::vector<uint8_t> ops;
+    std::vector<uint8_t> diff;
+    int32_t scan = 0, len = 0, pos = 0;
+    int32_t lastScan = 0, lastPos = 0, lastOffset = 0;
+
+    while (scan < newSize) {
+        int32_t oldScore = 0;
+        int32_t scsc = scan += len;
+        for (; scan < newSize; scan++) {
+            len = searchLongest(sa, oldData, oldSize, newData + scan, newSize - scan, &pos);
+            for (; scsc < scan + len; scsc++) {
+                if (scsc + lastOffset < oldSize && oldData[scsc + lastOffset] == newData[scsc]) oldScore++;
+            }
+            if ((len == oldScore && len != 0) || len > oldScore + DIFF_SWITCH_MARGIN) break;
+            if (scan + lastOffset < oldSize && oldData[scan + lastOffset] == newData[scan]) oldScore--;
+        }
+        if (len == oldScore && scan != newSize) continue;
+
+        // 上一段对齐向前扩展
+        int32_t lenForward = 0;
+        for (int32_t i = 0, s = 0, best = 0; lastScan + i < scan && lastPos + i < oldSize;) {
+            if (oldData[lastPos + i] == newData[lastScan + i]) s++;
+            i++;
+            if (s * 2 - i > best * 2 - lenForward) {
+                best = s;
+                lenForward = i;
+            }
+        }
+        // 新匹配向后扩展
+        int32_t lenBack = 0;
+        if (scan < newSize) {
+            for (int32_t i = 1, s = 0, best = 0; scan >= lastScan + i && pos >= i; i++) {
+                if (oldData[pos - i] == newData[scan - i]) s++;
+                if (s * 2 - i > best * 2 - lenBack) {
+                    best = s;
+                    lenBack = i;
+                }
+            }
+        }
+        // 两段重叠时找最佳分界
+        if (lastScan + lenForward > scan - lenBack) {
+            int32_t overlap = (lastScan + lenForward) - (scan - lenBack);
+            int32_t s = 0, best = 0, split = 0;
+            for (int32_t i = 0; i < overlap; i++) {
+                if (newData[lastScan + lenForward - overlap + i] == oldData[lastPos + lenForward - overlap + i]) s++;
+                if (newData[scan - lenBack + i] == oldData[pos - lenBack + i]) s--;
+                if (s > best) {
+                    best = s;
+                    split = i + 1;
+                }
+            }
+            lenForward += split - overlap;
+            lenBack -= split;
+        }
+
+        diff.resize((size_t)lenForward);
+        for (int32_t i = 0; i < lenForward; i++) {
+            diff[(size_t)i] = (uint8_t)(newData[lastScan + i] - oldData[lastPos + i]);
+        }
+        int32_t extraLen = (scan - lenBack) - (lastScan + lenForward);
+        int32_t seek = (pos - lenBack) - (lastPos + lenForward);
+        putInstruction(ops, diff.data(), (uint32_t)lenForward, newData + lastScan + lenForward,
+                       (uint32_t)extraLen, seek);
+        stats->instructions++;
+        stats->diffBytes += (size_t)lenForward;
+        stats->extraBytes += (size_t)extraLen;
+
+        lastScan = scan - lenBack;
+        lastPos = pos - lenBack;
+        lastOffset = pos - scan;
+    }
+
+    OtaPatchHeader header = {};
+    header.flags = OTA_PATCH_FLAG_DELTA;
+    header.baseSize = (uint32_t)oldSize;
+    header.targetSize = (uint32_t)newSize;
+    digest(base, header.baseSha);
+    digest(target, header.targetSha);
+    return assemble(header, ops, seed, stats);
+}
+
+std::vector<uint8_t> patchBuildFull(const std::vector<uint8_t>& target, const uint8_t seed[ED25519_SEED_SIZE],
+                                    PatchStats* stats) {
+    *stats = {};
+    std::vector<uint8_t> ops;
+    putInstruction(ops, NULL, 0, target.data(), (uint32_t)target.size(), 0);
+    stats->instructions = 1;
+    stats->extraBytes = target.size();
+
+    OtaPatchHeader header = {};
+    header.targetSize = (uint32_t)target.size();
+    digest(target, header.targetSha);
+    return assemble(header, ops, seed, stats);
+}
+
+/**
+ * @brief LZSS压缩，贪心取哈希链上的最长匹配
+ */
+std::vector<uint8_t> patchCompress(const uint8_t* data, size_t len) {
+    std::vector<uint8_t> out;
+    out.reserve(len / 2 + 16);
+    std::vector<int32_t> head((size_t)1 << LZ_HASH_BITS, -1);
+    std::vector<int32_t> prev(len);
+    auto hashAt = [&](size_t i) {
+        uint32_t v = (uint32_t)data[i] | ((uint32_t)data[i + 1] << 8) | ((uint32_t)data[i + 2] << 16);
+        return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+    };
+    auto insert = [&](size_t i) {
+        if (i + OTA_LZ_MIN_MATCH > len) return;
+        uint32_t h = hashAt(i);
+        prev[i] = head[h];
+        head[h] = (int32_t)i;
+    };
+
+    size_t flagPos = 0;
+    int bit = 8;
+    size_t pos = 0;
+    while (pos < len) {
+        if (bit == 8) {
+            flagPos = out.size();
+            out.push_back(0);
+            bit = 0;
+        }
+
+        size_t best = 0;
+        size_t bestDist = 0;
+        if (pos + OTA_LZ_MIN_MATCH <= len) {
+            size_t limit = std::min<size_t>(len - pos, OTA_LZ_MAX_MATCH);
+            int32_t cand = head[hashAt(pos)];
+            for (int depth = 0; cand >= 0 && pos - (size_t)cand <= OTA_LZ_WINDOW && depth < LZ_CHAIN_DEPTH;
+                 depth++, cand = prev[(size_t)cand]) {
+                const uint8_t* a = data + cand;
+                const uint8_t* b = data + pos;
+                if (a[best] != b[best]) continue;
+                size_t l = 0;
+                while (l < limit && a[l] == b[l]) l++;
+                if (l > best) {
+                    best = l;
+                    bestDist = pos - (size_t)cand;
+                    if (l == limit) break;
+                }
+            }
+        }
+
+        if (best >= OTA_LZ_MIN_MATCH) {
+            out[flagPos] |= (uint8_t)(1 << bit);
+            size_t extra = best - OTA_LZ_MIN_MATCH;
+            uint16_t word = (uint16_t)((bestDist - 1) << 4);
+            word |= extra >= OTA_LZ_LEN_EXTENDED ? OTA_LZ_LEN_EXTENDED : (uint16_t)extra;
+            out.push_back((uint8_t)word);
+            out.push_back((uint8_t)(word >> 8));
+            if (extra >= OTA_LZ_LEN_EXTENDED) putVarint(out, (uint32_t)(extra - OTA_LZ_LEN_EXTENDED));
+            for (size_t i = 0; i < best; i++) insert(pos + i);
+            pos += best;
+        } else {
+            out.push_back(data[pos]);
+            insert(pos);
+            pos++;
+        }
+        bit++;
+    }
+    return out;
+}
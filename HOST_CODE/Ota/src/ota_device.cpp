@@ -0,0 +1,473 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "MY_MqttSession.h"
+#include "MY_OtaWire.h"
+#include "MY_OtaPatch.h"
+#include "MY_OtaBoot.h"
+#include "MY_FlashSim.h"
+
+/*
+ * 设备模拟器：按固件 MY_Ota 的流程接收补丁、写入模拟Flash、切换分区并"重启"
+ *   补丁解码、签名校验、试运行记录与SHA-256直接编译固件源码，分区与NVS由 MY_FlashSim 以文件模拟
+ *   -K 为发布者公钥 (ota_keygen 生成的 .pub)，相当于固件的 MY_OtaKey.h
+ *   重启 = 断开MQTT并重新执行启动流程 (读取启动分区与试运行记录)
+ *   镜像含 OTA_IMAGE_NO_CHECKIN_TAG 时启动后不签到，含 OTA_IMAGE_CRASH_TAG 时启动后立即复位
+ */
+
+// ==================== 运行参数 ====================
+#define OTADEV_POLL_MS              20
+#define OTADEV_RETRY_MS             1000
+#define OTADEV_STALL_TIMEOUT_MS     60000
+#define OTADEV_REBOOT_DELAY_MS      500
+#define OTADEV_MAX_BOOTS            20          // 防止模拟器在坏镜像上无限重启
+
+typedef enum {
+    DEV_IDLE = 0,
+    DEV_RECEIVING,
+    DEV_REBOOTING,
+    DEV_FAILED
+} DeviceState;
+
+typedef struct {
+    // 参数
+    std::string host;
+    uint16_t port;
+    std::string deviceId;
+    int64_t windowMs;               // 签到窗口 (固件 OTA_CHECKIN_WINDOW_MS)
+    int64_t stableMs;               // 签到前需平稳运行的时间 (固件 OTA_CHECKIN_STABLE_MS)
+    uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE];
+
+    MqttSession session;
+    FlashSim flash;
+
+    // 本次启动
+    uint8_t runningSlot;
+    std::vector<uint8_t> image;
+    uint8_t imageSha[SHA256_DIGEST_SIZE];
+    char imageHex[SHA256_HEX_SIZE];
+    std::string version;
+    OtaBootRecord record;
+    int64_t bootMs;
+    bool restart;
+
+    // 升级会话
+    DeviceState state;
+    uint16_t otaId;
+    std::string targetVersion;
+    uint32_t chunks;
+    uint32_t chunkSize;
+    uint32_t patchBytes;
+    uint32_t next;
+    const char* error;
+    OtaPatch patch;
+    uint8_t targetSlot;
+    int64_t lastDataMs;
+    int64_t rebootAtMs;
+    bool statusDue;
+    bool ackDue;
+    uint16_t rejectId;
+} OtaDevice;
+
+static volatile sig_atomic_t running = 1;
+
+static void handleSignal(int) {
+    running = 0;
+}
+
+static void printUsage(const char* name) {
+    printf("Usage: %s -d flash_dir -K signing.pub [-I image.bin] [-h host] [-p port] [-i device_id] [-w window_s]"
+           " [-s stable_s]\n", name);
+}
+
+static const char* stateString(DeviceState state) {
+    switch (state) {
+        case DEV_IDLE:      return "idle";
+        case DEV_RECEIVING: return "receiving";
+        case DEV_REBOOTING: return "rebooting";
+        case DEV_FAILED:    return "failed";
+        default:            return "unknown";
+    }
+}
+
+// ==================== 分区读写 ====================
+
+static bool ioReadBase(void* context, uint32_t offset, uint8_t* buf, size_t len) {
+    OtaDevice* dev = (OtaDevice*)context;
+    return flashSimRead(&dev->flash, dev->runningSlot, offset, buf, len);
+}
+
+static bool ioWriteTarget(void* context, uint32_t offset, const uint8_t* buf, size_t len) {
+    OtaDevice* dev = (OtaDevice*)context;
+    return flashSimWrite(&dev->flash, dev->targetSlot, offset, buf, len);
+}
+
+static bool ioReadTarget(void* context, uint32_t offset, uint8_t* buf, size_t len) {
+    OtaDevice* dev = (OtaDevice*)context;
+    return flashSimRead(&dev->flash, dev->targetSlot, offset, buf, len);
+}
+
+// ==================== 启动 ====================
+
+static void rollbackTo(OtaDevice* dev, uint8_t slot, const char* reason) {
+    printf("[OTA] Rolling back to slot %u: %s\n", slot, reason);
+    if (!flashSimSetBoot(&dev->flash, slot)) {
+        printf("[OTA] Rollback failed, keeping current image\n");
+        return;
+    }
+    dev->restart = true;
+}
+
+/**
+ * @brief 启动流程 (对应固件 setupOta + measureRunningImage)
+ * @return false=本次启动未进入主循环 (回滚或崩溃)，需要再次启动
+ */
+static bool bootDevice(OtaDevice* dev) {
+    dev->restart = false;
+    dev->bootMs = mqttSessionNowMs();
+    dev->state = DEV_IDLE;
+    dev->otaId = 0;
+    dev->error = NULL;
+    dev->chunks = dev->next = 0;
+    dev->rejectId = 0;
+    dev->statusDue = true;
+    dev->ackDue = false;
+
+    dev->runningSlot = (uint8_t)dev->flash.meta.bootSlot;
+    flashSimLoadRecord(&dev->flash, &dev->record);
+    OtaBootRecord before = dev->record;
+    OtaBootAction action = otaBootOnStart(&dev->record, dev->runningSlot);
+    if (memcmp(&before, &dev->record, sizeof(OtaBootRecord)) != 0) flashSimSaveRecord(&dev->flash, &dev->record);
+    if (action == OTA_BOOT_ACTION_ROLLBACK) {
+        rollbackTo(dev, dev->record.previousSlot, "too many restarts before check-in");
+        if (dev->restart) return false;
+    }
+
+    if (!flashSimLoadImage(&dev->flash, dev->runningSlot, &dev->image) || dev->image.empty()) {
+        printf("[EMU] Slot %u holds no image\n", dev->runningSlot);
+        running = 0;
+        return false;
+    }
+    Sha256Context sha;
+    sha256Init(&sha);
+    sha256Update(&sha, dev->image.data(), dev->image.size());
+    sha256Final(&sha, dev->imageSha);
+    sha256ToHex(dev->imageSha, dev->imageHex);
+    dev->version = std::string(otaImageVersion(dev->image));
+
+    if (action == OTA_BOOT_ACTION_TRIAL) {
+        printf("[OTA] Trial boot %u/%u of %s, check-in window %llds\n", dev->record.trialBoots,
+               OTA_BOOT_MAX_TRIALS, dev->record.version, (long long)(dev->windowMs / 1000));
+    }
+    if (otaImageHasTag(dev->image, OTA_IMAGE_CRASH_TAG)) {
+        printf("[EMU] Image %s crashes during startup\n", dev->version.c_str());
+        dev->restart = true;
+        return false;
+    }
+
+    if (!dev->record.reported &&
+        (dev->record.state == OTA_BOOT_CONFIRMED || dev->record.state == OTA_BOOT_ROLLED_BACK)) {
+        printf("[ALARM] ota: %s\n",
+               dev->record.state == OTA_BOOT_CONFIRMED ? "update_confirmed" : "update_rolled_back");
+        dev->record.reported = 1;
+        flashSimSaveRecord(&dev->flash, &dev->record);
+    }
+    printf("[OTA] Firmware %s, slot %u, boot %s, image %zu bytes, sha256 %.16s...\n", dev->version.c_str(),
+           dev->runningSlot, otaBootStateString(dev->record.state), dev->image.size(), dev->imageHex);
+    return true;
+}
+
+// ==================== 升级会话 ====================
+
+static void failUpdate(OtaDevice* dev, const char* reason) {
+    dev->state = DEV_FAILED;
+    dev->error = reason;
+    dev->statusDue = true;
+    printf("[OTA] Update %u failed: %s\n", dev->otaId, reason);
+}
+
+static void completeUpdate(OtaDevice* dev) {
+    OtaPatchResult result = otaPatchFinish(&dev->patch);
+    if (result != OTA_PATCH_OK) {
+        failUpdate(dev, otaPatchResultString(result));
+        return;
+    }
+    if (!flashSimSetImage(&dev->flash, dev->targetSlot, dev->patch.header.targetSize) ||
+        !flashSimSetBoot(&dev->flash, dev->targetSlot)) {
+        failUpdate(dev, "set_boot");
+        return;
+    }
+    otaBootArm(&dev->record, dev->otaId, dev->targetVersion.c_str(), dev->version.c_str(), dev->targetSlot,
+               dev->runningSlot);
+    flashSimSaveRecord(&dev->flash, &dev->record);
+    dev->state = DEV_REBOOTING;
+    dev->statusDue = true;
+    dev->rebootAtMs = mqttSessionNowMs() + OTADEV_REBOOT_DELAY_MS;
+    printf("[OTA] Update %u to %s verified (%u bytes from base, %u literal), rebooting into slot %u\n", dev->otaId,
+           dev->targetVersion.c_str(), dev->patch.diffBytes, dev->patch.extraBytes, dev->targetSlot);
+}
+
+static void handleOffer(OtaDevice* dev, std::string_view payload) {
+    OtaOffer offer;
+    if (!otaParseOffer(payload, &offer)) return;
+
+    if (dev->state == DEV_RECEIVING && offer.otaId == dev->otaId) {
+        dev->statusDue = true;
+        return;
+    }
+    if (dev->state == DEV_RECEIVING || dev->state == DEV_REBOOTING) {
+        dev->rejectId = offer.otaId;
+        return;
+    }
+
+    const char* error = NULL;
+    uint8_t baseSha[SHA256_DIGEST_SIZE];
+    if (offer.size == 0 || offer.size > OTA_PATCH_MAX_BYTES || offer.chunkSize == 0 ||
+        offer.chunkSize > OTA_CHUNK_MAX || offer.chunks != (offer.size + offer.chunkSize - 1) / offer.chunkSize ||
+        offer.version.size() >= OTA_VERSION_SIZE) {
+        error = "bad_offer";
+    } else if (!offer.baseSha.empty() &&
+               (!sha256FromHex(offer.baseSha.data(), offer.baseSha.size(), baseSha) ||
+                memcmp(baseSha, dev->imageSha, SHA256_DIGEST_SIZE) != 0)) {
+        error = "base_mismatch";
+    }
+
+    dev->otaId = offer.otaId;
+    dev->targetVersion = std::string(offer.version);
+    dev->chunks = offer.chunks;
+    dev->chunkSize = offer.chunkSize;
+    dev->patchBytes = offer.size;
+    dev->next = 0;
+    dev->error = error;
+    dev->statusDue = true;
+    if (error != NULL) {
+        dev->state = DEV_FAILED;
+        printf("[OTA] Offer %u rejected: %s\n", offer.otaId, error);
+        return;
+    }
+    dev->state = DEV_RECEIVING;
+    dev->lastDataMs = mqttSessionNowMs();
+    printf("[OTA] Offer %u accepted: %s, %u bytes in %u chunks%s\n", offer.otaId, dev->targetVersion.c_str(),
+           offer.size, offer.chunks, offer.baseSha.empty() ? "" : " (delta)");
+}
+
+/**
+ * @brief 只接受下一个期望的块，收到即写入 (固件经接收槽位交给OTA任务)
+ */
+static void handleData(OtaDevice* dev, std::string_view payload) {
+    uint16_t id;
+    uint32_t index;
+    if (!otaParseDataHeader(payload, &id, &index) || dev->state != DEV_RECEIVING || id != dev->otaId) return;
+    dev->ackDue = true;
+
+    uint32_t dataLen = (uint32_t)(payload.size() - OTA_DATA_HEADER_SIZE);
+    uint32_t expectedLen = index + 1 < dev->chunks ? dev->chunkSize : dev->patchBytes - index * dev->chunkSize;
+    if (index != dev->next || dataLen != expectedLen) return;
+
+    if (index == 0) {
+        dev->targetSlot = (uint8_t)(1 - dev->runningSlot);
+        if (!flashSimErase(&dev->flash, dev->targetSlot)) {
+            failUpdate(dev, "ota_begin");
+            return;
+        }
+        OtaPatchIo io = {};
+        io.context = dev;
+        io.readBase = ioReadBase;
+        io.writeTarget = ioWriteTarget;
+        io.readTarget = ioReadTarget;
+        io.targetCapacity = FLASH_SIM_SLOT_SIZE;
+        otaPatchBegin(&dev->patch, &io, dev->publicKey, (uint32_t)dev->image.size(), dev->imageSha);
+    }
+
+    OtaPatchResult result = otaPatchFeed(&dev->patch, (const uint8_t*)payload.data() + OTA_DATA_HEADER_SIZE, dataLen);
+    if (result != OTA_PATCH_OK) {
+        failUpdate(dev, otaPatchResultString(result));
+        return;
+    }
+    dev->next++;
+    dev->lastDataMs = mqttSessionNowMs();
+    if (dev->next == dev->chunks) completeUpdate(dev);
+}
+
+static void handleMessage(void* context, std::string_view topic, std::string_view payload) {
+    OtaDevice* dev = (OtaDevice*)context;
+    if (topic == std::string(OTA_TOPIC_DATA) + dev->deviceId) {
+        handleData(dev, payload);
+    } else if (topic == std::string(OTA_TOPIC_OFFER) + dev->deviceId) {
+        handleOffer(dev, payload);
+    }
+}
+
+// ==================== 签到、计时与状态 ====================
+
+static void checkIn(OtaDevice* dev) {
+    if (mqttSessionNowMs() - dev->bootMs < dev->stableMs || otaImageHasTag(dev->image, OTA_IMAGE_NO_CHECKIN_TAG)) {
+        return;
+    }
+    if (!otaBootCheckIn(&dev->record)) return;
+    dev->record.reported = 1;
+    dev->statusDue = true;
+    flashSimSaveRecord(&dev->flash, &dev->record);
+    printf("[ALARM] ota: update_confirmed\n");
+    printf("[OTA] Firmware %s checked in after %llds\n", dev->record.version,
+           (long long)((mqttSessionNowMs() - dev->bootMs) / 1000));
+}
+
+static void deviceTimers(OtaDevice* dev) {
+    int64_t now = mqttSessionNowMs();
+    if (dev->state == DEV_RECEIVING && now - dev->lastDataMs > OTADEV_STALL_TIMEOUT_MS) {
+        failUpdate(dev, "stalled");
+    }
+    if (dev->state == DEV_REBOOTING && now >= dev->rebootAtMs) {
+        printf("[OTA] Restarting into new firmware\n");
+        dev->restart = true;
+    }
+    if (dev->record.state == OTA_BOOT_TRIAL && now - dev->bootMs > dev->windowMs) {
+        int slot = otaBootExpire(&dev->record);
+        if (slot >= 0) {
+            flashSimSaveRecord(&dev->flash, &dev->record);
+            rollbackTo(dev, (uint8_t)slot, "no check-in within window");
+        }
+    }
+}
+
+static void publishStatus(OtaDevice* dev) {
+    OtaStatusMessage status = {};
+    status.deviceId = dev->deviceId;
+    status.otaId = dev->otaId;
+    status.state = stateString(dev->state);
+    status.next = dev->next;
+    status.done = dev->next;
+
+    char payload[OTA_PAYLOAD_MAX];
+    size_t len = 0;
+    if (dev->statusDue) {
+        status.chunks = dev->chunks;
+        status.error = dev->error != NULL ? dev->error : "";
+        status.version = dev->version;
+        status.slot = dev->runningSlot;
+        status.boot = otaBootStateString(dev->record.state);
+        status.bootOtaId = dev->record.otaId;
+        status.imageSize = (uint32_t)dev->image.size();
+        status.imageSha = dev->imageHex;
+        status.window = OTA_RX_SLOTS;
+        status.chunkMax = OTA_CHUNK_MAX;
+        len = otaEncodeStatus(payload, sizeof(payload), &status);
+    } else if (dev->ackDue) {
+        len = otaEncodeAck(payload, sizeof(payload), &status);
+    }
+
+    if (dev->rejectId != 0) {
+        char reject[128];
+        int rejectLen = snprintf(reject, sizeof(reject),
+                                 "{\"device_id\":\"%s\",\"ota_id\":%u,\"state\":\"rejected\",\"error\":\"busy\"}",
+                                 dev->deviceId.c_str(), dev->rejectId);
+        if (mqttSessionPublish(&dev->session, OTA_TOPIC_STATUS, std::string_view(reject, (size_t)rejectLen))) {
+            dev->rejectId = 0;
+        }
+    }
+    if (len > 0 && mqttSessionPublish(&dev->session, OTA_TOPIC_STATUS, std::string_view(payload, len))) {
+        dev->statusDue = false;
+        dev->ackDue = false;
+    }
+}
+
+/**
+ * @brief 一次启动后的主循环，需要重启时返回
+ */
+static void runDevice(OtaDevice* dev) {
+    std::string offerTopic = std::string(OTA_TOPIC_OFFER) + dev->deviceId;
+    std::string dataTopic = std::string(OTA_TOPIC_DATA) + dev->deviceId;
+
+    while (running && !dev->restart) {
+        if (dev->session.fd < 0) {
+            if (!mqttSessionConnect(&dev->session, dev->host.c_str(), dev->port, dev->deviceId.c_str()) ||
+                !mqttSessionSubscribe(&dev->session, offerTopic.c_str()) ||
+                !mqttSessionSubscribe(&dev->session, dataTopic.c_str())) {
+                mqttSessionClose(&dev->session);
+                usleep(OTADEV_RETRY_MS * 1000);
+                deviceTimers(dev);
+                continue;
+            }
+            dev->statusDue = true;
+        }
+
+        if (!mqttSessionPoll(&dev->session, OTADEV_POLL_MS, handleMessage, dev)) {
+            printf("[MQTT] Connection lost\n");
+            mqttSessionClose(&dev->session);
+            continue;
+        }
+        checkIn(dev);
+        deviceTimers(dev);
+        publishStatus(dev);
+    }
+    mqttSessionClose(&dev->session);
+}
+
+// ==================== 主函数 ====================
+
+int main(int argc, char** argv) {
+    const char* flashDir = NULL;
+    const char* provisionPath = NULL;
+    const char* keyPath = NULL;
+
+    static OtaDevice dev;
+    dev.host = "127.0.0.1";
+    dev.port = 1883;
+    dev.deviceId = "esp32_fire_alarm_001";
+    dev.windowMs = 300000;
+    dev.stableMs = 30000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:K:I:h:p:i:w:s:")) != -1) {
+        switch (opt) {
+            case 'd': flashDir = optarg; break;
+            case 'K': keyPath = optarg; break;
+            case 'I': provisionPath = optarg; break;
+            case 'h': dev.host = optarg; break;
+            case 'p': dev.port = (uint16_t)atoi(optarg); break;
+            case 'i': dev.deviceId = optarg; break;
+            case 'w': dev.windowMs = (int64_t)(atof(optarg) * 1000); break;
+            case 's': dev.stableMs = (int64_t)(atof(optarg) * 1000); break;
+            default:
+                printUsage(argv[0]);
+                return 2;
+        }
+    }
+    if (flashDir == NULL || keyPath == NULL) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (!otaReadKeyFile(keyPath, dev.publicKey, sizeof(dev.publicKey))) return 1;
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    mqttSessionInit(&dev.session);
+    if (!flashSimOpen(&dev.flash, flashDir)) return 1;
+    if (provisionPath != NULL) {
+        std::vector<uint8_t> image;
+        if (!otaReadFile(provisionPath, &image) || !flashSimProvision(&dev.flash, 0, image)) {
+            fprintf(stderr, "provisioning %s failed\n", provisionPath);
+            return 1;
+        }
+        printf("[EMU] Flashed %s (%zu bytes) into slot 0\n", provisionPath, image.size());
+    }
+
+    for (int boots = 0; running; boots++) {
+        if (boots == OTADEV_MAX_BOOTS) {
+            printf("[EMU] Giving up after %d boots\n", boots);
+            break;
+        }
+        printf("[EMU] ---- boot %d (slot %u) ----\n", boots + 1, dev.flash.meta.bootSlot);
+        if (bootDevice(&dev)) runDevice(&dev);
+    }
+
+    flashSimClose(&dev.flash);
+    return 0;
+}
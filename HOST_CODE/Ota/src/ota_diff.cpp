@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <algorithm>
+#include <vector>
+#include "MY_OtaWire.h"
+#include "MY_PatchWriter.h"
+#include "MY_OtaPatch.h"
+#include "MY_MqttSession.h"
+
+/*
+ * 生成固件补丁：
+ *   ota_diff -k signing.key old.bin new.bin out.patch     以 old 为基准的增量补丁
+ *   ota_diff -k signing.key -f new.bin out.patch          完整镜像 (压缩)
+ * 头部用 signing.key (ota_keygen 生成的私钥种子) 签名，设备拒绝未签名或签名不符的补丁
+ * 生成后用固件同一份解码源码按 OTA_CHUNK_MAX 分块应用一遍 (含签名校验)，结果与 new.bin 逐字节比较
+ */
+
+// 内存中的"分区"
+typedef struct {
+    const std::vector<uint8_t>* base;
+    std::vector<uint8_t> target;
+} MemoryFlash;
+
+static bool memReadBase(void* context, uint32_t offset, uint8_t* buf, size_t len) {
+    const MemoryFlash* flash = (const MemoryFlash*)context;
+    if ((size_t)offset + len > flash->base->size()) return false;
+    memcpy(buf, flash->base->data() + offset, len);
+    return true;
+}
+
+static bool memWriteTarget(void* context, uint32_t offset, const uint8_t* buf, size_t len) {
+    MemoryFlash* flash = (MemoryFlash*)context;
+    if (offset != flash->target.size()) return false;
+    flash->target.insert(flash->target.end(), buf, buf + len);
+    return true;
+}
+
+static bool memReadTarget(void* context, uint32_t offset, uint8_t* buf, size_t len) {
+    const MemoryFlash* flash = (const MemoryFlash*)context;
+    if ((size_t)offset + len > flash->target.size()) return false;
+    memcpy(buf, flash->target.data() + offset, len);
+    return true;
+}
+
+/**
+ * @brief 按设备的方式应用补丁并与目标比较
+ */
+static bool verifyPatch(const std::vector<uint8_t>& patchData, const std::vector<uint8_t>& base,
+                        const std::vector<uint8_t>& target, const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE],
+                        double* applyMs) {
+    MemoryFlash flash = { &base, {} };
+    OtaPatchIo io = {};
+    io.context = &flash;
+    io.readBase = memReadBase;
+    io.writeTarget = memWriteTarget;
+    io.readTarget = memReadTarget;
+    io.targetCapacity = OTA_PATCH_MAX_BYTES * 2;
+
+    uint8_t baseSha[SHA256_DIGEST_SIZE];
+    Sha256Context sha;
+    sha256Init(&sha);
+    sha256Update(&sha, base.data(), base.size());
+    sha256Final(&sha, baseSha);
+
+    static OtaPatch patch;
+    int64_t start = mqttSessionNowMs();
+    otaPatchBegin(&patch, &io, publicKey, (uint32_t)base.size(), baseSha);
+    OtaPatchResult result = OTA_PATCH_OK;
+    for (size_t offset = 0; offset < patchData.size() && result == OTA_PATCH_OK; offset += OTA_CHUNK_MAX) {
+        size_t len = std::min<size_t>(OTA_CHUNK_MAX, patchData.size() - offset);
+        result = otaPatchFeed(&patch, patchData.data() + offset, len);
+    }
+    if (result == OTA_PATCH_OK) result = otaPatchFinish(&patch);
+    *applyMs = (double)(mqttSessionNowMs() - start);
+
+    if (result != OTA_PATCH_OK) {
+        fprintf(stderr, "verify: apply failed: %s\n", otaPatchResultString(result));
+        return false;
+    }
+    if (flash.target != target) {
+        fprintf(stderr, "verify: output differs from target\n");
+        return false;
+    }
+    return true;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s -k signing.key old.bin new.bin out.patch\n"
+            "       %s -k signing.key -f new.bin out.patch\n",
+            prog, prog);
+}
+
+int main(int argc, char** argv) {
+    bool full = false;
+    const char* keyPath = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "fk:")) != -1) {
+        if (opt == 'f') {
+            full = true;
+        } else if (opt == 'k') {
+            keyPath = optarg;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    int files = argc - optind;
+    if (keyPath == NULL || (full && files != 2) || (!full && files != 3)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    uint8_t seed[ED25519_SEED_SIZE];
+    uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE];
+    if (!otaReadKeyFile(keyPath, seed, sizeof(seed))) return 1;
+    ed25519PublicKey(seed, publicKey);
+
+    std::vector<uint8_t> base;
+    std::vector<uint8_t> target;
+    if (!full && !otaReadFile(argv[optind], &base)) return 1;
+    if (!otaReadFile(argv[argc - 2], &target)) return 1;
+    if (target.empty() || (!full && base.empty())) {
+        fprintf(stderr, "empty image\n");
+        return 1;
+    }
+
+    PatchStats stats;
+    int64_t start = mqttSessionNowMs();
+    std::vector<uint8_t> patch = full ? patchBuildFull(target, seed, &stats)
+                                      : patchBuildDelta(base, target, seed, &stats);
+    int64_t buildMs = mqttSessionNowMs() - start;
+    if (patch.size() > OTA_PATCH_MAX_BYTES) {
+        fprintf(stderr, "patch too large: %zu bytes (max %d)\n", patch.size(), OTA_PATCH_MAX_BYTES);
+        return 1;
+    }
+
+    double applyMs = 0;
+    if (!verifyPatch(patch, base, target, publicKey, &applyMs)) return 1;
+    if (!otaWriteFile(argv[argc - 1], patch)) return 1;
+
+    size_t chunks = (patch.size() + OTA_CHUNK_MAX - 1) / OTA_CHUNK_MAX;
+    printf("%s: %s patch %zu bytes (%.2f%% of %zu byte image), %zu chunks of %d\n", argv[argc - 1],
+           full ? "full" : "delta", patch.size(), 100.0 * (double)patch.size() / (double)target.size(),
+           target.size(), chunks, OTA_CHUNK_MAX);
+    printf("  instructions=%zu from_base=%zu literal=%zu stream=%zu build=%lldms verify=%.0fms\n",
+           stats.instructions, stats.diffBytes, stats.extraBytes, stats.rawBytes, (long long)buildMs, applyMs);
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <string>
+#include <vector>
+#include "MY_OtaWire.h"
+#include "MY_Sha256.h"
+
+/*
+ * 合成固件镜像 (没有 ESP32 工具链时用于测试补丁大小与端到端流程)
+ *   镜像由若干"函数"组成：指令字取自有限的指令表 (与真实代码一样可压缩)，
+ *   每个函数含若干绝对地址，指向其它函数；其后是字符串表、版本标记与SHA-256
+ *   -c N 在同一基础上做 N 处修改 (插入/删除指令、改常量、新增函数)，重新排布后
+ *   修改点之后的地址全部平移，与重新编译链接后的固件相似
+ */
+
+#define IMAGE_LOAD_ADDRESS      0x42000000u
+#define IMAGE_OPCODES           512
+
+struct Function {
+    std::vector<uint32_t> words;
+    std::vector<std::pair<size_t, size_t>> refs;    // (指令下标, 目标函数)
+};
+
+static uint64_t rngState = 1;
+
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)(rngState >> 16);
+}
+
+static void seedRandom(uint64_t seed) {
+    rngState = seed * 0x9E3779B97F4A7C15ull + 1;
+    for (int i = 0; i < 8; i++) nextRandom();
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-s size_kb] [-S seed] [-c changes] [-C change_seed] [-V version] [-b no_checkin|crash] out.bin\n",
+            prog);
+}
+
+static uint32_t randomInstruction(const std::vector<uint32_t>& opcodes) {
+    // 指令表 + 少量寄存器/立即数位
+    return opcodes[nextRandom() % IMAGE_OPCODES] ^ ((nextRandom() & 0x7) << 12);
+}
+
+static Function randomFunction(const std::vector<uint32_t>& opcodes, size_t functionCount) {
+    Function fn;
+    size_t words = 16 + nextRandom() % 240;
+    for (size_t i = 0; i < words; i++) {
+        fn.words.push_back(randomInstruction(opcodes));
+        if (nextRandom() % 12 == 0 && functionCount > 0) {
+            fn.refs.push_back({fn.words.size() - 1, nextRandom() % functionCount});
+        }
+    }
+    return fn;
+}
+
+/**
+ * @brief 在函数表上做一处修改
+ */
+static void mutate(std::vector<Function>& functions, const std::vector<uint32_t>& opcodes) {
+    Function& fn = functions[nextRandom() % functions.size()];
+    switch (nextRandom() % 4) {
+        case 0: {
+            // 插入几条指令
+            size_t at = nextRandom() % (fn.words.size() + 1);
+            size_t count = 1 + nextRandom() % 12;
+            for (size_t i = 0; i < count; i++) fn.words.insert(fn.words.begin() + (long)at, randomInstruction(opcodes));
+            for (auto& ref : fn.refs) {
+                if (ref.first >= at) ref.first += count;
+            }
+            break;
+        }
+        case 1: {
+            // 删除几条指令 (不删地址所在的指令)
+            if (fn.words.size() < 24) break;
+            size_t at = nextRandom() % (fn.words.size() - 8);
+            size_t count = 1 + nextRandom() % 6;
+            bool hit = false;
+            for (auto& ref : fn.refs) hit |= ref.first >= at && ref.first < at + count;
+            if (hit) break;
+            fn.words.erase(fn.words.begin() + (long)at, fn.words.begin() + (long)(at + count));
+            for (auto& ref : fn.refs) {
+                if (ref.first >= at + count) ref.first -= count;
+            }
+            break;
+        }
+        case 2:
+            // 修改常量
+            fn.words[nextRandom() % fn.words.size()] ^= nextRandom() & 0xFFF;
+            break;
+        default: {
+            // 新增函数并从某处调用
+            size_t at = nextRandom() % (functions.size() + 1);
+            for (auto& other : functions) {
+                for (auto& ref : other.refs) {
+                    if (ref.second >= at) ref.second++;
+                }
+            }
+            functions.insert(functions.begin() + (long)at, randomFunction(opcodes, functions.size()));
+            Function& caller = functions[nextRandom() % functions.size()];
+            caller.words.push_back(0);
+            caller.refs.push_back({caller.words.size() - 1, at});
+            break;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t sizeKb = 1024;
+    uint64_t seed = 1;
+    int changes = 0;
+    uint64_t changeSeed = 2;
+    const char* version = "1.0.0";
+    const char* behaviour = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:S:c:C:V:b:")) != -1) {
+        switch (opt) {
+            case 's': sizeKb = (size_t)atoi(optarg); break;
+            case 'S': seed = strtoull(optarg, NULL, 10); break;
+            case 'c': changes = atoi(optarg); break;
+            case 'C': changeSeed = strtoull(optarg, NULL, 10); break;
+            case 'V': version = optarg; break;
+            case 'b': behaviour = optarg; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (optind + 1 != argc || sizeKb == 0 ||
+        (behaviour != NULL && strcmp(behaviour, "no_checkin") != 0 && strcmp(behaviour, "crash") != 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // 基础代码：由 seed 决定
+    seedRandom(seed);
+    std::vector<uint32_t> opcodes(IMAGE_OPCODES);
+    for (auto& op : opcodes) op = nextRandom() & 0xFFFF0FFF;
+    std::vector<Function> functions;
+    size_t codeBytes = sizeKb * 1024 * 4 / 5;
+    for (size_t total = 0; total < codeBytes;) {
+        functions.push_back(randomFunction(opcodes, functions.size() + 64));
+        total += functions.back().words.size() * 4;
+    }
+    for (auto& fn : functions) {
+        for (auto& ref : fn.refs) ref.second %= functions.size();
+    }
+    static const char* dictionary[] = {"sensor", "zone", "alarm", "pump", "fan", "mqtt", "publish", "timeout",
+                                       "[MQTT]", "[FUSION]", "failed", "connected", "level", "threshold", "%d", "%s"};
+    std::string strings;
+    while (strings.size() < sizeKb * 1024 / 5) {
+        int words = 2 + (int)(nextRandom() % 6);
+        for (int i = 0; i < words; i++) {
+            strings += dictionary[nextRandom() % 16];
+            strings += i + 1 < words ? ' ' : '\0';
+        }
+    }
+
+    // 修改：由 change_seed 决定
+    seedRandom(changeSeed);
+    for (int i = 0; i < changes; i++) mutate(functions, opcodes);
+
+    // 排布并回填地址
+    std::vector<size_t> offsets(functions.size());
+    size_t offset = 24;
+    for (size_t i = 0; i < functions.size(); i++) {
+        offsets[i] = offset;
+        offset += functions[i].words.size() * 4;
+    }
+    std::vector<uint8_t> image(24, 0);
+    image[0] = 0xE9;                    // ESP32 镜像魔数
+    image[1] = 1;
+    for (size_t i = 0; i < functions.size(); i++) {
+        for (const auto& ref : functions[i].refs) {
+            functions[i].words[ref.first] = IMAGE_LOAD_ADDRESS + (uint32_t)offsets[ref.second];
+        }
+        for (uint32_t word : functions[i].words) {
+            for (int b = 0; b < 4; b++) image.push_back((uint8_t)(word >> (8 * b)));
+        }
+    }
+    image.insert(image.end(), strings.begin(), strings.end());
+    std::string tags = std::string(OTA_IMAGE_VERSION_TAG) + version + '\0';
+    if (behaviour != NULL) {
+        tags += strcmp(behaviour, "crash") == 0 ? OTA_IMAGE_CRASH_TAG : OTA_IMAGE_NO_CHECKIN_TAG;
+        tags += '\0';
+    }
+    image.insert(image.end(), tags.begin(), tags.end());
+    while (image.size() % 16 != 0) image.push_back(0);
+
+    // 与 esp_image 一样在末尾附加整个镜像的SHA-256
+    Sha256Context sha;
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256Init(&sha);
+    sha256Update(&sha, image.data(), image.size());
+    sha256Final(&sha, digest);
+    image.insert(image.end(), digest, digest + SHA256_DIGEST_SIZE);
+
+    if (!otaWriteFile(argv[optind], image)) return 1;
+    printf("%s: %zu bytes, %zu functions, version %s%s%s\n", argv[optind], image.size(), functions.size(), version,
+           behaviour != NULL ? ", " : "", behaviour != NULL ? behaviour : "");
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/random.h>
+#include <string>
+#include "MY_OtaWire.h"
+#include "MY_Ed25519.h"
+
+/*
+ * 补丁签名密钥：
+ *   ota_keygen signing.key                       生成私钥种子 signing.key (0600) 与公钥 signing.pub
+ *   ota_keygen -H include/MY_OtaKey.h signing.key 同时生成固件的公钥头文件
+ * signing.key 已存在时不覆盖，只由它重新导出 .pub 与头文件 (换机器或重新生成头文件时使用)
+ * 私钥只保存在发布补丁的主机上，不要提交到仓库
+ */
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [-H MY_OtaKey.h] signing.key\n", prog);
+}
+
+static bool writeHeader(const char* path, const uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE], const char* keyPath) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "#ifndef MY_OTA_KEY_H\n#define MY_OTA_KEY_H\n\n");
+    fprintf(f, "#include <stdint.h>\n#include \"MY_Ed25519.h\"\n\n");
+    fprintf(f, "// ==================== 固件补丁签名公钥 ====================\n");
+    fprintf(f, "// 由 HOST_CODE/Ota 的 ota_keygen 生成，不要手工修改\n");
+    fprintf(f, "// 对应私钥 %s 只保存在发布补丁的主机上，不进入仓库\n\n", keyPath);
+    fprintf(f, "#define OTA_SIGNING_KEY_SET         1\n\n");
+    fprintf(f, "static const uint8_t otaSigningPublicKey[ED25519_PUBLIC_KEY_SIZE] = {\n");
+    for (int i = 0; i < ED25519_PUBLIC_KEY_SIZE; i++) {
+        fprintf(f, "%s0x%02x%s", i % 8 == 0 ? "    " : "", publicKey[i],
+                i == ED25519_PUBLIC_KEY_SIZE - 1 ? "\n" : (i % 8 == 7 ? ",\n" : ", "));
+    }
+    fprintf(f, "};\n\n#endif\n");
+    return fclose(f) == 0;
+}
+
+int main(int argc, char** argv) {
+    const char* headerPath = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "H:")) != -1) {
+        if (opt == 'H') {
+            headerPath = optarg;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (argc - optind != 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    const char* keyPath = argv[optind];
+
+    uint8_t seed[ED25519_SEED_SIZE];
+    if (access(keyPath, F_OK) == 0) {
+        if (!otaReadKeyFile(keyPath, seed, sizeof(seed))) return 1;
+        printf("%s: using existing key\n", keyPath);
+    } else {
+        if (getrandom(seed, sizeof(seed), 0) != (ssize_t)sizeof(seed)) {
+            perror("getrandom");
+            return 1;
+        }
+        if (!otaWriteKeyFile(keyPath, seed, sizeof(seed), true)) return 1;
+        printf("%s: new signing key\n", keyPath);
+    }
+
+    uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE];
+    ed25519PublicKey(seed, publicKey);
+    std::string pubPath = keyPath;
+    size_t dot = pubPath.rfind('.');
+    if (dot != std::string::npos && pubPath.find('/', dot) == std::string::npos) pubPath.resize(dot);
+    pubPath += ".pub";
+    if (!otaWriteKeyFile(pubPath.c_str(), publicKey, sizeof(publicKey), false)) return 1;
+    printf("%s: public key\n", pubPath.c_str());
+
+    if (headerPath != NULL) {
+        if (!writeHeader(headerPath, publicKey, keyPath)) return 1;
+        printf("%s: firmware public key header\n", headerPath);
+    }
+    return 0;
+}
@@ -0,0 +1,323 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "MY_MqttSession.h"
+#include "MY_OtaWire.h"
+#include "MY_OtaPatch.h"
+
+// ==================== 运行参数 ====================
+#define OTASRV_POLL_MS              20
+#define OTASRV_OFFER_RETRY_MS       2000        // 未收到应答时重发描述
+#define OTASRV_RETRANSMIT_MS        2000        // 进度停滞时从 next 重发
+#define OTASRV_RETRY_MS             1000
+
+// 退出码
+#define OTASRV_EXIT_CONFIRMED       0           // 新镜像已签到
+#define OTASRV_EXIT_FAILED          1           // 升级失败或超时
+#define OTASRV_EXIT_USAGE           2
+#define OTASRV_EXIT_ROLLED_BACK     3           // 新镜像未签到，设备已回到原镜像
+
+typedef enum {
+    PHASE_OFFERING = 0,             // 等待设备接受描述
+    PHASE_SENDING,                  // 发送数据块
+    PHASE_WAIT_BOOT,                // 设备已切换分区，等待签到或回滚
+    PHASE_DONE
+} ServerPhase;
+
+typedef struct {
+    MqttSession* session;
+    std::string deviceId;
+    std::string version;
+    std::string offerTopic;
+    std::string dataTopic;
+    const char* fullPath;           // 基准不匹配时改发的完整镜像补丁 (可为NULL)
+    uint32_t chunkSize;
+
+    std::vector<uint8_t> patch;
+    bool usingFull;
+    std::string baseHex;
+    uint16_t otaId;
+    ServerPhase phase;
+    int exitCode;
+
+    uint32_t chunks;
+    uint32_t window;
+    uint32_t sent;                  // 已发送到的块序号
+    uint32_t next;                  // 设备已接收
+    uint32_t done;                  // 设备已写入
+    int64_t lastOfferMs;
+    int64_t lastProgressMs;
+    int64_t transferStartMs;
+    uint64_t chunksSent;
+    uint64_t retransmits;
+    bool trialSeen;
+} OtaServer;
+
+static volatile sig_atomic_t running = 1;
+
+static void handleSignal(int) {
+    running = 0;
+}
+
+static void printUsage(const char* name) {
+    printf("Usage: %s -P patch -V version [-F full_patch] [-h host] [-p port] [-i device_id] [-n ota_id]\n"
+           "          [-c chunk_size] [-t timeout_s]\n", name);
+}
+
+// ==================== 补丁 ====================
+
+static bool loadPatch(OtaServer* srv, const char* path, bool full) {
+    if (!otaReadFile(path, &srv->patch)) return false;
+    OtaPatchHeader header;
+    if (srv->patch.size() < OTA_PATCH_HEADER_SIZE || !otaPatchDecodeHeader(srv->patch.data(), &header)) {
+        fprintf(stderr, "%s: not an OTA patch\n", path);
+        return false;
+    }
+    if (srv->patch.size() > OTA_PATCH_MAX_BYTES) {
+        fprintf(stderr, "%s: %zu bytes exceeds device limit\n", path, srv->patch.size());
+        return false;
+    }
+
+    srv->usingFull = (header.flags & OTA_PATCH_FLAG_DELTA) == 0;
+    if (full && !srv->usingFull) {
+        fprintf(stderr, "%s: expected a full-image patch\n", path);
+        return false;
+    }
+    char hex[SHA256_HEX_SIZE] = "";
+    if (!srv->usingFull) sha256ToHex(header.baseSha, hex);
+    srv->baseHex = hex;
+    srv->chunks = (uint32_t)((srv->patch.size() + srv->chunkSize - 1) / srv->chunkSize);
+
+    char target[SHA256_HEX_SIZE];
+    sha256ToHex(header.targetSha, target);
+    printf("[OTASRV] %s: %s patch %zu bytes -> %u byte image (sha256 %.16s...), %u chunks\n", path,
+           srv->usingFull ? "full" : "delta", srv->patch.size(), header.targetSize, target, srv->chunks);
+    return true;
+}
+
+// ==================== 发送 ====================
+
+static void publishOffer(OtaServer* srv) {
+    OtaOffer offer = {};
+    offer.otaId = srv->otaId;
+    offer.version = srv->version;
+    offer.size = (uint32_t)srv->patch.size();
+    offer.chunks = srv->chunks;
+    offer.chunkSize = srv->chunkSize;
+    offer.baseSha = srv->baseHex;
+
+    char payload[OTA_PAYLOAD_MAX];
+    size_t len = otaEncodeOffer(payload, sizeof(payload), &offer);
+    if (len > 0) mqttSessionPublish(srv->session, srv->offerTopic, std::string_view(payload, len));
+    srv->lastOfferMs = mqttSessionNowMs();
+}
+
+static void publishChunk(OtaServer* srv, uint32_t index) {
+    size_t offset = (size_t)index * srv->chunkSize;
+    size_t len = std::min<size_t>(srv->chunkSize, srv->patch.size() - offset);
+    static uint8_t payload[OTA_DATA_HEADER_SIZE + OTA_CHUNK_MAX];
+    otaEncodeDataHeader(payload, srv->otaId, index);
+    memcpy(payload + OTA_DATA_HEADER_SIZE, srv->patch.data() + offset, len);
+    mqttSessionPublish(srv->session, srv->dataTopic,
+                       std::string_view((const char*)payload, OTA_DATA_HEADER_SIZE + len));
+    srv->chunksSent++;
+}
+
+/**
+ * @brief 窗口内发送：设备最多缓存 window 块，只发送 done + window 以内的块
+ *        进度停滞 OTASRV_RETRANSMIT_MS 后从设备的 next 重发 (回退N帧)
+ */
+static void pumpChunks(OtaServer* srv) {
+    int64_t now = mqttSessionNowMs();
+    if (srv->next < srv->chunks && now - srv->lastProgressMs > OTASRV_RETRANSMIT_MS) {
+        srv->retransmits += srv->sent - srv->next;
+        srv->sent = srv->next;
+        srv->lastProgressMs = now;
+        printf("[OTASRV] No progress, resending from chunk %u\n", srv->next);
+    }
+    while (srv->sent < srv->chunks && srv->sent < srv->done + srv->window) {
+        publishChunk(srv, srv->sent++);
+    }
+}
+
+// ==================== 状态处理 ====================
+
+static void finish(OtaServer* srv, int exitCode) {
+    srv->phase = PHASE_DONE;
+    srv->exitCode = exitCode;
+}
+
+static void startOffer(OtaServer* srv, uint16_t otaId) {
+    srv->otaId = otaId;
+    srv->phase = PHASE_OFFERING;
+    srv->sent = srv->next = srv->done = 0;
+    publishOffer(srv);
+    printf("[OTASRV] Offer %u: version %s, %s\n", otaId, srv->version.c_str(), srv->usingFull ? "full" : "delta");
+}
+
+/**
+ * @brief 设备切换分区后的结果 (试运行记录对应本次升级编号)
+ */
+static void handleBootResult(OtaServer* srv, const OtaStatusMessage* status) {
+    if (status->boot == "trial" && !srv->trialSeen) {
+        srv->trialSeen = true;
+        printf("[OTASRV] Device booted %.*s in trial, waiting for check-in\n", (int)status->version.size(),
+               status->version.data());
+    } else if (status->boot == "confirmed" && status->version == srv->version) {
+        printf("[OTASRV] Device checked in on %.*s (slot %d, sha256 %.16s...)\n", (int)status->version.size(),
+               status->version.data(), status->slot, std::string(status->imageSha).c_str());
+        finish(srv, OTASRV_EXIT_CONFIRMED);
+    } else if (status->boot == "rolled_back") {
+        printf("[OTASRV] Device rolled back to %.*s (slot %d)\n", (int)status->version.size(),
+               status->version.data(), status->slot);
+        finish(srv, OTASRV_EXIT_ROLLED_BACK);
+    }
+}
+
+static void handleStatus(void* context, std::string_view topic, std::string_view payload) {
+    OtaServer* srv = (OtaServer*)context;
+    OtaStatusMessage status;
+    if (topic != OTA_TOPIC_STATUS || !otaParseStatus(payload, &status) || status.deviceId != srv->deviceId) return;
+
+    // 切换分区前的 rebooting 状态已含新记录 (trial)，但仍是旧镜像在运行
+    if (srv->phase != PHASE_OFFERING && status.full && status.bootOtaId == srv->otaId &&
+        status.state != "rebooting") {
+        handleBootResult(srv, &status);
+        if (srv->phase == PHASE_DONE) return;
+    }
+    if (status.otaId != srv->otaId) {
+        // 设备 (重新) 上线：描述阶段立即重发
+        if (status.full && srv->phase == PHASE_OFFERING) publishOffer(srv);
+        return;
+    }
+
+    int64_t now = mqttSessionNowMs();
+    if (status.state == "rejected") {
+        printf("[OTASRV] Device busy, retrying\n");
+    } else if (status.state == "failed") {
+        if (status.error == "base_mismatch" && srv->fullPath != NULL && !srv->usingFull) {
+            printf("[OTASRV] Device is not running the patch base, falling back to full image\n");
+            if (!loadPatch(srv, srv->fullPath, true)) {
+                finish(srv, OTASRV_EXIT_FAILED);
+                return;
+            }
+            startOffer(srv, (uint16_t)(srv->otaId == 0xFFFF ? 1 : srv->otaId + 1));
+            return;
+        }
+        printf("[OTASRV] Update failed: %.*s\n", (int)status.error.size(), status.error.data());
+        finish(srv, OTASRV_EXIT_FAILED);
+    } else if (status.state == "receiving") {
+        if (srv->phase == PHASE_OFFERING) {
+            srv->phase = PHASE_SENDING;
+            if (status.full) srv->window = std::max<uint32_t>(1, status.window);
+            srv->transferStartMs = now;
+            srv->lastProgressMs = now;
+            printf("[OTASRV] Offer accepted, window %u\n", srv->window);
+        }
+        if (status.next > srv->next || status.done > srv->done) srv->lastProgressMs = now;
+        srv->next = std::max(srv->next, status.next);
+        srv->done = std::max(srv->done, status.done);
+        if (srv->sent < srv->next) srv->sent = srv->next;
+    } else if (status.state == "rebooting" && srv->phase == PHASE_SENDING) {
+        double seconds = (double)(now - srv->transferStartMs) / 1000.0;
+        printf("[OTASRV] Image written and verified: %zu bytes in %.1fs (%.1f KB/s), %llu chunks sent, "
+               "%llu resent\n", srv->patch.size(), seconds, (double)srv->patch.size() / 1024.0 / std::max(seconds, 0.001),
+               (unsigned long long)srv->chunksSent, (unsigned long long)srv->retransmits);
+        srv->phase = PHASE_WAIT_BOOT;
+    }
+}
+
+// ==================== 主函数 ====================
+
+/**
+ * @brief 向一台设备推送补丁，等待其签到或回滚后退出
+ */
+int main(int argc, char** argv) {
+    std::string host = "127.0.0.1";
+    uint16_t port = 1883;
+    const char* patchPath = NULL;
+    int timeoutS = 600;
+    // 连续运行时避免与上一次的编号相同 (设备据此区分重发的描述与新的升级)
+    uint16_t otaId = (uint16_t)(((uint32_t)time(NULL) * 31u + (uint32_t)getpid()) % 65535u + 1u);
+
+    MqttSession session;
+    mqttSessionInit(&session);
+    OtaServer srv = {};
+    srv.session = &session;
+    srv.deviceId = "esp32_fire_alarm_001";
+    srv.chunkSize = OTA_CHUNK_MAX;
+    srv.window = OTA_RX_SLOTS;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:i:P:F:V:n:c:t:")) != -1) {
+        switch (opt) {
+            case 'h': host = optarg; break;
+            case 'p': port = (uint16_t)atoi(optarg); break;
+            case 'i': srv.deviceId = optarg; break;
+            case 'P': patchPath = optarg; break;
+            case 'F': srv.fullPath = optarg; break;
+            case 'V': srv.version = optarg; break;
+            case 'n': otaId = (uint16_t)atoi(optarg); break;
+            case 'c': srv.chunkSize = (uint32_t)atoi(optarg); break;
+            case 't': timeoutS = atoi(optarg); break;
+            default:
+                printUsage(argv[0]);
+                return OTASRV_EXIT_USAGE;
+        }
+    }
+    if (patchPath == NULL || srv.version.empty() || srv.version.size() >= 24 || otaId == 0 || srv.chunkSize == 0 ||
+        srv.chunkSize > OTA_CHUNK_MAX) {
+        printUsage(argv[0]);
+        return OTASRV_EXIT_USAGE;
+    }
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    if (!loadPatch(&srv, patchPath, false)) return OTASRV_EXIT_FAILED;
+    srv.offerTopic = std::string(OTA_TOPIC_OFFER) + srv.deviceId;
+    srv.dataTopic = std::string(OTA_TOPIC_DATA) + srv.deviceId;
+    srv.exitCode = OTASRV_EXIT_FAILED;
+    std::string clientId = "ota_server_" + std::to_string(getpid());
+
+    int64_t deadline = mqttSessionNowMs() + (int64_t)timeoutS * 1000;
+    bool offered = false;
+    while (running && srv.phase != PHASE_DONE && mqttSessionNowMs() < deadline) {
+        if (session.fd < 0) {
+            if (!mqttSessionConnect(&session, host.c_str(), port, clientId.c_str()) ||
+                !mqttSessionSubscribe(&session, OTA_TOPIC_STATUS)) {
+                mqttSessionClose(&session);
+                usleep(OTASRV_RETRY_MS * 1000);
+                continue;
+            }
+            printf("[OTASRV] Connected to %s:%u, device %s\n", host.c_str(), port, srv.deviceId.c_str());
+            if (!offered) {
+                startOffer(&srv, otaId);
+                offered = true;
+            }
+        }
+
+        if (!mqttSessionPoll(&session, OTASRV_POLL_MS, handleStatus, &srv)) {
+            printf("[OTASRV] Connection lost\n");
+            mqttSessionClose(&session);
+            continue;
+        }
+
+        if (srv.phase == PHASE_OFFERING && mqttSessionNowMs() - srv.lastOfferMs > OTASRV_OFFER_RETRY_MS) {
+            publishOffer(&srv);
+        } else if (srv.phase == PHASE_SENDING) {
+            pumpChunks(&srv);
+        }
+    }
+
+    mqttSessionClose(&session);
+    if (srv.phase != PHASE_DONE) printf("[OTASRV] Timed out\n");
+    return srv.exitCode;
+}
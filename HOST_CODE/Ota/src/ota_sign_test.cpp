@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "MY_Sha512.h"
+#include "MY_Ed25519.h"
+#include "MY_OtaPatch.h"
+#include "MY_PatchWriter.h"
+
+/*
+ * 补丁签名测试：直接编译固件的 MY_Sha512.cpp、MY_Ed25519.cpp 与 MY_OtaPatch.cpp
+ *   1. SHA-512：FIPS 180-4 示例 (空串、单块、跨块)
+ *   2. Ed25519：RFC 8032 7.1 测试向量 1~3 (公钥导出、签名、校验)，改动任一字节或 S 不小于群阶时拒绝
+ *   3. 补丁：正确密钥签名的补丁能应用；其他密钥签名、头部被改、旧版未签名头部均在写入任何数据前被拒绝
+ * 任一检查失败时退出码为1
+ */
+
+// ==================== 检查 ====================
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("[SIGN] %-64s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+static std::vector<uint8_t> fromHex(const char* hex) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; hex[i] != '\0' && hex[i + 1] != '\0'; i += 2) {
+        char digits[3] = { hex[i], hex[i + 1], 0 };
+        out.push_back((uint8_t)strtoul(digits, NULL, 16));
+    }
+    return out;
+}
+
+// ==================== SHA-512 ====================
+
+static void testSha512() {
+    static const struct {
+        const char* message;
+        const char* digest;
+    } vectors[] = {
+        { "",
+          "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+          "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e" },
+        { "abc",
+          "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+          "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f" },
+        { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+          "ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+          "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+          "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909" },
+    };
+    bool ok = true;
+    bool split = true;
+    for (const auto& v : vectors) {
+        uint8_t digest[SHA512_DIGEST_SIZE];
+        Sha512Context sha;
+        sha512Init(&sha);
+        sha512Update(&sha, (const uint8_t*)v.message, strlen(v.message));
+        sha512Final(&sha, digest);
+        ok = ok && memcmp(digest, fromHex(v.digest).data(), SHA512_DIGEST_SIZE) == 0;
+
+        // 逐字节送入结果相同
+        sha512Init(&sha);
+        for (size_t i = 0; i < strlen(v.message); i++) sha512Update(&sha, (const uint8_t*)v.message + i, 1);
+        sha512Final(&sha, digest);
+        split = split && memcmp(digest, fromHex(v.digest).data(), SHA512_DIGEST_SIZE) == 0;
+    }
+    check(ok, "SHA-512 FIPS 180-4 examples");
+    check(split, "SHA-512 byte-at-a-time input gives the same digest");
+}
+
+// ==================== Ed25519 ====================
+
+static void testEd25519() {
+    static const struct {
+        const char* seed;
+        const char* publicKey;
+        const char* message;
+        const char* signature;
+    } vectors[] = {
+        { "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+          "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", "",
+          "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+          "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b" },
+        { "4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+          "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", "72",
+          "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+          "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00" },
+        { "c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+          "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025", "af82",
+          "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+          "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a" },
+    };
+    bool derive = true;
+    bool sign = true;
+    bool verify = true;
+    bool tampered = true;
+    for (const auto& v : vectors) {
+        std::vector<uint8_t> seed = fromHex(v.seed);
+        std::vector<uint8_t> expectedKey = fromHex(v.publicKey);
+        std::vector<uint8_t> message = fromHex(v.message);
+        std::vector<uint8_t> expectedSig = fromHex(v.signature);
+
+        uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE];
+        uint8_t signature[ED25519_SIGNATURE_SIZE];
+        ed25519PublicKey(seed.data(), publicKey);
+        ed25519Sign(seed.data(), message.data(), message.size(), signature);
+        derive = derive && memcmp(publicKey, expectedKey.data(), sizeof(publicKey)) == 0;
+        sign = sign && memcmp(signature, expectedSig.data(), sizeof(signature)) == 0;
+        verify = verify && ed25519Verify(expectedSig.data(), message.data(), message.size(), expectedKey.data());
+
+        // R、S 与消息各改一位
+        for (size_t pos : { (size_t)3, (size_t)40 }) {
+            std::vector<uint8_t> bad = expectedSig;
+            bad[pos] ^= 0x01;
+            tampered = tampered && !ed25519Verify(bad.data(), message.data(), message.size(), expectedKey.data());
+        }
+        std::vector<uint8_t> longer = message;
+        longer.push_back(0);
+        tampered = tampered && !ed25519Verify(expectedSig.data(), longer.data(), longer.size(), expectedKey.data());
+    }
+    check(derive, "RFC 8032 public keys derived from seeds");
+    check(sign, "RFC 8032 signatures reproduced");
+    check(verify, "RFC 8032 signatures verify");
+    check(tampered, "flipped bit in R, S or message rejected");
+
+    // S + L 与 S 在模群阶下相同，须按不规范签名拒绝
+    std::vector<uint8_t> seed = fromHex(vectors[1].seed);
+    std::vector<uint8_t> publicKey = fromHex(vectors[1].publicKey);
+    std::vector<uint8_t> message = fromHex(vectors[1].message);
+    std::vector<uint8_t> sig = fromHex(vectors[1].signature);
+    static const uint8_t order[32] = {
+        0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10
+    };
+    unsigned carry = 0;
+    for (int i = 0; i < 32; i++) {
+        carry += sig[32 + i] + order[i];
+        sig[32 + i] = (uint8_t)carry;
+        carry >>= 8;
+    }
+    check(!ed25519Verify(sig.data(), message.data(), message.size(), publicKey.data()),
+          "non-canonical S (S + L) rejected");
+
+    uint8_t zeroKey[ED25519_PUBLIC_KEY_SIZE] = {0};
+    uint8_t signature[ED25519_SIGNATURE_SIZE];
+    ed25519Sign(seed.data(), message.data(), message.size(), signature);
+    check(!ed25519Verify(signature, message.data(), message.size(), zeroKey), "placeholder all-zero key rejects");
+}
+
+// ==================== 补丁 ====================
+
+typedef struct {
+    std::vector<uint8_t> target;
+    size_t writes;
+} MemoryFlash;
+
+static bool memWriteTarget(void* context, uint32_t offset, const uint8_t* buf, size_t len) {
+    MemoryFlash* flash = (MemoryFlash*)context;
+    if (offset != flash->target.size()) return false;
+    flash->target.insert(flash->target.end(), buf, buf + len);
+    flash->writes++;
+    return true;
+}
+
+static bool memReadTarget(void* context, uint32_t offset, uint8_t* buf, size_t len) {
+    const MemoryFlash* flash = (const MemoryFlash*)context;
+    if ((size_t)offset + len > flash->target.size()) return false;
+    memcpy(buf, flash->target.data() + offset, len);
+    return true;
+}
+
+/**
+ * @brief 按设备的方式应用完整镜像补丁，返回结果与写入次数
+ */
+static OtaPatchResult applyFull(const std::vector<uint8_t>& patchData, const uint8_t* publicKey, size_t* writes) {
+    MemoryFlash flash = { {}, 0 };
+    OtaPatchIo io = {};
+    io.context = &flash;
+    io.writeTarget = memWriteTarget;
+    io.readTarget = memReadTarget;
+    io.targetCapacity = 1 << 20;
+
+    static OtaPatch patch;
+    uint8_t noSha[SHA256_DIGEST_SIZE] = {0};
+    otaPatchBegin(&patch, &io, publicKey, 0, noSha);
+    OtaPatchResult result = otaPatchFeed(&patch, patchData.data(), patchData.size());
+    if (result == OTA_PATCH_OK) result = otaPatchFinish(&patch);
+    *writes = flash.writes;
+    return result;
+}
+
+static void testPatch() {
+    uint8_t seed[ED25519_SEED_SIZE];
+    uint8_t otherSeed[ED25519_SEED_SIZE];
+    for (int i = 0; i < ED25519_SEED_SIZE; i++) {
+        seed[i] = (uint8_t)(i * 7 + 1);
+        otherSeed[i] = (uint8_t)(i * 11 + 3);
+    }
+    uint8_t publicKey[ED25519_PUBLIC_KEY_SIZE];
+    ed25519PublicKey(seed, publicKey);
+
+    std::vector<uint8_t> image(20000);
+    for (size_t i = 0; i < image.size(); i++) image[i] = (uint8_t)((i * 31) ^ (i >> 5));
+    PatchStats stats;
+    std::vector<uint8_t> patch = patchBuildFull(image, seed, &stats);
+    std::vector<uint8_t> foreign = patchBuildFull(image, otherSeed, &stats);
+
+    size_t writes = 0;
+    OtaPatchResult result = applyFull(patch, publicKey, &writes);
+    check(result == OTA_PATCH_OK && writes > 0, "patch signed with the device key applies");
+
+    result = applyFull(foreign, publicKey, &writes);
+    check(result == OTA_PATCH_ERR_SIGNATURE && writes == 0, "patch signed with another key rejected before writing");
+
+    // 改目标长度 (签名覆盖的字段)
+    std::vector<uint8_t> edited = patch;
+    edited[12] ^= 0x01;
+    result = applyFull(edited, publicKey, &writes);
+    check(result == OTA_PATCH_ERR_SIGNATURE && writes == 0, "edited header rejected before writing");
+
+    // 改签名之后的正文：签名通过，写完后由目标SHA-256拦住
+    edited = patch;
+    edited[OTA_PATCH_HEADER_SIZE + 40] ^= 0x01;
+    result = applyFull(edited, publicKey, &writes);
+    check(result != OTA_PATCH_OK, "edited body fails the signed target SHA-256");
+
+    // 旧版 (未签名) 头部
+    edited = patch;
+    edited[4] = 1;
+    result = applyFull(edited, publicKey, &writes);
+    check(result == OTA_PATCH_ERR_HEADER && writes == 0, "version 1 unsigned header rejected");
+
+    // 签名位置清零 (ota_diff 以外的工具只编码不签名)
+    edited = patch;
+    memset(edited.data() + OTA_PATCH_SIGNED_SIZE, 0, ED25519_SIGNATURE_SIZE);
+    result = applyFull(edited, publicKey, &writes);
+    check(result == OTA_PATCH_ERR_SIGNATURE && writes == 0, "zeroed signature rejected");
+    check(strcmp(otaPatchResultString(OTA_PATCH_ERR_SIGNATURE), "bad_signature") == 0,
+          "status reports bad_signature");
+}
+
+int main() {
+    testSha512();
+    testEd25519();
+    testPatch();
+
+    printf("[SIGN] %s (%d failures)\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
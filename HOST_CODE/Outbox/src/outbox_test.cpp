@@ -0,0 +1,379 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+#include "MY_OutboxCore.h"
+
+/*
+ * 离线缓存队列测试：直接编译固件的 MY_OutboxCore.cpp
+ *   1. 补发顺序：报警优先，同类先进先出，payload 原样补发
+ *   2. 遥测合并：窗口内覆盖队尾样本，窗口外追加
+ *   3. 满队列：丢弃最旧条目；没有存储区时入队失败并计入丢弃
+ *   4. 溢出存储：遥测满时写入溢出存储，按 报警 → 溢出 → RAM 的顺序补发，存储满时丢弃
+ *   5. 补发期间改写：发布期间队头被合并时不出队、不计入已补发，下次补发新内容
+ *   6. 令牌桶：突发上限、余数累计、millis 回绕和长时间断网
+ *   7. 随机序列：任意时刻 入队 = 已补发 + 丢弃 + 合并 + 队列深度，同一条消息不会出队两次
+ * 任一检查失败时退出码为1
+ */
+
+// 主机端不需要固件的大payload，截断行为用短缓冲区即可覆盖
+#define TEST_PAYLOAD_SIZE   32
+
+// ==================== 检查 ====================
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("[OUTBOX] %-62s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+static uint64_t rng = 1;
+
+static uint32_t randomRange(uint32_t lo, uint32_t hi) {
+    rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    return lo + (uint32_t)((rng >> 33) % (uint64_t)(hi - lo + 1));
+}
+
+// ==================== 内存溢出存储 ====================
+
+typedef struct {
+    OutboxEntryHeader header;
+    std::string payload;
+} SpilledEntry;
+
+typedef struct {
+    std::deque<SpilledEntry> entries;
+    uint32_t limit;
+} MemorySpill;
+
+static bool memSpillWrite(void* ctx, const OutboxEntryHeader* header, const char* payload) {
+    MemorySpill* spill = (MemorySpill*)ctx;
+    if (spill->entries.size() >= spill->limit) return false;
+    spill->entries.push_back({ *header, std::string(payload) });
+    return true;
+}
+
+static bool memSpillRead(void* ctx, OutboxEntryHeader* header, char* payload) {
+    MemorySpill* spill = (MemorySpill*)ctx;
+    if (spill->entries.empty()) return false;
+    *header = spill->entries.front().header;
+    strncpy(payload, spill->entries.front().payload.c_str(), TEST_PAYLOAD_SIZE);
+    return true;
+}
+
+static void memSpillPop(void* ctx) {
+    ((MemorySpill*)ctx)->entries.pop_front();
+}
+
+static uint32_t memSpillDepth(void* ctx) {
+    return (uint32_t)((MemorySpill*)ctx)->entries.size();
+}
+
+// ==================== 测试夹具 ====================
+
+typedef struct {
+    OutboxCore core;
+    std::vector<OutboxEntryHeader> alarmHeaders, telemetryHeaders;
+    std::vector<char> alarmPayloads, telemetryPayloads;
+    MemorySpill memSpill;
+    OutboxSpillHandlers handlers;
+    uint32_t pushed;
+} Fixture;
+
+static void fixtureInit(Fixture* f, uint32_t alarmCap, uint32_t telemetryCap, uint32_t spillLimit, uint32_t nowMs) {
+    f->memSpill.entries.clear();
+    f->memSpill.limit = spillLimit;
+    f->handlers = { &f->memSpill, memSpillWrite, memSpillRead, memSpillPop, memSpillDepth };
+    outboxCoreInit(&f->core, TEST_PAYLOAD_SIZE, spillLimit > 0 ? &f->handlers : NULL, nowMs);
+
+    f->alarmHeaders.assign(alarmCap, OutboxEntryHeader{});
+    f->alarmPayloads.assign((size_t)alarmCap * TEST_PAYLOAD_SIZE, 0);
+    f->telemetryHeaders.assign(telemetryCap, OutboxEntryHeader{});
+    f->telemetryPayloads.assign((size_t)telemetryCap * TEST_PAYLOAD_SIZE, 0);
+    outboxRingInit(&f->core.alarm, alarmCap ? f->alarmHeaders.data() : NULL, f->alarmPayloads.data(), alarmCap);
+    outboxRingInit(&f->core.telemetry, telemetryCap ? f->telemetryHeaders.data() : NULL, f->telemetryPayloads.data(), telemetryCap);
+    f->pushed = 0;
+}
+
+static bool push(Fixture* f, OutboxClass msgClass, const char* payload, uint32_t atMs) {
+    f->pushed++;
+    return outboxCorePush(&f->core, msgClass, msgClass == OUTBOX_CLASS_ALARM ? "fire/alarm" : "fire/telemetry",
+                          payload, atMs);
+}
+
+// 补发一条：返回补发的payload，队列为空时返回空串
+static std::string drainOne(Fixture* f, OutboxSource* sourceOut = NULL) {
+    OutboxEntryHeader header;
+    char payload[TEST_PAYLOAD_SIZE];
+    OutboxSource source = outboxCorePeek(&f->core, &header, payload);
+    if (sourceOut != NULL) *sourceOut = source;
+    if (source == OUTBOX_SOURCE_NONE) return "";
+    outboxCoreComplete(&f->core, source, header.seq);
+    return payload;
+}
+
+static uint32_t depth(const Fixture* f) {
+    OutboxStats s = outboxCoreStats(&f->core);
+    return s.alarmDepth + s.telemetryDepth + s.spilledDepth;
+}
+
+static bool balanced(const Fixture* f) {
+    OutboxStats s = outboxCoreStats(&f->core);
+    return f->pushed == s.sent + s.dropped + s.coalesced + depth(f);
+}
+
+// ==================== 测试用例 ====================
+
+static void testOrder() {
+    Fixture f;
+    fixtureInit(&f, 8, 8, 0, 0);
+    push(&f, OUTBOX_CLASS_TELEMETRY, "t1", 0);
+    push(&f, OUTBOX_CLASS_ALARM, "a1", 1000);
+    push(&f, OUTBOX_CLASS_TELEMETRY, "t2", 20000);
+    push(&f, OUTBOX_CLASS_ALARM, "a2", 21000);
+
+    std::string order;
+    OutboxSource source;
+    std::string p = drainOne(&f, &source);
+    check(p == "a1" && source == OUTBOX_SOURCE_ALARM, "order: alarms drain before older telemetry");
+    order = p;
+    while (!(p = drainOne(&f)).empty()) order += "," + p;
+    check(order == "a1,a2,t1,t2", "order: FIFO within each class");
+    check(outboxCoreStats(&f.core).sent == 4 && depth(&f) == 0 && balanced(&f), "order: every entry counted as sent once");
+
+    // 超长 payload 截断并保留结尾的 '\0'
+    std::string longPayload(TEST_PAYLOAD_SIZE * 2, 'x');
+    push(&f, OUTBOX_CLASS_ALARM, longPayload.c_str(), 30000);
+    check(drainOne(&f) == longPayload.substr(0, TEST_PAYLOAD_SIZE - 1), "order: oversized payload is truncated");
+}
+
+static void testCoalesce() {
+    Fixture f;
+    fixtureInit(&f, 4, 8, 0, 0);
+    push(&f, OUTBOX_CLASS_TELEMETRY, "t0", 0);
+    push(&f, OUTBOX_CLASS_TELEMETRY, "t5", 5000);
+    OutboxStats s = outboxCoreStats(&f.core);
+    check(s.telemetryDepth == 1 && s.coalesced == 1, "coalesce: sample inside the window replaces the tail");
+
+    // 窗口从队尾样本首次入队算起，合并不会顺延窗口
+    push(&f, OUTBOX_CLASS_TELEMETRY, "t10", OUTBOX_COALESCE_MS);
+    push(&f, OUTBOX_CLASS_TELEMETRY, "t15", OUTBOX_COALESCE_MS + 5000);
+    s = outboxCoreStats(&f.core);
+    check(s.telemetryDepth == 2 && s.coalesced == 2, "coalesce: window is anchored at the tail's first sample");
+
+    // 报警不合并
+    push(&f, OUTBOX_CLASS_ALARM, "a1", 16000);
+    push(&f, OUTBOX_CLASS_ALARM, "a2", 16001);
+    check(outboxCoreStats(&f.core).alarmDepth == 2, "coalesce: alarms are never coalesced");
+
+    check(drainOne(&f) == "a1" && drainOne(&f) == "a2" && drainOne(&f) == "t5" && drainOne(&f) == "t15",
+          "coalesce: the newest sample of each window is drained");
+    check(balanced(&f), "coalesce: pushed = sent + dropped + coalesced + depth");
+}
+
+static void testOverflow() {
+    Fixture f;
+    fixtureInit(&f, 4, 4, 0, 0);
+    char payload[16];
+    for (int i = 0; i < 6; i++) {
+        snprintf(payload, sizeof(payload), "a%d", i);
+        push(&f, OUTBOX_CLASS_ALARM, payload, (uint32_t)i);
+        snprintf(payload, sizeof(payload), "t%d", i);
+        push(&f, OUTBOX_CLASS_TELEMETRY, payload, (uint32_t)i * OUTBOX_COALESCE_MS);
+    }
+    OutboxStats s = outboxCoreStats(&f.core);
+    check(s.alarmDepth == 4 && s.telemetryDepth == 4 && s.dropped == 4, "overflow: full rings drop the oldest entry");
+    check(drainOne(&f) == "a2", "overflow: oldest surviving alarm drains first");
+    check(balanced(&f), "overflow: pushed = sent + dropped + coalesced + depth");
+
+    // 存储区分配失败
+    Fixture empty;
+    fixtureInit(&empty, 0, 0, 0, 0);
+    bool queued = push(&empty, OUTBOX_CLASS_ALARM, "a", 0) || push(&empty, OUTBOX_CLASS_TELEMETRY, "t", 0);
+    check(!queued && outboxCoreStats(&empty.core).dropped == 2 && balanced(&empty),
+          "overflow: ring without storage rejects and counts a drop");
+}
+
+static void testSpill() {
+    Fixture f;
+    fixtureInit(&f, 4, 2, 3, 0);
+    char payload[16];
+    for (int i = 0; i < 7; i++) {
+        snprintf(payload, sizeof(payload), "t%d", i);
+        push(&f, OUTBOX_CLASS_TELEMETRY, payload, (uint32_t)i * OUTBOX_COALESCE_MS);
+    }
+    OutboxStats s = outboxCoreStats(&f.core);
+    check(s.spilledDepth == 3 && s.telemetryDepth == 2 && s.dropped == 2,
+          "spill: overflow goes to the spill store until it is full");
+    check(outboxCoreHasTelemetry(&f.core), "spill: telemetry is pending");
+
+    // 报警溢出不写入溢出存储
+    for (int i = 0; i < 5; i++) {
+        snprintf(payload, sizeof(payload), "a%d", i);
+        push(&f, OUTBOX_CLASS_ALARM, payload, 70000 + (uint32_t)i);
+    }
+    s = outboxCoreStats(&f.core);
+    check(s.spilledDepth == 3 && s.dropped == 3, "spill: alarm overflow is dropped, not spilled");
+
+    std::string order;
+    std::string p;
+    while (!(p = drainOne(&f)).empty()) order += (order.empty() ? "" : ",") + p;
+    check(order == "a1,a2,a3,a4,t0,t1,t2,t5,t6", "spill: drain order is alarm -> spill -> RAM");
+    check(!outboxCoreHasTelemetry(&f.core) && depth(&f) == 0 && balanced(&f),
+          "spill: pushed = sent + dropped + coalesced + depth");
+}
+
+static void testPublishRace() {
+    Fixture f;
+    fixtureInit(&f, 4, 4, 0, 0);
+    push(&f, OUTBOX_CLASS_TELEMETRY, "old", 0);
+
+    // 拷贝队头后释放锁发布，期间新样本合并到同一条目
+    OutboxEntryHeader header;
+    char payload[TEST_PAYLOAD_SIZE];
+    OutboxSource source = outboxCorePeek(&f.core, &header, payload);
+    push(&f, OUTBOX_CLASS_TELEMETRY, "new", 2000);
+    outboxCoreComplete(&f.core, source, header.seq);
+
+    OutboxStats s = outboxCoreStats(&f.core);
+    check(s.telemetryDepth == 1 && s.sent == 0 && s.coalesced == 1,
+          "race: rewritten head is kept and not counted as sent");
+    check(drainOne(&f) == "new" && outboxCoreStats(&f.core).sent == 1 && balanced(&f),
+          "race: the new content is drained next");
+
+    // 发布失败：不调用 complete，条目和令牌都保留
+    push(&f, OUTBOX_CLASS_ALARM, "a", 3000);
+    uint32_t tokens = f.core.drainTokens;
+    source = outboxCorePeek(&f.core, &header, payload);
+    check(source == OUTBOX_SOURCE_ALARM && outboxCoreStats(&f.core).alarmDepth == 1 && f.core.drainTokens == tokens,
+          "race: failed publish leaves entry and tokens untouched");
+}
+
+static void testTokenBucket() {
+    Fixture f;
+    fixtureInit(&f, 64, 4, 0, 0);
+    check(outboxCoreRefill(&f.core, 0, OUTBOX_DRAIN_RATE_PER_SEC) == OUTBOX_DRAIN_BURST, "tokens: start with a full burst");
+    for (int i = 0; i < OUTBOX_DRAIN_BURST; i++) {
+        push(&f, OUTBOX_CLASS_ALARM, "a", 0);
+        drainOne(&f);
+    }
+    const uint32_t perTokenMs = 1000 / OUTBOX_DRAIN_RATE_PER_SEC;
+    check(outboxCoreRefill(&f.core, perTokenMs / 2, OUTBOX_DRAIN_RATE_PER_SEC) == 0, "tokens: burst is consumed");
+    check(outboxCoreRefill(&f.core, perTokenMs, OUTBOX_DRAIN_RATE_PER_SEC) == 1, "tokens: one token per 1/rate seconds");
+    check(outboxCoreRefill(&f.core, perTokenMs * 5 / 2, OUTBOX_DRAIN_RATE_PER_SEC) == 2, "tokens: partial intervals carry over");
+    check(outboxCoreRefill(&f.core, 3600000, OUTBOX_DRAIN_RATE_PER_SEC) == OUTBOX_DRAIN_BURST, "tokens: long idle is capped at the burst");
+
+    // millis 回绕
+    Fixture w;
+    fixtureInit(&w, 64, 4, 0, 0xFFFFFF00u);
+    for (int i = 0; i < OUTBOX_DRAIN_BURST; i++) {
+        push(&w, OUTBOX_CLASS_ALARM, "a", 0);
+        drainOne(&w);
+    }
+    check(outboxCoreRefill(&w.core, 0xFFFFFF00u + perTokenMs * 3, OUTBOX_DRAIN_RATE_PER_SEC) == 3, "tokens: refill across millis wrap-around");
+
+    // 断网约5天：间隔 × 速率恰好在32位回绕到接近0
+    const uint32_t outageMs = (uint32_t)((1ULL << 32) / OUTBOX_DRAIN_RATE_PER_SEC + 1);
+    Fixture d;
+    fixtureInit(&d, 64, 4, 0, 0);
+    for (int i = 0; i < OUTBOX_DRAIN_BURST; i++) {
+        push(&d, OUTBOX_CLASS_ALARM, "a", 0);
+        drainOne(&d);
+    }
+    check(outboxCoreRefill(&d.core, outageMs, OUTBOX_DRAIN_RATE_PER_SEC) == OUTBOX_DRAIN_BURST,
+          "tokens: multi-day outage refills to the burst");
+
+    // 速率由调用方传入 (配置项)：速率不整除1000时余数累计，0表示不补充
+    Fixture r;
+    fixtureInit(&r, 64, 4, 0, 0);
+    for (int i = 0; i < OUTBOX_DRAIN_BURST; i++) {
+        push(&r, OUTBOX_CLASS_ALARM, "a", 0);
+        drainOne(&r);
+    }
+    check(outboxCoreRefill(&r.core, 333, 3) == 0 && outboxCoreRefill(&r.core, 334, 3) == 1,
+          "tokens: rate is a parameter (3/s, first token at 334 ms)");
+    check(outboxCoreRefill(&r.core, 1000, 3) == 3, "tokens: non-divisor rate carries its remainder");
+    check(outboxCoreRefill(&r.core, 60000, 0) == 3, "tokens: zero rate stops refilling");
+    check(outboxCoreRefill(&r.core, 60100, 10) == 4, "tokens: paused interval is not credited later");
+}
+
+static void testRandom() {
+    uint32_t unbalanced = 0, duplicates = 0, outOfOrder = 0, priority = 0;
+    uint32_t totalPushed = 0, totalSent = 0, totalRaces = 0;
+    for (int run = 0; run < 200; run++) {
+        Fixture f;
+        uint32_t spillLimit = randomRange(0, 1) ? randomRange(1, 16) : 0;
+        fixtureInit(&f, randomRange(1, 8), randomRange(1, 8), spillLimit, 0);
+        std::set<uint32_t> delivered;
+        uint32_t lastAlarm = 0, lastTelemetry = 0;
+        uint32_t now = 0, nextId = 1;
+        char payload[16];
+
+        for (int step = 0; step < 2000; step++) {
+            uint32_t op = randomRange(0, 9);
+            if (op < 2) {
+                snprintf(payload, sizeof(payload), "%u", nextId++);
+                push(&f, OUTBOX_CLASS_ALARM, payload, now);
+            } else if (op < 6) {
+                now += randomRange(0, 15000);
+                snprintf(payload, sizeof(payload), "%u", nextId++);
+                push(&f, OUTBOX_CLASS_TELEMETRY, payload, now);
+            } else {
+                OutboxEntryHeader header;
+                char copy[TEST_PAYLOAD_SIZE];
+                OutboxSource source = outboxCorePeek(&f.core, &header, copy);
+                if (source == OUTBOX_SOURCE_NONE) continue;
+                if (source != OUTBOX_SOURCE_ALARM && f.core.alarm.count > 0) priority++;
+
+                // 发布期间可能有新样本入队 (可能合并到正在补发的条目)
+                if (randomRange(0, 3) == 0) {
+                    now += randomRange(0, 3000);
+                    snprintf(payload, sizeof(payload), "%u", nextId++);
+                    push(&f, OUTBOX_CLASS_TELEMETRY, payload, now);
+                    totalRaces++;
+                }
+                // 发布失败：保留条目，下次重试
+                if (randomRange(0, 9) == 0) continue;
+
+                uint32_t sentBefore = outboxCoreStats(&f.core).sent;
+                outboxCoreComplete(&f.core, source, header.seq);
+                if (outboxCoreStats(&f.core).sent != sentBefore) {
+                    uint32_t id = (uint32_t)atoi(copy);
+                    if (!delivered.insert(id).second) duplicates++;
+                    uint32_t* last = (source == OUTBOX_SOURCE_ALARM) ? &lastAlarm : &lastTelemetry;
+                    if (id <= *last) outOfOrder++;
+                    *last = id;
+                }
+            }
+            if (!balanced(&f)) unbalanced++;
+        }
+        OutboxStats s = outboxCoreStats(&f.core);
+        totalPushed += f.pushed;
+        totalSent += s.sent;
+    }
+    printf("[OUTBOX] random: 200 runs, %u pushed, %u sent, %u publish races\n", totalPushed, totalSent, totalRaces);
+    check(unbalanced == 0, "random: pushed = sent + dropped + coalesced + depth at every step");
+    check(duplicates == 0, "random: no entry is dequeued twice");
+    check(outOfOrder == 0, "random: each class is delivered in enqueue order");
+    check(priority == 0, "random: telemetry never drains while an alarm is queued");
+}
+
+// ==================== 主程序 ====================
+
+int main() {
+    testOrder();
+    testCoalesce();
+    testOverflow();
+    testSpill();
+    testPublishRace();
+    testTokenBucket();
+    testRandom();
+
+    printf("[OUTBOX] %s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include "MY_PumpDuty.h"
+
+/*
+ * 水泵占空比模型测试：直接编译固件的 MY_PumpDuty.cpp
+ *   1. 窗口统计：连续喷水耗尽预算、正在导通的区间、预测未来时刻、区间滑出窗口
+ *   2. 恢复时间：等待时间使预算恰好达到恢复值 (1毫秒精度)，窗口很小时恢复值不超过上限
+ *   3. 记录合并：记录满后合并最旧两条，只会高估占用
+ *   4. 随机序列：按固件的规则 (预算不足不启动、脉冲截短到剩余预算) 随机喷水，
+ *      与保存全部区间的参考实现比较，任意时刻窗口内的实际喷水不超过上限
+ * 任一检查失败时退出码为1
+ */
+
+#define US_PER_MS   1000LL
+#define US_PER_S    1000000LL
+
+// ==================== 检查 ====================
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("[DUTY] %-62s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+// ==================== 参考实现 ====================
+
+// 保存全部导通区间，按定义计算窗口内的累计导通时间
+typedef struct {
+    std::vector<OnInterval> intervals;
+} Reference;
+
+static int64_t referenceUsedUs(const Reference& ref, int64_t windowUs, int64_t atUs) {
+    int64_t from = atUs - windowUs;
+    int64_t used = 0;
+    for (const OnInterval& iv : ref.intervals) {
+        int64_t s = iv.startUs > from ? iv.startUs : from;
+        int64_t e = iv.endUs < atUs ? iv.endUs : atUs;
+        if (e > s) used += e - s;
+    }
+    return used;
+}
+
+static uint64_t rng = 1;
+
+static int64_t randomRange(int64_t lo, int64_t hi) {
+    rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    return lo + (int64_t)((rng >> 33) % (uint64_t)(hi - lo + 1));
+}
+
+// ==================== 测试用例 ====================
+
+static void testWindow() {
+    PumpDutyLimits limits = pumpDutyMakeLimits(60000, 50);
+    check(limits.windowUs == 60 * US_PER_S && limits.capUs == 30 * US_PER_S, "limits: 60s window at 50% allows 30s");
+
+    // 启动时刻取10天后，确认64位微秒计数不溢出
+    const int64_t t0 = 10LL * 24 * 3600 * US_PER_S;
+    PumpDutyModel model;
+    pumpDutyInit(&model);
+
+    pumpDutyStart(&model, t0);
+    int64_t now = t0 + 10 * US_PER_S;
+    check(pumpDutyUsedUs(&model, &limits, now, now) == 10 * US_PER_S, "open interval counts up to now");
+    check(pumpDutyBudgetAtUs(&model, &limits, now, now) == 20 * US_PER_S, "budget = cap - used while spraying");
+    check(pumpDutyUsedUs(&model, &limits, now + 55 * US_PER_S, now) == 5 * US_PER_S,
+          "prediction assumes no spray after now");
+
+    int64_t onUs = pumpDutyStop(&model, &limits, t0 + 30 * US_PER_S);
+    now = t0 + 30 * US_PER_S;
+    check(onUs == 30 * US_PER_S && pumpDutyBudgetAtUs(&model, &limits, now, now) == 0,
+          "30s continuous spray exhausts the budget");
+    check(pumpDutyStop(&model, &limits, now + US_PER_S) == 0, "repeated stop records nothing");
+
+    // 恢复 1s 预算：t0+61s 时窗口内只剩 29s
+    uint32_t waitMs = pumpDutyWaitMs(&model, &limits, now, pumpDutyResumeUs(&limits));
+    check(waitMs >= 31000 && waitMs <= 31001, "resume wait lands on the window edge (31s)");
+    int64_t resumeAt = now + (int64_t)waitMs * US_PER_MS;
+    check(pumpDutyBudgetAtUs(&model, &limits, resumeAt, resumeAt) >= pumpDutyResumeUs(&limits) &&
+          pumpDutyBudgetAtUs(&model, &limits, resumeAt - 2 * US_PER_MS, resumeAt - 2 * US_PER_MS) < pumpDutyResumeUs(&limits),
+          "budget reaches the resume value at the returned wait (1ms)");
+
+    now = t0 + 90 * US_PER_S;
+    check(pumpDutyUsedUs(&model, &limits, now, now) == 0 &&
+          pumpDutyWaitMs(&model, &limits, now, pumpDutyResumeUs(&limits)) == 0,
+          "interval slides out after one full window");
+
+    // 在线缩短窗口后立即按新窗口统计
+    PumpDutyLimits shorter = pumpDutyMakeLimits(20000, 50);
+    now = t0 + 40 * US_PER_S;
+    check(pumpDutyUsedUs(&model, &shorter, now, now) == 10 * US_PER_S, "shorter window applies immediately");
+
+    PumpDutyLimits tiny = pumpDutyMakeLimits(1000, 50);
+    check(pumpDutyResumeUs(&tiny) == tiny.capUs, "resume target never exceeds a tiny cap");
+}
+
+static void testMerge() {
+    PumpDutyLimits limits = pumpDutyMakeLimits(600000, 50);
+    PumpDutyModel model;
+    pumpDutyInit(&model);
+    Reference ref;
+
+    // 每2秒喷水100ms，记录数超过上限
+    int64_t t = 0;
+    for (int i = 0; i < PUMP_DUTY_HISTORY + 8; i++) {
+        pumpDutyStart(&model, t);
+        pumpDutyStop(&model, &limits, t + 100 * US_PER_MS);
+        ref.intervals.push_back({ t, t + 100 * US_PER_MS });
+        t += 2 * US_PER_S;
+    }
+    check(model.count == PUMP_DUTY_HISTORY, "history is capped at PUMP_DUTY_HISTORY");
+
+    bool over = true, same = true;
+    for (int64_t at = 0; at <= t + limits.windowUs; at += 500 * US_PER_MS) {
+        int64_t used = pumpDutyUsedUs(&model, &limits, at, t);
+        int64_t exact = referenceUsedUs(ref, limits.windowUs, at);
+        if (used < exact) over = false;
+        if (used != exact) same = false;
+    }
+    check(over, "merged history never underestimates usage");
+    check(!same, "merging is visible (the test actually merged)");
+    check(pumpDutyUsedUs(&model, &limits, t, t) >= (PUMP_DUTY_HISTORY + 8) * 100 * US_PER_MS,
+          "merged history still covers every pulse");
+}
+
+static void testRandom() {
+    int64_t worstExcessUs = 0;
+    int64_t maxUnderUs = 0;
+    int waitErrors = 0;
+    int sprays = 0;
+    for (int run = 0; run < 200; run++) {
+        PumpDutyLimits limits = pumpDutyMakeLimits((uint32_t)randomRange(10000, 120000),
+                                                   (uint32_t)randomRange(10, 90));
+        PumpDutyModel model;
+        pumpDutyInit(&model);
+        Reference ref;
+        int64_t t = randomRange(0, 1000) * US_PER_MS;
+
+        for (int step = 0; step < 200; step++) {
+            // 固件规则：预算未恢复时不启动，脉冲截短到剩余预算，短于最短脉冲不喷
+            int64_t resume = pumpDutyResumeUs(&limits);
+            uint32_t waitMs = pumpDutyWaitMs(&model, &limits, t, resume);
+            if (waitMs > 0) {
+                int64_t at = t + (int64_t)waitMs * US_PER_MS;
+                if (pumpDutyBudgetAtUs(&model, &limits, at, t) < resume ||
+                    (waitMs > 1 && pumpDutyBudgetAtUs(&model, &limits, at - 2 * US_PER_MS, t) >= resume)) {
+                    waitErrors++;
+                }
+                t = at;
+            }
+            int64_t onUs = randomRange(100, 10000) * US_PER_MS;
+            int64_t budget = pumpDutyBudgetAtUs(&model, &limits, t, t);
+            if (onUs > budget) onUs = budget;
+            if (onUs >= 100 * US_PER_MS) {
+                pumpDutyStart(&model, t);
+                pumpDutyStop(&model, &limits, t + onUs);
+                ref.intervals.push_back({ t, t + onUs });
+                t += onUs;
+                sprays++;
+            }
+            t += randomRange(0, 20000) * US_PER_MS;
+
+            // 当前及之后任意时刻 (固件只查询这些时刻)，窗口内的实际喷水不超过上限，模型不低估
+            for (int64_t at = t; at <= t + limits.windowUs; at += limits.windowUs / 16) {
+                int64_t exact = referenceUsedUs(ref, limits.windowUs, at);
+                int64_t used = pumpDutyUsedUs(&model, &limits, at, t);
+                if (exact - limits.capUs > worstExcessUs) worstExcessUs = exact - limits.capUs;
+                if (exact - used > maxUnderUs) maxUnderUs = exact - used;
+            }
+        }
+    }
+    printf("[DUTY] random: 200 runs, %d sprays\n", sprays);
+    check(worstExcessUs == 0, "random: spray within any window never exceeds the cap");
+    check(maxUnderUs == 0, "random: model never underestimates usage");
+    check(waitErrors == 0, "random: resume wait is exact to 1ms");
+}
+
+// ==================== 主程序 ====================
+
+int main() {
+    testWindow();
+    testMerge();
+    testRandom();
+
+    printf("[DUTY] %s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
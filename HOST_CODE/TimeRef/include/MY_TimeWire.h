@@ -0,0 +1,47 @@
+#ifndef MY_TIME_WIRE_H
+#define MY_TIME_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string_view>
+
+/*
+ * 时钟同步报文 (与固件 MY_TimeSync 一致)：
+ *   请求  fire_alarm/time/request               {"device_id":..., "seq":N, "t1":本地微秒}
+ *   应答  fire_alarm/time/response/<device_id>  {"device_id":..., "seq":N, "t1":..., "t2":..., "t3":...}
+ *   t2/t3 为参考进程收到请求/发出应答时的 CLOCK_REALTIME 微秒
+ */
+
+// ==================== Topic与节奏 (与 MY_TimeSync.h 一致) ====================
+#define TIME_TOPIC_REQUEST          "fire_alarm/time/request"
+#define TIME_TOPIC_RESPONSE         "fire_alarm/time/response/"
+#define TIME_BURST_SAMPLES          8
+#define TIME_BURST_MS               1000
+#define TIME_INTERVAL_MS            16000
+#define TIME_TIMEOUT_MS             2000
+#define TIME_PAYLOAD_MAX            192
+
+// ==================== 数据结构 ====================
+
+typedef struct {
+    std::string_view deviceId;      // 指向原负载
+    uint32_t seq;
+    int64_t t1;
+    int64_t t2;                     // 请求中为0
+    int64_t t3;
+} TimeMessage;
+
+// ==================== 函数声明 ====================
+
+// 解析请求/应答 (只取上述字段，字段顺序不限)，缺少 device_id/seq/t1 时返回false
+bool timeParseMessage(std::string_view payload, TimeMessage* out);
+
+// 编码请求/应答，返回长度
+size_t timeEncodeRequest(char* buf, size_t size, std::string_view deviceId, uint32_t seq, int64_t t1);
+size_t timeEncodeResponse(char* buf, size_t size, const TimeMessage* request, int64_t t2, int64_t t3);
+
+// CLOCK_REALTIME / CLOCK_MONOTONIC 微秒
+int64_t timeRealtimeUs();
+int64_t timeMonotonicUs();
+
+#endif
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "MY_TimeWire.h"
+
+// ==================== 字段查找 ====================
+
+/**
+ * @brief 查找 "key": 之后的值起始位置 (报文为扁平对象，键名不会出现在字符串值中)
+ */
+static size_t findValue(std::string_view payload, std::string_view key) {
+    char pattern[32];
+    int len = snprintf(pattern, sizeof(pattern), "\"%.*s\"", (int)key.size(), key.data());
+    size_t pos = payload.find(std::string_view(pattern, (size_t)len));
+    if (pos == std::string_view::npos) return pos;
+
+    pos += (size_t)len;
+    while (pos < payload.size() && (payload[pos] == ' ' || payload[pos] == ':')) pos++;
+    return pos < payload.size() ? pos : std::string_view::npos;
+}
+
+static bool findInt(std::string_view payload, std::string_view key, int64_t* out) {
+    size_t pos = findValue(payload, key);
+    if (pos == std::string_view::npos) return false;
+
+    // 负载不保证以0结尾，复制数字部分再转换
+    char digits[24];
+    size_t n = 0;
+    while (pos + n < payload.size() && n < sizeof(digits) - 1 &&
+           (payload[pos + n] == '-' || (payload[pos + n] >= '0' && payload[pos + n] <= '9'))) {
+        digits[n] = payload[pos + n];
+        n++;
+    }
+    if (n == 0) return false;
+    digits[n] = '\0';
+    *out = strtoll(digits, NULL, 10);
+    return true;
+}
+
+static bool findString(std::string_view payload, std::string_view key, std::string_view* out) {
+    size_t pos = findValue(payload, key);
+    if (pos == std::string_view::npos || payload[pos] != '"') return false;
+    size_t end = payload.find('"', pos + 1);
+    if (end == std::string_view::npos) return false;
+    *out = payload.substr(pos + 1, end - pos - 1);
+    return true;
+}
+
+// ==================== 公共接口 ====================
+
+bool timeParseMessage(std::string_view payload, TimeMessage* out) {
+    int64_t seq = 0;
+    if (!findString(payload, "device_id", &out->deviceId) || out->deviceId.empty() ||
+        !findInt(payload, "seq", &seq) || !findInt(payload, "t1", &out->t1)) {
+        return false;
+    }
+    out->seq = (uint32_t)seq;
+    if (!findInt(payload, "t2", &out->t2)) out->t2 = 0;
+    if (!findInt(payload, "t3", &out->t3)) out->t3 = 0;
+    return true;
+}
+
+size_t timeEncodeRequest(char* buf, size_t size, std::string_view deviceId, uint32_t seq, int64_t t1) {
+    int len = snprintf(buf, size, "{\"device_id\":\"%.*s\",\"seq\":%u,\"t1\":%lld}",
+                       (int)deviceId.size(), deviceId.data(), seq, (long long)t1);
+    return (len > 0 && (size_t)len < size) ? (size_t)len : 0;
+}
+
+size_t timeEncodeResponse(char* buf, size_t size, const TimeMessage* request, int64_t t2, int64_t t3) {
+    int len = snprintf(buf, size, "{\"device_id\":\"%.*s\",\"seq\":%u,\"t1\":%lld,\"t2\":%lld,\"t3\":%lld}",
+                       (int)request->deviceId.size(), request->deviceId.data(), request->seq,
+                       (long long)request->t1, (long long)t2, (long long)t3);
+    return (len > 0 && (size_t)len < size) ? (size_t)len : 0;
+}
+
+int64_t timeRealtimeUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t timeMonotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <math.h>
+#include <string>
+#include "MY_MqttSession.h"
+#include "MY_TimeWire.h"
+#include "MY_ClockFilter.h"
+
+/*
+ * 时钟同步探针：以固件相同的节奏和滤波器 (直接编译固件的 MY_ClockFilter.cpp)
+ * 模拟一台设备，本地时钟与 esp_timer 一样从启动时刻计数并带人为设定的漂移，并可在应答到达时刻上叠加随机排队时延
+ * 由于参考进程与探针在同一台主机上，真值就是本机 CLOCK_REALTIME，
+ * 可以直接统计估计误差以及 "误差 <= 上报的不确定度" 的覆盖率
+ */
+
+// ==================== 运行参数 ====================
+#define PROBE_DEFAULT_UPTIME_S      0.0         // 本地时钟初始读数 (设备已运行时间)
+#define PROBE_DEFAULT_DRIFT_PPM     40.0        // 本地时钟快多少 ppm (ESP32 晶振典型值 ±10~40)
+#define PROBE_REPORT_INTERVAL_S     5
+#define PROBE_EVAL_INTERVAL_MS      100
+
+typedef struct {
+    int64_t startMonoUs;
+    double offsetUs;
+    double driftPpm;
+    int64_t jitterUs;               // 应答到达时刻最多额外延后的时间 (一半的样本)
+} LocalClock;
+
+typedef struct {
+    ClockFilter filter;
+    LocalClock* clock;
+    std::string responseTopic;
+    uint32_t seq;
+    bool pending;
+    int64_t pendingT1;
+    int64_t lastRequestMs;
+    uint32_t burstRemaining;
+    uint32_t requests;
+    uint32_t timeouts;
+    // 评估
+    uint64_t evaluations;
+    uint64_t covered;
+    double sumAbsErrUs;
+    double maxAbsErrUs;
+    double sumUncertaintyUs;
+} ProbeContext;
+
+static volatile sig_atomic_t running = 1;
+
+static void handleSignal(int) {
+    running = 0;
+}
+
+static void printUsage(const char* name) {
+    printf("Usage: %s [-h host] [-p port] [-i device_id] [-u uptime_s] [-D drift_ppm] [-j jitter_us]\n"
+           "          [-I interval_ms] [-d duration_s] [-r report_s]\n", name);
+}
+
+/**
+ * @brief 模拟的本地时钟 (对应固件 esp_timer_get_time)
+ */
+static int64_t localNowUs(const LocalClock* clock) {
+    double elapsed = (double)(timeMonotonicUs() - clock->startMonoUs);
+    return (int64_t)(clock->offsetUs + elapsed * (1.0 + clock->driftPpm / 1e6));
+}
+
+static void handleResponse(void* context, std::string_view topic, std::string_view payload) {
+    ProbeContext* ctx = (ProbeContext*)context;
+    int64_t t4 = localNowUs(ctx->clock);
+    if (topic != ctx->responseTopic) return;
+
+    TimeMessage response;
+    if (!timeParseMessage(payload, &response) || !ctx->pending || response.seq != ctx->seq) return;
+    ctx->pending = false;
+
+    // 模拟下行排队：一半的应答晚到
+    if (ctx->clock->jitterUs > 0 && (rand() & 1)) {
+        t4 += rand() % ctx->clock->jitterUs;
+    }
+    clockFilterAddSample(&ctx->filter, ctx->pendingT1, response.t2, response.t3, t4);
+    if (ctx->burstRemaining > 0) ctx->burstRemaining--;
+}
+
+/**
+ * @brief 与 timeSyncPoll 相同的请求节奏
+ */
+static void pollRequest(ProbeContext* ctx, MqttSession* session, const std::string& deviceId, int64_t intervalMs) {
+    int64_t now = mqttSessionNowMs();
+    if (ctx->pending) {
+        if (now - ctx->lastRequestMs < TIME_TIMEOUT_MS) return;
+        ctx->pending = false;
+        ctx->timeouts++;
+    }
+
+    int64_t interval = (ctx->burstRemaining > 0 || !ctx->filter.synced) ? TIME_BURST_MS : intervalMs;
+    if (now - ctx->lastRequestMs < interval) return;
+
+    char payload[TIME_PAYLOAD_MAX];
+    ctx->seq++;
+    int64_t t1 = localNowUs(ctx->clock);
+    size_t len = timeEncodeRequest(payload, sizeof(payload), deviceId, ctx->seq, t1);
+    ctx->lastRequestMs = now;
+    if (!mqttSessionPublish(session, TIME_TOPIC_REQUEST, std::string_view(payload, len))) return;
+
+    ctx->pendingT1 = t1;
+    ctx->pending = true;
+    ctx->requests++;
+}
+
+/**
+ * @brief 用本机真实时间评估当前估计值
+ */
+static void evaluate(ProbeContext* ctx) {
+    if (!ctx->filter.synced) return;
+    int64_t truthUs = timeRealtimeUs();
+    int64_t localUs = localNowUs(ctx->clock);
+    double errUs = fabs((double)(clockFilterToReference(&ctx->filter, localUs) - truthUs));
+    int64_t uncertaintyUs = clockFilterUncertaintyUs(&ctx->filter, localUs);
+
+    ctx->evaluations++;
+    if (errUs <= (double)uncertaintyUs) ctx->covered++;
+    ctx->sumAbsErrUs += errUs;
+    ctx->sumUncertaintyUs += (double)uncertaintyUs;
+    if (errUs > ctx->maxAbsErrUs) ctx->maxAbsErrUs = errUs;
+}
+
+static void printReport(const ProbeContext* ctx, const char* tag) {
+    if (ctx->evaluations == 0) {
+        printf("[PROBE] %s unsynced, %u requests, %u timeouts\n", tag, ctx->requests, ctx->timeouts);
+        return;
+    }
+    // 本地时钟快 D ppm 时，偏差 (参考 - 本地) 每秒减少约 D 微秒
+    double trueDriftPpm = -ctx->clock->driftPpm / (1.0 + ctx->clock->driftPpm / 1e6);
+    printf("[PROBE] %s err mean/max %.0f/%.0fus, uncertainty mean %.0fus, coverage %.1f%%, "
+           "drift %.2f (true %.2f) ppm, samples %u/%u, steps %u, timeouts %u\n",
+           tag, ctx->sumAbsErrUs / (double)ctx->evaluations, ctx->maxAbsErrUs,
+           ctx->sumUncertaintyUs / (double)ctx->evaluations,
+           100.0 * (double)ctx->covered / (double)ctx->evaluations,
+           ctx->filter.driftPpm, trueDriftPpm, ctx->filter.samples, ctx->requests, ctx->filter.steps, ctx->timeouts);
+}
+
+int main(int argc, char** argv) {
+    std::string host = "127.0.0.1";
+    uint16_t port = 1883;
+    std::string deviceId = "time_probe_" + std::to_string(getpid());
+    double uptimeS = PROBE_DEFAULT_UPTIME_S;
+    double driftPpm = PROBE_DEFAULT_DRIFT_PPM;
+    int64_t jitterUs = 0;
+    int64_t intervalMs = TIME_INTERVAL_MS;
+    int durationS = 0;
+    int reportIntervalS = PROBE_REPORT_INTERVAL_S;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:i:u:D:j:I:d:r:")) != -1) {
+        switch (opt) {
+            case 'h': host = optarg; break;
+            case 'p': port = (uint16_t)atoi(optarg); break;
+            case 'i': deviceId = optarg; break;
+            case 'u': uptimeS = atof(optarg); break;
+            case 'D': driftPpm = atof(optarg); break;
+            case 'j': jitterUs = atoll(optarg); break;
+            case 'I': intervalMs = atoll(optarg); break;
+            case 'd': durationS = atoi(optarg); break;
+            case 'r': reportIntervalS = atoi(optarg); break;
+            default:
+                printUsage(argv[0]);
+                return 1;
+        }
+    }
+    if (intervalMs <= 0 || reportIntervalS <= 0 || jitterUs < 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    // 本地时钟从 uptimeS 开始计数，此后按漂移走快/走慢
+    LocalClock clock;
+    clock.startMonoUs = timeMonotonicUs();
+    clock.offsetUs = uptimeS * 1e6;
+    clock.driftPpm = driftPpm;
+    clock.jitterUs = jitterUs;
+
+    static ProbeContext ctx;
+    clockFilterReset(&ctx.filter);
+    ctx.clock = &clock;
+    ctx.responseTopic = std::string(TIME_TOPIC_RESPONSE) + deviceId;
+    ctx.lastRequestMs = mqttSessionNowMs() - intervalMs;
+    ctx.burstRemaining = TIME_BURST_SAMPLES;
+
+    MqttSession session;
+    mqttSessionInit(&session);
+    if (!mqttSessionConnect(&session, host.c_str(), port, deviceId.c_str()) ||
+        !mqttSessionSubscribe(&session, ctx.responseTopic.c_str())) {
+        return 1;
+    }
+    printf("[PROBE] %s: uptime %.3fs, drift %.1fppm, jitter %lldus, interval %lldms\n", deviceId.c_str(), uptimeS,
+           driftPpm, (long long)jitterUs, (long long)intervalMs);
+
+    int64_t startMs = mqttSessionNowMs();
+    int64_t lastEvalMs = startMs;
+    int64_t lastReportMs = startMs;
+
+    while (running) {
+        pollRequest(&ctx, &session, deviceId, intervalMs);
+        if (!mqttSessionPoll(&session, 10, handleResponse, &ctx)) {
+            printf("[PROBE] Connection lost\n");
+            break;
+        }
+
+        int64_t now = mqttSessionNowMs();
+        if (now - lastEvalMs >= PROBE_EVAL_INTERVAL_MS) {
+            evaluate(&ctx);
+            lastEvalMs = now;
+        }
+        if (now - lastReportMs >= reportIntervalS * 1000) {
+            printReport(&ctx, "So far:");
+            lastReportMs = now;
+        }
+        if (durationS > 0 && now - startMs >= (int64_t)durationS * 1000) break;
+    }
+
+    printReport(&ctx, "Total:");
+    mqttSessionClose(&session);
+    return ctx.filter.synced ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <string>
+#include <unordered_set>
+#include "MY_MqttSession.h"
+#include "MY_TimeWire.h"
+
+// ==================== 运行参数 ====================
+#define TIMEREF_POLL_MS             200
+#define TIMEREF_RETRY_MS            1000
+#define TIMEREF_REPORT_INTERVAL_S   10
+
+typedef struct {
+    MqttSession* session;
+    bool verbose;
+    uint64_t answered;
+    uint64_t malformed;
+    int64_t maxServiceUs;           // 周期内 t3 - t2 最大值
+    std::unordered_set<std::string> devices;
+} TimeRefContext;
+
+static volatile sig_atomic_t running = 1;
+
+static void handleSignal(int) {
+    running = 0;
+}
+
+static void printUsage(const char* name) {
+    printf("Usage: %s [-h host] [-p port] [-c client_id] [-v]\n", name);
+}
+
+/**
+ * @brief 收到请求立即应答，t2 尽早记录、t3 在发送前最后记录
+ */
+static void handleRequest(void* context, std::string_view topic, std::string_view payload) {
+    int64_t t2 = timeRealtimeUs();
+    TimeRefContext* ctx = (TimeRefContext*)context;
+    if (topic != TIME_TOPIC_REQUEST) return;
+
+    TimeMessage request;
+    if (!timeParseMessage(payload, &request)) {
+        ctx->malformed++;
+        return;
+    }
+
+    char responseTopic[128];
+    int topicLen = snprintf(responseTopic, sizeof(responseTopic), "%s%.*s", TIME_TOPIC_RESPONSE,
+                            (int)request.deviceId.size(), request.deviceId.data());
+    if (topicLen <= 0 || (size_t)topicLen >= sizeof(responseTopic)) {
+        ctx->malformed++;
+        return;
+    }
+
+    char response[TIME_PAYLOAD_MAX];
+    int64_t t3 = timeRealtimeUs();
+    size_t len = timeEncodeResponse(response, sizeof(response), &request, t2, t3);
+    if (len == 0) return;
+    mqttSessionPublish(ctx->session, responseTopic, std::string_view(response, len));
+
+    ctx->answered++;
+    if (t3 - t2 > ctx->maxServiceUs) ctx->maxServiceUs = t3 - t2;
+    ctx->devices.insert(std::string(request.deviceId));
+    if (ctx->verbose) {
+        printf("[TIMEREF] %.*s seq %u\n", (int)request.deviceId.size(), request.deviceId.data(), request.seq);
+    }
+}
+
+/**
+ * @brief 时钟同步参考进程
+ *
+ * 订阅 fire_alarm/time/request，用本机 CLOCK_REALTIME 回复 t2/t3
+ * 本机应由 NTP/PTP 校准，设备上报的 epoch_us 即以此为准
+ */
+int main(int argc, char** argv) {
+    std::string host = "127.0.0.1";
+    uint16_t port = 1883;
+    std::string clientId = "time_ref_" + std::to_string(getpid());
+    bool verbose = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:c:v")) != -1) {
+        switch (opt) {
+            case 'h': host = optarg; break;
+            case 'p': port = (uint16_t)atoi(optarg); break;
+            case 'c': clientId = optarg; break;
+            case 'v': verbose = true; break;
+            default:
+                printUsage(argv[0]);
+                return 1;
+        }
+    }
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    MqttSession session;
+    mqttSessionInit(&session);
+    TimeRefContext ctx;
+    ctx.session = &session;
+    ctx.verbose = verbose;
+    ctx.answered = 0;
+    ctx.malformed = 0;
+    ctx.maxServiceUs = 0;
+
+    printf("[TIMEREF] Broker %s:%u, answering %s\n", host.c_str(), port, TIME_TOPIC_REQUEST);
+
+    int64_t lastReportMs = mqttSessionNowMs();
+    uint64_t lastAnswered = 0;
+
+    while (running) {
+        if (session.fd < 0) {
+            if (!mqttSessionConnect(&session, host.c_str(), port, clientId.c_str()) ||
+                !mqttSessionSubscribe(&session, TIME_TOPIC_REQUEST)) {
+                mqttSessionClose(&session);
+                usleep(TIMEREF_RETRY_MS * 1000);
+                continue;
+            }
+            printf("[TIMEREF] Connected and subscribed\n");
+        }
+
+        if (!mqttSessionPoll(&session, TIMEREF_POLL_MS, handleRequest, &ctx)) {
+            printf("[TIMEREF] Connection lost\n");
+            mqttSessionClose(&session);
+            continue;
+        }
+
+        int64_t now = mqttSessionNowMs();
+        if (now - lastReportMs >= TIMEREF_REPORT_INTERVAL_S * 1000) {
+            printf("[TIMEREF] %llu answered (+%llu), %zu devices, %llu malformed, max service %lldus\n",
+                   (unsigned long long)ctx.answered, (unsigned long long)(ctx.answered - lastAnswered),
+                   ctx.devices.size(), (unsigned long long)ctx.malformed, (long long)ctx.maxServiceUs);
+            lastAnswered = ctx.answered;
+            ctx.maxServiceUs = 0;
+            lastReportMs = now;
+        }
+    }
+
+    mqttSessionClose(&session);
+    printf("[TIMEREF] Answered %llu requests from %zu devices\n", (unsigned long long)ctx.answered,
+           ctx.devices.size());
+    return 0;
+}
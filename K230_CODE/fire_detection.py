@@ -13,12 +13,78 @@ import image
 import random
 import gc
 import utime
+import struct
 from ybUtils.YbUart import YbUart
+try:
+    import _thread
+except ImportError:
+    _thread = None
+try:
+    from binascii import crc32
+except ImportError:
+    crc32 = None
 
-uart = YbUart(baudrate=115200)
+# 上电/回落时的基础速率，与 MY_K230.h 中 K230_BAUD_RATE 一致
+UART_BASE_BAUD = 115200
+uart = YbUart(baudrate=UART_BASE_BAUD)
+uart_baud = UART_BASE_BAUD
 # 定义一个全局变量记录上一次发送的时间
 last_send_time = 0
-SEND_INTERVAL_MS = 2000  # 发送间隔：2000毫秒（2秒）
+SEND_INTERVAL_MS = 2000  # 默认发送间隔：2000毫秒（2秒），ESP32可通过 "cfg" 命令调整
+# ESP32开启Light-sleep时由串口线电平唤醒，唤醒期间收到的字节会丢失
+# 先发送一个换行唤醒，等待后再发送以换行开头的命令，丢失的残字节会被换行隔开
+WAKE_GAP_MS = 20
+# 心跳发送间隔：无论有无火焰都定期上报帧数、帧率、推理耗时和模型ID，
+# ESP32据此区分"无火"与摄像头/模型/串口故障 (与 MY_K230.h 中 K230_HEARTBEAT_INTERVAL_MS 一致)
+HEARTBEAT_INTERVAL_MS = 5000
+MODEL_ID_MAX_LEN = 23
+
+# 心跳统计 (主循环写，心跳线程读)
+frame_count = 0
+infer_total_us = 0
+infer_frames = 0
+model_id = "unknown"
+heartbeat_running = False
+last_heartbeat_ticks = 0
+last_heartbeat_frames = 0
+uart_lock = _thread.allocate_lock() if _thread else None
+
+# 速率协商 (ESP32发起): "baud <N>" -> 回复 "baud_ok <N>" 后切换 -> 等待 "baud_confirm" -> 回复 "baud_active <N>"
+# 确认超时、或高速率下长时间收不到ESP32的任何行 (ESP32每5秒发送 "baud_keep") 时回落到基础速率
+BAUD_SUPPORTED = (460800, 921600)
+BAUD_SWITCH_GAP_MS = 20
+BAUD_CONFIRM_MS = 1000
+BAUD_KEEPALIVE_TIMEOUT_MS = 15000
+COMMAND_MAX_LEN = 64
+command_buffer = b""
+baud_pending = 0
+baud_deadline = 0
+last_command_ticks = 0
+
+# 检测快照：检测到火焰时发送检测帧的JPEG缩略图 (只在协商到高速率后发送)
+# 二进制帧: A5 5A | 类型 | 快照ID | 块序号 | 块数 | 总长 | 偏移 | 长度 | 数据 | CRC32，与 MY_K230.h 一致
+SNAPSHOT_ENABLE = True
+SNAPSHOT_WIDTH = 320
+SNAPSHOT_HEIGHT = 240
+SNAPSHOT_QUALITY = 50
+SNAPSHOT_INTERVAL_MS = 10000
+SNAPSHOT_MAX_BYTES = 64 * 1024
+FRAME_MAGIC = b"\xa5\x5a"
+FRAME_TYPE_JPEG = 0x01
+FRAME_CHUNK_SIZE = 1024
+snapshot_id = 0
+
+# 检测参数 (ESP32下发): "cfg <上报间隔ms> <置信度阈值> <ROI x> <ROI y> <ROI w> <ROI h>"，应用后原样回复 "cfg_ok ..."
+# ROI 以画面千分比表示；阈值为0表示使用部署配置中的 confidence_threshold。与 MY_K230.h 一致
+# K230重启后恢复为以下默认值，ESP32检测到重启会重新下发
+REPORT_INTERVAL_MIN_MS = 50
+REPORT_INTERVAL_MAX_MS = 2000
+ROI_FULL = 1000
+report_interval_ms = SEND_INTERVAL_MS
+detect_threshold = 0.0
+roi = (0, 0, ROI_FULL, ROI_FULL)
+pending_snapshot = None
+last_snapshot_ticks = 0
 
 display_mode="lcd"
 if display_mode=="lcd":
@@ -74,6 +140,240 @@ class ScopedTiming:
             elapsed_time = time.time_ns() - self.start_time
             print(f"{self.info} took {elapsed_time / 1000000:.2f} ms")
 
+def uart_acquire():
+    if uart_lock:
+        uart_lock.acquire()
+
+def uart_release():
+    if uart_lock:
+        uart_lock.release()
+
+def uart_send_line_locked(text):
+    # 先发换行唤醒ESP32，等待后再发以换行开头的整行 (调用方已持有串口锁)
+    uart.send("\n")
+    utime.sleep_ms(WAKE_GAP_MS)
+    uart.send("\n" + text + "\n")
+
+def uart_send_line(text):
+    # 心跳线程与主循环共用串口，需加锁
+    uart_acquire()
+    try:
+        uart_send_line_locked(text)
+    finally:
+        uart_release()
+
+def uart_set_baud(baud):
+    # 重新打开串口切换速率 (调用方已持有串口锁)
+    global uart, uart_baud
+    try:
+        uart.deinit()
+    except AttributeError:
+        pass
+    uart = YbUart(baudrate=baud)
+    uart_baud = baud
+
+def handle_command(line):
+    # 处理ESP32发来的一行命令
+    global baud_pending, baud_deadline
+    parts = line.split()
+    if not parts:
+        return
+    cmd = parts[0]
+    if cmd == "baud" and len(parts) == 2:
+        baud = int(parts[1]) if parts[1].isdigit() else 0
+        if baud not in BAUD_SUPPORTED:
+            return
+        # 以旧速率应答后切换，切换前的间隔保证应答已发完、ESP32已收到
+        uart_acquire()
+        try:
+            uart_send_line_locked("baud_ok %d" % baud)
+            utime.sleep_ms(BAUD_SWITCH_GAP_MS)
+            uart_set_baud(baud)
+        finally:
+            uart_release()
+        baud_pending = baud
+        baud_deadline = time.ticks_add(time.ticks_ms(), BAUD_CONFIRM_MS)
+        print("uart switched to %d, waiting confirm" % baud)
+    elif cmd == "cfg" and len(parts) == 7:
+        handle_cfg(parts[1:])
+    elif cmd == "baud_confirm" and baud_pending:
+        uart_send_line("baud_active %d" % baud_pending)
+        print("uart %d active" % baud_pending)
+        baud_pending = 0
+
+def handle_cfg(fields):
+    # 校验并应用ESP32下发的检测参数，非法参数不应答，ESP32会重发
+    global report_interval_ms, detect_threshold, roi
+    try:
+        interval = int(fields[0])
+        threshold = float(fields[1])
+        x, y, w, h = [int(v) for v in fields[2:]]
+    except ValueError:
+        return
+    if interval < REPORT_INTERVAL_MIN_MS or interval > REPORT_INTERVAL_MAX_MS:
+        return
+    if threshold < 0 or threshold >= 1:
+        return
+    if w <= 0 or h <= 0 or x < 0 or y < 0 or x + w > ROI_FULL or y + h > ROI_FULL:
+        return
+    changed = interval != report_interval_ms or threshold != detect_threshold or (x, y, w, h) != roi
+    report_interval_ms = interval
+    detect_threshold = threshold
+    roi = (x, y, w, h)
+    uart_send_line("cfg_ok %d %.2f %d %d %d %d" % (interval, threshold, x, y, w, h))
+    if changed:
+        print("detect params: report %dms, threshold %.2f, roi %d,%d %dx%d" % (interval, threshold, x, y, w, h))
+
+def roi_filter(det_boxes):
+    # 只保留中心点落在ROI内的检测框 (检测框坐标为 OUT_RGB888P 分辨率下的像素)
+    x, y, w, h = roi
+    if (x, y, w, h) == (0, 0, ROI_FULL, ROI_FULL):
+        return det_boxes
+    left = x * OUT_RGB888P_WIDTH // ROI_FULL
+    top = y * OUT_RGB888P_HEIGH // ROI_FULL
+    right = (x + w) * OUT_RGB888P_WIDTH // ROI_FULL
+    bottom = (y + h) * OUT_RGB888P_HEIGH // ROI_FULL
+    kept = []
+    for det_boxe in det_boxes:
+        cx = (det_boxe[2] + det_boxe[4]) / 2
+        cy = (det_boxe[3] + det_boxe[5]) / 2
+        if left <= cx <= right and top <= cy <= bottom:
+            kept.append(det_boxe)
+    return kept
+
+def uart_fallback(reason):
+    global baud_pending
+    uart_acquire()
+    try:
+        uart_set_baud(UART_BASE_BAUD)
+    finally:
+        uart_release()
+    baud_pending = 0
+    print("uart fallback to %d: %s" % (UART_BASE_BAUD, reason))
+
+def command_poll():
+    # 读取ESP32发来的命令行 (非阻塞)，并检查速率确认/保活超时
+    global command_buffer, last_command_ticks
+    data = uart.read()
+    if data:
+        command_buffer += data
+        while b"\n" in command_buffer:
+            raw, command_buffer = command_buffer.split(b"\n", 1)
+            try:
+                line = raw.decode().strip()
+            except UnicodeError:
+                continue
+            if line:
+                last_command_ticks = time.ticks_ms()
+                handle_command(line)
+        if len(command_buffer) > COMMAND_MAX_LEN:
+            command_buffer = b""
+
+    now = time.ticks_ms()
+    if baud_pending and time.ticks_diff(now, baud_deadline) > 0:
+        uart_fallback("no confirm")
+    elif uart_baud != UART_BASE_BAUD and not baud_pending and \
+            time.ticks_diff(now, last_command_ticks) > BAUD_KEEPALIVE_TIMEOUT_MS:
+        uart_fallback("no keepalive")
+
+def frame_crc32(data):
+    # 与zlib相同的CRC32；固件未带 binascii 时用逐位计算
+    if crc32:
+        return crc32(data) & 0xFFFFFFFF
+    crc = 0xFFFFFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1))
+    return crc ^ 0xFFFFFFFF
+
+def snapshot_send(jpeg):
+    # 按块发送一张快照；每块单独加锁，火焰行与心跳可以插在块之间及时发出
+    global snapshot_id
+    snapshot_id = (snapshot_id + 1) & 0xFFFF
+    total = len(jpeg)
+    count = (total + FRAME_CHUNK_SIZE - 1) // FRAME_CHUNK_SIZE
+    start = time.ticks_ms()
+    uart_send_line("")
+    for index in range(count):
+        offset = index * FRAME_CHUNK_SIZE
+        chunk = jpeg[offset:offset + FRAME_CHUNK_SIZE]
+        body = struct.pack("<BHHHIIH", FRAME_TYPE_JPEG, snapshot_id, index, count, total, offset, len(chunk)) + chunk
+        uart_acquire()
+        try:
+            uart.send(FRAME_MAGIC + body + struct.pack("<I", frame_crc32(body)))
+        finally:
+            uart_release()
+    print("snapshot #%d: %d bytes, %d chunks, %d ms" % (snapshot_id, total, count, time.ticks_diff(time.ticks_ms(), start)))
+
+def snapshot_poll():
+    # 发送主循环排队的快照；速率已回落时丢弃 (基础速率下一张快照要占用串口1秒以上)
+    global pending_snapshot
+    jpeg = pending_snapshot
+    if jpeg is None:
+        return
+    pending_snapshot = None
+    if uart_baud != UART_BASE_BAUD:
+        snapshot_send(jpeg)
+
+def snapshot_capture(sensor, det_boxes):
+    # 主循环调用：截取缩略图通道并画出检测框，压缩为JPEG后交给发送线程
+    global pending_snapshot, last_snapshot_ticks
+    now = time.ticks_ms()
+    if not SNAPSHOT_ENABLE or pending_snapshot is not None or uart_baud == UART_BASE_BAUD or \
+            time.ticks_diff(now, last_snapshot_ticks) < SNAPSHOT_INTERVAL_MS:
+        return
+    last_snapshot_ticks = now
+    thumb = sensor.snapshot(chn=CAM_CHN_ID_1)
+    for det_boxe in det_boxes:
+        x1, y1, x2, y2 = det_boxe[2], det_boxe[3], det_boxe[4], det_boxe[5]
+        thumb.draw_rectangle(int(x1 * SNAPSHOT_WIDTH // OUT_RGB888P_WIDTH), int(y1 * SNAPSHOT_HEIGHT // OUT_RGB888P_HEIGH),
+                             int((x2 - x1) * SNAPSHOT_WIDTH // OUT_RGB888P_WIDTH), int((y2 - y1) * SNAPSHOT_HEIGHT // OUT_RGB888P_HEIGH),
+                             color=(255, 0, 0), thickness=2)
+    jpeg = bytes(thumb.compress(quality=SNAPSHOT_QUALITY).bytearray())
+    if len(jpeg) <= SNAPSHOT_MAX_BYTES:
+        pending_snapshot = jpeg
+
+def heartbeat_poll():
+    # 到达间隔时发送一次心跳: "hb <累计帧数> <FPS> <平均推理ms> <模型ID>"
+    global infer_total_us, infer_frames, last_heartbeat_ticks, last_heartbeat_frames
+    now = time.ticks_ms()
+    elapsed = time.ticks_diff(now, last_heartbeat_ticks)
+    if elapsed < HEARTBEAT_INTERVAL_MS:
+        return
+    frames = frame_count
+    fps = (frames - last_heartbeat_frames) * 1000.0 / elapsed
+    infer_ms = infer_total_us / infer_frames / 1000.0 if infer_frames > 0 else 0.0
+    infer_total_us = 0
+    infer_frames = 0
+    last_heartbeat_ticks = now
+    last_heartbeat_frames = frames
+    uart_send_line("hb %d %.1f %.1f %s" % (frames, fps, infer_ms, model_id))
+
+def heartbeat_thread():
+    # 独立线程发送心跳：摄像头取帧或推理卡住时心跳仍在，但帧数不再增长，ESP32判定为stalled；
+    # 主循环异常退出时停止心跳，ESP32判定为lost
+    # 同一线程处理ESP32命令 (速率协商) 并发送检测快照，不占用推理主循环
+    while heartbeat_running:
+        command_poll()
+        heartbeat_poll()
+        snapshot_poll()
+        utime.sleep_ms(50)
+
+def start_heartbeat(kmodel_name):
+    global model_id, heartbeat_running, last_heartbeat_ticks
+    name = kmodel_name.split("/")[-1]
+    if name.endswith(".kmodel"):
+        name = name[:-len(".kmodel")]
+    model_id = name.replace(" ", "_")[:MODEL_ID_MAX_LEN] or "unknown"
+    last_heartbeat_ticks = time.ticks_ms()
+    heartbeat_running = True
+    if _thread:
+        _thread.start_new_thread(heartbeat_thread, ())
+        return True
+    # 不支持线程时由主循环每帧调用 heartbeat_poll
+    return False
+
 def read_deploy_config(config_path):
     # 打开JSON文件以进行读取deploy_config
     with open(config_path, 'r') as json_file:
@@ -91,7 +391,7 @@ def detection():
     print("det_infer start")
 
     # 引用全局变量
-    global last_send_time
+    global last_send_time, frame_count, infer_total_us, infer_frames, heartbeat_running
 
     # 使用json读取内容初始化部署变量
     deploy_conf=read_deploy_config(config_path)
@@ -153,6 +453,10 @@ def detection():
     # 通道2给到AI做算法处理，格式为RGB888
     sensor.set_framesize(width = OUT_RGB888P_WIDTH , height = OUT_RGB888P_HEIGH, chn=CAM_CHN_ID_2)
     sensor.set_pixformat(PIXEL_FORMAT_RGB_888_PLANAR, chn=CAM_CHN_ID_2)
+    # 通道1给检测快照，格式为RGB565缩略图
+    if SNAPSHOT_ENABLE:
+        sensor.set_framesize(width = SNAPSHOT_WIDTH, height = SNAPSHOT_HEIGHT, chn=CAM_CHN_ID_1)
+        sensor.set_pixformat(PIXEL_FORMAT_RGB_565, chn=CAM_CHN_ID_1)
     # 绑定通道0的输出到vo
     sensor_bind_info = sensor.bind_info(x = 0, y = 0, chn = CAM_CHN_ID_0)
     Display.bind_layer(**sensor_bind_info, layer = Display.LAYER_VIDEO1)
@@ -174,11 +478,13 @@ def detection():
         ai2d_input_tensor = None
         data = np.ones((1,3,width,height),dtype=np.uint8)
         ai2d_output_tensor = nn.from_numpy(data)
+        heartbeat_threaded = start_heartbeat(kmodel_name)
         while  True:
             with ScopedTiming("total",debug_mode > 0):
                 rgb888p_img = sensor.snapshot(chn=CAM_CHN_ID_2)
                 # for rgb888planar
                 if rgb888p_img.format() == image.RGBP888:
+                    infer_start = time.ticks_us()
                     ai2d_input = rgb888p_img.to_numpy_ref()
                     ai2d_input_tensor = nn.from_numpy(ai2d_input)
                     ai2d_builder.run(ai2d_input_tensor, ai2d_output_tensor)
@@ -197,14 +503,21 @@ def detection():
                         results.append(result)
                     gc.collect()
 
-                    # postprocess
+                    # postprocess (ESP32下发的阈值优先于部署配置)
+                    threshold = detect_threshold if detect_threshold > 0 else confidence_threshold
                     if model_type == "AnchorBaseDet":
-                        det_boxes = aicube.anchorbasedet_post_process( results[0], results[1], results[2], kmodel_frame_size, frame_size, strides, num_classes, confidence_threshold, nms_threshold, anchors, nms_option)
+                        det_boxes = aicube.anchorbasedet_post_process( results[0], results[1], results[2], kmodel_frame_size, frame_size, strides, num_classes, threshold, nms_threshold, anchors, nms_option)
                     elif model_type == "GFLDet":
-                        det_boxes = aicube.gfldet_post_process( results[0], results[1], results[2], kmodel_frame_size, frame_size, strides, num_classes, confidence_threshold, nms_threshold, nms_option)
+                        det_boxes = aicube.gfldet_post_process( results[0], results[1], results[2], kmodel_frame_size, frame_size, strides, num_classes, threshold, nms_threshold, nms_option)
                     else:
-                        det_boxes = aicube.anchorfreedet_post_process( results[0], results[1], results[2], kmodel_frame_size, frame_size, strides, num_classes, confidence_threshold, nms_threshold, nms_option)
+                        det_boxes = aicube.anchorfreedet_post_process( results[0], results[1], results[2], kmodel_frame_size, frame_size, strides, num_classes, threshold, nms_threshold, nms_option)
+                    # 推理耗时 = 预处理 + KPU推理 + 后处理
+                    infer_total_us += time.ticks_diff(time.ticks_us(), infer_start)
+                    infer_frames += 1
+                    frame_count += 1
                     osd_img.clear()
+                    if det_boxes:
+                        det_boxes = roi_filter(det_boxes)
                     if det_boxes:
 
                         # 2. 如果确认有火，并且距离上次发送超过了设定时间
@@ -212,10 +525,13 @@ def detection():
                         # 注意：MicroPython 的 time.time() 通常返回秒，建议用 time.ticks_ms() 更准
                         current_ticks = time.ticks_ms()
 
-                        if  time.ticks_diff(current_ticks, last_send_time) > SEND_INTERVAL_MS:
-                            uart.send("fire\n")
-                            print("fire\n")
+                        if  time.ticks_diff(current_ticks, last_send_time) >= report_interval_ms:
+                            # 附带本帧最高检测置信度，供ESP32融合评估
+                            fire_conf = max([det_boxe[1] for det_boxe in det_boxes])
+                            uart_send_line("fire %.2f" % fire_conf)
+                            print("fire %.2f\n" % fire_conf)
                             last_send_time = current_ticks # 更新发送时间
+                            snapshot_capture(sensor, det_boxes)
 
                         for det_boxe in det_boxes:
                             x1, y1, x2, y2 = det_boxe[2],det_boxe[3],det_boxe[4],det_boxe[5]
@@ -228,9 +544,16 @@ def detection():
                     Display.show_image(osd_img, 0, 0, Display.LAYER_OSD3)
                     gc.collect()
                 rgb888p_img = None
+                if not heartbeat_threaded:
+                    # 不支持线程时快照在主循环中发送，期间推理暂停
+                    command_poll()
+                    heartbeat_poll()
+                    snapshot_poll()
     except Exception as e:
         print(f"An error occurred during buffer used: {e}")
     finally:
+        # 停止心跳，ESP32超时后判定视觉链路丢失
+        heartbeat_running = False
         os.exitpoint(os.EXITPOINT_ENABLE_SLEEP)
         del ai2d_input_tensor
         del ai2d_output_tensor